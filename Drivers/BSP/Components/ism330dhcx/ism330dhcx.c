@@ -2852,6 +2852,45 @@ int32_t ISM330DHCX_FIFO_GYRO_Get_Axis(ISM330DHCX_Object_t *pObj, ISM330DHCX_Axes
   return ISM330DHCX_OK;
 }
 
+/**
+  * @brief  Set the ISM330DHCX decimation for timestamp batching in FIFO
+  * @param  pObj the device pObj
+  * @param  Decimation FIFO timestamp decimation (0 disables the timestamp)
+  * @retval 0 in case of success, an error code otherwise
+  */
+int32_t ISM330DHCX_FIFO_Set_TS_Decimation(ISM330DHCX_Object_t *pObj, uint8_t Decimation)
+{
+  /* The timestamp counter runs only when it is batched in FIFO */
+  if (ism330dhcx_timestamp_set(&(pObj->Ctx), (Decimation != 0U) ? PROPERTY_ENABLE : PROPERTY_DISABLE) != ISM330DHCX_OK)
+  {
+    return ISM330DHCX_ERROR;
+  }
+
+  if (ism330dhcx_fifo_timestamp_decimation_set(&(pObj->Ctx), (ism330dhcx_odr_ts_batch_t)Decimation) != ISM330DHCX_OK)
+  {
+    return ISM330DHCX_ERROR;
+  }
+
+  return ISM330DHCX_OK;
+}
+
+/**
+  * @brief  Read some words (tag + 6 data bytes each one) from the ISM330DHCX FIFO in one single burst
+  * @param  pObj the device pObj
+  * @param  pBuff Buffer to store the FIFO words (Words * 7 bytes)
+  * @param  Words Number of FIFO words to read
+  * @retval 0 in case of success, an error code otherwise
+  */
+int32_t ISM330DHCX_FIFO_Read(ISM330DHCX_Object_t *pObj, uint8_t *pBuff, uint16_t Words)
+{
+  if (ism330dhcx_read_reg(&(pObj->Ctx), ISM330DHCX_FIFO_DATA_OUT_TAG, pBuff, (uint16_t)(Words * 7U)) != ISM330DHCX_OK)
+  {
+    return ISM330DHCX_ERROR;
+  }
+
+  return ISM330DHCX_OK;
+}
+
 /**
   * @brief  Enable ISM330DHCX accelerometer DRDY interrupt on INT1
   * @param  pObj the device pObj
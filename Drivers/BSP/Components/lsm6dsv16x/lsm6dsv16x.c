@@ -2982,6 +2982,45 @@ int32_t LSM6DSV16X_FIFO_GYRO_Set_BDR(LSM6DSV16X_Object_t *pObj, float_t Bdr)
   return LSM6DSV16X_OK;
 }
 
+/**
+  * @brief  Set the LSM6DSV16X decimation for timestamp batching in FIFO
+  * @param  pObj the device pObj
+  * @param  Decimation FIFO timestamp decimation (0 disables the timestamp)
+  * @retval 0 in case of success, an error code otherwise
+  */
+int32_t LSM6DSV16X_FIFO_Set_TS_Decimation(LSM6DSV16X_Object_t *pObj, uint8_t Decimation)
+{
+  /* The timestamp counter runs only when it is batched in FIFO */
+  if (lsm6dsv16x_timestamp_set(&(pObj->Ctx), (Decimation != 0U) ? PROPERTY_ENABLE : PROPERTY_DISABLE) != LSM6DSV16X_OK)
+  {
+    return LSM6DSV16X_ERROR;
+  }
+
+  if (lsm6dsv16x_fifo_timestamp_batch_set(&(pObj->Ctx), (lsm6dsv16x_fifo_timestamp_batch_t)Decimation) != LSM6DSV16X_OK)
+  {
+    return LSM6DSV16X_ERROR;
+  }
+
+  return LSM6DSV16X_OK;
+}
+
+/**
+  * @brief  Read some words (tag + 6 data bytes each one) from the LSM6DSV16X FIFO in one single burst
+  * @param  pObj the device pObj
+  * @param  pBuff Buffer to store the FIFO words (Words * 7 bytes)
+  * @param  Words Number of FIFO words to read
+  * @retval 0 in case of success, an error code otherwise
+  */
+int32_t LSM6DSV16X_FIFO_Read(LSM6DSV16X_Object_t *pObj, uint8_t *pBuff, uint16_t Words)
+{
+  if (lsm6dsv16x_read_reg(&(pObj->Ctx), LSM6DSV16X_FIFO_DATA_OUT_TAG, pBuff, (uint16_t)(Words * 7U)) != LSM6DSV16X_OK)
+  {
+    return LSM6DSV16X_ERROR;
+  }
+
+  return LSM6DSV16X_OK;
+}
+
 /**
   * @brief  Enable the LSM6DSV16X gyroscope sensor
   * @param  pObj the device pObj
@@ -354,6 +354,8 @@ int32_t LSM6DSV16X_FIFO_ACC_Get_Axes(LSM6DSV16X_Object_t *pObj, LSM6DSV16X_Axes_
 int32_t LSM6DSV16X_FIFO_ACC_Set_BDR(LSM6DSV16X_Object_t *pObj, float_t Bdr);
 int32_t LSM6DSV16X_FIFO_GYRO_Get_Axes(LSM6DSV16X_Object_t *pObj, LSM6DSV16X_Axes_t *AngularVelocity);
 int32_t LSM6DSV16X_FIFO_GYRO_Set_BDR(LSM6DSV16X_Object_t *pObj, float_t Bdr);
+int32_t LSM6DSV16X_FIFO_Set_TS_Decimation(LSM6DSV16X_Object_t *pObj, uint8_t Decimation);
+int32_t LSM6DSV16X_FIFO_Read(LSM6DSV16X_Object_t *pObj, uint8_t *pBuff, uint16_t Words);
 
 int32_t LSM6DSV16X_GYRO_Enable(LSM6DSV16X_Object_t *pObj);
 int32_t LSM6DSV16X_GYRO_Disable(LSM6DSV16X_Object_t *pObj);
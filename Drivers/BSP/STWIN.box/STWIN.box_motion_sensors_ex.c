@@ -1329,31 +1329,60 @@ int32_t BSP_MOTION_SENSOR_FIFO_Get_Num_Samples(uint32_t Instance, uint16_t *NumS
   return ret;
 }
 
-#if (USE_MOTION_SENSOR_IIS3DWB_0 == 1)
 /**
- * @brief  Clear the interrupt on DRDY pin (available only for IIS3DWB sensor)
+ * @brief  Set the decimation for timestamp batching in FIFO
  * @param  Instance the device instance
- * @param  Status FIFO full interrupt on INT1 pin
- * @retval BSP status   
+ * @param  Function Motion sensor function. Could be:
+ *         - MOTION_ACCELERO for instance IIS3DWB_0
+ *         - MOTION_GYRO or MOTION_ACCELERO for instance ISM330DHCX_0
+ * @param  Decimation FIFO Timestamp decimation
+ * @retval BSP status
  */
-int32_t BSP_MOTION_SENSOR_Clear_DRDY(uint32_t Instance)
+int32_t BSP_MOTION_SENSOR_FIFO_TS_Decimation(uint32_t Instance, uint32_t Function, uint8_t Decimation)
 {
   int32_t ret;
-  IIS3DWB_Axes_t TempAcceleration;
 
   switch(Instance)
   {
+#if (USE_MOTION_SENSOR_IIS3DWB_0 == 1)
     case IIS3DWB_0:
+      if((Function & MOTION_ACCELERO) == MOTION_ACCELERO)
+      {
+        if(IIS3DWB_FIFO_Set_TS_Decimation(MotionCompObj[Instance], Decimation) != BSP_ERROR_NONE)
+        {
+          ret = BSP_ERROR_COMPONENT_FAILURE;
+        }
+        else
+        {
+          ret = BSP_ERROR_NONE;
+        }
+      }
+      else
+      {
+        ret = BSP_ERROR_WRONG_PARAM;
+      }
+      break;
+#endif
 
-      if(IIS3DWB_ACC_GetAxes(MotionCompObj[Instance], &TempAcceleration) != BSP_ERROR_NONE)
+#if (USE_MOTION_SENSOR_ISM330DHCX_0 == 1)
+    case ISM330DHCX_0:
+      if(((Function & MOTION_ACCELERO) == MOTION_ACCELERO) || ((Function & MOTION_GYRO) == MOTION_GYRO))
       {
-        ret = BSP_ERROR_COMPONENT_FAILURE;
+        if(ISM330DHCX_FIFO_Set_TS_Decimation(MotionCompObj[Instance], Decimation) != BSP_ERROR_NONE)
+        {
+          ret = BSP_ERROR_COMPONENT_FAILURE;
+        }
+        else
+        {
+          ret = BSP_ERROR_NONE;
+        }
       }
       else
       {
-        ret = BSP_ERROR_NONE;
+        ret = BSP_ERROR_WRONG_PARAM;
       }
       break;
+#endif
 
     default:
       ret = BSP_ERROR_WRONG_PARAM;
@@ -1364,36 +1393,43 @@ int32_t BSP_MOTION_SENSOR_Clear_DRDY(uint32_t Instance)
 }
 
 /**
- * @brief  Set the IIS3DWB decimation for timestamp batching in FIFO
+ * @brief  Read FIFO
  * @param  Instance the device instance
- * @param  Function Motion sensor function. Could be:
- *         - MOTION_GYRO or MOTION_ACCELERO for instance STWIN_LSM6DSL_0
- * @param  Decimation FIFO Timestamp decimation
+ * @param  pBuff The buffer to be fill with the read data (7 bytes for each word)
+ * @param  Watermark Number of FIFO words to read
  * @retval BSP status
  */
-int32_t BSP_MOTION_SENSOR_FIFO_TS_Decimation(uint32_t Instance, uint32_t Function, uint8_t Decimation)
+int32_t BSP_MOTION_SENSOR_FIFO_Read(uint32_t Instance, uint8_t *pBuff, uint16_t Watermark)
 {
   int32_t ret;
 
   switch(Instance)
   {
+#if (USE_MOTION_SENSOR_IIS3DWB_0 == 1)
     case IIS3DWB_0:
-      if((Function & MOTION_ACCELERO) == MOTION_ACCELERO)
+      if(IIS3DWB_FIFO_Read(MotionCompObj[Instance], pBuff, Watermark) != BSP_ERROR_NONE)
       {
-        if(IIS3DWB_FIFO_Set_TS_Decimation(MotionCompObj[Instance], Decimation) != BSP_ERROR_NONE)
-        {
-          ret = BSP_ERROR_COMPONENT_FAILURE;
-        }
-        else
-        {
-          ret = BSP_ERROR_NONE;
-        }
+        ret = BSP_ERROR_COMPONENT_FAILURE;
       }
       else
       {
-        ret = BSP_ERROR_WRONG_PARAM;
+        ret = BSP_ERROR_NONE;
+      }
+      break;
+#endif
+
+#if (USE_MOTION_SENSOR_ISM330DHCX_0 == 1)
+    case ISM330DHCX_0:
+      if(ISM330DHCX_FIFO_Read(MotionCompObj[Instance], pBuff, Watermark) != BSP_ERROR_NONE)
+      {
+        ret = BSP_ERROR_COMPONENT_FAILURE;
+      }
+      else
+      {
+        ret = BSP_ERROR_NONE;
       }
       break;
+#endif
 
     default:
       ret = BSP_ERROR_WRONG_PARAM;
@@ -1403,8 +1439,8 @@ int32_t BSP_MOTION_SENSOR_FIFO_TS_Decimation(uint32_t Instance, uint32_t Functio
   return ret;
 }
 
-/*
- * @brief  Set FIFO Threshold on INT1 pin 
+/**
+ * @brief  Set FIFO Threshold on INT1 pin
  * @param  Instance the device instance
  * @param  Status FIFO Threshold on INT1 pin
  * @retval BSP status
@@ -1415,6 +1451,7 @@ int32_t BSP_MOTION_SENSOR_FIFO_Set_INT1_FIFO_Threshold(uint32_t Instance, uint8_
 
   switch(Instance)
   {
+#if (USE_MOTION_SENSOR_IIS3DWB_0 == 1)
     case IIS3DWB_0:
       if(IIS3DWB_INT1_Set_FIFO_Threshold(MotionCompObj[Instance], Status) != BSP_ERROR_NONE)
       {
@@ -1425,6 +1462,20 @@ int32_t BSP_MOTION_SENSOR_FIFO_Set_INT1_FIFO_Threshold(uint32_t Instance, uint8_
         ret = BSP_ERROR_NONE;
       }
       break;
+#endif
+
+#if (USE_MOTION_SENSOR_ISM330DHCX_0 == 1)
+    case ISM330DHCX_0:
+      if(ISM330DHCX_FIFO_Set_INT1_FIFO_Threshold(MotionCompObj[Instance], Status) != BSP_ERROR_NONE)
+      {
+        ret = BSP_ERROR_COMPONENT_FAILURE;
+      }
+      else
+      {
+        ret = BSP_ERROR_NONE;
+      }
+      break;
+#endif
 
     default:
       ret = BSP_ERROR_WRONG_PARAM;
@@ -1434,20 +1485,23 @@ int32_t BSP_MOTION_SENSOR_FIFO_Set_INT1_FIFO_Threshold(uint32_t Instance, uint8_
   return ret;
 }
 
-/*
- * @brief  Set FIFO Threshold on INT2 pin 
+#if (USE_MOTION_SENSOR_IIS3DWB_0 == 1)
+/**
+ * @brief  Clear the interrupt on DRDY pin (available only for IIS3DWB sensor)
  * @param  Instance the device instance
- * @param  Status FIFO Threshold on INT2 pin
- * @retval BSP status
+ * @param  Status FIFO full interrupt on INT1 pin
+ * @retval BSP status   
  */
-int32_t BSP_MOTION_SENSOR_FIFO_Set_INT2_FIFO_Threshold(uint32_t Instance, uint8_t Status)
+int32_t BSP_MOTION_SENSOR_Clear_DRDY(uint32_t Instance)
 {
   int32_t ret;
+  IIS3DWB_Axes_t TempAcceleration;
 
   switch(Instance)
   {
     case IIS3DWB_0:
-      if(IIS3DWB_INT2_Set_FIFO_Threshold(MotionCompObj[Instance], Status) != BSP_ERROR_NONE)
+
+      if(IIS3DWB_ACC_GetAxes(MotionCompObj[Instance], &TempAcceleration) != BSP_ERROR_NONE)
       {
         ret = BSP_ERROR_COMPONENT_FAILURE;
       }
@@ -1465,35 +1519,26 @@ int32_t BSP_MOTION_SENSOR_FIFO_Set_INT2_FIFO_Threshold(uint32_t Instance, uint8_
   return ret;
 }
 
-/**
- * @brief  Set the IIS3DWB batching data rate for temperature data
+/*
+ * @brief  Set FIFO Threshold on INT2 pin 
  * @param  Instance the device instance
- * @param  Function Motion sensor function. Could be:
- *         - MOTION_GYRO or MOTION_ACCELERO
- * @param  bdr FIFO temperature data batching data rate
+ * @param  Status FIFO Threshold on INT2 pin
  * @retval BSP status
  */
-int32_t BSP_MOTION_SENSOR_FIFO_T_BDR(uint32_t Instance, uint32_t Function, uint8_t bdr)
+int32_t BSP_MOTION_SENSOR_FIFO_Set_INT2_FIFO_Threshold(uint32_t Instance, uint8_t Status)
 {
   int32_t ret;
 
   switch(Instance)
   {
     case IIS3DWB_0:
-      if((Function & MOTION_ACCELERO) == MOTION_ACCELERO)
+      if(IIS3DWB_INT2_Set_FIFO_Threshold(MotionCompObj[Instance], Status) != BSP_ERROR_NONE)
       {
-        if(IIS3DWB_FIFO_Set_T_BDR(MotionCompObj[Instance], (iis3dwb_odr_t_batch_t) bdr) != BSP_ERROR_NONE)
-        {
-          ret = BSP_ERROR_COMPONENT_FAILURE;
-        }
-        else
-        {
-          ret = BSP_ERROR_NONE;
-        }
+        ret = BSP_ERROR_COMPONENT_FAILURE;
       }
       else
       {
-        ret = BSP_ERROR_WRONG_PARAM;
+        ret = BSP_ERROR_NONE;
       }
       break;
 
@@ -1506,26 +1551,34 @@ int32_t BSP_MOTION_SENSOR_FIFO_T_BDR(uint32_t Instance, uint32_t Function, uint8
 }
 
 /**
- * @brief  Read FIFO
+ * @brief  Set the IIS3DWB batching data rate for temperature data
  * @param  Instance the device instance
- * @param  pBuff The buffer to be fill with the read data
- * @param  Watermark FIFO watermark level
+ * @param  Function Motion sensor function. Could be:
+ *         - MOTION_GYRO or MOTION_ACCELERO
+ * @param  bdr FIFO temperature data batching data rate
  * @retval BSP status
  */
-int32_t BSP_MOTION_SENSOR_FIFO_Read(uint32_t Instance, uint8_t *pBuff, uint16_t Watermark)
+int32_t BSP_MOTION_SENSOR_FIFO_T_BDR(uint32_t Instance, uint32_t Function, uint8_t bdr)
 {
   int32_t ret;
 
   switch(Instance)
   {
     case IIS3DWB_0:
-      if(IIS3DWB_FIFO_Read(MotionCompObj[Instance], pBuff, Watermark) != BSP_ERROR_NONE)
+      if((Function & MOTION_ACCELERO) == MOTION_ACCELERO)
       {
-        ret = BSP_ERROR_COMPONENT_FAILURE;
+        if(IIS3DWB_FIFO_Set_T_BDR(MotionCompObj[Instance], (iis3dwb_odr_t_batch_t) bdr) != BSP_ERROR_NONE)
+        {
+          ret = BSP_ERROR_COMPONENT_FAILURE;
+        }
+        else
+        {
+          ret = BSP_ERROR_NONE;
+        }
       }
       else
       {
-        ret = BSP_ERROR_NONE;
+        ret = BSP_ERROR_WRONG_PARAM;
       }
       break;
 
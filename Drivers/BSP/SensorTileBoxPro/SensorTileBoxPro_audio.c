@@ -334,6 +334,29 @@ int32_t BSP_AUDIO_IN_Record(uint32_t Instance, uint8_t *pBuf, uint32_t NbrOfByte
   return ret;
 }
 
+/**
+  * @brief  Change the buffer where the next recorded data will be stored.
+  *         It can be called inside the record callbacks for moving the data
+  *         of each interrupt directly to the application buffers
+  * @param  Instance  AUDIO IN Instance. It can be 0 when I2S / SPI is used or 1 if DFSDM is used
+  * @param  pBuf      Buffer pointer for the next recorded data
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_SetBuffer(uint32_t Instance, uint8_t *pBuf)
+{
+  int32_t ret = BSP_ERROR_NONE;
+
+  if (Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    AudioInCtx[Instance].pBuff = (uint16_t *)pBuf;
+  }
+  return ret;
+}
+
 
 /**
   * @brief  Stop audio recording.
@@ -291,6 +291,7 @@ extern AUDIO_IN_Ctx_t                         AudioInCtx[];
 int32_t BSP_AUDIO_IN_Init(uint32_t Instance, BSP_AUDIO_Init_t *AudioInit);
 int32_t BSP_AUDIO_IN_DeInit(uint32_t Instance);
 int32_t BSP_AUDIO_IN_Record(uint32_t Instance, uint8_t *pBuf, uint32_t NbrOfBytes);
+int32_t BSP_AUDIO_IN_SetBuffer(uint32_t Instance, uint8_t *pBuf);
 int32_t BSP_AUDIO_IN_Stop(uint32_t Instance);
 int32_t BSP_AUDIO_IN_Pause(uint32_t Instance);
 int32_t BSP_AUDIO_IN_Resume(uint32_t Instance);
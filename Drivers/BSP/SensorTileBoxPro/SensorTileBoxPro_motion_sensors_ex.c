@@ -2041,6 +2041,91 @@ int32_t BSP_MOTION_SENSOR_FIFO_Get_Axes(uint32_t Instance, uint32_t Function, BS
   return ret;
 }
 
+/**
+  * @brief  Set FIFO timestamp decimation
+  * @param  Instance the device instance
+  * @param  Function Motion sensor function
+  * @param  Decimation FIFO timestamp decimation (0 disables the timestamp)
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_FIFO_TS_Decimation(uint32_t Instance, uint32_t Function, uint8_t Decimation)
+{
+  int32_t ret;
+
+  switch (Instance)
+  {
+
+#if (USE_MOTION_SENSOR_LIS2MDL_0 == 1)
+    case LIS2MDL_0:
+      ret = BSP_ERROR_COMPONENT_FAILURE;
+      break;
+#endif /* USE_MOTION_SENSOR_LIS2MDL_0 == 1 */
+#if (USE_MOTION_SENSOR_LSM6DSV16X_0 == 1)
+    case LSM6DSV16X_0:
+      if (((Function & MOTION_ACCELERO) == MOTION_ACCELERO) || ((Function & MOTION_GYRO) == MOTION_GYRO))
+      {
+        if (LSM6DSV16X_FIFO_Set_TS_Decimation(MotionCompObj[Instance], Decimation) != BSP_ERROR_NONE)
+        {
+          ret = BSP_ERROR_COMPONENT_FAILURE;
+        }
+        else
+        {
+          ret = BSP_ERROR_NONE;
+        }
+      }
+      else
+      {
+        ret = BSP_ERROR_WRONG_PARAM;
+      }
+      break;
+#endif /* USE_MOTION_SENSOR_LSM6DSV16X_0 == 1 */
+    default:
+      ret = BSP_ERROR_WRONG_PARAM;
+      break;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Read FIFO words (tag + 6 data bytes each one) in one single burst
+  * @param  Instance the device instance
+  * @param  pBuff The buffer to be fill with the read data (7 bytes for each word)
+  * @param  Words Number of FIFO words to read
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_FIFO_Read(uint32_t Instance, uint8_t *pBuff, uint16_t Words)
+{
+  int32_t ret;
+
+  switch (Instance)
+  {
+
+#if (USE_MOTION_SENSOR_LIS2MDL_0 == 1)
+    case LIS2MDL_0:
+      ret = BSP_ERROR_COMPONENT_FAILURE;
+      break;
+#endif /* USE_MOTION_SENSOR_LIS2MDL_0 == 1 */
+#if (USE_MOTION_SENSOR_LSM6DSV16X_0 == 1)
+    case LSM6DSV16X_0:
+      if (LSM6DSV16X_FIFO_Read(MotionCompObj[Instance], pBuff, Words) != BSP_ERROR_NONE)
+      {
+        ret = BSP_ERROR_COMPONENT_FAILURE;
+      }
+      else
+      {
+        ret = BSP_ERROR_NONE;
+      }
+      break;
+#endif /* USE_MOTION_SENSOR_LSM6DSV16X_0 == 1 */
+    default:
+      ret = BSP_ERROR_WRONG_PARAM;
+      break;
+  }
+
+  return ret;
+}
+
 /**
   * @brief  Set accelero self-test
   * @param  Instance the device instance
@@ -104,6 +104,8 @@ int32_t BSP_MOTION_SENSOR_FIFO_Get_Axis(uint32_t Instance, uint32_t Function, in
 int32_t BSP_MOTION_SENSOR_FIFO_Set_BDR(uint32_t Instance, uint32_t Function, float Bdr);
 int32_t BSP_MOTION_SENSOR_FIFO_Get_Tag(uint32_t Instance, uint8_t *Tag);
 int32_t BSP_MOTION_SENSOR_FIFO_Get_Axes(uint32_t Instance, uint32_t Function, BSP_MOTION_SENSOR_Axes_t *Data);
+int32_t BSP_MOTION_SENSOR_FIFO_TS_Decimation(uint32_t Instance, uint32_t Function, uint8_t Decimation);
+int32_t BSP_MOTION_SENSOR_FIFO_Read(uint32_t Instance, uint8_t *pBuff, uint16_t Words);
 int32_t BSP_MOTION_SENSOR_Set_SelfTest(uint32_t Instance, uint32_t Function, uint8_t Status);
 
 int32_t BSP_MOTION_SENSOR_Set_PowerMode(uint32_t Instance, uint32_t Functions, uint8_t powerMode);
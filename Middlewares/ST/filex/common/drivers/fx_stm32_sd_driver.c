@@ -13,6 +13,44 @@
 /* Include necessary system files.  */
 #include "fx_stm32_sd_driver.h"
 
+/* the write queue is implemented by the application glue (fx_stm32_sd_queue_write / fx_stm32_sd_queue_drain) */
+#ifndef FX_STM32_SD_WRITE_QUEUE
+#define FX_STM32_SD_WRITE_QUEUE 0
+#endif
+
+/* sectors of the scratch buffer: the consecutive sectors of one unaligned request are
+ * copied on it and transferred with one multi-block transfer */
+#ifndef FX_STM32_SD_SCRATCH_SECTORS
+#define FX_STM32_SD_SCRATCH_SECTORS 1
+#endif
+
+/* the statistics type (FX_STM32_SD_DRIVER_STATS) is defined by fx_stm32_sd_driver.h */
+#ifndef FX_STM32_SD_STATS
+#define FX_STM32_SD_STATS 0
+#endif
+
+/* time base of the card ready waits in the statistics */
+#ifndef FX_STM32_SD_CYCLES
+#define FX_STM32_SD_CYCLES() 0
+#endif
+
+/* the card ready wait is implemented by the application glue (fx_stm32_sd_wait_ready)
+ * with the end of the card busy signalled by the SD interrupts */
+#ifndef FX_STM32_SD_CARD_EVENTS
+#define FX_STM32_SD_CARD_EVENTS 0
+#endif
+
+/* sectors of the read-ahead buffer (0 for none): the sequential read requests smaller
+ * than it are served from it, filled with one multi-block transfer */
+#ifndef FX_STM32_SD_READ_AHEAD_SECTORS
+#define FX_STM32_SD_READ_AHEAD_SECTORS 0
+#endif
+
+/* consecutive sequential read requests before reading ahead */
+#ifndef FX_STM32_SD_READ_AHEAD_TRIGGER
+#define FX_STM32_SD_READ_AHEAD_TRIGGER 2
+#endif
+
 /*
  * the scratch buffer is required when performing DMA transfers using unaligned addresses
  * When CPU cache is enabled, the scratch buffer should be 32-byte aligned to match a whole cache line
@@ -20,32 +58,78 @@
  */
 
 #if (FX_STM32_SD_CACHE_MAINTENANCE == 1)
-static UCHAR scratch[FX_STM32_SD_DEFAULT_SECTOR_SIZE] __attribute__ ((aligned (32)));
+static UCHAR scratch[FX_STM32_SD_SCRATCH_SECTORS * FX_STM32_SD_DEFAULT_SECTOR_SIZE] __attribute__ ((aligned (32)));
+#else
+static UCHAR scratch[FX_STM32_SD_SCRATCH_SECTORS * FX_STM32_SD_DEFAULT_SECTOR_SIZE] __attribute__ ((aligned (4)));
+#endif
+
+#if (FX_STM32_SD_READ_AHEAD_SECTORS > 0)
+#if (FX_STM32_SD_CACHE_MAINTENANCE == 1)
+static UCHAR read_ahead[FX_STM32_SD_READ_AHEAD_SECTORS * FX_STM32_SD_DEFAULT_SECTOR_SIZE] __attribute__ ((aligned (32)));
 #else
-static UCHAR scratch[FX_STM32_SD_DEFAULT_SECTOR_SIZE] __attribute__ ((aligned (4)));
+static UCHAR read_ahead[FX_STM32_SD_READ_AHEAD_SECTORS * FX_STM32_SD_DEFAULT_SECTOR_SIZE] __attribute__ ((aligned (4)));
+#endif
+
+/* sectors held by the read-ahead buffer (none when read_ahead_count is 0) */
+static ULONG read_ahead_start;
+static UINT read_ahead_count;
+
+/* sequential stream detection */
+static ULONG read_next_sector;
+static UINT read_sequential;
+#endif
+
+#if (FX_STM32_SD_STATS == 1)
+FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats;
 #endif
 
 UINT  _fx_partition_offset_calculate(void  *partition_sector, UINT partition, ULONG *partition_start, ULONG *partition_size);
 
 static UINT sd_read_data(FX_MEDIA *media_ptr, ULONG sector, UINT num_sectors, UINT use_scratch_buffer);
 static UINT sd_write_data(FX_MEDIA *media_ptr, ULONG sector, UINT num_sectors, UINT use_scratch_buffer);
+#if (FX_STM32_SD_READ_AHEAD_SECTORS > 0)
+static UINT sd_read_ahead(FX_MEDIA *media_ptr, ULONG start_sector, UINT num_sectors, UINT use_scratch_buffer);
+static VOID sd_read_ahead_invalidate(ULONG start_sector, UINT num_sectors);
+#endif
 
 static UINT is_initialized = 0;
 
 
 static INT check_sd_status(uint32_t instance)
 {
+  INT ret = 1;
+#if (FX_STM32_SD_STATS == 1)
+  ULONG start_cycles = FX_STM32_SD_CYCLES();
+  ULONG cycles;
+#endif
+
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+  /* the thread sleeps until the end of the card busy */
+  ret = fx_stm32_sd_wait_ready(instance);
+#else
   uint32_t start = FX_STM32_SD_CURRENT_TIME();
 
   while (FX_STM32_SD_CURRENT_TIME() - start < FX_STM32_SD_DEFAULT_TIMEOUT)
   {
     if (fx_stm32_sd_get_status(instance) == 0)
     {
-      return 0;
+      ret = 0;
+      break;
     }
   }
+#endif
+
+#if (FX_STM32_SD_STATS == 1)
+  cycles = FX_STM32_SD_CYCLES() - start_cycles;
+  fx_stm32_sd_driver_stats.ReadyChecks++;
+  fx_stm32_sd_driver_stats.ReadyCycles += cycles;
+  if (cycles > fx_stm32_sd_driver_stats.ReadyMax)
+  {
+    fx_stm32_sd_driver_stats.ReadyMax = cycles;
+  }
+#endif
 
-  return 1;
+  return ret;
 }
 
 /**
@@ -65,6 +149,47 @@ VOID  fx_stm32_sd_driver(FX_MEDIA *media_ptr)
  /* the SD was initialized by the application */
   is_initialized = 1;
 #endif
+#if (FX_STM32_SD_READ_AHEAD_SECTORS > 0)
+  /* the sectors written are not valid on the read-ahead buffer anymore */
+  if (media_ptr->fx_media_driver_request == FX_DRIVER_WRITE)
+  {
+    sd_read_ahead_invalidate(media_ptr->fx_media_driver_logical_sector + media_ptr->fx_media_hidden_sectors,
+                             media_ptr->fx_media_driver_sectors);
+  }
+  else if ((media_ptr->fx_media_driver_request != FX_DRIVER_READ) && (media_ptr->fx_media_driver_request != FX_DRIVER_FLUSH))
+  {
+    /* boot write, init, uninit and abort */
+    read_ahead_count = 0;
+    read_sequential = 0;
+  }
+#endif
+#if (FX_STM32_SD_WRITE_QUEUE == 1)
+  if (is_initialized == 1)
+  {
+    /* the data sectors are queued, the FAT/directory writes and the other requests
+     * wait for the queued writes first, so they are done in the same order on the card */
+    if ((media_ptr->fx_media_driver_request == FX_DRIVER_WRITE) && (media_ptr->fx_media_driver_system_write == FX_FALSE))
+    {
+      media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+      if (fx_stm32_sd_queue_write(FX_STM32_SD_INSTANCE, (UINT *)media_ptr->fx_media_driver_buffer,
+                                  (UINT)(media_ptr->fx_media_driver_logical_sector + media_ptr->fx_media_hidden_sectors),
+                                  media_ptr->fx_media_driver_sectors) != 0)
+      {
+        media_ptr->fx_media_driver_status = FX_IO_ERROR;
+      }
+
+      return;
+    }
+
+    if (fx_stm32_sd_queue_drain(FX_STM32_SD_INSTANCE) != 0)
+    {
+      media_ptr->fx_media_driver_status = FX_IO_ERROR;
+      return;
+    }
+  }
+#endif
+
   /* before performing any operation, check the status of the SD IP */
   if (is_initialized == 1)
   {
@@ -89,6 +214,10 @@ VOID  fx_stm32_sd_driver(FX_MEDIA *media_ptr)
     {
       media_ptr->fx_media_driver_status = FX_SUCCESS;
 
+#if (FX_STM32_SD_STATS == 1)
+      _fx_utility_memory_set((UCHAR *)&fx_stm32_sd_driver_stats, 0, sizeof(fx_stm32_sd_driver_stats));
+#endif
+
       FX_STM32_SD_PRE_INIT(media_ptr);
 
 #if (FX_STM32_SD_INIT == 1)
@@ -138,8 +267,13 @@ VOID  fx_stm32_sd_driver(FX_MEDIA *media_ptr)
     {
       media_ptr->fx_media_driver_status = FX_IO_ERROR;
 
+#if (FX_STM32_SD_READ_AHEAD_SECTORS > 0)
+      if (sd_read_ahead(media_ptr, media_ptr->fx_media_driver_logical_sector + media_ptr->fx_media_hidden_sectors,
+                        media_ptr->fx_media_driver_sectors, unaligned_buffer) == FX_SUCCESS)
+#else
       if (sd_read_data(media_ptr, media_ptr->fx_media_driver_logical_sector + media_ptr->fx_media_hidden_sectors,
                        media_ptr->fx_media_driver_sectors, unaligned_buffer) == FX_SUCCESS)
+#endif
       {
         media_ptr->fx_media_driver_status = FX_SUCCESS;
       }
@@ -257,21 +391,38 @@ VOID  fx_stm32_sd_driver(FX_MEDIA *media_ptr)
 
 static UINT sd_read_data(FX_MEDIA *media_ptr, ULONG start_sector, UINT num_sectors, UINT use_scratch_buffer)
 {
-  INT i = 0;
+  UINT i = 0;
+  UINT count;
   UINT status;
   UCHAR *read_addr;
 
  /* perform the Pre read operations */
   FX_STM32_SD_PRE_READ_TRANSFER(media_ptr);
 
+#if (FX_STM32_SD_STATS == 1)
+  fx_stm32_sd_driver_stats.Requests++;
+  if (use_scratch_buffer)
+  {
+    fx_stm32_sd_driver_stats.UnalignedRequests++;
+    fx_stm32_sd_driver_stats.UnalignedSectors += num_sectors;
+  }
+#endif
+
   if (use_scratch_buffer)
   {
     read_addr = media_ptr->fx_media_driver_buffer;
 
-    for (i = 0; i < num_sectors; i++)
+    for (i = 0; i < num_sectors; i += count)
     {
+      /* read up to FX_STM32_SD_SCRATCH_SECTORS sectors with one transfer */
+      count = num_sectors - i;
+      if (count > FX_STM32_SD_SCRATCH_SECTORS)
+      {
+        count = FX_STM32_SD_SCRATCH_SECTORS;
+      }
+
       /* Start reading into the scratch buffer */
-      status = fx_stm32_sd_read_blocks(FX_STM32_SD_INSTANCE, (UINT *)scratch, (UINT)start_sector++, 1);
+      status = fx_stm32_sd_read_blocks(FX_STM32_SD_INSTANCE, (UINT *)scratch, (UINT)start_sector, count);
 
       if (status != 0)
       {
@@ -284,11 +435,16 @@ static UINT sd_read_data(FX_MEDIA *media_ptr, ULONG start_sector, UINT num_secto
        FX_STM32_SD_READ_CPLT_NOTIFY();
 
 #if (FX_STM32_SD_CACHE_MAINTENANCE == 1)
-      invalidate_cache_by_addr((uint32_t*)scratch, FX_STM32_SD_DEFAULT_SECTOR_SIZE);
+      invalidate_cache_by_addr((uint32_t*)scratch, count * FX_STM32_SD_DEFAULT_SECTOR_SIZE);
 #endif
 
-      _fx_utility_memory_copy(scratch, read_addr, FX_STM32_SD_DEFAULT_SECTOR_SIZE);
-      read_addr += FX_STM32_SD_DEFAULT_SECTOR_SIZE;
+#if (FX_STM32_SD_STATS == 1)
+      fx_stm32_sd_driver_stats.ScratchTransfers++;
+#endif
+
+      _fx_utility_memory_copy(scratch, read_addr, count * FX_STM32_SD_DEFAULT_SECTOR_SIZE);
+      read_addr += count * FX_STM32_SD_DEFAULT_SECTOR_SIZE;
+      start_sector += count;
     }
 
     /* Check if all sectors were read */
@@ -341,28 +497,49 @@ static UINT sd_read_data(FX_MEDIA *media_ptr, ULONG start_sector, UINT num_secto
 
 static UINT sd_write_data(FX_MEDIA *media_ptr, ULONG start_sector, UINT num_sectors, UINT use_scratch_buffer)
 {
-  INT i = 0;
+  UINT i = 0;
+  UINT count;
   UINT status;
   UCHAR *write_addr;
 
   /* call Pre write operation macro */
   FX_STM32_SD_PRE_WRITE_TRANSFER(media_ptr);
 
+#if (FX_STM32_SD_STATS == 1)
+  fx_stm32_sd_driver_stats.Requests++;
+  if (use_scratch_buffer)
+  {
+    fx_stm32_sd_driver_stats.UnalignedRequests++;
+    fx_stm32_sd_driver_stats.UnalignedSectors += num_sectors;
+  }
+#endif
+
   if (use_scratch_buffer)
   {
     write_addr = media_ptr->fx_media_driver_buffer;
 
-    for (i = 0; i < num_sectors; i++)
+    for (i = 0; i < num_sectors; i += count)
     {
-      _fx_utility_memory_copy(write_addr, scratch, FX_STM32_SD_DEFAULT_SECTOR_SIZE);
-      write_addr += FX_STM32_SD_DEFAULT_SECTOR_SIZE;
+      /* write up to FX_STM32_SD_SCRATCH_SECTORS sectors with one transfer */
+      count = num_sectors - i;
+      if (count > FX_STM32_SD_SCRATCH_SECTORS)
+      {
+        count = FX_STM32_SD_SCRATCH_SECTORS;
+      }
+
+      _fx_utility_memory_copy(write_addr, scratch, count * FX_STM32_SD_DEFAULT_SECTOR_SIZE);
+      write_addr += count * FX_STM32_SD_DEFAULT_SECTOR_SIZE;
 
 #if (FX_STM32_SD_CACHE_MAINTENANCE == 1)
       /* Clean the DCache to make the SD DMA see the actual content of the scratch buffer */
-      clean_cache_by_addr((uint32_t*)scratch, FX_STM32_SD_DEFAULT_SECTOR_SIZE);
+      clean_cache_by_addr((uint32_t*)scratch, count * FX_STM32_SD_DEFAULT_SECTOR_SIZE);
+#endif
+
+#if (FX_STM32_SD_STATS == 1)
+      fx_stm32_sd_driver_stats.ScratchTransfers++;
 #endif
 
-      status = fx_stm32_sd_write_blocks(FX_STM32_SD_INSTANCE, (UINT *)scratch, (UINT)start_sector++, 1);
+      status = fx_stm32_sd_write_blocks(FX_STM32_SD_INSTANCE, (UINT *)scratch, (UINT)start_sector, count);
 
       if (status != 0)
       {
@@ -373,6 +550,8 @@ static UINT sd_write_data(FX_MEDIA *media_ptr, ULONG start_sector, UINT num_sect
 
       /*  */
        FX_STM32_SD_WRITE_CPLT_NOTIFY();
+
+      start_sector += count;
     }
 
     if (i == num_sectors)
@@ -409,3 +588,115 @@ static UINT sd_write_data(FX_MEDIA *media_ptr, ULONG start_sector, UINT num_sect
 
   return status;
 }
+
+#if (FX_STM32_SD_READ_AHEAD_SECTORS > 0)
+/**
+* @brief Read data through the read-ahead buffer: the sectors already on it are
+* copied, the sequential requests smaller than it fill it with the next sectors
+* with one multi-block transfer, the other requests are read directly
+* @param FX_MEDIA *media_ptr a pointer the main FileX structure
+* @param ULONG start_sector first sector to start reading from
+* @param UINT num_sectors number of sectors to be read
+* @param UINT use_scratch_buffer to enable scratch buffer usage or not.
+* @retval FX_SUCCESS on success FX_BUFFER_ERROR / FX_ACCESS_ERROR / FX_IO_ERROR otherwise
+*/
+static UINT sd_read_ahead(FX_MEDIA *media_ptr, ULONG start_sector, UINT num_sectors, UINT use_scratch_buffer)
+{
+  UCHAR *buffer = media_ptr->fx_media_driver_buffer;
+  UCHAR *read_addr = buffer;
+  ULONG64 end_sector;
+  UINT status = FX_SUCCESS;
+  UINT count;
+
+  /* one request after the previous one or after the read-ahead buffer continues the stream */
+  if ((start_sector == read_next_sector) ||
+      ((read_ahead_count != 0) && (start_sector == read_ahead_start + read_ahead_count)))
+  {
+    if (read_sequential < FX_STM32_SD_READ_AHEAD_TRIGGER)
+    {
+      read_sequential++;
+    }
+  }
+  else
+  {
+    read_sequential = 0;
+  }
+  read_next_sector = start_sector + num_sectors;
+
+  while ((num_sectors > 0) && (status == FX_SUCCESS))
+  {
+    if ((read_ahead_count != 0) && (start_sector >= read_ahead_start) &&
+        (start_sector < read_ahead_start + read_ahead_count))
+    {
+      /* already read */
+      count = read_ahead_start + read_ahead_count - start_sector;
+      if (count > num_sectors)
+      {
+        count = num_sectors;
+      }
+
+      _fx_utility_memory_copy(read_ahead + (start_sector - read_ahead_start) * FX_STM32_SD_DEFAULT_SECTOR_SIZE,
+                              read_addr, count * FX_STM32_SD_DEFAULT_SECTOR_SIZE);
+
+#if (FX_STM32_SD_STATS == 1)
+      fx_stm32_sd_driver_stats.ReadAheadHits += count;
+#endif
+
+      read_addr += count * FX_STM32_SD_DEFAULT_SECTOR_SIZE;
+      start_sector += count;
+      num_sectors -= count;
+      continue;
+    }
+
+    /* the read-ahead doesn't go after the end of the media */
+    count = FX_STM32_SD_READ_AHEAD_SECTORS;
+    end_sector = media_ptr->fx_media_total_sectors + media_ptr->fx_media_hidden_sectors;
+    if (start_sector + (ULONG64)count > end_sector)
+    {
+      count = (start_sector < end_sector) ? (UINT)(end_sector - start_sector) : 0;
+    }
+
+    if ((read_sequential < FX_STM32_SD_READ_AHEAD_TRIGGER) || (num_sectors >= count))
+    {
+      /* random access, or big enough for one single transfer */
+      media_ptr->fx_media_driver_buffer = read_addr;
+      status = sd_read_data(media_ptr, start_sector, num_sectors, use_scratch_buffer);
+      break;
+    }
+
+    /* fill the read-ahead buffer from the first sector requested */
+    read_ahead_count = 0;
+    media_ptr->fx_media_driver_buffer = read_ahead;
+    status = sd_read_data(media_ptr, start_sector, count, 0);
+
+    if (status == FX_SUCCESS)
+    {
+      read_ahead_start = start_sector;
+      read_ahead_count = count;
+
+#if (FX_STM32_SD_STATS == 1)
+      fx_stm32_sd_driver_stats.ReadAheadFills++;
+#endif
+    }
+  }
+
+  media_ptr->fx_media_driver_buffer = buffer;
+
+  return status;
+}
+
+/**
+* @brief Discard the read-ahead buffer if it has some sectors written
+* @param ULONG start_sector first sector written
+* @param UINT num_sectors number of sectors written
+* @retval None
+*/
+static VOID sd_read_ahead_invalidate(ULONG start_sector, UINT num_sectors)
+{
+  if ((read_ahead_count != 0) && (start_sector < read_ahead_start + read_ahead_count) &&
+      (start_sector + num_sectors > read_ahead_start))
+  {
+    read_ahead_count = 0;
+  }
+}
+#endif
@@ -428,6 +428,48 @@ VOID _fx_trace_event_update(TX_TRACE_BUFFER_ENTRY *event, ULONG timestamp, ULONG
 #define FX_MAX_FAT_CACHE                       16   /* Minimum value is 8, all values must be a power of 2.  */
 #endif
 
+/* Define the size of the free cluster map of the FAT12/16/32 media (FX_ENABLE_FAT_FREE_MAP).  This
+   represents how many groups of clusters are tracked: each group (a power of 2 clusters, so that
+   all the clusters fit in the map) keeps the number of its free clusters, so the cluster allocation
+   skips the full groups without reading their FAT entries.  */
+
+#ifndef FX_FAT_FREE_MAP_SIZE
+#define FX_FAT_FREE_MAP_SIZE                   1024 /* Minimum 1, maximum any. This represents how many 16-bit counters are used. */
+#endif
+
+/* Define the value of one group of the free cluster map not counted yet.  */
+
+#define FX_FAT_FREE_MAP_UNKNOWN                0xFFFF
+
+/* Define the size of the directory hash index of the FAT12/16/32 media (FX_ENABLE_DIRECTORY_HASH).
+   This represents how many names of one large directory can be indexed: each slot keeps part of
+   the hash of one long or short name and the number of its directory entry, so the directory search
+   reads only the entries of the matching names.  The index is discarded when it is 3/4 full.  */
+
+#ifndef FX_DIRECTORY_HASH_SIZE
+#define FX_DIRECTORY_HASH_SIZE                 4096 /* Minimum 16, all values must be a power of 2. This represents how many 32-bit slots are used. */
+#endif
+
+/* Define the number of entries read by one linear search before its directory is indexed at the
+   next search.  Smaller directories are not indexed, so they don't replace the index.  */
+
+#ifndef FX_DIRECTORY_HASH_MIN_ENTRIES
+#define FX_DIRECTORY_HASH_MIN_ENTRIES          64
+#endif
+
+/* Define the maximum number of clusters of the indexed directory.  */
+
+#ifndef FX_DIRECTORY_HASH_MAX_CLUSTERS
+#define FX_DIRECTORY_HASH_MAX_CLUSTERS         32
+#endif
+
+/* Define the values of the empty and of the removed slots of the directory hash index, and
+   of no directory to index.  */
+
+#define FX_DIRECTORY_HASH_EMPTY                0xFFFFFFFF
+#define FX_DIRECTORY_HASH_REMOVED              0xFFFFFFFE
+#define FX_DIRECTORY_HASH_NONE                 0xFFFFFFFF
+
 
 /* Define the size of fault tolerant cache, which is used when freeing FAT chain. */
 
@@ -1141,6 +1183,40 @@ typedef struct FX_MEDIA_STRUCT
        close to update sectors of any secondary FATs in the media.  */
     UCHAR               fx_media_fat_secondary_update_map[FX_FAT_MAP_SIZE];
 
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+    /* Define the free cluster map of FAT12/16/32 media: the number of free clusters of each
+       group of 2^shift clusters, or FX_FAT_FREE_MAP_UNKNOWN if it is not known.  The groups are
+       counted at media open when the FAT is read, otherwise the groups read by the searches without
+       free clusters are marked full.  */
+    UINT                fx_media_fat_free_map_valid;
+    UINT                fx_media_fat_free_map_shift;
+    ULONG               fx_media_fat_free_map_groups;
+    USHORT              fx_media_fat_free_map[FX_FAT_FREE_MAP_SIZE];
+#endif
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+    /* Define the directory hash index of FAT12/16/32 media: the names of one large directory
+       (first cluster, 0 for the root directory) with the number of their directory entry.  The
+       index is built at the search that follows one linear search of at least threshold entries
+       in the directory (the candidate), it's updated by the directory entry writes and discarded
+       by the media cache invalidate.  The free start is the first entry that may be free, the
+       skipped directory is the last one that could not be indexed.  */
+    UINT                fx_media_directory_hash_valid;
+    ULONG               fx_media_directory_hash_cluster;
+    ULONG               fx_media_directory_hash_candidate;
+    ULONG               fx_media_directory_hash_skipped;
+    ULONG               fx_media_directory_hash_threshold;
+    ULONG               fx_media_directory_hash_entries;
+    ULONG               fx_media_directory_hash_free_start;
+    ULONG               fx_media_directory_hash_used;
+    ULONG               fx_media_directory_hash_builds;
+    ULONG               fx_media_directory_hash_cluster_count;
+    ULONG               fx_media_directory_hash_clusters[FX_DIRECTORY_HASH_MAX_CLUSTERS];
+    ULONG               fx_media_directory_hash_table[FX_DIRECTORY_HASH_SIZE];
+#endif
+
     /* Define a variable for the application's use.  */
     ALIGN_TYPE          fx_media_reserved_for_user;
 
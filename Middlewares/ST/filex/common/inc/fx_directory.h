@@ -133,5 +133,21 @@ UINT  _fx_directory_free_search(FX_MEDIA *media_ptr, FX_DIR_ENTRY *directory_ptr
 CHAR *_fx_directory_name_extract(CHAR *source_ptr, CHAR *dest_ptr);
 UINT  _fx_directory_search(FX_MEDIA *media_ptr, CHAR *name_ptr, FX_DIR_ENTRY *entry_ptr, FX_DIR_ENTRY *last_dir_ptr, CHAR **last_name_ptr);
 
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+/* Define the directory hash index key of one search directory (NULL for the root directory), and the
+   slot of one name hash and directory entry number.  */
+#define FX_DIRECTORY_HASH_KEY(d)        (((d) == FX_NULL) ? 0 : (d) -> fx_dir_entry_cluster)
+#define FX_DIRECTORY_HASH_TAG(h)        (((h) >> 1) & 0x7FFF0000)
+#define FX_DIRECTORY_HASH_SLOT(h, e)    (FX_DIRECTORY_HASH_TAG(h) | (e))
+
+UINT  _fx_directory_hash_build(FX_MEDIA *media_ptr, FX_DIR_ENTRY *search_dir_ptr, ULONG directory_size, FX_DIR_ENTRY *entry_ptr);
+UINT  _fx_directory_hash_insert(FX_MEDIA *media_ptr, ULONG hash, ULONG entry);
+ULONG _fx_directory_hash_name_get(CHAR *name, UINT length);
+UINT  _fx_directory_hash_search(FX_MEDIA *media_ptr, FX_DIR_ENTRY *search_dir_ptr, ULONG directory_size, CHAR *name, FX_DIR_ENTRY *entry_ptr);
+VOID  _fx_directory_hash_update(FX_MEDIA *media_ptr, FX_DIR_ENTRY *entry_ptr, CHAR *short_name,
+                                ULONG logical_sector, ULONG byte_offset, UINT delete_flag);
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
 #endif
 
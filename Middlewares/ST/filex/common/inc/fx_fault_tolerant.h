@@ -128,6 +128,23 @@
 #define FX_FAULT_TOLERANT_BITMAP_LOG_ENTRY_SIZE   sizeof(FX_FAULT_TOLERANT_BITMAP_LOG)
 #define FX_FAULT_TOLERANT_DIR_LOG_ENTRY_SIZE      sizeof(FX_FAULT_TOLERANT_DIR_LOG)
 
+/* Define the free cluster map discard after the recovery of one transaction.  */
+#ifdef FX_ENABLE_FAT_FREE_MAP
+VOID    _fx_utility_FAT_free_map_initialize(FX_MEDIA *media_ptr, UINT counted);
+#define FX_FAULT_TOLERANT_FAT_FREE_MAP_DISCARD(m)                        \
+    _fx_utility_FAT_free_map_initialize(m, FX_FALSE);
+#else
+#define FX_FAULT_TOLERANT_FAT_FREE_MAP_DISCARD(m)
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
+/* Define the directory hash index discard after the recovery of one transaction.  */
+#ifdef FX_ENABLE_DIRECTORY_HASH
+#define FX_FAULT_TOLERANT_DIRECTORY_HASH_DISCARD(m)                      \
+    (m) -> fx_media_directory_hash_valid =  FX_FALSE;
+#else
+#define FX_FAULT_TOLERANT_DIRECTORY_HASH_DISCARD(m)
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
 #ifdef FX_FAULT_TOLERANT_TRANSACTION_FAIL_FUNCTION
 #define FX_FAULT_TOLERANT_TRANSACTION_FAIL _fx_fault_tolerant_transaction_fail
 #else
@@ -140,6 +157,8 @@
         {                                                                \
             _fx_fault_tolerant_recover(m);                               \
             _fx_fault_tolerant_reset_log_file(m);                        \
+            FX_FAULT_TOLERANT_FAT_FREE_MAP_DISCARD(m)                    \
+            FX_FAULT_TOLERANT_DIRECTORY_HASH_DISCARD(m)                  \
         }                                                                \
     }
 
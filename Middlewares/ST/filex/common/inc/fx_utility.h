@@ -77,6 +77,12 @@ UINT    _fx_utility_FAT_entry_read(FX_MEDIA *media_ptr, ULONG cluster, ULONG *en
 UINT    _fx_utility_FAT_entry_write(FX_MEDIA *media_ptr, ULONG cluster, ULONG next_cluster);
 UINT    _fx_utility_FAT_flush(FX_MEDIA *media_ptr);
 UINT    _fx_utility_FAT_map_flush(FX_MEDIA *media_ptr);
+#ifdef FX_ENABLE_FAT_FREE_MAP
+UINT    _fx_utility_FAT_free_cluster_find(FX_MEDIA *media_ptr, ULONG search_start_cluster, ULONG *free_cluster);
+VOID    _fx_utility_FAT_free_map_initialize(FX_MEDIA *media_ptr, UINT counted);
+VOID    _fx_utility_FAT_free_map_update(FX_MEDIA *media_ptr, ULONG cluster, ULONG next_cluster);
+ULONG   _fx_utility_FAT_free_run_get(FX_MEDIA *media_ptr, ULONG cluster);
+#endif /* FX_ENABLE_FAT_FREE_MAP */
 ULONG   _fx_utility_FAT_sector_get(FX_MEDIA *media_ptr, ULONG cluster);
 UINT    _fx_utility_string_length_get(CHAR *string, UINT max_length);
 
@@ -66,6 +66,7 @@
 /*    _fx_utility_16_unsigned_write         Write a UINT from memory      */
 /*    _fx_utility_32_unsigned_write         Write a ULONG from memory     */
 /*    _fx_fault_tolerant_add_dir_log        Add directory redo log        */
+/*    _fx_directory_hash_update             Update directory hash index   */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -80,6 +81,7 @@
 /*                                            resulting in version 6.1    */
 /*  03-02-2021     William E. Lamie         Modified comment(s),          */
 /*                                            resulting in version 6.1.5  */
+/*  10-17-2026     STMicroelectronics       Added directory hash index    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_directory_entry_write(FX_MEDIA *media_ptr, FX_DIR_ENTRY *entry_ptr)
@@ -101,6 +103,9 @@ UCHAR *changed_ptr;
 UINT   changed_size;
 ULONG  changed_offset;
 #endif /* FX_ENABLE_FAULT_TOLERANT */
+#ifdef FX_ENABLE_DIRECTORY_HASH
+CHAR   hash_short_name[FX_DIR_NAME_SIZE + FX_DIR_EXT_SIZE];
+#endif /* FX_ENABLE_DIRECTORY_HASH */
 
 
 #ifndef FX_MEDIA_STATISTICS_DISABLE
@@ -1032,6 +1037,15 @@ ULONG  changed_offset;
 
     /* Write out the 8.3 part of the name. */
 
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+    /* Save the short name written for the directory hash index.  */
+    for (i = 0; i < (FX_DIR_NAME_SIZE + FX_DIR_EXT_SIZE); i++)
+    {
+        hash_short_name[i] =  (CHAR)*(work_ptr - (FX_DIR_NAME_SIZE + FX_DIR_EXT_SIZE) + i);
+    }
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
     /* Copy the attribute into the destination.  */
     *work_ptr++ =  entry_ptr -> fx_dir_entry_attributes;
 
@@ -1117,6 +1131,12 @@ ULONG  changed_offset;
         return(status);
     }
 
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+    /* Update the directory hash index with the entry written.  */
+    _fx_directory_hash_update(media_ptr, entry_ptr, hash_short_name, logical_sector, byte_offset, delete_flag);
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
 #ifndef FX_MEDIA_DISABLE_SEARCH_CACHE
 
     /* Determine if there is a previously found directory entry in the directory
@@ -86,6 +86,7 @@
 /*                                            updated available cluster   */
 /*                                            check for sub directory,    */
 /*                                            resulting in version 6.1.12 */
+/*  10-17-2026     STMicroelectronics       Added directory hash index    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_directory_free_search(FX_MEDIA *media_ptr, FX_DIR_ENTRY *directory_ptr, FX_DIR_ENTRY *entry_ptr)
@@ -321,6 +322,19 @@ FX_INT_SAVE_AREA
         directory_index =  0;
     }
 
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+    /* Start at the first free entry if the directory is indexed, the entries before it are used.  */
+    if ((media_ptr -> fx_media_directory_hash_valid) &&
+        (media_ptr -> fx_media_directory_hash_cluster == FX_DIRECTORY_HASH_KEY(search_dir_ptr)) &&
+        (media_ptr -> fx_media_directory_hash_entries == directory_entries) &&
+        (media_ptr -> fx_media_directory_hash_free_start > directory_index))
+    {
+        directory_index =  (media_ptr -> fx_media_directory_hash_free_start < directory_entries) ?
+                           media_ptr -> fx_media_directory_hash_free_start : (directory_entries - 1);
+    }
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
     /* Loop through entries in the search directory.  Yes, this is a
        linear search!  */
     free_entry_start = directory_entries;
@@ -745,6 +759,17 @@ FX_INT_SAVE_AREA
                 /* Update the directory size field.  */
                 directory_ptr -> fx_dir_entry_file_size =  directory_entries;
 
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+                /* Index the directory again with its new clusters at its next search.  */
+                if ((media_ptr -> fx_media_directory_hash_valid) &&
+                    (media_ptr -> fx_media_directory_hash_cluster == FX_DIRECTORY_HASH_KEY(search_dir_ptr)))
+                {
+                    media_ptr -> fx_media_directory_hash_valid =      FX_FALSE;
+                    media_ptr -> fx_media_directory_hash_candidate =  FX_DIRECTORY_HASH_KEY(search_dir_ptr);
+                }
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
                 /* Defer the update of the FAT entry and the last cluster of the current
                    directory entry until after the new cluster is initialized and written out.  */
 
@@ -0,0 +1,249 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Directory                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_directory.h"
+#include "fx_utility.h"
+
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_directory_hash_build                            PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function builds the directory hash index of the supplied       */
+/*    directory with one linear read of its entries: the long and the     */
+/*    short name of each entry are added to the index, up to the last     */
+/*    entry as the directory search.  The clusters of the directory are   */
+/*    saved to find the directory entries written later, and the first    */
+/*    free entry to start the free entry searches.  The exFAT media and   */
+/*    the directories too large for the index are not indexed, they are   */
+/*    skipped up to the next media open.                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    search_dir_ptr                        Directory to index (NULL for  */
+/*                                            the root directory)         */
+/*    directory_size                        Number of directory entries   */
+/*    entry_ptr                             Directory entry work area     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    FX_SUCCESS                            Index built                   */
+/*    FX_NOT_AVAILABLE                      Directory not indexed         */
+/*    return status                         Read error                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_directory_entry_read              Read entries from directory   */
+/*    _fx_directory_hash_insert             Add name to the index         */
+/*    _fx_directory_hash_name_get           Get name hash                 */
+/*    _fx_utility_FAT_entry_read            Read FAT entries to find the  */
+/*                                            directory clusters          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_hash_search                                           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_directory_hash_build(FX_MEDIA *media_ptr, FX_DIR_ENTRY *search_dir_ptr, ULONG directory_size, FX_DIR_ENTRY *entry_ptr)
+{
+
+ULONG i, entry;
+ULONG cluster, next_cluster = 0;
+ULONG count;
+UINT  status;
+
+
+    /* Discard the previous index and the candidate directory.  */
+    media_ptr -> fx_media_directory_hash_valid =      FX_FALSE;
+    media_ptr -> fx_media_directory_hash_candidate =  FX_DIRECTORY_HASH_NONE;
+
+#ifdef FX_ENABLE_EXFAT
+
+    /* The exFAT directory entries have their own name hash.  */
+    if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+    {
+        media_ptr -> fx_media_directory_hash_skipped =  FX_DIRECTORY_HASH_KEY(search_dir_ptr);
+        return(FX_NOT_AVAILABLE);
+    }
+#endif /* FX_ENABLE_EXFAT */
+
+    /* The index keeps 16-bit entry numbers.  */
+    if (directory_size > 0x10000)
+    {
+        media_ptr -> fx_media_directory_hash_skipped =  FX_DIRECTORY_HASH_KEY(search_dir_ptr);
+        return(FX_NOT_AVAILABLE);
+    }
+
+    /* Pickup the first cluster of the directory, the FAT12/16 root directory has no clusters.  */
+    if (search_dir_ptr)
+    {
+        cluster =  search_dir_ptr -> fx_dir_entry_cluster;
+    }
+    else if (media_ptr -> fx_media_32_bit_FAT)
+    {
+        cluster =  media_ptr -> fx_media_root_cluster_32;
+    }
+    else
+    {
+        cluster =  0;
+    }
+
+    /* Follow the link of FAT entries to save the clusters of the directory.  */
+    count =  0;
+    while ((cluster >= FX_FAT_ENTRY_START) && (cluster < media_ptr -> fx_media_fat_reserved))
+    {
+
+        /* Determine if the directory is too large for the index.  */
+        if (count >= FX_DIRECTORY_HASH_MAX_CLUSTERS)
+        {
+            media_ptr -> fx_media_directory_hash_skipped =  FX_DIRECTORY_HASH_KEY(search_dir_ptr);
+            return(FX_NOT_AVAILABLE);
+        }
+
+        /* Save the cluster.  */
+        media_ptr -> fx_media_directory_hash_clusters[count++] =  cluster;
+
+        /* Read the next FAT entry.  */
+        status =  _fx_utility_FAT_entry_read(media_ptr, cluster, &next_cluster);
+
+        /* Check the return status.  */
+        if (status != FX_SUCCESS)
+        {
+            return(status);
+        }
+
+        /* Check for error situation.  */
+        if ((cluster == next_cluster) || (count > media_ptr -> fx_media_total_clusters))
+        {
+            return(FX_FAT_READ_ERROR);
+        }
+
+        cluster =  next_cluster;
+    }
+
+    /* Clear the index.  */
+    for (i = 0; i < FX_DIRECTORY_HASH_SIZE; i++)
+    {
+        media_ptr -> fx_media_directory_hash_table[i] =  FX_DIRECTORY_HASH_EMPTY;
+    }
+    media_ptr -> fx_media_directory_hash_used =        0;
+    media_ptr -> fx_media_directory_hash_free_start =  directory_size;
+
+    /* Loop through entries in the directory, as the directory search.  */
+    i =  0;
+    while (i < directory_size)
+    {
+
+        /* Read an entry from the directory, its number is the first entry of its long name.  */
+        entry =  i;
+        status =  _fx_directory_entry_read(media_ptr, search_dir_ptr, &i, entry_ptr);
+
+        /* Check for error status.  */
+        if (status != FX_SUCCESS)
+        {
+            return(status);
+        }
+
+        /* Determine if this is the last directory entry.  */
+        if ((UCHAR)entry_ptr -> fx_dir_entry_name[0] == (UCHAR)FX_DIR_ENTRY_DONE)
+        {
+
+            /* The free entries start here, if not before.  */
+            if (entry < media_ptr -> fx_media_directory_hash_free_start)
+            {
+                media_ptr -> fx_media_directory_hash_free_start =  entry;
+            }
+            break;
+        }
+
+        /* Determine if this is an empty entry.  */
+        if (((UCHAR)entry_ptr -> fx_dir_entry_name[0] == (UCHAR)FX_DIR_ENTRY_FREE) && (entry_ptr -> fx_dir_entry_short_name[0] == 0))
+        {
+
+            /* Remember the first free entry.  */
+            if (entry < media_ptr -> fx_media_directory_hash_free_start)
+            {
+                media_ptr -> fx_media_directory_hash_free_start =  entry;
+            }
+        }
+        /* Add the names of the entry, the volume label is not searched.  */
+        else if ((entry_ptr -> fx_dir_entry_attributes & FX_VOLUME) == 0)
+        {
+
+            /* Add the name.  */
+            status =  _fx_directory_hash_insert(media_ptr, _fx_directory_hash_name_get(entry_ptr -> fx_dir_entry_name, FX_MAX_LONG_NAME_LEN), entry);
+
+            /* Add the short name of the long name.  */
+            if ((status == FX_SUCCESS) && (entry_ptr -> fx_dir_entry_short_name[0] != 0))
+            {
+                status =  _fx_directory_hash_insert(media_ptr, _fx_directory_hash_name_get(entry_ptr -> fx_dir_entry_short_name, FX_MAX_SHORT_NAME_LEN), entry);
+            }
+
+            /* Determine if the index is full.  */
+            if (status != FX_SUCCESS)
+            {
+                media_ptr -> fx_media_directory_hash_skipped =  FX_DIRECTORY_HASH_KEY(search_dir_ptr);
+                return(FX_NOT_AVAILABLE);
+            }
+        }
+
+        /* Move to the next entry.  */
+        i++;
+    }
+
+    /* The index is valid for this directory.  */
+    media_ptr -> fx_media_directory_hash_cluster =        FX_DIRECTORY_HASH_KEY(search_dir_ptr);
+    media_ptr -> fx_media_directory_hash_entries =        directory_size;
+    media_ptr -> fx_media_directory_hash_cluster_count =  count;
+    media_ptr -> fx_media_directory_hash_valid =          FX_TRUE;
+    media_ptr -> fx_media_directory_hash_builds++;
+
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
@@ -0,0 +1,129 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Directory                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_directory.h"
+
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_directory_hash_insert                           PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds one name hash with the number of its directory   */
+/*    entry to the directory hash index (open addressing with linear      */
+/*    probing), if it is not already present.  The index is discarded if  */
+/*    it would be more than 3/4 full.                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    hash                                  Name hash                     */
+/*    entry                                 Directory entry number        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    FX_SUCCESS                            Name hash present             */
+/*    FX_NO_MORE_SPACE                      Index discarded               */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_hash_build                                            */
+/*    _fx_directory_hash_update                                           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_directory_hash_insert(FX_MEDIA *media_ptr, ULONG hash, ULONG entry)
+{
+
+ULONG slot;
+ULONG index;
+ULONG probes;
+
+
+    /* Build the slot of the name.  */
+    slot =  FX_DIRECTORY_HASH_SLOT(hash, entry);
+
+    /* Loop through the slots of the hash up to one empty slot.  */
+    index =  hash & (FX_DIRECTORY_HASH_SIZE - 1);
+    for (probes = 0; probes < FX_DIRECTORY_HASH_SIZE; probes++)
+    {
+
+        /* Is the name already present?  */
+        if (media_ptr -> fx_media_directory_hash_table[index] == slot)
+        {
+            return(FX_SUCCESS);
+        }
+
+        /* Is this the end of the slots of the hash?  */
+        if (media_ptr -> fx_media_directory_hash_table[index] == FX_DIRECTORY_HASH_EMPTY)
+        {
+            break;
+        }
+
+        /* Move to the next slot.  */
+        index =  (index + 1) & (FX_DIRECTORY_HASH_SIZE - 1);
+    }
+
+    /* Determine if the index is full, the removed slots are reused only when the index is built.  */
+    if (media_ptr -> fx_media_directory_hash_used >= ((FX_DIRECTORY_HASH_SIZE / 4) * 3))
+    {
+
+        /* Discard the index, the directory is searched linearly up to the next build.  */
+        media_ptr -> fx_media_directory_hash_valid =  FX_FALSE;
+        return(FX_NO_MORE_SPACE);
+    }
+
+    /* Store the name in the empty slot.  */
+    media_ptr -> fx_media_directory_hash_table[index] =  slot;
+    media_ptr -> fx_media_directory_hash_used++;
+
+    return(FX_SUCCESS);
+}
+
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
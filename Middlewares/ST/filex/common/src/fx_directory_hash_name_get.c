@@ -0,0 +1,119 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Directory                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_directory.h"
+
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_directory_hash_name_get                         PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates the hash of the directory hash index of    */
+/*    one name (FNV-1a).  The lower case letters are hashed as upper      */
+/*    case and the spaces and the dots are skipped, so that one short     */
+/*    name has the same hash as written in its directory entry (11        */
+/*    characters with spaces) and as read back (with the dot).            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    name                                  Name pointer                  */
+/*    length                                Maximum length of the name    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    Hash of the name                                                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_hash_build                                            */
+/*    _fx_directory_hash_search                                           */
+/*    _fx_directory_hash_update                                           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+ULONG  _fx_directory_hash_name_get(CHAR *name, UINT length)
+{
+
+ULONG hash;
+UINT  i;
+CHAR  alpha;
+
+
+    /* Loop through the name.  */
+    hash =  2166136261UL;
+    for (i = 0; (i < length) && (name[i]); i++)
+    {
+
+        /* Pickup the character.  */
+        alpha =  name[i];
+
+        /* Skip the spaces and the dots.  */
+        if ((alpha == ' ') || (alpha == '.'))
+        {
+            continue;
+        }
+
+        /* Determine if its case needs to be changed.  */
+        if ((alpha >= 'a') && (alpha <= 'z'))
+        {
+
+            /* Yes, make upper case.  */
+            alpha =  (CHAR)((INT)alpha - 0x20);
+        }
+
+        /* Add the character to the hash.  */
+        hash =  (hash ^ (UCHAR)alpha) * 16777619UL;
+    }
+
+    /* Return the hash (32 bit also with 64 bit ULONG).  */
+    return(hash & 0xFFFFFFFFUL);
+}
+
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
@@ -0,0 +1,310 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Directory                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_directory.h"
+
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+static UINT  _fx_directory_hash_name_match(FX_DIR_ENTRY *entry_ptr, CHAR *name);
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_directory_hash_search                           PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function searches one name in the supplied directory with the  */
+/*    directory hash index: only the entries with the same name hash are  */
+/*    read and compared as the linear search does, and the first one in   */
+/*    the directory is returned.  The index is built if the directory is  */
+/*    the candidate one, otherwise the caller searches linearly.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    search_dir_ptr                        Directory to search (NULL for */
+/*                                            the root directory)         */
+/*    directory_size                        Number of directory entries   */
+/*    name                                  Name to search                */
+/*    entry_ptr                             Pointer to directory entry    */
+/*                                            record                      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    FX_SUCCESS                            Name found                    */
+/*    FX_NOT_FOUND                          Name not present              */
+/*    FX_NOT_AVAILABLE                      Directory not indexed         */
+/*    return status                         Read error                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_directory_entry_read              Read entries from directory   */
+/*    _fx_directory_hash_build              Build the index               */
+/*    _fx_directory_hash_name_get           Get name hash                 */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_search                                                */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_directory_hash_search(FX_MEDIA *media_ptr, FX_DIR_ENTRY *search_dir_ptr, ULONG directory_size, CHAR *name, FX_DIR_ENTRY *entry_ptr)
+{
+
+ULONG hash;
+ULONG slot;
+ULONG index;
+ULONG probes;
+ULONG entry;
+ULONG found_entry;
+ULONG read_entry;
+UINT  status;
+
+
+    /* Determine if the index is valid for this directory.  */
+    if ((media_ptr -> fx_media_directory_hash_valid == FX_FALSE) ||
+        (media_ptr -> fx_media_directory_hash_cluster != FX_DIRECTORY_HASH_KEY(search_dir_ptr)) ||
+        (media_ptr -> fx_media_directory_hash_entries != directory_size))
+    {
+
+        /* Only the candidate directory is indexed.  */
+        if (media_ptr -> fx_media_directory_hash_candidate != FX_DIRECTORY_HASH_KEY(search_dir_ptr))
+        {
+            return(FX_NOT_AVAILABLE);
+        }
+
+        /* Build the index of this directory.  */
+        status =  _fx_directory_hash_build(media_ptr, search_dir_ptr, directory_size, entry_ptr);
+        if (status != FX_SUCCESS)
+        {
+            return(status);
+        }
+    }
+
+    /* Loop through the slots of the name hash up to one empty slot.  */
+    hash =         _fx_directory_hash_name_get(name, FX_MAX_LONG_NAME_LEN);
+    found_entry =  FX_DIRECTORY_HASH_EMPTY;
+    read_entry =   FX_DIRECTORY_HASH_EMPTY;
+    index =        hash & (FX_DIRECTORY_HASH_SIZE - 1);
+    for (probes = 0; probes < FX_DIRECTORY_HASH_SIZE; probes++)
+    {
+
+        /* Pickup the slot.  */
+        slot =  media_ptr -> fx_media_directory_hash_table[index];
+        if (slot == FX_DIRECTORY_HASH_EMPTY)
+        {
+            break;
+        }
+
+        /* Determine if the slot has the same hash and is before the entry found.  */
+        entry =  slot & 0xFFFF;
+        if ((slot != FX_DIRECTORY_HASH_REMOVED) &&
+            ((slot & 0x7FFF0000) == FX_DIRECTORY_HASH_TAG(hash)) && (entry < found_entry))
+        {
+
+            /* Read the entry from the directory.  */
+            read_entry =  entry;
+            status =  _fx_directory_entry_read(media_ptr, search_dir_ptr, &entry, entry_ptr);
+
+            /* Check for error status.  */
+            if (status != FX_SUCCESS)
+            {
+                return(status);
+            }
+
+            /* Compare the names.  */
+            if (_fx_directory_hash_name_match(entry_ptr, name))
+            {
+                found_entry =  read_entry;
+            }
+        }
+
+        /* Move to the next slot.  */
+        index =  (index + 1) & (FX_DIRECTORY_HASH_SIZE - 1);
+    }
+
+    /* Determine if the name was found.  */
+    if (found_entry == FX_DIRECTORY_HASH_EMPTY)
+    {
+        return(FX_NOT_FOUND);
+    }
+
+    /* Read the entry found again, if another entry was read after it.  */
+    if (read_entry != found_entry)
+    {
+        status =  _fx_directory_entry_read(media_ptr, search_dir_ptr, &found_entry, entry_ptr);
+        if (status != FX_SUCCESS)
+        {
+            return(status);
+        }
+    }
+
+    return(FX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_directory_hash_name_match                       PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function compares one directory entry with the name searched   */
+/*    as the linear directory search: the long name without case, the     */
+/*    short name with the name in upper case.                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    entry_ptr                             Directory entry read          */
+/*    name                                  Name to search                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    FX_TRUE if the entry has the name                                   */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_hash_search                                           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _fx_directory_hash_name_match(FX_DIR_ENTRY *entry_ptr, CHAR *name)
+{
+
+CHAR *work_ptr;
+CHAR *dir_name_ptr;
+CHAR  alpha, name_alpha;
+
+
+    /* Skip the last, the volume label and the empty entries.  */
+    if (((UCHAR)entry_ptr -> fx_dir_entry_name[0] == (UCHAR)FX_DIR_ENTRY_DONE) ||
+        (entry_ptr -> fx_dir_entry_attributes & FX_VOLUME) ||
+        (((UCHAR)entry_ptr -> fx_dir_entry_name[0] == (UCHAR)FX_DIR_ENTRY_FREE) && (entry_ptr -> fx_dir_entry_short_name[0] == 0)))
+    {
+        return(FX_FALSE);
+    }
+
+    /* Compare the input name with the directory entry.  */
+    work_ptr =      name;
+    dir_name_ptr =  entry_ptr -> fx_dir_entry_name;
+    do
+    {
+
+        /* Pickup the characters in upper case.  */
+        alpha =       *dir_name_ptr;
+        name_alpha =  *work_ptr;
+        if ((alpha >= 'a') && (alpha <= 'z'))
+        {
+            alpha =  (CHAR)((INT)alpha - 0x20);
+        }
+        if ((name_alpha >= 'a') && (name_alpha <= 'z'))
+        {
+            name_alpha =  (CHAR)((INT)name_alpha - 0x20);
+        }
+
+        /* Compare name with directory name.  */
+        if (alpha != name_alpha)
+        {
+            break;
+        }
+
+        work_ptr++;
+        dir_name_ptr++;
+    } while (*dir_name_ptr);
+
+    /* Determine if the name matches.  */
+    if ((*dir_name_ptr == 0) && (*work_ptr == *dir_name_ptr))
+    {
+        return(FX_TRUE);
+    }
+
+    /* Determine if there is a short name to check.  */
+    if (entry_ptr -> fx_dir_entry_short_name[0] == 0)
+    {
+        return(FX_FALSE);
+    }
+
+    /* Compare the input name in upper case with the short name.  */
+    work_ptr =      name;
+    dir_name_ptr =  entry_ptr -> fx_dir_entry_short_name;
+    do
+    {
+
+        /* Pickup the characters.  */
+        alpha =       *dir_name_ptr;
+        name_alpha =  *work_ptr;
+        if ((name_alpha >= 'a') && (name_alpha <= 'z'))
+        {
+            name_alpha =  (CHAR)((INT)name_alpha - 0x20);
+        }
+
+        /* Compare name with directory name.  */
+        if (alpha != name_alpha)
+        {
+            break;
+        }
+
+        work_ptr++;
+        dir_name_ptr++;
+    } while (*dir_name_ptr);
+
+    /* Determine if the names match.  */
+    return(((*dir_name_ptr == 0) && (*work_ptr == *dir_name_ptr)) ? FX_TRUE : FX_FALSE);
+}
+
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
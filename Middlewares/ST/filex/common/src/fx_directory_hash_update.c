@@ -0,0 +1,250 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Directory                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_directory.h"
+
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+static UINT  _fx_directory_hash_entry_get(FX_MEDIA *media_ptr, ULONG logical_sector, ULONG byte_offset, ULONG *entry_ptr);
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_directory_hash_update                           PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the directory hash index after one directory  */
+/*    entry write, if the entry is in the indexed directory: the names of */
+/*    one new entry are added and the slots of one deleted entry are      */
+/*    removed, so that no slot points inside the long name entries of     */
+/*    another name.  The first free entry is moved after the entries      */
+/*    written on it or before the entries deleted.                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    entry_ptr                             Directory entry written       */
+/*    short_name                            Short name written (11        */
+/*                                            characters with spaces)     */
+/*    logical_sector                        Sector of the short name      */
+/*                                            entry written               */
+/*    byte_offset                           Offset of the short name      */
+/*                                            entry written               */
+/*    delete_flag                           Entry deleted                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_directory_hash_entry_get          Get entry number              */
+/*    _fx_directory_hash_insert             Add name to the index         */
+/*    _fx_directory_hash_name_get           Get name hash                 */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_entry_write                                           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_directory_hash_update(FX_MEDIA *media_ptr, FX_DIR_ENTRY *entry_ptr, CHAR *short_name,
+                                ULONG logical_sector, ULONG byte_offset, UINT delete_flag)
+{
+
+ULONG entry;
+ULONG last_entry;
+ULONG i;
+
+
+    /* Determine if there is an index.  */
+    if (media_ptr -> fx_media_directory_hash_valid == FX_FALSE)
+    {
+        return;
+    }
+
+    /* Find the numbers of the first and of the short name entries in the indexed directory.  */
+    if ((_fx_directory_hash_entry_get(media_ptr, (ULONG)entry_ptr -> fx_dir_entry_log_sector, entry_ptr -> fx_dir_entry_byte_offset, &entry) == FX_FALSE) ||
+        (_fx_directory_hash_entry_get(media_ptr, logical_sector, byte_offset, &last_entry) == FX_FALSE) ||
+        (last_entry < entry))
+    {
+        return;
+    }
+
+    /* Determine if the entry is deleted.  */
+    if (delete_flag)
+    {
+
+        /* Remove the slots of the entry, its names are not known anymore.  */
+        for (i = 0; i < FX_DIRECTORY_HASH_SIZE; i++)
+        {
+            if ((media_ptr -> fx_media_directory_hash_table[i] < FX_DIRECTORY_HASH_REMOVED) &&
+                ((media_ptr -> fx_media_directory_hash_table[i] & 0xFFFF) == entry))
+            {
+                media_ptr -> fx_media_directory_hash_table[i] =  FX_DIRECTORY_HASH_REMOVED;
+            }
+        }
+
+        /* The entries of the name are free.  */
+        if (entry < media_ptr -> fx_media_directory_hash_free_start)
+        {
+            media_ptr -> fx_media_directory_hash_free_start =  entry;
+        }
+        return;
+    }
+
+    /* The free entries marked by the free entry search have no name.  */
+    if ((UCHAR)entry_ptr -> fx_dir_entry_name[0] == (UCHAR)FX_DIR_ENTRY_FREE)
+    {
+        return;
+    }
+
+    /* Add the name and the short name, nothing is added for one entry already present.  */
+    if ((_fx_directory_hash_insert(media_ptr, _fx_directory_hash_name_get(entry_ptr -> fx_dir_entry_name, FX_MAX_LONG_NAME_LEN), entry) != FX_SUCCESS) ||
+        (_fx_directory_hash_insert(media_ptr, _fx_directory_hash_name_get(short_name, FX_DIR_NAME_SIZE + FX_DIR_EXT_SIZE), entry) != FX_SUCCESS))
+    {
+        return;
+    }
+
+    /* Move the first free entry after the entries written on it.  */
+    if ((entry <= media_ptr -> fx_media_directory_hash_free_start) &&
+        (media_ptr -> fx_media_directory_hash_free_start <= last_entry))
+    {
+        media_ptr -> fx_media_directory_hash_free_start =  last_entry + 1;
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_directory_hash_entry_get                        PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function calculates the number of one directory entry in the   */
+/*    indexed directory from its logical sector and offset, with the      */
+/*    clusters of the directory saved when the index was built.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    logical_sector                        Sector of the entry           */
+/*    byte_offset                           Offset of the entry in sector */
+/*    entry_ptr                             Destination of the entry      */
+/*                                            number                      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    FX_TRUE if the entry is in the indexed directory                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_directory_hash_update                                           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+static UINT  _fx_directory_hash_entry_get(FX_MEDIA *media_ptr, ULONG logical_sector, ULONG byte_offset, ULONG *entry_ptr)
+{
+
+ULONG cluster;
+ULONG offset;
+ULONG i;
+
+
+    /* Determine if the indexed directory is the FAT12/16 root directory.  */
+    if ((media_ptr -> fx_media_directory_hash_cluster == 0) && (media_ptr -> fx_media_32_bit_FAT == 0))
+    {
+
+        /* Determine if the sector is in the root directory.  */
+        if ((logical_sector < (ULONG)media_ptr -> fx_media_root_sector_start) ||
+            (logical_sector >= (ULONG)(media_ptr -> fx_media_root_sector_start + media_ptr -> fx_media_root_sectors)))
+        {
+            return(FX_FALSE);
+        }
+        offset =  (logical_sector - (ULONG)media_ptr -> fx_media_root_sector_start) * media_ptr -> fx_media_bytes_per_sector;
+    }
+    else
+    {
+
+        /* Determine if the sector is in one cluster of the directory.  */
+        if (logical_sector < (ULONG)media_ptr -> fx_media_data_sector_start)
+        {
+            return(FX_FALSE);
+        }
+        cluster =  (logical_sector - (ULONG)media_ptr -> fx_media_data_sector_start) / media_ptr -> fx_media_sectors_per_cluster + FX_FAT_ENTRY_START;
+        for (i = 0; i < media_ptr -> fx_media_directory_hash_cluster_count; i++)
+        {
+            if (media_ptr -> fx_media_directory_hash_clusters[i] == cluster)
+            {
+                break;
+            }
+        }
+        if (i == media_ptr -> fx_media_directory_hash_cluster_count)
+        {
+            return(FX_FALSE);
+        }
+        offset =  ((i * media_ptr -> fx_media_sectors_per_cluster) +
+                   ((logical_sector - (ULONG)media_ptr -> fx_media_data_sector_start) % media_ptr -> fx_media_sectors_per_cluster)) *
+                  media_ptr -> fx_media_bytes_per_sector;
+    }
+
+    /* Return the entry number.  */
+    *entry_ptr =  (offset + byte_offset) / FX_DIR_ENTRY_SIZE;
+    return(FX_TRUE);
+}
+
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
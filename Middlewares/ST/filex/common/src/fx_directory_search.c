@@ -76,6 +76,8 @@ FX_LOCAL_PATH_SETUP
 /*    _fx_utility_exFAT_name_hash_get       Get name hash                 */
 /*    _fx_utility_FAT_entry_read            Read FAT entries to calculate */
 /*                                            the sub-directory size      */
+/*    _fx_directory_hash_search             Search with the directory     */
+/*                                            hash index                  */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -97,6 +99,7 @@ FX_LOCAL_PATH_SETUP
 /*  01-31-2022     William E. Lamie         Modified comment(s), and      */
 /*                                            fixed path compare,         */
 /*                                            resulting in version 6.1.10 */
+/*  10-17-2026     STMicroelectronics       Added directory hash index    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_directory_search(FX_MEDIA *media_ptr, CHAR *name_ptr, FX_DIR_ENTRY *entry_ptr,
@@ -634,6 +637,26 @@ USHORT        hash = 0;
         }
 #endif /* FX_ENABLE_EXFAT */
 
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+        /* Search the name with the directory hash index, if this directory is indexed.  */
+        status =  _fx_directory_hash_search(media_ptr, search_dir_ptr, (ULONG)directory_size, name, entry_ptr);
+        if (status == FX_SUCCESS)
+        {
+            found =  FX_TRUE;
+        }
+        else if (status == FX_NOT_FOUND)
+        {
+            return(FX_NOT_FOUND);
+        }
+        else if (status != FX_NOT_AVAILABLE)
+        {
+            return(status);
+        }
+
+        /* Otherwise search linearly.  */
+        if (!found)
+#endif /* FX_ENABLE_DIRECTORY_HASH */
         do
         {
 
@@ -789,6 +812,16 @@ USHORT        hash = 0;
             }
         } while ((i < directory_size) && (!found));
 
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+        /* Index this directory at its next search if this search read many entries.  */
+        if ((i >= media_ptr -> fx_media_directory_hash_threshold) &&
+            (media_ptr -> fx_media_directory_hash_skipped != FX_DIRECTORY_HASH_KEY(search_dir_ptr)))
+        {
+            media_ptr -> fx_media_directory_hash_candidate =  FX_DIRECTORY_HASH_KEY(search_dir_ptr);
+        }
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
         /* Now determine if we have a match.  */
         if (!found)
         {
@@ -74,6 +74,7 @@
 /*    _fx_utility_FAT_entry_read            Read a FAT entry              */
 /*    _fx_utility_16_unsigned_read          Read a USHORT from memory     */
 /*    _fx_utility_32_unsigned_read          Read a ULONG from memory      */
+/*    _fx_utility_FAT_free_map_initialize   Discard free cluster map      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -90,6 +91,9 @@
 /*                                            fixed memory buffer when    */
 /*                                            cache is disabled,          */
 /*                                            resulting in version 6.2.0  */
+/*  10-17-2026     STMicroelectronics       Added free cluster map of     */
+/*                                            FAT12/16/32 media           */
+/*  10-17-2026     STMicroelectronics       Added directory hash index    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_fault_tolerant_enable(FX_MEDIA *media_ptr, VOID *memory_buffer, UINT memory_size)
@@ -527,6 +531,18 @@ ULONG                         bytes_per_cluster;
     /* Initialize the sector number of cached FAT entries. */
     media_ptr -> fx_media_fault_tolerant_cached_FAT_sector = 0;
 
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+    /* Count the free cluster map again after the recovery of the log.  */
+    _fx_utility_FAT_free_map_initialize(media_ptr, FX_FALSE);
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+    /* Discard the directory hash index after the recovery of the log.  */
+    media_ptr -> fx_media_directory_hash_valid =  FX_FALSE;
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
     /* Release media protection.  */
     FX_UNPROTECT
 
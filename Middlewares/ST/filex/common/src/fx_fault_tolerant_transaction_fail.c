@@ -51,7 +51,9 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    _fx_fault_tolerant_recover            Recover FAT chain             */
+/*    _fx_fault_tolerant_reset_log_file     Reset the log file            */
+/*    _fx_utility_FAT_free_map_initialize   Discard free cluster map      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -78,6 +80,9 @@
 /*  05-19-2020     William E. Lamie         Initial Version 6.0           */
 /*  09-30-2020     William E. Lamie         Modified comment(s),          */
 /*                                            resulting in version 6.1    */
+/*  10-17-2026     STMicroelectronics       Added free cluster map of     */
+/*                                            FAT12/16/32 media           */
+/*  10-17-2026     STMicroelectronics       Added directory hash index    */
 /*                                                                        */
 /**************************************************************************/
 UINT _fx_fault_tolerant_transaction_fail(FX_MEDIA *media_ptr)
@@ -97,6 +102,12 @@ UINT _fx_fault_tolerant_transaction_fail(FX_MEDIA *media_ptr)
             /* Yes. Perform recover and reset the log file. */
             _fx_fault_tolerant_recover(media_ptr);
             _fx_fault_tolerant_reset_log_file(media_ptr);
+
+            /* Count the free cluster map again after the recovery.  */
+            FX_FAULT_TOLERANT_FAT_FREE_MAP_DISCARD(media_ptr)
+
+            /* Discard the directory hash index, the directories may be changed.  */
+            FX_FAULT_TOLERANT_DIRECTORY_HASH_DISCARD(media_ptr)
         }
     }
 
@@ -81,6 +81,8 @@
 /*    _fx_fault_tolerant_recover            Recover FAT chain             */
 /*    _fx_fault_tolerant_reset_log_file     Reset the log file            */
 /*    _fx_fault_tolerant_set_FAT_chain      Set data of FAT chain         */
+/*    _fx_utility_FAT_free_cluster_find     Find FAT free cluster         */
+/*    _fx_utility_FAT_free_run_get          Get free clusters of map      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -93,6 +95,8 @@
 /*  05-19-2020     William E. Lamie         Initial Version 6.0           */
 /*  09-30-2020     William E. Lamie         Modified comment(s),          */
 /*                                            resulting in version 6.1    */
+/*  10-17-2026     STMicroelectronics       Added free cluster map of     */
+/*                                            FAT12/16/32 media           */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_file_extended_best_effort_allocate(FX_FILE *file_ptr, ULONG64 size, ULONG64 *actual_size_allocated)
@@ -104,6 +108,9 @@ UINT                   found;
 ULONG                  bytes_per_cluster;
 ULONG                  FAT_index, start_FAT_index;
 ULONG                  FAT_value;
+#ifdef FX_ENABLE_FAT_FREE_MAP
+ULONG                  run;
+#endif /* FX_ENABLE_FAT_FREE_MAP */
 ULONG                  clusters, maximum_clusters;
 FX_MEDIA              *media_ptr;
 
@@ -351,6 +358,22 @@ ULONG                  trace_timestamp;
 
                 do
                 {
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+                    /* Skip the groups of the free cluster map with all the clusters free.  */
+                    run =  _fx_utility_FAT_free_run_get(media_ptr, FAT_index + i);
+                    if (run)
+                    {
+
+                        /* Count the free clusters of the group.  */
+                        i =  i + run;
+                        if (i > clusters)
+                        {
+                            i =  clusters;
+                        }
+                        continue;
+                    }
+#endif /* FX_ENABLE_FAT_FREE_MAP */
 
                     /* Read a FAT entry.  */
                     status =  _fx_utility_FAT_entry_read(media_ptr, (FAT_index + i), &FAT_value);
@@ -440,9 +463,36 @@ ULONG                  trace_timestamp;
                 else
                 {
 #endif /* FX_ENABLE_EXFAT */
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+                    /* Find the next free cluster, skipping the full groups of the free cluster map.  */
+                    status = _fx_utility_FAT_free_cluster_find(media_ptr, FAT_index + i + 1, &FAT_value);
+                    if ((status == FX_SUCCESS) && (FAT_value >= FAT_index + i + 1))
+                    {
+                        FAT_index = FAT_value;
+                    }
+                    else if ((status == FX_SUCCESS) || (status == FX_NO_MORE_SPACE))
+                    {
+
+                        /* No more free clusters up to the end of the FAT.  */
+                        FAT_index = media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START;
+                    }
+                    else
+                    {
+#ifdef FX_ENABLE_FAULT_TOLERANT
+                        FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
 
+                        /* Release media protection.  */
+                        FX_UNPROTECT
+
+                        /* Return the error status.  */
+                        return(status);
+                    }
+#else
                     /* Position to the next possibly free FAT entry.  */
                     FAT_index =  FAT_index + i + 1;
+#endif /* FX_ENABLE_FAT_FREE_MAP */
 #ifdef FX_ENABLE_EXFAT
                 }
 #endif /* FX_ENABLE_EXFAT */
@@ -82,6 +82,7 @@
 /*    _fx_fault_tolerant_recover            Recover FAT chain             */
 /*    _fx_fault_tolerant_reset_log_file     Reset the log file            */
 /*    _fx_fault_tolerant_set_FAT_chain      Set data of FAT chain         */
+/*    _fx_utility_FAT_free_cluster_find     Find FAT free cluster         */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -95,6 +96,8 @@
 /*  09-30-2020     William E. Lamie         Modified comment(s), verified */
 /*                                            memcpy usage,               */
 /*                                            resulting in version 6.1    */
+/*  10-17-2026     STMicroelectronics       Added free cluster map of     */
+/*                                            FAT12/16/32 media           */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_file_write(FX_FILE *file_ptr, VOID *buffer_ptr, ULONG size)
@@ -112,7 +115,9 @@ ULONG                  cluster, next_cluster;
 ULONG                  FAT_index;
 ULONG                  FAT_value;
 ULONG                  clusters;
+#ifndef FX_ENABLE_FAT_FREE_MAP
 ULONG                  total_clusters;
+#endif /* FX_ENABLE_FAT_FREE_MAP */
 UINT                   sectors;
 FX_MEDIA              *media_ptr;
 
@@ -567,8 +572,10 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
         }
 #endif /* FX_ENABLE_EXFAT && FX_ENABLE_FAULT_TOLERANT */
 
+#ifndef FX_ENABLE_FAT_FREE_MAP
         /* Search for the additional clusters we need.  */
         total_clusters =     media_ptr -> fx_media_total_clusters;
+#endif /* FX_ENABLE_FAT_FREE_MAP */
 
 #ifdef FX_ENABLE_FAULT_TOLERANT
         if (replace_clusters > 0)
@@ -763,6 +770,38 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
             {
 #endif /* FX_ENABLE_EXFAT */
 
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+                /* Find a free cluster, skipping the full groups of the free cluster map.  */
+                status =  _fx_utility_FAT_free_cluster_find(media_ptr, FAT_index, &FAT_index);
+
+                /* Check for a bad status (FX_NO_MORE_SPACE after one pass through the FAT table).  */
+                if (status != FX_SUCCESS)
+                {
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+                    FX_FAULT_TOLERANT_TRANSACTION_FAIL(media_ptr);
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+                    /* Release media protection.  */
+                    FX_UNPROTECT
+
+                    /* Return the bad status.  */
+                    return(status);
+                }
+
+                /* Move cluster search pointer forward.  */
+                media_ptr -> fx_media_cluster_search_start =  FAT_index + 1;
+
+                /* Determine if this needs to be wrapped.  */
+                if (media_ptr -> fx_media_cluster_search_start >= (media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
+                {
+
+                    /* Wrap the search to the beginning FAT entry.  */
+                    media_ptr -> fx_media_cluster_search_start =  FX_FAT_ENTRY_START;
+                }
+#else
+
                 /* Loop to find the first available cluster.  */
                 do
                 {
@@ -837,6 +876,7 @@ UCHAR                  dont_use_fat_old = FX_FALSE; /* Used by exFAT logic to in
                         }
                     }
                 } while (FX_TRUE);
+#endif /* FX_ENABLE_FAT_FREE_MAP */
 #ifdef FX_ENABLE_EXFAT
             }
 #endif /* FX_ENABLE_EXFAT */
@@ -59,6 +59,7 @@
 /*    _fx_utility_FAT_map_flush             Flush primary FAT changes to  */
 /*                                            secondary FAT(s)            */
 /*    _fx_utility_logical_sector_flush      Flush logical sector cache    */
+/*    _fx_utility_FAT_free_map_initialize   Discard free cluster map      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -71,6 +72,9 @@
 /*  05-19-2020     William E. Lamie         Initial Version 6.0           */
 /*  09-30-2020     William E. Lamie         Modified comment(s),          */
 /*                                            resulting in version 6.1    */
+/*  10-17-2026     STMicroelectronics       Added free cluster map of     */
+/*                                            FAT12/16/32 media           */
+/*  10-17-2026     STMicroelectronics       Added directory hash index    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_media_cache_invalidate(FX_MEDIA *media_ptr)
@@ -122,6 +126,18 @@ UINT i;
         media_ptr -> fx_media_fat_secondary_update_map[i] =  0;
     }
 
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+    /* Count the free cluster map again, the FAT may be changed.  */
+    _fx_utility_FAT_free_map_initialize(media_ptr, FX_FALSE);
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+    /* Discard the directory hash index, the directories may be changed.  */
+    media_ptr -> fx_media_directory_hash_valid =  FX_FALSE;
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
     /* Call the logical sector flush to invalidate the logical sector cache.  */
     status =  _fx_utility_logical_sector_flush(media_ptr, ((ULONG64) 1), (ULONG64) (media_ptr -> fx_media_total_sectors), FX_TRUE);
 
@@ -114,6 +114,7 @@
 /*    _fx_media_boot_info_extract           Extract media information     */
 /*    _fx_utility_FAT_entry_read            Pickup FAT entry contents     */
 /*    tx_mutex_create                       Create protection mutex       */
+/*    _fx_utility_FAT_free_map_initialize   Setup free cluster map        */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -136,6 +137,9 @@
 /*                                            fixed memory buffer when    */
 /*                                            cache is disabled,          */
 /*                                            resulting in version 6.2.0  */
+/*  10-17-2026     STMicroelectronics       Added free cluster map of     */
+/*                                            FAT12/16/32 media           */
+/*  10-17-2026     STMicroelectronics       Added directory hash index    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_media_open(FX_MEDIA *media_ptr, CHAR *media_name,
@@ -750,6 +754,26 @@ FX_INT_SAVE_AREA
         }
     }
 
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+    /* Setup the free cluster map: counted by the FAT search below, otherwise by the
+       first free cluster searches (FAT32 additional information sector).  */
+    _fx_utility_FAT_free_map_initialize(media_ptr, ((media_ptr -> fx_media_12_bit_FAT) ||
+                                                    (media_ptr -> fx_media_available_clusters == 0)) ? FX_TRUE : FX_FALSE);
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+    /* Setup the directory hash index: no directory is indexed before one search
+       reads more entries than the threshold.  */
+    media_ptr -> fx_media_directory_hash_valid =      FX_FALSE;
+    media_ptr -> fx_media_directory_hash_cluster =    FX_DIRECTORY_HASH_NONE;
+    media_ptr -> fx_media_directory_hash_candidate =  FX_DIRECTORY_HASH_NONE;
+    media_ptr -> fx_media_directory_hash_skipped =    FX_DIRECTORY_HASH_NONE;
+    media_ptr -> fx_media_directory_hash_threshold =  FX_DIRECTORY_HASH_MIN_ENTRIES;
+    media_ptr -> fx_media_directory_hash_builds =     0;
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
     /* Search the media to find the first available cluster as well as the total
        available clusters.  */
 
@@ -793,6 +817,15 @@ FX_INT_SAVE_AREA
                 /* Increment the number of available clusters.  */
                 media_ptr -> fx_media_available_clusters++;
 
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+                /* Count the free cluster in its group.  */
+                if (media_ptr -> fx_media_fat_free_map_valid)
+                {
+                    media_ptr -> fx_media_fat_free_map[cluster_number >> media_ptr -> fx_media_fat_free_map_shift]++;
+                }
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
                 /* Determine if the starting free cluster has been found yet.  */
                 if (media_ptr -> fx_media_cluster_search_start == 0)
                 {
@@ -917,6 +950,15 @@ FX_INT_SAVE_AREA
                     /* Entry is free, increment available clusters.  */
                     media_ptr -> fx_media_available_clusters++;
 
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+                    /* Count the free cluster in its group.  */
+                    if (media_ptr -> fx_media_fat_free_map_valid)
+                    {
+                        media_ptr -> fx_media_fat_free_map[cluster_number >> media_ptr -> fx_media_fat_free_map_shift]++;
+                    }
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
                     /* Determine if the starting free cluster has been found yet.  */
                     if (media_ptr -> fx_media_cluster_search_start == 0)
                     {
@@ -76,6 +76,7 @@
 /*  05-19-2020     William E. Lamie         Initial Version 6.0           */
 /*  09-30-2020     William E. Lamie         Modified comment(s),          */
 /*                                            resulting in version 6.1    */
+/*  10-17-2026     STMicroelectronics       Added directory hash index    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_unicode_directory_entry_change(FX_MEDIA *media_ptr, FX_DIR_ENTRY *entry_ptr, UCHAR *unicode_name, ULONG unicode_name_length)
@@ -102,6 +103,12 @@ ULONG  changed_offset;
     media_ptr -> fx_media_directory_entry_writes++;
 #endif
 
+#ifdef FX_ENABLE_DIRECTORY_HASH
+
+    /* Discard the directory hash index, the new long name is not hashed.  */
+    media_ptr -> fx_media_directory_hash_valid =  FX_FALSE;
+#endif /* FX_ENABLE_DIRECTORY_HASH */
+
     /* Pickup the byte offset of the entry.  */
     byte_offset = entry_ptr -> fx_dir_entry_byte_offset;
 
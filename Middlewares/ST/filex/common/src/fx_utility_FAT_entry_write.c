@@ -63,6 +63,7 @@
 /*    _fx_utility_FAT_flush                 FLUSH dirty entries in the    */
 /*                                            FAT cache                   */
 /*    _fx_fault_tolerant_add_fat_log        Add FAT redo log              */
+/*    _fx_utility_FAT_free_map_update       Update free cluster map       */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -75,6 +76,8 @@
 /*  05-19-2020     William E. Lamie         Initial Version 6.0           */
 /*  09-30-2020     William E. Lamie         Modified comment(s),          */
 /*                                            resulting in version 6.1    */
+/*  10-17-2026     STMicroelectronics       Added free cluster map of     */
+/*                                            FAT12/16/32 media           */
 /*                                                                        */
 /**************************************************************************/
 UINT  _fx_utility_FAT_entry_write(FX_MEDIA *media_ptr, ULONG cluster, ULONG next_cluster)
@@ -84,6 +87,15 @@ UINT                status, index, i;
 FX_FAT_CACHE_ENTRY *cache_entry_ptr;
 #ifdef FX_ENABLE_FAULT_TOLERANT
 ULONG               FAT_sector;
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+    /* Update the free clusters of the group before the entry is changed.  */
+    _fx_utility_FAT_free_map_update(media_ptr, cluster, next_cluster);
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
 
     /* While fault_tolerant is enabled, only FAT entries in the same sector are allowed to be cached. */
     /* We must flush FAT sectors in the order of FAT chains. */
@@ -0,0 +1,182 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_free_cluster_find                   PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function searches for a free cluster of FAT12/16/32 media,     */
+/*    from the search start to the end of the FAT and then from the       */
+/*    beginning.  With the free cluster map the groups without free       */
+/*    clusters are skipped without reading their FAT entries, and the     */
+/*    groups read by the search without free clusters are marked full.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    search_start_cluster                  Cluster number to begin search  */
+/*    free_cluster                          ULONG pointer to store cluster  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    FileX System Functions                                              */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _fx_utility_FAT_free_cluster_find(FX_MEDIA *media_ptr, ULONG search_start_cluster, ULONG *free_cluster)
+{
+
+UINT    status;
+UINT    pass;
+ULONG   cluster;
+ULONG   limit;
+ULONG   end_cluster;
+ULONG   group_start;
+ULONG   group_end;
+ULONG   FAT_index;
+ULONG   FAT_value;
+USHORT *count_ptr;
+
+
+    /* The data clusters go from FX_FAT_ENTRY_START to end_cluster - 1.  */
+    end_cluster =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START;
+    if ((search_start_cluster < FX_FAT_ENTRY_START) || (search_start_cluster >= end_cluster))
+    {
+        search_start_cluster =  FX_FAT_ENTRY_START;
+    }
+
+    /* Search from the start to the end of the FAT, then from the beginning to the start.  */
+    cluster =  search_start_cluster;
+    limit =    end_cluster;
+    for (pass = 0; pass < 2; pass++)
+    {
+
+        while (cluster < limit)
+        {
+
+            /* Without the map, the whole FAT is one group.  */
+            count_ptr =    FX_NULL;
+            group_start =  FX_FAT_ENTRY_START;
+            group_end =    end_cluster;
+            if (media_ptr -> fx_media_fat_free_map_valid)
+            {
+
+                /* Pickup the group of the cluster.  */
+                count_ptr =    &media_ptr -> fx_media_fat_free_map[cluster >> media_ptr -> fx_media_fat_free_map_shift];
+                group_start =  (cluster >> media_ptr -> fx_media_fat_free_map_shift) << media_ptr -> fx_media_fat_free_map_shift;
+                group_end =    group_start + (((ULONG)1) << media_ptr -> fx_media_fat_free_map_shift);
+                if (group_start < FX_FAT_ENTRY_START)
+                {
+                    group_start =  FX_FAT_ENTRY_START;
+                }
+                if (group_end > end_cluster)
+                {
+                    group_end =  end_cluster;
+                }
+
+                /* Skip the groups without free clusters.  */
+                if (*count_ptr == 0)
+                {
+                    cluster =  group_end;
+                    continue;
+                }
+            }
+
+            /* Read the FAT entries of the group up to the first free cluster.  */
+            for (FAT_index = cluster; FAT_index < group_end; FAT_index++)
+            {
+
+                status =  _fx_utility_FAT_entry_read(media_ptr, FAT_index, &FAT_value);
+                if (status != FX_SUCCESS)
+                {
+                    return(status);
+                }
+
+                /* Is this cluster free?  */
+                if (FAT_value == FX_FREE_CLUSTER)
+                {
+
+                    /* Is it before the limit?  */
+                    if (FAT_index < limit)
+                    {
+                        *free_cluster =  FAT_index;
+                        return(FX_SUCCESS);
+                    }
+                    break;
+                }
+            }
+
+            /* The whole group was read without free clusters: skip it from now on.  */
+            if ((count_ptr != FX_NULL) && (FAT_index == group_end) && (cluster == group_start))
+            {
+                *count_ptr =  0;
+            }
+
+            /* Move to the next group.  */
+            cluster =  group_end;
+        }
+
+        /* Wrap the search to the beginning FAT entry.  */
+        cluster =  FX_FAT_ENTRY_START;
+        limit =    search_start_cluster;
+    }
+
+    /* No more free clusters, return error.  */
+    return(FX_NO_MORE_SPACE);
+}
+
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
@@ -0,0 +1,131 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_free_map_initialize                 PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function initializes the free cluster map of FAT12/16/32       */
+/*    media: it picks the size of the groups of clusters so that all the  */
+/*    FAT entries fit in FX_FAT_FREE_MAP_SIZE groups, then it clears the  */
+/*    groups (counted by the caller while reading the FAT) or it marks    */
+/*    them as not counted (counted by the next free cluster searches).    */
+/*    It is also used to discard the map when the FAT is changed without  */
+/*    the FAT entry write utility.                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    counted                               FX_TRUE if counted by caller  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_media_open                                                      */
+/*    _fx_media_cache_invalidate                                          */
+/*    _fx_fault_tolerant_enable                                           */
+/*    _fx_fault_tolerant_transaction_fail                                 */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_FAT_free_map_initialize(FX_MEDIA *media_ptr, UINT counted)
+{
+
+ULONG  clusters;
+ULONG  i;
+UINT   shift;
+USHORT value;
+
+
+    /* The map covers all the FAT entries, the two reserved ones included.  */
+    clusters =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START;
+
+    /* Find the smallest group of clusters that fits the whole FAT in the map.  */
+    shift =  0;
+    while (((clusters + (((ULONG)1) << shift) - 1) >> shift) > FX_FAT_FREE_MAP_SIZE)
+    {
+        shift++;
+    }
+
+    media_ptr -> fx_media_fat_free_map_shift =   shift;
+    media_ptr -> fx_media_fat_free_map_groups =  (clusters + (((ULONG)1) << shift) - 1) >> shift;
+
+    /* The free clusters of one group must be less than FX_FAT_FREE_MAP_UNKNOWN.  */
+    media_ptr -> fx_media_fat_free_map_valid =  (shift <= 15) ? FX_TRUE : FX_FALSE;
+
+#ifdef FX_ENABLE_EXFAT
+
+    /* exFAT media have their own allocation bitmap.  */
+    if (media_ptr -> fx_media_FAT_type == FX_exFAT)
+    {
+        media_ptr -> fx_media_fat_free_map_valid =  FX_FALSE;
+    }
+#endif /* FX_ENABLE_EXFAT */
+
+    if (media_ptr -> fx_media_fat_free_map_valid == FX_FALSE)
+    {
+        return;
+    }
+
+    /* Clear the groups or mark them as not counted yet.  */
+    value =  (counted == FX_TRUE) ? 0 : FX_FAT_FREE_MAP_UNKNOWN;
+    for (i = 0; i < media_ptr -> fx_media_fat_free_map_groups; i++)
+    {
+        media_ptr -> fx_media_fat_free_map[i] =  value;
+    }
+}
+
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
@@ -0,0 +1,144 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+#ifdef FX_ENABLE_FAULT_TOLERANT
+#include "fx_fault_tolerant.h"
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_free_map_update                     PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the free cluster map of FAT12/16/32 media     */
+/*    before one FAT entry is written: the group of the cluster counts    */
+/*    one free cluster less when the entry is allocated and one more      */
+/*    when it is released.  While one fault tolerant transaction is       */
+/*    open the FAT entries are written by the log, so the group is only   */
+/*    marked as not counted.                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cluster                               Cluster entry number          */
+/*    next_cluster                          New value of the FAT entry    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _fx_utility_FAT_entry_read            Read a FAT entry              */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_utility_FAT_entry_write                                         */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _fx_utility_FAT_free_map_update(FX_MEDIA *media_ptr, ULONG cluster, ULONG next_cluster)
+{
+
+ULONG   old_value;
+USHORT *count_ptr;
+
+
+    /* Check for one map in use and for one data cluster.  */
+    if ((media_ptr -> fx_media_fat_free_map_valid == FX_FALSE) ||
+        (cluster < FX_FAT_ENTRY_START) ||
+        (cluster >= media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START))
+    {
+        return;
+    }
+
+    /* Pickup the group of the cluster.  */
+    count_ptr =  &media_ptr -> fx_media_fat_free_map[cluster >> media_ptr -> fx_media_fat_free_map_shift];
+
+    /* Nothing to do if the group is not counted yet.  */
+    if (*count_ptr == FX_FAT_FREE_MAP_UNKNOWN)
+    {
+        return;
+    }
+
+#ifdef FX_ENABLE_FAULT_TOLERANT
+
+    /* The FAT entries of one transaction are written by the log: count the group again.  */
+    if (media_ptr -> fx_media_fault_tolerant_enabled &&
+        (media_ptr -> fx_media_fault_tolerant_state & FX_FAULT_TOLERANT_STATE_STARTED))
+    {
+        *count_ptr =  FX_FAT_FREE_MAP_UNKNOWN;
+        return;
+    }
+#endif /* FX_ENABLE_FAULT_TOLERANT */
+
+    /* Read the current value of the FAT entry (usually from the FAT cache).  */
+    if (_fx_utility_FAT_entry_read(media_ptr, cluster, &old_value) != FX_SUCCESS)
+    {
+        *count_ptr =  FX_FAT_FREE_MAP_UNKNOWN;
+        return;
+    }
+
+    /* Update the free clusters of the group.  */
+    if ((old_value == FX_FREE_CLUSTER) && (next_cluster != FX_FREE_CLUSTER))
+    {
+
+        /* One cluster allocated.  */
+        if (*count_ptr > 0)
+        {
+            (*count_ptr)--;
+        }
+    }
+    else if ((old_value != FX_FREE_CLUSTER) && (next_cluster == FX_FREE_CLUSTER))
+    {
+
+        /* One cluster released.  */
+        (*count_ptr)++;
+    }
+}
+
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
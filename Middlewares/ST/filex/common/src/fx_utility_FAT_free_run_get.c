@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Partial Copyright (c) Microsoft Corporation. All rights reserved.*/
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*      Partial Copyright (c) STMicroelectronics 2026. All rights reserved*/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** FileX Component                                                       */
+/**                                                                       */
+/**   Utility                                                             */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define FX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "fx_api.h"
+#include "fx_system.h"
+#include "fx_utility.h"
+
+
+#ifdef FX_ENABLE_FAT_FREE_MAP
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _fx_utility_FAT_free_run_get                        PORTABLE C      */
+/*                                                           6.2.0        */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    STMicroelectronics                                                  */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns how many consecutive clusters from the        */
+/*    supplied one are free for the free cluster map, without reading     */
+/*    the FAT: the clusters up to the end of its group when all the       */
+/*    clusters of the group are free, otherwise zero.                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    media_ptr                             Media control block pointer   */
+/*    cluster                               Cluster entry number          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    Number of free clusters                                             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _fx_file_extended_allocate                                          */
+/*    _fx_file_extended_best_effort_allocate                              */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-17-2026     STMicroelectronics       Initial Version 6.2.0         */
+/*                                                                        */
+/**************************************************************************/
+ULONG  _fx_utility_FAT_free_run_get(FX_MEDIA *media_ptr, ULONG cluster)
+{
+
+ULONG end_cluster;
+ULONG group_start;
+ULONG group_end;
+
+
+    /* Check for one map in use and for one data cluster.  */
+    end_cluster =  media_ptr -> fx_media_total_clusters + FX_FAT_ENTRY_START;
+    if ((media_ptr -> fx_media_fat_free_map_valid == FX_FALSE) ||
+        (cluster < FX_FAT_ENTRY_START) || (cluster >= end_cluster))
+    {
+        return(0);
+    }
+
+    /* Pickup the bounds of the group.  */
+    group_start =  (cluster >> media_ptr -> fx_media_fat_free_map_shift) << media_ptr -> fx_media_fat_free_map_shift;
+    group_end =    group_start + (((ULONG)1) << media_ptr -> fx_media_fat_free_map_shift);
+    if (group_end > end_cluster)
+    {
+        group_end =  end_cluster;
+    }
+
+    /* Are all the clusters of the group free?  */
+    if (media_ptr -> fx_media_fat_free_map[cluster >> media_ptr -> fx_media_fat_free_map_shift] == (group_end - group_start))
+    {
+        return(group_end - cluster);
+    }
+
+    return(0);
+}
+
+#endif /* FX_ENABLE_FAT_FREE_MAP */
+
@@ -32,7 +32,7 @@ extern "C" {
 
 #define TX_APP_MEM_POOL_SIZE                     1024
 
-#define FX_APP_MEM_POOL_SIZE                     (1024*10)
+#define FX_APP_MEM_POOL_SIZE                     (1024*15)
 
 #ifdef __cplusplus
 }
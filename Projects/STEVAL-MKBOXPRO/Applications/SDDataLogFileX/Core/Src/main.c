@@ -53,6 +53,7 @@
 #include "SensorTileBoxPro.h"
 #include "SensorTileBoxPro_env_sensors.h"
 #include "SensorTileBoxPro_motion_sensors.h"
+#include "thread_profiler.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -441,7 +442,12 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
-
+#ifdef STBOX1_THREAD_PROFILER
+  if (htim->Instance == TIM6) {
+    /* Sample of the thread running at the HAL tick (lowest priority) */
+    ThreadProfiler_Sample();
+  }
+#endif /* STBOX1_THREAD_PROFILER */
   /* USER CODE END Callback 1 */
 }
 
@@ -24,6 +24,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "fx_stm32_sd_driver.h"
+#include "stm32u5xx_ll_lptim.h"
 #include "SensorTileBoxPro_audio.h"
 /* USER CODE END Includes */
 
@@ -179,9 +180,22 @@ void TIM6_IRQHandler(void)
 /* USER CODE BEGIN 1 */
 void SDMMC1_IRQHandler(void)
 {
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+  /* End of the card busy (not handled by the HAL) */
+  fx_stm32_sd_card_irq(FX_STM32_SD_INSTANCE);
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
   BSP_SD_IRQHandler(FX_STM32_SD_INSTANCE);
 }
 
+/**
+  * @brief This function handles LPTIM1 global interrupt (wake up from the
+  *        Stop 2 mode of the ThreadX idle, see app_threadx.c).
+  */
+void LPTIM1_IRQHandler(void)
+{
+  LL_LPTIM_ClearFlag_ARRM(LPTIM1);
+}
+
 /* USER CODE END 1 */
 
 /**
@@ -27,6 +27,166 @@
 /* For enabling the printf */
 #define STBOX1_ENABLE_PRINTF
 
+/* For saving the sensors as packed little-endian binary records (SensXXX.dat)
+ * instead of one text line for each sample (SensXXX.csv).
+ * The .dat files can be converted to .csv with the sens2csv host tool
+ * (Utilities/SDDataLogFileX) */
+//#define STBOX1_SENSORS_LOG_BINARY
+
+/* For reserving contiguous clusters for the sensors and audio files when
+ * the log starts (removing the FAT updates while recording).
+ * The clusters not used are released when the log is stopped */
+//#define STBOX1_SD_PREALLOCATION
+
+/* For saving the audio with a lossless compression (MicXXX.lac)
+ * instead of the PCM samples (MicXXX.wav).
+ * The .lac files can be converted to .wav with the lac2wav host tool
+ * (Utilities/SDDataLogFileX) */
+//#define STBOX1_AUDIO_COMPRESSION
+
+/* For reading the accelerometer and gyroscope from the LSM6DSV16X FIFO at
+ * STBOX1_IMU_FIFO_ODR, with the sensor's time stamps, instead of reading
+ * one sample at each Reading Timer tick (100Hz).
+ * The FIFO is read in bursts when it reaches STBOX1_IMU_FIFO_WATERMARK words
+ * (3 words for each sample: time stamp, accelerometer and gyroscope) */
+//#define STBOX1_IMU_FIFO
+#define STBOX1_IMU_FIFO_ODR 960.0f /* ODR = 960Hz */
+#define STBOX1_IMU_FIFO_WATERMARK 96 /* Max 255 */
+
+/* For saving all the sensors, the audio and some annotations on one single
+ * file (LogXXX.stb) made by time stamped chunks, with one index at the end,
+ * instead of the SensXXX and MicXXX files.
+ * The .stb files can be split with the stbsplit host tool
+ * (Utilities/SDDataLogFileX) */
+//#define STBOX1_LOG_CONTAINER
+
+/* For splitting each log on segments (one complete file for each segment,
+ * Sens000_000.csv, Sens000_001.csv...) when the current segment reaches
+ * STBOX1_LOG_ROTATION_SIZE or STBOX1_LOG_ROTATION_TIME.
+ * The next segment is opened and the previous one is closed by one
+ * background thread */
+//#define STBOX1_LOG_ROTATION
+#define STBOX1_LOG_ROTATION_SIZE 1024 /* MB for each segment (Max 4095) */
+#define STBOX1_LOG_ROTATION_TIME 3600 /* Seconds for each segment (0 for size only) */
+
+/* For mounting the SD cards formatted exFAT (usually the ones bigger than
+ * 32GB): it defines FX_ENABLE_EXFAT inside fx_user.h.
+ * The use of exFAT in one product requires a separate license from
+ * Microsoft (see the exFAT licensing notice inside fx_user.h) */
+//#define STBOX1_FX_EXFAT
+
+/* For saving one checkpoint of the log (sizes of the files written on the SD)
+ * every STBOX1_LOG_CHECKPOINT_TIME seconds, with the FileX fault tolerant
+ * module that keeps the FAT and the directories consistent.
+ * After one power loss, the log not closed is cut at its last checkpoint
+ * when the SD is opened again.
+ * It needs FX_ENABLE_FAULT_TOLERANT inside fx_user.h */
+//#define STBOX1_LOG_CHECKPOINT
+#define STBOX1_LOG_CHECKPOINT_TIME 5 /* Seconds between two checkpoints */
+
+/* For saving only the data around some events instead of the whole log.
+ * The last STBOX1_LOG_TRIGGER_PRE_TIME seconds of sensors and audio are kept
+ * on RAM and they are saved, with the next STBOX1_LOG_TRIGGER_POST_TIME
+ * seconds, when one trigger happens:
+ *  - the acceleration magnitude is over STBOX1_LOG_TRIGGER_ACC_THRESHOLD
+ *  - one MLC or FSM interrupt status of the LSM6DSV16X is set
+ *    (STBOX1_LOG_TRIGGER_EMB_FUNC, the MLC/FSM configuration must be
+ *    loaded on the sensor by the application)
+ *  - one click of the user button (one double click stops the log) */
+//#define STBOX1_LOG_TRIGGER
+#define STBOX1_LOG_TRIGGER_PRE_TIME 2 /* Seconds saved before the trigger */
+#define STBOX1_LOG_TRIGGER_POST_TIME 8 /* Seconds saved after the trigger */
+#define STBOX1_LOG_TRIGGER_ACC_THRESHOLD 2000 /* mg (0 for disabling it) */
+//#define STBOX1_LOG_TRIGGER_EMB_FUNC
+
+/* For finding the next free session on one small index file (Session.idx)
+ * instead of trying all the names from Sens000 at each start.
+ * The logs are saved on one directory for each STBOX1_LOG_SESSION_DIR_SIZE
+ * sessions (Logs000/Sens000.csv, ..., Logs001/Sens100.csv...) */
+//#define STBOX1_LOG_SESSION_INDEX
+#define STBOX1_LOG_SESSION_DIR_SIZE 100 /* Sessions for each directory */
+
+/* For saving the LogXXX.stb byte stream on one contiguous area reserved once
+ * (RawLog.bin) with sequential multi-block writes of STBOX1_LOG_RAW_BLOCK_SIZE
+ * bytes, without any FAT or directory update while logging.
+ * Each block has its session and sequence numbers, so the end of one session
+ * interrupted by one power loss is found at the next start.
+ * The sessions can be extracted from the SD (or its image) with the
+ * rawextract host tool (Utilities/SDDataLogFileX).
+ * It needs STBOX1_LOG_CONTAINER */
+//#define STBOX1_LOG_RAW
+#define STBOX1_LOG_RAW_SIZE 1024 /* MB reserved for RawLog.bin (Max 4095) */
+#define STBOX1_LOG_RAW_BLOCK_SIZE (32*1024) /* Bytes for each block */
+
+/* Number of sectors of the FileX media cache.
+ * A power of 2 (>=16) enables the FileX hashed logical sector cache and it
+ * must not exceed FX_MAX_SECTOR_CACHE defined inside fx_user.h */
+#define STBOX1_SD_MEDIA_CACHE_SECTORS 32 /* 16KB of RAM */
+
+/* For queuing the data sectors written by FileX on STBOX1_SD_WRITE_QUEUE_SLOTS
+ * buffers of the SD driver: each write returns after one copy and the slots are
+ * written in background, so the SD transfers and the card programming overlap
+ * the next writes. The reads, the FAT and directory writes and the flush wait
+ * for the queued writes first (same order on the card).
+ * The queue statistics are printed when the log is stopped */
+//#define STBOX1_SD_WRITE_QUEUE
+#define STBOX1_SD_WRITE_QUEUE_SLOTS 4 /* Slots of 16KB (STBOX1_LOG_RAW_BLOCK_SIZE with STBOX1_LOG_RAW) */
+
+/* Sectors of the aligned scratch buffer of the SD driver: the FileX requests with
+ * one buffer not 4-Bytes aligned are copied on it and moved with one multi-block
+ * transfer for each STBOX1_SD_SCRATCH_SECTORS sectors (1 for one transfer for
+ * each sector) */
+#define STBOX1_SD_SCRATCH_SECTORS 32 /* 16KB (one write batch) */
+
+/* For waiting the end of the card programming after each write on the SDMMC
+ * busy end interrupt (BUSYD0END) instead of polling the card status before each
+ * SD request: the waiting thread sleeps and the other threads run meanwhile.
+ * If the interrupt doesn't come, the card status is checked again after 1, 2, 4 ..
+ * STBOX1_SD_CARD_MAX_BACKOFF ticks */
+//#define STBOX1_SD_CARD_EVENTS
+#define STBOX1_SD_CARD_MAX_BACKOFF 4 /* ThreadX ticks (10mS) */
+
+/* For reading the next sectors in advance when FileX reads one file sequentially
+ * with small requests (for example one .csv or .wav file read back or one UCF file):
+ * after 2 consecutive sequential requests, the SD driver reads
+ * STBOX1_SD_READ_AHEAD_SECTORS sectors with one multi-block transfer and serves the
+ * next requests from its buffer. The random reads are done as before */
+//#define STBOX1_SD_READ_AHEAD
+#define STBOX1_SD_READ_AHEAD_SECTORS 32 /* 16KB of RAM */
+
+/* For queuing the data sectors written by FileX on one write-behind layer between
+ * FileX and the SD driver: the contiguous writes are collected on extents of
+ * STBOX1_FX_WRITE_BEHIND_EXTENT_SIZE and written by one low priority thread when
+ * they are full or STBOX1_FX_WRITE_BEHIND_DEADLINE after their first write, so one
+ * long card programming doesn't stop the Writing thread while the queue has space.
+ * When the queue is full the Writing thread waits for one free extent. The reads,
+ * the FAT and directory writes and fx_media_flush wait for the queued writes first.
+ * The queue statistics are printed when the log is stopped.
+ * It can't be enabled with STBOX1_SD_WRITE_QUEUE */
+//#define STBOX1_FX_WRITE_BEHIND
+#define STBOX1_FX_WRITE_BEHIND_SIZE 128 /* KB of RAM for the queue */
+#define STBOX1_FX_WRITE_BEHIND_EXTENT_SIZE 32 /* KB (multiple of 512 Bytes) */
+#define STBOX1_FX_WRITE_BEHIND_DEADLINE 100 /* mS */
+
+/* For profiling the ThreadX threads: the thread running is sampled at each HAL
+ * tick (1KHz, TIM6 interrupt with the lowest priority) and every
+ * STBOX1_THREAD_PROFILER_PERIOD seconds one low priority thread prints one JSON
+ * status with the CPU load of each thread and of the idle time, the stack
+ * high-water mark of each thread (ThreadX stack filling) and the high-water
+ * marks and the overflows of the message rings */
+//#define STBOX1_THREAD_PROFILER
+#define STBOX1_THREAD_PROFILER_PERIOD 5 /* Seconds between two reports */
+
+/* For stopping the ThreadX tick when no thread is ready: the MCU waits up to the
+ * next ThreadX timer expiration (at most 8 seconds) in Stop 2 mode, woken up by
+ * LPTIM1 (LSI) or by the user button, and the ticks slept are added to the ThreadX
+ * time at the wake up. The Stop 2 mode is used only when the next expiration is
+ * STBOX1_LOW_POWER_IDLE_MIN_TICKS away and the log is stopped: while logging the
+ * idle time is spent in Sleep mode, so the wake up latency of the acquisition is
+ * not changed and the SD, audio and sensor peripherals keep their clocks */
+//#define STBOX1_LOW_POWER_IDLE
+#define STBOX1_LOW_POWER_IDLE_MIN_TICKS 2 /* ThreadX ticks (10mS) */
+
 #define STTS22H_ODR 1.0f /* ODR = 1.0Hz */
 #define ISM330DHCX_ACC_ODR 104.0f /* ODR = 104Hz */
 #define ISM330DHCX_ACC_FS 4 /* FS = 4g */
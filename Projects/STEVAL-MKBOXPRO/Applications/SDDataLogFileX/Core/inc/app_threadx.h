@@ -32,6 +32,10 @@
 /* Exported functions prototypes ---------------------------------------------*/
 UINT App_ThreadX_Init(VOID *memory_ptr);
 void MX_ThreadX_Init(void);
+void App_ThreadX_LowPower_Timer_Setup(ULONG count);
+void App_ThreadX_LowPower_Enter(void);
+void App_ThreadX_LowPower_Exit(void);
+ULONG App_ThreadX_LowPower_Timer_Adjust(void);
 
 #ifdef __cplusplus
 }
@@ -36,6 +36,7 @@ void DebugMon_Handler(void);
 void TIM6_IRQHandler(void);
 void EXTI0_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void LPTIM1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
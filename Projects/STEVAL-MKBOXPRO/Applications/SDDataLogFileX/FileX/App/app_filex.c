@@ -28,8 +28,21 @@
 #include "SensorTileBoxPro.h"
 #include "SensorTileBoxPro_env_sensors.h"
 #include "SensorTileBoxPro_motion_sensors.h"
+#include "SensorTileBoxPro_motion_sensors_ex.h"
 #include "SensorTileBoxPro_audio.h"
 #include "main.h"
+#include "msg_ring.h"
+#include "audio_lac.h"
+#include "log_container.h"
+#include "log_checkpoint.h"
+#include "log_session.h"
+#include "log_raw.h"
+#include "log_write_behind.h"
+#include "thread_profiler.h"
+#include "low_power_idle.h"
+#ifdef STBOX1_LOG_CHECKPOINT
+#include "fx_fault_tolerant.h"
+#endif /* STBOX1_LOG_CHECKPOINT */
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -43,7 +56,146 @@ typedef struct
   BSP_MOTION_SENSOR_Axes_t acc;
   BSP_MOTION_SENSOR_Axes_t gyro;
   BSP_MOTION_SENSOR_Axes_t mag;
+  uint32_t AudioBlock; /* Audio block to save */
+#ifdef STBOX1_LOG_CONTAINER
+  ULONG LogTime;       /* Time stamp in mS of the first data (HAL_GetTick) */
+  UCHAR SlowSensors;   /* Magnetometer and environmental values just read */
+#endif /* STBOX1_LOG_CONTAINER */
+#ifdef STBOX1_LOG_TRIGGER
+  UINT TriggerSource;  /* Source of COMMAND_TRIGGER */
+#endif /* STBOX1_LOG_TRIGGER */
 } MessageData_T;
+
+#ifdef STBOX1_SENSORS_LOG_BINARY
+/* SensXXX.dat file header (little-endian).
+   It's followed by ChannelsNumber SensorsLogChannel_T descriptors and then
+   by the SensorsLogRecord_T records up to the end of the file */
+typedef struct
+{
+  char Magic[8];           /* SENSORS_LOG_MAGIC */
+  uint16_t Version;        /* SENSORS_LOG_VERSION */
+  uint16_t HeaderSize;     /* Header + channels descriptors size in bytes */
+  uint16_t RecordSize;     /* Size of one record in bytes */
+  uint16_t ChannelsNumber; /* Number of channels after the time stamp */
+  uint32_t TickFrequency;  /* Time stamp ticks for second */
+  float Odr;               /* Records for second */
+} SensorsLogHeader_T;
+
+/* Description of one record's channel */
+typedef struct
+{
+  char Sensor[12];         /* Sensor name */
+  char Name[8];            /* Channel name */
+  char Unit[8];            /* Channel unit */
+  uint32_t Type;           /* SENSORS_LOG_TYPE_INT32 or SENSORS_LOG_TYPE_FLOAT */
+  float Sensitivity;       /* Sensor sensitivity (0 if not available) */
+  float Odr;               /* Sensor output data rate */
+} SensorsLogChannel_T;
+
+/* One record for each COMMAND_SAVE_SENSORS message */
+typedef struct
+{
+  uint32_t MsgTime;
+  int32_t acc[3];
+  int32_t gyro[3];
+  int32_t mag[3];
+  float pressure;
+  float temperature;
+} SensorsLogRecord_T;
+#endif /* STBOX1_SENSORS_LOG_BINARY */
+
+/* Histogram of the fx_file_write latency of the write batching stage: the
+   upper limits (uS) of the bins, the last bin has the longer ones */
+#define WRITE_BATCH_LATENCY_BINS   10
+#define WRITE_BATCH_LATENCY_LIMITS {500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000}
+
+/* Staging area between the message rings and fx_file_write.
+   The data are accumulated in one buffer and written out with one single
+   write for each full buffer (one whole number of clusters). fx_file_write
+   returns when the buffer is consumed, so one buffer is enough (the
+   asynchronous writes are done below FileX, see STBOX1_FX_WRITE_BEHIND) */
+typedef struct
+{
+  FX_FILE *File;
+  UCHAR *Buffer;           /* Batch buffer (NULL for direct writes only) */
+  ULONG Size;              /* Buffer size used for this media */
+  ULONG Index;             /* Bytes present on the buffer */
+  ULONG Limit;             /* Bytes for reaching the next aligned file offset */
+  ULONG64 Offset;          /* File offset of the first byte of the buffer */
+  ULONG FirstTime;         /* Time of the first byte present on the buffer */
+  /* Statistics */
+  ULONG WriteCalls;
+  ULONG64 WriteBytes;
+  ULONG64 WriteTime;       /* uS spent on the writes */
+  ULONG WriteMaxTime;      /* Max uS of one write */
+  ULONG Latency[WRITE_BATCH_LATENCY_BINS]; /* Writes for each latency bin */
+} WriteBatch_T;
+
+#ifdef STBOX1_LOG_CONTAINER
+/* Records of the LogXXX.stb sensors streams (little-endian) */
+typedef struct
+{
+  uint32_t Time;           /* Sensor time stamp with STBOX1_IMU_FIFO, mS otherwise */
+  int32_t acc[3];
+  int32_t gyro[3];
+} LogImuRecord_T;
+
+typedef struct
+{
+  uint32_t Time;           /* mS */
+  int32_t mag[3];
+} LogMagRecord_T;
+
+typedef struct
+{
+  uint32_t Time;           /* mS */
+  float pressure;
+  float temperature;
+} LogEnvRecord_T;
+
+/* Staging area of one sensors stream: the records are accumulated
+   and written out with one single chunk */
+typedef struct
+{
+  UCHAR Id;                /* LOG_STREAM_XXX */
+  UCHAR *Buffer;
+  ULONG Index;             /* Bytes present on the Buffer */
+  ULONG Count;             /* Records present on the Buffer */
+  ULONG Time;              /* Time stamp in mS of the first record */
+  ULONG FirstTime;         /* Time when the first record was added */
+} LogStream_T;
+#endif /* STBOX1_LOG_CONTAINER */
+
+#ifdef STBOX1_LOG_ROTATION
+/* Segments of one log file.
+   The Closing thread opens the next segment in advance and completes and
+   closes the finished one, so the Writing thread only switches the file
+   of the write batching stage */
+typedef struct
+{
+  const CHAR *Format;      /* File name format (session number) */
+  WriteBatch_T *Batch;     /* Write batching stage of the file */
+  FX_FILE *Files[2];       /* Current segment and next (or closing) one */
+  ULONG Event;             /* ROTATION_EVENT_XXX for the Closing thread */
+  ULONG ReadyEvent;        /* ROTATION_EVENT_XXX_READY set by the Closing thread */
+  ULONG64 Preallocation;   /* Bytes reserved for each segment (0 for none) */
+  UCHAR *Header;           /* Updated header of the segment to close */
+  ULONG HeaderSize;        /* Bytes of the header to update (0 if none) */
+  ULONG64 ClosingSize;     /* Bytes written on the segment to close */
+  UINT Current;           /* File of the current segment */
+  ULONG Session;
+  ULONG Segment;           /* Number of the current segment */
+  ULONG StartTime;         /* Time when the current segment was started */
+  volatile UINT NextReady; /* The next segment is opened */
+  volatile UINT Closing;   /* The previous segment is not yet closed */
+  /* Statistics */
+  ULONG64 ClosedBytes;     /* Size of the segments already closed */
+  ULONG Late;              /* Switches delayed because the next segment was not ready */
+  ULONG SwitchMaxTime;     /* Writing thread */
+  ULONG CloseMaxTime;      /* Closing thread */
+  ULONG OpenMaxTime;       /* Closing thread */
+} LogRotation_T;
+#endif /* STBOX1_LOG_ROTATION */
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
@@ -63,17 +215,289 @@ typedef struct
 /* read_app_thread preemption priority */
 #define READ_APP_PREEMPTION_THRESHOLD     READ_APP_THREAD_PRIO
 
-#define   MESSAGE_QUEUE_SIZE                 100
+#if defined(STBOX1_LOG_ROTATION) || defined(STBOX1_LOG_CHECKPOINT)
+/* close_app_thread priority: it runs when the Writing thread is waiting
+   (FileX media mutex without priority inheritance) */
+#define CLOSE_APP_THREAD_PRIO              14
+
+/* close_app_thread preemption priority */
+#define CLOSE_APP_PREEMPTION_THRESHOLD     CLOSE_APP_THREAD_PRIO
+
+/* Events for waking up the Closing thread */
+#define ROTATION_EVENT_SENSORS 0x1U
+#define ROTATION_EVENT_AUDIO   0x2U
+#define CHECKPOINT_EVENT_SAVE  0x10U
+
+/* Events for waking up the Writing thread waiting for the next segment
+   or for the checkpoint handed off */
+#define ROTATION_EVENT_SENSORS_READY 0x4U
+#define ROTATION_EVENT_AUDIO_READY   0x8U
+#define CHECKPOINT_EVENT_SAVED       0x20U
+#endif /* STBOX1_LOG_ROTATION || STBOX1_LOG_CHECKPOINT */
+
+#ifdef STBOX1_FX_WRITE_BEHIND
+/* Thread of the write-behind layer: it writes the queue when the Writing thread
+   is waiting for the data */
+#define WRITE_BEHIND_THREAD_PRIO           13
+#endif /* STBOX1_FX_WRITE_BEHIND */
+
+#ifdef STBOX1_THREAD_PROFILER
+/* Thread of the profiler: the lowest priority, the reports wait for the other threads */
+#define PROFILER_THREAD_PRIO               15
+#endif /* STBOX1_THREAD_PROFILER */
+
+/* Messages of the Reading thread (power of 2) */
+#define SENSORS_RING_SIZE 128
+
+/* Audio blocks (power of 2), each one with its message */
+#ifdef STBOX1_LOG_TRIGGER
+/* The audio blocks before the trigger are kept on the ring */
+#define AUDIO_RING_SIZE MSG_RING_SIZE(TRIGGER_AUDIO_HISTORY + 4)
+#else /* STBOX1_LOG_TRIGGER */
+#define AUDIO_RING_SIZE 4
+#endif /* STBOX1_LOG_TRIGGER */
+
+/* Events for waking up the Writing thread */
+#define MESSAGE_EVENT_SENSORS 0x1U
+#define MESSAGE_EVENT_AUDIO   0x2U
 
 #define COMMAND_STOP_LOG  0
 #define COMMAND_START_LOG  1
 #define COMMAND_SAVE_AUDIO 2
 #define COMMAND_SAVE_SENSORS 3
+#define COMMAND_TRIGGER 4
+
+/* Reading Timer period in ThreadX ticks (10ms) */
+#define READING_TIMER_PERIOD 1
+
+#if defined(STBOX1_LOG_CONTAINER)
+  /* One single file for all the streams */
+  #define SENSORS_FILE_NAME "Log%03d.stb"
+#elif defined(STBOX1_SENSORS_LOG_BINARY)
+  #define SENSORS_FILE_NAME "Sens%03d.dat"
+
+  #define SENSORS_LOG_MAGIC "STBOXLOG"
+  #define SENSORS_LOG_VERSION 1
+  #define SENSORS_LOG_CHANNELS 11
+
+  #define SENSORS_LOG_TYPE_INT32 0
+  #define SENSORS_LOG_TYPE_FLOAT 1
+#else /* STBOX1_LOG_CONTAINER */
+  #define SENSORS_FILE_NAME "Sens%03d.csv"
+#endif /* STBOX1_LOG_CONTAINER */
+
+#ifdef STBOX1_IMU_FIFO
+  /* Accelerometer and gyroscope read from their FIFO */
+  #define IMU_FIFO_INSTANCE LSM6DSV16X_0
+
+  #define IMU_FIFO_BYPASS_MODE LSM6DSV16X_BYPASS_MODE
+  #define IMU_FIFO_STREAM_MODE LSM6DSV16X_STREAM_MODE
+
+  /* Time stamp resolution (21.75uS) */
+  #define IMU_FIFO_TS_FREQUENCY 45977
+
+  /* One FIFO word: tag byte and 6 data bytes */
+  #define IMU_FIFO_WORD_SIZE 7
+
+  /* Tags (bits [7:3] of the tag byte) */
+  #define IMU_FIFO_TAG_GYRO      0x01U
+  #define IMU_FIFO_TAG_ACC       0x02U
+  #define IMU_FIFO_TAG_TIMESTAMP 0x04U
+
+  #define SENSORS_TIME_HEADER "Time [21.75uS], "
+#else /* STBOX1_IMU_FIFO */
+  #define SENSORS_TIME_HEADER "Time [mS], "
+#endif /* STBOX1_IMU_FIFO */
+
+#ifdef STBOX1_SD_PREALLOCATION
+  /* Bytes reserved for the SensXXX file when it's opened */
+  #ifndef STBOX1_SD_SENSORS_PREALLOCATION_SIZE
+    #define STBOX1_SD_SENSORS_PREALLOCATION_SIZE (16*1024*1024)
+  #endif /* STBOX1_SD_SENSORS_PREALLOCATION_SIZE */
+
+  /* Bytes reserved for the MicXXX.wav file when it's opened */
+  #ifndef STBOX1_SD_AUDIO_PREALLOCATION_SIZE
+    #define STBOX1_SD_AUDIO_PREALLOCATION_SIZE (64*1024*1024)
+  #endif /* STBOX1_SD_AUDIO_PREALLOCATION_SIZE */
+#endif /* STBOX1_SD_PREALLOCATION */
+
+/* Size of the buffer of the write batching stage */
+#ifndef STBOX1_SD_WRITE_BATCH_SIZE
+  #define STBOX1_SD_WRITE_BATCH_SIZE (16*1024)
+#endif /* STBOX1_SD_WRITE_BATCH_SIZE */
+
+/* Max time in mS that one data could wait on the write batching stage */
+#ifndef STBOX1_SD_WRITE_BATCH_DEADLINE
+  #define STBOX1_SD_WRITE_BATCH_DEADLINE 2000
+#endif /* STBOX1_SD_WRITE_BATCH_DEADLINE */
+
+/* Samples of each mS of audio: with more microphones (AUDIO_IN_CHANNELS)
+   the BSP interleaves one sample of each microphone for each period */
+#define PCM_AUDIO_IN_SAMPLES     ((AUDIO_IN_SAMPLING_FREQUENCY / 1000) * AUDIO_IN_CHANNELS)
+
+/* Samples of each audio block saved with one single write (256mS, always
+   a multiple of the SD sector size whatever the number of microphones) */
+#define AUDIO_BLOCK_SAMPLES (PCM_AUDIO_IN_SAMPLES *256)
+
+/* Time in mS of some interleaved samples */
+#define AUDIO_SAMPLES_TIME(Samples) (((Samples) * 1000) / (AUDIO_IN_SAMPLING_FREQUENCY * AUDIO_IN_CHANNELS))
+
+#if defined(STBOX1_AUDIO_COMPRESSION) && (AUDIO_IN_CHANNELS > 1)
+  #error "STBOX1_AUDIO_COMPRESSION supports only one microphone"
+#endif /* STBOX1_AUDIO_COMPRESSION */
+
+/* Wav header size: one SD sector for keeping aligned the audio blocks */
+#define WAV_HEADER_SIZE 512
+
+#ifdef STBOX1_AUDIO_COMPRESSION
+  #define AUDIO_FILE_NAME "Mic%03d.lac"
+  #define AUDIO_HEADER_SIZE AUDIO_LAC_HEADER_SIZE
+#else /* STBOX1_AUDIO_COMPRESSION */
+  #define AUDIO_FILE_NAME "Mic%03d.wav"
+  #define AUDIO_HEADER_SIZE WAV_HEADER_SIZE
+#endif /* STBOX1_AUDIO_COMPRESSION */
+
+#ifdef STBOX1_LOG_CONTAINER
+  #ifdef STBOX1_SENSORS_LOG_BINARY
+    #error "STBOX1_LOG_CONTAINER and STBOX1_SENSORS_LOG_BINARY can't be enabled together"
+  #endif /* STBOX1_SENSORS_LOG_BINARY */
+
+  /* Streams of the LogXXX.stb file */
+  #define LOG_STREAM_IMU   0
+  #define LOG_STREAM_MAG   1
+  #define LOG_STREAM_ENV   2
+  #define LOG_STREAM_AUDIO 3
+  #define LOG_STREAM_NOTES 4
+  #define LOG_STREAMS      5
+
+  /* Streams with one staging area (the first ones) */
+  #define LOG_SENSORS_STREAMS 3
+
+  /* Time stamp frequency of the chunks (HAL_GetTick) */
+  #define LOG_TICK_FREQUENCY 1000
 
-#define STBOX1_AUDIO_DATA_NOT_READY 0xFFFFFF
+  /* Max length of one annotation */
+  #define LOG_NOTE_MAX_SIZE 64
 
-#define PCM_AUDIO_IN_SAMPLES     (AUDIO_IN_SAMPLING_FREQUENCY / 1000)
-#define AUDIO_BUFF_SIZE (PCM_AUDIO_IN_SAMPLES *1024)
+  /* Payload size of the sensors chunks */
+  #ifndef STBOX1_LOG_CHUNK_SIZE
+    #define STBOX1_LOG_CHUNK_SIZE 1024
+  #endif /* STBOX1_LOG_CHUNK_SIZE */
+
+  /* Max time in mS that one sensor record could wait on its chunk */
+  #ifndef STBOX1_LOG_CHUNK_DEADLINE
+    #define STBOX1_LOG_CHUNK_DEADLINE 1000
+  #endif /* STBOX1_LOG_CHUNK_DEADLINE */
+
+  #ifdef STBOX1_SD_PREALLOCATION
+    /* Bytes reserved for the LogXXX.stb file when it's opened */
+    #define LOG_PREALLOCATION_SIZE (STBOX1_SD_SENSORS_PREALLOCATION_SIZE + STBOX1_SD_AUDIO_PREALLOCATION_SIZE)
+  #endif /* STBOX1_SD_PREALLOCATION */
+#endif /* STBOX1_LOG_CONTAINER */
+
+#ifdef STBOX1_LOG_SESSION_INDEX
+  /* File with the next free session number */
+  #define SESSION_INDEX_FILE_NAME "Session.idx"
+
+  /* Each session is saved on the directory of its group (Logs000/Sens000.csv) */
+  #define LOG_SESSION_NAME(Name, Format, Session) LogSession_FileName((Name), (Format), (Session), STBOX1_LOG_SESSION_DIR_SIZE)
+  #define LOG_FILE_CREATE(Name) LogSession_FileCreate(&sdio_disk, (Name))
+#else /* STBOX1_LOG_SESSION_INDEX */
+  #define LOG_SESSION_NAME(Name, Format, Session) sprintf((Name), (Format), (Session))
+  #define LOG_FILE_CREATE(Name) fx_file_create(&sdio_disk, (Name))
+#endif /* STBOX1_LOG_SESSION_INDEX */
+
+#ifdef STBOX1_LOG_ROTATION
+  /* Max size of the header updated when one segment is closed */
+  #define ROTATION_HEADER_SIZE 512
+
+  /* Bytes reserved for each segment when it's opened */
+  #if !defined(STBOX1_SD_PREALLOCATION)
+    #define SENSORS_SEGMENT_PREALLOCATION 0
+    #define AUDIO_SEGMENT_PREALLOCATION 0
+  #elif defined(STBOX1_LOG_CONTAINER)
+    #define SENSORS_SEGMENT_PREALLOCATION LOG_PREALLOCATION_SIZE
+    #define AUDIO_SEGMENT_PREALLOCATION 0
+  #else /* STBOX1_SD_PREALLOCATION */
+    #define SENSORS_SEGMENT_PREALLOCATION STBOX1_SD_SENSORS_PREALLOCATION_SIZE
+    #define AUDIO_SEGMENT_PREALLOCATION STBOX1_SD_AUDIO_PREALLOCATION_SIZE
+  #endif /* STBOX1_SD_PREALLOCATION */
+
+  /* The segment number follows the session number (Sens000_000.csv) */
+  #define LOG_FILE_NAME(Name, Format, Session) LogRotation_FileName((Name), (Format), (Session), 0)
+#else /* STBOX1_LOG_ROTATION */
+  #define LOG_FILE_NAME(Name, Format, Session) LOG_SESSION_NAME((Name), (Format), (Session))
+#endif /* STBOX1_LOG_ROTATION */
+
+#ifdef STBOX1_LOG_CHECKPOINT
+  #ifndef FX_ENABLE_FAULT_TOLERANT
+    #error "STBOX1_LOG_CHECKPOINT needs FX_ENABLE_FAULT_TOLERANT inside fx_user.h"
+  #endif /* FX_ENABLE_FAULT_TOLERANT */
+
+  /* File with the last checkpoint of the log */
+  #define CHECKPOINT_FILE_NAME "Checkpoint.dat"
+
+  /* Files of the checkpoint record */
+  #define CHECKPOINT_FILE_SENSORS 0
+  #define CHECKPOINT_FILE_AUDIO   1
+#endif /* STBOX1_LOG_CHECKPOINT */
+
+#ifdef STBOX1_LOG_RAW
+  #ifndef STBOX1_LOG_CONTAINER
+    #error "STBOX1_LOG_RAW needs STBOX1_LOG_CONTAINER"
+  #endif /* STBOX1_LOG_CONTAINER */
+  #if defined(STBOX1_LOG_ROTATION) || defined(STBOX1_LOG_CHECKPOINT) || defined(STBOX1_LOG_SESSION_INDEX) || defined(STBOX1_SD_PREALLOCATION)
+    #error "STBOX1_LOG_RAW can't be enabled with the rotation, the checkpoints, the session index or the preallocation"
+  #endif /* STBOX1_LOG_ROTATION */
+  #if ((STBOX1_LOG_RAW_BLOCK_SIZE % LOG_RAW_SECTOR_SIZE) != 0)
+    #error "STBOX1_LOG_RAW_BLOCK_SIZE must be a multiple of the SD sector size"
+  #endif /* STBOX1_LOG_RAW_BLOCK_SIZE */
+
+  /* File with the raw log area (all the sessions) */
+  #define RAW_LOG_FILE_NAME "RawLog.bin"
+  #define RAW_LOG_SIZE ((ULONG)STBOX1_LOG_RAW_SIZE * 1024U * 1024U)
+#endif /* STBOX1_LOG_RAW */
+
+#if defined(STBOX1_FX_WRITE_BEHIND) && defined(STBOX1_SD_WRITE_QUEUE)
+  /* Two asynchronous write stages would copy each data sector twice and
+     both hold the writes queued while FileX goes on */
+  #error "STBOX1_FX_WRITE_BEHIND and STBOX1_SD_WRITE_QUEUE can't be enabled together"
+#endif /* STBOX1_FX_WRITE_BEHIND && STBOX1_SD_WRITE_QUEUE */
+
+#ifdef STBOX1_LOG_TRIGGER
+  #if (STBOX1_LOG_TRIGGER_PRE_TIME < 1)
+    #error "STBOX1_LOG_TRIGGER_PRE_TIME must be at least 1 second"
+  #endif /* STBOX1_LOG_TRIGGER_PRE_TIME */
+
+  /* Sensors messages sent each second by the Reading thread */
+  #ifdef STBOX1_IMU_FIFO
+    #define TRIGGER_SENSORS_RATE ((ULONG)STBOX1_IMU_FIFO_ODR)
+  #else /* STBOX1_IMU_FIFO */
+    #define TRIGGER_SENSORS_RATE (TX_TIMER_TICKS_PER_SECOND / READING_TIMER_PERIOD)
+  #endif /* STBOX1_IMU_FIFO */
+
+  /* Sensors messages and audio blocks (256mS) kept before the trigger */
+  #define TRIGGER_SENSORS_HISTORY (STBOX1_LOG_TRIGGER_PRE_TIME * TRIGGER_SENSORS_RATE)
+  #define TRIGGER_AUDIO_BLOCK_TIME AUDIO_SAMPLES_TIME(AUDIO_BLOCK_SAMPLES)
+  #define TRIGGER_AUDIO_HISTORY \
+    ((STBOX1_LOG_TRIGGER_PRE_TIME * 1000 + TRIGGER_AUDIO_BLOCK_TIME - 1) / TRIGGER_AUDIO_BLOCK_TIME)
+
+  /* Trigger sources */
+  #define TRIGGER_SOURCE_ACC      0
+  #define TRIGGER_SOURCE_EMB_FUNC 1
+  #define TRIGGER_SOURCE_BUTTON   2
+  #define TRIGGER_SOURCES         3
+
+  /* User button: the click is one trigger if there isn't a second one
+     within TRIGGER_DOUBLE_CLICK_TIME ticks (double click for stopping the log) */
+  #define TRIGGER_DEBOUNCE_TIME     (TX_TIMER_TICKS_PER_SECOND / 10)
+  #define TRIGGER_DOUBLE_CLICK_TIME (TX_TIMER_TICKS_PER_SECOND / 2)
+
+  /* MLC and FSM interrupt status registers read at each Reading Timer tick */
+  #define TRIGGER_EMB_FUNC_INSTANCE   LSM6DSV16X_0
+  #define TRIGGER_MLC_STATUS_REGISTER LSM6DSV16X_MLC_STATUS_MAINPAGE
+  #define TRIGGER_FSM_STATUS_REGISTER LSM6DSV16X_FSM_STATUS_MAINPAGE
+#endif /* STBOX1_LOG_TRIGGER */
 
 /* USER CODE END PD */
 
@@ -87,16 +511,53 @@ typedef struct
 
 /* Buffer for FileX FX_MEDIA sector cache. this should be 32-Bytes
 aligned to avoid cache maintenance issues */
-ALIGN_32BYTES (uint32_t media_memory[FX_STM32_SD_DEFAULT_SECTOR_SIZE / sizeof(uint32_t)]);
+ALIGN_32BYTES (uint32_t media_memory[STBOX1_SD_MEDIA_CACHE_SECTORS * FX_STM32_SD_DEFAULT_SECTOR_SIZE / sizeof(uint32_t)]);
+
+/* Buffers for the write batching stage. They are 32-Bytes aligned
+like the media_memory for avoiding the driver's scratch buffer */
+ALIGN_32BYTES (static UCHAR SensorsBatchBuffer[STBOX1_SD_WRITE_BATCH_SIZE]);
+
+static WriteBatch_T SensorsBatch = {NULL, SensorsBatchBuffer};
+#ifdef STBOX1_AUDIO_COMPRESSION
+/* The compressed frames have variable size: they pass through the write batching stage */
+ALIGN_32BYTES (static UCHAR AudioBatchBuffer[STBOX1_SD_WRITE_BATCH_SIZE]);
+
+static WriteBatch_T AudioBatch = {NULL, AudioBatchBuffer};
+
+/* Audio encoder and one compressed frame */
+static AudioLac_Encoder_T AudioEncoder;
+static uint8_t AudioLacFrame[AUDIO_LAC_FRAME_MAX_SIZE];
+
+/* CPU cycles spent for compressing the audio */
+static uint64_t AudioEncoderCycles;
+#else /* STBOX1_AUDIO_COMPRESSION */
+/* The audio blocks are written directly from Audio_OUT_Buff (no buffers) */
+static WriteBatch_T AudioBatch = {NULL, NULL};
+#endif /* STBOX1_AUDIO_COMPRESSION */
 
 /* Define FileX global data structures.  */
 FX_MEDIA        sdio_disk;
 FX_FILE         SensorsFxFile;
 FX_FILE         AudioFxFile;
+#ifdef STBOX1_LOG_ROTATION
+/* Next segments opened in advance (or segments that are closing) */
+FX_FILE         SensorsNextFxFile;
+FX_FILE         AudioNextFxFile;
+#endif /* STBOX1_LOG_ROTATION */
+#ifdef STBOX1_LOG_CHECKPOINT
+FX_FILE         CheckpointFxFile;
+#endif /* STBOX1_LOG_CHECKPOINT */
+#ifdef STBOX1_LOG_SESSION_INDEX
+FX_FILE         SessionFxFile;
+#endif /* STBOX1_LOG_SESSION_INDEX */
 /* Define ThreadX global data structures.  */
 TX_THREAD       fx_app_thread;
 TX_THREAD       read_app_thread;
-TX_QUEUE        MessageQueue;
+TX_EVENT_FLAGS_GROUP MessageEvents;
+#if defined(STBOX1_LOG_ROTATION) || defined(STBOX1_LOG_CHECKPOINT)
+TX_THREAD       close_app_thread;
+TX_EVENT_FLAGS_GROUP ClosingEvents;
+#endif /* STBOX1_LOG_ROTATION || STBOX1_LOG_CHECKPOINT */
 
 /* Timer for reading the sensor's Data*/
 TX_TIMER ReadTimer;
@@ -104,30 +565,185 @@ TX_TIMER ReadTimer;
 /* Semaphore for controlling the Reading Thread */
 TX_SEMAPHORE SemaphorePtr;
 
-/* Array for Sensors Values */
-static UCHAR SensorBuffer[MESSAGE_QUEUE_SIZE*sizeof(MessageData_T)];
-static UCHAR *SensorBufferWritingPointer = SensorBuffer;
-static UCHAR *SensorBufferEndPointer = SensorBuffer+MESSAGE_QUEUE_SIZE*sizeof(MessageData_T);
+/* Rings for the messages of the Reading thread and of the audio callbacks */
+static MessageData_T SensorsRingBuffer[SENSORS_RING_SIZE];
+static MessageData_T AudioRingBuffer[AUDIO_RING_SIZE];
+static MsgRing_T SensorsRing;
+static MsgRing_T AudioRing;
 
-/* Output PCM buffer from Digital Microphone */
+/* Output PCM buffer from Digital Microphone for the data that are discarded */
 uint16_t OnBoard_PCM_Buffer[2 *PCM_AUDIO_IN_SAMPLES];
 
-static uint16_t Audio_OUT_Buff[AUDIO_BUFF_SIZE];
+/* Audio blocks filled directly by the BSP, one for each message of AudioRing */
+ALIGN_32BYTES (static uint16_t Audio_OUT_Buff[AUDIO_RING_SIZE][AUDIO_BLOCK_SAMPLES]);
+/* Message reserved for the block that it's filled (NULL if the data are discarded) */
+static MessageData_T * volatile AudioMsg = NULL;
 static volatile uint32_t WriteIndexBufferAudio = 0;
-static volatile uint32_t  ReadIndexBufferAudio=STBOX1_AUDIO_DATA_NOT_READY;
 static volatile int SkipFirst200mS;
 
+/* Statistics of the audio blocks saved by the Writing thread */
+static uint32_t AudioSaveBlocks;
+static uint32_t AudioSaveTime;
+static uint32_t AudioSaveMaxTime;
+
+/* Statistics of the audio callbacks (DWT cycles of AudioProcess_SD_Recording) */
+static uint32_t AudioCallbacks;
+static uint64_t AudioCallbackCycles;
+static uint32_t AudioCallbackMaxCycles;
+
 /* Header for wav audio file */
-static uint8_t pAudioHeader[44];
+ALIGN_32BYTES (static uint8_t pAudioHeader[WAV_HEADER_SIZE]);
 
 static volatile CHAR SensorsFileOpen=0;
 static volatile CHAR AudioFileOpen=0;
 
-/* For Understanding Max Message Queues size */
-INT MessagePushed=0;
-INT MessageRemoved=0;
-INT MessageMaxSize=0;
+/* For Understanding the Sensors log cost */
+ULONG SensorsRecordsWritten=0;
+ULONG SensorsFileSize=0;
+
+#ifdef STBOX1_SENSORS_LOG_BINARY
+/* Header for binary sensors file */
+static struct
+{
+  SensorsLogHeader_T Header;
+  SensorsLogChannel_T Channels[SENSORS_LOG_CHANNELS];
+} SensorsLogHeader;
+#endif /* STBOX1_SENSORS_LOG_BINARY */
+
+#ifdef STBOX1_IMU_FIFO
+/* Words read from the FIFO with one single burst */
+static uint8_t ImuFifoBuffer[STBOX1_IMU_FIFO_WATERMARK * IMU_FIFO_WORD_SIZE];
+
+/* State of the FIFO reading */
+static struct
+{
+  float AccSensitivity;
+  float GyroSensitivity;
+  float AccOdr;            /* ODR restored when the log is stopped */
+  float GyroOdr;
+  float FifoOdr;           /* ODR used while logging */
+  uint32_t Time;           /* Last time stamp read from the FIFO */
+  uint8_t TimeValid;
+  uint8_t Pending;         /* Tags waiting for their pair (one bit for each tag) */
+  uint8_t PendingCnt;      /* TAG_CNT of the tags waiting */
+  BSP_MOTION_SENSOR_Axes_t acc;
+  BSP_MOTION_SENSOR_Axes_t gyro;
+  /* Statistics */
+  ULONG Bursts;
+  ULONG Words;
+  ULONG MaxLevel;
+  ULONG Unpaired;          /* Samples with one tag only (FIFO overrun) */
+#ifdef STBOX1_LOG_CONTAINER
+  uint32_t AnchorTime;     /* Time stamp of the last sample of the previous drain */
+  ULONG AnchorTick;        /* HAL_GetTick() of the previous drain */
+  uint8_t AnchorValid;
+#endif /* STBOX1_LOG_CONTAINER */
+} ImuFifo;
+#endif /* STBOX1_IMU_FIFO */
+
+#ifdef STBOX1_LOG_CONTAINER
+/* Header of the LogXXX.stb file */
+ALIGN_32BYTES (static uint8_t pLogHeader[LOG_CONTAINER_HEADER_SIZE]);
+
+/* Index and statistics of the LogXXX.stb file */
+static LogContainer_T LogContainer;
+
+/* Staging areas of the sensors streams */
+static UCHAR LogStreamBuffer[LOG_SENSORS_STREAMS][STBOX1_LOG_CHUNK_SIZE];
+static LogStream_T LogStreams[LOG_SENSORS_STREAMS] = {
+  {LOG_STREAM_IMU, LogStreamBuffer[LOG_STREAM_IMU]},
+  {LOG_STREAM_MAG, LogStreamBuffer[LOG_STREAM_MAG]},
+  {LOG_STREAM_ENV, LogStreamBuffer[LOG_STREAM_ENV]}
+};
+#endif /* STBOX1_LOG_CONTAINER */
+
+#ifdef STBOX1_AUDIO_COMPRESSION
+/* Samples saved before the current audio file */
+static uint32_t AudioFirstSample;
+#endif /* STBOX1_AUDIO_COMPRESSION */
+
+#ifdef STBOX1_LOG_ROTATION
+/* Headers of the segments that are closing */
+ALIGN_32BYTES (static UCHAR RotationHeader[2][ROTATION_HEADER_SIZE]);
+
+static LogRotation_T SensorsRotation = {SENSORS_FILE_NAME, &SensorsBatch, {&SensorsFxFile, &SensorsNextFxFile},
+                                        ROTATION_EVENT_SENSORS, ROTATION_EVENT_SENSORS_READY,
+                                        SENSORS_SEGMENT_PREALLOCATION, RotationHeader[0]};
+#ifndef STBOX1_LOG_CONTAINER
+static LogRotation_T AudioRotation = {AUDIO_FILE_NAME, &AudioBatch, {&AudioFxFile, &AudioNextFxFile},
+                                      ROTATION_EVENT_AUDIO, ROTATION_EVENT_AUDIO_READY,
+                                      AUDIO_SEGMENT_PREALLOCATION, RotationHeader[1]};
+#endif /* STBOX1_LOG_CONTAINER */
+#endif /* STBOX1_LOG_ROTATION */
+
+#ifdef STBOX1_LOG_CHECKPOINT
+/* Memory of the FileX fault tolerant module */
+ALIGN_32BYTES (static UCHAR FaultTolerantMemory[FX_FAULT_TOLERANT_MINIMAL_BUFFER_SIZE]);
+
+/* Checkpoint records (both the slots for the recovery) */
+ALIGN_32BYTES (static UCHAR CheckpointRecords[2 * LOG_CHECKPOINT_RECORD_SIZE]);
+
+/* State of the checkpoints */
+static struct
+{
+  LogCheckpoint_T Record;
+  LogCheckpoint_T Saved;   /* Record handed off to the Closing thread */
+  WriteBatch_T *Batch[LOG_CHECKPOINT_MAX_FILES]; /* Write batching stage of each file (NULL if not used) */
+  ULONG StartTime;         /* Time when the log was started */
+  ULONG LastTime;          /* Time of the last checkpoint */
+  volatile UINT Saving;    /* The Closing thread is saving the record handed off */
+  /* Statistics */
+  ULONG Count;
+  ULONG TotalTime;
+  ULONG MaxTime;           /* Closing thread */
+  ULONG Late;              /* Checkpoints delayed because the previous one was not yet saved (retries) */
+} CheckpointLog;
+#endif /* STBOX1_LOG_CHECKPOINT */
+
+#ifdef STBOX1_LOG_RAW
+/* Block of the raw log area that it's filled (written with one single SD request) */
+ALIGN_32BYTES (static UCHAR RawLogBuffer[STBOX1_LOG_RAW_BLOCK_SIZE]);
+static LogRaw_T RawLog;
+#endif /* STBOX1_LOG_RAW */
+
+#ifdef STBOX1_FX_WRITE_BEHIND
+/* Queue of the write-behind layer and stack of its thread (not on the FileX byte pool) */
+ALIGN_32BYTES (static UCHAR WriteBehindBuffer[STBOX1_FX_WRITE_BEHIND_SIZE * 1024]);
+static ULONG WriteBehindStack[DEFAULT_STACK_SIZE / sizeof(ULONG)];
+#endif /* STBOX1_FX_WRITE_BEHIND */
+
+#ifdef STBOX1_THREAD_PROFILER
+/* Stack of the profiler thread (not on the FileX byte pool) */
+static ULONG ProfilerStack[DEFAULT_STACK_SIZE / sizeof(ULONG)];
+#endif /* STBOX1_THREAD_PROFILER */
+
+#ifdef STBOX1_LOG_TRIGGER
+/* Sensors messages received before the trigger
+   (the audio blocks are kept directly on AudioRing) */
+static MessageData_T SensorsHistoryBuffer[MSG_RING_SIZE(TRIGGER_SENSORS_HISTORY)];
+static MsgRing_T SensorsHistory;
+
+/* Names of the trigger sources */
+static const CHAR *LogTriggerSourceName[TRIGGER_SOURCES] = {"Acc", "MLC/FSM", "Button"};
 
+/* State of the trigger mode */
+static struct
+{
+  UCHAR Capture;             /* 1 while the data around one trigger are saved */
+  ULONG StartTime;           /* tx_time_get() of the capture start */
+  ULONG EndTime;             /* tx_time_get() of the capture end */
+  /* Statistics */
+  ULONG Events[TRIGGER_SOURCES]; /* Triggers that started one capture */
+  ULONG CaptureTime;         /* Ticks saved after the triggers */
+  ULONG SensorsDiscarded;    /* Messages too old when the trigger happened */
+  ULONG AudioDiscarded;
+} LogTrigger;
+#endif /* STBOX1_LOG_TRIGGER */
+
+#ifdef STBOX1_LOG_SESSION_INDEX
+/* Next free session (read at each start) */
+static LogSession_T LogSession = {0, STBOX1_LOG_SESSION_DIR_SIZE, 0};
+#endif /* STBOX1_LOG_SESSION_INDEX */
 
 /* USER CODE END PV */
 
@@ -138,10 +754,111 @@ static volatile uint32_t UserButtonPressed = 0;
 
 static void fx_thread_entry(ULONG thread_input);
 static void read_thread_entry(ULONG thread_input);
+#if defined(STBOX1_LOG_ROTATION) || defined(STBOX1_LOG_CHECKPOINT)
+static void close_thread_entry(ULONG thread_input);
+#endif /* STBOX1_LOG_ROTATION || STBOX1_LOG_CHECKPOINT */
 static void ReadingTimerCallbackFunction(ULONG timer);
-static void AudioProcess_SD_Recording(uint16_t *pInBuff, uint32_t len);
+static MessageData_T *MessageReceive(MsgRing_T **Ring);
+static void AudioProcess_SD_Recording(uint32_t len);
+static uint8_t *AudioProcess_NextBuffer(void);
+static void AudioProcess_SaveBlock(MessageData_T *Msg, uint32_t len);
+static void AudioProcess_PrintSummary(void);
 static uint32_t WavProcess_HeaderInit(void);
 static uint32_t WavProcess_HeaderUpdate(uint32_t len);
+static UINT SensorsLog_WriteHeader(void);
+static void SensorsLog_Save(MessageData_T *Msg);
+#ifndef STBOX1_LOG_CONTAINER
+static UINT AudioLog_WriteHeader(void);
+#endif /* STBOX1_LOG_CONTAINER */
+#ifdef STBOX1_AUDIO_COMPRESSION
+static void AudioCodec_PrintSummary(void);
+#endif /* STBOX1_AUDIO_COMPRESSION */
+#ifdef STBOX1_SENSORS_LOG_BINARY
+static uint32_t SensorsLog_HeaderInit(void);
+#endif /* STBOX1_SENSORS_LOG_BINARY */
+#ifdef STBOX1_IMU_FIFO
+static void ImuFifo_Start(void);
+static void ImuFifo_Stop(void);
+static void ImuFifo_Drain(void);
+static void ImuFifo_PrintSummary(void);
+#endif /* STBOX1_IMU_FIFO */
+#ifdef STBOX1_LOG_CONTAINER
+static UINT ContainerLog_Start(void);
+static UINT ContainerLog_Finish(void);
+static void ContainerLog_Stop(void);
+static UINT ContainerLog_SaveSensors(MessageData_T *Msg);
+static UINT ContainerLog_Annotate(ULONG Time, CHAR *Text);
+static UINT ContainerLog_CheckDeadline(void);
+static void ContainerLog_PrintSummary(void);
+#ifdef STBOX1_LOG_RAW
+static void RawLog_PrintSummary(void);
+#endif /* STBOX1_LOG_RAW */
+static UINT LogChunk_Write(UCHAR StreamId, ULONG Time, ULONG Count, VOID *Data, ULONG Size);
+static UINT LogStream_Add(LogStream_T *Stream, ULONG Time, VOID *Record, ULONG Size);
+static UINT LogStream_Flush(LogStream_T *Stream);
+#endif /* STBOX1_LOG_CONTAINER */
+static void WriteBatch_Init(WriteBatch_T *Batch, FX_FILE *File);
+static void WriteBatch_SetFile(WriteBatch_T *Batch, FX_FILE *File);
+static UINT WriteBatch_Write(WriteBatch_T *Batch, VOID *Data, ULONG Size);
+static UINT WriteBatch_WriteDirect(WriteBatch_T *Batch, VOID *Data, ULONG Size);
+static UINT WriteBatch_Flush(WriteBatch_T *Batch);
+static UINT WriteBatch_CheckDeadline(WriteBatch_T *Batch);
+static ULONG WriteBatch_Percentile(WriteBatch_T *Batch, ULONG Permille);
+static void WriteBatch_PrintSummary(CHAR *Name, WriteBatch_T *Batch);
+static void MediaCache_PrintSummary(FX_MEDIA *Media);
+static void SdDriver_PrintSummary(void);
+#ifdef STBOX1_SD_WRITE_QUEUE
+static void SdQueue_PrintSummary(void);
+#endif /* STBOX1_SD_WRITE_QUEUE */
+#ifdef STBOX1_FX_WRITE_BEHIND
+static void WriteBehind_PrintSummary(void);
+#endif /* STBOX1_FX_WRITE_BEHIND */
+#ifdef STBOX1_THREAD_PROFILER
+static VOID ThreadProfiler_Print(const CHAR *Json);
+#endif /* STBOX1_THREAD_PROFILER */
+#ifdef STBOX1_SD_PREALLOCATION
+static void LogFile_Preallocate(FX_FILE *File, ULONG64 Size);
+static UINT LogFile_Release(FX_FILE *File, ULONG64 Size);
+#endif /* STBOX1_SD_PREALLOCATION */
+#ifdef STBOX1_LOG_CHECKPOINT
+static void CheckpointLog_Recover(void);
+static void CheckpointLog_SetFile(UINT Index, WriteBatch_T *Batch, const CHAR *Name);
+static void CheckpointLog_Start(void);
+static void CheckpointLog_Check(void);
+static void CheckpointLog_Save(void);
+static void CheckpointLog_Process(void);
+static void CheckpointLog_Wait(void);
+static void CheckpointLog_Stop(void);
+static void CheckpointLog_PrintSummary(void);
+#ifdef STBOX1_LOG_ROTATION
+static void CheckpointLog_SetSegments(LogRotation_T *Rotation);
+#endif /* STBOX1_LOG_ROTATION */
+#endif /* STBOX1_LOG_CHECKPOINT */
+#ifdef STBOX1_LOG_TRIGGER
+static void LogTrigger_Start(void);
+static void LogTrigger_SendCommand(UINT CommandType, UINT Source);
+#ifdef STBOX1_LOG_TRIGGER_EMB_FUNC
+static void LogTrigger_PollEmbFunc(void);
+#endif /* STBOX1_LOG_TRIGGER_EMB_FUNC */
+static void LogTrigger_SaveSensors(MessageData_T *Msg);
+static void LogTrigger_Fire(UINT Source, ULONG Time);
+static void LogTrigger_Check(void);
+static void LogTrigger_Stop(void);
+static void LogTrigger_PrintSummary(void);
+#endif /* STBOX1_LOG_TRIGGER */
+#ifdef STBOX1_LOG_ROTATION
+static void LogRotation_FileName(CHAR *Name, const CHAR *Format, ULONG Session, ULONG Segment);
+static void LogRotation_Start(LogRotation_T *Rotation, ULONG Session);
+static void LogRotation_Check(LogRotation_T *Rotation, UINT (*Rotate)(void));
+static UINT LogRotation_Switch(LogRotation_T *Rotation, UCHAR *Header, ULONG HeaderSize);
+static void LogRotation_Process(LogRotation_T *Rotation);
+static ULONG64 LogRotation_Stop(LogRotation_T *Rotation);
+static void LogRotation_PrintSummary(CHAR *Name, LogRotation_T *Rotation);
+static UINT SensorsLog_Rotate(void);
+#ifndef STBOX1_LOG_CONTAINER
+static UINT AudioLog_Rotate(void);
+#endif /* STBOX1_LOG_CONTAINER */
+#endif /* STBOX1_LOG_ROTATION */
 /* USER CODE END PFP */
 
 /**
@@ -180,6 +897,20 @@ UINT MX_FileX_Init(VOID *memory_ptr)
   
   STBOX1_PRINTF("FileX Thread Created\r\n");
   
+#ifdef STBOX1_FX_WRITE_BEHIND
+  /* Start the write-behind layer between FileX and the SD driver */
+  if (LogWriteBehind_Init(fx_stm32_sd_driver, WriteBehindBuffer, sizeof(WriteBehindBuffer),
+                          STBOX1_FX_WRITE_BEHIND_EXTENT_SIZE * 1024,
+                          (STBOX1_FX_WRITE_BEHIND_DEADLINE * TX_TIMER_TICKS_PER_SECOND) / 1000,
+                          WRITE_BEHIND_THREAD_PRIO, WriteBehindStack, sizeof(WriteBehindStack)) != FX_SUCCESS)
+  {
+    /* Failed at creating the queue */
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  STBOX1_PRINTF("Write-behind Thread Created\r\n");
+#endif /* STBOX1_FX_WRITE_BEHIND */
+  
   /* Allocate memory for the reading thread's stack */
   ret = tx_byte_allocate(byte_pool, &pointer, DEFAULT_STACK_SIZE*2, TX_NO_WAIT);
   
@@ -196,8 +927,9 @@ UINT MX_FileX_Init(VOID *memory_ptr)
   
   STBOX1_PRINTF("Read Sensor Thread Created\r\n");
   
-  /* Allocate memory for MessageQueue */
-  ret = tx_byte_allocate(byte_pool, &pointer, MESSAGE_QUEUE_SIZE*sizeof(MessageData_T *), TX_NO_WAIT);
+#if defined(STBOX1_LOG_ROTATION) || defined(STBOX1_LOG_CHECKPOINT)
+  /* Allocate memory for the closing thread's stack */
+  ret = tx_byte_allocate(byte_pool, &pointer, DEFAULT_STACK_SIZE*2, TX_NO_WAIT);
   
   if (ret != FX_SUCCESS)
   {
@@ -205,20 +937,46 @@ UINT MX_FileX_Init(VOID *memory_ptr)
     Error_Handler(__FILE__,__LINE__);
   }
   
-  /* Create the MessageQueue shared by Reading and Writing Thread */
-  if (tx_queue_create(&MessageQueue, "Message Queue",sizeof(MessageData_T *)/4,
-                      pointer, MESSAGE_QUEUE_SIZE*sizeof(MessageData_T *)) != TX_SUCCESS)
+  /* Create the closing thread.  */
+  tx_thread_create(&close_app_thread, "FileX Closing App Thread", close_thread_entry, 0, pointer, DEFAULT_STACK_SIZE*2,
+                   CLOSE_APP_THREAD_PRIO, CLOSE_APP_PREEMPTION_THRESHOLD, TX_NO_TIME_SLICE, TX_AUTO_START);
+  
+  /* Create the events used for waking up the Closing Thread (and the Writing Thread) */
+  if (tx_event_flags_create(&ClosingEvents, "Closing Events") != TX_SUCCESS)
   {
-    ret = TX_QUEUE_ERROR;
+    /* Failed at creating the events */
+    Error_Handler(__FILE__,__LINE__);
   }
   
-  if (ret != FX_SUCCESS)
+  STBOX1_PRINTF("Closing Thread Created\r\n");
+#endif /* STBOX1_LOG_ROTATION || STBOX1_LOG_CHECKPOINT */
+  
+  /* Initialize the rings shared by the Reading Thread/audio callbacks and Writing Thread */
+  MsgRing_Init(&SensorsRing, SensorsRingBuffer, sizeof(MessageData_T), SENSORS_RING_SIZE);
+  MsgRing_Init(&AudioRing, AudioRingBuffer, sizeof(MessageData_T), AUDIO_RING_SIZE);
+  
+  /* Create the events used only for waking up the Writing Thread */
+  if (tx_event_flags_create(&MessageEvents, "Message Events") != TX_SUCCESS)
+  {
+    /* Failed at creating the events */
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  STBOX1_PRINTF("Message Rings Created\r\n");
+  
+#ifdef STBOX1_THREAD_PROFILER
+  /* Start the profiler: the threads are sampled by the HAL tick (TIM6) */
+  if ((ThreadProfiler_AddQueue("Sensors", SENSORS_RING_SIZE, &SensorsRing.MaxUsed, &SensorsRing.Overflows) != TX_SUCCESS) ||
+      (ThreadProfiler_AddQueue("Audio", AUDIO_RING_SIZE, &AudioRing.MaxUsed, &AudioRing.Overflows) != TX_SUCCESS) ||
+      (ThreadProfiler_Init(ThreadProfiler_Print, STBOX1_THREAD_PROFILER_PERIOD * TX_TIMER_TICKS_PER_SECOND,
+                           PROFILER_THREAD_PRIO, ProfilerStack, sizeof(ProfilerStack)) != TX_SUCCESS))
   {
-    /* Failed at allocating Queue */
+    /* Failed at creating the profiler */
     Error_Handler(__FILE__,__LINE__);
   }
   
-  STBOX1_PRINTF("MessageQueue Created\r\n");
+  STBOX1_PRINTF("Profiler Thread Created\r\n");
+#endif /* STBOX1_THREAD_PROFILER */
   
   /* Create the tx_timer */
   if(tx_timer_create(
@@ -226,8 +984,8 @@ UINT MX_FileX_Init(VOID *memory_ptr)
                      "ReadingTimer",
                      ReadingTimerCallbackFunction,
                      (ULONG)TX_NULL,
-                     1 /* 10ms */,
-                     1 /* 10ms */,
+                     READING_TIMER_PERIOD,
+                     READING_TIMER_PERIOD,
                      TX_NO_ACTIVATE) != TX_SUCCESS)
   {
     Error_Handler(__FILE__,__LINE__);
@@ -261,39 +1019,51 @@ static void fx_thread_entry(ULONG thread_input)
   
   UINT status;
   MessageData_T *RMsg;
-  CHAR header[] = "Time [mS], AccX [mg],AccY [mg],AccZ [mg],GyroX [mdps],GyroY [mdps],GyroZ [mdps],MagX [mgauss],MagY [mgauss],MagZ [mgauss],P [mB],T ['C]\r\n";
+  MsgRing_T *RRing;
   
   SHORT SDCardCounter = 0;
   CHAR file_name[30];
+  ULONG CreateTime;
   
   while (1) {
-    /* Determine whether a message MessageQueue  is available */
-    status = tx_queue_receive(&MessageQueue, &RMsg, TX_WAIT_FOREVER);
-    MessageRemoved++;
-    if (status == TX_SUCCESS)
+    /* Determine whether a message is available */
+    RMsg = MessageReceive(&RRing);
+    if (RMsg != NULL)
     {
       switch(RMsg->CommandType) {
       case COMMAND_START_LOG:
         {
           BSP_LED_Off(LED_RED);
           
-          /* Init the Queue Statics */
-          MessagePushed=0;
-          MessageRemoved=0;
-          MessageMaxSize=0;
+#ifdef STBOX1_LOW_POWER_IDLE
+          /* Sleep mode only while logging */
+          LowPowerIdle_AllowStop(TX_FALSE);
+#endif /* STBOX1_LOW_POWER_IDLE */
+          
+          /* Init the Rings Statics */
+          SensorsRing.MaxUsed=0;
+          SensorsRing.Overflows=0;
+          AudioRing.MaxUsed=0;
+          AudioRing.Overflows=0;
+          SensorsRecordsWritten=0;
+          SensorsFileSize=0;
+          
+#ifdef STBOX1_LOG_TRIGGER
+          /* The data are only kept on RAM up to the first trigger */
+          LogTrigger_Start();
           
-          /* Reset the Sensors and Mic out Buffers */
-          SensorBufferWritingPointer = SensorBuffer;
+#endif /* STBOX1_LOG_TRIGGER */
+          /* Reset the Mic out Buffer */
           WriteIndexBufferAudio = 0;
-          ReadIndexBufferAudio=STBOX1_AUDIO_DATA_NOT_READY;
           SkipFirst200mS=200;
           
           if(SensorsFileOpen==0) {
-            sprintf(file_name, "Sens%03d.csv",SDCardCounter);
-            SDCardCounter++;
-            
             /* Open the SD disk driver.  */
+#ifdef STBOX1_FX_WRITE_BEHIND
+            status =  fx_media_open(&sdio_disk, "STM32_SDIO_DISK", LogWriteBehind_Driver, 0,(VOID *) media_memory, sizeof(media_memory));
+#else /* STBOX1_FX_WRITE_BEHIND */
             status =  fx_media_open(&sdio_disk, "STM32_SDIO_DISK", fx_stm32_sd_driver, 0,(VOID *) media_memory, sizeof(media_memory));
+#endif /* STBOX1_FX_WRITE_BEHIND */
             
             /* Check the media open status.  */
             if (status != FX_SUCCESS)
@@ -303,9 +1073,58 @@ static void fx_thread_entry(ULONG thread_input)
             }
             
             STBOX1_PRINTF("SD FX Media Open\r\n");
+
+#ifdef STBOX1_LOG_CHECKPOINT
+            /* Complete (or undo) the FAT/directory updates interrupted by one power loss
+               and repair the last log not closed */
+            CheckpointLog_Recover();
+#endif /* STBOX1_LOG_CHECKPOINT */
+
+#ifdef STBOX1_LOG_RAW
+            /* Open (or create) the raw log area and start one new session on it */
+            CreateTime = HAL_GetTick();
+            status = LogRaw_Open(&RawLog, &sdio_disk, &SensorsFxFile, RAW_LOG_FILE_NAME, RAW_LOG_SIZE,
+                                 RawLogBuffer, STBOX1_LOG_RAW_BLOCK_SIZE, (uint32_t)CreateTime);
+            CreateTime = HAL_GetTick() - CreateTime;
             
-            /* Create a file in the root directory.  */
-            status =  fx_file_create(&sdio_disk, file_name);
+            /* Check the raw log open status.  */
+            if (status != FX_SUCCESS)
+            {
+              STBOX1_PRINTF("Error opening %s\r\n", RAW_LOG_FILE_NAME);
+              Error_Handler(__FILE__,__LINE__);
+            }
+            
+            if (RawLog.Recovered != 0) {
+              STBOX1_PRINTF("Session not closed: %ld blocks recovered\r\n", RawLog.Recovered);
+            }
+            
+            /* Name of the session once extracted */
+            LOG_FILE_NAME(file_name, SENSORS_FILE_NAME, RawLog.Session);
+            SDCardCounter = (SHORT) (RawLog.Session + 1);
+#else /* STBOX1_LOG_RAW */
+            CreateTime = HAL_GetTick();
+#ifdef STBOX1_LOG_SESSION_INDEX
+            /* Next free session from the index (one directory scan if it's not valid) */
+            status = LogSession_Read(&sdio_disk, &SessionFxFile, SESSION_INDEX_FILE_NAME, &LogSession);
+            
+            /* Check the index read status.  */
+            if (status != FX_SUCCESS)
+            {
+              STBOX1_PRINTF("Error reading %s\r\n", SESSION_INDEX_FILE_NAME);
+              Error_Handler(__FILE__,__LINE__);
+            }
+            
+            if (LogSession.Scanned != 0) {
+              STBOX1_PRINTF("Session index rebuilt (%ld entries read)\r\n", LogSession.Scanned);
+            }
+            SDCardCounter = (SHORT) LogSession.Next;
+#endif /* STBOX1_LOG_SESSION_INDEX */
+            
+            LOG_FILE_NAME(file_name, SENSORS_FILE_NAME,SDCardCounter);
+            SDCardCounter++;
+            
+            /* Create the log file.  */
+            status =  LOG_FILE_CREATE(file_name);
             
             /* Check the create status.  */
             if (status != FX_SUCCESS)
@@ -319,9 +1138,9 @@ static void fx_thread_entry(ULONG thread_input)
               } else {
                 /* Searching one available File */
                 while(status == FX_ALREADY_CREATED ) {
-                  sprintf(file_name, "Sens%03d.csv",SDCardCounter);
+                  LOG_FILE_NAME(file_name, SENSORS_FILE_NAME,SDCardCounter);
                   SDCardCounter++;
-                  status =  fx_file_create(&sdio_disk, file_name);
+                  status =  LOG_FILE_CREATE(file_name);
                   /* Check the create status.  */
                   if (status != FX_SUCCESS)
                   {
@@ -337,6 +1156,20 @@ static void fx_thread_entry(ULONG thread_input)
               }
             }
             
+#ifdef STBOX1_LOG_SESSION_INDEX
+            /* The next start begins from the following session */
+            LogSession.Next = (uint32_t) SDCardCounter;
+            status = LogSession_Write(&sdio_disk, &SessionFxFile, SESSION_INDEX_FILE_NAME, &LogSession);
+            
+            /* Check the index write status.  */
+            if (status != FX_SUCCESS)
+            {
+              STBOX1_PRINTF("Error writing %s\r\n", SESSION_INDEX_FILE_NAME);
+              Error_Handler(__FILE__,__LINE__);
+            }
+#endif /* STBOX1_LOG_SESSION_INDEX */
+            CreateTime = HAL_GetTick() - CreateTime;
+            
             /* Open the test file.  */
             status =  fx_file_open(&sdio_disk, &SensorsFxFile, file_name, FX_OPEN_FOR_WRITE);
             
@@ -347,6 +1180,7 @@ static void fx_thread_entry(ULONG thread_input)
               STBOX1_PRINTF("Error opening SensXXX.csv\r\n");
               Error_Handler(__FILE__,__LINE__);
             }
+#endif /* STBOX1_LOG_RAW */
             
             /* Seek to the beginning of the test file.  */
             status =  fx_file_seek(&SensorsFxFile, 0);
@@ -358,10 +1192,32 @@ static void fx_thread_entry(ULONG thread_input)
               Error_Handler(__FILE__,__LINE__);
             }
             SensorsFileOpen=1;
-            STBOX1_PRINTF("File %s open\r\n",file_name);
+            STBOX1_PRINTF("File %s open (created in %ld mS)\r\n",file_name,CreateTime);
+            
+#ifdef STBOX1_SD_PREALLOCATION
+            /* Reserve the clusters for the whole log */
+#ifdef STBOX1_LOG_CONTAINER
+            LogFile_Preallocate(&SensorsFxFile, LOG_PREALLOCATION_SIZE);
+#else /* STBOX1_LOG_CONTAINER */
+            LogFile_Preallocate(&SensorsFxFile, STBOX1_SD_SENSORS_PREALLOCATION_SIZE);
+#endif /* STBOX1_LOG_CONTAINER */
+#endif /* STBOX1_SD_PREALLOCATION */
+            
+#ifdef STBOX1_IMU_FIFO
+            /* Start the accelerometer and gyroscope batching on FIFO */
+            ImuFifo_Start();
+#endif /* STBOX1_IMU_FIFO */
             
-            /* Write a string to the test file.  */
-            status =  fx_file_write(&SensorsFxFile, header, sizeof(header)-1);
+            /* Start the write batching stage */
+            WriteBatch_Init(&SensorsBatch, &SensorsFxFile);
+            
+#ifdef STBOX1_SENSORS_LOG_BINARY
+            /* Initialize the binary file header */
+            SensorsLog_HeaderInit();
+#endif /* STBOX1_SENSORS_LOG_BINARY */
+            
+            /* Write the file header */
+            status =  SensorsLog_WriteHeader();
             
             /* Check the file write status.  */
             if (status != FX_SUCCESS)
@@ -370,6 +1226,15 @@ static void fx_thread_entry(ULONG thread_input)
               STBOX1_PRINTF("Error writing SensXXX.csv\r\n");
               Error_Handler(__FILE__,__LINE__);
             }
+
+#ifdef STBOX1_LOG_CHECKPOINT
+            CheckpointLog_SetFile(CHECKPOINT_FILE_SENSORS, &SensorsBatch, file_name);
+#endif /* STBOX1_LOG_CHECKPOINT */
+
+#ifdef STBOX1_LOG_ROTATION
+            /* The next segment is opened in background */
+            LogRotation_Start(&SensorsRotation, SDCardCounter-1);
+#endif /* STBOX1_LOG_ROTATION */
             
             if (tx_timer_activate(&ReadTimer)!=TX_SUCCESS)
             {
@@ -382,7 +1247,15 @@ static void fx_thread_entry(ULONG thread_input)
           }
           
           if(AudioFileOpen==0) {
-            sprintf(file_name, "Mic%03d.wav",SDCardCounter-1);
+#ifdef STBOX1_LOG_CONTAINER
+            /* The audio is saved on the LogXXX.stb file */
+#ifdef STBOX1_AUDIO_COMPRESSION
+            AudioLac_Init(&AudioEncoder);
+            AudioEncoderCycles = 0;
+#endif /* STBOX1_AUDIO_COMPRESSION */
+            AudioFileOpen=1;
+#else /* STBOX1_LOG_CONTAINER */
+            LOG_FILE_NAME(file_name, AUDIO_FILE_NAME,SDCardCounter-1);
             
             /* Create a file in the root directory.  */
             status =  fx_file_create(&sdio_disk, file_name);
@@ -422,11 +1295,23 @@ static void fx_thread_entry(ULONG thread_input)
             AudioFileOpen=1;
             STBOX1_PRINTF("File %s open\r\n",file_name);
             
-            /* Initialize the Wav Header file */
-            WavProcess_HeaderInit();
+#ifdef STBOX1_SD_PREALLOCATION
+            /* Reserve the clusters for the whole log */
+            LogFile_Preallocate(&AudioFxFile, STBOX1_SD_AUDIO_PREALLOCATION_SIZE);
+#endif /* STBOX1_SD_PREALLOCATION */
+            
+            /* Start the write batching stage */
+            WriteBatch_Init(&AudioBatch, &AudioFxFile);
             
-            /* Write the Wav header  */
-            status =  fx_file_write(&AudioFxFile, pAudioHeader, sizeof(pAudioHeader));
+#ifdef STBOX1_AUDIO_COMPRESSION
+            /* Initialize the encoder */
+            AudioLac_Init(&AudioEncoder);
+            AudioEncoderCycles = 0;
+            AudioFirstSample = 0;
+#endif /* STBOX1_AUDIO_COMPRESSION */
+            
+            /* Write the file header */
+            status =  AudioLog_WriteHeader();
             
             /* Check the file write status.  */
             if (status != FX_SUCCESS)
@@ -435,12 +1320,30 @@ static void fx_thread_entry(ULONG thread_input)
               STBOX1_PRINTF("Error writing MicXXX.csv\r\n");
               Error_Handler(__FILE__,__LINE__);
             }
+
+#ifdef STBOX1_LOG_CHECKPOINT
+            CheckpointLog_SetFile(CHECKPOINT_FILE_AUDIO, &AudioBatch, file_name);
+#endif /* STBOX1_LOG_CHECKPOINT */
+
+#ifdef STBOX1_LOG_ROTATION
+            /* The next segment is opened in background */
+            LogRotation_Start(&AudioRotation, SDCardCounter-1);
+#endif /* STBOX1_LOG_ROTATION */
+#endif /* STBOX1_LOG_CONTAINER */
+            
+            AudioSaveBlocks = 0;
+            AudioSaveTime = 0;
+            AudioSaveMaxTime = 0;
+            AudioCallbacks = 0;
+            AudioCallbackCycles = 0;
+            AudioCallbackMaxCycles = 0;
             
-            /* Starting the Acquistion from Digital Microphone */
+            /* Starting the Acquistion from Digital Microphone
+               (all the microphones together, interleaved, if AUDIO_IN_CHANNELS > 1) */
             BSP_AUDIO_Init_t MicParams;
             
             MicParams.BitsPerSample = 16;
-            MicParams.ChannelsNbr = 1;
+            MicParams.ChannelsNbr = AUDIO_IN_CHANNELS;
             MicParams.Device = ACTIVE_MICROPHONES_MASK;
             MicParams.SampleRate = AUDIO_IN_SAMPLING_FREQUENCY;
             MicParams.Volume = AUDIO_VOLUME_INPUT;
@@ -450,7 +1353,10 @@ static void fx_thread_entry(ULONG thread_input)
               while(1);
             }
             
-            if(BSP_AUDIO_IN_Record(0 /*BSP_AUDIO_IN_INSTANCE*/, (uint8_t *) OnBoard_PCM_Buffer, PCM_AUDIO_IN_SAMPLES) != BSP_ERROR_NONE){
+            /* The BSP will write the data directly on the first audio block */
+            AudioMsg = (MessageData_T *) MsgRing_Reserve(&AudioRing);
+            
+            if(BSP_AUDIO_IN_Record(0 /*BSP_AUDIO_IN_INSTANCE*/, AudioProcess_NextBuffer(), PCM_AUDIO_IN_SAMPLES) != BSP_ERROR_NONE){
               STBOX1_PRINTF("ERROR Starting MIC\r\n");
               while(1);
             }
@@ -460,6 +1366,11 @@ static void fx_thread_entry(ULONG thread_input)
           } else {
             STBOX1_PRINTF("Error MicXXX.wav already opened\r\n");
           }
+
+#ifdef STBOX1_LOG_CHECKPOINT
+          /* First checkpoint: the log is open */
+          CheckpointLog_Start();
+#endif /* STBOX1_LOG_CHECKPOINT */
         }
         break;
       case COMMAND_STOP_LOG:
@@ -470,17 +1381,46 @@ static void fx_thread_entry(ULONG thread_input)
               Error_Handler(__FILE__,__LINE__);
             }
             
-            /* Flush the Queue for Sensors Data */
-            status = tx_queue_flush(&MessageQueue);
+#ifdef STBOX1_IMU_FIFO
+            /* Stop the FIFO batching (the data still on the FIFO are discarded) */
+            ImuFifo_Stop();
+#endif /* STBOX1_IMU_FIFO */
             
+            /* The Sensors Data still on the ring will be discarded */
+            
+#ifdef STBOX1_LOG_CONTAINER
+            /* The LogXXX.stb file is closed after saving the last audio blocks */
+#else /* STBOX1_LOG_CONTAINER */
+            /* Write out the data still present on the write batching stage */
+            status = WriteBatch_Flush(&SensorsBatch);
+            if (status != FX_SUCCESS)
+            {
+              /* Error writing to a file, call error handler.  */
+              STBOX1_PRINTF("Error writing SensXXX.csv\r\n");
+              Error_Handler(__FILE__,__LINE__);
+            }
+            
+            /* size of the SensXXX file */
+            SensorsFileSize = SensorsBatch.Offset;
+            
+#ifdef STBOX1_LOG_ROTATION
+            /* Remove the next segment (plus the size of the previous ones) */
+            SensorsFileSize += LogRotation_Stop(&SensorsRotation);
+#endif /* STBOX1_LOG_ROTATION */
+            
+#ifdef STBOX1_SD_PREALLOCATION
+            /* Release the reserved clusters not used */
+            status = LogFile_Release(SensorsBatch.File, SensorsBatch.Offset);
             if (status != FX_SUCCESS)
             {
-              /* Error flushing the queue, call error handler.  */
+              /* Error releasing the clusters, call error handler.  */
+              STBOX1_PRINTF("Error releasing SensXXX.csv clusters\r\n");
               Error_Handler(__FILE__,__LINE__);
             }
+#endif /* STBOX1_SD_PREALLOCATION */
             
             /* Close the test file.  */
-            status =  fx_file_close(&SensorsFxFile);
+            status =  fx_file_close(SensorsBatch.File);
             
             /* Check the file close status.  */
             if (status != FX_SUCCESS)
@@ -491,6 +1431,7 @@ static void fx_thread_entry(ULONG thread_input)
             }
             
             STBOX1_PRINTF("File SensXXX.csv closed\r\n");
+#endif /* STBOX1_LOG_CONTAINER */
             SensorsFileOpen=0;
           } else {
             STBOX1_PRINTF("Error SensXXX.csv Not opened\r\n");
@@ -509,18 +1450,60 @@ static void fx_thread_entry(ULONG thread_input)
             
             STBOX1_PRINTF("MIC Stop\r\n");
             
-            /* Flush the Queue for Sensors Data */
-            status = tx_queue_flush(&MessageQueue);
+#ifdef STBOX1_LOG_TRIGGER
+            /* Outside one capture the audio blocks kept on the ring are discarded */
+            LogTrigger_Stop();
+            
+#endif /* STBOX1_LOG_TRIGGER */
+            /* Save the audio blocks still on the ring and the last partial one */
+            {
+              MessageData_T *AMsg;
+              
+              while((AMsg = (MessageData_T *) MsgRing_Peek(&AudioRing)) != NULL) {
+                AudioProcess_SaveBlock(AMsg, AUDIO_BLOCK_SAMPLES);
+                MsgRing_Release(&AudioRing);
+              }
+              
+              if(AudioMsg != NULL) {
+                AudioProcess_SaveBlock(AudioMsg, WriteIndexBufferAudio);
+                AudioMsg = NULL;
+              }
+            }
+            
+#ifdef STBOX1_LOG_CONTAINER
+            /* Write out the last chunks and the index and close the LogXXX.stb file */
+            ContainerLog_Stop();
+#else /* STBOX1_LOG_CONTAINER */
+#ifdef STBOX1_AUDIO_COMPRESSION
+            /* Write out the compressed frames still present on the write batching stage */
+            status = WriteBatch_Flush(&AudioBatch);
+            if (status != FX_SUCCESS)
+            {
+              /* Error writing to a file, call error handler.  */
+              STBOX1_PRINTF("Error writing MicXXX.lac\r\n");
+              Error_Handler(__FILE__,__LINE__);
+            }
+#endif /* STBOX1_AUDIO_COMPRESSION */
+            
+#ifdef STBOX1_LOG_ROTATION
+            /* Remove the next segment */
+            LogRotation_Stop(&AudioRotation);
+#endif /* STBOX1_LOG_ROTATION */
             
             /* Update the  MicXXX.wav header */
             {
+#ifdef STBOX1_AUDIO_COMPRESSION
+              /* Number of samples saved */
+              AudioLac_HeaderUpdate(pAudioHeader, AudioEncoder.Samples - AudioFirstSample);
+#else /* STBOX1_AUDIO_COMPRESSION */
               /* size of the MicXXX.wav file */
-              uint32_t len =  AudioFxFile.fx_file_current_file_size;
+              uint32_t len =  (uint32_t)AudioBatch.Offset;
               
               WavProcess_HeaderUpdate(len);
+#endif /* STBOX1_AUDIO_COMPRESSION */
               
               /* Move at the file beginning */
-              status = fx_file_seek(&AudioFxFile,0);
+              status = fx_file_seek(AudioBatch.File,0);
               if (status != FX_SUCCESS)
               {
                 /* Error moving at the file beginning, call error handler.  */
@@ -528,7 +1511,7 @@ static void fx_thread_entry(ULONG thread_input)
               }
               
               /* Write the updated Wav header  */
-              status =  fx_file_write(&AudioFxFile, pAudioHeader, sizeof(pAudioHeader));
+              status =  fx_file_write(AudioBatch.File, pAudioHeader, AUDIO_HEADER_SIZE);
               if (status != FX_SUCCESS)
               {
                 /* Error writing the file, call error handler.  */
@@ -538,8 +1521,19 @@ static void fx_thread_entry(ULONG thread_input)
               
             }
             
+#ifdef STBOX1_SD_PREALLOCATION
+            /* Release the reserved clusters not used */
+            status = LogFile_Release(AudioBatch.File, AudioBatch.Offset);
+            if (status != FX_SUCCESS)
+            {
+              /* Error releasing the clusters, call error handler.  */
+              STBOX1_PRINTF("Error releasing MicXXX.wav clusters\r\n");
+              Error_Handler(__FILE__,__LINE__);
+            }
+#endif /* STBOX1_SD_PREALLOCATION */
+            
             /* Close the test file.  */
-            status =  fx_file_close(&AudioFxFile);
+            status =  fx_file_close(AudioBatch.File);
             
             /* Check the file close status.  */
             if (status != FX_SUCCESS)
@@ -550,9 +1544,15 @@ static void fx_thread_entry(ULONG thread_input)
             }
             
             STBOX1_PRINTF("File MicXXX.wav closed\r\n");
+#endif /* STBOX1_LOG_CONTAINER */
             
             AudioFileOpen=0;
             
+#ifdef STBOX1_LOG_CHECKPOINT
+            /* Last checkpoint: the log is closed */
+            CheckpointLog_Stop();
+            
+#endif /* STBOX1_LOG_CHECKPOINT */
             /* Close the media.  */
             status =  fx_media_close(&sdio_disk);
             
@@ -569,8 +1569,58 @@ static void fx_thread_entry(ULONG thread_input)
             STBOX1_PRINTF("|--------------------|\r\n");
             STBOX1_PRINTF("| Queues summary:    |\r\n");
             STBOX1_PRINTF("|--------------------|\r\n");
-            STBOX1_PRINTF("|   Queue Max: %4d  |\r\n",MessageMaxSize);
+            STBOX1_PRINTF("| Sensors Max: %4ld  |\r\n",SensorsRing.MaxUsed);
+            STBOX1_PRINTF("| Sensors Drop: %3ld  |\r\n",SensorsRing.Overflows);
+            STBOX1_PRINTF("| Audio Max: %6ld  |\r\n",AudioRing.MaxUsed);
+            STBOX1_PRINTF("| Audio Drop: %5ld  |\r\n",AudioRing.Overflows);
+            STBOX1_PRINTF("|--------------------|\r\n");
+            STBOX1_PRINTF("| Sensors summary:   |\r\n");
+            STBOX1_PRINTF("|--------------------|\r\n");
+            STBOX1_PRINTF("| Records: %8ld  |\r\n",SensorsRecordsWritten);
+            STBOX1_PRINTF("| Bytes: %10ld  |\r\n",SensorsFileSize);
             STBOX1_PRINTF("|--------------------|\r\n");
+            AudioProcess_PrintSummary();
+#ifdef STBOX1_IMU_FIFO
+            ImuFifo_PrintSummary();
+#endif /* STBOX1_IMU_FIFO */
+#ifdef STBOX1_LOG_CONTAINER
+            ContainerLog_PrintSummary();
+#ifdef STBOX1_LOG_RAW
+            RawLog_PrintSummary();
+#endif /* STBOX1_LOG_RAW */
+            WriteBatch_PrintSummary("Log writes:", &SensorsBatch);
+#ifdef STBOX1_LOG_ROTATION
+            LogRotation_PrintSummary("Log segments:", &SensorsRotation);
+#endif /* STBOX1_LOG_ROTATION */
+#else /* STBOX1_LOG_CONTAINER */
+            WriteBatch_PrintSummary("Sensors writes:", &SensorsBatch);
+            WriteBatch_PrintSummary("Audio writes:", &AudioBatch);
+#ifdef STBOX1_LOG_ROTATION
+            LogRotation_PrintSummary("Sensors segments:", &SensorsRotation);
+            LogRotation_PrintSummary("Audio segments:", &AudioRotation);
+#endif /* STBOX1_LOG_ROTATION */
+#endif /* STBOX1_LOG_CONTAINER */
+#ifdef STBOX1_AUDIO_COMPRESSION
+            AudioCodec_PrintSummary();
+#endif /* STBOX1_AUDIO_COMPRESSION */
+#ifdef STBOX1_LOG_CHECKPOINT
+            CheckpointLog_PrintSummary();
+#endif /* STBOX1_LOG_CHECKPOINT */
+#ifdef STBOX1_LOG_TRIGGER
+            LogTrigger_PrintSummary();
+#endif /* STBOX1_LOG_TRIGGER */
+            MediaCache_PrintSummary(&sdio_disk);
+            SdDriver_PrintSummary();
+#ifdef STBOX1_SD_WRITE_QUEUE
+            SdQueue_PrintSummary();
+#endif /* STBOX1_SD_WRITE_QUEUE */
+#ifdef STBOX1_FX_WRITE_BEHIND
+            WriteBehind_PrintSummary();
+#endif /* STBOX1_FX_WRITE_BEHIND */
+#ifdef STBOX1_LOW_POWER_IDLE
+            /* The media is closed */
+            LowPowerIdle_AllowStop(TX_TRUE);
+#endif /* STBOX1_LOW_POWER_IDLE */
             
           } else {
             STBOX1_PRINTF("Error MicXXX.wav Not opened\r\n");
@@ -580,16 +1630,7 @@ static void fx_thread_entry(ULONG thread_input)
       case COMMAND_SAVE_AUDIO:
         {
           if(AudioFileOpen==1) {
-            if(ReadIndexBufferAudio!=STBOX1_AUDIO_DATA_NOT_READY) {
-              status =  fx_file_write(&AudioFxFile, (UCHAR*) (Audio_OUT_Buff+ReadIndexBufferAudio), AUDIO_BUFF_SIZE);
-              /* Check the file write status.  */
-              if (status != FX_SUCCESS)
-              {
-                /* Error writing to a file, call error handler.  */
-                STBOX1_PRINTF("Error writing MicXXX.csv\r\n");
-                Error_Handler(__FILE__,__LINE__);
-              }
-            }
+            AudioProcess_SaveBlock(RMsg, AUDIO_BLOCK_SAMPLES);
           }
         }
         break;
@@ -597,48 +1638,134 @@ static void fx_thread_entry(ULONG thread_input)
       case COMMAND_SAVE_SENSORS:
         {
           if(SensorsFileOpen) {
-            CHAR data_s[256];
-            INT size;
-            size = sprintf(data_s, "%ld, %d, %d, %d, %d, %d, %d, %d, %d, %d, %5.2f, %5.2f\r\n",
-                           RMsg->MsgTime,
-                           RMsg->acc.x , RMsg->acc.y , RMsg->acc.z ,
-                           RMsg->gyro.x, RMsg->gyro.y, RMsg->gyro.z,
-                           RMsg->mag.x , RMsg->mag.y , RMsg->mag.z ,
-                           RMsg->pressure, RMsg->temperature);
-            
-            /* Write a string to the test file.  */
-            status =  fx_file_write(&SensorsFxFile, data_s, size);
-            
-            /* Check the file write status.  */
-            if (status != FX_SUCCESS)
-            {
-              /* Error writing to a file, call error handler.  */
-              STBOX1_PRINTF("Error writing SensXXX.csv\r\n");
-              Error_Handler(__FILE__,__LINE__);
-            }
+#ifdef STBOX1_LOG_TRIGGER
+            /* Saved only around the triggers */
+            LogTrigger_SaveSensors(RMsg);
+#else /* STBOX1_LOG_TRIGGER */
+            SensorsLog_Save(RMsg);
+#endif /* STBOX1_LOG_TRIGGER */
           }
           BSP_LED_Toggle(LED_GREEN);
         }
         break;
         
+#ifdef STBOX1_LOG_TRIGGER
+      case COMMAND_TRIGGER:
+        {
+          if(SensorsFileOpen) {
+            LogTrigger_Fire(RMsg->TriggerSource, RMsg->MsgTime);
+          }
+        }
+        break;
+        
+#endif /* STBOX1_LOG_TRIGGER */
       default:
         STBOX1_PRINTF("Command =%d Not recognized\r\n",RMsg->CommandType);
         Error_Handler(__FILE__,__LINE__);
       }
+      
+      /* Give back the message to its producer */
+      MsgRing_Release(RRing);
+
+      /* Write out the data that are waiting for too long on the write batching stages */
+      if(SensorsFileOpen) {
+#ifdef STBOX1_LOG_CONTAINER
+        if (ContainerLog_CheckDeadline() != FX_SUCCESS)
+        {
+          STBOX1_PRINTF("Error writing LogXXX.stb\r\n");
+          Error_Handler(__FILE__,__LINE__);
+        }
+#endif /* STBOX1_LOG_CONTAINER */
+        if (WriteBatch_CheckDeadline(&SensorsBatch) != FX_SUCCESS)
+        {
+          STBOX1_PRINTF("Error writing SensXXX.csv\r\n");
+          Error_Handler(__FILE__,__LINE__);
+        }
+      }
+#if defined(STBOX1_AUDIO_COMPRESSION) && !defined(STBOX1_LOG_CONTAINER)
+      if(AudioFileOpen) {
+        if (WriteBatch_CheckDeadline(&AudioBatch) != FX_SUCCESS)
+        {
+          STBOX1_PRINTF("Error writing MicXXX.lac\r\n");
+          Error_Handler(__FILE__,__LINE__);
+        }
+      }
+#endif /* STBOX1_AUDIO_COMPRESSION && !STBOX1_LOG_CONTAINER */
+#ifdef STBOX1_LOG_ROTATION
+      /* Switch to the next segment when the current one is too big or too long */
+      if(SensorsFileOpen) {
+        LogRotation_Check(&SensorsRotation, SensorsLog_Rotate);
+      }
+#ifndef STBOX1_LOG_CONTAINER
+      if(AudioFileOpen) {
+        LogRotation_Check(&AudioRotation, AudioLog_Rotate);
+      }
+#endif /* STBOX1_LOG_CONTAINER */
+#endif /* STBOX1_LOG_ROTATION */
+#ifdef STBOX1_LOG_CHECKPOINT
+      /* Save the log state every STBOX1_LOG_CHECKPOINT_TIME seconds */
+      if(SensorsFileOpen || AudioFileOpen) {
+        CheckpointLog_Check();
+      }
+#endif /* STBOX1_LOG_CHECKPOINT */
+#ifdef STBOX1_LOG_TRIGGER
+      /* End of the capture after STBOX1_LOG_TRIGGER_POST_TIME seconds */
+      LogTrigger_Check();
+#endif /* STBOX1_LOG_TRIGGER */
+
+    } else {
+      ULONG Events;
+      
+      /* Wait for one new message */
+      if (tx_event_flags_get(&MessageEvents, MESSAGE_EVENT_SENSORS | MESSAGE_EVENT_AUDIO, TX_OR_CLEAR,
+                             &Events, TX_WAIT_FOREVER) != TX_SUCCESS)
+      {
+        Error_Handler(__FILE__,__LINE__);
+      }
     }
   }
 }
 
 /**
-* @brief  BSP Push Button callback
-*
-* @param  Button Specifies the pin connected EXTI line
-* @retval None
+* @brief  Get the next message for the Writing thread.
+*         The audio blocks have the precedence on the sensors data
+*         (with STBOX1_LOG_TRIGGER they are kept on the ring up to the trigger)
+* @param  Ring: Ring where the message must be released
+* @retval Message or NULL if both the rings are empty
 */
-void BSP_PB_Callback(Button_TypeDef Button)
+static MessageData_T *MessageReceive(MsgRing_T **Ring)
 {
-  if(Button == BUTTON_USER) {
-    /* Set the User Button flag */
+  MessageData_T *Msg;
+  
+  *Ring = &AudioRing;
+  Msg = (MessageData_T *) MsgRing_Peek(&AudioRing);
+  
+#ifdef STBOX1_LOG_TRIGGER
+  if((Msg != NULL) && (LogTrigger.Capture == 0) && AudioFileOpen) {
+    /* Before the trigger only the last audio blocks are kept on the ring */
+    LogTrigger.AudioDiscarded += MsgRing_Trim(&AudioRing, TRIGGER_AUDIO_HISTORY);
+    Msg = NULL;
+  }
+  
+#endif /* STBOX1_LOG_TRIGGER */
+  if(Msg == NULL) {
+    *Ring = &SensorsRing;
+    Msg = (MessageData_T *) MsgRing_Peek(&SensorsRing);
+  }
+  
+  return Msg;
+}
+
+/**
+* @brief  BSP Push Button callback
+*
+* @param  Button Specifies the pin connected EXTI line
+* @retval None
+*/
+void BSP_PB_Callback(Button_TypeDef Button)
+{
+  if(Button == BUTTON_USER) {
+    /* Set the User Button flag */
     UserButtonPressed = SET;
     /* Release the Semaphore */
     tx_semaphore_put(&SemaphorePtr);
@@ -649,68 +1776,140 @@ static void read_thread_entry(ULONG thread_input)
 {
   MessageData_T *Msg;
   INT LogCommandType = COMMAND_STOP_LOG;
+#ifdef STBOX1_LOG_TRIGGER
+  ULONG ClickTime = 0;
+  UCHAR ClickPending = 0;
+#endif /* STBOX1_LOG_TRIGGER */
   while(1)
   {
     tx_semaphore_get(&SemaphorePtr,TX_WAIT_FOREVER);
     
-    Msg = (MessageData_T *)SensorBufferWritingPointer;
-    SensorBufferWritingPointer+=sizeof(MessageData_T);
-    if(SensorBufferWritingPointer == SensorBufferEndPointer) {
-      SensorBufferWritingPointer = SensorBuffer;
-    }
-    
     if(UserButtonPressed) {
       static ULONG ButtonPressedTime=0;
       ULONG NewTime;
       UserButtonPressed=0;
       
       NewTime = tx_time_get();
+#ifdef STBOX1_LOG_TRIGGER
+      if(LogCommandType==COMMAND_START_LOG) {
+        /* While logging one click is one trigger (sent when the double click
+           time expires) and one double click stops the log */
+        if((NewTime-ButtonPressedTime)>TRIGGER_DEBOUNCE_TIME) {
+          ButtonPressedTime = NewTime;
+          if(ClickPending == 0) {
+            ClickPending = 1;
+            ClickTime = NewTime;
+          } else {
+            ClickPending = 0;
+            LogCommandType = COMMAND_STOP_LOG;
+            LogTrigger_SendCommand(COMMAND_STOP_LOG, 0);
+          }
+        }
+        continue;
+      }
+#endif /* STBOX1_LOG_TRIGGER */
       /* For avoiding a double click */
       if((NewTime-ButtonPressedTime)>100) {
         ButtonPressedTime = NewTime;
+        
+        /* The commands are never discarded */
+        while((Msg = (MessageData_T *) MsgRing_Reserve(&SensorsRing)) == NULL) {
+          tx_thread_sleep(1);
+        }
+        
         if(LogCommandType==COMMAND_STOP_LOG) {
           Msg->CommandType = LogCommandType = COMMAND_START_LOG;
         } else {
           Msg->CommandType = LogCommandType = COMMAND_STOP_LOG;
         }
         
-        /* Send message to MessageQueue.  */
-        if (tx_queue_send(&MessageQueue, &Msg, TX_WAIT_FOREVER) != TX_SUCCESS)
-        {
-          STBOX1_PRINTF("Error Queue Max: %4d\r\n",MessageMaxSize);
-          Error_Handler(__FILE__,__LINE__);
-        }
-        MessagePushed++;
-        if((MessagePushed-MessageRemoved) > MessageMaxSize) {
-          MessageMaxSize = MessagePushed-MessageRemoved;
-        }
+        /* Send message to the Writing Thread */
+        MsgRing_Commit(&SensorsRing);
+        tx_event_flags_set(&MessageEvents, MESSAGE_EVENT_SENSORS, TX_OR);
       }
     } else {
       if(SensorsFileOpen == 1) {
+#ifdef STBOX1_LOG_TRIGGER
+        /* One click without the second one */
+        if(ClickPending && ((tx_time_get() - ClickTime) > TRIGGER_DOUBLE_CLICK_TIME)) {
+          ClickPending = 0;
+          LogTrigger_SendCommand(COMMAND_TRIGGER, TRIGGER_SOURCE_BUTTON);
+        }
+#ifdef STBOX1_LOG_TRIGGER_EMB_FUNC
+        LogTrigger_PollEmbFunc();
+#endif /* STBOX1_LOG_TRIGGER_EMB_FUNC */
+#endif /* STBOX1_LOG_TRIGGER */
+#ifdef STBOX1_IMU_FIFO
+        /* Read the FIFO when it reaches the watermark */
+        ImuFifo_Drain();
+#else /* STBOX1_IMU_FIFO */
+        /* If the ring is full the sample is discarded (and counted) */
+        Msg = (MessageData_T *) MsgRing_Reserve(&SensorsRing);
+        if(Msg == NULL) {
+          continue;
+        }
+        
+
         /* Read Sensors' Value */
         Msg->CommandType = COMMAND_SAVE_SENSORS;
         Msg->MsgTime=tx_time_get();
+#ifdef STBOX1_LOG_CONTAINER
+        Msg->LogTime=HAL_GetTick();
+        Msg->SlowSensors=1;
+#endif /* STBOX1_LOG_CONTAINER */
         BSP_ENV_SENSOR_GetValue(STTS22H_0, ENV_TEMPERATURE, &Msg->temperature);
         BSP_ENV_SENSOR_GetValue(LPS22DF_0, ENV_PRESSURE, &Msg->pressure);
         BSP_MOTION_SENSOR_GetAxes(LSM6DSV16X_0, MOTION_ACCELERO,&Msg->acc);
         BSP_MOTION_SENSOR_GetAxes(LSM6DSV16X_0, MOTION_GYRO,&Msg->gyro);
         BSP_MOTION_SENSOR_GetAxes(LIS2MDL_0, MOTION_MAGNETO,&Msg->mag);
         
-        /* Send message to MessageQueue.  */
-        if (tx_queue_send(&MessageQueue, &Msg, TX_WAIT_FOREVER) != TX_SUCCESS)
-        {
-          STBOX1_PRINTF("Error Queue Max: %4d\r\n",MessageMaxSize);
-          Error_Handler(__FILE__,__LINE__);
-        }
-        MessagePushed++;
-        if((MessagePushed-MessageRemoved) > MessageMaxSize) {
-          MessageMaxSize = MessagePushed-MessageRemoved;
-        }
+        /* Send message to the Writing Thread */
+        MsgRing_Commit(&SensorsRing);
+        tx_event_flags_set(&MessageEvents, MESSAGE_EVENT_SENSORS, TX_OR);
+#endif /* STBOX1_IMU_FIFO */
       }
     }
   }
 }
 
+#if defined(STBOX1_LOG_ROTATION) || defined(STBOX1_LOG_CHECKPOINT)
+/**
+* @brief  Closing thread: it saves the checkpoints handed off by the Writing
+*         thread, completes and closes the finished segments and opens the
+*         next ones in background
+* @param  thread_input: not used
+* @retval None
+*/
+static void close_thread_entry(ULONG thread_input)
+{
+  ULONG Events;
+  
+  while(1) {
+    if (tx_event_flags_get(&ClosingEvents, ROTATION_EVENT_SENSORS | ROTATION_EVENT_AUDIO | CHECKPOINT_EVENT_SAVE,
+                           TX_OR_CLEAR, &Events, TX_WAIT_FOREVER) != TX_SUCCESS)
+    {
+      Error_Handler(__FILE__,__LINE__);
+    }
+    
+#ifdef STBOX1_LOG_CHECKPOINT
+    /* The checkpoint first: it names the segment that is going to be created */
+    if(Events & CHECKPOINT_EVENT_SAVE) {
+      CheckpointLog_Process();
+    }
+#endif /* STBOX1_LOG_CHECKPOINT */
+#ifdef STBOX1_LOG_ROTATION
+    if(Events & ROTATION_EVENT_SENSORS) {
+      LogRotation_Process(&SensorsRotation);
+    }
+#ifndef STBOX1_LOG_CONTAINER
+    if(Events & ROTATION_EVENT_AUDIO) {
+      LogRotation_Process(&AudioRotation);
+    }
+#endif /* STBOX1_LOG_CONTAINER */
+#endif /* STBOX1_LOG_ROTATION */
+  }
+}
+#endif /* STBOX1_LOG_ROTATION || STBOX1_LOG_CHECKPOINT */
 
 /**
 * @brief Half Transfer user callback, called by BSP functions.
@@ -721,7 +1920,7 @@ void BSP_AUDIO_IN_HalfTransfer_CallBack(uint32_t Instance)
 {
   UNUSED(Instance);
   if(AudioFileOpen) {
-    AudioProcess_SD_Recording(OnBoard_PCM_Buffer, PCM_AUDIO_IN_SAMPLES);  
+    AudioProcess_SD_Recording(PCM_AUDIO_IN_SAMPLES);
   }
 }
 
@@ -734,88 +1933,240 @@ void BSP_AUDIO_IN_TransferComplete_CallBack(uint32_t Instance)
 {
   UNUSED(Instance);
   if(AudioFileOpen) {
-    AudioProcess_SD_Recording(OnBoard_PCM_Buffer, PCM_AUDIO_IN_SAMPLES);  
+    AudioProcess_SD_Recording(PCM_AUDIO_IN_SAMPLES);
   }
 }
 
 
 /**
-* @brief  Management of the audio data logging
-* @param  pInBuff     points to the audio buffer.
+* @brief  Management of the audio data logging.
+*         The BSP has already written the data on the audio block
+*         (the cycles are counted by the DWT enabled in tx_initialize_low_level)
 * @param  len         number of samples to process.
 * @retval None
 */
-static void AudioProcess_SD_Recording(uint16_t *pInBuff, uint32_t len)
+static void AudioProcess_SD_Recording(uint32_t len)
 {
+  uint32_t StartCycles = DWT->CYCCNT;
+  uint32_t Cycles;
+  
   if(SkipFirst200mS>0) {
     /* Tmp workaround for Initial Mic glitch */
     SkipFirst200mS--;
     return;
   }
-  /* Accumulate audio buffer into local ping-pong buffer before writing */  
-  memcpy(Audio_OUT_Buff + WriteIndexBufferAudio, pInBuff, len * sizeof(uint16_t));
-  WriteIndexBufferAudio += len;
-  
-  //WriteIndexBufferAudio &=AUDIO_BUFF_SIZE_MASK;
-  WriteIndexBufferAudio %=AUDIO_BUFF_SIZE;
   
-  if(WriteIndexBufferAudio == (AUDIO_BUFF_SIZE/2)){
-    MessageData_T *Msg;
-    Msg = (MessageData_T *)SensorBufferWritingPointer;
-    SensorBufferWritingPointer+=sizeof(MessageData_T);
-    if(SensorBufferWritingPointer == SensorBufferEndPointer) {
-      SensorBufferWritingPointer = SensorBuffer;
+  if(AudioMsg == NULL) {
+    /* The last data have been discarded: retry with one free block */
+    AudioMsg = (MessageData_T *) MsgRing_Reserve(&AudioRing);
+    WriteIndexBufferAudio = 0;
+  } else {
+#ifdef STBOX1_LOG_CONTAINER
+    if(WriteIndexBufferAudio == 0) {
+      /* Time of the first sample of the block */
+      AudioMsg->LogTime = HAL_GetTick() - AUDIO_SAMPLES_TIME(len);
     }
-    Msg->CommandType =COMMAND_SAVE_AUDIO;
-    /* first half */
-    ReadIndexBufferAudio=0;
+#endif /* STBOX1_LOG_CONTAINER */
+    WriteIndexBufferAudio += len;
     
-    /* Send te Message for writing out the 1/2 buffer */
-    if (tx_queue_send(&MessageQueue, &Msg, TX_NO_WAIT) != TX_SUCCESS)
-    {
-      STBOX1_PRINTF("Error Queue Max: %4d\r\n",MessageMaxSize);
-      Error_Handler(__FILE__,__LINE__);
+    if(WriteIndexBufferAudio == AUDIO_BLOCK_SAMPLES) {
+      AudioMsg->CommandType = COMMAND_SAVE_AUDIO;
+      AudioMsg->AudioBlock = AudioMsg - AudioRingBuffer;
+      
+      /* Send te Message for writing out the block */
+      MsgRing_Commit(&AudioRing);
+      tx_event_flags_set(&MessageEvents, MESSAGE_EVENT_AUDIO, TX_OR);
+      
+      /* If the ring is full the Writing thread has not yet saved the
+         oldest block: the next data are discarded (and counted) */
+      AudioMsg = (MessageData_T *) MsgRing_Reserve(&AudioRing);
+      WriteIndexBufferAudio = 0;
     }
-    MessagePushed++;
-    if((MessagePushed-MessageRemoved) > MessageMaxSize) {
-      MessageMaxSize = MessagePushed-MessageRemoved;
-    }
-  } else if (WriteIndexBufferAudio == 0) {
-    MessageData_T *Msg;
-    Msg = (MessageData_T *)SensorBufferWritingPointer;
-    SensorBufferWritingPointer+=sizeof(MessageData_T);
-    if(SensorBufferWritingPointer == SensorBufferEndPointer) {
-      SensorBufferWritingPointer = SensorBuffer;
-    }
-    Msg->CommandType =COMMAND_SAVE_AUDIO;
-    /* second half */
-    ReadIndexBufferAudio= AUDIO_BUFF_SIZE/2;
-    /* Send te Message for writing out the 1/2 buffer */
-    if (tx_queue_send(&MessageQueue, &Msg, TX_NO_WAIT) != TX_SUCCESS)
+  }
+  
+  if(AudioMsg == NULL) {
+    BSP_LED_Toggle(LED_RED);
+  }
+  
+  BSP_AUDIO_IN_SetBuffer(0 /*BSP_AUDIO_IN_INSTANCE*/, AudioProcess_NextBuffer());
+  
+  Cycles = DWT->CYCCNT - StartCycles;
+  AudioCallbackCycles += Cycles;
+  if(Cycles > AudioCallbackMaxCycles) {
+    AudioCallbackMaxCycles = Cycles;
+  }
+  AudioCallbacks++;
+}
+
+/**
+* @brief  Position where the BSP must write the next audio data
+* @param  None
+* @retval Pointer on the audio block or on the PCM buffer if the data must be discarded
+*/
+static uint8_t *AudioProcess_NextBuffer(void)
+{
+  if(AudioMsg == NULL) {
+    return (uint8_t *) OnBoard_PCM_Buffer;
+  }
+  
+  return (uint8_t *) (Audio_OUT_Buff[AudioMsg - AudioRingBuffer] + WriteIndexBufferAudio);
+}
+
+/**
+* @brief  Save one audio block directly from Audio_OUT_Buff
+*         (or compressed frame by frame if STBOX1_AUDIO_COMPRESSION is defined)
+* @param  Msg         message of the audio block.
+* @param  len         number of samples to save.
+* @retval None
+*/
+static void AudioProcess_SaveBlock(MessageData_T *Msg, uint32_t len)
+{
+  uint16_t *pBlock = Audio_OUT_Buff[Msg - AudioRingBuffer];
+  uint32_t StartTime;
+  UINT status;
+#ifdef STBOX1_AUDIO_COMPRESSION
+  uint32_t Saved = 0;
+#endif /* STBOX1_AUDIO_COMPRESSION */
+  
+  if(len == 0) {
+    return;
+  }
+  
+  StartTime = HAL_GetTick();
+  
+#ifdef STBOX1_AUDIO_COMPRESSION
+  while(len > 0) {
+    uint32_t Samples = (len > AUDIO_LAC_FRAME_SAMPLES) ? AUDIO_LAC_FRAME_SAMPLES : len;
+    uint32_t StartCycles = DWT->CYCCNT;
+    uint32_t Size;
+    
+    Size = AudioLac_EncodeFrame(&AudioEncoder, (int16_t *) pBlock, Samples, AudioLacFrame);
+    AudioEncoderCycles += DWT->CYCCNT - StartCycles;
+    
+#ifdef STBOX1_LOG_CONTAINER
+    /* One chunk for each compressed frame */
+    status = LogChunk_Write(LOG_STREAM_AUDIO, Msg->LogTime + AUDIO_SAMPLES_TIME(Saved),
+                            Samples, AudioLacFrame, Size);
+#else /* STBOX1_LOG_CONTAINER */
+    status = WriteBatch_Write(&AudioBatch, AudioLacFrame, Size);
+#endif /* STBOX1_LOG_CONTAINER */
+    
+    if (status != FX_SUCCESS)
     {
-      STBOX1_PRINTF("Error Queue Max: %4d\r\n",MessageMaxSize);
+      /* Error writing to a file, call error handler.  */
+      STBOX1_PRINTF("Error writing MicXXX.lac\r\n");
       Error_Handler(__FILE__,__LINE__);
     }
-    MessagePushed++;
-    if((MessagePushed-MessageRemoved) > MessageMaxSize) {
-      MessageMaxSize = MessagePushed-MessageRemoved;
-    }
+    
+    pBlock += Samples;
+    len -= Samples;
+    Saved += Samples;
   }
+#else /* STBOX1_AUDIO_COMPRESSION */
+#ifdef STBOX1_LOG_CONTAINER
+  /* One chunk for each audio block (one record for each sampling period) */
+  status = LogChunk_Write(LOG_STREAM_AUDIO, Msg->LogTime, len / AUDIO_IN_CHANNELS, pBlock, len * sizeof(uint16_t));
+#else /* STBOX1_LOG_CONTAINER */
+  status = WriteBatch_WriteDirect(&AudioBatch, pBlock, len * sizeof(uint16_t));
+#endif /* STBOX1_LOG_CONTAINER */
   
-  /* Control section */
-  if(ReadIndexBufferAudio==0) {
-    /* We need to read the First half */
-    if(WriteIndexBufferAudio<(AUDIO_BUFF_SIZE/2)) {
-      BSP_LED_Toggle(LED_RED);
-    }
-  } else if(ReadIndexBufferAudio==(AUDIO_BUFF_SIZE/2)){
-    /* We need to Read the Second half */
-    if(WriteIndexBufferAudio>(AUDIO_BUFF_SIZE/2)) {
-      BSP_LED_Toggle(LED_RED);
-    }
+  if (status != FX_SUCCESS)
+  {
+    /* Error writing to a file, call error handler.  */
+    STBOX1_PRINTF("Error writing MicXXX.csv\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+#endif /* STBOX1_AUDIO_COMPRESSION */
+  
+  StartTime = HAL_GetTick() - StartTime;
+  AudioSaveTime += StartTime;
+  if(StartTime > AudioSaveMaxTime) {
+    AudioSaveMaxTime = StartTime;
   }
+  AudioSaveBlocks++;
 }
 
+/**
+* @brief  Print the audio statistics: the SD has some headroom while
+*         the slowest save of one block is shorter than the block time.
+*         The callback load is the part of the CPU time taken by the audio
+*         callbacks (one for each PCM_AUDIO_IN_SAMPLES samples, 1 mS)
+* @param  None
+* @retval None
+*/
+static void AudioProcess_PrintSummary(void)
+{
+  ULONG Rate = (AUDIO_IN_SAMPLING_FREQUENCY * AUDIO_IN_CHANNELS * sizeof(uint16_t)) / 1024;
+  ULONG BlockTime = AUDIO_SAMPLES_TIME(AUDIO_BLOCK_SAMPLES);
+  ULONG RingSize = (AUDIO_RING_SIZE * AUDIO_BLOCK_SAMPLES * sizeof(uint16_t)) / 1024;
+  ULONG Average = 0;
+  ULONG Headroom = 0;
+  ULONG CallbackAverage = 0;
+  ULONG CallbackLoad = 0;
+  
+  if(AudioSaveBlocks != 0) {
+    Average = AudioSaveTime / AudioSaveBlocks;
+  }
+  
+  if(AudioCallbacks != 0) {
+    CallbackAverage = (ULONG) (AudioCallbackCycles / AudioCallbacks);
+    /* Per ten thousand of the cycles of one callback period */
+    CallbackLoad = (ULONG) ((AudioCallbackCycles * 10000U) / ((uint64_t) AudioCallbacks * (SystemCoreClock / 1000U)));
+  }
+  
+  if(AudioSaveMaxTime < BlockTime) {
+    Headroom = ((BlockTime - AudioSaveMaxTime) * 100) / BlockTime;
+  }
+  
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Audio summary:     |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Channels: %7ld  |\r\n",(ULONG)AUDIO_IN_CHANNELS);
+  STBOX1_PRINTF("| Rate: %6ld KB/S  |\r\n",Rate);
+  STBOX1_PRINTF("| Ring: %7ld KB   |\r\n",RingSize);
+  STBOX1_PRINTF("| Blocks: %9ld  |\r\n",AudioSaveBlocks);
+  STBOX1_PRINTF("| Block: %7ld mS  |\r\n",BlockTime);
+  STBOX1_PRINTF("| Avg: %7ld mS    |\r\n",Average);
+  STBOX1_PRINTF("| Max: %7ld mS    |\r\n",AudioSaveMaxTime);
+  STBOX1_PRINTF("| Headroom: %5ld %%  |\r\n",Headroom);
+  STBOX1_PRINTF("| Callbacks: %7ld |\r\n",AudioCallbacks);
+  STBOX1_PRINTF("| Cb Avg: %6ld cyc |\r\n",CallbackAverage);
+  STBOX1_PRINTF("| Cb Max: %6ld cyc |\r\n",AudioCallbackMaxCycles);
+  STBOX1_PRINTF("| Cb Load: %2ld.%02ld %%   |\r\n",CallbackLoad / 100, CallbackLoad % 100);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+
+#ifdef STBOX1_AUDIO_COMPRESSION
+/**
+* @brief  Print the audio compression statistics
+*         (the cycles are counted by the DWT enabled in tx_initialize_low_level)
+* @param  None
+* @retval None
+*/
+static void AudioCodec_PrintSummary(void)
+{
+  ULONG Ratio = 0;
+  ULONG Cycles = 0;
+  
+  if(AudioEncoder.Bytes != 0) {
+    Ratio = (ULONG) (((uint64_t) AudioEncoder.Samples * sizeof(uint16_t) * 100) / AudioEncoder.Bytes);
+  }
+  
+  if(AudioEncoder.Samples != 0) {
+    Cycles = (ULONG) (AudioEncoderCycles / AudioEncoder.Samples);
+  }
+  
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Audio codec:       |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Frames: %9ld  |\r\n",AudioEncoder.Frames);
+  STBOX1_PRINTF("| Verbatim: %7ld  |\r\n",AudioEncoder.VerbatimFrames);
+  STBOX1_PRINTF("| Ratio: %4ld.%02ld     |\r\n",Ratio / 100, Ratio % 100);
+  STBOX1_PRINTF("| Cycles/S: %7ld  |\r\n",Cycles);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+#endif /* STBOX1_AUDIO_COMPRESSION */
+
 /**
 * @brief  Initialize the wave header file
 * @param  pHeader: Header Buffer to be filled
@@ -825,10 +2176,11 @@ static void AudioProcess_SD_Recording(uint16_t *pInBuff, uint32_t len)
 static uint32_t WavProcess_HeaderInit(void)
 {
   uint16_t   BitPerSample=16;
-  uint32_t   ByteRate=AUDIO_IN_SAMPLING_FREQUENCY*(BitPerSample/8);
+  uint16_t   NumChannels=AUDIO_IN_CHANNELS;
+  uint32_t   ByteRate=AUDIO_IN_SAMPLING_FREQUENCY*NumChannels*(BitPerSample/8);
   
   uint32_t   SampleRate=AUDIO_IN_SAMPLING_FREQUENCY;
-  uint16_t   BlockAlign= BitPerSample/8;
+  uint16_t   BlockAlign= NumChannels*(BitPerSample/8);
   
   /* Write chunkID, must be 'RIFF'  ------------------------------------------*/
   pAudioHeader[0] = 'R';
@@ -866,8 +2218,8 @@ static uint32_t WavProcess_HeaderInit(void)
   pAudioHeader[20]  = 0x01;
   pAudioHeader[21]  = 0x00;
   
-  /* Write the number of channels, ie. 0x01 (Mono) ---------------------------*/
-  pAudioHeader[22]  = 1;
+  /* Write the number of channels, ie. 0x01 (Mono), 0x02 (Stereo) ------------*/
+  pAudioHeader[22]  = (uint8_t)NumChannels;
   pAudioHeader[23]  = 0x00;
   
   /* Write the Sample Rate in Hz ---------------------------------------------*/
@@ -891,18 +2243,32 @@ static uint32_t WavProcess_HeaderInit(void)
   pAudioHeader[34]  = BitPerSample;
   pAudioHeader[35]  = 0x00;
   
+  /* Write the padding chunk, must be 'JUNK' --------------------------------*/
+  /* It moves the audio data at the beginning of the second SD sector */
+  pAudioHeader[36]  = 'J';
+  pAudioHeader[37]  = 'U';
+  pAudioHeader[38]  = 'N';
+  pAudioHeader[39]  = 'K';
+  
+  /* Write the length of the 'JUNK' data -------------------------------------*/
+  pAudioHeader[40]  = (uint8_t)((WAV_HEADER_SIZE - 52) & 0xFF);
+  pAudioHeader[41]  = (uint8_t)(((WAV_HEADER_SIZE - 52) >> 8) & 0xFF);
+  pAudioHeader[42]  = 0x00;
+  pAudioHeader[43]  = 0x00;
+  memset(pAudioHeader + 44, 0, WAV_HEADER_SIZE - 52);
+  
   /* Write the Data chunk, must be 'data' ------------------------------------*/
-  pAudioHeader[36]  = 'd';
-  pAudioHeader[37]  = 'a';
-  pAudioHeader[38]  = 't';
-  pAudioHeader[39]  = 'a';
+  pAudioHeader[WAV_HEADER_SIZE - 8]  = 'd';
+  pAudioHeader[WAV_HEADER_SIZE - 7]  = 'a';
+  pAudioHeader[WAV_HEADER_SIZE - 6]  = 't';
+  pAudioHeader[WAV_HEADER_SIZE - 5]  = 'a';
   
   /* Write the number of sample data -----------------------------------------*/
   /* This variable will be written back at the end of the recording operation */
-  pAudioHeader[40]  = 0x00;
-  pAudioHeader[41]  = 0x4C;
-  pAudioHeader[42]  = 0x1D;
-  pAudioHeader[43]  = 0x00;
+  pAudioHeader[WAV_HEADER_SIZE - 4]  = 0x00;
+  pAudioHeader[WAV_HEADER_SIZE - 3]  = 0x4C;
+  pAudioHeader[WAV_HEADER_SIZE - 2]  = 0x1D;
+  pAudioHeader[WAV_HEADER_SIZE - 1]  = 0x00;
   
   /* Return 0 if all operations are OK */
   return 0;
@@ -925,14 +2291,2102 @@ static uint32_t WavProcess_HeaderUpdate(uint32_t len)
   pAudioHeader[7] = (uint8_t)(len >> 24);
   /* Write the number of sample data -----------------------------------------*/
   /* This variable will be written back at the end of the recording operation */
-  len -=44;
-  pAudioHeader[40] = (uint8_t)(len);
-  pAudioHeader[41] = (uint8_t)(len >> 8);
-  pAudioHeader[42] = (uint8_t)(len >> 16);
-  pAudioHeader[43] = (uint8_t)(len >> 24);
+  len -=WAV_HEADER_SIZE;
+  pAudioHeader[WAV_HEADER_SIZE - 4] = (uint8_t)(len);
+  pAudioHeader[WAV_HEADER_SIZE - 3] = (uint8_t)(len >> 8);
+  pAudioHeader[WAV_HEADER_SIZE - 2] = (uint8_t)(len >> 16);
+  pAudioHeader[WAV_HEADER_SIZE - 1] = (uint8_t)(len >> 24);
   /* Return 0 if all operations are OK */
   return 0;
 }
 
+/**
+* @brief  Write the header at the beginning of the sensors file
+*         (the container header and the first annotation for LogXXX.stb)
+* @param  None
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT SensorsLog_WriteHeader(void)
+{
+#if defined(STBOX1_LOG_CONTAINER)
+  return ContainerLog_Start();
+#elif defined(STBOX1_SENSORS_LOG_BINARY)
+  /* Write the binary header and the channels descriptors */
+  return WriteBatch_Write(&SensorsBatch, &SensorsLogHeader, sizeof(SensorsLogHeader));
+#else /* STBOX1_LOG_CONTAINER */
+  CHAR header[]= SENSORS_TIME_HEADER "AccX [mg],AccY [mg],AccZ [mg],GyroX [mdps],GyroY [mdps],GyroZ [mdps],MagX [mgauss],MagY [mgauss],MagZ [mgauss],P [mB],T ['C]\r\n";
+  
+  /* Write a string to the test file.  */
+  return WriteBatch_Write(&SensorsBatch, header, sizeof(header)-1);
+#endif /* STBOX1_LOG_CONTAINER */
+}
+
+/**
+* @brief  Save one sensors message on the log
+* @param  Msg: Message with the sensors values
+* @retval None
+*/
+static void SensorsLog_Save(MessageData_T *Msg)
+{
+  UINT status;
+  
+#if defined(STBOX1_LOG_CONTAINER)
+  /* Add the records to the sensors chunks */
+  status =  ContainerLog_SaveSensors(Msg);
+#elif defined(STBOX1_SENSORS_LOG_BINARY)
+  SensorsLogRecord_T Record;
+  Record.MsgTime = Msg->MsgTime;
+  Record.acc[0]  = Msg->acc.x;
+  Record.acc[1]  = Msg->acc.y;
+  Record.acc[2]  = Msg->acc.z;
+  Record.gyro[0] = Msg->gyro.x;
+  Record.gyro[1] = Msg->gyro.y;
+  Record.gyro[2] = Msg->gyro.z;
+  Record.mag[0]  = Msg->mag.x;
+  Record.mag[1]  = Msg->mag.y;
+  Record.mag[2]  = Msg->mag.z;
+  Record.pressure = Msg->pressure;
+  Record.temperature = Msg->temperature;
+  
+  /* Write the binary record to the test file.  */
+  status =  WriteBatch_Write(&SensorsBatch, &Record, sizeof(Record));
+#else /* STBOX1_LOG_CONTAINER */
+  CHAR data_s[256];
+  INT size;
+  size = sprintf(data_s, "%ld, %d, %d, %d, %d, %d, %d, %d, %d, %d, %5.2f, %5.2f\r\n",
+                 Msg->MsgTime,
+                 Msg->acc.x , Msg->acc.y , Msg->acc.z ,
+                 Msg->gyro.x, Msg->gyro.y, Msg->gyro.z,
+                 Msg->mag.x , Msg->mag.y , Msg->mag.z ,
+                 Msg->pressure, Msg->temperature);
+  
+  /* Write a string to the test file.  */
+  status =  WriteBatch_Write(&SensorsBatch, data_s, size);
+#endif /* STBOX1_LOG_CONTAINER */
+  
+  /* Check the file write status.  */
+  if (status != FX_SUCCESS)
+  {
+    /* Error writing to a file, call error handler.  */
+    STBOX1_PRINTF("Error writing SensXXX.csv\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+  SensorsRecordsWritten++;
+}
+
+#ifndef STBOX1_LOG_CONTAINER
+/**
+* @brief  Write the header at the beginning of the audio file
+*         (updated when the file is closed)
+* @param  None
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT AudioLog_WriteHeader(void)
+{
+#ifdef STBOX1_AUDIO_COMPRESSION
+  /* Initialize the compressed audio file header */
+  AudioLac_HeaderInit(pAudioHeader, AUDIO_IN_SAMPLING_FREQUENCY);
+  
+  return WriteBatch_Write(&AudioBatch, pAudioHeader, AUDIO_HEADER_SIZE);
+#else /* STBOX1_AUDIO_COMPRESSION */
+  /* Initialize the Wav Header file */
+  WavProcess_HeaderInit();
+  
+  return WriteBatch_WriteDirect(&AudioBatch, pAudioHeader, AUDIO_HEADER_SIZE);
+#endif /* STBOX1_AUDIO_COMPRESSION */
+}
+#endif /* STBOX1_LOG_CONTAINER */
+
+/**
+* @brief  Start one write batching stage for a file just opened
+* @param  Batch: Pointer to the write batching stage
+* @param  File: Pointer to the FileX file
+* @retval None
+*/
+static void WriteBatch_Init(WriteBatch_T *Batch, FX_FILE *File)
+{
+  WriteBatch_SetFile(Batch, File);
+  
+  Batch->WriteCalls = 0;
+  Batch->WriteBytes = 0;
+  Batch->WriteTime = 0;
+  Batch->WriteMaxTime = 0;
+  memset(Batch->Latency, 0, sizeof(Batch->Latency));
+}
+
+/**
+* @brief  Move one write batching stage (already flushed) to another file
+*         keeping its statistics
+* @param  Batch: Pointer to the write batching stage
+* @param  File: Pointer to the FileX file
+* @retval None
+*/
+static void WriteBatch_SetFile(WriteBatch_T *Batch, FX_FILE *File)
+{
+  FX_MEDIA *Media = File->fx_file_media_ptr;
+  ULONG ClusterSize = ((ULONG)Media->fx_media_sectors_per_cluster) * Media->fx_media_bytes_per_sector;
+  
+  /* Use one whole number of clusters, if possible, otherwise one
+     cluster's fraction (all the sizes are power of two) */
+  if(ClusterSize <= STBOX1_SD_WRITE_BATCH_SIZE) {
+    Batch->Size = STBOX1_SD_WRITE_BATCH_SIZE - (STBOX1_SD_WRITE_BATCH_SIZE % ClusterSize);
+  } else {
+    Batch->Size = STBOX1_SD_WRITE_BATCH_SIZE;
+  }
+  
+  Batch->File = File;
+  Batch->Index = 0;
+  Batch->Offset = File->fx_file_current_file_offset;
+  Batch->Limit = Batch->Size - (ULONG)(Batch->Offset % Batch->Size);
+  Batch->FirstTime = 0;
+}
+
+/**
+* @brief  Write one buffer to the file updating the write statistics
+*         (the cycles are counted by the DWT enabled in tx_initialize_low_level)
+* @param  Batch: Pointer to the write batching stage
+* @param  Data: Pointer to the data
+* @param  Size: Number of bytes
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT WriteBatch_FileWrite(WriteBatch_T *Batch, VOID *Data, ULONG Size)
+{
+  static const ULONG Limits[WRITE_BATCH_LATENCY_BINS - 1] = WRITE_BATCH_LATENCY_LIMITS;
+  UINT status;
+  uint32_t StartCycles = DWT->CYCCNT;
+  uint32_t WriteTime;
+  int Bin;
+  
+#ifdef STBOX1_LOG_RAW
+  /* The LogXXX.stb byte stream goes on the blocks of the raw log area */
+  status = LogRaw_Write(&RawLog, Data, Size);
+#else /* STBOX1_LOG_RAW */
+  status = fx_file_write(Batch->File, Data, Size);
+#endif /* STBOX1_LOG_RAW */
+  
+  WriteTime = (DWT->CYCCNT - StartCycles) / (SystemCoreClock / 1000000U);
+  Batch->WriteCalls++;
+  Batch->WriteBytes += Size;
+  Batch->WriteTime += WriteTime;
+  if(WriteTime > Batch->WriteMaxTime) {
+    Batch->WriteMaxTime = WriteTime;
+  }
+  for(Bin = 0; Bin < (WRITE_BATCH_LATENCY_BINS - 1); Bin++) {
+    if(WriteTime < Limits[Bin]) {
+      break;
+    }
+  }
+  Batch->Latency[Bin]++;
+  
+  return status;
+}
+
+/**
+* @brief  Write out the data present on the buffer
+* @param  Batch: Pointer to the write batching stage
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT WriteBatch_Flush(WriteBatch_T *Batch)
+{
+  ULONG Size = Batch->Index;
+  
+  if(Size == 0) {
+    return FX_SUCCESS;
+  }
+  
+  /* The buffer is free again when fx_file_write returns */
+  Batch->Index = 0;
+  Batch->Offset += Size;
+  /* After a partial buffer, fill only up to the next aligned offset */
+  Batch->Limit = Batch->Size - (ULONG)(Batch->Offset % Batch->Size);
+  
+  return WriteBatch_FileWrite(Batch, Batch->Buffer, Size);
+}
+
+/**
+* @brief  Add data to the write batching stage
+* @param  Batch: Pointer to the write batching stage
+* @param  Data: Pointer to the data
+* @param  Size: Number of bytes
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT WriteBatch_Write(WriteBatch_T *Batch, VOID *Data, ULONG Size)
+{
+  UINT status = FX_SUCCESS;
+  UCHAR *Source = (UCHAR *) Data;
+  ULONG Len;
+  
+  while((Size > 0) && (status == FX_SUCCESS)) {
+    if((Batch->Index == 0) && (Batch->Limit == Batch->Size) && (Size >= Batch->Size)) {
+      /* Aligned file offset and at least one full buffer:
+         write them directly without copying */
+      Len = Size - (Size % Batch->Size);
+      status = WriteBatch_FileWrite(Batch, Source, Len);
+      Batch->Offset += Len;
+    } else {
+      Len = Batch->Limit - Batch->Index;
+      if(Len > Size) {
+        Len = Size;
+      }
+      
+      if(Batch->Index == 0) {
+        Batch->FirstTime = HAL_GetTick();
+      }
+      
+      memcpy(Batch->Buffer + Batch->Index, Source, Len);
+      Batch->Index += Len;
+      
+      if(Batch->Index == Batch->Limit) {
+        status = WriteBatch_Flush(Batch);
+      }
+    }
+    Source += Len;
+    Size -= Len;
+  }
+  
+  return status;
+}
+
+/**
+* @brief  Write data directly to the file without passing through the buffer
+*         (32-Bytes aligned data for avoiding the driver's scratch buffer)
+* @param  Batch: Pointer to the write batching stage
+* @param  Data: Pointer to the data
+* @param  Size: Number of bytes
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT WriteBatch_WriteDirect(WriteBatch_T *Batch, VOID *Data, ULONG Size)
+{
+  UINT status;
+  
+  /* Keep the file order with the data already present on the buffer */
+  status = WriteBatch_Flush(Batch);
+  
+  if(status == FX_SUCCESS) {
+    status = WriteBatch_FileWrite(Batch, Data, Size);
+    Batch->Offset += Size;
+    Batch->Limit = Batch->Size - (ULONG)(Batch->Offset % Batch->Size);
+  }
+  
+  return status;
+}
+
+/**
+* @brief  Write out the buffer if its data are waiting for too long
+* @param  Batch: Pointer to the write batching stage
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT WriteBatch_CheckDeadline(WriteBatch_T *Batch)
+{
+  if((Batch->Index != 0) && ((HAL_GetTick() - Batch->FirstTime) >= STBOX1_SD_WRITE_BATCH_DEADLINE)) {
+    return WriteBatch_Flush(Batch);
+  }
+  
+  return FX_SUCCESS;
+}
+
+/**
+* @brief  Latency percentile of the writes from the histogram
+* @param  Batch: Pointer to the write batching stage
+* @param  Permille: Percentile (per thousand of the writes)
+* @retval Upper limit in uS of the bin with the percentile (the max latency
+*         for the last bin or if it's lower)
+*/
+static ULONG WriteBatch_Percentile(WriteBatch_T *Batch, ULONG Permille)
+{
+  static const ULONG Limits[WRITE_BATCH_LATENCY_BINS - 1] = WRITE_BATCH_LATENCY_LIMITS;
+  ULONG64 Target = ((ULONG64)Batch->WriteCalls * Permille + 999U) / 1000U;
+  ULONG64 Count = 0;
+  int Bin;
+  
+  for(Bin = 0; Bin < (WRITE_BATCH_LATENCY_BINS - 1); Bin++) {
+    Count += Batch->Latency[Bin];
+    if(Count >= Target) {
+      return (Limits[Bin] < Batch->WriteMaxTime) ? Limits[Bin] : Batch->WriteMaxTime;
+    }
+  }
+  
+  return Batch->WriteMaxTime;
+}
+
+/**
+* @brief  Print the write batching stage statistics
+* @param  Name: Summary title
+* @param  Batch: Pointer to the write batching stage
+* @retval None
+*/
+static void WriteBatch_PrintSummary(CHAR *Name, WriteBatch_T *Batch)
+{
+  static const ULONG Limits[WRITE_BATCH_LATENCY_BINS - 1] = WRITE_BATCH_LATENCY_LIMITS;
+  int Bin;
+  
+  STBOX1_PRINTF("| %-18s |\r\n", Name);
+  STBOX1_PRINTF("|--------------------|\r\n");
+  if(Batch->Buffer != NULL) {
+    STBOX1_PRINTF("| Buffer: %7ld B  |\r\n", Batch->Size);
+  }
+  STBOX1_PRINTF("| Calls: %10ld  |\r\n", Batch->WriteCalls);
+  if(Batch->WriteCalls != 0) {
+    STBOX1_PRINTF("| Bytes/Call: %5ld  |\r\n", (ULONG)(Batch->WriteBytes / Batch->WriteCalls));
+    STBOX1_PRINTF("| Avg: %7ld uS    |\r\n", (ULONG)(Batch->WriteTime / Batch->WriteCalls));
+    STBOX1_PRINTF("| P50: %7ld uS    |\r\n", WriteBatch_Percentile(Batch, 500));
+    STBOX1_PRINTF("| P90: %7ld uS    |\r\n", WriteBatch_Percentile(Batch, 900));
+    STBOX1_PRINTF("| P99: %7ld uS    |\r\n", WriteBatch_Percentile(Batch, 990));
+    STBOX1_PRINTF("| P99.9: %5ld uS    |\r\n", WriteBatch_Percentile(Batch, 999));
+    STBOX1_PRINTF("| Max: %7ld uS    |\r\n", Batch->WriteMaxTime);
+    for(Bin = 0; Bin < WRITE_BATCH_LATENCY_BINS - 1; Bin++) {
+      STBOX1_PRINTF("| <%6ld uS: %5ld  |\r\n", Limits[Bin], Batch->Latency[Bin]);
+    }
+    STBOX1_PRINTF("| >=%6ld uS: %4ld  |\r\n", Limits[Bin - 1], Batch->Latency[Bin]);
+  }
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+
+/**
+* @brief  Print the FileX media cache statistics of the last log
+* @param  Media: FileX media
+* @retval None
+*/
+static void MediaCache_PrintSummary(FX_MEDIA *Media)
+{
+  STBOX1_PRINTF("| Media cache:       |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Sectors: %8ld  |\r\n", Media->fx_media_sector_cache_size);
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+  STBOX1_PRINTF("| Sector Hit: %5ld  |\r\n", Media->fx_media_logical_sector_cache_read_hits);
+  STBOX1_PRINTF("| Sector Miss: %4ld  |\r\n", Media->fx_media_logical_sector_cache_read_misses);
+  STBOX1_PRINTF("| FAT Hit: %8ld  |\r\n",
+                Media->fx_media_fat_entry_cache_read_hits + Media->fx_media_fat_entry_cache_write_hits);
+  STBOX1_PRINTF("| FAT Miss: %7ld  |\r\n",
+                Media->fx_media_fat_entry_cache_read_misses + Media->fx_media_fat_entry_cache_write_misses);
+  STBOX1_PRINTF("| FAT Flushes: %4ld  |\r\n", Media->fx_media_fat_cache_flushes);
+  STBOX1_PRINTF("| FAT Writes: %5ld  |\r\n", Media->fx_media_fat_sector_writes);
+  STBOX1_PRINTF("| SD Reads: %7ld  |\r\n", Media->fx_media_driver_read_requests);
+  STBOX1_PRINTF("| SD Writes: %6ld  |\r\n", Media->fx_media_driver_write_requests);
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+
+/**
+* @brief  Print the SD driver requests of the last log with one unaligned buffer
+*         (moved through the scratch buffer) and the time waiting for the card
+*         ready before each request
+* @param  None
+* @retval None
+*/
+static void SdDriver_PrintSummary(void)
+{
+  FX_STM32_SD_DRIVER_STATS *Stats = &fx_stm32_sd_driver_stats;
+  ULONG CyclesUs = SystemCoreClock / 1000000U;
+
+  STBOX1_PRINTF("| SD driver:         |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Requests: %7ld  |\r\n", Stats->Requests);
+  STBOX1_PRINTF("| Unaligned: %6ld  |\r\n", Stats->UnalignedRequests);
+  if(Stats->UnalignedRequests != 0) {
+    STBOX1_PRINTF("| Sectors: %8ld  |\r\n", Stats->UnalignedSectors);
+    STBOX1_PRINTF("| Scratch: %8ld  |\r\n", Stats->ScratchTransfers);
+  }
+  if(Stats->ReadyChecks != 0) {
+    STBOX1_PRINTF("| Rdy Avg: %6ld uS |\r\n", (ULONG)(Stats->ReadyCycles / Stats->ReadyChecks / CyclesUs));
+    STBOX1_PRINTF("| Rdy Max: %6ld uS |\r\n", Stats->ReadyMax / CyclesUs);
+  }
+#ifdef STBOX1_SD_READ_AHEAD
+  STBOX1_PRINTF("| RA Fills: %7ld  |\r\n", Stats->ReadAheadFills);
+  STBOX1_PRINTF("| RA Hits: %8ld  |\r\n", Stats->ReadAheadHits);
+#endif /* STBOX1_SD_READ_AHEAD */
+#ifdef STBOX1_SD_CARD_EVENTS
+  STBOX1_PRINTF("| Card Busy: %6ld  |\r\n", fx_stm32_sd_card_stats.Busy);
+  STBOX1_PRINTF("| Busy IRQ: %7ld  |\r\n", fx_stm32_sd_card_stats.Events);
+  STBOX1_PRINTF("| Status: %9ld  |\r\n", fx_stm32_sd_card_stats.Polls);
+  STBOX1_PRINTF("| Timeouts: %7ld  |\r\n", fx_stm32_sd_card_stats.Timeouts);
+#endif /* STBOX1_SD_CARD_EVENTS */
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+
+#ifdef STBOX1_SD_WRITE_QUEUE
+/**
+* @brief  Print the statistics of the SD driver write queue of the last log
+*         (the cycles are counted by the DWT enabled in tx_initialize_low_level)
+* @param  None
+* @retval None
+*/
+static void SdQueue_PrintSummary(void)
+{
+  FX_STM32_SD_QUEUE_STATS *Stats = &fx_stm32_sd_queue_stats;
+  ULONG CyclesUs = SystemCoreClock / 1000000U;
+
+  STBOX1_PRINTF("| SD write queue:    |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Slots: %2ld x %3ld KB |\r\n", (ULONG)FX_STM32_SD_QUEUE_SLOTS,
+                (ULONG)(FX_STM32_SD_QUEUE_SLOT_SIZE / 1024));
+  STBOX1_PRINTF("| Writes: %9ld  |\r\n", Stats->Writes);
+  STBOX1_PRINTF("| Transfers: %6ld  |\r\n", Stats->Transfers);
+  if(Stats->Transfers != 0) {
+    STBOX1_PRINTF("| Avg Depth: %4ld.%02ld |\r\n", (ULONG)(Stats->DepthSum / Stats->Transfers),
+                  (ULONG)(((Stats->DepthSum % Stats->Transfers) * 100U) / Stats->Transfers));
+    STBOX1_PRINTF("| Latency: %6ld uS |\r\n", (ULONG)(Stats->LatencySum / Stats->Transfers / CyclesUs));
+    STBOX1_PRINTF("| Lat Max: %6ld uS |\r\n", Stats->LatencyMax / CyclesUs);
+  }
+  STBOX1_PRINTF("| Max Depth: %6ld  |\r\n", Stats->MaxDepth);
+  STBOX1_PRINTF("| Full: %11ld  |\r\n", Stats->FullWaits);
+  STBOX1_PRINTF("| Drains: %9ld  |\r\n", Stats->Drains);
+  STBOX1_PRINTF("| Wait: %8ld mS  |\r\n", (ULONG)(Stats->WaitCycles / CyclesUs / 1000U));
+  STBOX1_PRINTF("| Errors: %9ld  |\r\n", Stats->Errors);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+#endif /* STBOX1_SD_WRITE_QUEUE */
+
+#ifdef STBOX1_FX_WRITE_BEHIND
+/**
+* @brief  Print the statistics of the write-behind layer of the last log
+*         (one tick resolution for the times)
+* @param  None
+* @retval None
+*/
+static void WriteBehind_PrintSummary(void)
+{
+  static const ULONG Limits[LOG_WRITE_BEHIND_LATENCY_BINS - 1] = LOG_WRITE_BEHIND_LATENCY_LIMITS;
+  LogWriteBehindStats_T *Stats = &LogWriteBehindStats;
+  int Bin;
+
+  STBOX1_PRINTF("| Write-behind:      |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Queue: %7ld KB  |\r\n", (ULONG)STBOX1_FX_WRITE_BEHIND_SIZE);
+  STBOX1_PRINTF("| Extent: %6ld KB  |\r\n", (ULONG)STBOX1_FX_WRITE_BEHIND_EXTENT_SIZE);
+  STBOX1_PRINTF("| Writes: %9ld  |\r\n", Stats->Writes);
+  STBOX1_PRINTF("| Coalesced: %6ld  |\r\n", Stats->Coalesced);
+  STBOX1_PRINTF("| Extents: %8ld  |\r\n", Stats->Extents);
+  STBOX1_PRINTF("| Deadline: %7ld  |\r\n", Stats->DeadlineFlushes);
+  STBOX1_PRINTF("| Max Queue: %4ld KB |\r\n", Stats->MaxBytes / 1024);
+  STBOX1_PRINTF("| Max Extents: %4ld  |\r\n", Stats->MaxExtents);
+  STBOX1_PRINTF("| Full: %11ld  |\r\n", Stats->FullWaits);
+  STBOX1_PRINTF("| Wait Max: %5ld mS |\r\n", Stats->WaitMax / 1000U);
+  STBOX1_PRINTF("| Drains: %9ld  |\r\n", Stats->Drains);
+  STBOX1_PRINTF("| Lat Max: %6ld mS |\r\n", Stats->LatencyMax / 1000U);
+  for(Bin = 0; Bin < LOG_WRITE_BEHIND_LATENCY_BINS - 1; Bin++) {
+    STBOX1_PRINTF("| <%4ld mS: %7ld  |\r\n", Limits[Bin], Stats->Latency[Bin]);
+  }
+  STBOX1_PRINTF("| >=%4ld mS: %6ld  |\r\n", Limits[Bin - 1], Stats->Latency[Bin]);
+  STBOX1_PRINTF("| Errors: %9ld  |\r\n", Stats->Errors);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+#endif /* STBOX1_FX_WRITE_BEHIND */
+
+#ifdef STBOX1_THREAD_PROFILER
+/**
+* @brief  Print one status of the profiler (called by its thread)
+* @param  Json: Loads and stack high-water marks of the threads, queues high-water marks
+* @retval None
+*/
+static VOID ThreadProfiler_Print(const CHAR *Json)
+{
+  STBOX1_PRINTF("%s\r\n", Json);
+}
+#endif /* STBOX1_THREAD_PROFILER */
+
+#ifdef STBOX1_SD_PREALLOCATION
+/**
+* @brief  Reserve contiguous clusters at the end of one log file.
+*         If there is not one contiguous area big enough, it reserves the
+*         biggest one available
+* @param  File: FileX file
+* @param  Size: Bytes to reserve
+* @retval None
+*/
+static void LogFile_Preallocate(FX_FILE *File, ULONG64 Size)
+{
+  ULONG64 Allocated = Size;
+  UINT status;
+  
+  status = fx_file_extended_allocate(File, Size);
+  
+  if (status == FX_NO_MORE_SPACE)
+  {
+    status = fx_file_extended_best_effort_allocate(File, Size, &Allocated);
+  }
+  
+  if (status == FX_SUCCESS)
+  {
+    STBOX1_PRINTF("Reserved %ld KB\r\n", (ULONG)(Allocated >> 10));
+  } else {
+    /* The file will grow cluster by cluster */
+    STBOX1_PRINTF("Error reserving the file clusters (0x%x)\r\n", status);
+  }
+}
+
+/**
+* @brief  Release the reserved clusters after the end of one log file.
+*         The file size is not used because the fault tolerant module
+*         adds the reserved bytes to it
+* @param  File: FileX file
+* @param  Size: Bytes written on the file
+* @retval FileX status
+*/
+static UINT LogFile_Release(FX_FILE *File, ULONG64 Size)
+{
+  return fx_file_extended_truncate_release(File, Size);
+}
+#endif /* STBOX1_SD_PREALLOCATION */
+
+#ifdef STBOX1_LOG_ROTATION
+/**
+* @brief  Name of one segment: the segment number is added before the extension
+* @param  Name: Segment name to be filled
+* @param  Format: File name format (SENSORS_FILE_NAME or AUDIO_FILE_NAME)
+* @param  Session: Session number
+* @param  Segment: Segment number
+* @retval None
+*/
+static void LogRotation_FileName(CHAR *Name, const CHAR *Format, ULONG Session, ULONG Segment)
+{
+  LOG_SESSION_NAME(Name, Format, (int)Session);
+  sprintf(strrchr(Name, '.'), "_%03ld%s", Segment, strrchr(Format, '.'));
+}
+
+/**
+* @brief  Start the segments of one log file just opened (the first segment)
+*         and open the next one in background
+* @param  Rotation: Segments of the log file
+* @param  Session: Session number of the file name
+* @retval None
+*/
+static void LogRotation_Start(LogRotation_T *Rotation, ULONG Session)
+{
+  Rotation->Current = 0;
+  Rotation->Session = Session;
+  Rotation->Segment = 0;
+  Rotation->StartTime = HAL_GetTick();
+  Rotation->HeaderSize = 0;
+  Rotation->Closing = 0;
+  Rotation->NextReady = 0;
+  
+  Rotation->ClosedBytes = 0;
+  Rotation->Late = 0;
+  Rotation->SwitchMaxTime = 0;
+  Rotation->CloseMaxTime = 0;
+  Rotation->OpenMaxTime = 0;
+  
+#ifdef STBOX1_LOG_CHECKPOINT
+  CheckpointLog_SetSegments(Rotation);
+#endif /* STBOX1_LOG_CHECKPOINT */
+  tx_event_flags_set(&ClosingEvents, Rotation->Event, TX_OR);
+}
+
+/**
+* @brief  Switch to the next segment when the current one reaches
+*         STBOX1_LOG_ROTATION_SIZE MB or STBOX1_LOG_ROTATION_TIME seconds.
+*         The switch is delayed if the next segment is not yet opened
+* @param  Rotation: Segments of the log file
+* @param  Rotate: Function that completes the segment and switches to the next one
+* @retval None
+*/
+static void LogRotation_Check(LogRotation_T *Rotation, UINT (*Rotate)(void))
+{
+  ULONG64 Size = Rotation->Batch->Offset + Rotation->Batch->Index;
+  ULONG StartTime;
+  ULONG SwitchTime;
+  
+  if((Size < (((ULONG64)STBOX1_LOG_ROTATION_SIZE) << 20)) &&
+     ((STBOX1_LOG_ROTATION_TIME == 0) ||
+      ((HAL_GetTick() - Rotation->StartTime) < (STBOX1_LOG_ROTATION_TIME * 1000U)))) {
+    return;
+  }
+  
+  if(!Rotation->NextReady) {
+    /* The Closing thread is still working: retry after the next message */
+    Rotation->Late++;
+    return;
+  }
+  
+#ifdef STBOX1_LOG_CHECKPOINT
+  if(CheckpointLog.Saving) {
+    /* The checkpoint with the new segment names is handed off with the switch */
+    Rotation->Late++;
+    return;
+  }
+#endif /* STBOX1_LOG_CHECKPOINT */
+  
+  StartTime = HAL_GetTick();
+  
+  if (Rotate() != FX_SUCCESS)
+  {
+    /* Error writing to a file, call error handler.  */
+    STBOX1_PRINTF("Error switching to the next segment\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+#ifdef STBOX1_LOG_CHECKPOINT
+  /* The Closing thread creates the following segment only after
+     one checkpoint with the new segment names */
+  CheckpointLog_SetSegments(Rotation);
+  CheckpointLog_Save();
+#endif /* STBOX1_LOG_CHECKPOINT */
+  tx_event_flags_set(&ClosingEvents, Rotation->Event, TX_OR);
+  
+  SwitchTime = HAL_GetTick() - StartTime;
+  if(SwitchTime > Rotation->SwitchMaxTime) {
+    Rotation->SwitchMaxTime = SwitchTime;
+  }
+}
+
+/**
+* @brief  Continue the log on the next segment (already opened). The Closing
+*         thread, woken up by LogRotation_Check, completes the current one
+*         and opens the following one
+* @param  Rotation: Segments of the log file
+* @param  Header: Updated header of the current segment (NULL if none)
+* @param  HeaderSize: Bytes of the header
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT LogRotation_Switch(LogRotation_T *Rotation, UCHAR *Header, ULONG HeaderSize)
+{
+  UINT status;
+  
+  /* Write out the end of the current segment */
+  status = WriteBatch_Flush(Rotation->Batch);
+  Rotation->ClosingSize = Rotation->Batch->Offset;
+  
+  /* The header is written by the Closing thread */
+  Rotation->HeaderSize = HeaderSize;
+  if(HeaderSize != 0) {
+    memcpy(Rotation->Header, Header, HeaderSize);
+  }
+  
+  Rotation->Current ^= 1;
+  Rotation->Segment++;
+  Rotation->StartTime = HAL_GetTick();
+  WriteBatch_SetFile(Rotation->Batch, Rotation->Files[Rotation->Current]);
+  
+  Rotation->NextReady = 0;
+  Rotation->Closing = 1;
+  
+  return status;
+}
+
+/**
+* @brief  Work of the Closing thread for one log file: update the header and
+*         close the previous segment, then open the next one.
+*         Both use the FX_FILE not used by the Writing thread
+* @param  Rotation: Segments of the log file
+* @retval None
+*/
+static void LogRotation_Process(LogRotation_T *Rotation)
+{
+  FX_FILE *File = Rotation->Files[Rotation->Current ^ 1];
+  CHAR Name[30];
+  ULONG StartTime;
+  ULONG Time;
+  UINT status;
+  
+  if(Rotation->Closing) {
+    StartTime = HAL_GetTick();
+    
+    if(Rotation->HeaderSize != 0) {
+      /* Write the updated header at the file beginning */
+      status = fx_file_seek(File, 0);
+      if(status == FX_SUCCESS) {
+        status = fx_file_write(File, Rotation->Header, Rotation->HeaderSize);
+      }
+      if (status != FX_SUCCESS)
+      {
+        /* Error writing the file, call error handler.  */
+        STBOX1_PRINTF("Error writing the segment header\r\n");
+        Error_Handler(__FILE__,__LINE__);
+      }
+    }
+    
+    Rotation->ClosedBytes += Rotation->ClosingSize;
+    
+#ifdef STBOX1_SD_PREALLOCATION
+    /* Release the reserved clusters not used */
+    status = LogFile_Release(File, Rotation->ClosingSize);
+    if (status != FX_SUCCESS)
+    {
+      /* Error releasing the clusters, call error handler.  */
+      STBOX1_PRINTF("Error releasing the segment clusters\r\n");
+      Error_Handler(__FILE__,__LINE__);
+    }
+#endif /* STBOX1_SD_PREALLOCATION */
+    
+    status = fx_file_close(File);
+    
+    /* Write out the directory entry and the FAT sectors still on the media cache */
+    if(status == FX_SUCCESS) {
+      status = fx_media_flush(&sdio_disk);
+    }
+    
+    if (status != FX_SUCCESS)
+    {
+      /* Error closing the file, call error handler.  */
+      STBOX1_PRINTF("Error closing the segment\r\n");
+      Error_Handler(__FILE__,__LINE__);
+    }
+    
+    Time = HAL_GetTick() - StartTime;
+    if(Time > Rotation->CloseMaxTime) {
+      Rotation->CloseMaxTime = Time;
+    }
+    Rotation->Closing = 0;
+  }
+  
+  if(!Rotation->NextReady) {
+    StartTime = HAL_GetTick();
+    
+    LogRotation_FileName(Name, Rotation->Format, Rotation->Session, Rotation->Segment + 1);
+    
+    status = fx_file_create(&sdio_disk, Name);
+    
+    if((status == FX_SUCCESS) || (status == FX_ALREADY_CREATED)) {
+      status = fx_file_open(&sdio_disk, File, Name, FX_OPEN_FOR_WRITE);
+    }
+    
+    /* One file left by an older log is overwritten */
+    if((status == FX_SUCCESS) && (File->fx_file_current_file_size != 0)) {
+      status = fx_file_extended_truncate_release(File, 0);
+    }
+    
+    if (status != FX_SUCCESS)
+    {
+      /* Error opening file, call error handler.  */
+      STBOX1_PRINTF("Error opening %s\r\n", Name);
+      Error_Handler(__FILE__,__LINE__);
+    }
+    
+#ifdef STBOX1_SD_PREALLOCATION
+    /* Reserve the clusters for the whole segment */
+    if(Rotation->Preallocation != 0) {
+      LogFile_Preallocate(File, Rotation->Preallocation);
+    }
+#endif /* STBOX1_SD_PREALLOCATION */
+    
+    Time = HAL_GetTick() - StartTime;
+    if(Time > Rotation->OpenMaxTime) {
+      Rotation->OpenMaxTime = Time;
+    }
+    Rotation->NextReady = 1;
+    
+    /* Wake up the Writing thread if it's waiting for it */
+    tx_event_flags_set(&ClosingEvents, Rotation->ReadyEvent, TX_OR);
+  }
+}
+
+/**
+* @brief  Remove the next segment (not used) when the log is stopped.
+*         The current segment is closed by the Writing thread
+* @param  Rotation: Segments of the log file
+* @retval Size of the segments already closed
+*/
+static ULONG64 LogRotation_Stop(LogRotation_T *Rotation)
+{
+  FX_FILE *File = Rotation->Files[Rotation->Current ^ 1];
+  CHAR Name[30];
+  ULONG Events;
+  UINT status;
+  
+  /* Wait the end of the Closing thread's work: one event left by an older
+     segment only makes the check of NextReady repeat */
+  while(!Rotation->NextReady) {
+    if (tx_event_flags_get(&ClosingEvents, Rotation->ReadyEvent, TX_OR_CLEAR,
+                           &Events, TX_WAIT_FOREVER) != TX_SUCCESS)
+    {
+      Error_Handler(__FILE__,__LINE__);
+    }
+  }
+  
+  LogRotation_FileName(Name, Rotation->Format, Rotation->Session, Rotation->Segment + 1);
+  
+#ifdef STBOX1_SD_PREALLOCATION
+  /* Release all the reserved clusters */
+  status = LogFile_Release(File, 0);
+  if(status == FX_SUCCESS) {
+    /* One empty file keeps its first cluster on the directory entry and
+       exFAT doesn't accept one entry with a cluster and without data */
+    File->fx_file_dir_entry.fx_dir_entry_cluster = FX_NULL;
+    File->fx_file_modified = FX_TRUE;
+    status = fx_file_close(File);
+  }
+#else /* STBOX1_SD_PREALLOCATION */
+  status = fx_file_close(File);
+#endif /* STBOX1_SD_PREALLOCATION */
+  
+  if(status == FX_SUCCESS) {
+    status = fx_file_delete(&sdio_disk, Name);
+  }
+  
+  if (status != FX_SUCCESS)
+  {
+    /* Error removing the file, call error handler.  */
+    STBOX1_PRINTF("Error removing %s 0x%x\r\n", Name, status);
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  Rotation->NextReady = 0;
+  
+  return Rotation->ClosedBytes;
+}
+
+/**
+* @brief  Print the segments statistics (the times are the max ones)
+* @param  Name: Summary title
+* @param  Rotation: Segments of the log file
+* @retval None
+*/
+static void LogRotation_PrintSummary(CHAR *Name, LogRotation_T *Rotation)
+{
+  STBOX1_PRINTF("| %-18s |\r\n", Name);
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Segments: %7ld  |\r\n", Rotation->Segment + 1);
+  STBOX1_PRINTF("| Late: %11ld  |\r\n", Rotation->Late);
+  STBOX1_PRINTF("| Switch Max: %3ld mS |\r\n", Rotation->SwitchMaxTime);
+  STBOX1_PRINTF("| Close Max: %4ld mS |\r\n", Rotation->CloseMaxTime);
+  STBOX1_PRINTF("| Open Max: %5ld mS |\r\n", Rotation->OpenMaxTime);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+
+/**
+* @brief  Complete the current sensors segment (LogXXX.stb segment with its
+*         last chunks and index) and continue on the next one
+* @param  None
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT SensorsLog_Rotate(void)
+{
+  UINT status;
+  
+#ifdef STBOX1_LOG_CONTAINER
+  status = ContainerLog_Finish();
+  
+  if(status == FX_SUCCESS) {
+    status = LogRotation_Switch(&SensorsRotation, pLogHeader, LOG_CONTAINER_HEADER_SIZE);
+  }
+#else /* STBOX1_LOG_CONTAINER */
+  status = LogRotation_Switch(&SensorsRotation, NULL, 0);
+#endif /* STBOX1_LOG_CONTAINER */
+  
+  /* Each segment is one complete file */
+  if(status == FX_SUCCESS) {
+    status = SensorsLog_WriteHeader();
+  }
+  
+  return status;
+}
+
+#ifndef STBOX1_LOG_CONTAINER
+/**
+* @brief  Complete the header of the current audio segment
+*         and continue on the next one
+* @param  None
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT AudioLog_Rotate(void)
+{
+  UINT status;
+  
+#ifdef STBOX1_AUDIO_COMPRESSION
+  /* Number of samples of the segment */
+  AudioLac_HeaderUpdate(pAudioHeader, AudioEncoder.Samples - AudioFirstSample);
+  AudioFirstSample = AudioEncoder.Samples;
+#else /* STBOX1_AUDIO_COMPRESSION */
+  /* Size of the segment */
+  WavProcess_HeaderUpdate((uint32_t)(AudioBatch.Offset + AudioBatch.Index));
+#endif /* STBOX1_AUDIO_COMPRESSION */
+  
+  status = LogRotation_Switch(&AudioRotation, pAudioHeader, AUDIO_HEADER_SIZE);
+  
+  if(status == FX_SUCCESS) {
+    status = AudioLog_WriteHeader();
+  }
+  
+  return status;
+}
+#endif /* STBOX1_LOG_CONTAINER */
+#endif /* STBOX1_LOG_ROTATION */
+
+#ifdef STBOX1_LOG_CHECKPOINT
+/**
+* @brief  Enable the FileX fault tolerant module on the media just opened (it
+*         completes or undoes the FAT and directory updates interrupted by one
+*         power loss) and repair the last log if it was not closed
+* @param  None
+* @retval None
+*/
+static void CheckpointLog_Recover(void)
+{
+  uint32_t Sequence;
+  UINT status;
+  
+  status = fx_fault_tolerant_enable(&sdio_disk, FaultTolerantMemory, sizeof(FaultTolerantMemory));
+  if (status != FX_SUCCESS)
+  {
+    /* Error enabling the fault tolerant module, call error handler.  */
+    STBOX1_PRINTF("Error enabling FileX fault tolerant (0x%x)\r\n", status);
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  status = LogCheckpoint_Recover(&sdio_disk, &CheckpointFxFile, CHECKPOINT_FILE_NAME,
+                                 &CheckpointLog.Record, CheckpointRecords);
+  if (status != FX_SUCCESS)
+  {
+    /* The new log is saved anyway */
+    STBOX1_PRINTF("Error repairing the last log (0x%x)\r\n", status);
+  } else if (CheckpointLog.Record.Open) {
+    STBOX1_PRINTF("Last log repaired at %ld mS: %ld files, %ld bytes removed\r\n",
+                  CheckpointLog.Record.Time, CheckpointLog.Record.Repaired,
+                  (ULONG)CheckpointLog.Record.Discarded);
+  }
+  
+  /* The new log starts from the first slot with one sequence number
+     greater than the last one */
+  Sequence = (CheckpointLog.Record.Sequence + 2U) & ~1U;
+  LogCheckpoint_Init(&CheckpointLog.Record);
+  CheckpointLog.Record.Sequence = Sequence;
+  memset(CheckpointLog.Batch, 0, sizeof(CheckpointLog.Batch));
+}
+
+/**
+* @brief  Add one log file just opened to the checkpoint record
+* @param  Index: CHECKPOINT_FILE_SENSORS or CHECKPOINT_FILE_AUDIO
+* @param  Batch: Write batching stage of the file
+* @param  Name: File name
+* @retval None
+*/
+static void CheckpointLog_SetFile(UINT Index, WriteBatch_T *Batch, const CHAR *Name)
+{
+  LogCheckpoint_File_T *File = &CheckpointLog.Record.Files[Index];
+  
+  memset(File, 0, sizeof(LogCheckpoint_File_T));
+  strncpy(File->Name, Name, LOG_CHECKPOINT_NAME_SIZE - 1);
+  CheckpointLog.Batch[Index] = Batch;
+}
+
+/**
+* @brief  Create the checkpoint file and save the first checkpoint of the log
+*         on both its slots
+* @param  None
+* @retval None
+*/
+static void CheckpointLog_Start(void)
+{
+  UINT status;
+  
+  status = fx_file_create(&sdio_disk, CHECKPOINT_FILE_NAME);
+  
+  if((status == FX_SUCCESS) || (status == FX_ALREADY_CREATED)) {
+    status = fx_file_open(&sdio_disk, &CheckpointFxFile, CHECKPOINT_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+  
+  if (status != FX_SUCCESS)
+  {
+    /* Error opening file, call error handler.  */
+    STBOX1_PRINTF("Error opening %s\r\n", CHECKPOINT_FILE_NAME);
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  CheckpointLog.Record.Open = 1;
+  CheckpointLog.StartTime = HAL_GetTick();
+  
+  CheckpointLog_Save();
+  CheckpointLog_Wait();
+  CheckpointLog_Save();
+  CheckpointLog_Wait();
+  
+  CheckpointLog.Count = 0;
+  CheckpointLog.TotalTime = 0;
+  CheckpointLog.MaxTime = 0;
+  CheckpointLog.Late = 0;
+}
+
+/**
+* @brief  Save one checkpoint every STBOX1_LOG_CHECKPOINT_TIME seconds
+* @param  None
+* @retval None
+*/
+static void CheckpointLog_Check(void)
+{
+  if((HAL_GetTick() - CheckpointLog.LastTime) >= (STBOX1_LOG_CHECKPOINT_TIME * 1000U)) {
+    CheckpointLog_Save();
+  }
+}
+
+/**
+* @brief  Write out the data waiting on the write batching stages and hand off
+*         one checkpoint with the sizes of the log files to the Closing thread.
+*         If the previous checkpoint is not yet saved, it's retried after the
+*         next message
+* @param  None
+* @retval None
+*/
+static void CheckpointLog_Save(void)
+{
+  UINT status = FX_SUCCESS;
+  UINT Index;
+  
+  if(CheckpointLog.Saving) {
+    CheckpointLog.Late++;
+    return;
+  }
+  
+  for(Index = 0; (Index < LOG_CHECKPOINT_MAX_FILES) && (status == FX_SUCCESS); Index++) {
+    if(CheckpointLog.Batch[Index] != NULL) {
+      status = WriteBatch_Flush(CheckpointLog.Batch[Index]);
+      CheckpointLog.Record.Files[Index].Size = CheckpointLog.Batch[Index]->Offset;
+    }
+  }
+  
+  if (status != FX_SUCCESS)
+  {
+    /* Error writing the file, call error handler.  */
+    STBOX1_PRINTF("Error saving the checkpoint\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  CheckpointLog.LastTime = HAL_GetTick();
+  CheckpointLog.Record.Time = CheckpointLog.LastTime - CheckpointLog.StartTime;
+  
+  /* The Closing thread writes one copy: the Writing thread goes on updating the record */
+  CheckpointLog.Saved = CheckpointLog.Record;
+  CheckpointLog.Record.Sequence++;
+  CheckpointLog.Saving = 1;
+  tx_event_flags_set(&ClosingEvents, CHECKPOINT_EVENT_SAVE, TX_OR);
+}
+
+/**
+* @brief  Work of the Closing thread for one checkpoint handed off.
+*         The data, the directory entries and the FAT are on the SD before the
+*         checkpoint record that refers to them
+* @param  None
+* @retval None
+*/
+static void CheckpointLog_Process(void)
+{
+  ULONG StartTime = HAL_GetTick();
+  ULONG Time;
+  UINT status;
+  
+  status = fx_media_flush(&sdio_disk);
+  
+  if(status == FX_SUCCESS) {
+    status = LogCheckpoint_Write(&CheckpointFxFile, &CheckpointLog.Saved, CheckpointRecords);
+  }
+  
+  if(status == FX_SUCCESS) {
+    status = fx_media_flush(&sdio_disk);
+  }
+  
+  if (status != FX_SUCCESS)
+  {
+    /* Error writing the checkpoint, call error handler.  */
+    STBOX1_PRINTF("Error saving the checkpoint\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  Time = HAL_GetTick() - StartTime;
+  CheckpointLog.Count++;
+  CheckpointLog.TotalTime += Time;
+  if(Time > CheckpointLog.MaxTime) {
+    CheckpointLog.MaxTime = Time;
+  }
+  CheckpointLog.Saving = 0;
+  
+  /* Wake up the Writing thread if it's waiting for it */
+  tx_event_flags_set(&ClosingEvents, CHECKPOINT_EVENT_SAVED, TX_OR);
+}
+
+/**
+* @brief  Wait until the Closing thread has saved the checkpoint handed off
+* @param  None
+* @retval None
+*/
+static void CheckpointLog_Wait(void)
+{
+  ULONG Events;
+  
+  /* One event left by an older checkpoint only makes the check of Saving repeat */
+  while(CheckpointLog.Saving) {
+    if (tx_event_flags_get(&ClosingEvents, CHECKPOINT_EVENT_SAVED, TX_OR_CLEAR,
+                           &Events, TX_WAIT_FOREVER) != TX_SUCCESS)
+    {
+      Error_Handler(__FILE__,__LINE__);
+    }
+  }
+}
+
+/**
+* @brief  Save the last checkpoint (the log is closed) and close the checkpoint file
+* @param  None
+* @retval None
+*/
+static void CheckpointLog_Stop(void)
+{
+  UINT status;
+  
+  /* The last checkpoint handed off is written before this one */
+  CheckpointLog_Wait();
+  
+  /* The log files are already closed */
+  memset(CheckpointLog.Batch, 0, sizeof(CheckpointLog.Batch));
+  CheckpointLog.Record.Open = 0;
+  
+  status = LogCheckpoint_Write(&CheckpointFxFile, &CheckpointLog.Record, CheckpointRecords);
+  
+  if(status == FX_SUCCESS) {
+    status = fx_file_close(&CheckpointFxFile);
+  }
+  
+  if (status != FX_SUCCESS)
+  {
+    /* Error closing the file, call error handler.  */
+    STBOX1_PRINTF("Error closing %s\r\n", CHECKPOINT_FILE_NAME);
+    Error_Handler(__FILE__,__LINE__);
+  }
+}
+
+/**
+* @brief  Print the checkpoints statistics of the last log
+* @param  None
+* @retval None
+*/
+static void CheckpointLog_PrintSummary(void)
+{
+  STBOX1_PRINTF("| Checkpoints:       |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Number: %9ld  |\r\n", CheckpointLog.Count);
+  STBOX1_PRINTF("| Avg Time: %5ld mS |\r\n",
+                (CheckpointLog.Count != 0) ? (CheckpointLog.TotalTime / CheckpointLog.Count) : 0);
+  STBOX1_PRINTF("| Max Time: %5ld mS |\r\n", CheckpointLog.MaxTime);
+  STBOX1_PRINTF("| Late: %11ld  |\r\n", CheckpointLog.Late);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+
+#ifdef STBOX1_LOG_ROTATION
+/**
+* @brief  Update the segment names of the checkpoint record when one log file
+*         is started or switched to the next segment: the previous segment
+*         (closed in background) with its final size, the current one and the
+*         next one (created in advance)
+* @param  Rotation: Segments of the log file
+* @retval None
+*/
+static void CheckpointLog_SetSegments(LogRotation_T *Rotation)
+{
+  LogCheckpoint_File_T *File;
+  UINT Index;
+  
+  for(Index = 0; Index < LOG_CHECKPOINT_MAX_FILES; Index++) {
+    if(CheckpointLog.Batch[Index] == Rotation->Batch) {
+      File = &CheckpointLog.Record.Files[Index];
+      
+      if(Rotation->Segment != 0) {
+        strcpy(File->PrevName, File->Name);
+        File->PrevSize = Rotation->ClosingSize;
+      }
+      
+      LogRotation_FileName(File->Name, Rotation->Format, Rotation->Session, Rotation->Segment);
+      LogRotation_FileName(File->NextName, Rotation->Format, Rotation->Session, Rotation->Segment + 1);
+    }
+  }
+}
+#endif /* STBOX1_LOG_ROTATION */
+#endif /* STBOX1_LOG_CHECKPOINT */
+
+#ifdef STBOX1_LOG_TRIGGER
+/**
+* @brief  Start the trigger mode: the data are only kept on RAM up to the first trigger
+* @param  None
+* @retval None
+*/
+static void LogTrigger_Start(void)
+{
+  MsgRing_Init(&SensorsHistory, SensorsHistoryBuffer, sizeof(MessageData_T),
+               sizeof(SensorsHistoryBuffer) / sizeof(MessageData_T));
+  memset(&LogTrigger, 0, sizeof(LogTrigger));
+  
+  STBOX1_PRINTF("Trigger mode: %d S before and %d S after each trigger\r\n",
+                STBOX1_LOG_TRIGGER_PRE_TIME, STBOX1_LOG_TRIGGER_POST_TIME);
+  STBOX1_PRINTF("Pre-trigger RAM: Sensors %ld bytes, Audio %ld bytes\r\n",
+                (ULONG)sizeof(SensorsHistoryBuffer), (ULONG)sizeof(Audio_OUT_Buff));
+}
+
+/**
+* @brief  Send one command from the Reading thread to the Writing thread
+* @param  CommandType: COMMAND_TRIGGER or COMMAND_STOP_LOG
+* @param  Source: Source of the trigger (TRIGGER_SOURCE_xxx)
+* @retval None
+*/
+static void LogTrigger_SendCommand(UINT CommandType, UINT Source)
+{
+  MessageData_T *Msg;
+  
+  /* The commands are never discarded */
+  while((Msg = (MessageData_T *) MsgRing_Reserve(&SensorsRing)) == NULL) {
+    tx_thread_sleep(1);
+  }
+  
+  Msg->CommandType = CommandType;
+  Msg->TriggerSource = Source;
+  Msg->MsgTime = tx_time_get();
+  
+  /* Send message to the Writing Thread */
+  MsgRing_Commit(&SensorsRing);
+  tx_event_flags_set(&MessageEvents, MESSAGE_EVENT_SENSORS, TX_OR);
+}
+
+#ifdef STBOX1_LOG_TRIGGER_EMB_FUNC
+/**
+* @brief  Read the MLC and FSM interrupt status of the sensor and send one
+*         trigger when one of them is set
+* @param  None
+* @retval None
+*/
+static void LogTrigger_PollEmbFunc(void)
+{
+  static uint16_t LastStatus = 0;
+  uint8_t MlcStatus = 0;
+  uint8_t FsmStatus = 0;
+  uint16_t Status;
+  
+  BSP_MOTION_SENSOR_Read_Register(TRIGGER_EMB_FUNC_INSTANCE, TRIGGER_MLC_STATUS_REGISTER, &MlcStatus);
+  BSP_MOTION_SENSOR_Read_Register(TRIGGER_EMB_FUNC_INSTANCE, TRIGGER_FSM_STATUS_REGISTER, &FsmStatus);
+  Status = ((uint16_t)MlcStatus << 8) | FsmStatus;
+  
+  /* Only the interrupts just set */
+  if((Status & ~LastStatus) != 0) {
+    LogTrigger_SendCommand(COMMAND_TRIGGER, TRIGGER_SOURCE_EMB_FUNC);
+  }
+  LastStatus = Status;
+}
+#endif /* STBOX1_LOG_TRIGGER_EMB_FUNC */
+
+/**
+* @brief  Save one sensors message during one capture or keep it on RAM
+*         (only the last STBOX1_LOG_TRIGGER_PRE_TIME seconds) waiting for the trigger
+* @param  Msg: Message with the sensors values
+* @retval None
+*/
+static void LogTrigger_SaveSensors(MessageData_T *Msg)
+{
+  MessageData_T *History;
+  
+#if (STBOX1_LOG_TRIGGER_ACC_THRESHOLD > 0)
+  int32_t Magnitude2 = Msg->acc.x * Msg->acc.x + Msg->acc.y * Msg->acc.y + Msg->acc.z * Msg->acc.z;
+  
+  if(Magnitude2 > (STBOX1_LOG_TRIGGER_ACC_THRESHOLD * STBOX1_LOG_TRIGGER_ACC_THRESHOLD)) {
+    LogTrigger_Fire(TRIGGER_SOURCE_ACC, tx_time_get());
+  }
+  
+#endif /* STBOX1_LOG_TRIGGER_ACC_THRESHOLD > 0 */
+  if(LogTrigger.Capture) {
+    SensorsLog_Save(Msg);
+    return;
+  }
+  
+  /* The oldest message is overwritten */
+  LogTrigger.SensorsDiscarded += MsgRing_Trim(&SensorsHistory, TRIGGER_SENSORS_HISTORY - 1);
+  History = (MessageData_T *) MsgRing_Reserve(&SensorsHistory);
+  *History = *Msg;
+  MsgRing_Commit(&SensorsHistory);
+}
+
+/**
+* @brief  One trigger: start one capture saving the sensors data kept on RAM
+*         (the audio blocks kept on AudioRing are saved by the Writing thread)
+*         or extend the current one
+* @param  Source: Source of the trigger (TRIGGER_SOURCE_xxx)
+* @param  Time: tx_time_get() of the trigger
+* @retval None
+*/
+static void LogTrigger_Fire(UINT Source, ULONG Time)
+{
+  MessageData_T *History;
+  
+  if(LogTrigger.Capture == 0) {
+    LogTrigger.Capture = 1;
+    LogTrigger.StartTime = Time;
+    LogTrigger.Events[Source]++;
+    
+    STBOX1_PRINTF("Trigger %s at %ld mS\r\n", LogTriggerSourceName[Source], HAL_GetTick());
+    
+#ifdef STBOX1_LOG_CONTAINER
+    {
+      CHAR Text[LOG_NOTE_MAX_SIZE];
+      
+      sprintf(Text, "Trigger %s", LogTriggerSourceName[Source]);
+      if (ContainerLog_Annotate(HAL_GetTick(), Text) != FX_SUCCESS)
+      {
+        STBOX1_PRINTF("Error writing LogXXX.stb\r\n");
+        Error_Handler(__FILE__,__LINE__);
+      }
+    }
+#endif /* STBOX1_LOG_CONTAINER */
+    
+    while((History = (MessageData_T *) MsgRing_Peek(&SensorsHistory)) != NULL) {
+      SensorsLog_Save(History);
+      MsgRing_Release(&SensorsHistory);
+    }
+  }
+  
+  /* One trigger during the capture extends it */
+  LogTrigger.EndTime = Time + STBOX1_LOG_TRIGGER_POST_TIME * TX_TIMER_TICKS_PER_SECOND;
+}
+
+/**
+* @brief  Stop the capture STBOX1_LOG_TRIGGER_POST_TIME seconds after the last trigger
+* @param  None
+* @retval None
+*/
+static void LogTrigger_Check(void)
+{
+  if(LogTrigger.Capture && ((LONG)(tx_time_get() - LogTrigger.EndTime) >= 0)) {
+    LogTrigger.Capture = 0;
+    LogTrigger.CaptureTime += LogTrigger.EndTime - LogTrigger.StartTime;
+  }
+}
+
+/**
+* @brief  End of the log: the audio blocks kept on AudioRing are discarded
+*         if there isn't one capture
+* @param  None
+* @retval None
+*/
+static void LogTrigger_Stop(void)
+{
+  if(LogTrigger.Capture) {
+    LogTrigger.Capture = 0;
+    LogTrigger.CaptureTime += tx_time_get() - LogTrigger.StartTime;
+  } else {
+    LogTrigger.AudioDiscarded += MsgRing_Trim(&AudioRing, 0);
+    AudioMsg = NULL;
+  }
+}
+
+/**
+* @brief  Print the trigger mode statistics of the last log
+* @param  None
+* @retval None
+*/
+static void LogTrigger_PrintSummary(void)
+{
+  ULONG Captures = 0;
+  UINT Source;
+  
+  STBOX1_PRINTF("| Triggers:          |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  for(Source = 0; Source < TRIGGER_SOURCES; Source++) {
+    STBOX1_PRINTF("| %-8s%9ld  |\r\n", LogTriggerSourceName[Source], LogTrigger.Events[Source]);
+    Captures += LogTrigger.Events[Source];
+  }
+  STBOX1_PRINTF("| Saved: %8ld S  |\r\n",
+                LogTrigger.CaptureTime / TX_TIMER_TICKS_PER_SECOND + Captures * STBOX1_LOG_TRIGGER_PRE_TIME);
+  STBOX1_PRINTF("| Sens Old: %7ld  |\r\n", LogTrigger.SensorsDiscarded);
+  STBOX1_PRINTF("| Audio Old: %6ld  |\r\n", LogTrigger.AudioDiscarded);
+  STBOX1_PRINTF("| RAM: %10ld B  |\r\n", (ULONG)(sizeof(SensorsHistoryBuffer) + sizeof(Audio_OUT_Buff)));
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+#endif /* STBOX1_LOG_TRIGGER */
+
+#ifdef STBOX1_SENSORS_LOG_BINARY
+/**
+* @brief  Fill one channel descriptor of the binary sensors file header
+* @param  Channel: Pointer to the descriptor to be filled
+* @param  Sensor: Sensor name
+* @param  Name: Channel name
+* @param  Unit: Channel unit
+* @param  Type: SENSORS_LOG_TYPE_INT32 or SENSORS_LOG_TYPE_FLOAT
+* @param  Sensitivity: Sensor sensitivity
+* @param  Odr: Sensor output data rate
+* @retval None
+*/
+static void SensorsLog_ChannelInit(SensorsLogChannel_T *Channel, const char *Sensor, const char *Name, const char *Unit,
+                                   uint32_t Type, float Sensitivity, float Odr)
+{
+  memset(Channel, 0, sizeof(SensorsLogChannel_T));
+  strncpy(Channel->Sensor, Sensor, sizeof(Channel->Sensor) - 1);
+  strncpy(Channel->Name, Name, sizeof(Channel->Name) - 1);
+  strncpy(Channel->Unit, Unit, sizeof(Channel->Unit) - 1);
+  Channel->Type = Type;
+  Channel->Sensitivity = Sensitivity;
+  Channel->Odr = Odr;
+}
+
+/**
+* @brief  Initialize the binary sensors file header
+* @param  None
+* @retval 0 if passed, !0 if failed.
+*/
+static uint32_t SensorsLog_HeaderInit(void)
+{
+  SensorsLogChannel_T *Channel = SensorsLogHeader.Channels;
+  float AccSens = 0.0f, GyroSens = 0.0f, MagSens = 0.0f;
+  float AccOdr = 0.0f, GyroOdr = 0.0f, MagOdr = 0.0f;
+  float PressOdr = 0.0f, TempOdr = 0.0f;
+  
+  BSP_MOTION_SENSOR_GetSensitivity(LSM6DSV16X_0, MOTION_ACCELERO, &AccSens);
+  BSP_MOTION_SENSOR_GetSensitivity(LSM6DSV16X_0, MOTION_GYRO, &GyroSens);
+  BSP_MOTION_SENSOR_GetSensitivity(LIS2MDL_0, MOTION_MAGNETO, &MagSens);
+  BSP_MOTION_SENSOR_GetOutputDataRate(LSM6DSV16X_0, MOTION_ACCELERO, &AccOdr);
+  BSP_MOTION_SENSOR_GetOutputDataRate(LSM6DSV16X_0, MOTION_GYRO, &GyroOdr);
+  BSP_MOTION_SENSOR_GetOutputDataRate(LIS2MDL_0, MOTION_MAGNETO, &MagOdr);
+  BSP_ENV_SENSOR_GetOutputDataRate(LPS22DF_0, ENV_PRESSURE, &PressOdr);
+  BSP_ENV_SENSOR_GetOutputDataRate(STTS22H_0, ENV_TEMPERATURE, &TempOdr);
+  
+  memcpy(SensorsLogHeader.Header.Magic, SENSORS_LOG_MAGIC, sizeof(SensorsLogHeader.Header.Magic));
+  SensorsLogHeader.Header.Version = SENSORS_LOG_VERSION;
+  SensorsLogHeader.Header.HeaderSize = sizeof(SensorsLogHeader);
+  SensorsLogHeader.Header.RecordSize = sizeof(SensorsLogRecord_T);
+  SensorsLogHeader.Header.ChannelsNumber = SENSORS_LOG_CHANNELS;
+#ifdef STBOX1_IMU_FIFO
+  /* One record for each FIFO sample with the sensor's time stamp */
+  SensorsLogHeader.Header.TickFrequency = IMU_FIFO_TS_FREQUENCY;
+  SensorsLogHeader.Header.Odr = ImuFifo.FifoOdr;
+#else /* STBOX1_IMU_FIFO */
+  SensorsLogHeader.Header.TickFrequency = TX_TIMER_TICKS_PER_SECOND;
+  SensorsLogHeader.Header.Odr = ((float)TX_TIMER_TICKS_PER_SECOND) / READING_TIMER_PERIOD;
+#endif /* STBOX1_IMU_FIFO */
+  
+  /* The channels order must follow the SensorsLogRecord_T fields */
+  SensorsLog_ChannelInit(Channel++, "LSM6DSV16X", "AccX", "mg", SENSORS_LOG_TYPE_INT32, AccSens, AccOdr);
+  SensorsLog_ChannelInit(Channel++, "LSM6DSV16X", "AccY", "mg", SENSORS_LOG_TYPE_INT32, AccSens, AccOdr);
+  SensorsLog_ChannelInit(Channel++, "LSM6DSV16X", "AccZ", "mg", SENSORS_LOG_TYPE_INT32, AccSens, AccOdr);
+  SensorsLog_ChannelInit(Channel++, "LSM6DSV16X", "GyroX", "mdps", SENSORS_LOG_TYPE_INT32, GyroSens, GyroOdr);
+  SensorsLog_ChannelInit(Channel++, "LSM6DSV16X", "GyroY", "mdps", SENSORS_LOG_TYPE_INT32, GyroSens, GyroOdr);
+  SensorsLog_ChannelInit(Channel++, "LSM6DSV16X", "GyroZ", "mdps", SENSORS_LOG_TYPE_INT32, GyroSens, GyroOdr);
+  SensorsLog_ChannelInit(Channel++, "LIS2MDL", "MagX", "mgauss", SENSORS_LOG_TYPE_INT32, MagSens, MagOdr);
+  SensorsLog_ChannelInit(Channel++, "LIS2MDL", "MagY", "mgauss", SENSORS_LOG_TYPE_INT32, MagSens, MagOdr);
+  SensorsLog_ChannelInit(Channel++, "LIS2MDL", "MagZ", "mgauss", SENSORS_LOG_TYPE_INT32, MagSens, MagOdr);
+  SensorsLog_ChannelInit(Channel++, "LPS22DF", "P", "mB", SENSORS_LOG_TYPE_FLOAT, 0.0f, PressOdr);
+  SensorsLog_ChannelInit(Channel, "STTS22H", "T", "'C", SENSORS_LOG_TYPE_FLOAT, 0.0f, TempOdr);
+  
+  /* Return 0 if all operations are OK */
+  return 0;
+}
+#endif /* STBOX1_SENSORS_LOG_BINARY */
+
+#ifdef STBOX1_IMU_FIFO
+/**
+* @brief  Start the accelerometer and gyroscope batching on FIFO
+* @param  None
+* @retval None
+*/
+static void ImuFifo_Start(void)
+{
+  int32_t Result;
+  
+  memset(&ImuFifo, 0, sizeof(ImuFifo));
+  
+  BSP_MOTION_SENSOR_GetOutputDataRate(IMU_FIFO_INSTANCE, MOTION_ACCELERO, &ImuFifo.AccOdr);
+  BSP_MOTION_SENSOR_GetOutputDataRate(IMU_FIFO_INSTANCE, MOTION_GYRO, &ImuFifo.GyroOdr);
+  
+  Result  = BSP_MOTION_SENSOR_FIFO_Set_Mode(IMU_FIFO_INSTANCE, IMU_FIFO_BYPASS_MODE);
+  Result |= BSP_MOTION_SENSOR_SetOutputDataRate(IMU_FIFO_INSTANCE, MOTION_ACCELERO, STBOX1_IMU_FIFO_ODR);
+  Result |= BSP_MOTION_SENSOR_SetOutputDataRate(IMU_FIFO_INSTANCE, MOTION_GYRO, STBOX1_IMU_FIFO_ODR);
+  Result |= BSP_MOTION_SENSOR_GetOutputDataRate(IMU_FIFO_INSTANCE, MOTION_ACCELERO, &ImuFifo.FifoOdr);
+  Result |= BSP_MOTION_SENSOR_FIFO_Set_BDR(IMU_FIFO_INSTANCE, MOTION_ACCELERO, ImuFifo.FifoOdr);
+  Result |= BSP_MOTION_SENSOR_FIFO_Set_BDR(IMU_FIFO_INSTANCE, MOTION_GYRO, ImuFifo.FifoOdr);
+  /* One time stamp for each batch event */
+  Result |= BSP_MOTION_SENSOR_FIFO_TS_Decimation(IMU_FIFO_INSTANCE, MOTION_ACCELERO, 1);
+  Result |= BSP_MOTION_SENSOR_FIFO_Set_Watermark_Level(IMU_FIFO_INSTANCE, STBOX1_IMU_FIFO_WATERMARK);
+  Result |= BSP_MOTION_SENSOR_GetSensitivity(IMU_FIFO_INSTANCE, MOTION_ACCELERO, &ImuFifo.AccSensitivity);
+  Result |= BSP_MOTION_SENSOR_GetSensitivity(IMU_FIFO_INSTANCE, MOTION_GYRO, &ImuFifo.GyroSensitivity);
+  Result |= BSP_MOTION_SENSOR_FIFO_Set_Mode(IMU_FIFO_INSTANCE, IMU_FIFO_STREAM_MODE);
+  
+  if (Result != BSP_ERROR_NONE)
+  {
+    STBOX1_PRINTF("Error starting the IMU FIFO\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  STBOX1_PRINTF("IMU FIFO Start (%.1f Hz)\r\n", ImuFifo.FifoOdr);
+}
+
+/**
+* @brief  Stop the FIFO batching and restore the accelerometer and gyroscope ODR
+* @param  None
+* @retval None
+*/
+static void ImuFifo_Stop(void)
+{
+  int32_t Result;
+  
+  Result  = BSP_MOTION_SENSOR_FIFO_Set_Mode(IMU_FIFO_INSTANCE, IMU_FIFO_BYPASS_MODE);
+  Result |= BSP_MOTION_SENSOR_FIFO_TS_Decimation(IMU_FIFO_INSTANCE, MOTION_ACCELERO, 0);
+  Result |= BSP_MOTION_SENSOR_SetOutputDataRate(IMU_FIFO_INSTANCE, MOTION_ACCELERO, ImuFifo.AccOdr);
+  Result |= BSP_MOTION_SENSOR_SetOutputDataRate(IMU_FIFO_INSTANCE, MOTION_GYRO, ImuFifo.GyroOdr);
+  
+  if (Result != BSP_ERROR_NONE)
+  {
+    STBOX1_PRINTF("Error stopping the IMU FIFO\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+}
+
+/**
+* @brief  Convert the raw axes of one FIFO word
+* @param  Axes: Converted axes
+* @param  Data: Data bytes of the FIFO word
+* @param  Sensitivity: Sensor sensitivity
+* @retval None
+*/
+static void ImuFifo_GetAxes(BSP_MOTION_SENSOR_Axes_t *Axes, const uint8_t *Data, float Sensitivity)
+{
+  Axes->x = (int32_t)((float)(int16_t)(Data[0] | (Data[1] << 8)) * Sensitivity);
+  Axes->y = (int32_t)((float)(int16_t)(Data[2] | (Data[3] << 8)) * Sensitivity);
+  Axes->z = (int32_t)((float)(int16_t)(Data[4] | (Data[5] << 8)) * Sensitivity);
+}
+
+/**
+* @brief  Read the FIFO when it has reached the watermark.
+*         The FIFO level is polled at each Reading Timer tick: the
+*         SensorTileBoxPro BSP has no LSM6DSV16X interrupt line.
+*         One message is sent for each accelerometer and gyroscope pair,
+*         with the last time stamp read from the FIFO
+* @param  None
+* @retval None
+*/
+static void ImuFifo_Drain(void)
+{
+  MessageData_T *Msg;
+  BSP_MOTION_SENSOR_Axes_t mag;
+  float pressure, temperature;
+  uint16_t Level, Words, Index;
+  uint32_t Sent = 0;
+#ifdef STBOX1_LOG_CONTAINER
+  ULONG DrainTick;
+#endif /* STBOX1_LOG_CONTAINER */
+  
+  if (BSP_MOTION_SENSOR_FIFO_Get_Num_Samples(IMU_FIFO_INSTANCE, &Level) != BSP_ERROR_NONE)
+  {
+    return;
+  }
+  
+  if (Level > ImuFifo.MaxLevel)
+  {
+    ImuFifo.MaxLevel = Level;
+  }
+  
+  if (Level < STBOX1_IMU_FIFO_WATERMARK)
+  {
+    return;
+  }
+  
+#ifdef STBOX1_LOG_CONTAINER
+  /* The newest sample on the FIFO has been just taken */
+  DrainTick = HAL_GetTick();
+#endif /* STBOX1_LOG_CONTAINER */
+  
+  /* The slower sensors are read once for each FIFO drain */
+  BSP_ENV_SENSOR_GetValue(STTS22H_0, ENV_TEMPERATURE, &temperature);
+  BSP_ENV_SENSOR_GetValue(LPS22DF_0, ENV_PRESSURE, &pressure);
+  BSP_MOTION_SENSOR_GetAxes(LIS2MDL_0, MOTION_MAGNETO, &mag);
+  
+  while (Level > 0)
+  {
+    Words = (Level > STBOX1_IMU_FIFO_WATERMARK) ? STBOX1_IMU_FIFO_WATERMARK : Level;
+    
+    if (BSP_MOTION_SENSOR_FIFO_Read(IMU_FIFO_INSTANCE, ImuFifoBuffer, Words) != BSP_ERROR_NONE)
+    {
+      break;
+    }
+    ImuFifo.Bursts++;
+    ImuFifo.Words += Words;
+    Level -= Words;
+    
+    for (Index = 0; Index < Words; Index++)
+    {
+      const uint8_t *Word = ImuFifoBuffer + Index * IMU_FIFO_WORD_SIZE;
+      uint8_t Tag = Word[0] >> 3;
+      uint8_t Cnt = (Word[0] >> 1) & 0x03U;
+      
+      /* After one overrun the FIFO can start in the middle of one batch: the
+         accelerometer and the gyroscope are paired only with the same TAG_CNT */
+      if ((Tag == IMU_FIFO_TAG_ACC) || (Tag == IMU_FIFO_TAG_GYRO))
+      {
+        if ((ImuFifo.Pending != 0) && (Cnt != ImuFifo.PendingCnt))
+        {
+          ImuFifo.Pending = 0;
+          ImuFifo.Unpaired++;
+        }
+        ImuFifo.PendingCnt = Cnt;
+      }
+      
+      switch (Tag)
+      {
+        case IMU_FIFO_TAG_TIMESTAMP:
+          ImuFifo.Time = (uint32_t)Word[1] | ((uint32_t)Word[2] << 8) |
+                         ((uint32_t)Word[3] << 16) | ((uint32_t)Word[4] << 24);
+          ImuFifo.TimeValid = 1;
+#ifdef STBOX1_LOG_CONTAINER
+          if (ImuFifo.AnchorValid == 0)
+          {
+            /* First time stamp: 3 words for each sample are still on the FIFO after it */
+            ImuFifo.AnchorTime = ImuFifo.Time;
+            ImuFifo.AnchorTick = DrainTick - (ULONG)(((Level + Words - Index) / 3) * 1000.0f / ImuFifo.FifoOdr);
+            ImuFifo.AnchorValid = 1;
+          }
+#endif /* STBOX1_LOG_CONTAINER */
+          break;
+        case IMU_FIFO_TAG_ACC:
+          ImuFifo_GetAxes(&ImuFifo.acc, Word + 1, ImuFifo.AccSensitivity);
+          ImuFifo.Pending |= IMU_FIFO_TAG_ACC;
+          break;
+        case IMU_FIFO_TAG_GYRO:
+          ImuFifo_GetAxes(&ImuFifo.gyro, Word + 1, ImuFifo.GyroSensitivity);
+          ImuFifo.Pending |= IMU_FIFO_TAG_GYRO;
+          break;
+        default:
+          /* Tag not used */
+          break;
+      }
+      
+      if (ImuFifo.Pending != (IMU_FIFO_TAG_ACC | IMU_FIFO_TAG_GYRO))
+      {
+        continue;
+      }
+      ImuFifo.Pending = 0;
+      
+      /* The samples before the first time stamp are discarded */
+      if (ImuFifo.TimeValid == 0)
+      {
+        continue;
+      }
+      
+      /* If the ring is full the sample is discarded (and counted) */
+      Msg = (MessageData_T *) MsgRing_Reserve(&SensorsRing);
+      if (Msg == NULL)
+      {
+        continue;
+      }
+      
+      Msg->CommandType = COMMAND_SAVE_SENSORS;
+      Msg->MsgTime = ImuFifo.Time;
+      Msg->temperature = temperature;
+      Msg->pressure = pressure;
+      Msg->acc = ImuFifo.acc;
+      Msg->gyro = ImuFifo.gyro;
+      Msg->mag = mag;
+#ifdef STBOX1_LOG_CONTAINER
+      /* Sensor time stamp converted to mS from the last sample of the previous drain */
+      Msg->LogTime = ImuFifo.AnchorTick +
+                     (ULONG)(((uint64_t)(ImuFifo.Time - ImuFifo.AnchorTime) * 1000) / IMU_FIFO_TS_FREQUENCY);
+      /* The slower sensors are saved only once for each drain */
+      Msg->SlowSensors = (Sent == 0);
+#endif /* STBOX1_LOG_CONTAINER */
+      MsgRing_Commit(&SensorsRing);
+      Sent++;
+    }
+  }
+  
+#ifdef STBOX1_LOG_CONTAINER
+  /* The last sample read is the reference for the next drain */
+  if (ImuFifo.AnchorValid)
+  {
+    ImuFifo.AnchorTime = ImuFifo.Time;
+    ImuFifo.AnchorTick = DrainTick;
+  }
+#endif /* STBOX1_LOG_CONTAINER */
+  
+  /* Wake up the Writing Thread once for each drain */
+  if (Sent != 0)
+  {
+    tx_event_flags_set(&MessageEvents, MESSAGE_EVENT_SENSORS, TX_OR);
+  }
+}
+
+/**
+* @brief  Print the FIFO reading statistics
+* @param  None
+* @retval None
+*/
+static void ImuFifo_PrintSummary(void)
+{
+  STBOX1_PRINTF("| IMU FIFO:          |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| ODR: %9.1f Hz  |\r\n", ImuFifo.FifoOdr);
+  STBOX1_PRINTF("| Bursts: %9ld  |\r\n", ImuFifo.Bursts);
+  STBOX1_PRINTF("| Words: %10ld  |\r\n", ImuFifo.Words);
+  STBOX1_PRINTF("| Max Level: %6ld  |\r\n", ImuFifo.MaxLevel);
+  STBOX1_PRINTF("| Unpaired: %7ld  |\r\n", ImuFifo.Unpaired);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+#endif /* STBOX1_IMU_FIFO */
+
+#ifdef STBOX1_LOG_CONTAINER
+/**
+* @brief  Write the LogXXX.stb file header with the streams descriptors
+*         and the first annotation
+* @param  None
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT ContainerLog_Start(void)
+{
+  CHAR Text[LOG_NOTE_MAX_SIZE];
+  UINT status;
+  ULONG Index;
+#ifdef STBOX1_IMU_FIFO
+  /* IMU records with the sensor's time stamps, the slower sensors once for each drain */
+  uint32_t ImuTickFrequency = IMU_FIFO_TS_FREQUENCY;
+  float ImuRate = ImuFifo.FifoOdr;
+  float SlowRate = ImuFifo.FifoOdr * 3 / STBOX1_IMU_FIFO_WATERMARK;
+#else /* STBOX1_IMU_FIFO */
+  uint32_t ImuTickFrequency = LOG_TICK_FREQUENCY;
+  float ImuRate = ((float)TX_TIMER_TICKS_PER_SECOND) / READING_TIMER_PERIOD;
+  float SlowRate = ImuRate;
+#endif /* STBOX1_IMU_FIFO */
+  /* The stream names are used by stbsplit for the output files */
+  LogContainer_Stream_T Streams[LOG_STREAMS] = {
+    {LOG_STREAM_IMU, LOG_CONTAINER_TYPE_IMU, sizeof(LogImuRecord_T), "imu", ImuTickFrequency, ImuRate},
+    {LOG_STREAM_MAG, LOG_CONTAINER_TYPE_MAG, sizeof(LogMagRecord_T), "mag", LOG_TICK_FREQUENCY, SlowRate},
+    {LOG_STREAM_ENV, LOG_CONTAINER_TYPE_ENV, sizeof(LogEnvRecord_T), "env", LOG_TICK_FREQUENCY, SlowRate},
+#ifdef STBOX1_AUDIO_COMPRESSION
+    {LOG_STREAM_AUDIO, LOG_CONTAINER_TYPE_AUDIO_LAC, 0, "mic", AUDIO_IN_SAMPLING_FREQUENCY, AUDIO_IN_SAMPLING_FREQUENCY},
+#else /* STBOX1_AUDIO_COMPRESSION */
+    {LOG_STREAM_AUDIO, LOG_CONTAINER_TYPE_AUDIO_PCM, sizeof(uint16_t) * AUDIO_IN_CHANNELS, "mic", AUDIO_IN_SAMPLING_FREQUENCY, AUDIO_IN_SAMPLING_FREQUENCY},
+#endif /* STBOX1_AUDIO_COMPRESSION */
+    {LOG_STREAM_NOTES, LOG_CONTAINER_TYPE_ANNOTATION, 0, "notes", LOG_TICK_FREQUENCY, 0.0f}
+  };
+  
+  for(Index = 0; Index < LOG_SENSORS_STREAMS; Index++) {
+    LogStreams[Index].Index = 0;
+    LogStreams[Index].Count = 0;
+  }
+  
+  LogContainer_Init(&LogContainer);
+  LogContainer_HeaderInit(pLogHeader, LOG_TICK_FREQUENCY, Streams, LOG_STREAMS);
+  
+  status = WriteBatch_Write(&SensorsBatch, pLogHeader, LOG_CONTAINER_HEADER_SIZE);
+  
+  if(status == FX_SUCCESS) {
+    sprintf(Text, "Start %s V%c.%c.%c", STBOX1_PACKAGENAME,
+            STBOX1_VERSION_MAJOR, STBOX1_VERSION_MINOR, STBOX1_VERSION_PATCH);
+    status = ContainerLog_Annotate(HAL_GetTick(), Text);
+  }
+  
+  return status;
+}
+
+/**
+* @brief  Write out the last chunks and the index of the LogXXX.stb file
+*         and update its header (pLogHeader) with the index position
+* @param  None
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT ContainerLog_Finish(void)
+{
+  ULONG64 IndexOffset;
+  UINT status = FX_SUCCESS;
+  ULONG Index;
+  
+  /* Write out the records still present on the sensors chunks */
+  for(Index = 0; (Index < LOG_SENSORS_STREAMS) && (status == FX_SUCCESS); Index++) {
+    status = LogStream_Flush(&LogStreams[Index]);
+  }
+  
+  /* The index is the last chunk */
+  IndexOffset = SensorsBatch.Offset + SensorsBatch.Index;
+  if(status == FX_SUCCESS) {
+    status = LogChunk_Write(LOG_CONTAINER_STREAM_INDEX, HAL_GetTick(), LogContainer.IndexEntries,
+                            LogContainer.Index, LogContainer.IndexEntries * LOG_CONTAINER_INDEX_ENTRY_SIZE);
+  }
+  
+  LogContainer_HeaderUpdate(pLogHeader, &LogContainer, IndexOffset);
+  
+  return status;
+}
+
+/**
+* @brief  Write out the last chunks and the index, update the header
+*         and close the LogXXX.stb file
+* @param  None
+* @retval None
+*/
+static void ContainerLog_Stop(void)
+{
+  CHAR Text[LOG_NOTE_MAX_SIZE];
+  UINT status;
+  
+  sprintf(Text, "Stop Sensors Drop %ld Audio Drop %ld", SensorsRing.Overflows, AudioRing.Overflows);
+  status = ContainerLog_Annotate(HAL_GetTick(), Text);
+  
+  if(status == FX_SUCCESS) {
+    status = ContainerLog_Finish();
+  }
+  
+  /* Write out the data still present on the write batching stage */
+  if(status == FX_SUCCESS) {
+    status = WriteBatch_Flush(&SensorsBatch);
+  }
+  
+  if (status != FX_SUCCESS)
+  {
+    /* Error writing to a file, call error handler.  */
+    STBOX1_PRINTF("Error writing LogXXX.stb\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  /* size of the LogXXX.stb file */
+  SensorsFileSize = SensorsBatch.Offset;
+  
+#ifdef STBOX1_LOG_ROTATION
+  /* Remove the next segment (plus the size of the previous ones) */
+  SensorsFileSize += LogRotation_Stop(&SensorsRotation);
+#endif /* STBOX1_LOG_ROTATION */
+  
+#ifdef STBOX1_LOG_RAW
+  /* The blocks already written are not updated: the header of the session
+     is completed (index position) when it's extracted */
+  status = LogRaw_Close(&RawLog);
+  
+  /* Check the raw log close status.  */
+  if (status != FX_SUCCESS)
+  {
+    STBOX1_PRINTF("Error closing %s\r\n", RAW_LOG_FILE_NAME);
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  STBOX1_PRINTF("Session %ld closed on %s\r\n", RawLog.Session, RAW_LOG_FILE_NAME);
+#else /* STBOX1_LOG_RAW */
+  /* Move at the file beginning */
+  status = fx_file_seek(SensorsBatch.File,0);
+  if (status != FX_SUCCESS)
+  {
+    /* Error moving at the file beginning, call error handler.  */
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  /* Write the updated header */
+  status =  fx_file_write(SensorsBatch.File, pLogHeader, LOG_CONTAINER_HEADER_SIZE);
+  if (status != FX_SUCCESS)
+  {
+    /* Error writing the file, call error handler.  */
+    STBOX1_PRINTF("Error writing LogXXX.stb\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+#ifdef STBOX1_SD_PREALLOCATION
+  /* Release the reserved clusters not used */
+  status = LogFile_Release(SensorsBatch.File, SensorsBatch.Offset);
+  if (status != FX_SUCCESS)
+  {
+    /* Error releasing the clusters, call error handler.  */
+    STBOX1_PRINTF("Error releasing LogXXX.stb clusters\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+#endif /* STBOX1_SD_PREALLOCATION */
+  
+  /* Close the file.  */
+  status =  fx_file_close(SensorsBatch.File);
+  
+  /* Check the file close status.  */
+  if (status != FX_SUCCESS)
+  {
+    /* Error closing the file, call error handler.  */
+    STBOX1_PRINTF("Error closing LogXXX.stb\r\n");
+    Error_Handler(__FILE__,__LINE__);
+  }
+  
+  STBOX1_PRINTF("File LogXXX.stb closed\r\n");
+#endif /* STBOX1_LOG_RAW */
+}
+
+/**
+* @brief  Add the records of one COMMAND_SAVE_SENSORS message to the sensors chunks
+* @param  Msg: Message
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT ContainerLog_SaveSensors(MessageData_T *Msg)
+{
+  LogImuRecord_T Imu;
+  UINT status;
+  
+#ifdef STBOX1_IMU_FIFO
+  Imu.Time = Msg->MsgTime;
+#else /* STBOX1_IMU_FIFO */
+  Imu.Time = Msg->LogTime;
+#endif /* STBOX1_IMU_FIFO */
+  Imu.acc[0]  = Msg->acc.x;
+  Imu.acc[1]  = Msg->acc.y;
+  Imu.acc[2]  = Msg->acc.z;
+  Imu.gyro[0] = Msg->gyro.x;
+  Imu.gyro[1] = Msg->gyro.y;
+  Imu.gyro[2] = Msg->gyro.z;
+  
+  status = LogStream_Add(&LogStreams[LOG_STREAM_IMU], Msg->LogTime, &Imu, sizeof(Imu));
+  
+  if((status == FX_SUCCESS) && (Msg->SlowSensors)) {
+    LogMagRecord_T Mag;
+    LogEnvRecord_T Env;
+    
+    Mag.Time = Msg->LogTime;
+    Mag.mag[0] = Msg->mag.x;
+    Mag.mag[1] = Msg->mag.y;
+    Mag.mag[2] = Msg->mag.z;
+    
+    Env.Time = Msg->LogTime;
+    Env.pressure = Msg->pressure;
+    Env.temperature = Msg->temperature;
+    
+    status = LogStream_Add(&LogStreams[LOG_STREAM_MAG], Msg->LogTime, &Mag, sizeof(Mag));
+    if(status == FX_SUCCESS) {
+      status = LogStream_Add(&LogStreams[LOG_STREAM_ENV], Msg->LogTime, &Env, sizeof(Env));
+    }
+  }
+  
+  return status;
+}
+
+/**
+* @brief  Write one annotation with its own chunk
+* @param  Time: Time stamp in mS
+* @param  Text: Annotation (truncated at LOG_NOTE_MAX_SIZE chars)
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT ContainerLog_Annotate(ULONG Time, CHAR *Text)
+{
+  UCHAR Record[sizeof(uint32_t) + sizeof(uint16_t) + LOG_NOTE_MAX_SIZE];
+  uint32_t RecordTime = Time;
+  uint16_t Length = strlen(Text);
+  
+  if(Length > LOG_NOTE_MAX_SIZE) {
+    Length = LOG_NOTE_MAX_SIZE;
+  }
+  
+  memcpy(Record, &RecordTime, sizeof(RecordTime));
+  memcpy(Record + sizeof(uint32_t), &Length, sizeof(Length));
+  memcpy(Record + sizeof(uint32_t) + sizeof(uint16_t), Text, Length);
+  
+  return LogChunk_Write(LOG_STREAM_NOTES, Time, 1, Record, sizeof(uint32_t) + sizeof(uint16_t) + Length);
+}
+
+/**
+* @brief  Write out the sensors chunks whose records are waiting for too long
+* @param  None
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT ContainerLog_CheckDeadline(void)
+{
+  UINT status = FX_SUCCESS;
+  ULONG Index;
+  
+  for(Index = 0; (Index < LOG_SENSORS_STREAMS) && (status == FX_SUCCESS); Index++) {
+    if((LogStreams[Index].Count != 0) &&
+       ((HAL_GetTick() - LogStreams[Index].FirstTime) >= STBOX1_LOG_CHUNK_DEADLINE)) {
+      status = LogStream_Flush(&LogStreams[Index]);
+    }
+  }
+  
+  return status;
+}
+
+/**
+* @brief  Print the LogXXX.stb file statistics
+* @param  None
+* @retval None
+*/
+static void ContainerLog_PrintSummary(void)
+{
+  STBOX1_PRINTF("| Log container:     |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Chunks: %9ld  |\r\n", LogContainer.Chunks);
+  STBOX1_PRINTF("| Index: %10ld  |\r\n", LogContainer.IndexEntries);
+  STBOX1_PRINTF("| Stride: %9ld  |\r\n", LogContainer.IndexStride);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+
+#ifdef STBOX1_LOG_RAW
+/**
+* @brief  Print the raw log area statistics of the last session
+* @param  None
+* @retval None
+*/
+static void RawLog_PrintSummary(void)
+{
+  STBOX1_PRINTF("| Raw log:           |\r\n");
+  STBOX1_PRINTF("|--------------------|\r\n");
+  STBOX1_PRINTF("| Session: %8ld  |\r\n", RawLog.Session);
+  STBOX1_PRINTF("| Start: %10ld  |\r\n", RawLog.FirstBlock);
+  STBOX1_PRINTF("| Blocks: %9ld  |\r\n", RawLog.Sequence);
+  STBOX1_PRINTF("| Area: %11ld  |\r\n", RawLog.Blocks);
+  STBOX1_PRINTF("| Recovered: %6ld  |\r\n", RawLog.Recovered);
+  STBOX1_PRINTF("|--------------------|\r\n");
+}
+#endif /* STBOX1_LOG_RAW */
+
+/**
+* @brief  Write one chunk on the write batching stage of the LogXXX.stb file
+* @param  StreamId: Stream of the chunk
+* @param  Time: Time stamp in mS of the first record
+* @param  Count: Number of records (or samples)
+* @param  Data: Pointer to the payload
+* @param  Size: Payload size in bytes
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT LogChunk_Write(UCHAR StreamId, ULONG Time, ULONG Count, VOID *Data, ULONG Size)
+{
+  UCHAR Header[LOG_CONTAINER_CHUNK_HEADER_SIZE];
+  UINT status;
+  
+  /* The chunk starts at the current end of the write batching stage */
+  LogContainer_ChunkHeader(&LogContainer, Header, SensorsBatch.Offset + SensorsBatch.Index,
+                           StreamId, Time, Count, Size);
+  
+  status = WriteBatch_Write(&SensorsBatch, Header, LOG_CONTAINER_CHUNK_HEADER_SIZE);
+  
+  if((status == FX_SUCCESS) && (Size != 0)) {
+    status = WriteBatch_Write(&SensorsBatch, Data, Size);
+  }
+  
+  return status;
+}
+
+/**
+* @brief  Add one record to the staging area of one sensors stream
+*         (the chunk is written out when there is no space for the record)
+* @param  Stream: Sensors stream
+* @param  Time: Time stamp in mS of the record
+* @param  Record: Pointer to the record
+* @param  Size: Record size in bytes
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT LogStream_Add(LogStream_T *Stream, ULONG Time, VOID *Record, ULONG Size)
+{
+  UINT status = FX_SUCCESS;
+  
+  if((Stream->Index + Size) > STBOX1_LOG_CHUNK_SIZE) {
+    status = LogStream_Flush(Stream);
+  }
+  
+  if(Stream->Count == 0) {
+    Stream->Time = Time;
+    Stream->FirstTime = HAL_GetTick();
+  }
+  
+  memcpy(Stream->Buffer + Stream->Index, Record, Size);
+  Stream->Index += Size;
+  Stream->Count++;
+  
+  return status;
+}
+
+/**
+* @brief  Write out the records of one sensors stream with one chunk
+* @param  Stream: Sensors stream
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT LogStream_Flush(LogStream_T *Stream)
+{
+  UINT status;
+  
+  if(Stream->Count == 0) {
+    return FX_SUCCESS;
+  }
+  
+  status = LogChunk_Write(Stream->Id, Stream->Time, Stream->Count, Stream->Buffer, Stream->Index);
+  
+  Stream->Index = 0;
+  Stream->Count = 0;
+  
+  return status;
+}
+#endif /* STBOX1_LOG_CONTAINER */
 
 /* USER CODE END 1 */
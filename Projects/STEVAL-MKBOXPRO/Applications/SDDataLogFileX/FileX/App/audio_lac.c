@@ -0,0 +1,332 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\audio_lac.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Lossless audio compression (fixed linear predictor + Rice coding)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "audio_lac.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* MSB first bit stream writer */
+typedef struct
+{
+  uint8_t *Out;
+  uint32_t Acc;
+  uint32_t Count;            /* Bits waiting on Acc (always < 8 between two calls) */
+} BitWriter_T;
+
+/* Private define ------------------------------------------------------------*/
+
+/* Max bits added to the bit stream with one single BitWriter_Put */
+#define BIT_WRITER_MAX_BITS 24
+
+/* Max Rice parameter (the folded residuals of the order 3 predictor are < 2^20) */
+#define RICE_MAX_PARAMETER 20
+
+/* Private function prototypes -----------------------------------------------*/
+static inline void PutU16(uint8_t *p, uint16_t v);
+static inline void PutU32(uint8_t *p, uint32_t v);
+static inline void BitWriter_Put(BitWriter_T *Writer, uint32_t Value, uint32_t Bits);
+static uint32_t SelectOrder(const int16_t *pIn, uint32_t Samples);
+static uint32_t EncodeVerbatim(AudioLac_Encoder_T *Encoder, const int16_t *pIn, uint32_t Samples, uint8_t *pOut);
+
+/**
+* @brief  Reset the encoder statistics
+* @param  Encoder: Encoder
+* @retval None
+*/
+void AudioLac_Init(AudioLac_Encoder_T *Encoder)
+{
+  Encoder->Frames = 0;
+  Encoder->VerbatimFrames = 0;
+  Encoder->Samples = 0;
+  Encoder->Bytes = 0;
+}
+
+/**
+* @brief  Initialize the file header (the total samples are still unknown)
+* @param  pHeader: AUDIO_LAC_HEADER_SIZE bytes to fill
+* @param  SampleRate: Sampling frequency
+* @retval None
+*/
+void AudioLac_HeaderInit(uint8_t *pHeader, uint32_t SampleRate)
+{
+  memset(pHeader, 0, AUDIO_LAC_HEADER_SIZE);
+  memcpy(pHeader, AUDIO_LAC_MAGIC, 8);
+  PutU16(pHeader + 8, AUDIO_LAC_VERSION);
+  PutU16(pHeader + 10, AUDIO_LAC_HEADER_SIZE);
+  PutU32(pHeader + 12, SampleRate);
+  /* Channels */
+  PutU16(pHeader + 16, 1);
+  /* Bits for sample */
+  PutU16(pHeader + 18, 16);
+  PutU16(pHeader + 20, AUDIO_LAC_FRAME_SAMPLES);
+  PutU16(pHeader + 22, AUDIO_LAC_PARTITION_SAMPLES);
+}
+
+/**
+* @brief  Update the total samples of the file header
+* @param  pHeader: File header
+* @param  TotalSamples: Number of samples saved
+* @retval None
+*/
+void AudioLac_HeaderUpdate(uint8_t *pHeader, uint32_t TotalSamples)
+{
+  PutU32(pHeader + AUDIO_LAC_TOTAL_SAMPLES_POS, TotalSamples);
+}
+
+/**
+* @brief  Encode one frame.
+*         The fixed predictor with the smallest residuals is used, falling back
+*         to the verbatim samples when the residuals are not compressible
+* @param  Encoder: Encoder
+* @param  pIn: Samples to encode
+* @param  Samples: Number of samples (<= AUDIO_LAC_FRAME_SAMPLES)
+* @param  pOut: Output buffer (at least AUDIO_LAC_FRAME_MAX_SIZE bytes)
+* @retval Size of the encoded frame in bytes
+*/
+uint32_t AudioLac_EncodeFrame(AudioLac_Encoder_T *Encoder, const int16_t *pIn, uint32_t Samples, uint8_t *pOut)
+{
+  uint32_t *Residual = Encoder->Residual;
+  uint8_t Rice[(AUDIO_LAC_FRAME_SAMPLES + AUDIO_LAC_PARTITION_SAMPLES - 1) / AUDIO_LAC_PARTITION_SAMPLES];
+  uint32_t Partitions = (Samples + AUDIO_LAC_PARTITION_SAMPLES - 1) / AUDIO_LAC_PARTITION_SAMPLES;
+  uint32_t Order, Bits, Payload;
+  uint32_t Part, Start, End, Index;
+  BitWriter_T Writer;
+
+  if (Samples <= AUDIO_LAC_MAX_ORDER) {
+    return EncodeVerbatim(Encoder, pIn, Samples, pOut);
+  }
+
+  Order = SelectOrder(pIn, Samples);
+
+  /* Folded residuals (0,-1,1,-2,2... -> 0,1,2,3,4...) */
+  for (Index = Order; Index < Samples; Index++) {
+    int32_t Error;
+    switch (Order) {
+      case 0:
+        Error = pIn[Index];
+        break;
+      case 1:
+        Error = pIn[Index] - pIn[Index - 1];
+        break;
+      case 2:
+        Error = pIn[Index] - 2 * pIn[Index - 1] + pIn[Index - 2];
+        break;
+      default:
+        Error = pIn[Index] - 3 * pIn[Index - 1] + 3 * pIn[Index - 2] - pIn[Index - 3];
+        break;
+    }
+    Residual[Index] = ((uint32_t)Error << 1) ^ (uint32_t)(Error >> 31);
+  }
+
+  /* Rice parameter for each partition from the mean of its residuals and exact size */
+  Bits = 0;
+  for (Part = 0; Part < Partitions; Part++) {
+    uint32_t Sum = 0;
+    uint32_t Count;
+    uint32_t K = 0;
+
+    Start = (Part == 0) ? Order : Part * AUDIO_LAC_PARTITION_SAMPLES;
+    End = (Part + 1) * AUDIO_LAC_PARTITION_SAMPLES;
+    if (End > Samples) {
+      End = Samples;
+    }
+    Count = End - Start;
+
+    for (Index = Start; Index < End; Index++) {
+      Sum += Residual[Index];
+    }
+
+    while ((K < RICE_MAX_PARAMETER) && ((Count << (K + 1)) <= Sum)) {
+      K++;
+    }
+    Rice[Part] = (uint8_t)K;
+
+    Bits += AUDIO_LAC_RICE_BITS + Count * (K + 1);
+    for (Index = Start; Index < End; Index++) {
+      Bits += Residual[Index] >> K;
+    }
+  }
+
+  Payload = Order * 2 + (Bits + 7) / 8;
+  if (Payload >= (Samples * 2)) {
+    return EncodeVerbatim(Encoder, pIn, Samples, pOut);
+  }
+
+  /* Frame header */
+  PutU16(pOut, AUDIO_LAC_FRAME_SYNC);
+  PutU16(pOut + 2, (uint16_t)Samples);
+  pOut[4] = AUDIO_LAC_METHOD_FIXED;
+  pOut[5] = (uint8_t)Order;
+  PutU16(pOut + 6, (uint16_t)Payload);
+
+  /* Warm-up samples */
+  for (Index = 0; Index < Order; Index++) {
+    PutU16(pOut + AUDIO_LAC_FRAME_HEADER_SIZE + Index * 2, (uint16_t)pIn[Index]);
+  }
+
+  /* Rice coded residuals: quotient in unary (zeros ended by one) and K bits remainder */
+  Writer.Out = pOut + AUDIO_LAC_FRAME_HEADER_SIZE + Order * 2;
+  Writer.Acc = 0;
+  Writer.Count = 0;
+  for (Part = 0; Part < Partitions; Part++) {
+    uint32_t K = Rice[Part];
+
+    Start = (Part == 0) ? Order : Part * AUDIO_LAC_PARTITION_SAMPLES;
+    End = (Part + 1) * AUDIO_LAC_PARTITION_SAMPLES;
+    if (End > Samples) {
+      End = Samples;
+    }
+
+    BitWriter_Put(&Writer, K, AUDIO_LAC_RICE_BITS);
+    for (Index = Start; Index < End; Index++) {
+      uint32_t Quotient = Residual[Index] >> K;
+      uint32_t Code = (1U << K) | (Residual[Index] & ((1U << K) - 1));
+
+      if ((Quotient + 1 + K) <= BIT_WRITER_MAX_BITS) {
+        BitWriter_Put(&Writer, Code, Quotient + 1 + K);
+      } else {
+        while (Quotient > BIT_WRITER_MAX_BITS) {
+          BitWriter_Put(&Writer, 0, BIT_WRITER_MAX_BITS);
+          Quotient -= BIT_WRITER_MAX_BITS;
+        }
+        BitWriter_Put(&Writer, 0, Quotient);
+        BitWriter_Put(&Writer, Code, K + 1);
+      }
+    }
+  }
+
+  /* Last bits padded with zeros */
+  if (Writer.Count > 0) {
+    *Writer.Out = (uint8_t)(Writer.Acc << (8 - Writer.Count));
+  }
+
+  Encoder->Frames++;
+  Encoder->Samples += Samples;
+  Encoder->Bytes += AUDIO_LAC_FRAME_HEADER_SIZE + Payload;
+
+  return AUDIO_LAC_FRAME_HEADER_SIZE + Payload;
+}
+
+/**
+* @brief  Select the fixed predictor order with the smallest sum of the absolute residuals
+* @param  pIn: Samples
+* @param  Samples: Number of samples (> AUDIO_LAC_MAX_ORDER)
+* @retval Predictor order
+*/
+static uint32_t SelectOrder(const int16_t *pIn, uint32_t Samples)
+{
+  uint32_t Sum[AUDIO_LAC_MAX_ORDER + 1] = {0, 0, 0, 0};
+  int32_t Last0 = pIn[2];
+  int32_t Last1 = pIn[2] - pIn[1];
+  int32_t Last2 = pIn[2] - 2 * pIn[1] + pIn[0];
+  uint32_t Order = 0;
+  uint32_t Index;
+
+  for (Index = AUDIO_LAC_MAX_ORDER; Index < Samples; Index++) {
+    int32_t Error0 = pIn[Index];
+    int32_t Error1 = Error0 - Last0;
+    int32_t Error2 = Error1 - Last1;
+    int32_t Error3 = Error2 - Last2;
+
+    Sum[0] += (Error0 < 0) ? -Error0 : Error0;
+    Sum[1] += (Error1 < 0) ? -Error1 : Error1;
+    Sum[2] += (Error2 < 0) ? -Error2 : Error2;
+    Sum[3] += (Error3 < 0) ? -Error3 : Error3;
+
+    Last0 = Error0;
+    Last1 = Error1;
+    Last2 = Error2;
+  }
+
+  for (Index = 1; Index <= AUDIO_LAC_MAX_ORDER; Index++) {
+    if (Sum[Index] < Sum[Order]) {
+      Order = Index;
+    }
+  }
+
+  return Order;
+}
+
+/**
+* @brief  Save one frame without compression
+* @param  Encoder: Encoder
+* @param  pIn: Samples
+* @param  Samples: Number of samples
+* @param  pOut: Output buffer
+* @retval Size of the frame in bytes
+*/
+static uint32_t EncodeVerbatim(AudioLac_Encoder_T *Encoder, const int16_t *pIn, uint32_t Samples, uint8_t *pOut)
+{
+  uint32_t Index;
+
+  PutU16(pOut, AUDIO_LAC_FRAME_SYNC);
+  PutU16(pOut + 2, (uint16_t)Samples);
+  pOut[4] = AUDIO_LAC_METHOD_VERBATIM;
+  pOut[5] = 0;
+  PutU16(pOut + 6, (uint16_t)(Samples * 2));
+
+  for (Index = 0; Index < Samples; Index++) {
+    PutU16(pOut + AUDIO_LAC_FRAME_HEADER_SIZE + Index * 2, (uint16_t)pIn[Index]);
+  }
+
+  Encoder->Frames++;
+  Encoder->VerbatimFrames++;
+  Encoder->Samples += Samples;
+  Encoder->Bytes += AUDIO_LAC_FRAME_HEADER_SIZE + Samples * 2;
+
+  return AUDIO_LAC_FRAME_HEADER_SIZE + Samples * 2;
+}
+
+/**
+* @brief  Add up to BIT_WRITER_MAX_BITS bits to the bit stream
+* @param  Writer: Bit stream writer
+* @param  Value: Bits to add (right aligned, the upper bits must be zero)
+* @param  Bits: Number of bits
+* @retval None
+*/
+static inline void BitWriter_Put(BitWriter_T *Writer, uint32_t Value, uint32_t Bits)
+{
+  if (Bits == 0) {
+    return;
+  }
+
+  Writer->Acc = (Writer->Acc << Bits) | Value;
+  Writer->Count += Bits;
+  while (Writer->Count >= 8) {
+    Writer->Count -= 8;
+    *Writer->Out++ = (uint8_t)(Writer->Acc >> Writer->Count);
+  }
+}
+
+static inline void PutU16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void PutU32(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
@@ -0,0 +1,115 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_container.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Multi-stream log container (time stamped chunks + index)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOG_CONTAINER_H__
+#define __LOG_CONTAINER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* LogXXX.stb file layout (little-endian):
+   - one LOG_CONTAINER_HEADER_SIZE bytes header:
+       "STBOXSTB" magic, version, header size, number of streams,
+       chunk header size, time stamp frequency of the chunks, number of
+       chunks and file offset of the index (0 if the file was not closed)
+       followed by one LOG_CONTAINER_STREAM_SIZE bytes descriptor for each
+       stream: id, type, record size (0 if variable), name, time stamp
+       frequency of the records and records (or samples) for second
+   - the chunks up to the end of the file, each one made by:
+       sync, stream id, flags, payload size, time stamp of the first record
+       (common time base of all the streams), number of records (or samples)
+       and the payload
+   - the index: the last chunk (stream LOG_CONTAINER_STREAM_INDEX), one
+       LOG_CONTAINER_INDEX_ENTRY_SIZE bytes entry for some of the chunks:
+       file offset, time stamp and stream id of the chunk */
+#define LOG_CONTAINER_MAGIC              "STBOXSTB"
+#define LOG_CONTAINER_VERSION            1
+#define LOG_CONTAINER_HEADER_SIZE        512
+#define LOG_CONTAINER_CHUNKS_POS         20
+#define LOG_CONTAINER_INDEX_OFFSET_POS   24
+#define LOG_CONTAINER_STREAMS_POS        32
+#define LOG_CONTAINER_STREAM_SIZE        32
+#define LOG_CONTAINER_MAX_STREAMS        ((LOG_CONTAINER_HEADER_SIZE - LOG_CONTAINER_STREAMS_POS) / LOG_CONTAINER_STREAM_SIZE)
+
+#define LOG_CONTAINER_CHUNK_SYNC         0xB5C7U
+#define LOG_CONTAINER_CHUNK_HEADER_SIZE  16
+
+/* Stream of the index chunk */
+#define LOG_CONTAINER_STREAM_INDEX       0xFFU
+
+#define LOG_CONTAINER_INDEX_ENTRY_SIZE   16
+
+/* Max entries of the index: when it's full, one entry every two is removed
+   and the following chunks are indexed with a doubled stride */
+#ifndef LOG_CONTAINER_INDEX_ENTRIES
+  #define LOG_CONTAINER_INDEX_ENTRIES    1024
+#endif /* LOG_CONTAINER_INDEX_ENTRIES */
+
+/* Stream types */
+#define LOG_CONTAINER_TYPE_IMU           1 /* Time, Acc[3] (mg), Gyro[3] (mdps): int32 */
+#define LOG_CONTAINER_TYPE_MAG           2 /* Time, Mag[3] (mgauss): int32 */
+#define LOG_CONTAINER_TYPE_ENV           3 /* Time, Pressure (hPa), Temperature ('C): float */
+#define LOG_CONTAINER_TYPE_AUDIO_PCM     4 /* 16 bit samples, RecordSize / 2 interleaved channels */
+#define LOG_CONTAINER_TYPE_AUDIO_LAC     5 /* One compressed audio frame (audio_lac.h) */
+#define LOG_CONTAINER_TYPE_ANNOTATION    6 /* Time, text length (uint16) and text */
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Description of one stream */
+typedef struct
+{
+  uint8_t Id;
+  uint8_t Type;              /* LOG_CONTAINER_TYPE_XXX */
+  uint16_t RecordSize;       /* Bytes for record (0 if variable) */
+  const char *Name;          /* Up to 11 chars */
+  uint32_t TickFrequency;    /* Time stamps ticks for second of the records */
+  float Rate;                /* Records (or samples) for second */
+} LogContainer_Stream_T;
+
+typedef struct
+{
+  /* Serialized index entries */
+  uint8_t Index[LOG_CONTAINER_INDEX_ENTRIES * LOG_CONTAINER_INDEX_ENTRY_SIZE];
+  uint32_t IndexEntries;
+  uint32_t IndexStride;      /* Chunks for each index entry */
+  uint32_t IndexSkip;        /* Chunks still to skip before the next entry */
+  /* Statistics */
+  uint32_t Chunks;
+  uint64_t Bytes;
+} LogContainer_T;
+
+/* Exported functions --------------------------------------------------------*/
+void LogContainer_Init(LogContainer_T *Log);
+void LogContainer_HeaderInit(uint8_t *pHeader, uint32_t TickFrequency, const LogContainer_Stream_T *Streams, uint32_t StreamsNumber);
+void LogContainer_HeaderUpdate(uint8_t *pHeader, const LogContainer_T *Log, uint64_t IndexOffset);
+uint32_t LogContainer_ChunkHeader(LogContainer_T *Log, uint8_t *pOut, uint64_t Offset, uint8_t StreamId,
+                                  uint32_t Time, uint32_t Count, uint32_t Size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_CONTAINER_H__ */
@@ -0,0 +1,516 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_raw.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Raw log: sequential multi-block writes on one contiguous file
+  *          without FAT or directory updates while logging
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "log_raw.h"
+
+/* Private variables ---------------------------------------------------------*/
+
+/* CRC-32 (IEEE 802.3) for each nibble: one 64 bytes table is enough for
+   checking the whole payload of each block at some cycles for each byte */
+static const uint32_t Crc32Nibble[16] = {
+  0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+  0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT Create(LogRaw_T *Raw, CHAR *Name, ULONG Size, uint32_t Id);
+static ULONG Recover(LogRaw_T *Raw, uint32_t Session, ULONG FirstBlock);
+static int IsSessionBlock(LogRaw_T *Raw, uint32_t Session, ULONG Block, ULONG Sequence);
+static ULONG BlockAfter(LogRaw_T *Raw, ULONG Block, ULONG Count);
+static UINT WriteBlock(LogRaw_T *Raw);
+static UINT WriteSuper(LogRaw_T *Raw, ULONG NextBlock);
+static UINT SectorsIo(LogRaw_T *Raw, UINT Request, ULONG Block, ULONG Sectors);
+static uint32_t Crc32(const UCHAR *p, ULONG Size);
+static inline void PutU16(UCHAR *p, uint16_t v);
+static inline void PutU32(UCHAR *p, uint32_t v);
+static inline uint16_t GetU16(const UCHAR *p);
+static inline uint32_t GetU32(const UCHAR *p);
+
+/**
+* @brief  Open the raw log area and start one new session after the last one.
+*         The file is created, with all its clusters reserved at once, if it's
+*         not present. If the last session was not closed (power loss) its end
+*         is found from the sequence numbers of its blocks
+* @param  Raw: Raw log
+* @param  Media: FileX media
+* @param  File: FileX file (kept open up to LogRaw_Close)
+* @param  Name: File name
+* @param  Size: Bytes of the area reserved when the file is created
+* @param  Buffer: One block (32-Bytes aligned for the SD DMA)
+* @param  BlockSize: Bytes for each block (multiple of the sector size)
+* @param  Id: Identifier of the area if it's created (for not confusing its blocks
+*         with the ones of one old area on the same sectors)
+* @retval FX_SUCCESS, FX_NO_MORE_SPACE if there is not one contiguous area
+*         big enough or the FileX error
+*/
+UINT LogRaw_Open(LogRaw_T *Raw, FX_MEDIA *Media, FX_FILE *File, CHAR *Name, ULONG Size, UCHAR *Buffer, ULONG BlockSize, uint32_t Id)
+{
+  ULONG ClusterSize = ((ULONG)Media->fx_media_sectors_per_cluster) * Media->fx_media_bytes_per_sector;
+  uint32_t Session = 0;
+  ULONG FirstBlock = 1;
+  UINT status;
+
+  Raw->Media = Media;
+  Raw->File = File;
+  Raw->Buffer = Buffer;
+  Raw->BlockSectors = BlockSize / LOG_RAW_SECTOR_SIZE;
+  Raw->Recovered = 0;
+  Raw->PayloadBytes = 0;
+
+  if ((Media->fx_media_bytes_per_sector != LOG_RAW_SECTOR_SIZE) || ((BlockSize % LOG_RAW_SECTOR_SIZE) != 0)) {
+    return FX_NOT_IMPLEMENTED;
+  }
+
+  status = fx_file_open(Media, File, Name, FX_OPEN_FOR_WRITE);
+  if (status == FX_NOT_FOUND) {
+    status = Create(Raw, Name, Size, Id);
+    if (status == FX_SUCCESS) {
+      status = fx_file_open(Media, File, Name, FX_OPEN_FOR_WRITE);
+    }
+  }
+
+  if (status != FX_SUCCESS) {
+    return status;
+  }
+
+  /* The blocks are written directly on the sectors: the area must be one
+     single run of clusters */
+  Raw->Blocks = (ULONG)(File->fx_file_current_file_size / BlockSize);
+  if ((((ULONG64)File->fx_file_consecutive_cluster) * ClusterSize < File->fx_file_current_file_size) ||
+      (Raw->Blocks < 2)) {
+    fx_file_close(File);
+    return FX_NO_MORE_SPACE;
+  }
+
+  Raw->StartSector = Media->fx_media_data_sector_start +
+                     (File->fx_file_first_physical_cluster - FX_FAT_ENTRY_START) * Media->fx_media_sectors_per_cluster;
+
+  /* Last session from the superblock */
+  status = SectorsIo(Raw, FX_DRIVER_READ, 0, 1);
+  if (status != FX_SUCCESS) {
+    fx_file_close(File);
+    return status;
+  }
+
+  Raw->Id = GetU32(Buffer + 36);
+  if ((memcmp(Buffer, LOG_RAW_MAGIC, 8) == 0) &&
+      (GetU16(Buffer + 8) == LOG_RAW_VERSION) &&
+      (GetU16(Buffer + 10) == LOG_RAW_SUPER_SIZE) &&
+      (GetU32(Buffer + 12) == Raw->BlockSectors) &&
+      (GetU32(Buffer + 16) == Raw->Blocks) &&
+      (GetU32(Buffer + LOG_RAW_SUPER_CRC_POS) == Crc32(Buffer, LOG_RAW_SUPER_CRC_POS))) {
+    Session = GetU32(Buffer + 20);
+    FirstBlock = GetU32(Buffer + 28);
+
+    if (FirstBlock == 0) {
+      /* Not closed: its end is found from the blocks written */
+      FirstBlock = Recover(Raw, Session, GetU32(Buffer + 24));
+    }
+    Session++;
+  } else {
+    /* New area (or made with another block size): the old blocks are ignored */
+    Raw->Id = Id;
+  }
+
+  if ((FirstBlock == 0) || (FirstBlock >= Raw->Blocks)) {
+    FirstBlock = 1;
+  }
+
+  Raw->Session = Session;
+  Raw->FirstBlock = FirstBlock;
+  Raw->Block = FirstBlock;
+  Raw->Sequence = 0;
+  Raw->Index = LOG_RAW_BLOCK_HEADER_SIZE;
+
+  return WriteSuper(Raw, 0);
+}
+
+/**
+* @brief  Add data to the current block, writing out each full block
+* @param  Raw: Raw log
+* @param  Data: Pointer to the data
+* @param  Size: Number of bytes
+* @retval FX_SUCCESS, FX_NO_MORE_SPACE if the session fills the whole area
+*         or the driver error
+*/
+UINT LogRaw_Write(LogRaw_T *Raw, VOID *Data, ULONG Size)
+{
+  ULONG BlockSize = Raw->BlockSectors * LOG_RAW_SECTOR_SIZE;
+  UCHAR *Source = (UCHAR *) Data;
+  UINT status = FX_SUCCESS;
+  ULONG Len;
+
+  while ((Size > 0) && (status == FX_SUCCESS)) {
+    Len = BlockSize - Raw->Index;
+    if (Len > Size) {
+      Len = Size;
+    }
+
+    memcpy(Raw->Buffer + Raw->Index, Source, Len);
+    Raw->Index += Len;
+    Source += Len;
+    Size -= Len;
+
+    if (Raw->Index == BlockSize) {
+      status = WriteBlock(Raw);
+    }
+  }
+
+  return status;
+}
+
+/**
+* @brief  Write out the current block even if it's not full (only its sectors used)
+* @param  Raw: Raw log
+* @retval FX_SUCCESS, FX_NO_MORE_SPACE if the session fills the whole area
+*         or the driver error
+*/
+UINT LogRaw_Flush(LogRaw_T *Raw)
+{
+  if (Raw->Index == LOG_RAW_BLOCK_HEADER_SIZE) {
+    return FX_SUCCESS;
+  }
+
+  return WriteBlock(Raw);
+}
+
+/**
+* @brief  Write out the last block, close the session on the superblock
+*         and close the file
+* @param  Raw: Raw log
+* @retval FX_SUCCESS or the FileX error
+*/
+UINT LogRaw_Close(LogRaw_T *Raw)
+{
+  UINT status;
+
+  status = LogRaw_Flush(Raw);
+
+  if (status == FX_SUCCESS) {
+    status = WriteSuper(Raw, Raw->Block);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(Raw->File);
+  } else {
+    fx_file_close(Raw->File);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Create the file reserving all its clusters at once (one contiguous area).
+*         The file size covers the whole area, so the blocks can be read also
+*         as one normal file (FileX can't grow one file without writing it)
+* @param  Raw: Raw log
+* @param  Name: File name
+* @param  Size: Bytes to reserve
+* @param  Id: Identifier of the new area
+* @retval FX_SUCCESS, FX_NO_MORE_SPACE if there is not one contiguous area
+*         big enough or the FileX error
+*/
+static UINT Create(LogRaw_T *Raw, CHAR *Name, ULONG Size, uint32_t Id)
+{
+  FX_FILE *File = Raw->File;
+  UINT status;
+
+  status = fx_file_create(Raw->Media, Name);
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(Raw->Media, File, Name, FX_OPEN_FOR_WRITE);
+  }
+
+  if (status != FX_SUCCESS) {
+    return status;
+  }
+
+  status = fx_file_allocate(File, Size);
+
+  if (status == FX_SUCCESS) {
+    File->fx_file_current_file_size = File->fx_file_current_available_size;
+    File->fx_file_modified = FX_TRUE;
+
+    /* One superblock not valid: the first session starts from block 1 */
+    memset(Raw->Buffer, 0, LOG_RAW_SECTOR_SIZE);
+    PutU32(Raw->Buffer + 36, Id);
+    Raw->StartSector = Raw->Media->fx_media_data_sector_start +
+                       (File->fx_file_first_physical_cluster - FX_FAT_ENTRY_START) * Raw->Media->fx_media_sectors_per_cluster;
+    status = SectorsIo(Raw, FX_DRIVER_WRITE, 0, 1);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(File);
+  } else {
+    fx_file_close(File);
+    fx_file_delete(Raw->Media, Name);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Find the end of one session not closed: its blocks have consecutive
+*         sequence numbers from its first block, so one binary search on the
+*         sequence number reads only log2(Blocks) headers
+* @param  Raw: Raw log
+* @param  Session: Session not closed
+* @param  FirstBlock: First block of the session
+* @retval First block after the session
+*/
+static ULONG Recover(LogRaw_T *Raw, uint32_t Session, ULONG FirstBlock)
+{
+  ULONG Low = 0;
+  ULONG High = Raw->Blocks - 1;
+
+  if ((FirstBlock == 0) || (FirstBlock >= Raw->Blocks)) {
+    return 1;
+  }
+
+  while (Low < High) {
+    ULONG Middle = Low + (High - Low) / 2;
+
+    if (IsSessionBlock(Raw, Session, BlockAfter(Raw, FirstBlock, Middle), Middle)) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  Raw->Recovered = Low;
+
+  return BlockAfter(Raw, FirstBlock, Low);
+}
+
+/**
+* @brief  Check if one block has been written by one session
+* @param  Raw: Raw log
+* @param  Session: Session number
+* @param  Block: Block to check
+* @param  Sequence: Sequence number expected for the block
+* @retval 1 if the block header is valid and it has the expected numbers
+*/
+static int IsSessionBlock(LogRaw_T *Raw, uint32_t Session, ULONG Block, ULONG Sequence)
+{
+  UCHAR *Header = Raw->Buffer;
+
+  if (SectorsIo(Raw, FX_DRIVER_READ, Block, 1) != FX_SUCCESS) {
+    return 0;
+  }
+
+  return (memcmp(Header, LOG_RAW_BLOCK_MAGIC, 8) == 0) &&
+         (GetU32(Header + 8) == Raw->Id) &&
+         (GetU32(Header + 12) == Session) &&
+         (GetU32(Header + 16) == Sequence) &&
+         (GetU32(Header + LOG_RAW_BLOCK_CRC_POS) == Crc32(Header, LOG_RAW_BLOCK_CRC_POS));
+}
+
+/**
+* @brief  Block that follows another one on the ring of the blocks (1 to Blocks - 1)
+* @param  Raw: Raw log
+* @param  Block: Starting block
+* @param  Count: Number of blocks to move forward (less than Blocks - 1)
+* @retval Block
+*/
+static ULONG BlockAfter(LogRaw_T *Raw, ULONG Block, ULONG Count)
+{
+  Block += Count;
+  if (Block >= Raw->Blocks) {
+    Block -= Raw->Blocks - 1;
+  }
+
+  return Block;
+}
+
+/**
+* @brief  Complete the header of the current block and write it out
+*         with one single multi-block write of the sectors used
+* @param  Raw: Raw log
+* @retval FX_SUCCESS, FX_NO_MORE_SPACE if the session fills the whole area
+*         or the driver error
+*/
+static UINT WriteBlock(LogRaw_T *Raw)
+{
+  UCHAR *Header = Raw->Buffer;
+  ULONG Payload = Raw->Index - LOG_RAW_BLOCK_HEADER_SIZE;
+  ULONG Sectors = (Raw->Index + LOG_RAW_SECTOR_SIZE - 1) / LOG_RAW_SECTOR_SIZE;
+  UINT status;
+
+  /* The first block of the session is never overwritten */
+  if (Raw->Sequence >= Raw->Blocks - 1) {
+    return FX_NO_MORE_SPACE;
+  }
+
+  memcpy(Header, LOG_RAW_BLOCK_MAGIC, 8);
+  PutU32(Header + 8, Raw->Id);
+  PutU32(Header + 12, Raw->Session);
+  PutU32(Header + 16, Raw->Sequence);
+  PutU32(Header + 20, Payload);
+  PutU32(Header + 24, Crc32(Header + LOG_RAW_BLOCK_HEADER_SIZE, Payload));
+  PutU32(Header + LOG_RAW_BLOCK_CRC_POS, Crc32(Header, LOG_RAW_BLOCK_CRC_POS));
+
+  /* No old data after the payload on the last sector */
+  memset(Raw->Buffer + Raw->Index, 0, Sectors * LOG_RAW_SECTOR_SIZE - Raw->Index);
+
+  status = SectorsIo(Raw, FX_DRIVER_WRITE, Raw->Block, Sectors);
+
+  Raw->Block = BlockAfter(Raw, Raw->Block, 1);
+  Raw->Index = LOG_RAW_BLOCK_HEADER_SIZE;
+  Raw->Sequence++;
+  Raw->PayloadBytes += Payload;
+
+  return status;
+}
+
+/**
+* @brief  Write the superblock
+* @param  Raw: Raw log
+* @param  NextBlock: First block after the session (0 while the session is open)
+* @retval FX_SUCCESS or the driver error
+*/
+static UINT WriteSuper(LogRaw_T *Raw, ULONG NextBlock)
+{
+  UCHAR Sector[LOG_RAW_SECTOR_SIZE];
+  UCHAR *Saved = Raw->Buffer;
+  UINT status;
+
+  memset(Sector, 0, sizeof(Sector));
+  memcpy(Sector, LOG_RAW_MAGIC, 8);
+  PutU16(Sector + 8, LOG_RAW_VERSION);
+  PutU16(Sector + 10, LOG_RAW_SUPER_SIZE);
+  PutU32(Sector + 12, Raw->BlockSectors);
+  PutU32(Sector + 16, Raw->Blocks);
+  PutU32(Sector + 20, Raw->Session);
+  PutU32(Sector + 24, Raw->FirstBlock);
+  PutU32(Sector + 28, NextBlock);
+  PutU32(Sector + 32, LOG_RAW_BLOCK_HEADER_SIZE);
+  PutU32(Sector + 36, Raw->Id);
+  PutU32(Sector + LOG_RAW_SUPER_CRC_POS, Crc32(Sector, LOG_RAW_SUPER_CRC_POS));
+
+  /* The block being filled is not touched */
+  Raw->Buffer = Sector;
+  status = SectorsIo(Raw, FX_DRIVER_WRITE, 0, 1);
+  Raw->Buffer = Saved;
+
+  return status;
+}
+
+/**
+* @brief  Read or write some sectors of one block from/to Buffer with one
+*         single request to the media driver (bypassing the FileX cache,
+*         that never contains the sectors of the area)
+* @param  Raw: Raw log
+* @param  Request: FX_DRIVER_READ or FX_DRIVER_WRITE
+* @param  Block: Block number
+* @param  Sectors: Sectors from the beginning of the block
+* @retval FX_SUCCESS or the driver error
+*/
+static UINT SectorsIo(LogRaw_T *Raw, UINT Request, ULONG Block, ULONG Sectors)
+{
+  FX_MEDIA *Media = Raw->Media;
+
+#ifndef FX_MEDIA_STATISTICS_DISABLE
+  if (Request == FX_DRIVER_WRITE) {
+    Media->fx_media_driver_write_requests++;
+  } else {
+    Media->fx_media_driver_read_requests++;
+  }
+#endif /* FX_MEDIA_STATISTICS_DISABLE */
+
+  Media->fx_media_driver_request = Request;
+  Media->fx_media_driver_status = FX_IO_ERROR;
+  Media->fx_media_driver_buffer = Raw->Buffer;
+  Media->fx_media_driver_logical_sector = Raw->StartSector + Block * Raw->BlockSectors;
+  Media->fx_media_driver_sectors = Sectors;
+  Media->fx_media_driver_sector_type = FX_DATA_SECTOR;
+  /* The superblock is written as one system sector (after the blocks already queued) */
+  Media->fx_media_driver_system_write = (Block == 0) ? FX_TRUE : FX_FALSE;
+
+  (Media->fx_media_driver_entry)(Media);
+  Media->fx_media_driver_system_write = FX_FALSE;
+
+  return Media->fx_media_driver_status;
+}
+
+/**
+* @brief  CRC-32 (IEEE 802.3) of one buffer
+* @param  p: Data
+* @param  Size: Number of bytes
+* @retval CRC
+*/
+static uint32_t Crc32(const UCHAR *p, ULONG Size)
+{
+  uint32_t Crc = 0xFFFFFFFFU;
+
+  while (Size-- > 0) {
+    Crc ^= *p++;
+    Crc = (Crc >> 4) ^ Crc32Nibble[Crc & 0xFU];
+    Crc = (Crc >> 4) ^ Crc32Nibble[Crc & 0xFU];
+  }
+
+  return ~Crc;
+}
+
+/**
+* @brief  Write one 16 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU16(UCHAR *p, uint16_t v)
+{
+  p[0] = (UCHAR)v;
+  p[1] = (UCHAR)(v >> 8);
+}
+
+/**
+* @brief  Write one 32 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU32(UCHAR *p, uint32_t v)
+{
+  PutU16(p, (uint16_t)v);
+  PutU16(p + 2, (uint16_t)(v >> 16));
+}
+
+/**
+* @brief  Read one 16 bit little-endian value
+* @param  p: Source
+* @retval Value
+*/
+static inline uint16_t GetU16(const UCHAR *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+* @brief  Read one 32 bit little-endian value
+* @param  p: Source
+* @retval Value
+*/
+static inline uint32_t GetU32(const UCHAR *p)
+{
+  return ((uint32_t)GetU16(p)) | (((uint32_t)GetU16(p + 2)) << 16);
+}
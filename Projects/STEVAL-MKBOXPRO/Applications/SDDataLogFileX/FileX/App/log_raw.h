@@ -0,0 +1,92 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_raw.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Raw log: sequential multi-block writes on one contiguous file
+  *          without FAT or directory updates while logging
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOG_RAW_H__
+#define __LOG_RAW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "fx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* RawLog.bin layout (little-endian): one contiguous area of the SD card made
+   by blocks of the same size, written only with whole sectors.
+   - block 0: the superblock on its first sector:
+       "STBOXRAW" magic, version, superblock size, sectors for each block,
+       number of blocks, last session number, first block of the last session,
+       next free block (0 while the last session is open), block header size,
+       area identifier and one CRC-32 of the superblock at the end
+   - the other blocks, each one with one LOG_RAW_BLOCK_HEADER_SIZE header:
+       "STBOXBLK" magic, area identifier, session number, sequence number of
+       the block in its session, payload size, CRC-32 of the payload and
+       CRC-32 of the header,
+     followed by the payload (one piece of the session's byte stream).
+   The blocks after the superblock are used as one ring: the blocks of one
+   session are consecutive (wrapping from the last block to block 1) with
+   increasing sequence numbers, the next session starts after them and one
+   session can't overwrite its own first block */
+#define LOG_RAW_MAGIC                "STBOXRAW"
+#define LOG_RAW_VERSION              1
+#define LOG_RAW_SUPER_SIZE           64
+#define LOG_RAW_SUPER_CRC_POS        (LOG_RAW_SUPER_SIZE - 4)
+
+#define LOG_RAW_BLOCK_MAGIC          "STBOXBLK"
+#define LOG_RAW_BLOCK_HEADER_SIZE    32
+#define LOG_RAW_BLOCK_CRC_POS        (LOG_RAW_BLOCK_HEADER_SIZE - 4)
+
+#define LOG_RAW_SECTOR_SIZE          512
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  FX_MEDIA *Media;
+  FX_FILE *File;
+  ULONG StartSector;         /* First logical sector of the area */
+  ULONG BlockSectors;        /* Sectors for each block */
+  ULONG Blocks;              /* Blocks of the area (superblock included) */
+  uint32_t Id;               /* Identifier of the area */
+  uint32_t Session;          /* Session that it's written */
+  ULONG FirstBlock;          /* First block of the session */
+  ULONG Block;               /* Next block to write */
+  ULONG Sequence;            /* Blocks written by the session */
+  UCHAR *Buffer;             /* One block, header included (32-Bytes aligned) */
+  ULONG Index;               /* Bytes present on Buffer (header included) */
+  /* Statistics */
+  ULONG Recovered;           /* Blocks of the previous session found after one power loss */
+  ULONG64 PayloadBytes;
+} LogRaw_T;
+
+/* Exported functions --------------------------------------------------------*/
+UINT LogRaw_Open(LogRaw_T *Raw, FX_MEDIA *Media, FX_FILE *File, CHAR *Name, ULONG Size, UCHAR *Buffer, ULONG BlockSize, uint32_t Id);
+UINT LogRaw_Write(LogRaw_T *Raw, VOID *Data, ULONG Size);
+UINT LogRaw_Flush(LogRaw_T *Raw);
+UINT LogRaw_Close(LogRaw_T *Raw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_RAW_H__ */
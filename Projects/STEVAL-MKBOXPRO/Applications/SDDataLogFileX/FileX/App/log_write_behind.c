@@ -0,0 +1,404 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_write_behind.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Write-behind layer between FileX and its media driver: the data
+  *          sectors are queued on RAM and written by one low priority thread
+  *          within one deadline
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "log_write_behind.h"
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  ULONG Sector;              /* First logical sector */
+  ULONG Sectors;             /* Sectors queued */
+  ULONG QueueTime;           /* uS of the first write queued */
+  ULONG Deadline;            /* Tick when it's written also if it's not full */
+} WriteBehindExtent_T;
+
+/* Private variables ---------------------------------------------------------*/
+LogWriteBehindStats_T LogWriteBehindStats;
+
+static const ULONG LatencyLimits[LOG_WRITE_BEHIND_LATENCY_BINS - 1] = LOG_WRITE_BEHIND_LATENCY_LIMITS;
+
+static struct
+{
+  VOID (*Driver)(FX_MEDIA *media_ptr);
+  UCHAR *Buffer;
+  ULONG ExtentSize;
+  ULONG Extents;
+  ULONG Deadline;
+  WriteBehindExtent_T Extent[LOG_WRITE_BEHIND_MAX_EXTENTS];
+  ULONG Head;                /* Oldest extent queued */
+  ULONG Count;               /* Extents queued */
+  ULONG Queued;              /* Bytes queued */
+  UINT Open;                 /* The last extent queued accepts the next writes */
+  UINT Drain;                /* One request waits for the queue empty */
+  UINT Error;                /* One write failed: returned on the next request */
+  FX_MEDIA Media;            /* Media given to the driver by the thread */
+  TX_MUTEX Mutex;
+  TX_SEMAPHORE Free;         /* Free extents */
+  TX_SEMAPHORE Work;         /* Wakes up the thread */
+  TX_SEMAPHORE Empty;        /* Queue written after one drain request */
+  TX_THREAD Thread;
+} WriteBehind;
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT Queue(FX_MEDIA *media_ptr);
+static UINT Drain(VOID);
+static UINT WriteExtent(WriteBehindExtent_T *Extent, UCHAR *Buffer);
+static VOID WriteBehind_Thread(ULONG Input);
+
+/**
+* @brief  Start the write-behind layer of one media driver
+* @param  Driver: FileX media driver (called by LogWriteBehind_Driver and by the thread)
+* @param  Buffer: RAM of the queue (32-Bytes aligned for the SD DMA)
+* @param  Size: Bytes of the queue
+* @param  ExtentSize: Bytes of each extent (multiple of the sector size): the contiguous
+*         writes are queued on the same extent and written with one request
+* @param  Deadline: Max ticks from the first write on one extent to the start of its write
+* @param  Priority: Priority of the thread writing the queue (lower than the FileX threads)
+* @param  Stack: Stack of the thread
+* @param  StackSize: Bytes of the stack
+* @retval FX_SUCCESS or FX_NOT_ENOUGH_MEMORY if there is not space for 2 extents
+*/
+UINT LogWriteBehind_Init(VOID (*Driver)(FX_MEDIA *media_ptr), UCHAR *Buffer, ULONG Size, ULONG ExtentSize,
+                         ULONG Deadline, UINT Priority, VOID *Stack, ULONG StackSize)
+{
+  ULONG Extents = (ExtentSize != 0) ? (Size / ExtentSize) : 0;
+
+  if (Extents > LOG_WRITE_BEHIND_MAX_EXTENTS) {
+    Extents = LOG_WRITE_BEHIND_MAX_EXTENTS;
+  }
+
+  if (Extents < 2) {
+    return FX_NOT_ENOUGH_MEMORY;
+  }
+
+  memset(&WriteBehind, 0, sizeof(WriteBehind));
+  memset(&LogWriteBehindStats, 0, sizeof(LogWriteBehindStats));
+  WriteBehind.Driver = Driver;
+  WriteBehind.Buffer = Buffer;
+  WriteBehind.ExtentSize = ExtentSize;
+  WriteBehind.Extents = Extents;
+  WriteBehind.Deadline = (Deadline != 0) ? Deadline : 1;
+
+  if ((tx_mutex_create(&WriteBehind.Mutex, "WriteBehind Mutex", TX_INHERIT) != TX_SUCCESS) ||
+      (tx_semaphore_create(&WriteBehind.Free, "WriteBehind Free", Extents) != TX_SUCCESS) ||
+      (tx_semaphore_create(&WriteBehind.Work, "WriteBehind Work", 0) != TX_SUCCESS) ||
+      (tx_semaphore_create(&WriteBehind.Empty, "WriteBehind Empty", 0) != TX_SUCCESS) ||
+      (tx_thread_create(&WriteBehind.Thread, "WriteBehind Thread", WriteBehind_Thread, 0, Stack, StackSize,
+                        Priority, Priority, TX_NO_TIME_SLICE, TX_AUTO_START) != TX_SUCCESS)) {
+    return FX_IO_ERROR;
+  }
+
+  return FX_SUCCESS;
+}
+
+/**
+* @brief  FileX media driver with the write-behind layer: the data sector writes are
+*         queued, the other requests (reads, FAT/directory writes, flush, close..)
+*         wait for the queued writes before calling the media driver, so the writes
+*         are done on the media in the same order and fx_media_flush returns when
+*         all the data are written. One write failed in background is returned on
+*         the next request
+* @param  media_ptr: FileX media
+* @retval None
+*/
+VOID LogWriteBehind_Driver(FX_MEDIA *media_ptr)
+{
+  UINT status;
+
+  if ((media_ptr->fx_media_driver_request == FX_DRIVER_WRITE) &&
+      (media_ptr->fx_media_driver_system_write == FX_FALSE)) {
+    media_ptr->fx_media_driver_status = Queue(media_ptr);
+    return;
+  }
+
+  status = Drain();
+
+  switch (media_ptr->fx_media_driver_request) {
+    case FX_DRIVER_INIT:
+      memset(&LogWriteBehindStats, 0, sizeof(LogWriteBehindStats));
+      /* Fall through */
+    case FX_DRIVER_UNINIT:
+    case FX_DRIVER_ABORT:
+      /* Done also after one write error */
+      break;
+    default:
+      if (status != FX_SUCCESS) {
+        media_ptr->fx_media_driver_status = status;
+        return;
+      }
+      break;
+  }
+
+  WriteBehind.Driver(media_ptr);
+}
+
+/**
+* @brief  Queue one data sector write: it's appended to the last extent if it's
+*         contiguous, otherwise it waits for one free extent if the queue is full
+* @param  media_ptr: FileX media
+* @retval FX_SUCCESS or FX_IO_ERROR (queue full for LOG_WRITE_BEHIND_TIMEOUT or
+*         one previous write failed)
+*/
+static UINT Queue(FX_MEDIA *media_ptr)
+{
+  ULONG SectorSize = media_ptr->fx_media_bytes_per_sector;
+  ULONG ExtentSectors = WriteBehind.ExtentSize / SectorSize;
+  ULONG Sector = media_ptr->fx_media_driver_logical_sector;
+  ULONG Sectors = media_ptr->fx_media_driver_sectors;
+  UCHAR *Data = media_ptr->fx_media_driver_buffer;
+  WriteBehindExtent_T *Extent;
+  ULONG Start;
+  ULONG Wait;
+  ULONG n;
+
+  tx_mutex_get(&WriteBehind.Mutex, TX_WAIT_FOREVER);
+
+  if (WriteBehind.Error) {
+    WriteBehind.Error = 0;
+    tx_mutex_put(&WriteBehind.Mutex);
+    return FX_IO_ERROR;
+  }
+
+  LogWriteBehindStats.Writes++;
+
+  /* Used by the thread for calling the driver */
+  WriteBehind.Media.fx_media_driver_info = media_ptr->fx_media_driver_info;
+  WriteBehind.Media.fx_media_hidden_sectors = media_ptr->fx_media_hidden_sectors;
+  WriteBehind.Media.fx_media_bytes_per_sector = media_ptr->fx_media_bytes_per_sector;
+
+  while (Sectors > 0) {
+    if (WriteBehind.Open) {
+      Extent = &WriteBehind.Extent[(WriteBehind.Head + WriteBehind.Count - 1) % WriteBehind.Extents];
+
+      if ((Extent->Sector + Extent->Sectors) == Sector) {
+        if (Sectors == media_ptr->fx_media_driver_sectors) {
+          LogWriteBehindStats.Coalesced++;
+        }
+      } else {
+        /* Not contiguous: the last extent is written at once */
+        WriteBehind.Open = 0;
+        tx_semaphore_ceiling_put(&WriteBehind.Work, 1);
+        continue;
+      }
+    } else {
+      if (tx_semaphore_get(&WriteBehind.Free, TX_NO_WAIT) != TX_SUCCESS) {
+        /* Queue full: the FileX thread waits for the oldest extent written */
+        tx_mutex_put(&WriteBehind.Mutex);
+        tx_semaphore_ceiling_put(&WriteBehind.Work, 1);
+        Start = LOG_WRITE_BEHIND_TIME_US();
+
+        if (tx_semaphore_get(&WriteBehind.Free, LOG_WRITE_BEHIND_TIMEOUT) != TX_SUCCESS) {
+          return FX_IO_ERROR;
+        }
+
+        Wait = LOG_WRITE_BEHIND_TIME_US() - Start;
+        tx_mutex_get(&WriteBehind.Mutex, TX_WAIT_FOREVER);
+        LogWriteBehindStats.FullWaits++;
+        LogWriteBehindStats.WaitTime += Wait;
+        if (Wait > LogWriteBehindStats.WaitMax) {
+          LogWriteBehindStats.WaitMax = Wait;
+        }
+      }
+
+      Extent = &WriteBehind.Extent[(WriteBehind.Head + WriteBehind.Count) % WriteBehind.Extents];
+      Extent->Sector = Sector;
+      Extent->Sectors = 0;
+      Extent->QueueTime = LOG_WRITE_BEHIND_TIME_US();
+      Extent->Deadline = tx_time_get() + WriteBehind.Deadline;
+      WriteBehind.Count++;
+      WriteBehind.Open = 1;
+
+      if (WriteBehind.Count > LogWriteBehindStats.MaxExtents) {
+        LogWriteBehindStats.MaxExtents = WriteBehind.Count;
+      }
+
+      if (WriteBehind.Count == 1) {
+        /* The thread waits for the deadline of this extent */
+        tx_semaphore_ceiling_put(&WriteBehind.Work, 1);
+      }
+    }
+
+    n = ExtentSectors - Extent->Sectors;
+    if (n > Sectors) {
+      n = Sectors;
+    }
+
+    memcpy(WriteBehind.Buffer + ((Extent - WriteBehind.Extent) * WriteBehind.ExtentSize) + (Extent->Sectors * SectorSize),
+           Data, n * SectorSize);
+    Extent->Sectors += n;
+    Sector += n;
+    Sectors -= n;
+    Data += n * SectorSize;
+
+    WriteBehind.Queued += n * SectorSize;
+    if (WriteBehind.Queued > LogWriteBehindStats.MaxBytes) {
+      LogWriteBehindStats.MaxBytes = WriteBehind.Queued;
+    }
+
+    if (Extent->Sectors == ExtentSectors) {
+      /* Full: written at once */
+      WriteBehind.Open = 0;
+      tx_semaphore_ceiling_put(&WriteBehind.Work, 1);
+    }
+  }
+
+  tx_mutex_put(&WriteBehind.Mutex);
+
+  return FX_SUCCESS;
+}
+
+/**
+* @brief  Wait for all the queued writes done on the media
+* @param  None
+* @retval FX_SUCCESS or FX_IO_ERROR if one write failed or the queue was not
+*         written within LOG_WRITE_BEHIND_TIMEOUT
+*/
+static UINT Drain(VOID)
+{
+  UINT status = FX_SUCCESS;
+
+  tx_mutex_get(&WriteBehind.Mutex, TX_WAIT_FOREVER);
+
+  if (WriteBehind.Count != 0) {
+    LogWriteBehindStats.Drains++;
+    WriteBehind.Drain = 1;
+    tx_mutex_put(&WriteBehind.Mutex);
+    tx_semaphore_ceiling_put(&WriteBehind.Work, 1);
+
+    if (tx_semaphore_get(&WriteBehind.Empty, LOG_WRITE_BEHIND_TIMEOUT) != TX_SUCCESS) {
+      return FX_IO_ERROR;
+    }
+
+    tx_mutex_get(&WriteBehind.Mutex, TX_WAIT_FOREVER);
+  }
+
+  if (WriteBehind.Error) {
+    WriteBehind.Error = 0;
+    status = FX_IO_ERROR;
+  }
+
+  tx_mutex_put(&WriteBehind.Mutex);
+
+  return status;
+}
+
+/**
+* @brief  Write one extent with the media driver
+* @param  Extent: Extent queued
+* @param  Buffer: Data of the extent
+* @retval Driver status
+*/
+static UINT WriteExtent(WriteBehindExtent_T *Extent, UCHAR *Buffer)
+{
+  WriteBehind.Media.fx_media_driver_request = FX_DRIVER_WRITE;
+  WriteBehind.Media.fx_media_driver_logical_sector = Extent->Sector;
+  WriteBehind.Media.fx_media_driver_sectors = Extent->Sectors;
+  WriteBehind.Media.fx_media_driver_buffer = Buffer;
+  WriteBehind.Media.fx_media_driver_system_write = FX_FALSE;
+  WriteBehind.Media.fx_media_driver_status = FX_IO_ERROR;
+
+  WriteBehind.Driver(&WriteBehind.Media);
+
+  return WriteBehind.Media.fx_media_driver_status;
+}
+
+/**
+* @brief  Thread writing the queue: the full extents are written at once, the
+*         last one at its deadline or when one request waits for the queue empty
+* @param  Input: Not used
+* @retval None
+*/
+static VOID WriteBehind_Thread(ULONG Input)
+{
+  WriteBehindExtent_T *Extent;
+  ULONG Wait = TX_WAIT_FOREVER;
+  ULONG Latency;
+  ULONG Now;
+  UINT status;
+  int Bin;
+
+  (void)Input;
+
+  for (;;) {
+    tx_semaphore_get(&WriteBehind.Work, Wait);
+    tx_mutex_get(&WriteBehind.Mutex, TX_WAIT_FOREVER);
+
+    while (WriteBehind.Count != 0) {
+      Extent = &WriteBehind.Extent[WriteBehind.Head];
+
+      if (WriteBehind.Open && (WriteBehind.Count == 1)) {
+        /* Still filled by FileX */
+        if ((!WriteBehind.Drain) && (((LONG)(tx_time_get() - Extent->Deadline)) < 0)) {
+          break;
+        }
+
+        WriteBehind.Open = 0;
+        if (!WriteBehind.Drain) {
+          LogWriteBehindStats.DeadlineFlushes++;
+        }
+      }
+
+      /* FileX can queue on the other extents while this one is written */
+      tx_mutex_put(&WriteBehind.Mutex);
+      status = WriteExtent(Extent, WriteBehind.Buffer + (WriteBehind.Head * WriteBehind.ExtentSize));
+      Latency = LOG_WRITE_BEHIND_TIME_US() - Extent->QueueTime;
+      tx_mutex_get(&WriteBehind.Mutex, TX_WAIT_FOREVER);
+
+      if (status != FX_SUCCESS) {
+        LogWriteBehindStats.Errors++;
+        WriteBehind.Error = 1;
+      }
+
+      LogWriteBehindStats.Extents++;
+      if (Latency > LogWriteBehindStats.LatencyMax) {
+        LogWriteBehindStats.LatencyMax = Latency;
+      }
+
+      for (Bin = 0; Bin < (LOG_WRITE_BEHIND_LATENCY_BINS - 1); Bin++) {
+        if (Latency < (LatencyLimits[Bin] * 1000U)) {
+          break;
+        }
+      }
+      LogWriteBehindStats.Latency[Bin]++;
+
+      WriteBehind.Queued -= Extent->Sectors * WriteBehind.Media.fx_media_bytes_per_sector;
+      WriteBehind.Head = (WriteBehind.Head + 1) % WriteBehind.Extents;
+      WriteBehind.Count--;
+      tx_semaphore_put(&WriteBehind.Free);
+    }
+
+    /* Wakes up at the deadline of the last extent or at the next request */
+    Wait = TX_WAIT_FOREVER;
+    if (WriteBehind.Count != 0) {
+      Now = tx_time_get();
+      Extent = &WriteBehind.Extent[WriteBehind.Head];
+      Wait = (((LONG)(Extent->Deadline - Now)) > 0) ? (Extent->Deadline - Now) : 1;
+    } else if (WriteBehind.Drain) {
+      WriteBehind.Drain = 0;
+      tx_semaphore_put(&WriteBehind.Empty);
+    }
+
+    tx_mutex_put(&WriteBehind.Mutex);
+  }
+}
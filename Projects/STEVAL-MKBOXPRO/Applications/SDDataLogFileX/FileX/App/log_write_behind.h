@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_write_behind.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Write-behind layer between FileX and its media driver: the data
+  *          sectors are queued on RAM and written by one low priority thread
+  *          within one deadline
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOG_WRITE_BEHIND_H__
+#define __LOG_WRITE_BEHIND_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "fx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Max extents of the queue: the RAM given to LogWriteBehind_Init is split in
+   extents of the same size, each one written with one multi-sector request */
+#define LOG_WRITE_BEHIND_MAX_EXTENTS      32
+
+/* Max wait for one free extent or for the queued writes (ticks) */
+#define LOG_WRITE_BEHIND_TIMEOUT          (10 * TX_TIMER_TICKS_PER_SECOND)
+
+/* Histogram of the latency from the first write queued on one extent to the end
+   of its write on the media: the upper limits (mS) of the bins, the last bin
+   has the longer ones */
+#define LOG_WRITE_BEHIND_LATENCY_BINS     8
+#define LOG_WRITE_BEHIND_LATENCY_LIMITS   {10, 20, 50, 100, 200, 500, 1000}
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Time base of the statistics (uS) */
+#ifndef LOG_WRITE_BEHIND_TIME_US
+#define LOG_WRITE_BEHIND_TIME_US()        (tx_time_get() * (1000000U / TX_TIMER_TICKS_PER_SECOND))
+#endif /* LOG_WRITE_BEHIND_TIME_US */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  ULONG Writes;              /* Data sector writes of FileX */
+  ULONG Coalesced;           /* Writes appended to the previous extent */
+  ULONG Extents;             /* Extents written on the media */
+  ULONG DeadlineFlushes;     /* Extents written at their deadline before being full */
+  ULONG Drains;              /* Other requests that waited for the queued writes */
+  ULONG FullWaits;           /* Writes that waited for one free extent */
+  ULONG64 WaitTime;          /* uS of the FileX thread waiting for one free extent */
+  ULONG WaitMax;             /* Max uS of one wait */
+  ULONG MaxExtents;          /* High-water mark of the extents queued */
+  ULONG MaxBytes;            /* High-water mark of the bytes queued */
+  ULONG LatencyMax;          /* Max uS from the first queued write to the end of the write */
+  ULONG Latency[LOG_WRITE_BEHIND_LATENCY_BINS];
+  ULONG Errors;              /* Writes failed on the media */
+} LogWriteBehindStats_T;
+
+/* Exported variables --------------------------------------------------------*/
+extern LogWriteBehindStats_T LogWriteBehindStats;
+
+/* Exported functions --------------------------------------------------------*/
+UINT LogWriteBehind_Init(VOID (*Driver)(FX_MEDIA *media_ptr), UCHAR *Buffer, ULONG Size, ULONG ExtentSize,
+                         ULONG Deadline, UINT Priority, VOID *Stack, ULONG StackSize);
+VOID LogWriteBehind_Driver(FX_MEDIA *media_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_WRITE_BEHIND_H__ */
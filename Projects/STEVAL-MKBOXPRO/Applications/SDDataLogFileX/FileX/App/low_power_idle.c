@@ -0,0 +1,186 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\low_power_idle.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Tickless idle of ThreadX: the low power hooks of the scheduler
+  *          (tx_low_power.c) stop the tick and wait up to the next ThreadX
+  *          timer expiration on one low power timer, then the time slept is
+  *          added to the ThreadX time
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "low_power_idle.h"
+
+/* Private variables ---------------------------------------------------------*/
+LowPowerIdleStats_T LowPowerIdleStats;
+
+static struct
+{
+  const LowPowerIdle_Driver_T *Driver;
+  volatile UINT StopAllowed;
+  /* Idle period in progress */
+  UINT Stop;                 /* Stop mode, with the tick stopped */
+  ULONG Counts;              /* Counts of the low power timer */
+  ULONG Elapsed;             /* Counts since the last tick counted at the entry */
+  ULONG AdjustTicks;
+} Idle;
+
+/**
+* @brief  Start the tickless idle
+* @param  Driver: Hardware of the idle periods (NULL for the busy loop of the
+*         scheduler)
+* @retval None
+*/
+VOID LowPowerIdle_Init(const LowPowerIdle_Driver_T *Driver)
+{
+  Idle.Driver = Driver;
+  Idle.Stop = TX_FALSE;
+  Idle.AdjustTicks = 0;
+}
+
+/**
+* @brief  Allow the Stop mode: without it the idle periods wait with the tick
+*         running, so one interrupt resumes the threads without the wake up
+*         time of the Stop mode (and the peripherals without clocks in Stop
+*         mode keep working)
+* @param  Allow: TX_TRUE for allowing the Stop mode
+* @retval None
+*/
+VOID LowPowerIdle_AllowStop(UINT Allow)
+{
+  Idle.StopAllowed = Allow;
+}
+
+/**
+* @brief  Choose the mode of the idle period and start the low power timer for
+*         the Stop mode. Called by tx_low_power_enter with the interrupts
+*         disabled
+* @param  Ticks: Ticks up to the next ThreadX timer expiration minus one
+*         (tx_timer_get_next), 0xFFFFFFFF without ThreadX timers
+* @retval None
+*/
+VOID LowPowerIdle_TimerSetup(ULONG Ticks)
+{
+  const LowPowerIdle_Driver_T *Driver = Idle.Driver;
+  ULONG Elapsed;
+  ULONG MaxTicks;
+
+  Idle.Stop = TX_FALSE;
+
+  if ((Driver == NULL) || (Idle.StopAllowed == TX_FALSE)) {
+    return;
+  }
+
+  /* With the tick pending the idle period ends at once */
+  Elapsed = Driver->TickElapsed();
+  if (Elapsed >= Driver->CountsPerTick) {
+    return;
+  }
+
+  /* Ticks up to the expiration: the wake up is at the expiration and its
+     tick is the one pending at the exit */
+  MaxTicks = (Driver->MaxCounts + Elapsed) / Driver->CountsPerTick;
+  Ticks = (Ticks >= MaxTicks) ? MaxTicks : Ticks + 1;
+  if ((Ticks < Driver->MinStopTicks) || (Ticks * Driver->CountsPerTick <= Elapsed)) {
+    return;
+  }
+
+  Idle.Counts = Ticks * Driver->CountsPerTick - Elapsed;
+  Driver->TimerStart(Idle.Counts);
+
+  /* The counts up to the start of the timer are counted with the tick */
+  Idle.Elapsed = Driver->TickSuspend();
+  Idle.Stop = TX_TRUE;
+}
+
+/**
+* @brief  Wait for one interrupt. Called by tx_low_power_enter with the
+*         interrupts disabled by the scheduler (the interrupt pending wakes up
+*         the MCU, its handler runs after tx_low_power_exit)
+* @param  None
+* @retval None
+*/
+VOID LowPowerIdle_Enter(VOID)
+{
+  const LowPowerIdle_Driver_T *Driver = Idle.Driver;
+
+  if (Driver == NULL) {
+    return;
+  }
+
+  if (Idle.Stop) {
+    LowPowerIdleStats.Stops++;
+    Driver->Stop();
+  } else {
+    LowPowerIdleStats.Sleeps++;
+    Driver->Sleep();
+  }
+}
+
+/**
+* @brief  Restart the tick after the Stop mode. Called by tx_low_power_exit
+*         with the interrupts disabled
+* @param  None
+* @retval None
+*/
+VOID LowPowerIdle_Exit(VOID)
+{
+  const LowPowerIdle_Driver_T *Driver = Idle.Driver;
+  ULONG Counts;
+  ULONG Total;
+  ULONG Ticks;
+  ULONG Elapsed;
+
+  Idle.AdjustTicks = 0;
+
+  if (Idle.Stop == TX_FALSE) {
+    return;
+  }
+  Idle.Stop = TX_FALSE;
+
+  Counts = Driver->TimerStop();
+  if (Counts < Idle.Counts) {
+    LowPowerIdleStats.EarlyWakeups++;
+  }
+
+  Total = Idle.Elapsed + Counts;
+  Ticks = Total / Driver->CountsPerTick;
+  Elapsed = Total - (Ticks * Driver->CountsPerTick);
+  LowPowerIdleStats.StopTicks += Ticks;
+
+  /* The last tick is counted by the tick interrupt, so the timers expired
+     at the wake up are processed as by the tick running. The tick restarts
+     with the counts of the tick in progress, so the ThreadX ticks keep the
+     real time also after one wake up before the timer */
+  if (Ticks != 0) {
+    Idle.AdjustTicks = Ticks - 1;
+  }
+  Driver->TickResume(Counts, Elapsed, (Ticks != 0) ? TX_TRUE : TX_FALSE);
+}
+
+/**
+* @brief  Ticks to add to the ThreadX time after the Stop mode
+* @param  None
+* @retval Ticks (tx_time_increment)
+*/
+ULONG LowPowerIdle_TimerAdjust(VOID)
+{
+  ULONG Ticks = Idle.AdjustTicks;
+
+  Idle.AdjustTicks = 0;
+
+  return Ticks;
+}
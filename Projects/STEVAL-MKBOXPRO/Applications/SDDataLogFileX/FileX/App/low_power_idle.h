@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\low_power_idle.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Tickless idle of ThreadX: the low power hooks of the scheduler
+  *          (tx_low_power.c) stop the tick and wait up to the next ThreadX
+  *          timer expiration on one low power timer, then the time slept is
+  *          added to the ThreadX time
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOW_POWER_IDLE_H__
+#define __LOW_POWER_IDLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Hardware of the idle periods. The counts are the ones of the low power timer */
+typedef struct
+{
+  ULONG CountsPerTick;                 /* Counts of one ThreadX tick */
+  ULONG MaxCounts;                     /* Longest period of the low power timer */
+  ULONG MinStopTicks;                  /* Shortest wait (ThreadX ticks) of the Stop mode */
+  /* Counts since the last tick, CountsPerTick or more if the tick is pending */
+  ULONG (*TickElapsed)(VOID);
+  /* Stop the tick: whole counts since the last tick, with one tick more if
+     it is pending (its interrupt is cleared) */
+  ULONG (*TickSuspend)(VOID);
+  /* Restart the tick after Counts stopped, on one count of the low power
+     timer: the first period is shorter of the Elapsed counts of the tick in
+     progress and of the part of count not given by TickSuspend, with the
+     interrupt pending if Pend is set */
+  VOID (*TickResume)(ULONG Counts, ULONG Elapsed, UINT Pend);
+  VOID (*TimerStart)(ULONG Counts);    /* Low power timer interrupt after Counts */
+  ULONG (*TimerStop)(VOID);            /* Counts since TimerStart */
+  VOID (*Sleep)(VOID);                 /* Wait one interrupt with the tick running */
+  VOID (*Stop)(VOID);                  /* Wait one interrupt in Stop mode, clocks restored at the end */
+} LowPowerIdle_Driver_T;
+
+typedef struct
+{
+  ULONG Sleeps;              /* Idle periods with the tick running */
+  ULONG Stops;               /* Idle periods in Stop mode */
+  ULONG EarlyWakeups;        /* Stop periods ended before the low power timer */
+  ULONG StopTicks;           /* ThreadX ticks slept in Stop mode */
+} LowPowerIdleStats_T;
+
+/* Exported variables --------------------------------------------------------*/
+extern LowPowerIdleStats_T LowPowerIdleStats;
+
+/* Exported functions --------------------------------------------------------*/
+VOID LowPowerIdle_Init(const LowPowerIdle_Driver_T *Driver);
+VOID LowPowerIdle_AllowStop(UINT Allow);
+
+/* Hooks of tx_low_power.c (TX_LOW_POWER_TIMER_SETUP, TX_LOW_POWER_USER_ENTER,
+   TX_LOW_POWER_USER_EXIT and TX_LOW_POWER_USER_TIMER_ADJUST) */
+VOID LowPowerIdle_TimerSetup(ULONG Ticks);
+VOID LowPowerIdle_Enter(VOID);
+VOID LowPowerIdle_Exit(VOID);
+ULONG LowPowerIdle_TimerAdjust(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOW_POWER_IDLE_H__ */
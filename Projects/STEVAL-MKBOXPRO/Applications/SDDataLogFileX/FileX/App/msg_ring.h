@@ -0,0 +1,181 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\msg_ring.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Single producer/single consumer ring of fixed size messages
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MSG_RING_H__
+#define __MSG_RING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "stm32u5xx_hal.h"
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Smallest power of 2 not lower than N (N from 1 to 65536), for sizing one ring
+   at compile time */
+#define MSG_RING_SMEAR1(N)  ((N) | ((N) >> 1))
+#define MSG_RING_SMEAR2(N)  (MSG_RING_SMEAR1(N) | (MSG_RING_SMEAR1(N) >> 2))
+#define MSG_RING_SMEAR4(N)  (MSG_RING_SMEAR2(N) | (MSG_RING_SMEAR2(N) >> 4))
+#define MSG_RING_SMEAR8(N)  (MSG_RING_SMEAR4(N) | (MSG_RING_SMEAR4(N) >> 8))
+#define MSG_RING_SIZE(N)    (MSG_RING_SMEAR8((ULONG)(N) - 1U) + 1U)
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Wait-free ring shared by one producer (thread or interrupt) and one consumer.
+   Head and Tail are free running sequence numbers: Head is written only by the
+   producer and Tail only by the consumer, so no lock is needed.
+   The messages are filled and read in place (Reserve/Commit and Peek/Release) */
+typedef struct
+{
+  UCHAR *Buffer;             /* ItemsNumber messages of ItemSize bytes */
+  ULONG ItemSize;
+  ULONG ItemsNumber;         /* Must be a power of 2 */
+  volatile ULONG Head;       /* Sequence number of the next message to commit */
+  volatile ULONG Tail;       /* Sequence number of the next message to release */
+  /* Statistics (written by the producer) */
+  ULONG Overflows;           /* Reserve requests refused because the ring was full */
+  ULONG MaxUsed;             /* Max number of messages waiting for the consumer */
+} MsgRing_T;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Initialize one ring (no producer or consumer must be active)
+* @param  Ring: Ring to initialize
+* @param  Buffer: Memory for ItemsNumber*ItemSize bytes
+* @param  ItemSize: Size of one message
+* @param  ItemsNumber: Number of messages (power of 2)
+* @retval None
+*/
+static inline void MsgRing_Init(MsgRing_T *Ring, VOID *Buffer, ULONG ItemSize, ULONG ItemsNumber)
+{
+  Ring->Buffer = (UCHAR *) Buffer;
+  Ring->ItemSize = ItemSize;
+  Ring->ItemsNumber = ItemsNumber;
+  Ring->Head = 0;
+  Ring->Tail = 0;
+  Ring->Overflows = 0;
+  Ring->MaxUsed = 0;
+}
+
+/**
+* @brief  Number of committed messages not yet released
+* @param  Ring: Ring
+* @retval Number of messages
+*/
+static inline ULONG MsgRing_Used(MsgRing_T *Ring)
+{
+  return Ring->Head - Ring->Tail;
+}
+
+/**
+* @brief  Producer: get the next free message
+* @param  Ring: Ring
+* @retval Pointer to the message to fill or NULL if the ring is full
+*/
+static inline VOID *MsgRing_Reserve(MsgRing_T *Ring)
+{
+  ULONG Head = Ring->Head;
+
+  if((Head - Ring->Tail) == Ring->ItemsNumber) {
+    Ring->Overflows++;
+    return NULL;
+  }
+
+  return Ring->Buffer + (Head & (Ring->ItemsNumber - 1)) * Ring->ItemSize;
+}
+
+/**
+* @brief  Producer: publish the message obtained with MsgRing_Reserve
+* @param  Ring: Ring
+* @retval None
+*/
+static inline void MsgRing_Commit(MsgRing_T *Ring)
+{
+  ULONG Used;
+
+  /* The message must be in memory before the consumer could see it */
+  __DMB();
+  Ring->Head++;
+
+  Used = Ring->Head - Ring->Tail;
+  if(Used > Ring->MaxUsed) {
+    Ring->MaxUsed = Used;
+  }
+}
+
+/**
+* @brief  Consumer: get the oldest committed message
+* @param  Ring: Ring
+* @retval Pointer to the message or NULL if the ring is empty
+*/
+static inline VOID *MsgRing_Peek(MsgRing_T *Ring)
+{
+  ULONG Tail = Ring->Tail;
+
+  if(Tail == Ring->Head) {
+    return NULL;
+  }
+
+  /* Read the message only after having seen the Head */
+  __DMB();
+  return Ring->Buffer + (Tail & (Ring->ItemsNumber - 1)) * Ring->ItemSize;
+}
+
+/**
+* @brief  Consumer: give back to the producer the message obtained with MsgRing_Peek
+* @param  Ring: Ring
+* @retval None
+*/
+static inline void MsgRing_Release(MsgRing_T *Ring)
+{
+  /* The message must be completely read before the producer could reuse it */
+  __DMB();
+  Ring->Tail++;
+}
+
+/**
+* @brief  Consumer: give back to the producer the oldest messages, keeping only
+*         the newest ones on the ring without reading them
+* @param  Ring: Ring
+* @param  Keep: Number of messages to keep
+* @retval Number of messages discarded
+*/
+static inline ULONG MsgRing_Trim(MsgRing_T *Ring, ULONG Keep)
+{
+  ULONG Used = Ring->Head - Ring->Tail;
+
+  if(Used <= Keep) {
+    return 0;
+  }
+
+  __DMB();
+  Ring->Tail += Used - Keep;
+  return Used - Keep;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MSG_RING_H__ */
@@ -0,0 +1,352 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\thread_profiler.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Per-thread CPU load and stack high-water marks of the ThreadX
+  *          threads, with the high-water marks of the message rings, reported
+  *          as one JSON status at a fixed period
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "thread_profiler.h"
+#include "tx_thread.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Bytes of the JSON status kept for closing the lists */
+#define THREAD_PROFILER_JSON_TAIL         16
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  TX_THREAD *Thread;
+  ULONG Samples;             /* Samples of the thread running */
+} ThreadProfilerCounter_T;
+
+typedef struct
+{
+  const CHAR *Name;
+  ULONG Size;
+  const ULONG *MaxUsed;
+  const ULONG *Overflows;
+} ThreadProfilerQueue_T;
+
+/* Private variables ---------------------------------------------------------*/
+ThreadProfilerStats_T ThreadProfilerStats;
+
+static struct
+{
+  VOID (*Report)(const CHAR *Json);
+  ULONG Period;
+  /* Written by ThreadProfiler_Sample */
+  ThreadProfilerCounter_T Counter[THREAD_PROFILER_MAX_THREADS];
+  ULONG Counters;            /* Counters assigned to one thread */
+  ULONG Last;                /* Counter of the last sample */
+  ULONG Samples;
+  ULONG Idle;
+  ULONG Unknown;
+  /* Counters of the last period */
+  ULONG Snapshot[THREAD_PROFILER_MAX_THREADS];
+  ULONG SnapshotCounters;
+  ThreadProfilerQueue_T Queue[THREAD_PROFILER_MAX_QUEUES];
+  ULONG Queues;
+  CHAR Json[THREAD_PROFILER_JSON_SIZE];
+  ULONG Length;
+  TX_THREAD Thread;
+} Profiler;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID Snapshot(VOID);
+static VOID Format(VOID);
+static UINT Append(ULONG Limit, const CHAR *Fmt, ...);
+static ULONG PerMille(ULONG Samples, ULONG Total);
+static ULONG StackUsed(TX_THREAD *Thread);
+static VOID ThreadProfiler_Thread(ULONG Input);
+
+/**
+* @brief  Start the thread reporting the status of the threads
+* @param  Report: Callback receiving the JSON status (called by the thread)
+* @param  Period: Ticks between two reports
+* @param  Priority: Priority of the thread (the lowest one of the application,
+*         so the reports don't delay the other threads)
+* @param  Stack: Stack of the thread
+* @param  StackSize: Bytes of the stack
+* @retval TX_SUCCESS or the error of tx_thread_create
+*/
+UINT ThreadProfiler_Init(VOID (*Report)(const CHAR *Json), ULONG Period, UINT Priority, VOID *Stack, ULONG StackSize)
+{
+  Profiler.Report = Report;
+  Profiler.Period = (Period != 0) ? Period : 1;
+
+  return tx_thread_create(&Profiler.Thread, "Profiler Thread", ThreadProfiler_Thread, 0, Stack, StackSize,
+                          Priority, Priority, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/**
+* @brief  Add one queue to the reports: its counters are read at each report
+* @param  Name: Name of the queue on the report
+* @param  Size: Messages of the queue
+* @param  MaxUsed: High-water mark of the messages waiting
+* @param  Overflows: Messages refused because the queue was full
+* @retval TX_SUCCESS or TX_SIZE_ERROR if there are already THREAD_PROFILER_MAX_QUEUES
+*/
+UINT ThreadProfiler_AddQueue(const CHAR *Name, ULONG Size, const ULONG *MaxUsed, const ULONG *Overflows)
+{
+  ThreadProfilerQueue_T *Queue;
+
+  if (Profiler.Queues == THREAD_PROFILER_MAX_QUEUES) {
+    return TX_SIZE_ERROR;
+  }
+
+  Queue = &Profiler.Queue[Profiler.Queues];
+  Queue->Name = Name;
+  Queue->Size = Size;
+  Queue->MaxUsed = MaxUsed;
+  Queue->Overflows = Overflows;
+  Profiler.Queues++;
+
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Count one sample of the thread running: called at a fixed rate by one
+*         interrupt with the lowest priority, so the thread interrupted is the
+*         one running (or none if the scheduler is idle). The time spent on the
+*         interrupts is counted on the thread interrupted
+* @param  None
+* @retval None
+*/
+VOID ThreadProfiler_Sample(VOID)
+{
+  TX_THREAD *Current;
+  ULONG Index;
+
+  TX_THREAD_GET_CURRENT(Current)
+
+  Profiler.Samples++;
+
+  if (Current == TX_NULL) {
+    Profiler.Idle++;
+    return;
+  }
+
+  /* The same thread runs for many samples */
+  if (Profiler.Counter[Profiler.Last].Thread == Current) {
+    Profiler.Counter[Profiler.Last].Samples++;
+    return;
+  }
+
+  for (Index = 0; Index < Profiler.Counters; Index++) {
+    if (Profiler.Counter[Index].Thread == Current) {
+      break;
+    }
+  }
+
+  if (Index == Profiler.Counters) {
+    if (Index == THREAD_PROFILER_MAX_THREADS) {
+      Profiler.Unknown++;
+      return;
+    }
+
+    /* First sample of the thread */
+    Profiler.Counter[Index].Thread = Current;
+    Profiler.Counters++;
+  }
+
+  Profiler.Counter[Index].Samples++;
+  Profiler.Last = Index;
+}
+
+/**
+* @brief  Copy and reset the counters of the period
+* @param  None
+* @retval None
+*/
+static VOID Snapshot(VOID)
+{
+  UINT Interrupts;
+  ULONG Index;
+
+  Interrupts = tx_interrupt_control(TX_INT_DISABLE);
+
+  for (Index = 0; Index < Profiler.Counters; Index++) {
+    Profiler.Snapshot[Index] = Profiler.Counter[Index].Samples;
+    Profiler.Counter[Index].Samples = 0;
+  }
+  Profiler.SnapshotCounters = Profiler.Counters;
+
+  ThreadProfilerStats.Samples = Profiler.Samples;
+  ThreadProfilerStats.Idle = Profiler.Idle;
+  ThreadProfilerStats.Unknown = Profiler.Unknown;
+  Profiler.Samples = 0;
+  Profiler.Idle = 0;
+  Profiler.Unknown = 0;
+
+  tx_interrupt_control(Interrupts);
+}
+
+/**
+* @brief  Write the JSON status of the last period on Profiler.Json:
+*         {"performance":{"samples":1000,"idle":85.2,
+*          "threads":[{"name":"..","priority":12,"load":10.3,"stack_used":1204,"stack_size":4096},..],
+*          "queues":[{"name":"..","size":128,"max_used":12,"overflows":0},..]}}
+*         load and idle are % of the samples, stack_used is the high-water mark
+*         of the stack (Bytes changed from the ThreadX fill pattern)
+* @param  None
+* @retval None
+*/
+static VOID Format(VOID)
+{
+  ULONG Limit = THREAD_PROFILER_JSON_SIZE - THREAD_PROFILER_JSON_TAIL;
+  ULONG Total = ThreadProfilerStats.Samples;
+  ULONG Load;
+  ULONG Index;
+  ULONG Reported = 0;
+  TX_THREAD *Thread;
+  ULONG Threads;
+  ThreadProfilerQueue_T *Queue;
+
+  Profiler.Length = 0;
+  Load = PerMille(ThreadProfilerStats.Idle, Total);
+  Append(THREAD_PROFILER_JSON_SIZE, "{\"performance\":{\"samples\":%lu,\"idle\":%lu.%lu,\"threads\":[",
+         (unsigned long)Total, (unsigned long)(Load / 10), (unsigned long)(Load % 10));
+
+  /* The threads are created only at the start of the application */
+  Thread = _tx_thread_created_ptr;
+  for (Threads = _tx_thread_created_count; Threads != 0; Threads--) {
+    for (Index = 0; Index < Profiler.SnapshotCounters; Index++) {
+      if (Profiler.Counter[Index].Thread == Thread) {
+        break;
+      }
+    }
+    Load = (Index < Profiler.SnapshotCounters) ? PerMille(Profiler.Snapshot[Index], Total) : 0;
+
+#ifndef TX_DISABLE_STACK_FILLING
+    if (Append(Limit, "%s{\"name\":\"%s\",\"priority\":%u,\"load\":%lu.%lu,\"stack_used\":%lu,\"stack_size\":%lu}",
+               (Reported != 0) ? "," : "", Thread->tx_thread_name, Thread->tx_thread_priority,
+               (unsigned long)(Load / 10), (unsigned long)(Load % 10),
+               (unsigned long)StackUsed(Thread), (unsigned long)Thread->tx_thread_stack_size) != TX_SUCCESS) {
+#else /* TX_DISABLE_STACK_FILLING */
+    /* The stack is not filled: its high-water mark is unknown */
+    if (Append(Limit, "%s{\"name\":\"%s\",\"priority\":%u,\"load\":%lu.%lu,\"stack_size\":%lu}",
+               (Reported != 0) ? "," : "", Thread->tx_thread_name, Thread->tx_thread_priority,
+               (unsigned long)(Load / 10), (unsigned long)(Load % 10),
+               (unsigned long)Thread->tx_thread_stack_size) != TX_SUCCESS) {
+#endif /* TX_DISABLE_STACK_FILLING */
+      break;
+    }
+
+    Reported++;
+    Thread = Thread->tx_thread_created_next;
+  }
+
+  Append(THREAD_PROFILER_JSON_SIZE, "],\"queues\":[");
+
+  for (Index = 0; Index < Profiler.Queues; Index++) {
+    Queue = &Profiler.Queue[Index];
+    if (Append(Limit, "%s{\"name\":\"%s\",\"size\":%lu,\"max_used\":%lu,\"overflows\":%lu}",
+               (Index != 0) ? "," : "", Queue->Name, (unsigned long)Queue->Size,
+               (unsigned long)*Queue->MaxUsed, (unsigned long)*Queue->Overflows) != TX_SUCCESS) {
+      break;
+    }
+  }
+
+  Append(THREAD_PROFILER_JSON_SIZE, "]}}");
+}
+
+/**
+* @brief  Append one formatted text to Profiler.Json
+* @param  Limit: Max Bytes of Profiler.Json with the text (terminator included)
+* @param  Fmt: Format of the text
+* @retval TX_SUCCESS or TX_SIZE_ERROR if the text doesn't fit (nothing is appended)
+*/
+static UINT Append(ULONG Limit, const CHAR *Fmt, ...)
+{
+  va_list Args;
+  int Length;
+
+  va_start(Args, Fmt);
+  Length = vsnprintf(&Profiler.Json[Profiler.Length], Limit - Profiler.Length, Fmt, Args);
+  va_end(Args);
+
+  if ((Length < 0) || ((ULONG)Length >= (Limit - Profiler.Length))) {
+    Profiler.Json[Profiler.Length] = '\0';
+    return TX_SIZE_ERROR;
+  }
+
+  Profiler.Length += (ULONG)Length;
+
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Samples on thousandths of the total, rounded
+* @param  Samples: Samples of one thread
+* @param  Total: All the samples of the period
+* @retval Thousandths of the samples
+*/
+static ULONG PerMille(ULONG Samples, ULONG Total)
+{
+  if (Total == 0) {
+    return 0;
+  }
+
+  return (ULONG)((((ULONG64)Samples * 1000U) + (Total / 2U)) / Total);
+}
+
+/**
+* @brief  High-water mark of one stack: the stack grows down and it's filled with
+*         TX_STACK_FILL when the thread is created, so the words never written
+*         are the ones from the start of the stack up to the first changed one
+* @param  Thread: Thread
+* @retval Bytes of the stack used
+*/
+static ULONG StackUsed(TX_THREAD *Thread)
+{
+  ULONG *Start = (ULONG *) Thread->tx_thread_stack_start;
+  ULONG *End = (ULONG *) Thread->tx_thread_stack_end;
+  ULONG *Word = Start;
+
+  while ((Word < End) && (*Word == TX_STACK_FILL)) {
+    Word++;
+  }
+
+  return Thread->tx_thread_stack_size - (ULONG)((UCHAR *) Word - (UCHAR *) Start);
+}
+
+/**
+* @brief  Thread reporting the status at each period
+* @param  Input: Not used
+* @retval None
+*/
+static VOID ThreadProfiler_Thread(ULONG Input)
+{
+  (void)Input;
+
+  for (;;) {
+    tx_thread_sleep(Profiler.Period);
+
+    Snapshot();
+    Format();
+    if (Profiler.Report != NULL) {
+      Profiler.Report(Profiler.Json);
+    }
+    ThreadProfilerStats.Reports++;
+  }
+}
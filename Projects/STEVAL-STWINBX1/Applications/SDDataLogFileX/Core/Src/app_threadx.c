@@ -23,7 +23,9 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "main.h"
+#include "low_power_idle.h"
+#include "stm32u5xx_ll_lptim.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -33,7 +35,12 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#ifdef STBOX1_LOW_POWER_IDLE
+/* LPTIM1 clocked by LSI (32KHz) / 4: 8.19 Seconds of Stop 2 at most */
+#define LOW_POWER_TIMER_FREQUENCY 8000
+#define LOW_POWER_TIMER_MAX_COUNTS 0xFFFF
+#define LOW_POWER_TIMER_COUNTS_PER_TICK (LOW_POWER_TIMER_FREQUENCY / TX_TIMER_TICKS_PER_SECOND)
+#endif /* STBOX1_LOW_POWER_IDLE */
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -43,12 +50,43 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
+#ifdef STBOX1_LOW_POWER_IDLE
+static const LowPowerIdle_Driver_T LowPowerDriver = {
+  LOW_POWER_TIMER_COUNTS_PER_TICK,
+  LOW_POWER_TIMER_MAX_COUNTS,
+  STBOX1_LOW_POWER_IDLE_MIN_TICKS,
+  LowPower_TickElapsed,
+  LowPower_TickSuspend,
+  LowPower_TickResume,
+  LowPower_TimerStart,
+  LowPower_TimerStop,
+  LowPower_Sleep,
+  LowPower_Stop
+};
 
+/* LPTIM1 counts not yet added to the HAL tick */
+static ULONG LowPowerHalTickCounts = 0;
+
+/* SysTick cycles after the last LPTIM1 count at the stop of the tick */
+static uint32_t LowPowerTickFraction = 0;
+#endif /* STBOX1_LOW_POWER_IDLE */
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN PFP */
-
+#ifdef STBOX1_LOW_POWER_IDLE
+void SystemClock_Config(void);
+static void LowPower_Timer_Init(void);
+static ULONG LowPower_SysTickCounts(uint32_t Cycles);
+static ULONG LowPower_TimerCounter(VOID);
+static ULONG LowPower_TickElapsed(VOID);
+static ULONG LowPower_TickSuspend(VOID);
+static VOID LowPower_TickResume(ULONG Counts, ULONG Elapsed, UINT Pend);
+static VOID LowPower_TimerStart(ULONG Counts);
+static ULONG LowPower_TimerStop(VOID);
+static VOID LowPower_Sleep(VOID);
+static VOID LowPower_Stop(VOID);
+#endif /* STBOX1_LOW_POWER_IDLE */
 /* USER CODE END PFP */
 
 /**
@@ -66,6 +104,12 @@ UINT App_ThreadX_Init(VOID *memory_ptr)
   /* USER CODE END App_ThreadX_MEM_POOL */
 
   /* USER CODE BEGIN App_ThreadX_Init */
+#ifdef STBOX1_LOW_POWER_IDLE
+  /* Tickless idle: Stop 2 mode up to the start of the log */
+  LowPower_Timer_Init();
+  LowPowerIdle_Init(&LowPowerDriver);
+  LowPowerIdle_AllowStop(TX_TRUE);
+#endif /* STBOX1_LOW_POWER_IDLE */
   /* USER CODE END App_ThreadX_Init */
 
   return ret;
@@ -89,6 +133,276 @@ void MX_ThreadX_Init(void)
   /* USER CODE END  Kernel_Start_Error */
 }
 
+/**
+  * @brief  App_ThreadX_LowPower_Timer_Setup
+  * @param  count : TX timer count
+  * @retval None
+  */
+void App_ThreadX_LowPower_Timer_Setup(ULONG count)
+{
+  /* USER CODE BEGIN  App_ThreadX_LowPower_Timer_Setup */
+  LowPowerIdle_TimerSetup(count);
+  /* USER CODE END  App_ThreadX_LowPower_Timer_Setup */
+}
+
+/**
+  * @brief  App_ThreadX_LowPower_Enter
+  * @param  None
+  * @retval None
+  */
+void App_ThreadX_LowPower_Enter(void)
+{
+  /* USER CODE BEGIN  App_ThreadX_LowPower_Enter */
+  LowPowerIdle_Enter();
+  /* USER CODE END  App_ThreadX_LowPower_Enter */
+}
+
+/**
+  * @brief  App_ThreadX_LowPower_Exit
+  * @param  None
+  * @retval None
+  */
+void App_ThreadX_LowPower_Exit(void)
+{
+  /* USER CODE BEGIN  App_ThreadX_LowPower_Exit */
+  LowPowerIdle_Exit();
+  /* USER CODE END  App_ThreadX_LowPower_Exit */
+}
+
+/**
+  * @brief  App_ThreadX_LowPower_Timer_Adjust
+  * @param  None
+  * @retval Amount of time (in ticks)
+  */
+ULONG App_ThreadX_LowPower_Timer_Adjust(void)
+{
+  /* USER CODE BEGIN  App_ThreadX_LowPower_Timer_Adjust */
+  return LowPowerIdle_TimerAdjust();
+  /* USER CODE END  App_ThreadX_LowPower_Timer_Adjust */
+}
+
 /* USER CODE BEGIN 1 */
+#ifdef STBOX1_LOW_POWER_IDLE
+/**
+  * @brief  LPTIM1 clocked by LSI for the wake up from the Stop 2 mode
+  * @param  None
+  * @retval None
+  */
+static void LowPower_Timer_Init(void)
+{
+  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_LSI;
+  RCC_OscInitStruct.LSIState = RCC_LSI_ON;
+  RCC_OscInitStruct.LSIDiv = RCC_LSI_DIV1;
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+  {
+    Error_Handler(__FILE__,__LINE__);
+  }
+
+  __HAL_RCC_LPTIM1_CONFIG(RCC_LPTIM1CLKSOURCE_LSI);
+  __HAL_RCC_LPTIM1_CLK_ENABLE();
+  /* LPTIM1 keeps counting in Stop 2 mode */
+  __HAL_RCC_LPTIM1_CLKAM_ENABLE();
+
+  /* The configuration is written with the LPTIM disabled */
+  LL_LPTIM_Disable(LPTIM1);
+  LL_LPTIM_SetClockSource(LPTIM1, LL_LPTIM_CLK_SOURCE_INTERNAL);
+  LL_LPTIM_SetPrescaler(LPTIM1, LL_LPTIM_PRESCALER_DIV4);
+
+  HAL_NVIC_SetPriority(LPTIM1_IRQn, TICK_INT_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+}
+
+/**
+  * @brief  SysTick cycles to LPTIM1 counts (whole counts)
+  * @param  Cycles: SysTick cycles
+  * @retval LPTIM1 counts
+  */
+static ULONG LowPower_SysTickCounts(uint32_t Cycles)
+{
+  uint64_t Period = (uint64_t)SysTick->LOAD + 1;
+
+  return (ULONG)(((uint64_t)Cycles * LOW_POWER_TIMER_COUNTS_PER_TICK) / Period);
+}
+
+/**
+  * @brief  LPTIM1 counts since the last ThreadX tick
+  * @param  None
+  * @retval Counts, LOW_POWER_TIMER_COUNTS_PER_TICK if the tick is pending
+  */
+static ULONG LowPower_TickElapsed(VOID)
+{
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U)
+  {
+    return LOW_POWER_TIMER_COUNTS_PER_TICK;
+  }
+
+  return LowPower_SysTickCounts(SysTick->LOAD - SysTick->VAL);
+}
 
+/**
+  * @brief  Stop the SysTick (ThreadX tick) and the HAL tick (TIM6)
+  * @param  None
+  * @retval LPTIM1 counts since the last ThreadX tick (the tick pending is
+  *         counted and cleared)
+  */
+static ULONG LowPower_TickSuspend(VOID)
+{
+  uint64_t Period = (uint64_t)SysTick->LOAD + 1;
+  uint32_t Cycles;
+  ULONG Counts;
+
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  Cycles = SysTick->LOAD - SysTick->VAL;
+  Counts = LowPower_SysTickCounts(Cycles);
+  LowPowerTickFraction = Cycles - (uint32_t)((Counts * Period) / LOW_POWER_TIMER_COUNTS_PER_TICK);
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U)
+  {
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+    Counts += LOW_POWER_TIMER_COUNTS_PER_TICK;
+  }
+
+  HAL_SuspendTick();
+
+  return Counts;
+}
+
+/**
+  * @brief  Restart the SysTick (ThreadX tick) and the HAL tick (TIM6)
+  * @param  Counts: LPTIM1 counts with the ticks stopped
+  * @param  Elapsed: LPTIM1 counts of the ThreadX tick in progress
+  * @param  Pend: Set the SysTick interrupt pending
+  * @retval None
+  */
+static VOID LowPower_TickResume(ULONG Counts, ULONG Elapsed, UINT Pend)
+{
+  uint64_t Period = (uint64_t)SysTick->LOAD + 1;
+  uint32_t LoadValue;
+  uint32_t Shorter;
+
+  /* HAL tick of 1mS */
+  LowPowerHalTickCounts += Counts;
+  uwTick += LowPowerHalTickCounts / (LOW_POWER_TIMER_FREQUENCY / 1000);
+  LowPowerHalTickCounts %= (LOW_POWER_TIMER_FREQUENCY / 1000);
+  HAL_ResumeTick();
+
+  /* The first period is shorter of the tick in progress and of the cycles
+     not counted at the stop (the SysTick reloads the period at the end of
+     it), so they are not lost */
+  LoadValue = SysTick->LOAD;
+  Shorter = (uint32_t)((Elapsed * Period) / LOW_POWER_TIMER_COUNTS_PER_TICK) + LowPowerTickFraction;
+  SysTick->LOAD = (Shorter < LoadValue) ? (LoadValue - Shorter) : 1U;
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  SysTick->LOAD = LoadValue;
+  if (Pend)
+  {
+    SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+  }
+}
+
+/**
+  * @brief  Start LPTIM1 in continuous mode (the ARRM interrupt wakes up the
+  *         MCU and the counter keeps counting the wake up from Stop 2)
+  * @param  Counts: Counts up to the interrupt (1..LOW_POWER_TIMER_MAX_COUNTS)
+  * @retval None
+  */
+static VOID LowPower_TimerStart(ULONG Counts)
+{
+  LL_LPTIM_Enable(LPTIM1);
+
+  LL_LPTIM_EnableIT_ARRM(LPTIM1);
+  while (LL_LPTIM_IsActiveFlag_DIEROK(LPTIM1) == 0U)
+  {
+  }
+  LL_LPTIM_ClearFlag_DIEROK(LPTIM1);
+
+  LL_LPTIM_SetAutoReload(LPTIM1, Counts);
+  while (LL_LPTIM_IsActiveFlag_ARROK(LPTIM1) == 0U)
+  {
+  }
+  LL_LPTIM_ClearFlag_ARROK(LPTIM1);
+
+  LL_LPTIM_StartCounter(LPTIM1, LL_LPTIM_OPERATING_MODE_CONTINUOUS);
+}
+
+/**
+  * @brief  Stop LPTIM1
+  * @param  None
+  * @retval Counts since LowPower_TimerStart
+  */
+static ULONG LowPower_TimerStop(VOID)
+{
+  ULONG Last;
+  ULONG Counts;
+
+  /* The tick restarts on one count (at most 125uS), so the time after the
+     last count is not lost */
+  Last = LowPower_TimerCounter();
+  do
+  {
+    Counts = LowPower_TimerCounter();
+  } while (Counts == Last);
+
+  /* After the ARRM interrupt the counter restarts from 0 */
+  if (LL_LPTIM_IsActiveFlag_ARRM(LPTIM1) != 0U)
+  {
+    if (Counts < LL_LPTIM_GetAutoReload(LPTIM1))
+    {
+      Counts += LL_LPTIM_GetAutoReload(LPTIM1) + 1U;
+    }
+    LL_LPTIM_ClearFlag_ARRM(LPTIM1);
+  }
+
+  LL_LPTIM_Disable(LPTIM1);
+  HAL_NVIC_ClearPendingIRQ(LPTIM1_IRQn);
+
+  return Counts;
+}
+
+/**
+  * @brief  Read the counter of LPTIM1
+  * @param  None
+  * @retval Counter
+  */
+static ULONG LowPower_TimerCounter(VOID)
+{
+  ULONG Counts;
+
+  /* The counter is asynchronous: two reads with the same value */
+  do
+  {
+    Counts = LL_LPTIM_GetCounter(LPTIM1);
+  } while (Counts != LL_LPTIM_GetCounter(LPTIM1));
+
+  return Counts;
+}
+
+/**
+  * @brief  Sleep mode: any interrupt wakes up the MCU in a few cycles
+  * @param  None
+  * @retval None
+  */
+static VOID LowPower_Sleep(VOID)
+{
+  HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+}
+
+/**
+  * @brief  Stop 2 mode up to LPTIM1 or one EXTI interrupt (user button)
+  * @param  None
+  * @retval None
+  */
+static VOID LowPower_Stop(VOID)
+{
+  /* SystemClock_Config disables the PWR clock */
+  __HAL_RCC_PWR_CLK_ENABLE();
+  HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFI);
+
+  /* The MCU restarts on MSI: clocks of the Run mode */
+  SystemClock_Config();
+}
+#endif /* STBOX1_LOW_POWER_IDLE */
 /* USER CODE END 1 */
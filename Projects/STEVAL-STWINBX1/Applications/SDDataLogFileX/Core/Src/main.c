@@ -50,6 +50,7 @@
 #include <stdio.h>
 #include "STWIN.box_env_sensors.h"
 #include "STWIN.box_motion_sensors.h"
+#include "thread_profiler.h"
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
@@ -358,7 +359,12 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
-
+#ifdef STBOX1_THREAD_PROFILER
+  if (htim->Instance == TIM6) {
+    /* Sample of the thread running at the HAL tick (lowest priority) */
+    ThreadProfiler_Sample();
+  }
+#endif /* STBOX1_THREAD_PROFILER */
   /* USER CODE END Callback 1 */
 }
 
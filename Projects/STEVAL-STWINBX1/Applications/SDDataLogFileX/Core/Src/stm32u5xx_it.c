@@ -23,6 +23,7 @@
 #include "stm32u5xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 #include "fx_stm32_sd_driver.h"
+#include "stm32u5xx_ll_lptim.h"
 #include "STWIN.box_audio.h"
 
 
@@ -148,8 +149,21 @@ void TIM6_IRQHandler(void)
 /* USER CODE BEGIN 1 */
 void SDMMC1_IRQHandler(void)
 {
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+  /* End of the card busy (not handled by the HAL) */
+  fx_stm32_sd_card_irq(FX_STM32_SD_INSTANCE);
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
   BSP_SD_IRQHandler(FX_STM32_SD_INSTANCE);
 }
+
+/**
+  * @brief This function handles LPTIM1 global interrupt (wake up from the
+  *        Stop 2 mode of the ThreadX idle, see app_threadx.c).
+  */
+void LPTIM1_IRQHandler(void)
+{
+  LL_LPTIM_ClearFlag_ARRM(LPTIM1);
+}
 /* USER CODE END 1 */
 
 /**
@@ -161,6 +175,15 @@ void EXTI0_IRQHandler(void)
   HAL_EXTI_IRQHandler(&H_EXTI_0);
 }
 
+/**
+  * @brief This function handles EXTI line8 interrupts.
+  */
+void EXTI8_IRQHandler(void)
+{
+  /* ISM330DHCX INT1 (FIFO watermark with STBOX1_IMU_FIFO) */
+  HAL_EXTI_IRQHandler(&H_EXTI_8);
+}
+
 /**
 * @brief This function handles MDF DMA interrupt request.
 * @param None
@@ -217,7 +217,8 @@ extern EXTI_HandleTypeDef                       hexti13;
 #define BSP_GPO_CLK_ENABLE()                    __HAL_RCC_GPIOB_CLK_ENABLE()
 #define BSP_GPO_EXTI_IRQHANDLER                 EXTI13_IRQHandler
 
-/* Analog and digital mics */
+/* Analog and digital mics (with both of them enabled the audio log has two
+   synchronized channels: digital mic on the left, analog mic on the right) */
 #define ONBOARD_ANALOG_MIC          0
 #define ONBOARD_DIGITAL_MIC         1
 
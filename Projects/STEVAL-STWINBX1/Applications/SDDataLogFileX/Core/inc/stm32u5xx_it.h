@@ -35,7 +35,9 @@ void UsageFault_Handler(void);
 void DebugMon_Handler(void);
 void TIM6_IRQHandler(void);
 void EXTI0_IRQHandler(void);
+void EXTI8_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void LPTIM1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
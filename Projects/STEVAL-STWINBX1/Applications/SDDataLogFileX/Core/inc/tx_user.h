@@ -220,4 +220,28 @@
 
 /*#define TX_SAFETY_CRITICAL*/
 
+/* Define the low power hooks of the ThreadX low power utility (tx_low_power.c). The scheduler
+   calls tx_low_power_enter/tx_low_power_exit when no thread is ready because TX_LOW_POWER is
+   defined for the assembler (tx_thread_schedule) in the projects. The hooks are in app_threadx.c
+   and they do nothing without STBOX1_LOW_POWER_IDLE (STBOX1_config.h).  */
+
+/* Define a macro that sets up a low power clock and keep track of time */
+void App_ThreadX_LowPower_Timer_Setup(unsigned long count);
+#define TX_LOW_POWER_TIMER_SETUP(_count) App_ThreadX_LowPower_Timer_Setup(_count)
+
+/* Define the TX_LOW_POWER_TICKLESS to disable the internal ticks */
+/*#define TX_LOW_POWER_TICKLESS*/
+
+/* A user defined macro to make the system enter low power mode */
+void App_ThreadX_LowPower_Enter(void);
+#define TX_LOW_POWER_USER_ENTER App_ThreadX_LowPower_Enter()
+
+/* A user defined macro to make the system exit low power mode */
+void App_ThreadX_LowPower_Exit(void);
+#define TX_LOW_POWER_USER_EXIT App_ThreadX_LowPower_Exit()
+
+/* User's low-power macro to obtain the amount of time (in ticks) the system has been in low power mode */
+unsigned long App_ThreadX_LowPower_Timer_Adjust(void);
+#define TX_LOW_POWER_USER_TIMER_ADJUST App_ThreadX_LowPower_Timer_Adjust()
+
 #endif
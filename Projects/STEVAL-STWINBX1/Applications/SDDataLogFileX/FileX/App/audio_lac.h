@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\audio_lac.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Lossless audio compression (fixed linear predictor + Rice coding)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __AUDIO_LAC_H__
+#define __AUDIO_LAC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* MicXXX.lac file layout (little-endian):
+   - one AUDIO_LAC_HEADER_SIZE bytes header:
+       "STBOXLAC" magic, version, header size, sampling frequency, channels,
+       bits for sample, frame samples, partition samples, total samples
+   - the frames up to the end of the file, each one made by:
+       sync, number of samples, method, predictor order, payload size
+       and the payload:
+       AUDIO_LAC_METHOD_VERBATIM: the 16 bit samples
+       AUDIO_LAC_METHOD_FIXED: Order 16 bit warm-up samples followed by the
+       Rice coded residuals (MSB first bit stream), one 5 bit Rice parameter
+       at the beginning of each partition */
+#define AUDIO_LAC_MAGIC              "STBOXLAC"
+#define AUDIO_LAC_VERSION            1
+#define AUDIO_LAC_HEADER_SIZE        32
+#define AUDIO_LAC_TOTAL_SAMPLES_POS  24
+
+#define AUDIO_LAC_FRAME_SYNC         0xF1ACU
+#define AUDIO_LAC_FRAME_HEADER_SIZE  8
+
+#define AUDIO_LAC_METHOD_VERBATIM    0
+#define AUDIO_LAC_METHOD_FIXED       1
+
+/* Max order of the fixed predictor */
+#define AUDIO_LAC_MAX_ORDER          3
+
+/* Samples of one frame (one frame is encoded with one single predictor) */
+#ifndef AUDIO_LAC_FRAME_SAMPLES
+  #define AUDIO_LAC_FRAME_SAMPLES    1024
+#endif /* AUDIO_LAC_FRAME_SAMPLES */
+
+/* Residuals sharing the same Rice parameter */
+#define AUDIO_LAC_PARTITION_SAMPLES  128
+
+#define AUDIO_LAC_RICE_BITS          5
+
+/* Worst case size of one encoded frame (verbatim) */
+#define AUDIO_LAC_FRAME_MAX_SIZE     (AUDIO_LAC_FRAME_HEADER_SIZE + AUDIO_LAC_FRAME_SAMPLES * 2)
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  /* Folded residuals of the frame that it's encoded */
+  uint32_t Residual[AUDIO_LAC_FRAME_SAMPLES];
+  /* Statistics */
+  uint32_t Frames;
+  uint32_t VerbatimFrames;
+  uint32_t Samples;
+  uint32_t Bytes;
+} AudioLac_Encoder_T;
+
+/* Exported functions --------------------------------------------------------*/
+void AudioLac_Init(AudioLac_Encoder_T *Encoder);
+void AudioLac_HeaderInit(uint8_t *pHeader, uint32_t SampleRate);
+void AudioLac_HeaderUpdate(uint8_t *pHeader, uint32_t TotalSamples);
+uint32_t AudioLac_EncodeFrame(AudioLac_Encoder_T *Encoder, const int16_t *pIn, uint32_t Samples, uint8_t *pOut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AUDIO_LAC_H__ */
@@ -89,14 +89,45 @@
 
 /* #define FX_ENABLE_EXFAT */
 
-/* Defined, enables FileX fault tolerant service.  */
+/* Defined only when STBOX1_FX_EXFAT is enabled inside STBOX1_config.h (see the
+   exFAT licensing above).  */
+
+#include "STBOX1_config.h"
+#ifdef STBOX1_FX_EXFAT
+#define FX_ENABLE_EXFAT
+#endif /* STBOX1_FX_EXFAT */
+
+/* Defined, enables FileX fault tolerant service (needed by STBOX1_LOG_CHECKPOINT).  */
 
 /* #define FX_ENABLE_FAULT_TOLERANT */
 
 /* Defines the size in bytes of the bit map used to update the secondary FAT sectors.
    The larger the value the less unnecessary secondary FAT sector writes.   */
 
-/* #define FX_FAT_MAP_SIZE         128 */
+#define FX_FAT_MAP_SIZE         256
+
+/* Defined, one map of the free clusters of each group of FAT12/16/32 media is kept in RAM, so the
+   allocations skip the groups without free clusters instead of reading all their FAT entries.
+   The map is built by fx_media_open when the FAT is scanned, otherwise the searches mark the full groups.  */
+
+/* #define FX_ENABLE_FAT_FREE_MAP */
+
+/* Defines the number of groups (2 Bytes each) of the free cluster map: each group has the smallest
+   power of 2 clusters that covers the whole FAT. By default the value is 1024.  */
+
+/* #define FX_FAT_FREE_MAP_SIZE    1024 */
+
+/* Defined, the names of one large directory of FAT12/16/32 media are kept in one hash index in RAM,
+   so fx_file_open, fx_file_create and fx_file_delete read only the directory entries of the matching
+   names instead of all the entries. The directory is indexed after one search of at least 64 entries.  */
+
+/* #define FX_ENABLE_DIRECTORY_HASH */
+
+/* Defines the number of slots (4 Bytes each) of the directory hash index, a power of 2: each long
+   name takes 2 slots (long and short name) and the index is full at 3/4 of the slots, larger
+   directories are searched linearly. By default the value is 4096 (1536 long names).  */
+
+/* #define FX_DIRECTORY_HASH_SIZE  4096 */
 
 /* Defined, data sector write requests are flushed immediately to the driver.  */
 
@@ -113,7 +144,7 @@
 
 /* Defines the number of entries in the FAT cache.  */
 
-/* #define FX_MAX_FAT_CACHE         16 */
+#define FX_MAX_FAT_CACHE         64
 
 /* Defines the maximum size of long file names supported by FileX.
    The minimum value is 13 and the maximum value is 256.  */
@@ -127,7 +158,7 @@
 /* Defines the maximum number of logical sectors that can be cached by FileX. The cache memory
    supplied to FileX at fx_media_open determines how many sectors can actually be cached.  */
 
-/* #define FX_MAX_SECTOR_CACHE         256 */
+#define FX_MAX_SECTOR_CACHE         64
 
 /* Defined, the file search cache optimization is disabled.  */
 
@@ -0,0 +1,421 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_checkpoint.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Log checkpoints and recovery of the log not closed
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "log_checkpoint.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Max bytes searched for the 'data' chunk of one .wav file */
+#define WAV_DATA_SEARCH_SIZE  4096
+
+/* Private function prototypes -----------------------------------------------*/
+static void Serialize(const LogCheckpoint_T *Ckpt, UCHAR *pRecord);
+static int Parse(const UCHAR *pRecord, LogCheckpoint_T *Ckpt);
+static UINT Repair(FX_MEDIA *Media, FX_FILE *File, CHAR *Name, ULONG64 Size, LogCheckpoint_T *Ckpt);
+static UINT WavRepair(FX_FILE *File, ULONG64 *Size);
+static uint32_t Crc32(const UCHAR *p, uint32_t Size);
+static inline void PutU16(UCHAR *p, uint16_t v);
+static inline void PutU32(UCHAR *p, uint32_t v);
+static inline void PutU64(UCHAR *p, ULONG64 v);
+static inline uint16_t GetU16(const UCHAR *p);
+static inline uint32_t GetU32(const UCHAR *p);
+static inline ULONG64 GetU64(const UCHAR *p);
+
+/**
+* @brief  Reset the checkpoint (no files)
+* @param  Ckpt: Checkpoint
+* @retval None
+*/
+void LogCheckpoint_Init(LogCheckpoint_T *Ckpt)
+{
+  memset(Ckpt, 0, sizeof(LogCheckpoint_T));
+}
+
+/**
+* @brief  Write one checkpoint record on the slot not used by the last one.
+*         The first two records fill both the slots of one new file.
+*         The record is on the media only after one fx_media_flush
+* @param  File: Checkpoint file (opened for writing)
+* @param  Ckpt: Checkpoint
+* @param  pRecord: LOG_CHECKPOINT_RECORD_SIZE bytes buffer
+* @retval FX_SUCCESS or the FileX error
+*/
+UINT LogCheckpoint_Write(FX_FILE *File, LogCheckpoint_T *Ckpt, UCHAR *pRecord)
+{
+  UINT status;
+
+  Serialize(Ckpt, pRecord);
+
+  status = fx_file_extended_seek(File, (ULONG64)(Ckpt->Sequence & 1) * LOG_CHECKPOINT_RECORD_SIZE);
+  if (status == FX_SUCCESS) {
+    status = fx_file_write(File, pRecord, LOG_CHECKPOINT_RECORD_SIZE);
+  }
+
+  Ckpt->Sequence++;
+
+  return status;
+}
+
+/**
+* @brief  Read the last checkpoint and, if the log was not closed, repair
+*         its files: the data saved after the checkpoint and the clusters
+*         reserved and not used are removed, the .wav headers are updated
+*         and the next segments created in advance are deleted
+* @param  Media: FileX media
+* @param  File: FileX file not used
+* @param  Name: Checkpoint file name
+* @param  Ckpt: Checkpoint found (Open is 0 if there was nothing to repair)
+* @param  pRecords: 2 * LOG_CHECKPOINT_RECORD_SIZE bytes buffer
+* @retval FX_SUCCESS or the FileX error
+*/
+UINT LogCheckpoint_Recover(FX_MEDIA *Media, FX_FILE *File, CHAR *Name, LogCheckpoint_T *Ckpt, UCHAR *pRecords)
+{
+  LogCheckpoint_T Slot;
+  ULONG Actual = 0;
+  UINT status;
+  uint32_t Index;
+  int Found = 0;
+
+  LogCheckpoint_Init(Ckpt);
+
+  status = fx_file_open(Media, File, Name, FX_OPEN_FOR_READ);
+  if (status == FX_NOT_FOUND) {
+    /* Never used */
+    return FX_SUCCESS;
+  } else if (status != FX_SUCCESS) {
+    return status;
+  }
+
+  status = fx_file_read(File, pRecords, 2 * LOG_CHECKPOINT_RECORD_SIZE, &Actual);
+  fx_file_close(File);
+  if ((status != FX_SUCCESS) && (status != FX_END_OF_FILE)) {
+    return status;
+  }
+
+  /* The last record with one good CRC */
+  for (Index = 0; Index < 2; Index++) {
+    if ((Actual >= ((Index + 1) * LOG_CHECKPOINT_RECORD_SIZE)) &&
+        Parse(pRecords + Index * LOG_CHECKPOINT_RECORD_SIZE, &Slot) &&
+        ((!Found) || ((int32_t)(Slot.Sequence - Ckpt->Sequence) > 0))) {
+      *Ckpt = Slot;
+      Found = 1;
+    }
+  }
+
+  if ((!Found) || (!Ckpt->Open)) {
+    Ckpt->Open = 0;
+    return FX_SUCCESS;
+  }
+
+  status = FX_SUCCESS;
+  for (Index = 0; (Index < LOG_CHECKPOINT_MAX_FILES) && (status == FX_SUCCESS); Index++) {
+    LogCheckpoint_File_T *Log = &Ckpt->Files[Index];
+
+    status = Repair(Media, File, Log->PrevName, Log->PrevSize, Ckpt);
+    if (status == FX_SUCCESS) {
+      status = Repair(Media, File, Log->Name, Log->Size, Ckpt);
+    }
+    if ((status == FX_SUCCESS) && (Log->NextName[0] != '\0')) {
+      status = fx_file_delete(Media, Log->NextName);
+      if (status == FX_NOT_FOUND) {
+        status = FX_SUCCESS;
+      }
+    }
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Cut one log file at the size of the checkpoint
+* @param  Media: FileX media
+* @param  File: FileX file not used
+* @param  Name: Log file name ("" if not used)
+* @param  Size: Bytes saved at the checkpoint
+* @param  Ckpt: Checkpoint (recovery results)
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Repair(FX_MEDIA *Media, FX_FILE *File, CHAR *Name, ULONG64 Size, LogCheckpoint_T *Ckpt)
+{
+  UINT status;
+
+  if (Name[0] == '\0') {
+    return FX_SUCCESS;
+  }
+
+  status = fx_file_open(Media, File, Name, FX_OPEN_FOR_WRITE);
+  if (status == FX_NOT_FOUND) {
+    return FX_SUCCESS;
+  } else if (status != FX_SUCCESS) {
+    return status;
+  }
+
+  /* The data after the checkpoint could be not complete */
+  if (Size > File->fx_file_current_file_size) {
+    Size = File->fx_file_current_file_size;
+  }
+
+  status = WavRepair(File, &Size);
+
+  if (status == FX_SUCCESS) {
+    Ckpt->Discarded += File->fx_file_current_file_size - Size;
+
+    /* Release also all the clusters reserved in advance */
+    status = fx_file_extended_truncate_release(File, Size);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(File);
+    Ckpt->Repaired++;
+  } else {
+    fx_file_close(File);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Update the sizes of the header of one .wav file (nothing for the other files)
+* @param  File: Log file
+* @param  Size: File size (rounded to whole samples)
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT WavRepair(FX_FILE *File, ULONG64 *Size)
+{
+  UCHAR Chunk[12];
+  ULONG Actual;
+  ULONG64 Position = 12;
+  UINT status;
+
+  status = fx_file_extended_seek(File, 0);
+  if (status == FX_SUCCESS) {
+    status = fx_file_read(File, Chunk, 12, &Actual);
+  }
+
+  if ((status != FX_SUCCESS) || (Actual != 12) ||
+      (memcmp(Chunk, "RIFF", 4) != 0) || (memcmp(Chunk + 8, "WAVE", 4) != 0)) {
+    /* Not one .wav file */
+    return FX_SUCCESS;
+  }
+
+  /* Look for the 'data' chunk */
+  while ((Position + 8) <= *Size) {
+    status = fx_file_extended_seek(File, Position);
+    if (status == FX_SUCCESS) {
+      status = fx_file_read(File, Chunk, 8, &Actual);
+    }
+    if ((status != FX_SUCCESS) || (Actual != 8)) {
+      return status;
+    }
+
+    if (memcmp(Chunk, "data", 4) == 0) {
+      ULONG64 DataSize = (*Size - Position - 8) & ~1ULL;
+
+      *Size = Position + 8 + DataSize;
+
+      PutU32(Chunk, (uint32_t)DataSize);
+      status = fx_file_extended_seek(File, Position + 4);
+      if (status == FX_SUCCESS) {
+        status = fx_file_write(File, Chunk, 4);
+      }
+
+      PutU32(Chunk, (uint32_t)(*Size - 8));
+      if (status == FX_SUCCESS) {
+        status = fx_file_extended_seek(File, 4);
+      }
+      if (status == FX_SUCCESS) {
+        status = fx_file_write(File, Chunk, 4);
+      }
+      return status;
+    }
+
+    Position += 8 + GetU32(Chunk + 4) + (GetU32(Chunk + 4) & 1);
+    if (Position > WAV_DATA_SEARCH_SIZE) {
+      break;
+    }
+  }
+
+  return FX_SUCCESS;
+}
+
+/**
+* @brief  Fill one checkpoint record
+* @param  Ckpt: Checkpoint
+* @param  pRecord: LOG_CHECKPOINT_RECORD_SIZE bytes to fill
+* @retval None
+*/
+static void Serialize(const LogCheckpoint_T *Ckpt, UCHAR *pRecord)
+{
+  UCHAR *Descriptor = pRecord + LOG_CHECKPOINT_FILES_POS;
+  uint32_t Index;
+
+  memset(pRecord, 0, LOG_CHECKPOINT_RECORD_SIZE);
+  memcpy(pRecord, LOG_CHECKPOINT_MAGIC, 8);
+  PutU16(pRecord + 8, LOG_CHECKPOINT_VERSION);
+  PutU16(pRecord + 10, LOG_CHECKPOINT_RECORD_SIZE);
+  PutU32(pRecord + 12, Ckpt->Sequence);
+  PutU32(pRecord + 16, Ckpt->Time);
+  pRecord[20] = Ckpt->Open;
+  pRecord[21] = LOG_CHECKPOINT_MAX_FILES;
+
+  for (Index = 0; Index < LOG_CHECKPOINT_MAX_FILES; Index++) {
+    const LogCheckpoint_File_T *Log = &Ckpt->Files[Index];
+
+    strncpy((char *)Descriptor, Log->Name, LOG_CHECKPOINT_NAME_SIZE - 1);
+    PutU64(Descriptor + 32, Log->Size);
+    strncpy((char *)Descriptor + 40, Log->PrevName, LOG_CHECKPOINT_NAME_SIZE - 1);
+    PutU64(Descriptor + 72, Log->PrevSize);
+    strncpy((char *)Descriptor + 80, Log->NextName, LOG_CHECKPOINT_NAME_SIZE - 1);
+    Descriptor += LOG_CHECKPOINT_FILE_SIZE;
+  }
+
+  PutU32(pRecord + LOG_CHECKPOINT_CRC_POS, Crc32(pRecord, LOG_CHECKPOINT_CRC_POS));
+}
+
+/**
+* @brief  Read one checkpoint record
+* @param  pRecord: LOG_CHECKPOINT_RECORD_SIZE bytes
+* @param  Ckpt: Checkpoint to fill
+* @retval 1 if the record is valid, 0 otherwise
+*/
+static int Parse(const UCHAR *pRecord, LogCheckpoint_T *Ckpt)
+{
+  const UCHAR *Descriptor = pRecord + LOG_CHECKPOINT_FILES_POS;
+  uint32_t Index;
+
+  if ((memcmp(pRecord, LOG_CHECKPOINT_MAGIC, 8) != 0) ||
+      (GetU16(pRecord + 8) != LOG_CHECKPOINT_VERSION) ||
+      (GetU16(pRecord + 10) != LOG_CHECKPOINT_RECORD_SIZE) ||
+      (pRecord[21] > LOG_CHECKPOINT_MAX_FILES) ||
+      (GetU32(pRecord + LOG_CHECKPOINT_CRC_POS) != Crc32(pRecord, LOG_CHECKPOINT_CRC_POS))) {
+    return 0;
+  }
+
+  LogCheckpoint_Init(Ckpt);
+  Ckpt->Sequence = GetU32(pRecord + 12);
+  Ckpt->Time = GetU32(pRecord + 16);
+  Ckpt->Open = pRecord[20];
+
+  for (Index = 0; Index < pRecord[21]; Index++) {
+    LogCheckpoint_File_T *Log = &Ckpt->Files[Index];
+
+    memcpy(Log->Name, Descriptor, LOG_CHECKPOINT_NAME_SIZE - 1);
+    Log->Size = GetU64(Descriptor + 32);
+    memcpy(Log->PrevName, Descriptor + 40, LOG_CHECKPOINT_NAME_SIZE - 1);
+    Log->PrevSize = GetU64(Descriptor + 72);
+    memcpy(Log->NextName, Descriptor + 80, LOG_CHECKPOINT_NAME_SIZE - 1);
+    Descriptor += LOG_CHECKPOINT_FILE_SIZE;
+  }
+
+  return 1;
+}
+
+/**
+* @brief  CRC-32 (IEEE 802.3) of one buffer
+* @param  p: Data
+* @param  Size: Number of bytes
+* @retval CRC
+*/
+static uint32_t Crc32(const UCHAR *p, uint32_t Size)
+{
+  uint32_t Crc = 0xFFFFFFFFU;
+  uint32_t Bit;
+
+  while (Size-- > 0) {
+    Crc ^= *p++;
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ (0xEDB88320U & (0U - (Crc & 1U)));
+    }
+  }
+
+  return ~Crc;
+}
+
+/**
+* @brief  Write one 16 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU16(UCHAR *p, uint16_t v)
+{
+  p[0] = (UCHAR)v;
+  p[1] = (UCHAR)(v >> 8);
+}
+
+/**
+* @brief  Write one 32 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU32(UCHAR *p, uint32_t v)
+{
+  PutU16(p, (uint16_t)v);
+  PutU16(p + 2, (uint16_t)(v >> 16));
+}
+
+/**
+* @brief  Write one 64 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU64(UCHAR *p, ULONG64 v)
+{
+  PutU32(p, (uint32_t)v);
+  PutU32(p + 4, (uint32_t)(v >> 32));
+}
+
+/**
+* @brief  Read one 16 bit little-endian value
+* @param  p: Source
+* @retval Value
+*/
+static inline uint16_t GetU16(const UCHAR *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+* @brief  Read one 32 bit little-endian value
+* @param  p: Source
+* @retval Value
+*/
+static inline uint32_t GetU32(const UCHAR *p)
+{
+  return GetU16(p) | ((uint32_t)GetU16(p + 2) << 16);
+}
+
+/**
+* @brief  Read one 64 bit little-endian value
+* @param  p: Source
+* @retval Value
+*/
+static inline ULONG64 GetU64(const UCHAR *p)
+{
+  return GetU32(p) | ((ULONG64)GetU32(p + 4) << 32);
+}
@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_checkpoint.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Log checkpoints and recovery of the log not closed
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOG_CHECKPOINT_H__
+#define __LOG_CHECKPOINT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "fx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Checkpoint file layout (little-endian): two LOG_CHECKPOINT_RECORD_SIZE bytes
+   slots written alternately, so one record interrupted by a power loss never
+   overwrites the last good one. Each record is made by:
+     "STBOXCKP" magic, version, record size, sequence number, time of the log
+     (mS), open flag (0 when the log was closed), number of files and one
+     LOG_CHECKPOINT_FILE_SIZE bytes descriptor for each log file:
+       name and bytes saved at the checkpoint of the current file,
+       name and final size of the previous segment (closed in background),
+       name of the next segment (created in advance, empty)
+     and one CRC-32 of the record at the end */
+#define LOG_CHECKPOINT_MAGIC          "STBOXCKP"
+#define LOG_CHECKPOINT_VERSION        1
+#define LOG_CHECKPOINT_RECORD_SIZE    512
+#define LOG_CHECKPOINT_FILES_POS      24
+#define LOG_CHECKPOINT_FILE_SIZE      128
+#define LOG_CHECKPOINT_CRC_POS        (LOG_CHECKPOINT_RECORD_SIZE - 4)
+
+#define LOG_CHECKPOINT_NAME_SIZE      32
+#define LOG_CHECKPOINT_MAX_FILES      2
+
+/* Exported types ------------------------------------------------------------*/
+
+/* One log file (and its segments when the log is split) */
+typedef struct
+{
+  CHAR Name[LOG_CHECKPOINT_NAME_SIZE];      /* "" if not used */
+  ULONG64 Size;                             /* Bytes saved at the checkpoint */
+  CHAR PrevName[LOG_CHECKPOINT_NAME_SIZE];  /* "" if not present */
+  ULONG64 PrevSize;
+  CHAR NextName[LOG_CHECKPOINT_NAME_SIZE];  /* "" if not present */
+} LogCheckpoint_File_T;
+
+typedef struct
+{
+  uint32_t Sequence;
+  uint32_t Time;             /* mS from the log start */
+  uint8_t Open;              /* 0 when the log was closed */
+  LogCheckpoint_File_T Files[LOG_CHECKPOINT_MAX_FILES];
+  /* Recovery results */
+  uint32_t Repaired;         /* Files repaired */
+  ULONG64 Discarded;         /* Bytes saved after the checkpoint and removed */
+} LogCheckpoint_T;
+
+/* Exported functions --------------------------------------------------------*/
+void LogCheckpoint_Init(LogCheckpoint_T *Ckpt);
+UINT LogCheckpoint_Write(FX_FILE *File, LogCheckpoint_T *Ckpt, UCHAR *pRecord);
+UINT LogCheckpoint_Recover(FX_MEDIA *Media, FX_FILE *File, CHAR *Name, LogCheckpoint_T *Ckpt, UCHAR *pRecords);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_CHECKPOINT_H__ */
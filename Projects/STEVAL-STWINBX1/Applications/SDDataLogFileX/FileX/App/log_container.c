@@ -0,0 +1,195 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_container.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Multi-stream log container (time stamped chunks + index)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "log_container.h"
+
+/* Private function prototypes -----------------------------------------------*/
+static inline void PutU16(uint8_t *p, uint16_t v);
+static inline void PutU32(uint8_t *p, uint32_t v);
+static void IndexAdd(LogContainer_T *Log, uint64_t Offset, uint8_t StreamId, uint32_t Time);
+
+/**
+* @brief  Reset the index and the statistics
+* @param  Log: Container
+* @retval None
+*/
+void LogContainer_Init(LogContainer_T *Log)
+{
+  Log->IndexEntries = 0;
+  Log->IndexStride = 1;
+  Log->IndexSkip = 0;
+  Log->Chunks = 0;
+  Log->Bytes = LOG_CONTAINER_HEADER_SIZE;
+}
+
+/**
+* @brief  Initialize the file header (the index is still unknown)
+* @param  pHeader: LOG_CONTAINER_HEADER_SIZE bytes to fill
+* @param  TickFrequency: Time stamp ticks for second of the chunks
+* @param  Streams: Streams descriptors
+* @param  StreamsNumber: Number of streams (<= LOG_CONTAINER_MAX_STREAMS)
+* @retval None
+*/
+void LogContainer_HeaderInit(uint8_t *pHeader, uint32_t TickFrequency, const LogContainer_Stream_T *Streams, uint32_t StreamsNumber)
+{
+  uint8_t *Descriptor = pHeader + LOG_CONTAINER_STREAMS_POS;
+  uint32_t Index;
+
+  if (StreamsNumber > LOG_CONTAINER_MAX_STREAMS) {
+    StreamsNumber = LOG_CONTAINER_MAX_STREAMS;
+  }
+
+  memset(pHeader, 0, LOG_CONTAINER_HEADER_SIZE);
+  memcpy(pHeader, LOG_CONTAINER_MAGIC, 8);
+  PutU16(pHeader + 8, LOG_CONTAINER_VERSION);
+  PutU16(pHeader + 10, LOG_CONTAINER_HEADER_SIZE);
+  PutU16(pHeader + 12, (uint16_t)StreamsNumber);
+  PutU16(pHeader + 14, LOG_CONTAINER_CHUNK_HEADER_SIZE);
+  PutU32(pHeader + 16, TickFrequency);
+
+  for (Index = 0; Index < StreamsNumber; Index++) {
+    uint32_t Rate;
+
+    Descriptor[0] = Streams[Index].Id;
+    Descriptor[1] = Streams[Index].Type;
+    PutU16(Descriptor + 2, Streams[Index].RecordSize);
+    strncpy((char *)Descriptor + 4, Streams[Index].Name, 11);
+    PutU32(Descriptor + 16, Streams[Index].TickFrequency);
+    memcpy(&Rate, &Streams[Index].Rate, sizeof(Rate));
+    PutU32(Descriptor + 20, Rate);
+    Descriptor += LOG_CONTAINER_STREAM_SIZE;
+  }
+}
+
+/**
+* @brief  Update the number of chunks and the index position of the file header
+* @param  pHeader: File header
+* @param  Log: Container
+* @param  IndexOffset: File offset of the index chunk
+* @retval None
+*/
+void LogContainer_HeaderUpdate(uint8_t *pHeader, const LogContainer_T *Log, uint64_t IndexOffset)
+{
+  PutU32(pHeader + LOG_CONTAINER_CHUNKS_POS, Log->Chunks);
+  PutU32(pHeader + LOG_CONTAINER_INDEX_OFFSET_POS, (uint32_t)IndexOffset);
+  PutU32(pHeader + LOG_CONTAINER_INDEX_OFFSET_POS + 4, (uint32_t)(IndexOffset >> 32));
+}
+
+/**
+* @brief  Fill the header of one chunk and add the chunk to the index
+* @param  Log: Container
+* @param  pOut: LOG_CONTAINER_CHUNK_HEADER_SIZE bytes to fill
+* @param  Offset: File offset of the chunk
+* @param  StreamId: Stream of the chunk
+* @param  Time: Time stamp of the first record
+* @param  Count: Number of records (or samples)
+* @param  Size: Payload size in bytes
+* @retval Size of the chunk header in bytes
+*/
+uint32_t LogContainer_ChunkHeader(LogContainer_T *Log, uint8_t *pOut, uint64_t Offset, uint8_t StreamId,
+                                  uint32_t Time, uint32_t Count, uint32_t Size)
+{
+  PutU16(pOut, LOG_CONTAINER_CHUNK_SYNC);
+  pOut[2] = StreamId;
+  pOut[3] = 0;
+  PutU32(pOut + 4, Size);
+  PutU32(pOut + 8, Time);
+  PutU32(pOut + 12, Count);
+
+  /* The index chunk doesn't index itself */
+  if (StreamId != LOG_CONTAINER_STREAM_INDEX) {
+    IndexAdd(Log, Offset, StreamId, Time);
+    Log->Chunks++;
+  }
+  Log->Bytes += LOG_CONTAINER_CHUNK_HEADER_SIZE + Size;
+
+  return LOG_CONTAINER_CHUNK_HEADER_SIZE;
+}
+
+/**
+* @brief  Add one chunk to the index (one chunk every IndexStride)
+* @param  Log: Container
+* @param  Offset: File offset of the chunk
+* @param  StreamId: Stream of the chunk
+* @param  Time: Time stamp of the chunk
+* @retval None
+*/
+static void IndexAdd(LogContainer_T *Log, uint64_t Offset, uint8_t StreamId, uint32_t Time)
+{
+  uint8_t *Entry;
+
+  if (Log->IndexSkip > 0) {
+    Log->IndexSkip--;
+    return;
+  }
+
+  if (Log->IndexEntries == LOG_CONTAINER_INDEX_ENTRIES) {
+    uint32_t Index;
+
+    /* Index full: keep the even entries and double the stride
+       (this chunk is still on the new stride) */
+    for (Index = 0; Index < (LOG_CONTAINER_INDEX_ENTRIES / 2); Index++) {
+      memmove(Log->Index + Index * LOG_CONTAINER_INDEX_ENTRY_SIZE,
+              Log->Index + 2 * Index * LOG_CONTAINER_INDEX_ENTRY_SIZE,
+              LOG_CONTAINER_INDEX_ENTRY_SIZE);
+    }
+    Log->IndexEntries = LOG_CONTAINER_INDEX_ENTRIES / 2;
+    Log->IndexStride *= 2;
+  }
+
+  Entry = Log->Index + Log->IndexEntries * LOG_CONTAINER_INDEX_ENTRY_SIZE;
+  PutU32(Entry, (uint32_t)Offset);
+  PutU32(Entry + 4, (uint32_t)(Offset >> 32));
+  PutU32(Entry + 8, Time);
+  Entry[12] = StreamId;
+  Entry[13] = 0;
+  Entry[14] = 0;
+  Entry[15] = 0;
+  Log->IndexEntries++;
+  Log->IndexSkip = Log->IndexStride - 1;
+}
+
+/**
+* @brief  Write one 16 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+/**
+* @brief  Write one 32 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU32(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
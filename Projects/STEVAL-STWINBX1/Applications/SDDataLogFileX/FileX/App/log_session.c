@@ -0,0 +1,375 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_session.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Session index and session directories of the log files
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "log_session.h"
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Name of one directory entry read while rebuilding the index */
+static CHAR EntryName[FX_MAX_LONG_NAME_LEN];
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT Scan(FX_MEDIA *Media, LogSession_T *Session);
+static int ParseNumber(const CHAR *Name, const CHAR *Prefix, uint32_t *Number);
+static void Serialize(const LogSession_T *Session, UCHAR *pRecord);
+static int Parse(const UCHAR *pRecord, LogSession_T *Session);
+static uint32_t Crc32(const UCHAR *p, uint32_t Size);
+static inline void PutU16(UCHAR *p, uint16_t v);
+static inline void PutU32(UCHAR *p, uint32_t v);
+static inline uint16_t GetU16(const UCHAR *p);
+static inline uint32_t GetU32(const UCHAR *p);
+
+/**
+* @brief  Name of one log file with the directory of its session (Logs000/Sens000.csv)
+* @param  Name: File name to be filled
+* @param  Format: File name format with the session number
+* @param  Session: Session number
+* @param  DirSize: Sessions for each directory
+* @retval None
+*/
+void LogSession_FileName(CHAR *Name, const CHAR *Format, uint32_t Session, uint32_t DirSize)
+{
+  sprintf(Name, LOG_SESSION_DIR_NAME "/", (int)(Session / DirSize));
+  sprintf(Name + strlen(Name), Format, (int)Session);
+}
+
+/**
+* @brief  Create one log file and, for the first session, its directory
+* @param  Media: FileX media
+* @param  Name: File name (Logs000/Sens000.csv)
+* @retval FX_SUCCESS or the FileX error (FX_ALREADY_CREATED if the file is present)
+*/
+UINT LogSession_FileCreate(FX_MEDIA *Media, CHAR *Name)
+{
+  CHAR *Separator;
+  UINT status;
+
+  status = fx_file_create(Media, Name);
+
+  /* The directory is not present */
+  if (status == FX_INVALID_PATH) {
+    Separator = strrchr(Name, '/');
+    if (Separator != NULL) {
+      *Separator = 0;
+      status = fx_directory_create(Media, Name);
+      *Separator = '/';
+
+      if (status == FX_SUCCESS) {
+        status = fx_file_create(Media, Name);
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+* @brief  Read the next free session from the index file. If the index is
+*         missing or not valid, it's rebuilt with one scan of the root
+*         directory and of the last session directory
+* @param  Media: FileX media
+* @param  File: FileX file not used
+* @param  Name: Index file name
+* @param  Session: Index (DirSize must be set by the caller)
+* @retval FX_SUCCESS or the FileX error
+*/
+UINT LogSession_Read(FX_MEDIA *Media, FX_FILE *File, CHAR *Name, LogSession_T *Session)
+{
+  UCHAR Record[LOG_SESSION_RECORD_SIZE];
+  ULONG Size = 0;
+  UINT status;
+
+  status = fx_file_open(Media, File, Name, FX_OPEN_FOR_READ);
+  if (status == FX_SUCCESS) {
+    status = fx_file_read(File, Record, LOG_SESSION_RECORD_SIZE, &Size);
+    fx_file_close(File);
+  }
+
+  if ((status == FX_SUCCESS) && (Size == LOG_SESSION_RECORD_SIZE) && Parse(Record, Session)) {
+    Session->Scanned = 0;
+    return FX_SUCCESS;
+  }
+
+  return Scan(Media, Session);
+}
+
+/**
+* @brief  Save the next free session on the index file
+* @param  Media: FileX media
+* @param  File: FileX file not used
+* @param  Name: Index file name
+* @param  Session: Index
+* @retval FX_SUCCESS or the FileX error
+*/
+UINT LogSession_Write(FX_MEDIA *Media, FX_FILE *File, CHAR *Name, LogSession_T *Session)
+{
+  UCHAR Record[LOG_SESSION_RECORD_SIZE];
+  UINT status;
+
+  Serialize(Session, Record);
+
+  status = fx_file_create(Media, Name);
+  if ((status != FX_SUCCESS) && (status != FX_ALREADY_CREATED)) {
+    return status;
+  }
+
+  status = fx_file_open(Media, File, Name, FX_OPEN_FOR_WRITE);
+  if (status != FX_SUCCESS) {
+    return status;
+  }
+
+  status = fx_file_seek(File, 0);
+  if (status == FX_SUCCESS) {
+    status = fx_file_write(File, Record, LOG_SESSION_RECORD_SIZE);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(File);
+  } else {
+    fx_file_close(File);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Rebuild the index: the last session is searched only on the
+*         session directory with the highest number
+* @param  Media: FileX media
+* @param  Session: Index to fill
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Scan(FX_MEDIA *Media, LogSession_T *Session)
+{
+  CHAR DirName[16];
+  UINT Attributes;
+  UINT status;
+  uint32_t Number;
+  uint32_t LastDir = 0;
+  uint32_t LastSession = 0;
+  int DirFound = 0;
+  int SessionFound = 0;
+
+  Session->Next = 0;
+  Session->Scanned = 0;
+
+  /* Last session directory */
+  status = fx_directory_default_set(Media, (CHAR *)"/");
+  if (status != FX_SUCCESS) {
+    return status;
+  }
+
+  status = fx_directory_first_full_entry_find(Media, EntryName, &Attributes, FX_NULL,
+                                              FX_NULL, FX_NULL, FX_NULL, FX_NULL, FX_NULL, FX_NULL);
+  while (status == FX_SUCCESS) {
+    Session->Scanned++;
+    if ((Attributes & FX_DIRECTORY) && ParseNumber(EntryName, LOG_SESSION_DIR_PREFIX, &Number) &&
+        ((!DirFound) || (Number > LastDir))) {
+      LastDir = Number;
+      DirFound = 1;
+    }
+    status = fx_directory_next_full_entry_find(Media, EntryName, &Attributes, FX_NULL,
+                                               FX_NULL, FX_NULL, FX_NULL, FX_NULL, FX_NULL, FX_NULL);
+  }
+
+  if (status != FX_NO_MORE_ENTRIES) {
+    return status;
+  }
+
+  if (!DirFound) {
+    return FX_SUCCESS;
+  }
+
+  /* Last session saved on that directory */
+  sprintf(DirName, LOG_SESSION_DIR_NAME, (int)LastDir);
+  status = fx_directory_default_set(Media, DirName);
+  if (status != FX_SUCCESS) {
+    return status;
+  }
+
+  status = fx_directory_first_full_entry_find(Media, EntryName, &Attributes, FX_NULL,
+                                              FX_NULL, FX_NULL, FX_NULL, FX_NULL, FX_NULL, FX_NULL);
+  while (status == FX_SUCCESS) {
+    Session->Scanned++;
+    if (((Attributes & FX_DIRECTORY) == 0) && ParseNumber(EntryName, FX_NULL, &Number) &&
+        ((!SessionFound) || (Number > LastSession))) {
+      LastSession = Number;
+      SessionFound = 1;
+    }
+    status = fx_directory_next_full_entry_find(Media, EntryName, &Attributes, FX_NULL,
+                                               FX_NULL, FX_NULL, FX_NULL, FX_NULL, FX_NULL, FX_NULL);
+  }
+
+  fx_directory_default_set(Media, (CHAR *)"/");
+
+  if (status != FX_NO_MORE_ENTRIES) {
+    return status;
+  }
+
+  Session->Next = SessionFound ? (LastSession + 1) : (LastDir * Session->DirSize);
+
+  return FX_SUCCESS;
+}
+
+/**
+* @brief  Session number of one directory (Logs012) or of one log file
+*         (Sens012.csv, Mic012_003.wav...)
+* @param  Name: Directory entry name
+* @param  Prefix: Directory prefix or FX_NULL for the log files
+* @param  Number: Number found
+* @retval 1 if the name has one session number, 0 otherwise
+*/
+static int ParseNumber(const CHAR *Name, const CHAR *Prefix, uint32_t *Number)
+{
+  if (Prefix != FX_NULL) {
+    if (strncmp(Name, Prefix, strlen(Prefix)) != 0) {
+      return 0;
+    }
+    Name += strlen(Prefix);
+  } else {
+    while (((*Name >= 'A') && (*Name <= 'Z')) || ((*Name >= 'a') && (*Name <= 'z'))) {
+      Name++;
+    }
+  }
+
+  if ((*Name < '0') || (*Name > '9')) {
+    return 0;
+  }
+
+  *Number = 0;
+  while ((*Name >= '0') && (*Name <= '9')) {
+    *Number = *Number * 10 + (uint32_t)(*Name - '0');
+    Name++;
+  }
+
+  /* The directory name ends with the number, the file name continues with
+     the segment number or the extension */
+  if (Prefix != FX_NULL) {
+    return (*Name == 0);
+  }
+
+  return ((*Name == '.') || (*Name == '_'));
+}
+
+/**
+* @brief  Fill one index record
+* @param  Session: Index
+* @param  pRecord: LOG_SESSION_RECORD_SIZE bytes to fill
+* @retval None
+*/
+static void Serialize(const LogSession_T *Session, UCHAR *pRecord)
+{
+  memset(pRecord, 0, LOG_SESSION_RECORD_SIZE);
+  memcpy(pRecord, LOG_SESSION_MAGIC, 8);
+  PutU16(pRecord + 8, LOG_SESSION_VERSION);
+  PutU16(pRecord + 10, LOG_SESSION_RECORD_SIZE);
+  PutU32(pRecord + 12, Session->Next);
+  PutU32(pRecord + 16, Session->DirSize);
+  PutU32(pRecord + LOG_SESSION_CRC_POS, Crc32(pRecord, LOG_SESSION_CRC_POS));
+}
+
+/**
+* @brief  Read one index record
+* @param  pRecord: LOG_SESSION_RECORD_SIZE bytes
+* @param  Session: Index to fill
+* @retval 1 if the record is valid and made with the same directory size, 0 otherwise
+*/
+static int Parse(const UCHAR *pRecord, LogSession_T *Session)
+{
+  if ((memcmp(pRecord, LOG_SESSION_MAGIC, 8) != 0) ||
+      (GetU16(pRecord + 8) != LOG_SESSION_VERSION) ||
+      (GetU16(pRecord + 10) != LOG_SESSION_RECORD_SIZE) ||
+      (GetU32(pRecord + 16) != Session->DirSize) ||
+      (GetU32(pRecord + LOG_SESSION_CRC_POS) != Crc32(pRecord, LOG_SESSION_CRC_POS))) {
+    return 0;
+  }
+
+  Session->Next = GetU32(pRecord + 12);
+
+  return 1;
+}
+
+/**
+* @brief  CRC-32 (IEEE 802.3) of one buffer
+* @param  p: Data
+* @param  Size: Number of bytes
+* @retval CRC
+*/
+static uint32_t Crc32(const UCHAR *p, uint32_t Size)
+{
+  uint32_t Crc = 0xFFFFFFFFU;
+  uint32_t Bit;
+
+  while (Size-- > 0) {
+    Crc ^= *p++;
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ (0xEDB88320U & (0U - (Crc & 1U)));
+    }
+  }
+
+  return ~Crc;
+}
+
+/**
+* @brief  Write one 16 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU16(UCHAR *p, uint16_t v)
+{
+  p[0] = (UCHAR)v;
+  p[1] = (UCHAR)(v >> 8);
+}
+
+/**
+* @brief  Write one 32 bit little-endian value
+* @param  p: Destination
+* @param  v: Value
+* @retval None
+*/
+static inline void PutU32(UCHAR *p, uint32_t v)
+{
+  PutU16(p, (uint16_t)v);
+  PutU16(p + 2, (uint16_t)(v >> 16));
+}
+
+/**
+* @brief  Read one 16 bit little-endian value
+* @param  p: Source
+* @retval Value
+*/
+static inline uint16_t GetU16(const UCHAR *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+* @brief  Read one 32 bit little-endian value
+* @param  p: Source
+* @retval Value
+*/
+static inline uint32_t GetU32(const UCHAR *p)
+{
+  return GetU16(p) | ((uint32_t)GetU16(p + 2) << 16);
+}
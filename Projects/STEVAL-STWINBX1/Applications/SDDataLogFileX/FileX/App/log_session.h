@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\log_session.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Session index and session directories of the log files
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOG_SESSION_H__
+#define __LOG_SESSION_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "fx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Index file layout (little-endian): "STBOXIDX" magic, version, record size,
+   next free session number, sessions for each directory and one CRC-32 of
+   the record at the end */
+#define LOG_SESSION_MAGIC          "STBOXIDX"
+#define LOG_SESSION_VERSION        1
+#define LOG_SESSION_RECORD_SIZE    32
+#define LOG_SESSION_CRC_POS        (LOG_SESSION_RECORD_SIZE - 4)
+
+/* Directory of the sessions from Number * DirSize to (Number + 1) * DirSize - 1 */
+#define LOG_SESSION_DIR_PREFIX     "Logs"
+#define LOG_SESSION_DIR_NAME       LOG_SESSION_DIR_PREFIX "%03d"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Next;             /* Next free session number */
+  uint32_t DirSize;          /* Sessions for each directory */
+  uint32_t Scanned;          /* Directory entries read for rebuilding the index (0 if it was valid) */
+} LogSession_T;
+
+/* Exported functions --------------------------------------------------------*/
+void LogSession_FileName(CHAR *Name, const CHAR *Format, uint32_t Session, uint32_t DirSize);
+UINT LogSession_FileCreate(FX_MEDIA *Media, CHAR *Name);
+UINT LogSession_Read(FX_MEDIA *Media, FX_FILE *File, CHAR *Name, LogSession_T *Session);
+UINT LogSession_Write(FX_MEDIA *Media, FX_FILE *File, CHAR *Name, LogSession_T *Session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_SESSION_H__ */
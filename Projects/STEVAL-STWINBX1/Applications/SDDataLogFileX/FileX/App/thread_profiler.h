@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    SDDataLogFileX\FileX\App\thread_profiler.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Per-thread CPU load and stack high-water marks of the ThreadX
+  *          threads, with the high-water marks of the message rings, reported
+  *          as one JSON status at a fixed period
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __THREAD_PROFILER_H__
+#define __THREAD_PROFILER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Threads with their own load counter: the samples of the other ones are
+   counted only on the total */
+#define THREAD_PROFILER_MAX_THREADS       12
+
+/* Queues added with ThreadProfiler_AddQueue */
+#define THREAD_PROFILER_MAX_QUEUES        4
+
+/* Bytes of the JSON status given to the report callback (the threads and
+   queues that don't fit are not reported) */
+#define THREAD_PROFILER_JSON_SIZE         1024
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  ULONG Samples;             /* Samples of the last period */
+  ULONG Idle;                /* Samples without one thread running */
+  ULONG Reports;             /* Reports done */
+  ULONG Unknown;             /* Samples of the threads without counter */
+} ThreadProfilerStats_T;
+
+/* Exported variables --------------------------------------------------------*/
+extern ThreadProfilerStats_T ThreadProfilerStats;
+
+/* Exported functions --------------------------------------------------------*/
+UINT ThreadProfiler_Init(VOID (*Report)(const CHAR *Json), ULONG Period, UINT Priority, VOID *Stack, ULONG StackSize);
+UINT ThreadProfiler_AddQueue(const CHAR *Name, ULONG Size, const ULONG *MaxUsed, const ULONG *Overflows);
+VOID ThreadProfiler_Sample(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __THREAD_PROFILER_H__ */
@@ -25,6 +25,47 @@ extern "C" {
 /* Exported types ------------------------------------------------------------*/
 /* USER CODE BEGIN ET */
 #include "STWIN.box_sd.h"
+#include "STBOX1_config.h"
+
+/* Statistics of the write queue (STBOX1_SD_WRITE_QUEUE), reset at each media open.
+   The times are CPU cycles (DWT) */
+typedef struct
+{
+  ULONG Writes;              /* Write requests queued */
+  ULONG Transfers;           /* DMA transfers started (one for each slot) */
+  ULONG FullWaits;           /* Write requests that waited for one free slot */
+  ULONG Drains;              /* Requests that waited for the queued writes */
+  ULONG MaxDepth;            /* Max slots used */
+  ULONG64 DepthSum;          /* Slots used after each slot queued (average depth) */
+  ULONG64 WaitCycles;        /* Time waiting for free slots and drains */
+  ULONG64 LatencySum;        /* Time from the slot queued to its DMA transfer completed */
+  ULONG LatencyMax;
+  ULONG Errors;              /* Queued writes failed */
+} FX_STM32_SD_QUEUE_STATS;
+
+/* Statistics of the read and write requests, reset at each media open: the
+   buffers not 4-Bytes aligned are moved through the scratch buffer (slow path) */
+typedef struct
+{
+  ULONG Requests;            /* Read and write requests */
+  ULONG UnalignedRequests;   /* Requests with one unaligned buffer */
+  ULONG UnalignedSectors;    /* Sectors of the unaligned requests */
+  ULONG ScratchTransfers;    /* Transfers through the scratch buffer */
+  ULONG ReadyChecks;         /* Requests that checked the card ready */
+  ULONG64 ReadyCycles;       /* Time waiting for the card ready (DWT cycles) */
+  ULONG ReadyMax;
+  ULONG ReadAheadFills;      /* Read-ahead buffer filled (STBOX1_SD_READ_AHEAD) */
+  ULONG ReadAheadHits;       /* Sectors read from the read-ahead buffer */
+} FX_STM32_SD_DRIVER_STATS;
+
+/* Statistics of the card ready events (STBOX1_SD_CARD_EVENTS), reset at each media open */
+typedef struct
+{
+  ULONG Busy;                /* Card ready waits with the card busy */
+  ULONG Events;              /* Busy ends signalled by the BUSYD0END interrupt */
+  ULONG Polls;               /* Card status checks (CMD13) */
+  ULONG Timeouts;
+} FX_STM32_SD_CARD_STATS;
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
@@ -55,6 +96,92 @@ extern "C" {
 
 /* USER CODE BEGIN EC */
 
+/* Sectors of the scratch buffer used for the unaligned buffers: the consecutive
+ * sectors are copied on it and moved with one multi-block transfer */
+#ifdef STBOX1_SD_SCRATCH_SECTORS
+#define FX_STM32_SD_SCRATCH_SECTORS                           STBOX1_SD_SCRATCH_SECTORS
+#else /* STBOX1_SD_SCRATCH_SECTORS */
+#define FX_STM32_SD_SCRATCH_SECTORS                           1
+#endif /* STBOX1_SD_SCRATCH_SECTORS */
+
+/* Count the requests and the unaligned ones (fx_stm32_sd_driver_stats) */
+#define FX_STM32_SD_STATS                                     1
+#define FX_STM32_SD_CYCLES()                                  (DWT->CYCCNT)
+
+/* Card ready events: the end of the card busy after each write is signalled by
+ * the SDMMC BUSYD0END interrupt and the requests sleep on one semaphore until it,
+ * instead of polling the card status */
+#ifdef STBOX1_SD_CARD_EVENTS
+#define FX_STM32_SD_CARD_EVENTS                               1
+#else /* STBOX1_SD_CARD_EVENTS */
+#define FX_STM32_SD_CARD_EVENTS                               0
+#endif /* STBOX1_SD_CARD_EVENTS */
+
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+/* Without the interrupt the card status is checked again after 1, 2, 4 ..
+ * FX_STM32_SD_CARD_MAX_BACKOFF ticks */
+#ifdef STBOX1_SD_CARD_MAX_BACKOFF
+#define FX_STM32_SD_CARD_MAX_BACKOFF                          STBOX1_SD_CARD_MAX_BACKOFF
+#else /* STBOX1_SD_CARD_MAX_BACKOFF */
+#define FX_STM32_SD_CARD_MAX_BACKOFF                          4
+#endif /* STBOX1_SD_CARD_MAX_BACKOFF */
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
+
+/* Read-ahead: after FX_STM32_SD_READ_AHEAD_TRIGGER consecutive sequential read
+ * requests, the next FX_STM32_SD_READ_AHEAD_SECTORS sectors are read with one
+ * multi-block transfer on one driver buffer and the next requests are copied
+ * from it. The writes on its sectors discard it */
+#ifdef STBOX1_SD_READ_AHEAD
+#define FX_STM32_SD_READ_AHEAD_SECTORS                        STBOX1_SD_READ_AHEAD_SECTORS
+#else /* STBOX1_SD_READ_AHEAD */
+#define FX_STM32_SD_READ_AHEAD_SECTORS                        0
+#endif /* STBOX1_SD_READ_AHEAD */
+#define FX_STM32_SD_READ_AHEAD_TRIGGER                        2
+
+/* Write queue: the data sectors are copied on one free slot and the driver
+ * returns while the previous slots are written, the other requests wait
+ * for the queued writes first */
+#ifdef STBOX1_SD_WRITE_QUEUE
+#define FX_STM32_SD_WRITE_QUEUE                               1
+#else /* STBOX1_SD_WRITE_QUEUE */
+#define FX_STM32_SD_WRITE_QUEUE                               0
+#endif /* STBOX1_SD_WRITE_QUEUE */
+
+#if (FX_STM32_SD_WRITE_QUEUE == 1)
+/* Number of slots of the queue */
+#ifdef STBOX1_SD_WRITE_QUEUE_SLOTS
+#define FX_STM32_SD_QUEUE_SLOTS                               STBOX1_SD_WRITE_QUEUE_SLOTS
+#else /* STBOX1_SD_WRITE_QUEUE_SLOTS */
+#define FX_STM32_SD_QUEUE_SLOTS                               4
+#endif /* STBOX1_SD_WRITE_QUEUE_SLOTS */
+
+/* Bytes for each slot: the biggest write of the application (the writes
+ * bigger than one slot are split on more slots) */
+#if defined(STBOX1_SD_WRITE_QUEUE_SLOT_SIZE)
+#define FX_STM32_SD_QUEUE_SLOT_SIZE                           STBOX1_SD_WRITE_QUEUE_SLOT_SIZE
+#elif defined(STBOX1_LOG_RAW)
+#define FX_STM32_SD_QUEUE_SLOT_SIZE                           STBOX1_LOG_RAW_BLOCK_SIZE
+#else
+#define FX_STM32_SD_QUEUE_SLOT_SIZE                           (16 * 1024)
+#endif
+
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+/* The thread that writes the slots sleeps while the card is busy, so it runs
+ * before the FileX Writing thread (priority 12) and starts each slot as soon as
+ * the card is ready */
+#define FX_STM32_SD_QUEUE_THREAD_PRIO                         11
+#else /* FX_STM32_SD_CARD_EVENTS == 1 */
+/* The thread that writes the slots runs when the FileX Writing thread
+ * (priority 12) waits, so the copy of the next writes is not delayed */
+#define FX_STM32_SD_QUEUE_THREAD_PRIO                         13
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
+#define FX_STM32_SD_QUEUE_STACK_SIZE                          1024
+
+#if ((FX_STM32_SD_QUEUE_SLOT_SIZE % FX_STM32_SD_DEFAULT_SECTOR_SIZE) != 0)
+  #error "STBOX1_SD_WRITE_QUEUE_SLOT_SIZE must be a multiple of the sector size"
+#endif
+#endif /* FX_STM32_SD_WRITE_QUEUE == 1 */
+
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -224,6 +351,22 @@ VOID  fx_stm32_sd_driver(FX_MEDIA *media_ptr);
 
 /* USER CODE BEGIN EFP */
 
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats;
+
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+extern FX_STM32_SD_CARD_STATS fx_stm32_sd_card_stats;
+
+INT fx_stm32_sd_wait_ready(UINT Instance);
+VOID fx_stm32_sd_card_irq(UINT Instance);
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
+
+#if (FX_STM32_SD_WRITE_QUEUE == 1)
+extern FX_STM32_SD_QUEUE_STATS fx_stm32_sd_queue_stats;
+
+INT fx_stm32_sd_queue_write(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks);
+INT fx_stm32_sd_queue_drain(UINT Instance);
+#endif /* FX_STM32_SD_WRITE_QUEUE == 1 */
+
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
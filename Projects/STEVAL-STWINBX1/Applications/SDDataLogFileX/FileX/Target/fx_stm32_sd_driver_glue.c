@@ -20,7 +20,50 @@
 #include "fx_stm32_sd_driver.h"
 
 /* USER CODE BEGIN  0 */
+#include <string.h>
+
 TX_SEMAPHORE transfer_semaphore;
+
+#if (FX_STM32_SD_WRITE_QUEUE == 1)
+/* One slot of the write queue */
+typedef struct
+{
+  UINT Sector;               /* First sector */
+  UINT Sectors;              /* Number of sectors */
+  ULONG QueueTime;           /* DWT cycles when it was queued */
+} fx_stm32_sd_queue_slot_t;
+
+FX_STM32_SD_QUEUE_STATS fx_stm32_sd_queue_stats;
+
+ALIGN_32BYTES (static UCHAR queue_buffer[FX_STM32_SD_QUEUE_SLOTS][FX_STM32_SD_QUEUE_SLOT_SIZE]);
+static fx_stm32_sd_queue_slot_t queue_slot[FX_STM32_SD_QUEUE_SLOTS];
+static volatile UINT queue_head;   /* Oldest slot, advanced only by queue_release */
+static volatile UINT queue_count;  /* Slots used */
+static UINT queue_tail;            /* Next free slot, advanced only by the writing thread */
+static UINT queue_busy;            /* DMA transfer started for the oldest slot */
+static INT queue_error;            /* Error of one queued write, returned by the next request */
+static UINT queue_created = 0;
+
+static TX_SEMAPHORE queue_free_semaphore;
+static TX_SEMAPHORE queue_work_semaphore;
+static TX_MUTEX queue_mutex;
+static TX_THREAD queue_thread;
+static ULONG queue_thread_stack[FX_STM32_SD_QUEUE_STACK_SIZE / sizeof(ULONG)];
+
+static VOID queue_init(UINT instance);
+static VOID queue_thread_entry(ULONG instance);
+#endif /* FX_STM32_SD_WRITE_QUEUE == 1 */
+
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+FX_STM32_SD_CARD_STATS fx_stm32_sd_card_stats;
+
+static TX_SEMAPHORE card_ready_semaphore;
+static volatile UINT card_busy;    /* One write started and the end of its busy not seen yet */
+static UINT card_created = 0;
+
+static VOID card_init(VOID);
+static VOID card_write_done(UINT instance);
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
 /* USER CODE END  0 */
 
 /**
@@ -34,6 +77,12 @@ INT fx_stm32_sd_init(UINT instance)
 /* USER CODE BEGIN  FX_SD_INIT */
 if (BSP_SD_Init(instance) == BSP_ERROR_NONE)
   {
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+    card_init();
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
+#if (FX_STM32_SD_WRITE_QUEUE == 1)
+    queue_init(instance);
+#endif /* FX_STM32_SD_WRITE_QUEUE == 1 */
     ret = 0;
   }
   else
@@ -114,6 +163,10 @@ INT fx_stm32_sd_write_blocks(UINT instance, UINT *buffer, UINT start_block, UINT
 {
   INT ret = 0;
 /* USER CODE BEGIN  WRITE_BLOCKS */
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+  /* cleared at the end of the card programming */
+  card_busy = 1;
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
  if (BSP_SD_WriteBlocks_DMA(instance, (uint32_t *)buffer, start_block, total_blocks) != BSP_ERROR_NONE)
   {
     ret = -1;
@@ -127,8 +180,405 @@ INT fx_stm32_sd_write_blocks(UINT instance, UINT *buffer, UINT start_block, UINT
 }
 
 /* USER CODE BEGIN  1 */
+#if (FX_STM32_SD_WRITE_QUEUE == 1)
+/**
+* @brief Create the write queue (only the first time) and reset its statistics
+* @param uINT Instance SD instance
+* @retval None
+*/
+static VOID queue_init(UINT instance)
+{
+  if (queue_created == 0)
+  {
+    tx_semaphore_create(&queue_free_semaphore, "sdmmc queue free semaphore", FX_STM32_SD_QUEUE_SLOTS);
+    tx_semaphore_create(&queue_work_semaphore, "sdmmc queue work semaphore", 0);
+    tx_mutex_create(&queue_mutex, "sdmmc queue mutex", TX_INHERIT);
+    tx_thread_create(&queue_thread, "sdmmc queue thread", queue_thread_entry, instance,
+                     queue_thread_stack, sizeof(queue_thread_stack),
+                     FX_STM32_SD_QUEUE_THREAD_PRIO, FX_STM32_SD_QUEUE_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+    queue_created = 1;
+  }
+
+  memset(&fx_stm32_sd_queue_stats, 0, sizeof(fx_stm32_sd_queue_stats));
+  queue_error = 0;
+}
+
+/**
+* @brief Release the oldest slot
+* @param INT error 1 if its write failed
+* @retval None
+*/
+static VOID queue_release(INT error)
+{
+  TX_INTERRUPT_SAVE_AREA
+  ULONG latency = DWT->CYCCNT - queue_slot[queue_head].QueueTime;
+
+  if (error != 0)
+  {
+    queue_error = -1;
+    fx_stm32_sd_queue_stats.Errors++;
+  }
+
+  fx_stm32_sd_queue_stats.LatencySum += latency;
+  if (latency > fx_stm32_sd_queue_stats.LatencyMax)
+  {
+    fx_stm32_sd_queue_stats.LatencyMax = latency;
+  }
+
+  /* head and count change together: no thread can see the slot released
+     and still counted */
+  TX_DISABLE
+  queue_busy = 0;
+  queue_head = (queue_head + 1) % FX_STM32_SD_QUEUE_SLOTS;
+  queue_count--;
+  TX_RESTORE
+
+  tx_semaphore_put(&queue_free_semaphore);
+}
+
+/**
+* @brief Complete the DMA transfer of the oldest slot and start the next one.
+*        It must be called with queue_mutex
+* @param uINT Instance SD instance
+* @param ULONG wait_option TX_NO_WAIT for only checking the transfer and the card,
+*        FX_STM32_SD_DEFAULT_TIMEOUT for waiting them
+* @retval None
+*/
+static VOID queue_pump(UINT instance, ULONG wait_option)
+{
+#if (FX_STM32_SD_CARD_EVENTS == 0)
+  ULONG start;
+#endif /* FX_STM32_SD_CARD_EVENTS == 0 */
+
+  if (queue_busy == 1)
+  {
+    /* the semaphore is put by BSP_SD_WriteCpltCallback at the end of the DMA transfer */
+    if (tx_semaphore_get(&transfer_semaphore, wait_option) != TX_SUCCESS)
+    {
+      if (wait_option == TX_NO_WAIT)
+      {
+        return;
+      }
+
+      /* transfer lost: the slot is dropped and the next request fails */
+      tx_semaphore_put(&transfer_semaphore);
+      queue_release(1);
+      return;
+    }
+
+    tx_semaphore_put(&transfer_semaphore);
+    queue_release(0);
+  }
+
+  if (queue_count == 0)
+  {
+    return;
+  }
+
+  /* the card could be still programming the previous slot */
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+  if (wait_option == TX_NO_WAIT)
+  {
+    if (card_busy != 0)
+    {
+      return;
+    }
+  }
+  else if (fx_stm32_sd_wait_ready(instance) != 0)
+  {
+    queue_release(1);
+    return;
+  }
+#else /* FX_STM32_SD_CARD_EVENTS == 1 */
+  start = FX_STM32_SD_CURRENT_TIME();
+  while (fx_stm32_sd_get_status(instance) != 0)
+  {
+    if ((wait_option == TX_NO_WAIT) || (FX_STM32_SD_CURRENT_TIME() - start >= FX_STM32_SD_DEFAULT_TIMEOUT))
+    {
+      if (wait_option != TX_NO_WAIT)
+      {
+        queue_release(1);
+      }
+      return;
+    }
+  }
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
+
+  /* the driver waits for the queue before the other transfers, so the semaphore is free */
+  if (tx_semaphore_get(&transfer_semaphore, wait_option) != TX_SUCCESS)
+  {
+    if (wait_option != TX_NO_WAIT)
+    {
+      queue_release(1);
+    }
+    return;
+  }
+
+  if (fx_stm32_sd_write_blocks(instance, (UINT *)queue_buffer[queue_head],
+                               queue_slot[queue_head].Sector, queue_slot[queue_head].Sectors) != 0)
+  {
+    tx_semaphore_put(&transfer_semaphore);
+    queue_release(1);
+    return;
+  }
+
+  queue_busy = 1;
+  fx_stm32_sd_queue_stats.Transfers++;
+}
+
+/**
+* @brief Thread writing the queued slots when the threads with higher priority wait
+* @param ULONG instance SD instance
+* @retval None
+*/
+static VOID queue_thread_entry(ULONG instance)
+{
+  for (;;)
+  {
+    tx_semaphore_get(&queue_work_semaphore, TX_WAIT_FOREVER);
+
+    while (queue_count != 0)
+    {
+      tx_mutex_get(&queue_mutex, TX_WAIT_FOREVER);
+      queue_pump((UINT)instance, FX_STM32_SD_DEFAULT_TIMEOUT);
+      tx_mutex_put(&queue_mutex);
+    }
+  }
+}
+
+/**
+* @brief Queue data sectors to write into the SD device.
+*        The data are copied, so the buffer could be changed on return
+* @param uINT *Buffer buffer to write into the SD device.
+* @param uINT StartBlock the first block to start writing from.
+* @param uINT NbrOfBlocks total number of blocks to write.
+* @retval 0 on success error code otherwise (also for the previous queued writes)
+*/
+INT fx_stm32_sd_queue_write(UINT instance, UINT *buffer, UINT start_block, UINT total_blocks)
+{
+  TX_INTERRUPT_SAVE_AREA
+  UCHAR *data = (UCHAR *)buffer;
+  UINT blocks;
+  UINT slot;
+  ULONG start;
+  INT ret;
+
+  fx_stm32_sd_queue_stats.Writes++;
+
+  while (total_blocks > 0)
+  {
+    blocks = FX_STM32_SD_QUEUE_SLOT_SIZE / FX_STM32_SD_DEFAULT_SECTOR_SIZE;
+    if (blocks > total_blocks)
+    {
+      blocks = total_blocks;
+    }
+
+    /* wait for one free slot: the oldest slots are written by the queue thread */
+    if (tx_semaphore_get(&queue_free_semaphore, TX_NO_WAIT) != TX_SUCCESS)
+    {
+      fx_stm32_sd_queue_stats.FullWaits++;
+      start = DWT->CYCCNT;
+      if (tx_semaphore_get(&queue_free_semaphore, FX_STM32_SD_DEFAULT_TIMEOUT) != TX_SUCCESS)
+      {
+        return -1;
+      }
+      fx_stm32_sd_queue_stats.WaitCycles += DWT->CYCCNT - start;
+    }
+
+    /* the free slot comes from the tail owned by this thread, never from
+       queue_head + queue_count: the queue thread (with lower or higher priority)
+       can release the oldest slot at any point of this request */
+    slot = queue_tail;
+    queue_tail = (queue_tail + 1) % FX_STM32_SD_QUEUE_SLOTS;
+    memcpy(queue_buffer[slot], data, blocks * FX_STM32_SD_DEFAULT_SECTOR_SIZE);
+#if (FX_STM32_SD_CACHE_MAINTENANCE == 1)
+    clean_cache_by_addr((uint32_t*)queue_buffer[slot], blocks * FX_STM32_SD_DEFAULT_SECTOR_SIZE);
+#endif
+    queue_slot[slot].Sector = start_block;
+    queue_slot[slot].Sectors = blocks;
+    queue_slot[slot].QueueTime = DWT->CYCCNT;
+
+    TX_DISABLE
+    queue_count++;
+    TX_RESTORE
+
+    fx_stm32_sd_queue_stats.DepthSum += queue_count;
+    if (queue_count > fx_stm32_sd_queue_stats.MaxDepth)
+    {
+      fx_stm32_sd_queue_stats.MaxDepth = queue_count;
+    }
+
+    /* start the transfer now if the card is ready, otherwise the queue thread does it */
+    if (tx_mutex_get(&queue_mutex, TX_NO_WAIT) == TX_SUCCESS)
+    {
+      queue_pump(instance, TX_NO_WAIT);
+      tx_mutex_put(&queue_mutex);
+    }
+    tx_semaphore_ceiling_put(&queue_work_semaphore, 1);
+
+    data += blocks * FX_STM32_SD_DEFAULT_SECTOR_SIZE;
+    start_block += blocks;
+    total_blocks -= blocks;
+  }
+
+  ret = queue_error;
+  queue_error = 0;
+
+  return ret;
+}
+
+/**
+* @brief Wait for all the queued writes (before the reads, the FAT and directory
+*        writes, the flush and the deinit)
+* @param uINT Instance SD instance
+* @retval 0 on success error code otherwise (for one of the queued writes)
+*/
+INT fx_stm32_sd_queue_drain(UINT instance)
+{
+  ULONG start;
+  INT ret;
+
+  if (queue_count != 0)
+  {
+    fx_stm32_sd_queue_stats.Drains++;
+    start = DWT->CYCCNT;
+
+    tx_mutex_get(&queue_mutex, TX_WAIT_FOREVER);
+    while (queue_count != 0)
+    {
+      queue_pump(instance, FX_STM32_SD_DEFAULT_TIMEOUT);
+    }
+    tx_mutex_put(&queue_mutex);
+
+    fx_stm32_sd_queue_stats.WaitCycles += DWT->CYCCNT - start;
+  }
+
+  ret = queue_error;
+  queue_error = 0;
+
+  return ret;
+}
+#endif /* FX_STM32_SD_WRITE_QUEUE == 1 */
+
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+/**
+* @brief Create the card ready semaphore (only the first time) and reset the statistics
+* @param None
+* @retval None
+*/
+static VOID card_init(VOID)
+{
+  if (card_created == 0)
+  {
+    tx_semaphore_create(&card_ready_semaphore, "sdmmc card ready semaphore", 0);
+    card_created = 1;
+  }
+
+  memset(&fx_stm32_sd_card_stats, 0, sizeof(fx_stm32_sd_card_stats));
+  card_busy = 0;
+}
+
+/**
+* @brief End of one write transfer (interrupt context): the card keeps DAT0 low
+*        while it programs the data, the BUSYD0END interrupt signals its end
+* @param uINT Instance SD instance
+* @retval None
+*/
+static VOID card_write_done(UINT instance)
+{
+  SD_HandleTypeDef *hsd = &hsd_sdmmc[instance];
+
+  __HAL_SD_CLEAR_FLAG(hsd, SDMMC_FLAG_BUSYD0END);
+
+  if (__HAL_SD_GET_FLAG(hsd, SDMMC_FLAG_BUSYD0) != RESET)
+  {
+    __HAL_SD_ENABLE_IT(hsd, SDMMC_IT_BUSYD0END);
+  }
+  else
+  {
+    card_busy = 0;
+  }
+}
+
+/**
+* @brief SDMMC interrupt: end of the card busy. It must be called by the SDMMC
+*        interrupt handler before BSP_SD_IRQHandler
+* @param uINT Instance SD instance
+* @retval None
+*/
+VOID fx_stm32_sd_card_irq(UINT instance)
+{
+  SD_HandleTypeDef *hsd = &hsd_sdmmc[instance];
+
+  if (((hsd->Instance->MASK & SDMMC_IT_BUSYD0END) != 0U) && (__HAL_SD_GET_FLAG(hsd, SDMMC_FLAG_BUSYD0END) != RESET))
+  {
+    __HAL_SD_DISABLE_IT(hsd, SDMMC_IT_BUSYD0END);
+    __HAL_SD_CLEAR_FLAG(hsd, SDMMC_FLAG_BUSYD0END);
+
+    card_busy = 0;
+    fx_stm32_sd_card_stats.Events++;
+    tx_semaphore_ceiling_put(&card_ready_semaphore, 1);
+  }
+}
+
+/**
+* @brief Wait for the card ready: the thread sleeps until the end of the card busy.
+*        If the interrupt doesn't come, the card status is checked after 1, 2, 4 ..
+*        FX_STM32_SD_CARD_MAX_BACKOFF ticks
+* @param uINT Instance SD instance
+* @retval 0 when ready 1 on timeout
+*/
+INT fx_stm32_sd_wait_ready(UINT instance)
+{
+  SD_HandleTypeDef *hsd = &hsd_sdmmc[instance];
+  ULONG start = FX_STM32_SD_CURRENT_TIME();
+  ULONG backoff = 1;
+
+  if (card_busy == 0)
+  {
+    return 0;
+  }
+
+  fx_stm32_sd_card_stats.Busy++;
+
+  for (;;)
+  {
+    /* the card could be ready without the interrupt */
+    fx_stm32_sd_card_stats.Polls++;
+    if (fx_stm32_sd_get_status(instance) == 0)
+    {
+      __HAL_SD_DISABLE_IT(hsd, SDMMC_IT_BUSYD0END);
+      card_busy = 0;
+      return 0;
+    }
+
+    if (FX_STM32_SD_CURRENT_TIME() - start >= FX_STM32_SD_DEFAULT_TIMEOUT)
+    {
+      fx_stm32_sd_card_stats.Timeouts++;
+      return 1;
+    }
+
+    /* the semaphore is put by fx_stm32_sd_card_irq */
+    if (tx_semaphore_get(&card_ready_semaphore, backoff) == TX_SUCCESS)
+    {
+      if (card_busy == 0)
+      {
+        return 0;
+      }
+    }
+    else if (backoff < FX_STM32_SD_CARD_MAX_BACKOFF)
+    {
+      backoff *= 2;
+    }
+  }
+}
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
+
 void BSP_SD_WriteCpltCallback(uint32_t instance)
 {
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+  card_write_done(instance);
+#endif /* FX_STM32_SD_CARD_EVENTS == 1 */
   tx_semaphore_put(&transfer_semaphore);
 }
 
@@ -0,0 +1,473 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\alignbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the FileX SD driver of the firmware with aligned
+  *          and unaligned application buffers: the same driver is linked with
+  *          different sizes of its scratch buffer (STBOX1_SD_SCRATCH_SECTORS)
+  *          and runs on one simulated SD card with one latency model
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fx_api.h"
+#include "fx_stm32_sd_driver.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated SD card: 4 GB (SDHC) formatted FAT32 with 32 KB clusters. The
+   memory is allocated only for the parts written */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (8 * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_CHUNKS           (DISK_SECTORS / DISK_CHUNK_SECTORS)
+
+/* Same write batching stage and media cache of the firmware */
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define LOG_FILE_NAME         "Log000.stb"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Latency model of the SD card: each request costs one command overhead plus
+   the bus transfer (the DMA transfer on the board), then after each write the
+   card is busy programming. The driver copies the unaligned sectors on its
+   scratch buffer at the CPU copy rate */
+typedef struct
+{
+  double CommandTime;        /* uS for each request */
+  double BusRate;            /* MB/s on the bus */
+  double ProgramTime;        /* uS of card busy after each write */
+  double CopyRate;           /* MB/s of the CPU copy on the scratch buffer */
+} Latency_T;
+
+/* The same driver (fx_stm32_sd_driver.c) built with one scratch buffer of
+   Sectors sectors (see the Makefile) */
+typedef struct
+{
+  ULONG Sectors;
+  VOID (*Driver)(FX_MEDIA *media_ptr);
+  FX_STM32_SD_DRIVER_STATS *Stats;
+} Driver_T;
+
+/* Private variables ---------------------------------------------------------*/
+extern VOID fx_stm32_sd_driver_1(FX_MEDIA *media_ptr);
+extern VOID fx_stm32_sd_driver_16(FX_MEDIA *media_ptr);
+extern VOID fx_stm32_sd_driver_32(FX_MEDIA *media_ptr);
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_1;
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_16;
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_32;
+
+static const Driver_T Drivers[] = {
+  {1, fx_stm32_sd_driver_1, &fx_stm32_sd_driver_stats_1},
+  {16, fx_stm32_sd_driver_16, &fx_stm32_sd_driver_stats_16},
+  {32, fx_stm32_sd_driver_32, &fx_stm32_sd_driver_stats_32},
+};
+#define DRIVERS               (sizeof(Drivers) / sizeof(Drivers[0]))
+
+static UCHAR *Disk[DISK_CHUNKS];
+static Latency_T Latency = {100.0, 25.0, 800.0, 200.0};
+static double Now;           /* uS of the simulation */
+static double CardReady;     /* End of the card busy */
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+
+/* One more byte for the unaligned buffers (Buffer + 1) */
+static UCHAR Buffer[WRITE_BATCH_SIZE + 4] __attribute__ ((aligned (32)));
+static UCHAR Expected[WRITE_BATCH_SIZE];
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated card
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Data: Data
+* @param  Write: 1 for writing the card
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Data, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Sectors;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Data, 0, DISK_SECTOR_SIZE);
+    } else {
+      Sectors = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Sectors, Data, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Data, Sectors, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Data += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Free the simulated card
+* @param  None
+* @retval None
+*/
+static void Disk_Free(void)
+{
+  ULONG Chunk;
+
+  for (Chunk = 0; Chunk < DISK_CHUNKS; Chunk++) {
+    free(Disk[Chunk]);
+    Disk[Chunk] = NULL;
+  }
+}
+
+/**
+* @brief  One transfer on the simulated card: the DMA transfer is completed
+*         at once, the time follows the latency model
+* @param  Count: Number of sectors
+* @param  Write: 1 for one write request
+* @retval None
+*/
+static void Card_Transfer(ULONG Count, int Write)
+{
+  if (CardReady > Now) {
+    Now = CardReady;
+  }
+  Now += Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate;
+
+  CardReady = Now;
+  if (Write) {
+    CardReady += Latency.ProgramTime;
+  }
+}
+
+/**
+* @brief  Time base of the driver statistics (DWT on the board)
+* @param  None
+* @retval uS of the simulation
+*/
+ULONG fx_stm32_sd_host_cycles(VOID)
+{
+  return (ULONG)Now;
+}
+
+/**
+* @brief  SD functions used by the driver (fx_stm32_sd_driver_glue.c on the board)
+*/
+INT fx_stm32_sd_init(UINT Instance)
+{
+  (void)Instance;
+  return 0;
+}
+
+INT fx_stm32_sd_deinit(UINT Instance)
+{
+  (void)Instance;
+  return 0;
+}
+
+INT fx_stm32_sd_get_status(UINT Instance)
+{
+  (void)Instance;
+
+  /* The driver polls the card until the end of its busy */
+  if (CardReady > Now) {
+    Now = CardReady;
+  }
+
+  return 0;
+}
+
+INT fx_stm32_sd_read_blocks(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks)
+{
+  (void)Instance;
+
+  if ((StartSector + NbrOfBlocks > DISK_SECTORS) || (((uintptr_t)Buffer & 0x3) != 0)) {
+    return 1;
+  }
+
+  Disk_Copy(StartSector, NbrOfBlocks, (UCHAR *)Buffer, 0);
+  Card_Transfer(NbrOfBlocks, 0);
+
+  return 0;
+}
+
+INT fx_stm32_sd_write_blocks(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks)
+{
+  (void)Instance;
+
+  /* The SD DMA needs 4-Bytes aligned buffers */
+  if ((StartSector + NbrOfBlocks > DISK_SECTORS) || (((uintptr_t)Buffer & 0x3) != 0)) {
+    return 1;
+  }
+
+  Disk_Copy(StartSector, NbrOfBlocks, (UCHAR *)Buffer, 1);
+  Card_Transfer(NbrOfBlocks, 1);
+
+  return 0;
+}
+
+/**
+* @brief  Format the simulated card and open it with one driver
+* @param  Driver: Driver to use
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT SimDisk_Open(const Driver_T *Driver)
+{
+  UINT status;
+
+  Disk_Free();
+
+  status = fx_media_format(&Media, Driver->Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                           "ALIBENCH", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 64, 1, 1);
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "ALIBENCH", Driver->Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  }
+
+  return status;
+}
+
+/**
+* @brief  Simulated time of the driver, with the copies on the scratch buffer
+* @param  Driver: Driver used
+* @retval uS
+*/
+static double Driver_Time(const Driver_T *Driver)
+{
+  return Now + (Driver->Stats->UnalignedSectors * (double)DISK_SECTOR_SIZE) / Latency.CopyRate;
+}
+
+/**
+* @brief  Pattern of the log data
+* @param  Data: Destination
+* @param  Offset: Offset of the data in the log
+* @param  Size: Bytes
+* @retval None
+*/
+static void Pattern(UCHAR *Data, ULONG64 Offset, ULONG Size)
+{
+  ULONG Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Data[Index] = (UCHAR)(((Offset + Index) * 7U) ^ ((Offset + Index) >> 9));
+  }
+}
+
+/**
+* @brief  Write one log with Chunk bytes for each fx_file_write from Buffer + Shift,
+*         then read it back with the same buffer and check it
+* @param  Driver: Driver to use
+* @param  Size: Bytes of the log
+* @param  Chunk: Bytes for each fx_file_write
+* @param  Shift: 0 for the aligned buffer, 1 for the unaligned one
+* @param  WriteTime: uS of the writes (close included)
+* @param  ReadTime: uS of the reads
+* @param  Stats: Driver statistics of the writes
+* @retval FX_SUCCESS, FX_IO_ERROR for wrong data or the FileX error
+*/
+static UINT AlignLog(const Driver_T *Driver, ULONG64 Size, ULONG Chunk, ULONG Shift,
+                     double *WriteTime, double *ReadTime, FX_STM32_SD_DRIVER_STATS *Stats)
+{
+  UCHAR *Data = Buffer + Shift;
+  ULONG64 Offset;
+  ULONG Actual;
+  double Start;
+  UINT status;
+
+  status = SimDisk_Open(Driver);
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_create(&Media, LOG_FILE_NAME);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+
+  memset(Driver->Stats, 0, sizeof(*Driver->Stats));
+  Start = Driver_Time(Driver);
+
+  for (Offset = 0; (Offset < Size) && (status == FX_SUCCESS); Offset += Chunk) {
+    Pattern(Data, Offset, Chunk);
+    status = fx_file_write(&File, Data, Chunk);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(&Media);
+  }
+
+  *WriteTime = Driver_Time(Driver) - Start;
+  *Stats = *Driver->Stats;
+
+  /* Read it back from the card: the media cache is flushed first */
+  if (status == FX_SUCCESS) {
+    status = fx_media_cache_invalidate(&Media);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_READ);
+  }
+
+  memset(Driver->Stats, 0, sizeof(*Driver->Stats));
+  Start = Driver_Time(Driver);
+
+  for (Offset = 0; (Offset < Size) && (status == FX_SUCCESS); Offset += Chunk) {
+    status = fx_file_read(&File, Data, Chunk, &Actual);
+    if (status == FX_SUCCESS) {
+      Pattern(Expected, Offset, Chunk);
+      if ((Actual != Chunk) || (memcmp(Data, Expected, Chunk) != 0)) {
+        fprintf(stderr, "Wrong data at %llu\n", (unsigned long long)Offset);
+        status = FX_IO_ERROR;
+      }
+    }
+  }
+
+  *ReadTime = Driver_Time(Driver) - Start;
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-m MB] [-w bytes] [-c uS] [-b MB/s] [-p uS] [-r MB/s]\n", Name);
+  fprintf(stderr, "  -m  size of each log (default 16 MB)\n");
+  fprintf(stderr, "  -w  bytes for each fx_file_write and fx_file_read (default 16384, max 16384)\n");
+  fprintf(stderr, "  -c  command overhead of each SD request (default 100 uS)\n");
+  fprintf(stderr, "  -b  SD bus rate (default 25 MB/s)\n");
+  fprintf(stderr, "  -p  card busy after each write (default 800 uS)\n");
+  fprintf(stderr, "  -r  CPU copy rate on the scratch buffer (default 200 MB/s)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  ULONG64 Size = 16ULL * 1024 * 1024;
+  ULONG Chunk = WRITE_BATCH_SIZE;
+  ULONG Index;
+  ULONG Shift;
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      Size = (ULONG64)atoi(argv[++Arg]) * 1024 * 1024;
+    } else if ((strcmp(argv[Arg], "-w") == 0) && (Arg + 1 < argc)) {
+      Chunk = (ULONG)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc)) {
+      Latency.CommandTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Latency.BusRate = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      Latency.ProgramTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-r") == 0) && (Arg + 1 < argc)) {
+      Latency.CopyRate = atof(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if ((Size == 0) || (Size > 1024ULL * 1024 * 1024) || (Chunk == 0) || (Chunk > WRITE_BATCH_SIZE) ||
+      (Latency.BusRate <= 0) || (Latency.CopyRate <= 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  /* Whole fx_file_write calls */
+  Size -= Size % Chunk;
+
+  fx_system_initialize();
+
+  printf("FAT32, %u MB for each log, %lu bytes for each fx_file_write/fx_file_read\n",
+         (unsigned)(Size / (1024 * 1024)), (unsigned long)Chunk);
+  printf("SD request %.0f uS + %.1f MB/s, busy %.0f uS after each write, copy %.0f MB/s\n",
+         Latency.CommandTime, Latency.BusRate, Latency.ProgramTime, Latency.CopyRate);
+  printf("Buffer     Scratch  Write MB/s  Read MB/s  Requests  Unaligned  Transfers\n");
+
+  for (Shift = 0; Shift < 2; Shift++) {
+    for (Index = 0; Index < DRIVERS; Index++) {
+      FX_STM32_SD_DRIVER_STATS Stats;
+      double WriteTime;
+      double ReadTime;
+      uint64_t WriteTransfers;
+
+      Now = 0;
+      CardReady = 0;
+      if (AlignLog(&Drivers[Index], Size, Chunk, Shift, &WriteTime, &ReadTime, &Stats) != FX_SUCCESS) {
+        fprintf(stderr, "Error with %lu sectors of scratch buffer\n", (unsigned long)Drivers[Index].Sectors);
+        return 1;
+      }
+
+      /* Transfers of the writes: one for each aligned request, the others through the scratch buffer */
+      WriteTransfers = (Stats.Requests - Stats.UnalignedRequests) + Stats.ScratchTransfers;
+
+      printf("%-9s  %7lu  %10.2f  %9.2f  %8lu  %9lu  %9llu\n", Shift ? "unaligned" : "aligned",
+             (unsigned long)Drivers[Index].Sectors, Size / WriteTime, Size / ReadTime,
+             (unsigned long)Stats.Requests, (unsigned long)Stats.UnalignedRequests,
+             (unsigned long long)WriteTransfers);
+    }
+  }
+
+  Disk_Free();
+
+  return 0;
+}
@@ -0,0 +1,508 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\audiobench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the audio callbacks of the firmware: the BSP
+  *          filter of each 1 mS MDF interrupt followed by the old
+  *          AudioProcess_SD_Recording (copy of the PCM buffer on the ping-pong
+  *          buffer) or by the new one (the BSP writes directly on the audio
+  *          blocks of the message ring). The duration of the callbacks, their
+  *          CPU load and the bytes written are compared and the audio saved
+  *          is checked against the filter output
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "tx_api.h"
+#include "msg_ring.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Same BSP settings of the boards */
+#define AUDIO_VOLUME_INPUT    64
+#define SKIP_CALLBACKS        200
+#define MAX_SAMPLES_MS        48
+#define SaturaLH(N, L, H) (((N)<(L))?(L):(((N)>(H))?(H):(N)))
+
+/* Old path: one ping-pong buffer of 1024 mS (two blocks of 512 mS) */
+#define OLD_AUDIO_RING_SIZE   2
+#define OLD_BUFF_MS           1024
+
+/* New path: AUDIO_RING_SIZE blocks of 256 mS */
+#define NEW_AUDIO_RING_SIZE   4
+#define NEW_BLOCK_MS          256
+
+#define DEFAULT_CALLBACKS     60000
+#define INPUT_CALLBACKS       1000
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  ULONG CommandType;
+  uint32_t AudioIndex;       /* Old path: first sample of the half to save */
+  uint32_t AudioBlock;       /* New path: audio block to save */
+} MessageData_T;
+
+typedef struct
+{
+  int32_t Z;
+  int32_t oldOut;
+  int32_t oldIn;
+} HP_FilterState_TypeDef;
+
+/* Results of one path */
+typedef struct
+{
+  double BspTime;            /* nS of the BSP filter */
+  double AppTime;            /* nS of AudioProcess_SD_Recording */
+  uint64_t Bytes;            /* Bytes written by the callbacks on the audio buffers */
+  uint64_t Saved;            /* Samples saved by the Writing thread */
+  uint32_t Hash;             /* Hash of the samples saved */
+} Result_T;
+
+/* Private variables ---------------------------------------------------------*/
+
+/* BSP: filter state and buffer where the next data are written */
+static HP_FilterState_TypeDef HP_Filter;
+static uint16_t *pBuff;
+static int32_t DMIC_Input[INPUT_CALLBACKS * MAX_SAMPLES_MS];
+
+static ULONG Samples;        /* PCM_AUDIO_IN_SAMPLES */
+static ULONG MessageEvents;
+static volatile int SkipFirst200mS;
+static volatile uint32_t WriteIndexBufferAudio;
+static ULONG LedToggles;
+
+/* PCM buffer of the BSP (old path) or for the data discarded (new path) */
+static uint16_t OnBoard_PCM_Buffer[2 * MAX_SAMPLES_MS];
+
+/* Old path */
+static uint16_t Old_Audio_OUT_Buff[MAX_SAMPLES_MS * OLD_BUFF_MS];
+static MessageData_T OldRingBuffer[OLD_AUDIO_RING_SIZE];
+static MsgRing_T OldRing;
+static volatile uint32_t ReadIndexBufferAudio;
+
+/* New path */
+static uint16_t New_Audio_OUT_Buff[NEW_AUDIO_RING_SIZE][MAX_SAMPLES_MS * NEW_BLOCK_MS] __attribute__ ((aligned (32)));
+static MessageData_T NewRingBuffer[NEW_AUDIO_RING_SIZE];
+static MsgRing_T NewRing;
+static MessageData_T * volatile AudioMsg;
+
+/* Filter output without the callbacks, for checking the audio saved */
+static uint16_t *Reference;
+
+/* nS of each callback (AudioProcess_SD_Recording and whole interrupt) for the percentiles */
+static float *AppSamples;
+static float *IsrSamples;
+
+/**
+* @brief  Events of the Writing thread (one OR, as tx_event_flags_set without waiting threads)
+* @param  group_ptr: Not used
+* @param  flags_to_set: Events
+* @param  set_option: Not used
+* @retval TX_SUCCESS
+*/
+UINT _tx_event_flags_set(TX_EVENT_FLAGS_GROUP *group_ptr, ULONG flags_to_set, UINT set_option)
+{
+  (void)group_ptr;
+  (void)set_option;
+  MessageEvents |= flags_to_set;
+  return TX_SUCCESS;
+}
+
+/**
+* @brief  Time in nS from one monotonic clock
+* @param  None
+* @retval Time in nS
+*/
+static double NowNs(void)
+{
+  struct timespec Ts;
+  clock_gettime(CLOCK_MONOTONIC, &Ts);
+  return Ts.tv_sec * 1e9 + Ts.tv_nsec;
+}
+
+/**
+* @brief  Hash of some samples (FNV-1a)
+* @param  Hash: Hash of the previous samples
+* @param  Data: Samples
+* @param  Count: Number of samples
+* @retval Hash
+*/
+static uint32_t Hash_Samples(uint32_t Hash, const uint16_t *Data, uint32_t Count)
+{
+  while (Count-- > 0) {
+    Hash = (Hash ^ *Data++) * 16777619U;
+  }
+  return Hash;
+}
+
+/**
+* @brief  BSP part of HAL_MDF_AcqHalfCpltCallback/HAL_MDF_AcqCpltCallback: the
+*         high pass filter and the volume of the digital microphone, written on pBuff
+* @param  Dmic: Samples of the MDF DMA buffer
+* @retval None
+*/
+static void Bsp_Filter(const int32_t *Dmic)
+{
+  uint32_t j;
+
+  for (j = 0U; j < Samples; j++) {
+    HP_Filter.Z = Dmic[j] * (int32_t)AUDIO_VOLUME_INPUT;
+    HP_Filter.oldOut = (0xFC * (HP_Filter.oldOut + HP_Filter.Z - HP_Filter.oldIn)) / 256;
+    HP_Filter.oldIn = HP_Filter.Z;
+    pBuff[j] = (uint16_t) SaturaLH(HP_Filter.oldOut, -32760, 32760);
+  }
+}
+
+/**
+* @brief  Old AudioProcess_SD_Recording: copy of the PCM buffer on the ping-pong buffer
+* @param  pInBuff     points to the audio buffer.
+* @param  len         number of samples to process.
+* @retval None
+*/
+static void Old_Recording(uint16_t *pInBuff, uint32_t len)
+{
+  uint32_t AudioBuffSize = Samples * OLD_BUFF_MS;
+
+  if(SkipFirst200mS>0) {
+    /* Tmp workaround for Initial Mic glitch */
+    SkipFirst200mS--;
+    return;
+  }
+  /* Accumulate audio buffer into local ping-pong buffer before writing */
+  memcpy(Old_Audio_OUT_Buff + WriteIndexBufferAudio, pInBuff, len * sizeof(uint16_t));
+  WriteIndexBufferAudio += len;
+
+  WriteIndexBufferAudio %=AudioBuffSize;
+
+  if((WriteIndexBufferAudio == (AudioBuffSize/2)) || (WriteIndexBufferAudio == 0)) {
+    MessageData_T *Msg;
+
+    /* first half or second half */
+    ReadIndexBufferAudio = (WriteIndexBufferAudio == 0) ? (AudioBuffSize/2) : 0;
+
+    /* If the ring is full the Writing thread has not yet saved the
+       previous data of this half: the block is lost (and counted) */
+    Msg = (MessageData_T *) MsgRing_Reserve(&OldRing);
+    if(Msg != NULL) {
+      Msg->CommandType = 1;
+      Msg->AudioIndex = ReadIndexBufferAudio;
+
+      /* Send te Message for writing out the 1/2 buffer */
+      MsgRing_Commit(&OldRing);
+      tx_event_flags_set(TX_NULL, 0x2U, TX_OR);
+    }
+  }
+
+  /* Control section */
+  if(ReadIndexBufferAudio==0) {
+    /* We need to read the First half */
+    if(WriteIndexBufferAudio<(AudioBuffSize/2)) {
+      LedToggles++;
+    }
+  } else if(ReadIndexBufferAudio==(AudioBuffSize/2)){
+    /* We need to Read the Second half */
+    if(WriteIndexBufferAudio>(AudioBuffSize/2)) {
+      LedToggles++;
+    }
+  }
+}
+
+/**
+* @brief  Position where the BSP must write the next audio data (AudioProcess_NextBuffer)
+* @param  None
+* @retval Pointer on the audio block or on the PCM buffer if the data must be discarded
+*/
+static uint16_t *New_NextBuffer(void)
+{
+  if(AudioMsg == NULL) {
+    return OnBoard_PCM_Buffer;
+  }
+
+  return New_Audio_OUT_Buff[AudioMsg - NewRingBuffer] + WriteIndexBufferAudio;
+}
+
+/**
+* @brief  New AudioProcess_SD_Recording: the BSP has already written the data on the audio block
+* @param  len         number of samples to process.
+* @retval None
+*/
+static void New_Recording(uint32_t len)
+{
+  uint32_t AudioBlockSamples = Samples * NEW_BLOCK_MS;
+
+  if(SkipFirst200mS>0) {
+    /* Tmp workaround for Initial Mic glitch */
+    SkipFirst200mS--;
+    return;
+  }
+
+  if(AudioMsg == NULL) {
+    /* The last data have been discarded: retry with one free block */
+    AudioMsg = (MessageData_T *) MsgRing_Reserve(&NewRing);
+    WriteIndexBufferAudio = 0;
+  } else {
+    WriteIndexBufferAudio += len;
+
+    if(WriteIndexBufferAudio == AudioBlockSamples) {
+      AudioMsg->CommandType = 1;
+      AudioMsg->AudioBlock = AudioMsg - NewRingBuffer;
+
+      /* Send te Message for writing out the block */
+      MsgRing_Commit(&NewRing);
+      tx_event_flags_set(TX_NULL, 0x2U, TX_OR);
+
+      /* If the ring is full the Writing thread has not yet saved the
+         oldest block: the next data are discarded (and counted) */
+      AudioMsg = (MessageData_T *) MsgRing_Reserve(&NewRing);
+      WriteIndexBufferAudio = 0;
+    }
+  }
+
+  if(AudioMsg == NULL) {
+    LedToggles++;
+  }
+
+  /* BSP_AUDIO_IN_SetBuffer */
+  pBuff = New_NextBuffer();
+}
+
+/**
+* @brief  Writing thread: save the blocks on the ring (hash of the samples)
+* @param  New: 1 for the new path
+* @param  Result: Results of the path
+* @retval None
+*/
+static void Writer_Save(int New, Result_T *Result)
+{
+  MsgRing_T *Ring = New ? &NewRing : &OldRing;
+  MessageData_T *Msg;
+  uint32_t Count = New ? (Samples * NEW_BLOCK_MS) : (Samples * OLD_BUFF_MS / 2);
+
+  while ((Msg = (MessageData_T *) MsgRing_Peek(Ring)) != NULL) {
+    const uint16_t *Data = New ? New_Audio_OUT_Buff[Msg->AudioBlock] : (Old_Audio_OUT_Buff + Msg->AudioIndex);
+    Result->Hash = Hash_Samples(Result->Hash, Data, Count);
+    Result->Saved += Count;
+    MsgRing_Release(Ring);
+  }
+}
+
+/**
+* @brief  Run the callbacks of one log
+* @param  New: 1 for the new path
+* @param  Callbacks: Number of 1 mS callbacks
+* @param  Result: Results of the path
+* @retval None
+*/
+static void Bench_Run(int New, uint32_t Callbacks, Result_T *Result)
+{
+  uint32_t Index;
+
+  memset(Result, 0, sizeof(Result_T));
+  Result->Hash = 2166136261U;
+  memset(&HP_Filter, 0, sizeof(HP_Filter));
+  SkipFirst200mS = SKIP_CALLBACKS;
+  WriteIndexBufferAudio = 0;
+  ReadIndexBufferAudio = 0xFFFFFF;
+  LedToggles = 0;
+
+  if (New) {
+    MsgRing_Init(&NewRing, NewRingBuffer, sizeof(MessageData_T), NEW_AUDIO_RING_SIZE);
+    AudioMsg = (MessageData_T *) MsgRing_Reserve(&NewRing);
+    pBuff = New_NextBuffer();
+  } else {
+    MsgRing_Init(&OldRing, OldRingBuffer, sizeof(MessageData_T), OLD_AUDIO_RING_SIZE);
+    pBuff = OnBoard_PCM_Buffer;
+  }
+
+  for (Index = 0; Index < Callbacks; Index++) {
+    const int32_t *Dmic = DMIC_Input + (Index % INPUT_CALLBACKS) * Samples;
+    double Start, Filtered, End;
+
+    Start = NowNs();
+    Bsp_Filter(Dmic);
+    Filtered = NowNs();
+    if (New) {
+      New_Recording(Samples);
+    } else {
+      Old_Recording(OnBoard_PCM_Buffer, Samples);
+    }
+    End = NowNs();
+
+    Result->BspTime += Filtered - Start;
+    Result->AppTime += End - Filtered;
+    AppSamples[Index] = (float)(End - Filtered);
+    IsrSamples[Index] = (float)(End - Start);
+
+    /* BSP filter output, plus the copy (read and write) of the old path */
+    Result->Bytes += Samples * sizeof(uint16_t);
+    if ((!New) && (Index >= SKIP_CALLBACKS)) {
+      Result->Bytes += 2 * Samples * sizeof(uint16_t);
+    }
+
+    /* The Writing thread saves the blocks as soon as they are ready */
+    if (MessageEvents != 0) {
+      MessageEvents = 0;
+      Writer_Save(New, Result);
+    }
+  }
+}
+
+/**
+* @brief  Filter output of all the callbacks after the skipped ones
+* @param  Callbacks: Number of 1 mS callbacks
+* @retval None
+*/
+static void Reference_Init(uint32_t Callbacks)
+{
+  uint32_t Index;
+
+  memset(&HP_Filter, 0, sizeof(HP_Filter));
+  for (Index = 0; Index < Callbacks; Index++) {
+    pBuff = (Index < SKIP_CALLBACKS) ? OnBoard_PCM_Buffer : (Reference + (Index - SKIP_CALLBACKS) * Samples);
+    Bsp_Filter(DMIC_Input + (Index % INPUT_CALLBACKS) * Samples);
+  }
+}
+
+/**
+* @brief  Compare two times for qsort
+* @param  a: First time
+* @param  b: Second time
+* @retval <0, 0, >0
+*/
+static int Compare(const void *a, const void *b)
+{
+  float x = *(const float *)a;
+  float y = *(const float *)b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+* @brief  Percentile of the times of the callbacks (the samples are sorted)
+* @param  Times: nS of each callback
+* @param  Callbacks: Number of callbacks
+* @param  Permille: Percentile (per thousand of the callbacks)
+* @retval nS
+*/
+static double Percentile(float *Times, uint32_t Callbacks, uint32_t Permille)
+{
+  qsort(Times, Callbacks, sizeof(Times[0]), Compare);
+  return Times[((uint64_t)Callbacks * Permille) / 1000U];
+}
+
+/**
+* @brief  Print the results of one path and check the audio saved
+* @param  Name: Path name
+* @param  Callbacks: Number of 1 mS callbacks
+* @param  Result: Results of the path
+* @retval 1 if the audio saved is the filter output
+*/
+static int Print_Result(const char *Name, uint32_t Callbacks, Result_T *Result)
+{
+  double Isr = (Result->BspTime + Result->AppTime) / Callbacks;
+  int Ok = (Result->Saved != 0) &&
+           (Hash_Samples(2166136261U, Reference, (uint32_t)Result->Saved) == Result->Hash);
+
+  printf("%-5s %8.1f %8.1f %10.1f %8.1f %10.1f %7.3f %8.1f %9s\n", Name, Result->BspTime / Callbacks,
+         Result->AppTime / Callbacks, Percentile(AppSamples, Callbacks, 999), Isr,
+         Percentile(IsrSamples, Callbacks, 999), Isr / 1e4,
+         (double)Result->Bytes / Callbacks, Ok ? "ok" : "DIFFERENT");
+
+  return Ok;
+}
+
+int main(int argc, char **argv)
+{
+  /* STEVAL-MKBOXPRO and STEVAL-STWINBX1 */
+  ULONG Rates[] = {16000, 48000};
+  unsigned int RatesNumber = sizeof(Rates) / sizeof(Rates[0]);
+  uint32_t Callbacks = DEFAULT_CALLBACKS;
+  ULONG Rate = 0;
+  Result_T Result;
+  int Failed = 0;
+  unsigned int r;
+  uint32_t i;
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-n") == 0) && (Arg + 1 < argc)) {
+      Callbacks = (uint32_t)strtoul(argv[++Arg], NULL, 0);
+    } else if ((strcmp(argv[Arg], "-f") == 0) && (Arg + 1 < argc)) {
+      Rate = strtoul(argv[++Arg], NULL, 0);
+    } else {
+      fprintf(stderr, "Usage: %s [-n callbacks] [-f Hz]\n", argv[0]);
+      return 1;
+    }
+  }
+  if ((Callbacks <= SKIP_CALLBACKS) || ((Rate % 1000) != 0) || ((Rate / 1000) > MAX_SAMPLES_MS)) {
+    fprintf(stderr, "More than %d callbacks, rate multiple of 1000 Hz up to %d KHz\n", SKIP_CALLBACKS, MAX_SAMPLES_MS);
+    return 1;
+  }
+  if (Rate != 0) {
+    Rates[0] = Rate;
+    RatesNumber = 1;
+  }
+
+  /* Digital microphone samples after the MDF filter (one 16 bit range before the volume) */
+  srand(1);
+  for (i = 0; i < (sizeof(DMIC_Input) / sizeof(DMIC_Input[0])); i++) {
+    DMIC_Input[i] = (rand() % 1024) - 512;
+  }
+
+  Reference = malloc((size_t)Callbacks * MAX_SAMPLES_MS * sizeof(uint16_t));
+  AppSamples = malloc((size_t)Callbacks * sizeof(float));
+  IsrSamples = malloc((size_t)Callbacks * sizeof(float));
+  if ((Reference == NULL) || (AppSamples == NULL) || (IsrSamples == NULL)) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  /* Time of one read of the clock, included in each time measured */
+  {
+    double Start = NowNs();
+    for (i = 0; i < 1000000; i++) {
+      NowNs();
+    }
+    printf("%lu callbacks of 1 mS (the first %d skipped), times in nS (each one with %.1f nS of clock read)\n",
+           (unsigned long)Callbacks, SKIP_CALLBACKS, (NowNs() - Start) / 1000000);
+  }
+  for (r = 0; r < RatesNumber; r++) {
+    Samples = Rates[r] / 1000;
+    Reference_Init(Callbacks);
+
+    printf("%lu Hz: old ping-pong buffer %u KB, new ring %u x %u KB\n", (unsigned long)Rates[r],
+           (unsigned)((Samples * OLD_BUFF_MS * sizeof(uint16_t)) / 1024), NEW_AUDIO_RING_SIZE,
+           (unsigned)((Samples * NEW_BLOCK_MS * sizeof(uint16_t)) / 1024));
+    printf("Path  BSP avg  App avg  App P99.9  ISR avg  ISR P99.9  Load %%  Bytes/cb  Audio\n");
+    Bench_Run(0, Callbacks, &Result);
+    Failed |= !Print_Result("Old", Callbacks, &Result);
+    Bench_Run(1, Callbacks, &Result);
+    Failed |= !Print_Result("New", Callbacks, &Result);
+  }
+
+  free(Reference);
+  free(AppSamples);
+  free(IsrSamples);
+
+  return Failed;
+}
@@ -0,0 +1,452 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\batchbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the write batching stage of the firmware: the
+  *          same log is written with one fx_file_write for each record and
+  *          through one batch buffer of different sizes, on the FileX RAM
+  *          driver (_fx_ram_driver) with one SD card latency model
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "fx_api.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* RAM disk: 64 MB, FAT16 with 4 KB clusters or exFAT with 32 KB clusters */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (128 * 1024)
+
+/* Same media cache of the firmware */
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define LOG_FILE_NAME         "Sens000.dat"
+
+/* Batch sizes compared (0: one fx_file_write for each record) */
+#define MAX_BATCH_SIZE        (32 * 1024)
+static const ULONG BatchSizes[] = {0, 4 * 1024, 16 * 1024, 32 * 1024};
+#define BATCH_SIZES           (sizeof(BatchSizes) / sizeof(BatchSizes[0]))
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Latency model of the SD card: each request costs one command overhead plus
+   the bus transfer, then after each write the card is busy programming */
+typedef struct
+{
+  double CommandTime;        /* uS for each request */
+  double BusRate;            /* MB/s on the bus */
+  double ProgramTime;        /* uS of card busy after each write */
+} Latency_T;
+
+/* Requests seen by the driver */
+typedef struct
+{
+  uint64_t ReadRequests;
+  uint64_t ReadSectors;
+  uint64_t WriteRequests;
+  uint64_t WriteSectors;
+  double Time;               /* uS of the simulated card */
+} DriverStats_T;
+
+/* Same single buffer write batching stage of app_filex.c (WriteBatch_T)
+   without the deadline */
+typedef struct
+{
+  FX_FILE *File;
+  UCHAR *Buffer;
+  ULONG Size;
+  ULONG Index;
+  ULONG Limit;
+  ULONG64 Offset;
+  ULONG WriteCalls;
+} WriteBatch_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk;
+static Latency_T Latency = {100.0, 25.0, 800.0};
+static DriverStats_T Stats;
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+
+static UCHAR BatchBuffer[MAX_BATCH_SIZE] __attribute__ ((aligned (32)));
+static UCHAR Record[4096];
+
+static int ExFat = 0;
+
+extern VOID _fx_ram_driver(FX_MEDIA *media_ptr);
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  FileX RAM driver counting the requests and their time on the card model
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID Bench_Driver(FX_MEDIA *media_ptr)
+{
+  ULONG Count = media_ptr->fx_media_driver_sectors;
+
+  switch (media_ptr->fx_media_driver_request) {
+  case FX_DRIVER_READ:
+    Stats.ReadRequests++;
+    Stats.ReadSectors += Count;
+    Stats.Time += Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate;
+    break;
+  case FX_DRIVER_WRITE:
+    Stats.WriteRequests++;
+    Stats.WriteSectors += Count;
+    Stats.Time += Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate + Latency.ProgramTime;
+    break;
+  case FX_DRIVER_RELEASE_SECTORS:
+    /* Not handled by the RAM driver: nothing to do */
+    media_ptr->fx_media_driver_status = FX_SUCCESS;
+    return;
+  default:
+    break;
+  }
+
+  /* The RAM disk is given by fx_media_open (fx_media_driver_info) */
+  _fx_ram_driver(media_ptr);
+}
+
+/**
+* @brief  Host time in uS
+* @param  None
+* @retval Time
+*/
+static double Now(void)
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+
+  return Time.tv_sec * 1e6 + Time.tv_nsec / 1e3;
+}
+
+/**
+* @brief  Byte of the log at one offset (for checking the file)
+* @param  Offset: Offset on the log
+* @retval Byte value
+*/
+static UCHAR Log_Byte(ULONG64 Offset)
+{
+  return (UCHAR)((Offset * 7) ^ (Offset >> 9));
+}
+
+/**
+* @brief  Start the write batching stage for the file just opened (WriteBatch_SetFile)
+* @param  Batch: Pointer to the write batching stage
+* @param  Size: Batch size
+* @retval None
+*/
+static void WriteBatch_Init(WriteBatch_T *Batch, ULONG Size)
+{
+  ULONG ClusterSize = ((ULONG)Media.fx_media_sectors_per_cluster) * Media.fx_media_bytes_per_sector;
+
+  if (ClusterSize <= Size) {
+    Batch->Size = Size - (Size % ClusterSize);
+  } else {
+    Batch->Size = Size;
+  }
+  Batch->File = &File;
+  Batch->Buffer = BatchBuffer;
+  Batch->Index = 0;
+  Batch->Offset = File.fx_file_current_file_offset;
+  Batch->Limit = Batch->Size - (ULONG)(Batch->Offset % Batch->Size);
+  Batch->WriteCalls = 0;
+}
+
+/**
+* @brief  Write out the data present on the buffer (WriteBatch_Flush)
+* @param  Batch: Pointer to the write batching stage
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT WriteBatch_Flush(WriteBatch_T *Batch)
+{
+  ULONG Size = Batch->Index;
+
+  if (Size == 0) {
+    return FX_SUCCESS;
+  }
+
+  Batch->Index = 0;
+  Batch->Offset += Size;
+  Batch->Limit = Batch->Size - (ULONG)(Batch->Offset % Batch->Size);
+  Batch->WriteCalls++;
+
+  return fx_file_write(Batch->File, Batch->Buffer, Size);
+}
+
+/**
+* @brief  Add data to the write batching stage (WriteBatch_Write)
+* @param  Batch: Pointer to the write batching stage
+* @param  Data: Pointer to the data
+* @param  Size: Number of bytes
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT WriteBatch_Write(WriteBatch_T *Batch, VOID *Data, ULONG Size)
+{
+  UINT status = FX_SUCCESS;
+  UCHAR *Source = (UCHAR *) Data;
+  ULONG Len;
+
+  while ((Size > 0) && (status == FX_SUCCESS)) {
+    if ((Batch->Index == 0) && (Batch->Limit == Batch->Size) && (Size >= Batch->Size)) {
+      Len = Size - (Size % Batch->Size);
+      Batch->WriteCalls++;
+      status = fx_file_write(Batch->File, Source, Len);
+      Batch->Offset += Len;
+    } else {
+      Len = Batch->Limit - Batch->Index;
+      if (Len > Size) {
+        Len = Size;
+      }
+      memcpy(Batch->Buffer + Batch->Index, Source, Len);
+      Batch->Index += Len;
+      if (Batch->Index == Batch->Limit) {
+        status = WriteBatch_Flush(Batch);
+      }
+    }
+    Source += Len;
+    Size -= Len;
+  }
+
+  return status;
+}
+
+/**
+* @brief  Format the RAM disk
+* @param  None
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT RamDisk_Format(void)
+{
+  memset(Disk, 0, (size_t)DISK_SECTORS * DISK_SECTOR_SIZE);
+
+  if (ExFat) {
+    return fx_media_exFAT_format(&Media, Bench_Driver, Disk, MediaMemory, sizeof(MediaMemory),
+                                 "BATCH", 1, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 64, 12345, 0);
+  }
+
+  return fx_media_format(&Media, Bench_Driver, Disk, MediaMemory, sizeof(MediaMemory),
+                         "BATCH", 2, 512, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 8, 1, 1);
+}
+
+/**
+* @brief  Read back the log and compare it with the data written
+* @param  LogSize: Log size in bytes
+* @retval 1 if the log is correct
+*/
+static int Log_Check(ULONG64 LogSize)
+{
+  ULONG64 Offset = 0;
+  ULONG Read = 0;
+  ULONG i;
+
+  if ((fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_READ) != FX_SUCCESS) ||
+      (File.fx_file_current_file_size != LogSize)) {
+    return 0;
+  }
+
+  while ((fx_file_read(&File, BatchBuffer, sizeof(BatchBuffer), &Read) == FX_SUCCESS) && (Read > 0)) {
+    for (i = 0; i < Read; i++) {
+      if (BatchBuffer[i] != Log_Byte(Offset + i)) {
+        return 0;
+      }
+    }
+    Offset += Read;
+  }
+  fx_file_close(&File);
+
+  return Offset == LogSize;
+}
+
+/**
+* @brief  Write one log of LogSize bytes made by records of RecordSize bytes
+* @param  LogSize: Log size in bytes
+* @param  RecordSize: Bytes of each record
+* @param  BatchSize: Bytes of the batch buffer (0 for one fx_file_write for each record)
+* @retval 1 if the log was written and read back correctly
+*/
+static int Bench_Run(ULONG64 LogSize, ULONG RecordSize, ULONG BatchSize)
+{
+  WriteBatch_T Batch = {0};
+  ULONG64 Offset;
+  ULONG FileWrites = 0;
+  double Start, Host;
+  UINT status;
+  ULONG i;
+
+  status = RamDisk_Format();
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "BATCH", Bench_Driver, Disk, MediaMemory, sizeof(MediaMemory));
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_create(&Media, LOG_FILE_NAME);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+  if (status != FX_SUCCESS) {
+    fprintf(stderr, "FileX error 0x%x\n", status);
+    return 0;
+  }
+
+  if (BatchSize != 0) {
+    WriteBatch_Init(&Batch, BatchSize);
+  }
+
+  memset(&Stats, 0, sizeof(Stats));
+  Start = Now();
+  for (Offset = 0; (Offset < LogSize) && (status == FX_SUCCESS); Offset += RecordSize) {
+    for (i = 0; i < RecordSize; i++) {
+      Record[i] = Log_Byte(Offset + i);
+    }
+    if (BatchSize != 0) {
+      status = WriteBatch_Write(&Batch, Record, RecordSize);
+    } else {
+      status = fx_file_write(&File, Record, RecordSize);
+      FileWrites++;
+    }
+  }
+  if ((status == FX_SUCCESS) && (BatchSize != 0)) {
+    status = WriteBatch_Flush(&Batch);
+    FileWrites = Batch.WriteCalls;
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(&Media);
+  }
+  Host = Now() - Start;
+
+  if (status != FX_SUCCESS) {
+    fprintf(stderr, "FileX error 0x%x\n", status);
+    return 0;
+  }
+
+  if (BatchSize == 0) {
+    printf("%6lu  unbatched  ", (unsigned long)RecordSize);
+  } else {
+    printf("%6lu  %5lu KB   ", (unsigned long)RecordSize, (unsigned long)(Batch.Size / 1024));
+  }
+  printf("%9lu %9lu %8lu %8lu %9.1f %8.2f %8.2f\n",
+         (unsigned long)FileWrites, (unsigned long)Stats.WriteRequests, (unsigned long)Stats.WriteSectors,
+         (unsigned long)Stats.ReadSectors, (double)Stats.WriteSectors * DISK_SECTOR_SIZE / (Stats.WriteRequests * 1024.0),
+         LogSize / Stats.Time, LogSize / Host);
+
+  status = Log_Check(Offset);
+  fx_media_close(&Media);
+
+  return (status != 0);
+}
+
+int main(int argc, char **argv)
+{
+  ULONG64 LogSize = 8 * 1024 * 1024;
+  ULONG RecordSizes[16];
+  ULONG NumRecordSizes = 0;
+  ULONG r, b;
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if (strcmp(argv[Arg], "-x") == 0) {
+      ExFat = 1;
+    } else if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      LogSize = (ULONG64)(atof(argv[++Arg]) * 1024 * 1024);
+    } else if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc)) {
+      Latency.CommandTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Latency.BusRate = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      Latency.ProgramTime = atof(argv[++Arg]);
+    } else if ((argv[Arg][0] != '-') && (NumRecordSizes < 16)) {
+      RecordSizes[NumRecordSizes++] = strtoul(argv[Arg], NULL, 0);
+    } else {
+      fprintf(stderr, "Usage: %s [-x] [-m MB] [-c uS] [-b MB/s] [-p uS] [record bytes...]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (NumRecordSizes == 0) {
+    /* Binary sensors record, CSV sensors line and one compressed audio frame */
+    RecordSizes[NumRecordSizes++] = 48;
+    RecordSizes[NumRecordSizes++] = 79;
+    RecordSizes[NumRecordSizes++] = 612;
+  }
+  for (r = 0; r < NumRecordSizes; r++) {
+    if ((RecordSizes[r] == 0) || (RecordSizes[r] > sizeof(Record))) {
+      fprintf(stderr, "Record size from 1 to %u bytes\n", (unsigned)sizeof(Record));
+      return 1;
+    }
+  }
+  if ((LogSize == 0) || (LogSize > (DISK_SECTORS / 2) * (ULONG64)DISK_SECTOR_SIZE)) {
+    fprintf(stderr, "Log size up to %u MB\n", (DISK_SECTORS / 2) * DISK_SECTOR_SIZE / (1024 * 1024));
+    return 1;
+  }
+
+  Disk = malloc((size_t)DISK_SECTORS * DISK_SECTOR_SIZE);
+  if (Disk == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  fx_system_initialize();
+
+  printf("%s, %.1f MB for each log, SD request %.0f uS + %.1f MB/s, busy %.0f uS after each write\n",
+         ExFat ? "exFAT 32 KB clusters" : "FAT16 4 KB clusters", LogSize / (1024.0 * 1024.0),
+         Latency.CommandTime, Latency.BusRate, Latency.ProgramTime);
+  printf("Record  Batch      FileWrite  Requests  Written     Read  KB/Write  SD MB/s  Host MB/s\n");
+
+  for (r = 0; r < NumRecordSizes; r++) {
+    for (b = 0; b < BATCH_SIZES; b++) {
+      if (!Bench_Run(LogSize, RecordSizes[r], BatchSizes[b])) {
+        fprintf(stderr, "Log not written correctly\n");
+        free(Disk);
+        return 1;
+      }
+    }
+  }
+
+  free(Disk);
+
+  return 0;
+}
@@ -0,0 +1,433 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\cachebench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the FileX caches of the firmware: the media
+  *          memory given to fx_media_open (STBOX1_SD_MEDIA_CACHE_SECTORS) is
+  *          swept at run time, FX_MAX_FAT_CACHE and FX_FAT_MAP_SIZE are the
+  *          ones of the FileX build (one cachebench-<fat>-<map> for each
+  *          configuration, see the Makefile). The driver reads and writes of
+  *          some logs and of one append after the logs are reported
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fx_api.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated SD card: 32 GB, FAT32 with 32 KB clusters (8192 sectors for each
+   FAT). The memory is allocated only for the parts written */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (64UL * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_CHUNKS           (DISK_SECTORS / DISK_CHUNK_SECTORS)
+#define CLUSTER_SECTORS       64
+
+/* Same names and writes of the firmware: one 16 KB batch of the sensors for
+   each AUDIO_WRITES_FOR_BATCH audio blocks of 48 KB */
+#define SENSORS_FILE_NAME     "Sens%03d.csv"
+#define AUDIO_FILE_NAME       "Mic%03d.wav"
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define AUDIO_BLOCK_SIZE      (48 * 1024)
+#define AUDIO_WRITES_FOR_BATCH 4
+
+/* Media memory sizes swept by default (sectors, up to FX_MAX_SECTOR_CACHE) */
+#define MAX_CACHE_SECTORS     FX_MAX_SECTOR_CACHE
+static const ULONG DefaultCacheSectors[] = {1, 4, 8, 16, 32, 64};
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Driver requests and FileX cache misses of one phase */
+typedef struct
+{
+  ULONG ReadRequests;
+  ULONG64 ReadSectors;
+  ULONG WriteRequests;
+  ULONG64 WriteSectors;
+  ULONG FatSectorWrites;     /* FAT sectors written by FileX (both FATs) */
+  ULONG FatMisses;           /* FAT entry cache read misses */
+} Cost_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk[DISK_CHUNKS];
+static ULONG64 DiskReadSectors;
+static ULONG64 DiskWriteSectors;
+
+static UCHAR MediaMemory[MAX_CACHE_SECTORS * DISK_SECTOR_SIZE] __attribute__ ((aligned (32)));
+static FX_MEDIA Media;
+static FX_FILE SensorsFile;
+static FX_FILE AudioFile;
+
+static UCHAR SensorsBatch[WRITE_BATCH_SIZE];
+static UCHAR AudioBlock[AUDIO_BLOCK_SIZE];
+
+static ULONG Logs = 4;
+static ULONG LogMB = 32;
+static ULONG FlushBlocks = 32;
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated card
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Buffer: Data
+* @param  Write: 1 for writing the card
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Buffer, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Data;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Buffer, 0, DISK_SECTOR_SIZE);
+    } else {
+      Data = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Data, Buffer, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Buffer, Data, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Buffer += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Free the simulated card
+* @param  None
+* @retval None
+*/
+static void Disk_Free(void)
+{
+  ULONG Chunk;
+
+  for (Chunk = 0; Chunk < DISK_CHUNKS; Chunk++) {
+    free(Disk[Chunk]);
+    Disk[Chunk] = NULL;
+  }
+}
+
+/**
+* @brief  Simulated SD card driver counting the sectors read and written
+*         (FileX counts the requests)
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID SimDisk_Driver(FX_MEDIA *media_ptr)
+{
+  media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+  switch (media_ptr->fx_media_driver_request) {
+  case FX_DRIVER_READ:
+    Disk_Copy((ULONG)media_ptr->fx_media_driver_logical_sector, media_ptr->fx_media_driver_sectors,
+              media_ptr->fx_media_driver_buffer, 0);
+    DiskReadSectors += media_ptr->fx_media_driver_sectors;
+    break;
+  case FX_DRIVER_WRITE:
+    Disk_Copy((ULONG)media_ptr->fx_media_driver_logical_sector, media_ptr->fx_media_driver_sectors,
+              media_ptr->fx_media_driver_buffer, 1);
+    DiskWriteSectors += media_ptr->fx_media_driver_sectors;
+    break;
+  case FX_DRIVER_BOOT_READ:
+    Disk_Copy(0, 1, media_ptr->fx_media_driver_buffer, 0);
+    break;
+  case FX_DRIVER_BOOT_WRITE:
+    Disk_Copy(0, 1, media_ptr->fx_media_driver_buffer, 1);
+    break;
+  default:
+    /* Init, flush, abort, release sectors and uninit: nothing to do */
+    break;
+  }
+}
+
+/**
+* @brief  Snapshot of the counters for one phase
+* @param  Cost: Counters to be filled
+* @retval None
+*/
+static void Cost_Get(Cost_T *Cost)
+{
+  Cost->ReadRequests = Media.fx_media_driver_read_requests;
+  Cost->ReadSectors = DiskReadSectors;
+  Cost->WriteRequests = Media.fx_media_driver_write_requests;
+  Cost->WriteSectors = DiskWriteSectors;
+  Cost->FatSectorWrites = Media.fx_media_fat_sector_writes;
+  Cost->FatMisses = Media.fx_media_fat_entry_cache_read_misses;
+}
+
+/**
+* @brief  Counters of one phase: difference from the snapshot at its start
+* @param  Cost: Snapshot at the start, replaced by the difference
+* @retval None
+*/
+static void Cost_End(Cost_T *Cost)
+{
+  Cost_T End;
+
+  Cost_Get(&End);
+  Cost->ReadRequests = End.ReadRequests - Cost->ReadRequests;
+  Cost->ReadSectors = End.ReadSectors - Cost->ReadSectors;
+  Cost->WriteRequests = End.WriteRequests - Cost->WriteRequests;
+  Cost->WriteSectors = End.WriteSectors - Cost->WriteSectors;
+  Cost->FatSectorWrites = End.FatSectorWrites - Cost->FatSectorWrites;
+  Cost->FatMisses = End.FatMisses - Cost->FatMisses;
+}
+
+/**
+* @brief  Create the first free log file as the firmware does (one name after
+*         the other from 000) and open it
+* @param  File: FileX file
+* @param  Format: SENSORS_FILE_NAME or AUDIO_FILE_NAME
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Log_Open(FX_FILE *File, const CHAR *Format)
+{
+  CHAR Name[32];
+  UINT status;
+  int Counter = 0;
+
+  do {
+    sprintf(Name, Format, Counter++);
+    status = fx_file_create(&Media, Name);
+  } while (status == FX_ALREADY_CREATED);
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, File, Name, FX_OPEN_FOR_WRITE);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Save one log: the sensors batches and the audio blocks interleaved,
+*         with one fx_media_flush each FlushBlocks audio blocks (as the log
+*         checkpoint) and at the end
+* @param  None
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Log_Save(void)
+{
+  ULONG Blocks = (LogMB * 1024 * 1024) / AUDIO_BLOCK_SIZE;
+  ULONG Block;
+  UINT status;
+
+  status = Log_Open(&SensorsFile, SENSORS_FILE_NAME);
+  if (status == FX_SUCCESS) {
+    status = Log_Open(&AudioFile, AUDIO_FILE_NAME);
+  }
+
+  for (Block = 0; (Block < Blocks) && (status == FX_SUCCESS); Block++) {
+    status = fx_file_write(&AudioFile, AudioBlock, AUDIO_BLOCK_SIZE);
+    if ((status == FX_SUCCESS) && ((Block % AUDIO_WRITES_FOR_BATCH) == AUDIO_WRITES_FOR_BATCH - 1)) {
+      status = fx_file_write(&SensorsFile, SensorsBatch, WRITE_BATCH_SIZE);
+    }
+    if ((status == FX_SUCCESS) && (FlushBlocks != 0) && ((Block % FlushBlocks) == FlushBlocks - 1)) {
+      status = fx_media_flush(&Media);
+    }
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&SensorsFile);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&AudioFile);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Append one block to the audio file of the first log: the seek to
+*         its end walks all its cluster chain on the FAT
+* @param  None
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Log_Append(void)
+{
+  CHAR Name[32];
+  UINT status;
+
+  sprintf(Name, AUDIO_FILE_NAME, 0);
+  status = fx_file_open(&Media, &AudioFile, Name, FX_OPEN_FOR_WRITE);
+  if (status == FX_SUCCESS) {
+    status = fx_file_seek(&AudioFile, 0xFFFFFFFFUL);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_write(&AudioFile, AudioBlock, AUDIO_BLOCK_SIZE);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&AudioFile);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Format the card and save the logs with one media memory size
+* @param  CacheSectors: Sectors of the media memory
+* @param  Log: Cost of the logs
+* @param  Append: Cost of the append after the logs
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Bench_Run(ULONG CacheSectors, Cost_T *Log, Cost_T *Append)
+{
+  ULONG CacheSize = CacheSectors * DISK_SECTOR_SIZE;
+  ULONG Index;
+  UINT status;
+
+  Disk_Free();
+  DiskReadSectors = 0;
+  DiskWriteSectors = 0;
+
+  status = fx_media_format(&Media, SimDisk_Driver, NULL, MediaMemory, CacheSize,
+                           "CACHE", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, CLUSTER_SECTORS, 1, 1);
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "CACHE", SimDisk_Driver, NULL, MediaMemory, CacheSize);
+  }
+
+  if (status == FX_SUCCESS) {
+    Cost_Get(Log);
+    for (Index = 0; (Index < Logs) && (status == FX_SUCCESS); Index++) {
+      status = Log_Save();
+    }
+    Cost_End(Log);
+  }
+
+  if (status == FX_SUCCESS) {
+    Cost_Get(Append);
+    status = Log_Append();
+    Cost_End(Append);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+int main(int argc, char **argv)
+{
+  ULONG CacheSectors[16];
+  ULONG NumCacheSectors = 0;
+  int Header = 0;
+  ULONG i;
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if (strcmp(argv[Arg], "-H") == 0) {
+      Header = 1;
+    } else if ((strcmp(argv[Arg], "-l") == 0) && (Arg + 1 < argc)) {
+      Logs = strtoul(argv[++Arg], NULL, 0);
+    } else if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      LogMB = strtoul(argv[++Arg], NULL, 0);
+    } else if ((strcmp(argv[Arg], "-f") == 0) && (Arg + 1 < argc)) {
+      FlushBlocks = strtoul(argv[++Arg], NULL, 0);
+    } else if ((argv[Arg][0] != '-') && (NumCacheSectors < 16)) {
+      CacheSectors[NumCacheSectors++] = strtoul(argv[Arg], NULL, 0);
+    } else {
+      fprintf(stderr, "Usage: %s [-H] [-l logs] [-m MB] [-f blocks] [cache sectors...]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (NumCacheSectors == 0) {
+    for (i = 0; i < sizeof(DefaultCacheSectors) / sizeof(DefaultCacheSectors[0]); i++) {
+      CacheSectors[NumCacheSectors++] = DefaultCacheSectors[i];
+    }
+  }
+  for (i = 0; i < NumCacheSectors; i++) {
+    if ((CacheSectors[i] == 0) || (CacheSectors[i] > MAX_CACHE_SECTORS)) {
+      fprintf(stderr, "Media memory from 1 to %d sectors\n", MAX_CACHE_SECTORS);
+      return 1;
+    }
+  }
+  if ((Logs == 0) || (LogMB == 0) || (Logs * LogMB * 2 > 16 * 1024)) {
+    fprintf(stderr, "Wrong logs\n");
+    return 1;
+  }
+
+  fx_system_initialize();
+
+  if (Header) {
+    printf("FAT32 32 KB clusters, %lu logs of %lu MB (audio + sensors), fx_media_flush every %lu audio blocks\n",
+           (unsigned long)Logs, (unsigned long)LogMB, (unsigned long)FlushBlocks);
+    printf("                       |                 Logs                  |            Append\n");
+    printf("FatCache  FatMap Cache |  Reads  RdSect  Writes   WrSect  FatWr |  Reads  RdSect  Writes FatMiss\n");
+  }
+
+  for (i = 0; i < NumCacheSectors; i++) {
+    Cost_T Log, Append;
+    UINT status = Bench_Run(CacheSectors[i], &Log, &Append);
+
+    if (status != FX_SUCCESS) {
+      fprintf(stderr, "FileX error 0x%x\n", status);
+      Disk_Free();
+      return 1;
+    }
+
+    printf("%8d %7d %5lu | %6lu %7lu %7lu %8lu %6lu | %6lu %7lu %7lu %7lu\n",
+           FX_MAX_FAT_CACHE, FX_FAT_MAP_SIZE, (unsigned long)CacheSectors[i],
+           (unsigned long)Log.ReadRequests, (unsigned long)Log.ReadSectors, (unsigned long)Log.WriteRequests,
+           (unsigned long)Log.WriteSectors, (unsigned long)Log.FatSectorWrites, (unsigned long)Append.ReadRequests, (unsigned long)Append.ReadSectors,
+           (unsigned long)Append.WriteRequests, (unsigned long)Append.FatMisses);
+  }
+
+  Disk_Free();
+
+  return 0;
+}
@@ -0,0 +1,541 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\cardbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Benchmark of the card ready wait of the FileX SD driver
+  *          (STBOX1_SD_CARD_EVENTS) on the ThreadX Linux port: one log written
+  *          by FileX on one simulated card, busy for some time after each
+  *          write, with the driver polling the card status and with the driver
+  *          sleeping until the busy end interrupt
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "tx_api.h"
+#include "fx_api.h"
+#include "fx_stm32_sd_driver.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated SD card: 4 GB (SDHC) formatted FAT32 with 32 KB clusters. The
+   memory is allocated only for the parts written */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (8 * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_CHUNKS           (DISK_SECTORS / DISK_CHUNK_SECTORS)
+
+/* Same write batching stage, media cache and thread priorities of the firmware */
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define LOG_FILE_NAME         "Log000.stb"
+#define WRITER_THREAD_PRIO    12
+#define LOWER_THREAD_PRIO     20
+#define THREAD_STACK_SIZE     (16 * 1024)
+
+/* Same backoff of the firmware (STBOX1_SD_CARD_MAX_BACKOFF) */
+#define CARD_MAX_BACKOFF      4
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Latency model of the SD card: after each write the card is busy for the
+   command, the bus transfer and the programming of the data */
+typedef struct
+{
+  double CommandTime;        /* uS for each request */
+  double BusRate;            /* MB/s on the bus */
+  double ProgramTime;        /* uS of card busy after each write */
+} Latency_T;
+
+/* One way of waiting the card ready */
+typedef struct
+{
+  const char *Name;
+  VOID (*Driver)(FX_MEDIA *media_ptr);
+  FX_STM32_SD_DRIVER_STATS *Stats;
+  int Interrupt;             /* 1 for signalling the busy end */
+} Mode_T;
+
+/* Private variables ---------------------------------------------------------*/
+extern VOID fx_stm32_sd_driver_events0(FX_MEDIA *media_ptr);
+extern VOID fx_stm32_sd_driver_events1(FX_MEDIA *media_ptr);
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_events0;
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_events1;
+
+/* ThreadX Linux port: simulated interrupts */
+extern VOID _tx_thread_context_save(VOID);
+extern VOID _tx_thread_context_restore(VOID);
+
+static const Mode_T Modes[] = {
+  {"polling", fx_stm32_sd_driver_events0, &fx_stm32_sd_driver_stats_events0, 0},
+  {"busy end IRQ", fx_stm32_sd_driver_events1, &fx_stm32_sd_driver_stats_events1, 1},
+  {"backoff only", fx_stm32_sd_driver_events1, &fx_stm32_sd_driver_stats_events1, 0},
+};
+#define MODES                 (sizeof(Modes) / sizeof(Modes[0]))
+
+static UCHAR *Disk[DISK_CHUNKS];
+static Latency_T Latency = {100.0, 25.0, 800.0};
+static ULONG64 LogSize = 4ULL * 1024 * 1024;
+static const Mode_T *Mode;
+
+/* Card state, same of fx_stm32_sd_driver_glue.c with STBOX1_SD_CARD_EVENTS */
+static volatile uint64_t CardBusyEnd;     /* uS of the busy end */
+static volatile UINT card_busy;
+static TX_SEMAPHORE card_ready_semaphore;
+static FX_STM32_SD_CARD_STATS CardStats;
+static ULONG StatusCommands;
+
+/* Simulated SDMMC interrupt */
+static pthread_t IrqThread;
+static sem_t IrqStart;
+
+static volatile int LowerRunning;
+static volatile uint64_t LowerLoops;
+
+static TX_THREAD WriterThread;
+static TX_THREAD LowerThread;
+static ULONG WriterStack[THREAD_STACK_SIZE / sizeof(ULONG)];
+static ULONG LowerStack[THREAD_STACK_SIZE / sizeof(ULONG)];
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+
+static UCHAR Batch[WRITE_BATCH_SIZE] __attribute__ ((aligned (32)));
+
+/**
+* @brief  Time of the host
+* @param  None
+* @retval uS
+*/
+static uint64_t Now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)(ts.tv_nsec / 1000);
+}
+
+/**
+* @brief  Time base of the driver statistics (DWT on the board)
+* @param  None
+* @retval uS
+*/
+ULONG fx_stm32_sd_host_cycles(VOID)
+{
+  return (ULONG)Now_us();
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated card
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Data: Data
+* @param  Write: 1 for writing the card
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Data, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Sectors;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Data, 0, DISK_SECTOR_SIZE);
+    } else {
+      Sectors = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Sectors, Data, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Data, Sectors, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Data += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Free the simulated card
+* @param  None
+* @retval None
+*/
+static void Disk_Free(void)
+{
+  ULONG Chunk;
+
+  for (Chunk = 0; Chunk < DISK_CHUNKS; Chunk++) {
+    free(Disk[Chunk]);
+    Disk[Chunk] = NULL;
+  }
+}
+
+/**
+* @brief  Simulated SDMMC interrupt: one host thread that waits for the busy end
+*         and runs fx_stm32_sd_card_irq as one ThreadX interrupt (the same way
+*         of the timer interrupt of the Linux port)
+* @param  Arg: Not used
+* @retval None
+*/
+static void *Irq_Thread(void *Arg)
+{
+  struct timespec ts;
+  uint64_t End;
+
+  (void)Arg;
+
+  for (;;) {
+    while (sem_wait(&IrqStart) != 0) {
+    }
+
+    End = CardBusyEnd;
+    ts.tv_sec = (time_t)(End / 1000000U);
+    ts.tv_nsec = (long)((End % 1000000U) * 1000U);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+
+    _tx_thread_context_save();
+    fx_stm32_sd_card_irq(FX_STM32_SD_INSTANCE);
+    _tx_thread_context_restore();
+  }
+
+  return NULL;
+}
+
+/**
+* @brief  SD functions used by the driver (fx_stm32_sd_driver_glue.c on the board)
+*/
+INT fx_stm32_sd_init(UINT Instance)
+{
+  (void)Instance;
+
+  memset(&CardStats, 0, sizeof(CardStats));
+  card_busy = 0;
+
+  return 0;
+}
+
+INT fx_stm32_sd_deinit(UINT Instance)
+{
+  (void)Instance;
+  return 0;
+}
+
+INT fx_stm32_sd_get_status(UINT Instance)
+{
+  (void)Instance;
+
+  /* One card status command (CMD13) */
+  StatusCommands++;
+  return (Now_us() < CardBusyEnd) ? 1 : 0;
+}
+
+INT fx_stm32_sd_read_blocks(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks)
+{
+  (void)Instance;
+
+  if (StartSector + NbrOfBlocks > DISK_SECTORS) {
+    return 1;
+  }
+
+  Disk_Copy(StartSector, NbrOfBlocks, (UCHAR *)Buffer, 0);
+
+  return 0;
+}
+
+INT fx_stm32_sd_write_blocks(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks)
+{
+  (void)Instance;
+
+  if (StartSector + NbrOfBlocks > DISK_SECTORS) {
+    return 1;
+  }
+
+  Disk_Copy(StartSector, NbrOfBlocks, (UCHAR *)Buffer, 1);
+
+  /* The card is busy from the command to the end of the programming */
+  card_busy = 1;
+  CardBusyEnd = Now_us() + (uint64_t)(Latency.CommandTime + (NbrOfBlocks * DISK_SECTOR_SIZE) / Latency.BusRate +
+                                      Latency.ProgramTime);
+
+  /* End of the transfer: the busy end interrupt is enabled */
+  if (Mode->Interrupt) {
+    sem_post(&IrqStart);
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Busy end interrupt (same of fx_stm32_sd_card_irq in fx_stm32_sd_driver_glue.c)
+* @param  Instance: SD instance
+* @retval None
+*/
+VOID fx_stm32_sd_card_irq(UINT Instance)
+{
+  (void)Instance;
+
+  card_busy = 0;
+  CardStats.Events++;
+  tx_semaphore_ceiling_put(&card_ready_semaphore, 1);
+}
+
+/**
+* @brief  Same steps of fx_stm32_sd_wait_ready (fx_stm32_sd_driver_glue.c): the
+*         thread sleeps until the busy end interrupt, or it checks the card status
+*         after 1, 2, 4 .. CARD_MAX_BACKOFF ticks
+* @param  Instance: SD instance
+* @retval 0 when ready 1 on timeout
+*/
+INT fx_stm32_sd_wait_ready(UINT Instance)
+{
+  ULONG start = tx_time_get();
+  ULONG backoff = 1;
+
+  if (card_busy == 0) {
+    return 0;
+  }
+
+  CardStats.Busy++;
+
+  for (;;) {
+    CardStats.Polls++;
+    if (fx_stm32_sd_get_status(Instance) == 0) {
+      card_busy = 0;
+      return 0;
+    }
+
+    if (tx_time_get() - start >= 10 * TX_TIMER_TICKS_PER_SECOND) {
+      CardStats.Timeouts++;
+      return 1;
+    }
+
+    if (tx_semaphore_get(&card_ready_semaphore, backoff) == TX_SUCCESS) {
+      if (card_busy == 0) {
+        return 0;
+      }
+    } else if (backoff < CARD_MAX_BACKOFF) {
+      backoff *= 2;
+    }
+  }
+}
+
+/**
+* @brief  One log with one mode: one new file written with WRITE_BATCH_SIZE
+*         bytes for each fx_file_write
+* @param  Time: uS of the log
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT CardLog(uint64_t *Time)
+{
+  ULONG64 Written;
+  uint64_t Start;
+  UINT status;
+
+  Disk_Free();
+
+  status = fx_media_format(&Media, Mode->Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                           "CRDBENCH", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 64, 1, 1);
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "CRDBENCH", Mode->Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_create(&Media, LOG_FILE_NAME);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+
+  /* The statistics of the log only */
+  memset(Mode->Stats, 0, sizeof(*Mode->Stats));
+  memset(&CardStats, 0, sizeof(CardStats));
+  StatusCommands = 0;
+
+  LowerLoops = 0;
+  Start = Now_us();
+
+  for (Written = 0; (Written < LogSize) && (status == FX_SUCCESS); Written += WRITE_BATCH_SIZE) {
+    status = fx_file_write(&File, Batch, WRITE_BATCH_SIZE);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  *Time = Now_us() - Start;
+
+  return status;
+}
+
+/**
+* @brief  Thread with lower priority than the writing one: it counts the CPU
+*         left by the writing thread
+* @param  Input: Not used
+* @retval None
+*/
+static VOID Lower_Thread(ULONG Input)
+{
+  (void)Input;
+
+  for (;;) {
+    while (LowerRunning) {
+      LowerLoops++;
+    }
+    tx_thread_sleep(1);
+  }
+}
+
+/**
+* @brief  Writing thread: the same log with each mode
+* @param  Input: Not used
+* @retval None
+*/
+static VOID Writer_Thread(ULONG Input)
+{
+  double LoopsPerUs;
+  uint64_t Start;
+  uint64_t Time;
+  ULONG Index;
+
+  (void)Input;
+
+  /* CPU of the lower priority thread alone */
+  LowerLoops = 0;
+  LowerRunning = 1;
+  Start = Now_us();
+  tx_thread_sleep(TX_TIMER_TICKS_PER_SECOND / 2);
+  LoopsPerUs = (double)LowerLoops / (double)(Now_us() - Start);
+
+  printf("FAT32, %u MB for each log, %u bytes for each fx_file_write\n",
+         (unsigned)(LogSize / (1024 * 1024)), (unsigned)WRITE_BATCH_SIZE);
+  printf("SD request %.0f uS + %.1f MB/s, busy %.0f uS after each write, tick %u uS\n",
+         Latency.CommandTime, Latency.BusRate, Latency.ProgramTime, (unsigned)(1000000U / TX_TIMER_TICKS_PER_SECOND));
+  printf("Mode           MB/s  Ready avg  Ready max    Status   IRQ  Lower CPU %%\n");
+
+  for (Index = 0; Index < MODES; Index++) {
+    FX_STM32_SD_DRIVER_STATS *Stats;
+    double Lower;
+
+    Mode = &Modes[Index];
+    if (CardLog(&Time) != FX_SUCCESS) {
+      fprintf(stderr, "Error with %s\n", Mode->Name);
+      exit(1);
+    }
+
+    Stats = Mode->Stats;
+
+    /* The calibration is done with one single run: the small differences are noise */
+    Lower = (100.0 * (double)LowerLoops) / (LoopsPerUs * (double)Time);
+    if (Lower > 100.0) {
+      Lower = 100.0;
+    }
+
+    printf("%-12s  %5.2f  %6lu uS  %6lu uS  %8lu  %4lu  %10.1f\n", Mode->Name, LogSize / (double)Time,
+           (unsigned long)((Stats->ReadyChecks != 0) ? (Stats->ReadyCycles / Stats->ReadyChecks) : 0),
+           (unsigned long)Stats->ReadyMax, (unsigned long)StatusCommands, (unsigned long)CardStats.Events,
+           Lower);
+  }
+
+  Disk_Free();
+  exit(0);
+}
+
+/**
+* @brief  ThreadX application define: the writing thread and the lower one
+* @param  first_unused_memory: Not used
+* @retval None
+*/
+VOID tx_application_define(VOID *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_semaphore_create(&card_ready_semaphore, "card ready semaphore", 0);
+
+  /* The simulated interrupt is started after the initialization of the Linux port */
+  sem_init(&IrqStart, 0, 0);
+  pthread_create(&IrqThread, NULL, Irq_Thread, NULL);
+
+  tx_thread_create(&WriterThread, "writer", Writer_Thread, 0, WriterStack, sizeof(WriterStack),
+                   WRITER_THREAD_PRIO, WRITER_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+  tx_thread_create(&LowerThread, "lower", Lower_Thread, 0, LowerStack, sizeof(LowerStack),
+                   LOWER_THREAD_PRIO, LOWER_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-m MB] [-c uS] [-b MB/s] [-p uS]\n", Name);
+  fprintf(stderr, "  -m  size of each log (default 4 MB)\n");
+  fprintf(stderr, "  -c  command overhead of each SD request (default 100 uS)\n");
+  fprintf(stderr, "  -b  SD bus rate (default 25 MB/s)\n");
+  fprintf(stderr, "  -p  card busy after each write (default 800 uS)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      LogSize = (ULONG64)atoi(argv[++Arg]) * 1024 * 1024;
+    } else if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc)) {
+      Latency.CommandTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Latency.BusRate = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      Latency.ProgramTime = atof(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if ((LogSize == 0) || (LogSize > 256ULL * 1024 * 1024) || (Latency.BusRate <= 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  memset(Batch, 0x5A, sizeof(Batch));
+
+  fx_system_initialize();
+
+  tx_kernel_enter();
+
+  return 0;
+}
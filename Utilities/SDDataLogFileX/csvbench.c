@@ -0,0 +1,322 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\csvbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host micro-benchmark of the sensors log encoding of the firmware:
+  *          one CSV line with sprintf (SensXXX.csv) against one packed binary
+  *          record (SensXXX.dat, STBOX1_SENSORS_LOG_BINARY), both copied on
+  *          one 16 KB write batch as SensorsLog_Save does
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "sdlog_utils.h"
+
+/* Private define ------------------------------------------------------------*/
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define DEFAULT_RECORDS       1000000
+#define SENSORS_LOG_RECORD_SIZE 48
+
+/* Messages generated before the measure (the same values for both encodings) */
+#define MESSAGES              4096
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Same fields of MessageData_T for COMMAND_SAVE_SENSORS (the ThreadX ULONG is
+   32 bit on the board) */
+typedef struct
+{
+  int32_t x;
+  int32_t y;
+  int32_t z;
+} Axes_T;
+
+typedef struct
+{
+  uint32_t MsgTime;
+  float pressure;
+  float temperature;
+  Axes_T acc;
+  Axes_T gyro;
+  Axes_T mag;
+} Message_T;
+
+/* Same layout of SensorsLogRecord_T */
+typedef struct
+{
+  uint32_t MsgTime;
+  int32_t acc[3];
+  int32_t gyro[3];
+  int32_t mag[3];
+  float pressure;
+  float temperature;
+} Record_T;
+
+/* Write batch: only the copy of WriteBatch_Write, the full buffer is dropped */
+typedef struct
+{
+  uint8_t Buffer[WRITE_BATCH_SIZE];
+  uint32_t Index;
+  uint64_t Bytes;
+  uint32_t Flushes;
+} Batch_T;
+
+/* Private variables ---------------------------------------------------------*/
+static Message_T Messages[MESSAGES];
+static Batch_T Batch;
+
+/**
+* @brief  Time in nS from one monotonic clock
+* @param  None
+* @retval Time in nS
+*/
+static double NowNs(void)
+{
+  struct timespec Ts;
+  clock_gettime(CLOCK_MONOTONIC, &Ts);
+  return Ts.tv_sec * 1e9 + Ts.tv_nsec;
+}
+
+/**
+* @brief  Generate the messages with the range of the sensors values at rest
+*         and in movement (mg, mdps, mgauss, mB and 'C)
+* @param  None
+* @retval None
+*/
+static void Messages_Init(void)
+{
+  uint32_t i;
+
+  srand(1);
+  for (i = 0; i < MESSAGES; i++) {
+    Message_T *Msg = &Messages[i];
+    Msg->MsgTime = 1000 + i;
+    Msg->acc.x = (rand() % 4000) - 2000;
+    Msg->acc.y = (rand() % 4000) - 2000;
+    Msg->acc.z = (rand() % 200) + 900;
+    Msg->gyro.x = (rand() % 500000) - 250000;
+    Msg->gyro.y = (rand() % 500000) - 250000;
+    Msg->gyro.z = (rand() % 500000) - 250000;
+    Msg->mag.x = (rand() % 1000) - 500;
+    Msg->mag.y = (rand() % 1000) - 500;
+    Msg->mag.z = (rand() % 1000) - 500;
+    Msg->pressure = 990.0f + (rand() % 4000) / 100.0f;
+    Msg->temperature = 15.0f + (rand() % 2000) / 100.0f;
+  }
+}
+
+/**
+* @brief  Copy some bytes on the write batch (WriteBatch_Write without FileX)
+* @param  Data: Bytes to be copied
+* @param  Size: Number of bytes
+* @retval None
+*/
+static void Batch_Write(const void *Data, uint32_t Size)
+{
+  const uint8_t *p = Data;
+
+  while (Size > 0) {
+    uint32_t Chunk = WRITE_BATCH_SIZE - Batch.Index;
+    if (Chunk > Size) {
+      Chunk = Size;
+    }
+    memcpy(Batch.Buffer + Batch.Index, p, Chunk);
+    Batch.Index += Chunk;
+    Batch.Bytes += Chunk;
+    p += Chunk;
+    Size -= Chunk;
+    if (Batch.Index == WRITE_BATCH_SIZE) {
+      Batch.Index = 0;
+      Batch.Flushes++;
+    }
+  }
+}
+
+/**
+* @brief  Format one CSV line as SensorsLog_Save without STBOX1_SENSORS_LOG_BINARY
+* @param  Msg: Message with the sensors values
+* @param  Line: Output line (256 bytes)
+* @retval Line length
+*/
+static int Csv_Encode(const Message_T *Msg, char *Line)
+{
+  return sprintf(Line, "%ld, %d, %d, %d, %d, %d, %d, %d, %d, %d, %5.2f, %5.2f\r\n",
+                 (long)Msg->MsgTime,
+                 Msg->acc.x , Msg->acc.y , Msg->acc.z ,
+                 Msg->gyro.x, Msg->gyro.y, Msg->gyro.z,
+                 Msg->mag.x , Msg->mag.y , Msg->mag.z ,
+                 Msg->pressure, Msg->temperature);
+}
+
+/**
+* @brief  Fill one binary record as SensorsLog_Save with STBOX1_SENSORS_LOG_BINARY
+* @param  Msg: Message with the sensors values
+* @param  Record: Output record
+* @retval None
+*/
+static void Binary_Encode(const Message_T *Msg, Record_T *Record)
+{
+  Record->MsgTime = Msg->MsgTime;
+  Record->acc[0]  = Msg->acc.x;
+  Record->acc[1]  = Msg->acc.y;
+  Record->acc[2]  = Msg->acc.z;
+  Record->gyro[0] = Msg->gyro.x;
+  Record->gyro[1] = Msg->gyro.y;
+  Record->gyro[2] = Msg->gyro.z;
+  Record->mag[0]  = Msg->mag.x;
+  Record->mag[1]  = Msg->mag.y;
+  Record->mag[2]  = Msg->mag.z;
+  Record->pressure = Msg->pressure;
+  Record->temperature = Msg->temperature;
+}
+
+/**
+* @brief  Convert one binary record to text as sens2csv does
+* @param  Record: Little-endian record
+* @param  Line: Output line (256 bytes)
+* @retval Line length
+*/
+static int Binary_Decode(const uint8_t *Record, char *Line)
+{
+  int Size = sprintf(Line, "%u", SDLOG_GetU32(Record));
+  int i;
+
+  for (i = 0; i < 9; i++) {
+    Size += sprintf(Line + Size, ", %d", (int32_t)SDLOG_GetU32(Record + 4 + 4 * i));
+  }
+  for (i = 0; i < 2; i++) {
+    Size += sprintf(Line + Size, ", %5.2f", SDLOG_GetFloat(Record + 40 + 4 * i));
+  }
+  Size += sprintf(Line + Size, "\r\n");
+
+  return Size;
+}
+
+/**
+* @brief  Check that sens2csv gives back the same text of the firmware CSV
+* @param  None
+* @retval Number of lines that differ
+*/
+static uint32_t Check_RoundTrip(void)
+{
+  uint32_t i, Errors = 0;
+
+  for (i = 0; i < MESSAGES; i++) {
+    char Csv[256], Decoded[256];
+    Record_T Record;
+
+    Csv_Encode(&Messages[i], Csv);
+    Binary_Encode(&Messages[i], &Record);
+    Binary_Decode((const uint8_t *)&Record, Decoded);
+    if (strcmp(Csv, Decoded) != 0) {
+      if (Errors == 0) {
+        fprintf(stderr, "Mismatch:\n  %s  %s", Csv, Decoded);
+      }
+      Errors++;
+    }
+  }
+
+  return Errors;
+}
+
+/**
+* @brief  Print one result line
+* @param  Name: Encoding name
+* @param  Records: Number of records
+* @param  Time: Time in nS
+* @param  Rate: Records for second of the log
+* @retval None
+*/
+static void Print_Result(const char *Name, uint32_t Records, double Time, double Rate)
+{
+  double Bytes = (double)Batch.Bytes / Records;
+
+  printf("%-8s %8.1f %9.1f %9.2f %8lu %10.1f\n", Name, Time / Records, Bytes,
+         Batch.Bytes / (Time / 1e3), (unsigned long)Batch.Flushes, Bytes * Rate * 3600.0 / (1024 * 1024));
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t Records = DEFAULT_RECORDS;
+  double Rate = 100.0;
+  double Start, CsvTime, BinaryTime;
+  volatile uint32_t Sink = 0;
+  uint32_t i;
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-n") == 0) && (Arg + 1 < argc)) {
+      Records = (uint32_t)strtoul(argv[++Arg], NULL, 0);
+    } else if ((strcmp(argv[Arg], "-r") == 0) && (Arg + 1 < argc)) {
+      Rate = atof(argv[++Arg]);
+    } else {
+      fprintf(stderr, "Usage: %s [-n records] [-r Hz]\n", argv[0]);
+      return 1;
+    }
+  }
+  if ((Records == 0) || (Rate <= 0.0)) {
+    fprintf(stderr, "Wrong options\n");
+    return 1;
+  }
+
+  if (sizeof(Record_T) != SENSORS_LOG_RECORD_SIZE) {
+    fprintf(stderr, "Wrong record size %u\n", (unsigned)sizeof(Record_T));
+    return 1;
+  }
+
+  Messages_Init();
+  if (Check_RoundTrip() != 0) {
+    fprintf(stderr, "sens2csv doesn't give back the CSV of the firmware\n");
+    return 1;
+  }
+
+  printf("%u records, %.0f Hz log, %u KB write batch\n", Records, Rate, WRITE_BATCH_SIZE / 1024);
+  printf("Encoding  nS/rec  Bytes/rec  MB/s out  Batches    MB/hour\n");
+
+  /* CSV: sprintf on the stack buffer and copy on the batch */
+  memset(&Batch, 0, sizeof(Batch));
+  Start = NowNs();
+  for (i = 0; i < Records; i++) {
+    char Line[256];
+    int Size = Csv_Encode(&Messages[i % MESSAGES], Line);
+    Batch_Write(Line, (uint32_t)Size);
+  }
+  CsvTime = NowNs() - Start;
+  Sink += Batch.Buffer[0];
+  Print_Result("CSV", Records, CsvTime, Rate);
+
+  /* Binary: fill the record on the stack and copy it on the batch */
+  memset(&Batch, 0, sizeof(Batch));
+  Start = NowNs();
+  for (i = 0; i < Records; i++) {
+    Record_T Record;
+    Binary_Encode(&Messages[i % MESSAGES], &Record);
+    Batch_Write(&Record, sizeof(Record));
+  }
+  BinaryTime = NowNs() - Start;
+  Sink += Batch.Buffer[0];
+  Print_Result("Binary", Records, BinaryTime, Rate);
+
+  printf("Binary is %.1fx faster, sens2csv output matches the firmware CSV\n", CsvTime / BinaryTime);
+  (void)Sink;
+
+  return 0;
+}
@@ -0,0 +1,521 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\dirbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the FileX directory hash index (FX_ENABLE_DIRECTORY_HASH):
+  *          latency of fx_file_open, fx_file_create and fx_file_delete in one
+  *          directory of the session files at some directory sizes, with the
+  *          linear directory search and with the index
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "fx_api.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated SD card in RAM: 4 GB, FAT32 with 32 KB clusters. The memory is
+   allocated only for the parts written (FATs and directories) */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (8UL * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_CHUNKS           (DISK_SECTORS / DISK_CHUNK_SECTORS)
+#define CLUSTER_SECTORS       64
+
+/* Time of one read command of the card (single or multiple block), to show
+   the time spent reading the directory from a real card */
+#define CARD_READ_US          250
+
+/* Same media cache of the firmware */
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+
+/* Directory of the session files and operations measured at each size */
+#define LOG_DIR               "Logs000"
+#define MAX_SIZES             8
+#define MAX_FILES             20000
+#define OPERATIONS            200
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Cost of one kind of operation */
+typedef struct
+{
+  double Time;               /* uS of the host */
+  ULONG Reads;               /* Read requests to the card */
+  ULONG SectorReads;         /* Sectors read from the card */
+  ULONG Count;               /* Operations */
+} Cost_T;
+
+/* Results of one directory size with the linear search or with the index */
+typedef struct
+{
+  Cost_T Fill;               /* Creation of the files of the directory */
+  Cost_T Open;               /* fx_file_open of existing files */
+  Cost_T Create;             /* fx_file_create of new files */
+  Cost_T Delete;             /* fx_file_delete of existing files */
+  ULONG Builds;              /* Index builds */
+  ULONG Errors;              /* Files not found or found after the delete */
+  uint32_t DiskHash;         /* Hash of the card at the end */
+} Result_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk[DISK_CHUNKS];
+static ULONG Reads;
+static ULONG SectorReads;
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+
+/* Files present in the directory */
+static UCHAR Present[MAX_FILES + OPERATIONS];
+static uint32_t Seed;
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  Time of the host
+* @param  None
+* @retval uS
+*/
+static double Now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+/**
+* @brief  Pseudo random numbers of the operations (the same for each run)
+* @param  Range: Numbers from 0 to Range - 1
+* @retval Random number
+*/
+static ULONG Random(ULONG Range)
+{
+  Seed = Seed * 1664525U + 1013904223U;
+  return (ULONG)(((uint64_t)(Seed >> 8) * Range) >> 24);
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated card
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Buffer: Data
+* @param  Write: 1 for writing the card
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Buffer, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Data;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Buffer, 0, DISK_SECTOR_SIZE);
+    } else {
+      Data = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Data, Buffer, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Buffer, Data, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Buffer += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Free the simulated card
+* @param  None
+* @retval None
+*/
+static void Disk_Free(void)
+{
+  ULONG Chunk;
+
+  for (Chunk = 0; Chunk < DISK_CHUNKS; Chunk++) {
+    free(Disk[Chunk]);
+    Disk[Chunk] = NULL;
+  }
+}
+
+/**
+* @brief  Hash (FNV-1a) of the simulated card
+* @param  None
+* @retval Hash
+*/
+static uint32_t Disk_Hash(void)
+{
+  uint32_t Hash = 2166136261U;
+  ULONG Chunk;
+  ULONG Byte;
+
+  for (Chunk = 0; Chunk < DISK_CHUNKS; Chunk++) {
+    Hash = (Hash ^ (Disk[Chunk] != NULL)) * 16777619U;
+    if (Disk[Chunk] != NULL) {
+      for (Byte = 0; Byte < DISK_CHUNK_SECTORS * DISK_SECTOR_SIZE; Byte++) {
+        Hash = (Hash ^ Disk[Chunk][Byte]) * 16777619U;
+      }
+    }
+  }
+
+  return Hash;
+}
+
+/**
+* @brief  Simulated SD card driver: the data are copied at once and the
+*         read requests and the sectors read are counted
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID SimDisk_Driver(FX_MEDIA *media_ptr)
+{
+  media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+  switch (media_ptr->fx_media_driver_request) {
+  case FX_DRIVER_READ:
+    Disk_Copy((ULONG)media_ptr->fx_media_driver_logical_sector, media_ptr->fx_media_driver_sectors,
+              media_ptr->fx_media_driver_buffer, 0);
+    Reads++;
+    SectorReads += media_ptr->fx_media_driver_sectors;
+    break;
+  case FX_DRIVER_WRITE:
+    Disk_Copy((ULONG)media_ptr->fx_media_driver_logical_sector, media_ptr->fx_media_driver_sectors,
+              media_ptr->fx_media_driver_buffer, 1);
+    break;
+  case FX_DRIVER_BOOT_READ:
+    Disk_Copy(0, 1, media_ptr->fx_media_driver_buffer, 0);
+    break;
+  case FX_DRIVER_BOOT_WRITE:
+    Disk_Copy(0, 1, media_ptr->fx_media_driver_buffer, 1);
+    break;
+  default:
+    /* Init, flush, abort, release sectors and uninit: nothing to do */
+    break;
+  }
+}
+
+/**
+* @brief  Name of one session file, with one long name as the firmware logs
+* @param  Index: File index
+* @param  Name: Name (at least 32 bytes)
+* @retval None
+*/
+static void FileName(ULONG Index, CHAR *Name)
+{
+  snprintf(Name, 32, "/" LOG_DIR "/Sens%05lu.csv", (unsigned long)Index);
+}
+
+/**
+* @brief  Open the media as the firmware does at each log start; with the
+*         linear search no directory is ever indexed
+* @param  Hash: 1 for using the index
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Open(int Hash)
+{
+  UINT status;
+
+  status = fx_media_open(&Media, "DIRBENCH", SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  if ((status == FX_SUCCESS) && !Hash) {
+    Media.fx_media_directory_hash_threshold = 0xFFFFFFFFUL;
+  }
+
+  return status;
+}
+
+/**
+* @brief  Start one operation
+* @param  Cost: Cost of the operation
+* @retval None
+*/
+static void CostStart(Cost_T *Cost)
+{
+  Cost->Time -= Now_us();
+  Cost->Reads -= Reads;
+  Cost->SectorReads -= SectorReads;
+}
+
+/**
+* @brief  End one operation
+* @param  Cost: Cost of the operation
+* @retval None
+*/
+static void CostEnd(Cost_T *Cost)
+{
+  Cost->Time += Now_us();
+  Cost->Reads += Reads;
+  Cost->SectorReads += SectorReads;
+  Cost->Count++;
+}
+
+/**
+* @brief  Create one empty file
+* @param  Index: File index
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Create(ULONG Index)
+{
+  CHAR Name[32];
+  UINT status;
+
+  FileName(Index, Name);
+  status = fx_file_create(&Media, Name);
+  if (status == FX_SUCCESS) {
+    Present[Index] = 1;
+  }
+
+  return status;
+}
+
+/**
+* @brief  One directory size: the files are created in one empty directory,
+*         then the media is opened again (no index) and some random existing
+*         files are opened, some new files are created and some random files
+*         are deleted. At the end each file must be found if present and not
+*         found if deleted
+* @param  Hash: 1 for using the index
+* @param  Files: Files of the directory
+* @param  Result: Results of the tests
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Test(int Hash, ULONG Files, Result_T *Result)
+{
+  CHAR Name[32];
+  ULONG Index;
+  ULONG Op;
+  UINT status;
+
+  Disk_Free();
+  memset(Result, 0, sizeof(Result_T));
+  memset(Present, 0, sizeof(Present));
+  Seed = 12345;
+
+  status = fx_media_format(&Media, SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                           "DIRBENCH", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, CLUSTER_SECTORS, 1, 1);
+  if (status == FX_SUCCESS) {
+    status = Open(Hash);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_directory_create(&Media, LOG_DIR);
+  }
+
+  /* Files of the directory */
+  for (Index = 0; (Index < Files) && (status == FX_SUCCESS); Index++) {
+    CostStart(&Result->Fill);
+    status = Create(Index);
+    CostEnd(&Result->Fill);
+  }
+  Result->Builds = Media.fx_media_directory_hash_builds;
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+  if (status == FX_SUCCESS) {
+    status = Open(Hash);
+  }
+
+  /* Existing files opened for reading */
+  for (Op = 0; (Op < OPERATIONS) && (status == FX_SUCCESS); Op++) {
+    FileName(Random(Files), Name);
+    CostStart(&Result->Open);
+    status = fx_file_open(&Media, &File, Name, FX_OPEN_FOR_READ);
+    if (status == FX_SUCCESS) {
+      status = fx_file_close(&File);
+    }
+    CostEnd(&Result->Open);
+  }
+
+  /* New files */
+  for (Op = 0; (Op < OPERATIONS) && (status == FX_SUCCESS); Op++) {
+    CostStart(&Result->Create);
+    status = Create(Files + Op);
+    CostEnd(&Result->Create);
+  }
+
+  /* Existing files deleted */
+  for (Op = 0; (Op < OPERATIONS) && (status == FX_SUCCESS); Op++) {
+    Index = Random(Files + OPERATIONS);
+    if (Present[Index]) {
+      FileName(Index, Name);
+      CostStart(&Result->Delete);
+      status = fx_file_delete(&Media, Name);
+      CostEnd(&Result->Delete);
+      Present[Index] = 0;
+    }
+  }
+  Result->Builds += Media.fx_media_directory_hash_builds;
+
+  /* Each file must be found only if present */
+  for (Index = 0; (Index < Files + OPERATIONS) && (status == FX_SUCCESS); Index++) {
+    FileName(Index, Name);
+    status = fx_file_open(&Media, &File, Name, FX_OPEN_FOR_READ);
+    if (status == FX_SUCCESS) {
+      status = fx_file_close(&File);
+      Result->Errors += !Present[Index];
+    } else if (status == FX_NOT_FOUND) {
+      status = FX_SUCCESS;
+      Result->Errors += Present[Index];
+    }
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+  if (status == FX_SUCCESS) {
+    Result->DiskHash = Disk_Hash();
+  }
+
+  return status;
+}
+
+/**
+* @brief  Print the cost of one kind of operation
+* @param  Cost: Cost of the operation
+* @retval None
+*/
+static void PrintCost(const Cost_T *Cost)
+{
+  ULONG Count = (Cost->Count != 0) ? Cost->Count : 1;
+
+  printf(" %7.1f %6.1f %6.2f", Cost->Time / Count, (double)Cost->SectorReads / Count,
+         (double)Cost->Reads * CARD_READ_US / 1000.0 / Count);
+}
+
+/**
+* @brief  Print one result
+* @param  Files: Files of the directory
+* @param  Hash: 1 for the index
+* @param  Result: Results of the tests
+* @retval None
+*/
+static void Print(ULONG Files, int Hash, const Result_T *Result)
+{
+  printf("%6lu  %-6s", (unsigned long)Files, Hash ? "hash" : "linear");
+  PrintCost(&Result->Fill);
+  PrintCost(&Result->Open);
+  PrintCost(&Result->Create);
+  PrintCost(&Result->Delete);
+  printf(" %6lu\n", (unsigned long)Result->Builds);
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [files...]\n", Name);
+  fprintf(stderr, "  files: files of the directory (default 100 500 1000 2000 5000, max %d)\n", MAX_FILES);
+}
+
+int main(int argc, char *argv[])
+{
+  ULONG Sizes[MAX_SIZES] = {100, 500, 1000, 2000, 5000};
+  int SizeCount = 5;
+  Result_T Result[2];
+  int Index;
+  int Hash;
+  int Arg;
+
+  if ((argc > 1) && (argv[1][0] == '-')) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  if (argc > 1) {
+    for (SizeCount = 0, Arg = 1; (Arg < argc) && (SizeCount < MAX_SIZES); Arg++) {
+      Sizes[SizeCount++] = (ULONG)atol(argv[Arg]);
+    }
+  }
+
+  for (Index = 0; Index < SizeCount; Index++) {
+    if ((Sizes[Index] == 0) || (Sizes[Index] > MAX_FILES)) {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  fx_system_initialize();
+
+  printf("FAT32 4 GB, %u KB clusters, %u sectors of media cache, index of %u slots\n",
+         (CLUSTER_SECTORS * DISK_SECTOR_SIZE) / 1024, MEDIA_CACHE_SIZE / DISK_SECTOR_SIZE, FX_DIRECTORY_HASH_SIZE);
+  printf("Session files /" LOG_DIR "/SensNNNNN.csv, %d opens, creates and deletes at each size\n", OPERATIONS);
+  printf("For each operation: uS of the host, sectors read, mS of the card (%u uS each read command)\n", CARD_READ_US);
+  printf("                Fill (create)          fx_file_open          fx_file_create          fx_file_delete\n");
+  printf(" Files  Search      uS    rd   card      uS    rd   card      uS    rd   card      uS    rd   card builds\n");
+
+  for (Index = 0; Index < SizeCount; Index++) {
+    for (Hash = 0; Hash < 2; Hash++) {
+      if (Test(Hash, Sizes[Index], &Result[Hash]) != FX_SUCCESS) {
+        fprintf(stderr, "Error with %lu files %s the index\n", (unsigned long)Sizes[Index], Hash ? "with" : "without");
+        return 1;
+      }
+      Print(Sizes[Index], Hash, &Result[Hash]);
+    }
+
+    /* The index must find the same files and must not change the directory entries written */
+    if ((Result[0].Errors != 0) || (Result[1].Errors != 0)) {
+      fprintf(stderr, "Files not found or deleted files found with %lu files\n", (unsigned long)Sizes[Index]);
+      return 1;
+    }
+    if (Result[0].DiskHash != Result[1].DiskHash) {
+      fprintf(stderr, "Different card with and without the index with %lu files\n", (unsigned long)Sizes[Index]);
+      return 1;
+    }
+  }
+
+  printf("Same card with and without the index, each file found only if present\n");
+
+  Disk_Free();
+
+  return 0;
+}
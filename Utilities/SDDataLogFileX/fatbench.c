@@ -0,0 +1,632 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\fatbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the FileX free cluster map (FX_ENABLE_FAT_FREE_MAP):
+  *          one big FAT32 simulated SD card filled and fragmented at some levels,
+  *          then the cluster allocations of one log and of one contiguous file
+  *          with and without the map
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "fx_api.h"
+#include "fx_utility.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated SD card: 32 GB by default, FAT32 with 32 KB clusters. The memory
+   is allocated only for the parts written (FATs, directories and logs): the
+   files of the fill are only allocated */
+#define DISK_SECTOR_SIZE      512
+#define DISK_MAX_SECTORS      (128UL * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_MAX_CHUNKS       (DISK_MAX_SECTORS / DISK_CHUNK_SECTORS)
+#define CLUSTER_SECTORS       64
+
+/* Same write batching stage and media cache of the firmware */
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+
+/* Files of the fill: DIR_FILES files for each directory */
+#define DIR_FILES             256
+#define MAX_FILES             (256 * 1024)
+#define MAX_LEVELS            8
+
+/* Segments preallocated after the log, as the log rotation (STBOX1_LOG_ROTATION) does */
+#define SEGMENTS              4
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Results of one test */
+typedef struct
+{
+  double Time;               /* mS of the host */
+  ULONG FatReads;            /* FAT entries read by FileX */
+  ULONG SectorReads;         /* Sectors read from the card */
+} Cost_T;
+
+/* Results of one fill level with or without the map */
+typedef struct
+{
+  Cost_T Log;                /* The log after the media open */
+  Cost_T Segment[SEGMENTS];  /* The segments allocated after the log */
+  ULONG64 SegmentSize;       /* Bytes of the last segment */
+  uint32_t FatHash;          /* Hash of the FAT at the end */
+  ULONG MapErrors;           /* Groups of the map with one wrong count */
+} Result_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk[DISK_MAX_CHUNKS];
+static UCHAR *Saved[DISK_MAX_CHUNKS];
+static ULONG DiskSectors = 64UL * 1024 * 1024;
+static ULONG SectorReads;
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+
+static UCHAR Batch[WRITE_BATCH_SIZE];
+
+/* Size in clusters of the files of the fill (0 for the deleted ones) */
+static ULONG FileClusters[MAX_FILES];
+static ULONG Files;
+static uint32_t Seed;
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  Time of the host
+* @param  None
+* @retval mS
+*/
+static double Now_ms(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/**
+* @brief  Pseudo random numbers of the fill (the same for each run)
+* @param  Range: Numbers from 0 to Range - 1
+* @retval Random number
+*/
+static ULONG Random(ULONG Range)
+{
+  Seed = Seed * 1664525U + 1013904223U;
+  return (ULONG)(((uint64_t)(Seed >> 8) * Range) >> 24);
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated card
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Buffer: Data
+* @param  Write: 1 for writing the card
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Buffer, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Data;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Buffer, 0, DISK_SECTOR_SIZE);
+    } else {
+      Data = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Data, Buffer, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Buffer, Data, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Buffer += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Free the simulated card (or its saved copy)
+* @param  Chunks: Chunks of the card
+* @retval None
+*/
+static void Disk_Free(UCHAR **Chunks)
+{
+  ULONG Chunk;
+
+  for (Chunk = 0; Chunk < DISK_MAX_CHUNKS; Chunk++) {
+    free(Chunks[Chunk]);
+    Chunks[Chunk] = NULL;
+  }
+}
+
+/**
+* @brief  Copy the simulated card, so each test starts from the same fill
+* @param  To: Chunks of the copy
+* @param  From: Chunks to copy
+* @retval None
+*/
+static void Disk_Duplicate(UCHAR **To, UCHAR **From)
+{
+  ULONG Chunk;
+
+  Disk_Free(To);
+  for (Chunk = 0; Chunk < DISK_MAX_CHUNKS; Chunk++) {
+    if (From[Chunk] != NULL) {
+      To[Chunk] = malloc(DISK_CHUNK_SECTORS * DISK_SECTOR_SIZE);
+      if (To[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+      memcpy(To[Chunk], From[Chunk], DISK_CHUNK_SECTORS * DISK_SECTOR_SIZE);
+    }
+  }
+}
+
+/**
+* @brief  Hash (FNV-1a) of the first FAT of the simulated card
+* @param  None
+* @retval Hash
+*/
+static uint32_t Disk_FatHash(void)
+{
+  static UCHAR Sector[DISK_SECTOR_SIZE];
+  uint32_t Hash = 2166136261U;
+  ULONG Index;
+  ULONG Byte;
+
+  for (Index = 0; Index < Media.fx_media_sectors_per_FAT; Index++) {
+    Disk_Copy(Media.fx_media_reserved_sectors + Index, 1, Sector, 0);
+    for (Byte = 0; Byte < DISK_SECTOR_SIZE; Byte++) {
+      Hash = (Hash ^ Sector[Byte]) * 16777619U;
+    }
+  }
+
+  return Hash;
+}
+
+/**
+* @brief  Simulated SD card driver: the data are copied at once and the
+*         sectors read are counted
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID SimDisk_Driver(FX_MEDIA *media_ptr)
+{
+  media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+  switch (media_ptr->fx_media_driver_request) {
+  case FX_DRIVER_READ:
+    Disk_Copy((ULONG)media_ptr->fx_media_driver_logical_sector, media_ptr->fx_media_driver_sectors,
+              media_ptr->fx_media_driver_buffer, 0);
+    SectorReads += media_ptr->fx_media_driver_sectors;
+    break;
+  case FX_DRIVER_WRITE:
+    Disk_Copy((ULONG)media_ptr->fx_media_driver_logical_sector, media_ptr->fx_media_driver_sectors,
+              media_ptr->fx_media_driver_buffer, 1);
+    break;
+  case FX_DRIVER_BOOT_READ:
+    Disk_Copy(0, 1, media_ptr->fx_media_driver_buffer, 0);
+    break;
+  case FX_DRIVER_BOOT_WRITE:
+    Disk_Copy(0, 1, media_ptr->fx_media_driver_buffer, 1);
+    break;
+  default:
+    /* Init, flush, abort, release sectors and uninit: nothing to do */
+    break;
+  }
+}
+
+/**
+* @brief  Name of one file of the fill
+* @param  Index: File index
+* @param  Name: Name (at least 20 bytes)
+* @retval None
+*/
+static void FillName(ULONG Index, CHAR *Name)
+{
+  snprintf(Name, 20, "/D%03lu/F%03lu.BIN", (unsigned long)(Index / DIR_FILES), (unsigned long)(Index % DIR_FILES));
+}
+
+/**
+* @brief  Fill the simulated card: files of random size (from 1 to 2 * Average
+*         clusters, each one contiguous when possible) until the card is full,
+*         then random files are deleted until Level % of the clusters are used.
+*         The free clusters are left as holes of random size on all the card
+* @param  Level: % of the clusters used
+* @param  Average: Average clusters of the files
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Fill(double Level, ULONG Average)
+{
+  ULONG ClusterSize = CLUSTER_SECTORS * DISK_SECTOR_SIZE;
+  ULONG64 Allocated;
+  ULONG Target;
+  ULONG Index;
+  CHAR Name[20];
+  UINT status;
+
+  Disk_Free(Disk);
+  Seed = 12345;
+  Files = 0;
+
+  status = fx_media_format(&Media, SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                           "FATBENCH", 2, 0, 0, DiskSectors, DISK_SECTOR_SIZE, CLUSTER_SECTORS, 1, 1);
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "FATBENCH", SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  }
+
+  /* Files until the card is full */
+  while ((status == FX_SUCCESS) && (Files < MAX_FILES)) {
+    if ((Files % DIR_FILES) == 0) {
+      snprintf(Name, sizeof(Name), "/D%03lu", (unsigned long)(Files / DIR_FILES));
+      status = fx_directory_create(&Media, Name);
+      if (status != FX_SUCCESS) {
+        break;
+      }
+    }
+
+    FillName(Files, Name);
+    status = fx_file_create(&Media, Name);
+    if (status == FX_SUCCESS) {
+      status = fx_file_open(&Media, &File, Name, FX_OPEN_FOR_WRITE);
+    }
+    if (status == FX_SUCCESS) {
+      status = fx_file_extended_best_effort_allocate(&File, (ULONG64)(1 + Random(2 * Average)) * ClusterSize, &Allocated);
+      if (status == FX_SUCCESS) {
+        status = fx_file_close(&File);
+      } else {
+        fx_file_close(&File);
+      }
+    }
+
+    if (status == FX_SUCCESS) {
+      FileClusters[Files++] = (ULONG)(Allocated / ClusterSize);
+      if (Allocated == 0) {
+        break;
+      }
+    }
+  }
+
+  if (status == FX_NO_MORE_SPACE) {
+    status = FX_SUCCESS;
+  }
+
+  /* Delete random files down to the level */
+  Target = (ULONG)((Media.fx_media_total_clusters * (100.0 - Level)) / 100.0);
+  while ((status == FX_SUCCESS) && (Media.fx_media_available_clusters < Target)) {
+    Index = Random(Files);
+    if (FileClusters[Index] != 0) {
+      FillName(Index, Name);
+      status = fx_file_delete(&Media, Name);
+      FileClusters[Index] = 0;
+    }
+  }
+
+  /* The media is closed with the FSInfo sector updated */
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Start the cost of one test
+* @param  Cost: Cost of the test
+* @retval None
+*/
+static void CostStart(Cost_T *Cost)
+{
+  Cost->Time = Now_ms();
+  Cost->FatReads = Media.fx_media_fat_entry_reads;
+  Cost->SectorReads = SectorReads;
+}
+
+/**
+* @brief  End the cost of one test
+* @param  Cost: Cost of the test
+* @retval None
+*/
+static void CostEnd(Cost_T *Cost)
+{
+  Cost->Time = Now_ms() - Cost->Time;
+  Cost->FatReads = Media.fx_media_fat_entry_reads - Cost->FatReads;
+  Cost->SectorReads = SectorReads - Cost->SectorReads;
+}
+
+/**
+* @brief  Check the free cluster map against the FAT of the open media: each
+*         group counted must have the same free clusters of the FAT, and all
+*         the free clusters must be the available clusters of the media
+* @param  None
+* @retval Groups with one wrong count (0xFFFFFFFF for one FileX error)
+*/
+static ULONG MapCheck(void)
+{
+  ULONG End = Media.fx_media_total_clusters + FX_FAT_ENTRY_START;
+  ULONG Available = 0;
+  ULONG Errors = 0;
+  ULONG Group;
+  ULONG Cluster;
+  ULONG Value;
+  ULONG Free;
+
+  for (Group = 0; Group < Media.fx_media_fat_free_map_groups; Group++) {
+    Free = 0;
+    for (Cluster = Group << Media.fx_media_fat_free_map_shift;
+         (Cluster < ((Group + 1) << Media.fx_media_fat_free_map_shift)) && (Cluster < End); Cluster++) {
+      if (Cluster < FX_FAT_ENTRY_START) {
+        continue;
+      }
+      if (_fx_utility_FAT_entry_read(&Media, Cluster, &Value) != FX_SUCCESS) {
+        return 0xFFFFFFFFUL;
+      }
+      if (Value == FX_FREE_CLUSTER) {
+        Free++;
+      }
+    }
+
+    if ((Media.fx_media_fat_free_map[Group] != FX_FAT_FREE_MAP_UNKNOWN) && (Media.fx_media_fat_free_map[Group] != Free)) {
+      Errors++;
+    }
+    Available += Free;
+  }
+
+  if (Available != Media.fx_media_available_clusters) {
+    Errors++;
+  }
+
+  return Errors;
+}
+
+/**
+* @brief  The tests on the filled card, opened as the firmware does at each log
+*         start: one log written with WRITE_BATCH_SIZE bytes for each
+*         fx_file_write, then SEGMENTS files preallocated as the log rotation
+*         does (fx_file_extended_allocate for one contiguous file, otherwise
+*         fx_file_extended_best_effort_allocate). Without the map it's disabled
+*         after fx_media_open: FileX reads the FAT entries one by one as without
+*         FX_ENABLE_FAT_FREE_MAP
+* @param  Map: 1 for using the map
+* @param  LogSize: Bytes of the log
+* @param  SegmentSize: Bytes of each segment
+* @param  Result: Results of the tests
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Test(int Map, ULONG64 LogSize, ULONG64 SegmentSize, Result_T *Result)
+{
+  CHAR Name[20];
+  ULONG64 Written;
+  UINT status;
+  int Segment;
+
+  Disk_Duplicate(Disk, Saved);
+  memset(Result, 0, sizeof(Result_T));
+
+  status = fx_media_open(&Media, "FATBENCH", SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  if (status != FX_SUCCESS) {
+    return status;
+  }
+  if (!Map) {
+    Media.fx_media_fat_free_map_valid = FX_FALSE;
+  }
+
+  CostStart(&Result->Log);
+  status = fx_file_create(&Media, "Log000.stb");
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, "Log000.stb", FX_OPEN_FOR_WRITE);
+  }
+  for (Written = 0; (Written < LogSize) && (status == FX_SUCCESS); Written += WRITE_BATCH_SIZE) {
+    status = fx_file_write(&File, Batch, WRITE_BATCH_SIZE);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  CostEnd(&Result->Log);
+
+  for (Segment = 0; (Segment < SEGMENTS) && (status == FX_SUCCESS); Segment++) {
+    snprintf(Name, sizeof(Name), "Log000_%03d.stb", Segment + 1);
+    CostStart(&Result->Segment[Segment]);
+    status = fx_file_create(&Media, Name);
+    if (status == FX_SUCCESS) {
+      status = fx_file_open(&Media, &File, Name, FX_OPEN_FOR_WRITE);
+    }
+    if (status == FX_SUCCESS) {
+      Result->SegmentSize = SegmentSize;
+      status = fx_file_extended_allocate(&File, SegmentSize);
+      if (status == FX_NO_MORE_SPACE) {
+        status = fx_file_extended_best_effort_allocate(&File, SegmentSize, &Result->SegmentSize);
+      }
+    }
+    if (status == FX_SUCCESS) {
+      status = fx_file_close(&File);
+    }
+    CostEnd(&Result->Segment[Segment]);
+  }
+
+  if ((status == FX_SUCCESS) && Map) {
+    Result->MapErrors = MapCheck();
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+  if (status == FX_SUCCESS) {
+    Result->FatHash = Disk_FatHash();
+  }
+
+  return status;
+}
+
+/**
+* @brief  Print one result
+* @param  Level: % of the clusters used
+* @param  Map: 1 for the map
+* @param  Result: Results of the tests
+* @retval None
+*/
+static void Print(double Level, int Map, const Result_T *Result)
+{
+  Cost_T Next = {0, 0, 0};
+  int Segment;
+
+  for (Segment = 1; Segment < SEGMENTS; Segment++) {
+    Next.Time += Result->Segment[Segment].Time / (SEGMENTS - 1);
+    Next.FatReads += Result->Segment[Segment].FatReads / (SEGMENTS - 1);
+    Next.SectorReads += Result->Segment[Segment].SectorReads / (SEGMENTS - 1);
+  }
+
+  printf("%5.1f  %-4s %7.1f %9lu %6lu  %7.1f %9lu %6lu  %7.1f %9lu %6lu %6.1f\n", Level, Map ? "yes" : "no",
+         Result->Log.Time, (unsigned long)Result->Log.FatReads, (unsigned long)Result->Log.SectorReads,
+         Result->Segment[0].Time, (unsigned long)Result->Segment[0].FatReads,
+         (unsigned long)Result->Segment[0].SectorReads, Next.Time, (unsigned long)Next.FatReads,
+         (unsigned long)Next.SectorReads, Result->SegmentSize / (1024.0 * 1024.0));
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-g GB] [-f clusters] [-m MB] [-s MB] [level...]\n", Name);
+  fprintf(stderr, "  -g  size of the SD card (default 32 GB, max 64 GB)\n");
+  fprintf(stderr, "  -f  average clusters of the files of the fill (default 32)\n");
+  fprintf(stderr, "  -m  size of the log (default 16 MB)\n");
+  fprintf(stderr, "  -s  size of each segment (default 64 MB)\n");
+  fprintf(stderr, "  level: %% of the clusters used (default 50 90 99)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  double Levels[MAX_LEVELS] = {50.0, 90.0, 99.0};
+  int LevelCount = 3;
+  ULONG64 LogSize = 16ULL * 1024 * 1024;
+  ULONG64 SegmentSize = 64ULL * 1024 * 1024;
+  ULONG Average = 32;
+  Result_T Result[2];
+  int Index;
+  int Map;
+  int Arg;
+
+  for (Arg = 1; (Arg < argc) && (argv[Arg][0] == '-'); Arg++) {
+    if ((strcmp(argv[Arg], "-g") == 0) && (Arg + 1 < argc)) {
+      DiskSectors = (ULONG)atoi(argv[++Arg]) * 2UL * 1024 * 1024;
+    } else if ((strcmp(argv[Arg], "-f") == 0) && (Arg + 1 < argc)) {
+      Average = (ULONG)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      LogSize = (ULONG64)atoi(argv[++Arg]) * 1024 * 1024;
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 1 < argc)) {
+      SegmentSize = (ULONG64)atoi(argv[++Arg]) * 1024 * 1024;
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (Arg < argc) {
+    for (LevelCount = 0; (Arg < argc) && (LevelCount < MAX_LEVELS); Arg++) {
+      Levels[LevelCount++] = atof(argv[Arg]);
+    }
+  }
+
+  if ((DiskSectors < 2UL * 1024 * 1024) || (DiskSectors > DISK_MAX_SECTORS) || (Average == 0) ||
+      (LogSize == 0) || (SegmentSize == 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  memset(Batch, 0x5A, sizeof(Batch));
+
+  fx_system_initialize();
+
+  printf("FAT32 %lu GB, %u KB clusters, fill with files of %lu clusters on average\n",
+         (unsigned long)(DiskSectors / (2UL * 1024 * 1024)), (CLUSTER_SECTORS * DISK_SECTOR_SIZE) / 1024,
+         (unsigned long)Average);
+  printf("One log of %u MB (16384 bytes for each fx_file_write), then %d segments of %u MB preallocated\n",
+         (unsigned)(LogSize / (1024 * 1024)), SEGMENTS, (unsigned)(SegmentSize / (1024 * 1024)));
+  printf("             Log                        First segment              Next segments (avg)\n");
+  printf("Fill%%  Map       mS FAT reads SD rd       mS FAT reads SD rd       mS FAT reads SD rd     MB\n");
+
+  for (Index = 0; Index < LevelCount; Index++) {
+    if ((Levels[Index] < 0) || (Levels[Index] > 100) || (Fill(Levels[Index], Average) != FX_SUCCESS)) {
+      fprintf(stderr, "Error filling the card at %.1f%%\n", Levels[Index]);
+      return 1;
+    }
+    Disk_Duplicate(Saved, Disk);
+
+    for (Map = 0; Map < 2; Map++) {
+      if (Test(Map, LogSize, SegmentSize, &Result[Map]) != FX_SUCCESS) {
+        fprintf(stderr, "Error at %.1f%% %s the map\n", Levels[Index], Map ? "with" : "without");
+        return 1;
+      }
+      Print(Levels[Index], Map, &Result[Map]);
+    }
+
+    /* The map must not change the clusters allocated */
+    if (Result[0].FatHash != Result[1].FatHash) {
+      fprintf(stderr, "Different FAT with and without the map at %.1f%%\n", Levels[Index]);
+      return 1;
+    }
+    if (Result[1].MapErrors != 0) {
+      fprintf(stderr, "Free cluster map different from the FAT at %.1f%%\n", Levels[Index]);
+      return 1;
+    }
+  }
+
+  printf("Same FAT with and without the map, free cluster map checked against the FAT\n");
+
+  Disk_Free(Disk);
+  Disk_Free(Saved);
+
+  return 0;
+}
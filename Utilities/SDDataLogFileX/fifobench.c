@@ -0,0 +1,767 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\fifobench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Check of the reading of the IMU FIFO (STBOX1_IMU_FIFO): one model
+  *          of the FIFO registers of the LSM6DSV16X and of the ISM330DHCX
+  *          (tagged words, level, depth and overrun) filled at the ODR in
+  *          simulated time and read with the same ImuFifo_Drain of
+  *          FileX/App/app_filex.c at each tick of the Reading Timer
+  *          (LSM6DSV16X) or at each FIFO watermark interrupt (ISM330DHCX).
+  *          The samples sent are checked for losses, pairing and time stamps,
+  *          and the LogTime of the log container with the real sampling time
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sdlog_utils.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Same options of STBOX1_config.h and FileX/App/app_filex.c */
+#define STBOX1_IMU_FIFO_WATERMARK 96
+#define STBOX1_LOG_CONTAINER
+#define IMU_FIFO_WORD_SIZE        7
+#define IMU_FIFO_TAG_GYRO         0x01U
+#define IMU_FIFO_TAG_ACC          0x02U
+#define IMU_FIFO_TAG_TIMESTAMP    0x04U
+
+/* Reading Timer of 1 tick of 10 mS (ThreadX default of 100 ticks/S) */
+#define READING_TIMER_US          10000
+
+/* Registers of the FIFO (same address of FIFO_DATA_OUT_TAG on both sensors) */
+#define FIFO_DATA_OUT_TAG         0x78U
+#define FIFO_STATUS2_OVR_IA       0x40U
+#define FIFO_STATUS2_WTM_IA       0x80U
+
+#define BSP_ERROR_NONE            0
+#define BSP_ERROR_COMPONENT       (-5)
+
+/* Words of one batch event: time stamp, gyroscope and accelerometer */
+#define WORDS_PER_SAMPLE          3
+
+/* Private typedef -----------------------------------------------------------*/
+typedef unsigned long ULONG;
+
+typedef struct
+{
+  int32_t x;
+  int32_t y;
+  int32_t z;
+} BSP_MOTION_SENSOR_Axes_t;
+
+/* Sensor of one board */
+typedef struct
+{
+  const char *Name;
+  const char *Board;
+  float Odr;                 /* STBOX1_IMU_FIFO_ODR */
+  uint32_t TsFrequency;      /* IMU_FIFO_TS_FREQUENCY */
+  uint8_t StatusReg;         /* FIFO_STATUS1 (FIFO_STATUS2 follows it) */
+  uint8_t LevelBits;         /* DIFF_FIFO bits of FIFO_STATUS2 */
+  uint8_t Int1;              /* Watermark on INT1: drained at the interrupt, not at each tick */
+} Sensor_T;
+
+/* Message sent to the Writing Thread (fields of MessageData_T used here) */
+typedef struct
+{
+  uint32_t MsgTime;
+  ULONG LogTime;
+  uint8_t SlowSensors;
+  BSP_MOTION_SENSOR_Axes_t acc;
+  BSP_MOTION_SENSOR_Axes_t gyro;
+} MessageData_T;
+
+/* One word on the FIFO and the sample that has written it */
+typedef struct
+{
+  uint8_t Data[IMU_FIFO_WORD_SIZE];
+  uint32_t Sample;
+} FifoWord_T;
+
+/* Private variables ---------------------------------------------------------*/
+static const Sensor_T Sensors[] = {
+  {"LSM6DSV16X", "STEVAL-MKBOXPRO", 960.0f, 45977, 0x1BU, 1, 0},
+  {"ISM330DHCX", "STEVAL-STWINBX1", 833.0f, 40000, 0x3AU, 2, 1},
+};
+#define SENSORS                   (sizeof(Sensors) / sizeof(Sensors[0]))
+
+static const Sensor_T *Sensor;
+
+/* Simulated sensor: the FIFO, its depth and its own oscillator */
+static struct
+{
+  FifoWord_T *Words;
+  uint32_t Depth;
+  uint32_t Head;
+  uint32_t Level;
+  uint32_t NextSample;       /* Next sample to be batched */
+  uint8_t TagCnt;
+  uint8_t Overrun;           /* FIFO_OVR_IA, cleared by the read of FIFO_STATUS2 */
+  double Ppm;                /* Oscillator error from the nominal ODR */
+  uint32_t TsStart;          /* Time stamp counter at the start */
+  /* Samples with one word overwritten */
+  uint8_t *Lost;
+  uint32_t Samples;
+} Fifo;
+
+/* Simulated MCU */
+static double Now;           /* uS */
+static unsigned int Seed = 1;
+
+/* Copy of the state of FileX/App/app_filex.c */
+static uint8_t ImuFifoBuffer[STBOX1_IMU_FIFO_WATERMARK * IMU_FIFO_WORD_SIZE];
+
+static struct
+{
+  float AccSensitivity;
+  float GyroSensitivity;
+  float FifoOdr;           /* ODR used while logging */
+  uint32_t Time;           /* Last time stamp read from the FIFO */
+  uint8_t TimeValid;
+  uint8_t Pending;         /* Tags waiting for their pair (one bit for each tag) */
+  uint8_t PendingCnt;      /* TAG_CNT of the tags waiting */
+  BSP_MOTION_SENSOR_Axes_t acc;
+  BSP_MOTION_SENSOR_Axes_t gyro;
+  /* Statistics */
+  ULONG Bursts;
+  ULONG Words;
+  ULONG MaxLevel;
+  ULONG Unpaired;          /* Samples with one tag only (FIFO overrun) */
+#ifdef STBOX1_LOG_CONTAINER
+  uint32_t AnchorTime;     /* Time stamp of the last sample of the previous drain */
+  ULONG AnchorTick;        /* HAL_GetTick() of the previous drain */
+  uint8_t AnchorValid;
+#endif /* STBOX1_LOG_CONTAINER */
+} ImuFifo;
+
+static MessageData_T Message;
+
+/* Checks of the messages sent */
+static struct
+{
+  ULONG Drains;
+  ULONG Sent;
+  ULONG Discarded;           /* Pairs before the first time stamp */
+  ULONG Mismatched;          /* Accelerometer and gyroscope of two samples */
+  ULONG BadTime;             /* Time stamp not of the sample */
+  ULONG Gaps;                /* Samples missing between two sent */
+  ULONG Missing;             /* Samples missing and not overwritten on the FIFO */
+  ULONG Overwritten;         /* Samples with one word overwritten on the FIFO */
+  ULONG BadDelta;            /* Time stamp steps out of the ODR */
+  ULONG Backsteps;           /* LogTime lower than the one before */
+  uint32_t DeltaMin;
+  uint32_t DeltaMax;
+  double LogErrMin;          /* LogTime - real time of the sample (mS) */
+  double LogErrMax;
+  double LogErrSum;
+  int Last;                  /* Sample of the last message (-1 before the first one) */
+  ULONG LastLogTime;
+} Stats;
+
+/* Options */
+static double Duration = 60;         /* S */
+static double Jitter = 3000;         /* uS */
+static double StallTime = 0;         /* uS */
+static double StallPeriod = 10;      /* S */
+static double Ppm = 1000;
+static double WrapTime = 5;          /* S */
+
+/* Private function prototypes -----------------------------------------------*/
+static double Sample_Time(uint32_t Sample);
+static uint32_t Sample_TimeStamp(uint32_t Sample);
+static void Fifo_Push(uint8_t Tag, const uint8_t *Data, uint32_t Sample);
+static void Fifo_Update(void);
+static int32_t Fifo_ReadReg(uint8_t Reg, uint8_t *Data, uint16_t Len);
+static int32_t BSP_MOTION_SENSOR_FIFO_Get_Num_Samples(uint16_t *NumSamples);
+static int32_t BSP_MOTION_SENSOR_FIFO_Read(uint8_t *Data, uint16_t Words);
+static ULONG HAL_GetTick(void);
+static void ImuFifo_GetAxes(BSP_MOTION_SENSOR_Axes_t *Axes, const uint8_t *Data, float Sensitivity);
+static void ImuFifo_Drain(void);
+static void Message_Check(void);
+static int Run(void);
+static void Usage(const char *Name);
+
+/**
+* @brief  Real time of one sample, with the error of the sensor oscillator
+* @param  Sample: Sample number
+* @retval Time in uS
+*/
+static double Sample_Time(uint32_t Sample)
+{
+  return (Sample + 1) * 1000000.0 / (Sensor->Odr * (1.0 + Fifo.Ppm / 1000000.0));
+}
+
+/**
+* @brief  Time stamp of one sample: the counter and the ODR have the same oscillator
+* @param  Sample: Sample number
+* @retval Time stamp
+*/
+static uint32_t Sample_TimeStamp(uint32_t Sample)
+{
+  return Fifo.TsStart + (uint32_t)(uint64_t)((Sample + 1) * (double)Sensor->TsFrequency / Sensor->Odr);
+}
+
+/**
+* @brief  Write one word on the FIFO: in stream mode the oldest one is overwritten when full
+* @param  Tag: Sensor tag
+* @param  Data: 6 data bytes
+* @param  Sample: Sample number
+* @retval None
+*/
+static void Fifo_Push(uint8_t Tag, const uint8_t *Data, uint32_t Sample)
+{
+  FifoWord_T *Word;
+
+  if (Fifo.Level == Fifo.Depth) {
+    Fifo.Lost[Fifo.Words[Fifo.Head].Sample] = 1;
+    Fifo.Head = (Fifo.Head + 1) % Fifo.Depth;
+    Fifo.Level--;
+    Fifo.Overrun = 1;
+  }
+
+  Word = &Fifo.Words[(Fifo.Head + Fifo.Level) % Fifo.Depth];
+  /* TAG_SENSOR [7:3], TAG_CNT [2:1] */
+  Word->Data[0] = (uint8_t)((Tag << 3) | (Fifo.TagCnt << 1));
+  memcpy(Word->Data + 1, Data, IMU_FIFO_WORD_SIZE - 1);
+  Word->Sample = Sample;
+  Fifo.Level++;
+}
+
+/**
+* @brief  Batch on the FIFO the samples taken up to now: one time stamp word
+*         (decimation 1), then the gyroscope and the accelerometer. The axes
+*         are the sample number, for checking the pairs
+* @param  None
+* @retval None
+*/
+static void Fifo_Update(void)
+{
+  uint8_t Data[IMU_FIFO_WORD_SIZE - 1];
+  uint32_t Sample;
+
+  while ((Fifo.NextSample < Fifo.Samples) && (Sample_Time(Fifo.NextSample) <= Now)) {
+    Sample = Fifo.NextSample++;
+
+    memset(Data, 0, sizeof(Data));
+    SDLOG_PutU32(Data, Sample_TimeStamp(Sample));
+    Fifo_Push(IMU_FIFO_TAG_TIMESTAMP, Data, Sample);
+
+    SDLOG_PutU16(Data, (uint16_t)(Sample & 0x7FFFU));
+    SDLOG_PutU16(Data + 2, (uint16_t)((Sample >> 15) & 0x7FFFU));
+    SDLOG_PutU16(Data + 4, 1);
+    Fifo_Push(IMU_FIFO_TAG_GYRO, Data, Sample);
+    SDLOG_PutU16(Data + 4, 2);
+    Fifo_Push(IMU_FIFO_TAG_ACC, Data, Sample);
+
+    Fifo.TagCnt = (Fifo.TagCnt + 1) & 0x3U;
+  }
+}
+
+/**
+* @brief  Multiple bytes read of the registers: FIFO_STATUS1/2 and FIFO_DATA_OUT_TAG,
+*         where the address rolls back to the tag at each word
+* @param  Reg: First register
+* @param  Data: Bytes read
+* @param  Len: Number of bytes
+* @retval 0 in case of success, an error code otherwise
+*/
+static int32_t Fifo_ReadReg(uint8_t Reg, uint8_t *Data, uint16_t Len)
+{
+  uint16_t Index;
+
+  Fifo_Update();
+
+  if ((Reg == Sensor->StatusReg) && (Len == 2)) {
+    Data[0] = (uint8_t)Fifo.Level;
+    Data[1] = (uint8_t)((Fifo.Level >> 8) & ((1U << Sensor->LevelBits) - 1U));
+    if (Fifo.Overrun) {
+      Data[1] |= FIFO_STATUS2_OVR_IA;
+      Fifo.Overrun = 0;
+    }
+    if (Fifo.Level >= STBOX1_IMU_FIFO_WATERMARK) {
+      Data[1] |= FIFO_STATUS2_WTM_IA;
+    }
+    return 0;
+  }
+
+  if ((Reg == FIFO_DATA_OUT_TAG) && ((Len % IMU_FIFO_WORD_SIZE) == 0)) {
+    for (Index = 0; Index < Len; Index += IMU_FIFO_WORD_SIZE) {
+      if (Fifo.Level == 0) {
+        /* Empty FIFO: tag 0 */
+        memset(Data + Index, 0, IMU_FIFO_WORD_SIZE);
+        continue;
+      }
+      memcpy(Data + Index, Fifo.Words[Fifo.Head].Data, IMU_FIFO_WORD_SIZE);
+      Fifo.Head = (Fifo.Head + 1) % Fifo.Depth;
+      Fifo.Level--;
+    }
+    return 0;
+  }
+
+  return -1;
+}
+
+/**
+* @brief  Number of words on the FIFO (as the component drivers: DIFF_FIFO of FIFO_STATUS1/2)
+* @param  NumSamples: Words on the FIFO
+* @retval BSP status
+*/
+static int32_t BSP_MOTION_SENSOR_FIFO_Get_Num_Samples(uint16_t *NumSamples)
+{
+  uint8_t Status[2];
+
+  if (Fifo_ReadReg(Sensor->StatusReg, Status, 2) != 0) {
+    return BSP_ERROR_COMPONENT;
+  }
+  *NumSamples = (uint16_t)(Status[0] | ((Status[1] & ((1U << Sensor->LevelBits) - 1U)) << 8));
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+* @brief  Burst read of the FIFO words (as the component drivers: one read from FIFO_DATA_OUT_TAG)
+* @param  Data: Words read
+* @param  Words: Number of words
+* @retval BSP status
+*/
+static int32_t BSP_MOTION_SENSOR_FIFO_Read(uint8_t *Data, uint16_t Words)
+{
+  if (Fifo_ReadReg(FIFO_DATA_OUT_TAG, Data, (uint16_t)(Words * IMU_FIFO_WORD_SIZE)) != 0) {
+    return BSP_ERROR_COMPONENT;
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+* @brief  SysTick of the MCU
+* @param  None
+* @retval Time in mS
+*/
+static ULONG HAL_GetTick(void)
+{
+  return (ULONG)(Now / 1000.0);
+}
+
+/**
+* @brief  Copy of ImuFifo_GetAxes of FileX/App/app_filex.c
+* @param  Axes: Output axes
+* @param  Data: 6 data bytes of one FIFO word
+* @param  Sensitivity: Sensor sensitivity
+* @retval None
+*/
+static void ImuFifo_GetAxes(BSP_MOTION_SENSOR_Axes_t *Axes, const uint8_t *Data, float Sensitivity)
+{
+  Axes->x = (int32_t)((float)(int16_t)(Data[0] | (Data[1] << 8)) * Sensitivity);
+  Axes->y = (int32_t)((float)(int16_t)(Data[2] | (Data[3] << 8)) * Sensitivity);
+  Axes->z = (int32_t)((float)(int16_t)(Data[4] | (Data[5] << 8)) * Sensitivity);
+}
+
+/**
+* @brief  Copy of ImuFifo_Drain of FileX/App/app_filex.c: the slower sensors
+*         are not read and the message is checked instead of sent
+* @param  None
+* @retval None
+*/
+static void ImuFifo_Drain(void)
+{
+  MessageData_T *Msg;
+  uint16_t Level, Words, Index;
+  uint32_t Sent = 0;
+#ifdef STBOX1_LOG_CONTAINER
+  ULONG DrainTick;
+#endif /* STBOX1_LOG_CONTAINER */
+
+  if (BSP_MOTION_SENSOR_FIFO_Get_Num_Samples(&Level) != BSP_ERROR_NONE)
+  {
+    return;
+  }
+
+  if (Level > ImuFifo.MaxLevel)
+  {
+    ImuFifo.MaxLevel = Level;
+  }
+
+  if (Level < STBOX1_IMU_FIFO_WATERMARK)
+  {
+    return;
+  }
+  Stats.Drains++;
+
+#ifdef STBOX1_LOG_CONTAINER
+  /* The newest sample on the FIFO has been just taken */
+  DrainTick = HAL_GetTick();
+#endif /* STBOX1_LOG_CONTAINER */
+
+  while (Level > 0)
+  {
+    Words = (Level > STBOX1_IMU_FIFO_WATERMARK) ? STBOX1_IMU_FIFO_WATERMARK : Level;
+
+    if (BSP_MOTION_SENSOR_FIFO_Read(ImuFifoBuffer, Words) != BSP_ERROR_NONE)
+    {
+      break;
+    }
+    ImuFifo.Bursts++;
+    ImuFifo.Words += Words;
+    Level -= Words;
+
+    for (Index = 0; Index < Words; Index++)
+    {
+      const uint8_t *Word = ImuFifoBuffer + Index * IMU_FIFO_WORD_SIZE;
+      uint8_t Tag = Word[0] >> 3;
+      uint8_t Cnt = (Word[0] >> 1) & 0x03U;
+
+      /* After one overrun the FIFO can start in the middle of one batch: the
+         accelerometer and the gyroscope are paired only with the same TAG_CNT */
+      if ((Tag == IMU_FIFO_TAG_ACC) || (Tag == IMU_FIFO_TAG_GYRO))
+      {
+        if ((ImuFifo.Pending != 0) && (Cnt != ImuFifo.PendingCnt))
+        {
+          ImuFifo.Pending = 0;
+          ImuFifo.Unpaired++;
+        }
+        ImuFifo.PendingCnt = Cnt;
+      }
+
+      switch (Tag)
+      {
+        case IMU_FIFO_TAG_TIMESTAMP:
+          ImuFifo.Time = (uint32_t)Word[1] | ((uint32_t)Word[2] << 8) |
+                         ((uint32_t)Word[3] << 16) | ((uint32_t)Word[4] << 24);
+          ImuFifo.TimeValid = 1;
+#ifdef STBOX1_LOG_CONTAINER
+          if (ImuFifo.AnchorValid == 0)
+          {
+            /* First time stamp: 3 words for each sample are still on the FIFO after it */
+            ImuFifo.AnchorTime = ImuFifo.Time;
+            ImuFifo.AnchorTick = DrainTick - (ULONG)(((Level + Words - Index) / 3) * 1000.0f / ImuFifo.FifoOdr);
+            ImuFifo.AnchorValid = 1;
+          }
+#endif /* STBOX1_LOG_CONTAINER */
+          break;
+        case IMU_FIFO_TAG_ACC:
+          ImuFifo_GetAxes(&ImuFifo.acc, Word + 1, ImuFifo.AccSensitivity);
+          ImuFifo.Pending |= IMU_FIFO_TAG_ACC;
+          break;
+        case IMU_FIFO_TAG_GYRO:
+          ImuFifo_GetAxes(&ImuFifo.gyro, Word + 1, ImuFifo.GyroSensitivity);
+          ImuFifo.Pending |= IMU_FIFO_TAG_GYRO;
+          break;
+        default:
+          /* Tag not used */
+          break;
+      }
+
+      if (ImuFifo.Pending != (IMU_FIFO_TAG_ACC | IMU_FIFO_TAG_GYRO))
+      {
+        continue;
+      }
+      ImuFifo.Pending = 0;
+
+      /* The samples before the first time stamp are discarded */
+      if (ImuFifo.TimeValid == 0)
+      {
+        Stats.Discarded++;
+        continue;
+      }
+
+      Msg = &Message;
+      Msg->MsgTime = ImuFifo.Time;
+      Msg->acc = ImuFifo.acc;
+      Msg->gyro = ImuFifo.gyro;
+#ifdef STBOX1_LOG_CONTAINER
+      /* Sensor time stamp converted to mS from the last sample of the previous drain */
+      Msg->LogTime = ImuFifo.AnchorTick +
+                     (ULONG)(((uint64_t)(ImuFifo.Time - ImuFifo.AnchorTime) * 1000) / Sensor->TsFrequency);
+      /* The slower sensors are saved only once for each drain */
+      Msg->SlowSensors = (Sent == 0);
+#endif /* STBOX1_LOG_CONTAINER */
+      Message_Check();
+      Sent++;
+    }
+  }
+
+#ifdef STBOX1_LOG_CONTAINER
+  /* The last sample read is the reference for the next drain */
+  if (ImuFifo.AnchorValid)
+  {
+    ImuFifo.AnchorTime = ImuFifo.Time;
+    ImuFifo.AnchorTick = DrainTick;
+  }
+#endif /* STBOX1_LOG_CONTAINER */
+}
+
+/**
+* @brief  Check one message: pair and time stamp of the same sample, samples
+*         missing after the one before (only the ones overwritten on the
+*         FIFO), time stamp step and LogTime against the real time
+* @param  None
+* @retval None
+*/
+static void Message_Check(void)
+{
+  uint32_t Sample = (uint32_t)Message.acc.x | ((uint32_t)Message.acc.y << 15);
+  uint32_t GyroSample = (uint32_t)Message.gyro.x | ((uint32_t)Message.gyro.y << 15);
+  uint32_t Missing, Delta, Step, Expected;
+  double Error;
+
+  Stats.Sent++;
+
+  if ((Message.acc.z != 2) || (Message.gyro.z != 1) || (Sample != GyroSample)) {
+    Stats.Mismatched++;
+    return;
+  }
+
+  if (Message.MsgTime != Sample_TimeStamp(Sample)) {
+    Stats.BadTime++;
+    return;
+  }
+
+  if (Stats.Last >= 0) {
+    Missing = Sample - (uint32_t)Stats.Last - 1;
+    if (Missing != 0) {
+      Stats.Gaps++;
+      for (Step = (uint32_t)Stats.Last + 1; Step < Sample; Step++) {
+        if (Fifo.Lost[Step] == 0) {
+          Stats.Missing++;
+        }
+      }
+    }
+
+    /* The time stamps of consecutive samples differ by TsFrequency / Odr ticks */
+    Delta = Message.MsgTime - Sample_TimeStamp((uint32_t)Stats.Last);
+    Step = Sample - (uint32_t)Stats.Last;
+    Expected = (uint32_t)((double)Step * Sensor->TsFrequency / Sensor->Odr);
+    if ((Delta < Expected) || (Delta > Expected + 1)) {
+      Stats.BadDelta++;
+    }
+    if (Step == 1) {
+      if (Delta < Stats.DeltaMin) {
+        Stats.DeltaMin = Delta;
+      }
+      if (Delta > Stats.DeltaMax) {
+        Stats.DeltaMax = Delta;
+      }
+    }
+
+    if (Message.LogTime < Stats.LastLogTime) {
+      Stats.Backsteps++;
+    }
+  }
+  Stats.Last = (int)Sample;
+  Stats.LastLogTime = Message.LogTime;
+
+  Error = (double)Message.LogTime - Sample_Time(Sample) / 1000.0;
+  if (Error < Stats.LogErrMin) {
+    Stats.LogErrMin = Error;
+  }
+  if (Error > Stats.LogErrMax) {
+    Stats.LogErrMax = Error;
+  }
+  Stats.LogErrSum += Error;
+}
+
+/**
+* @brief  One log of Duration seconds with the sensor selected: the Reading
+*         Timer expires every 10 mS, or the FIFO level reaches the watermark
+*         and INT1 rises (one edge until the level goes down again), and the
+*         thread runs after up to Jitter uS (and after StallTime uS every
+*         StallPeriod seconds)
+* @param  None
+* @retval 0 if all the checks are passed, 1 otherwise
+*/
+static int Run(void)
+{
+  double Tick, Stall, Limit;
+  uint32_t Sample, Overwritten = 0;
+  int Failed, Line = 0;
+
+  memset(&Fifo, 0, sizeof(Fifo));
+  memset(&ImuFifo, 0, sizeof(ImuFifo));
+  memset(&Stats, 0, sizeof(Stats));
+  Stats.Last = -1;
+  Stats.DeltaMin = UINT32_MAX;
+  Stats.LogErrMin = 1e9;
+  Stats.LogErrMax = -1e9;
+
+  /* Depth: highest level of DIFF_FIFO */
+  Fifo.Depth = (1U << (8 + Sensor->LevelBits)) - 1U;
+  Fifo.Words = (FifoWord_T *)malloc(Fifo.Depth * sizeof(FifoWord_T));
+  Fifo.Samples = (uint32_t)(Duration * Sensor->Odr) + 1;
+  Fifo.Lost = (uint8_t *)calloc(Fifo.Samples, 1);
+  Fifo.Ppm = Ppm;
+  Fifo.TsStart = (uint32_t)(0x100000000ULL - (uint64_t)(WrapTime * Sensor->TsFrequency));
+  if ((Fifo.Words == NULL) || (Fifo.Lost == NULL)) {
+    fprintf(stderr, "Out of memory\n");
+    exit(1);
+  }
+
+  ImuFifo.AccSensitivity = 1.0f;
+  ImuFifo.GyroSensitivity = 1.0f;
+  ImuFifo.FifoOdr = Sensor->Odr;
+
+  /* The first tick of the Reading Timer is at a random point of the first 10 mS */
+  Tick = READING_TIMER_US * (double)rand_r(&Seed) / RAND_MAX;
+  Stall = StallPeriod * 1000000.0;
+  Limit = Duration * 1000000.0;
+  while (Sensor->Int1 && (Fifo.NextSample < Fifo.Samples) && (Sample_Time(Fifo.NextSample) < Limit)) {
+    /* One more sample batched: INT1 follows the watermark flag */
+    Now = Sample_Time(Fifo.NextSample);
+    Fifo_Update();
+    if (Fifo.Level < STBOX1_IMU_FIFO_WATERMARK) {
+      Line = 0;
+      continue;
+    }
+    if (Line) {
+      continue;
+    }
+    Line = 1;
+
+    Now += Jitter * (double)rand_r(&Seed) / RAND_MAX;
+    if ((StallTime > 0) && (Now >= Stall)) {
+      Now += StallTime;
+      Stall += StallPeriod * 1000000.0;
+    }
+    ImuFifo_Drain();
+    Line = (Fifo.Level >= STBOX1_IMU_FIFO_WATERMARK);
+  }
+  for (; !Sensor->Int1 && (Tick < Limit); Tick += READING_TIMER_US) {
+    Now = Tick + Jitter * (double)rand_r(&Seed) / RAND_MAX;
+    if ((StallTime > 0) && (Now >= Stall)) {
+      Now += StallTime;
+      Stall += StallPeriod * 1000000.0;
+      while (Tick + READING_TIMER_US < Now) {
+        Tick += READING_TIMER_US;
+      }
+    }
+    ImuFifo_Drain();
+  }
+
+  /* Samples still on the FIFO (or not yet batched) at the stop */
+  Now = Limit;
+  Fifo_Update();
+  for (Sample = 0; Sample < Fifo.Samples; Sample++) {
+    Overwritten += Fifo.Lost[Sample];
+  }
+  Stats.Overwritten = Overwritten;
+
+  printf("%s (%s): %.0f Hz, time stamp %lu Hz, FIFO of %lu words, watermark %d%s\n",
+         Sensor->Name, Sensor->Board, Sensor->Odr, (unsigned long)Sensor->TsFrequency,
+         (unsigned long)Fifo.Depth, STBOX1_IMU_FIFO_WATERMARK, Sensor->Int1 ? " on INT1" : "");
+  printf("Samples  Sent  Overwritten  Discarded  OnFifo  Gaps  Missing  Mismatched  BadTime\n");
+  printf("%7lu %6lu %12lu %10lu %7lu %5lu %8lu %11lu %8lu\n",
+         (unsigned long)Fifo.NextSample, Stats.Sent, Stats.Overwritten, Stats.Discarded,
+         (unsigned long)(Fifo.Level / WORDS_PER_SAMPLE), Stats.Gaps, Stats.Missing,
+         Stats.Mismatched, Stats.BadTime);
+  printf("Drains  Bursts  MaxLevel  Unpaired  TsStep min/max  BadStep  LogTime err min/avg/max mS  Backsteps\n");
+  printf("%6lu %7lu %9lu %9lu %9lu/%-5lu %8lu %11.2f/%.2f/%.2f %13lu\n",
+         Stats.Drains, ImuFifo.Bursts, ImuFifo.MaxLevel, ImuFifo.Unpaired,
+         (unsigned long)Stats.DeltaMin, (unsigned long)Stats.DeltaMax, Stats.BadDelta,
+         Stats.LogErrMin, (Stats.Sent != 0) ? Stats.LogErrSum / Stats.Sent : 0.0, Stats.LogErrMax,
+         Stats.Backsteps);
+
+  /* LogTime: up to one sample period from DrainTick (the first anchor counts the
+     samples still on the FIFO, the others take the last sample as taken at
+     DrainTick) and 1 mS of HAL_GetTick() and 1 mS of the conversions */
+  Failed = (Stats.Sent == 0) || (Stats.Missing != 0) || (Stats.Mismatched != 0) ||
+           (Stats.BadTime != 0) || (Stats.BadDelta != 0) ||
+           (Stats.LogErrMin < -1000.0 / Sensor->Odr - 2.0) || (Stats.LogErrMax > 1000.0 / Sensor->Odr + 2.0);
+  if (Stats.Sent + Stats.Discarded + Stats.Overwritten + Fifo.Level / WORDS_PER_SAMPLE < Fifo.NextSample) {
+    Failed = 1;
+  }
+  printf("%s\n", Failed ? "FAILED" : "OK: each sample sent or overwritten on the FIFO, time stamps continuous");
+
+  free(Fifo.Words);
+  free(Fifo.Lost);
+
+  return Failed;
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-t S] [-j uS] [-s uS] [-p S] [-d ppm] [-w S] [-b board]\n", Name);
+  fprintf(stderr, "  -t  log duration (default 60 S)\n");
+  fprintf(stderr, "  -j  highest delay of the sensors thread after each tick or interrupt (default 3000 uS)\n");
+  fprintf(stderr, "  -s  one stall of the sensors thread every -p seconds (default 0 uS)\n");
+  fprintf(stderr, "  -p  period of the stalls (default 10 S)\n");
+  fprintf(stderr, "  -d  error of the sensor oscillator (default 1000 ppm)\n");
+  fprintf(stderr, "  -w  time of the time stamp counter before its wrap, at the start (default 5 S)\n");
+  fprintf(stderr, "  -b  only one board: STEVAL-MKBOXPRO or STEVAL-STWINBX1\n");
+}
+
+int main(int argc, char *argv[])
+{
+  const char *Board = NULL;
+  unsigned int Index;
+  int Arg, Failed = 0;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-t") == 0) && (Arg + 1 < argc)) {
+      Duration = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-j") == 0) && (Arg + 1 < argc)) {
+      Jitter = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 1 < argc)) {
+      StallTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      StallPeriod = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-d") == 0) && (Arg + 1 < argc)) {
+      Ppm = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-w") == 0) && (Arg + 1 < argc)) {
+      WrapTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Board = argv[++Arg];
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if ((Duration <= 0) || (Jitter < 0) || (StallTime < 0) || (StallPeriod <= 0) || (WrapTime < 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  printf("%.0f S, Reading Timer every %d uS, up to %.0f uS late", Duration, READING_TIMER_US, Jitter);
+  if (StallTime > 0) {
+    printf(" (%.0f uS every %.0f S)", StallTime, StallPeriod);
+  }
+  printf(", oscillator %+.0f ppm\n", Ppm);
+
+  for (Index = 0; Index < SENSORS; Index++) {
+    if ((Board != NULL) && (strcmp(Board, Sensors[Index].Board) != 0)) {
+      continue;
+    }
+    Sensor = &Sensors[Index];
+    Failed |= Run();
+  }
+
+  if (Sensor == NULL) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  return Failed;
+}
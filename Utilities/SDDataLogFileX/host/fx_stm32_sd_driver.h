@@ -0,0 +1,119 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\host\fx_stm32_sd_driver.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host configuration of the FileX SD driver of the firmware
+  *          (Middlewares/ST/filex/common/drivers/fx_stm32_sd_driver.c) for the
+  *          benchmarks: the SD card functions are implemented by the benchmark
+  *          on one simulated card and each transfer is completed at once
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FX_STM32_SD_DRIVER_H
+#define FX_STM32_SD_DRIVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "fx_api.h"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Same statistics of the firmware (FileX/Target/fx_stm32_sd_driver.h) */
+typedef struct
+{
+  ULONG Requests;            /* Read and write requests */
+  ULONG UnalignedRequests;   /* Requests with one unaligned buffer */
+  ULONG UnalignedSectors;    /* Sectors of the unaligned requests */
+  ULONG ScratchTransfers;    /* Transfers through the scratch buffer */
+  ULONG ReadyChecks;         /* Card ready waits */
+  ULONG64 ReadyCycles;       /* Time of the card ready waits */
+  ULONG ReadyMax;            /* Max time of one card ready wait */
+  ULONG ReadAheadFills;      /* Read-ahead buffer filled */
+  ULONG ReadAheadHits;       /* Sectors read from the read-ahead buffer */
+} FX_STM32_SD_DRIVER_STATS;
+
+/* Same card statistics of the firmware (STBOX1_SD_CARD_EVENTS) */
+typedef struct
+{
+  ULONG Busy;                /* Waits with the card busy */
+  ULONG Events;              /* Busy end interrupts */
+  ULONG Polls;               /* Card status commands of the waits */
+  ULONG Timeouts;            /* Waits ended by timeout */
+} FX_STM32_SD_CARD_STATS;
+
+/* Exported constants --------------------------------------------------------*/
+#define FX_STM32_SD_DEFAULT_TIMEOUT                           1000
+#define FX_STM32_SD_INSTANCE                                  0
+#define FX_STM32_SD_DEFAULT_SECTOR_SIZE                       512
+#define FX_STM32_SD_INIT                                      1
+#define FX_STM32_SD_DMA_API                                   1
+#define FX_STM32_SD_CACHE_MAINTENANCE                         0
+#define FX_STM32_SD_STATS                                     1
+
+/* FX_STM32_SD_SCRATCH_SECTORS, FX_STM32_SD_CARD_EVENTS and FX_STM32_SD_READ_AHEAD_SECTORS
+   are given by the Makefile */
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* The benchmark is single thread: the card time is simulated by
+ * fx_stm32_sd_get_status, so the timeout is never reached */
+#define FX_STM32_SD_CURRENT_TIME()                            0
+
+/* Time base of the statistics (uS of the host) */
+#define FX_STM32_SD_CYCLES()                                  fx_stm32_sd_host_cycles()
+
+#define FX_STM32_SD_PRE_INIT(_media_ptr)                      do { _media_ptr->fx_media_driver_status = FX_SUCCESS; } while(0)
+#define FX_STM32_SD_POST_INIT(_media_ptr)
+#define FX_STM32_SD_POST_DEINIT(_media_ptr)
+#define FX_STM32_SD_POST_ABORT(_media_ptr)
+
+#define FX_STM32_SD_PRE_READ_TRANSFER(__media_ptr__)
+#define FX_STM32_SD_POST_READ_TRANSFER(__media_ptr__)
+#define FX_STM32_SD_READ_TRANSFER_ERROR(__status__)           do { __status__ = FX_IO_ERROR; } while(0)
+#define FX_STM32_SD_READ_CPLT_NOTIFY()
+#define FX_STM32_SD_WRITE_CPLT_NOTIFY()
+#define FX_STM32_SD_PRE_WRITE_TRANSFER                        FX_STM32_SD_PRE_READ_TRANSFER
+#define FX_STM32_SD_POST_WRITE_TRANSFER                       FX_STM32_SD_POST_READ_TRANSFER
+#define FX_STM32_SD_WRITE_TRANSFER_ERROR                      FX_STM32_SD_READ_TRANSFER_ERROR
+
+/* Exported functions prototypes ---------------------------------------------*/
+INT fx_stm32_sd_init(UINT Instance);
+INT fx_stm32_sd_deinit(UINT Instance);
+
+INT fx_stm32_sd_get_status(UINT Instance);
+
+INT fx_stm32_sd_read_blocks(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks);
+INT fx_stm32_sd_write_blocks(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks);
+
+ULONG fx_stm32_sd_host_cycles(VOID);
+
+#if (FX_STM32_SD_CARD_EVENTS == 1)
+INT fx_stm32_sd_wait_ready(UINT Instance);
+VOID fx_stm32_sd_card_irq(UINT Instance);
+#endif
+
+VOID fx_stm32_sd_driver(FX_MEDIA *media_ptr);
+
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FX_STM32_SD_DRIVER_H */
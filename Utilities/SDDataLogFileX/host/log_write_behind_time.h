@@ -0,0 +1,40 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\host\log_write_behind_time.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host time base of the write-behind layer of the firmware
+  *          (FileX/App/log_write_behind.c) for the benchmarks: included before
+  *          the module, it replaces the one tick resolution of its statistics
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef LOG_WRITE_BEHIND_TIME_H
+#define LOG_WRITE_BEHIND_TIME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Exported macro ------------------------------------------------------------*/
+#define LOG_WRITE_BEHIND_TIME_US()      log_write_behind_host_us()
+
+/* Exported functions prototypes ---------------------------------------------*/
+unsigned int log_write_behind_host_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOG_WRITE_BEHIND_TIME_H */
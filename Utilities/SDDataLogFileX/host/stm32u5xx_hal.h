@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\host\stm32u5xx_hal.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host replacement of the HAL header for the modules of the firmware
+  *          that use only the CMSIS memory barriers (FileX/App/msg_ring.h)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef STM32U5XX_HAL_H
+#define STM32U5XX_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* Data Memory Barrier: one full fence of the compiler and of the host CPU */
+#define __DMB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32U5XX_HAL_H */
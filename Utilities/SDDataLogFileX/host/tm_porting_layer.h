@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\host\tm_porting_layer.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host porting layer of the thread_metric tests for tmbench: included
+  *          before the tests, it replaces the Cortex-M SVC of
+  *          TM_CAUSE_INTERRUPT with one interrupt simulated on the ThreadX
+  *          Linux port and sizes the messages of the queue for the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+/* Same guard of thread_metric/tm_porting_layer.h: the original one is skipped */
+#ifndef TM_PORTING_LAYER_H
+#define TM_PORTING_LAYER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* Exported macro ------------------------------------------------------------*/
+#define TM_CAUSE_INTERRUPT    tm_interrupt_raise();
+
+/* The porting layer of the ThreadX example sends the 16 bytes messages of the
+   tests as TX_4_ULONG: on 64 bit hosts the messages are 4 unsigned long of 8
+   bytes, with ThreadX ULONG of 4 bytes */
+#ifdef TX_API_H
+#undef TX_4_ULONG
+#define TX_4_ULONG            ((4 * sizeof(unsigned long)) / sizeof(ULONG))
+#endif
+
+/* Exported functions prototypes ---------------------------------------------*/
+void tm_interrupt_raise(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TM_PORTING_LAYER_H */
@@ -0,0 +1,321 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\lac2wav.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host tool for converting the SDDataLogFileX compressed audio
+  *          (MicXXX.lac) to one .wav file
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sdlog_utils.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Compressed audio layout (see SDDataLogFileX\FileX\App\audio_lac.h) */
+#define LAC_MAGIC              "STBOXLAC"
+#define LAC_VERSION            1
+#define LAC_HEADER_SIZE        32
+#define LAC_FRAME_SYNC         0xF1AC
+#define LAC_FRAME_HEADER_SIZE  8
+#define LAC_METHOD_VERBATIM    0
+#define LAC_METHOD_FIXED       1
+#define LAC_MAX_ORDER          3
+#define LAC_RICE_BITS          5
+#define LAC_MAX_FRAME_SAMPLES  65535
+
+#define WAV_HEADER_SIZE        44
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* MSB first bit stream reader */
+typedef struct
+{
+  const uint8_t *Data;
+  uint32_t Size;             /* Bytes of the bit stream */
+  uint32_t Position;         /* Bit position */
+} BitReader_T;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Payload[LAC_MAX_FRAME_SAMPLES * 2];
+static int16_t Samples[LAC_MAX_FRAME_SAMPLES];
+
+/**
+* @brief  Read some bits from the bit stream
+* @param  Reader: Bit stream reader
+* @param  Bits: Number of bits (<= 32)
+* @param  Value: Bits read
+* @retval 0 on success, -1 at the end of the bit stream
+*/
+static int BitReader_Get(BitReader_T *Reader, uint32_t Bits, uint32_t *Value)
+{
+  uint32_t Result = 0;
+
+  while (Bits-- > 0) {
+    if ((Reader->Position >> 3) >= Reader->Size) {
+      return -1;
+    }
+    Result = (Result << 1) | ((Reader->Data[Reader->Position >> 3] >> (7 - (Reader->Position & 7))) & 1);
+    Reader->Position++;
+  }
+
+  *Value = Result;
+  return 0;
+}
+
+/**
+* @brief  Decode the payload of one frame
+* @param  Method: Frame method
+* @param  Order: Predictor order
+* @param  NumSamples: Samples of the frame
+* @param  PartitionSamples: Residuals sharing the same Rice parameter
+* @param  Size: Payload size
+* @retval 0 on success, -1 if the frame is corrupted
+*/
+static int DecodeFrame(uint32_t Method, uint32_t Order, uint32_t NumSamples, uint32_t PartitionSamples, uint32_t Size)
+{
+  BitReader_T Reader;
+  uint32_t Index, Rice = 0;
+
+  if (Method == LAC_METHOD_VERBATIM) {
+    if (Size != (NumSamples * 2)) {
+      return -1;
+    }
+    for (Index = 0; Index < NumSamples; Index++) {
+      Samples[Index] = (int16_t)SDLOG_GetU16(Payload + Index * 2);
+    }
+    return 0;
+  }
+
+  if ((Method != LAC_METHOD_FIXED) || (Order > LAC_MAX_ORDER) ||
+      (NumSamples <= Order) || (Size < (Order * 2))) {
+    return -1;
+  }
+
+  for (Index = 0; Index < Order; Index++) {
+    Samples[Index] = (int16_t)SDLOG_GetU16(Payload + Index * 2);
+  }
+
+  Reader.Data = Payload + Order * 2;
+  Reader.Size = Size - Order * 2;
+  Reader.Position = 0;
+
+  for (Index = Order; Index < NumSamples; Index++) {
+    uint32_t Quotient = 0, Bit, Low = 0, Folded;
+    int32_t Error, Prediction;
+
+    /* New Rice parameter at the beginning of each partition */
+    if ((Index == Order) || ((Index % PartitionSamples) == 0)) {
+      if (BitReader_Get(&Reader, LAC_RICE_BITS, &Rice) != 0) {
+        return -1;
+      }
+    }
+
+    do {
+      if (BitReader_Get(&Reader, 1, &Bit) != 0) {
+        return -1;
+      }
+      Quotient += (Bit == 0);
+    } while (Bit == 0);
+
+    if ((Rice > 0) && (BitReader_Get(&Reader, Rice, &Low) != 0)) {
+      return -1;
+    }
+
+    Folded = (Quotient << Rice) | Low;
+    Error = (int32_t)(Folded >> 1) ^ -(int32_t)(Folded & 1);
+
+    switch (Order) {
+      case 0:
+        Prediction = 0;
+        break;
+      case 1:
+        Prediction = Samples[Index - 1];
+        break;
+      case 2:
+        Prediction = 2 * Samples[Index - 1] - Samples[Index - 2];
+        break;
+      default:
+        Prediction = 3 * Samples[Index - 1] - 3 * Samples[Index - 2] + Samples[Index - 3];
+        break;
+    }
+    Samples[Index] = (int16_t)(Prediction + Error);
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Write the header of one mono 16 bit .wav file
+* @param  Out: Output file
+* @param  SampleRate: Sampling frequency
+* @param  NumSamples: Number of samples
+* @retval None
+*/
+static void WriteWavHeader(FILE *Out, uint32_t SampleRate, uint32_t NumSamples)
+{
+  uint8_t Header[WAV_HEADER_SIZE];
+
+  memcpy(Header, "RIFF", 4);
+  SDLOG_PutU32(Header + 4, 36 + NumSamples * 2);
+  memcpy(Header + 8, "WAVEfmt ", 8);
+  SDLOG_PutU32(Header + 16, 16);
+  /* PCM, mono */
+  SDLOG_PutU16(Header + 20, 1);
+  SDLOG_PutU16(Header + 22, 1);
+  SDLOG_PutU32(Header + 24, SampleRate);
+  SDLOG_PutU32(Header + 28, SampleRate * 2);
+  SDLOG_PutU16(Header + 32, 2);
+  SDLOG_PutU16(Header + 34, 16);
+  memcpy(Header + 36, "data", 4);
+  SDLOG_PutU32(Header + 40, NumSamples * 2);
+
+  fwrite(Header, 1, sizeof(Header), Out);
+}
+
+/**
+* @brief  Main program
+* @param  argc: number of arguments
+* @param  argv: arguments (input .lac file and output .wav file)
+* @retval 0 on success, 1 otherwise
+*/
+int main(int argc, char **argv)
+{
+  uint8_t Header[LAC_HEADER_SIZE];
+  uint8_t FrameHeader[LAC_FRAME_HEADER_SIZE];
+  uint16_t Version, HeaderSize, FrameSamples, PartitionSamples;
+  uint32_t SampleRate, TotalSamples;
+  uint32_t NumFrames = 0, VerbatimFrames = 0, NumSamples = 0;
+  uint64_t InputBytes;
+  FILE *In, *Out;
+  int Verbose = 0;
+  int ArgIndex = 1;
+  int Result = 0;
+
+  if ((argc > 1) && (strcmp(argv[1], "-v") == 0)) {
+    Verbose = 1;
+    ArgIndex++;
+  }
+
+  if ((argc - ArgIndex) < 2) {
+    fprintf(stderr, "Usage: %s [-v] MicXXX.lac MicXXX.wav\n", argv[0]);
+    return 1;
+  }
+
+  In = fopen(argv[ArgIndex], "rb");
+  if (In == NULL) {
+    fprintf(stderr, "Error opening %s\n", argv[ArgIndex]);
+    return 1;
+  }
+
+  /* Read and check the file header */
+  if ((fread(Header, 1, sizeof(Header), In) != sizeof(Header)) ||
+      (memcmp(Header, LAC_MAGIC, 8) != 0)) {
+    fprintf(stderr, "%s is not a SDDataLogFileX compressed audio file\n", argv[ArgIndex]);
+    return 1;
+  }
+
+  Version          = SDLOG_GetU16(Header + 8);
+  HeaderSize       = SDLOG_GetU16(Header + 10);
+  SampleRate       = SDLOG_GetU32(Header + 12);
+  FrameSamples     = SDLOG_GetU16(Header + 20);
+  PartitionSamples = SDLOG_GetU16(Header + 22);
+  TotalSamples     = SDLOG_GetU32(Header + 24);
+
+  if (Version != LAC_VERSION) {
+    fprintf(stderr, "Unsupported compressed audio version %u\n", Version);
+    return 1;
+  }
+
+  if ((HeaderSize != LAC_HEADER_SIZE) || (SDLOG_GetU16(Header + 16) != 1) ||
+      (SDLOG_GetU16(Header + 18) != 16) || (PartitionSamples == 0)) {
+    fprintf(stderr, "Corrupted compressed audio header\n");
+    return 1;
+  }
+
+  Out = fopen(argv[ArgIndex + 1], "wb");
+  if (Out == NULL) {
+    fprintf(stderr, "Error opening %s\n", argv[ArgIndex + 1]);
+    fclose(In);
+    return 1;
+  }
+
+  /* The data size is updated at the end */
+  WriteWavHeader(Out, SampleRate, 0);
+
+  /* Decode all the frames */
+  while (fread(FrameHeader, 1, sizeof(FrameHeader), In) == sizeof(FrameHeader)) {
+    uint32_t FrameNumSamples = SDLOG_GetU16(FrameHeader + 2);
+    uint32_t Method = FrameHeader[4];
+    uint32_t Order = FrameHeader[5];
+    uint32_t Size = SDLOG_GetU16(FrameHeader + 6);
+
+    if (SDLOG_GetU16(FrameHeader) != LAC_FRAME_SYNC) {
+      fprintf(stderr, "Frame %u: sync not found\n", NumFrames);
+      Result = 1;
+      break;
+    }
+
+    if ((fread(Payload, 1, Size, In) != Size) ||
+        (DecodeFrame(Method, Order, FrameNumSamples, PartitionSamples, Size) != 0)) {
+      fprintf(stderr, "Frame %u: corrupted or truncated\n", NumFrames);
+      Result = 1;
+      break;
+    }
+
+    /* The samples are written little-endian */
+    {
+      uint32_t Index;
+      for (Index = 0; Index < FrameNumSamples; Index++) {
+        SDLOG_PutU16(Payload + Index * 2, (uint16_t)Samples[Index]);
+      }
+      fwrite(Payload, 2, FrameNumSamples, Out);
+    }
+
+    NumFrames++;
+    VerbatimFrames += (Method == LAC_METHOD_VERBATIM);
+    NumSamples += FrameNumSamples;
+  }
+
+  InputBytes = (uint64_t)ftell(In);
+
+  fseek(Out, 0, SEEK_SET);
+  WriteWavHeader(Out, SampleRate, NumSamples);
+
+  if ((TotalSamples != 0) && (TotalSamples != NumSamples)) {
+    fprintf(stderr, "Warning: %u samples decoded, %u expected\n", NumSamples, TotalSamples);
+  }
+
+  if (Verbose) {
+    fprintf(stderr, "%u Hz, %u samples for frame, %u samples for partition\n",
+            SampleRate, FrameSamples, PartitionSamples);
+    fprintf(stderr, "%u frames (%u verbatim), %u samples (%.2f s)\n",
+            NumFrames, VerbatimFrames, NumSamples, (double)NumSamples / SampleRate);
+    if ((InputBytes != 0) && (NumSamples != 0)) {
+      fprintf(stderr, "Compression ratio %.2f (%.2f bits for sample)\n",
+              (double)NumSamples * 2 / InputBytes, (double)InputBytes * 8 / NumSamples);
+    }
+  }
+
+  fclose(In);
+  fclose(Out);
+
+  return Result;
+}
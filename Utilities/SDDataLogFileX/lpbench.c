@@ -0,0 +1,638 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\lpbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Check of the tickless idle of the firmware (STBOX1_LOW_POWER_IDLE):
+  *          the ThreadX low power utility and low_power_idle.c run on the
+  *          ThreadX Linux port with one simulated MCU (SysTick, LPTIM1, Sleep
+  *          and Stop 2 modes) in simulated time. The expirations of the ThreadX
+  *          timers are compared with the real time and the wakeups per second
+  *          with the ones of the periodic tick
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "tx_api.h"
+#include "tx_timer.h"
+#include "tx_thread.h"
+#include "tx_initialize.h"
+#include "tx_low_power.h"
+#include "low_power_idle.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Same ThreadX tick and LPTIM1 (LSI / 4) of the firmware, times in uS */
+#define TICK_US               (1000000 / TX_TIMER_TICKS_PER_SECOND)
+#define COUNT_US              125
+#define COUNTS_PER_TICK       (TICK_US / COUNT_US)
+#define MAX_COUNTS            0xFFFF
+#define MIN_STOP_TICKS        2
+
+/* Wake up from Stop 2 up to the end of SystemClock_Config */
+#define STOP_EXIT_US          300
+
+/* Handler of one timer or interrupt: WORK_US plus up to WORK_US at random */
+#define WORK_US               50
+
+/* Highest delay of the ThreadX ticks from the real time: one tick counted
+   at the end, the exit from Stop 2 and the wait of one count of LPTIM1,
+   the handlers running at the tick */
+#define MAX_TIMERS            6
+#define MAX_LAG_US            ((int64_t)(TICK_US + STOP_EXIT_US + COUNT_US + (MAX_TIMERS * 2 * WORK_US)))
+
+/* Mixed run: one-shot timers started by the sensor interrupt (ticks and uS
+   between the interrupts) and log started / stopped by the button (uS) */
+#define ONE_SHOT_MAX_TICKS    400
+#define SENSOR_IRQ_US         500000
+#define BUTTON_IRQ_US         30000000
+
+#define NEVER                 UINT64_MAX
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  IRQ_SENSOR = 0,
+  IRQ_BUTTON,
+  IRQS
+} Irq_T;
+
+typedef struct
+{
+  const char *Name;
+  ULONG Period;              /* Ticks of the periodic timer, 0 for the mixed run */
+  UINT Stop;                 /* Tickless idle with Stop 2 (or periodic tick) */
+} Run_T;
+
+typedef struct
+{
+  TX_TIMER Timer;
+  ULONG Ticks;
+  UINT Periodic;
+  ULONG Expected;            /* ThreadX time of the next expiration */
+} BenchTimer_T;
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Simulated MCU */
+static struct
+{
+  uint64_t Now;
+  /* SysTick */
+  UINT TickRunning;
+  UINT TickPending;
+  uint64_t TickLast;         /* Start of the tick period */
+  uint64_t TickFraction;     /* uS after the last count at the stop */
+  /* LPTIM1 */
+  uint64_t TimerStart;
+  ULONG TimerCounts;
+  /* External interrupts */
+  uint64_t Irq[IRQS];
+  UINT IrqPending[IRQS];
+  /* Idle periods */
+  unsigned long Wakeups;
+  uint64_t StopTime;
+  uint64_t WakeLatency[2];   /* Highest: Sleep, Stop */
+} Mcu;
+
+static const Run_T *Run;
+static uint64_t Duration = 600ULL * 1000000;
+static unsigned int Seed = 1;
+
+/* 0..3 periodic, 4 one-shot, 5 read timer of the log */
+#define TIMER_ONE_SHOT        4
+#define TIMER_READ            5
+static BenchTimer_T Timers[MAX_TIMERS];
+static const ULONG MixedPeriods[] = {7, 100, 333, 6000};
+static UINT Logging;
+
+static struct
+{
+  unsigned long Expirations;
+  unsigned long PeriodicExpirations;
+  unsigned long TickErrors;
+  int64_t LateMin;
+  int64_t LateMax;
+  int64_t LateSum;
+} Stats;
+
+static const Run_T Runs[] = {
+  {"1 tick", 1, TX_FALSE}, {"1 tick", 1, TX_TRUE},
+  {"2 ticks", 2, TX_FALSE}, {"2 ticks", 2, TX_TRUE},
+  {"5 ticks", 5, TX_FALSE}, {"5 ticks", 5, TX_TRUE},
+  {"10 ticks", 10, TX_FALSE}, {"10 ticks", 10, TX_TRUE},
+  {"50 ticks", 50, TX_FALSE}, {"50 ticks", 50, TX_TRUE},
+  {"100 ticks", 100, TX_FALSE}, {"100 ticks", 100, TX_TRUE},
+  {"500 ticks", 500, TX_FALSE}, {"500 ticks", 500, TX_TRUE},
+  {"1000 ticks", 1000, TX_FALSE}, {"1000 ticks", 1000, TX_TRUE},
+  {"6000 ticks", 6000, TX_FALSE}, {"6000 ticks", 6000, TX_TRUE},
+  {"mixed", 0, TX_FALSE}, {"mixed", 0, TX_TRUE},
+};
+#define RUNS                  (sizeof(Runs) / sizeof(Runs[0]))
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* SysTick interrupt of the Linux port (the timers expire in it) */
+VOID _tx_timer_interrupt(VOID);
+
+static ULONG Mcu_TickElapsed(VOID);
+static ULONG Mcu_TickSuspend(VOID);
+static VOID Mcu_TickResume(ULONG Counts, ULONG Elapsed, UINT Pend);
+static VOID Mcu_TimerStart(ULONG Counts);
+static ULONG Mcu_TimerStop(VOID);
+static VOID Mcu_Sleep(VOID);
+static VOID Mcu_Stop(VOID);
+
+static const LowPowerIdle_Driver_T Driver = {
+  COUNTS_PER_TICK,
+  MAX_COUNTS,
+  MIN_STOP_TICKS,
+  Mcu_TickElapsed,
+  Mcu_TickSuspend,
+  Mcu_TickResume,
+  Mcu_TimerStart,
+  Mcu_TimerStop,
+  Mcu_Sleep,
+  Mcu_Stop
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Move the simulated time: the SysTick and the external interrupts
+*         become pending
+* @param  To: Time (uS)
+* @retval None
+*/
+static void Mcu_Advance(uint64_t To)
+{
+  int Index;
+
+  if (Mcu.TickRunning) {
+    while (Mcu.TickLast + TICK_US <= To) {
+      Mcu.TickLast += TICK_US;
+      Mcu.TickPending = TX_TRUE;
+    }
+  }
+
+  for (Index = 0; Index < IRQS; Index++) {
+    if (Mcu.Irq[Index] <= To) {
+      Mcu.IrqPending[Index] = TX_TRUE;
+    }
+  }
+
+  Mcu.Now = To;
+}
+
+/**
+* @brief  Run one handler
+* @param  None
+* @retval None
+*/
+static void Mcu_Work(void)
+{
+  Mcu_Advance(Mcu.Now + WORK_US + (uint64_t)(rand() % WORK_US));
+}
+
+static UINT Mcu_IrqPending(void)
+{
+  return Mcu.IrqPending[IRQ_SENSOR] || Mcu.IrqPending[IRQ_BUTTON];
+}
+
+static uint64_t Mcu_NextIrq(void)
+{
+  return (Mcu.Irq[IRQ_SENSOR] < Mcu.Irq[IRQ_BUTTON]) ? Mcu.Irq[IRQ_SENSOR] : Mcu.Irq[IRQ_BUTTON];
+}
+
+static ULONG Mcu_TickElapsed(VOID)
+{
+  if (Mcu.TickPending) {
+    return COUNTS_PER_TICK;
+  }
+
+  return (ULONG)((Mcu.Now - Mcu.TickLast) / COUNT_US);
+}
+
+static ULONG Mcu_TickSuspend(VOID)
+{
+  uint64_t Time = Mcu.Now - Mcu.TickLast;
+  ULONG Counts = (ULONG)(Time / COUNT_US);
+
+  Mcu.TickRunning = TX_FALSE;
+  Mcu.TickFraction = Time - ((uint64_t)Counts * COUNT_US);
+  if (Mcu.TickPending) {
+    Mcu.TickPending = TX_FALSE;
+    Counts += COUNTS_PER_TICK;
+  }
+
+  return Counts;
+}
+
+static VOID Mcu_TickResume(ULONG Counts, ULONG Elapsed, UINT Pend)
+{
+  (void)Counts;
+
+  /* The first period is shorter of the tick in progress */
+  Mcu.TickLast = Mcu.Now - Mcu.TickFraction - ((uint64_t)Elapsed * COUNT_US);
+  Mcu.TickRunning = TX_TRUE;
+  Mcu.TickPending = Pend;
+}
+
+static VOID Mcu_TimerStart(ULONG Counts)
+{
+  if ((Counts == 0) || (Counts > MAX_COUNTS)) {
+    fprintf(stderr, "Wrong LPTIM1 counts %lu\n", (unsigned long)Counts);
+    exit(1);
+  }
+
+  Mcu.TimerStart = Mcu.Now;
+  Mcu.TimerCounts = Counts;
+}
+
+/* The counter runs from the start: the stop waits for the next count */
+static ULONG Mcu_TimerStop(VOID)
+{
+  uint64_t Counts = ((Mcu.Now - Mcu.TimerStart) / COUNT_US) + 1;
+
+  Mcu_Advance(Mcu.TimerStart + (Counts * COUNT_US));
+
+  return (ULONG)Counts;
+}
+
+static VOID Mcu_Sleep(VOID)
+{
+  uint64_t Wakeup;
+
+  if (Mcu.TickPending || Mcu_IrqPending()) {
+    return;
+  }
+
+  Wakeup = Mcu_NextIrq();
+  if (Mcu.TickRunning && (Mcu.TickLast + TICK_US < Wakeup)) {
+    Wakeup = Mcu.TickLast + TICK_US;
+  }
+  if (Wakeup == NEVER) {
+    fprintf(stderr, "Sleep mode without wake up\n");
+    exit(1);
+  }
+
+  Mcu_Advance(Wakeup);
+  Mcu.Wakeups++;
+}
+
+static VOID Mcu_Stop(VOID)
+{
+  uint64_t Start = Mcu.Now;
+  uint64_t Wakeup;
+
+  if (Mcu_IrqPending()) {
+    return;
+  }
+
+  Wakeup = Mcu.TimerStart + ((uint64_t)Mcu.TimerCounts * COUNT_US);
+  if (Mcu_NextIrq() < Wakeup) {
+    Wakeup = Mcu_NextIrq();
+  }
+
+  Mcu_Advance(Wakeup);
+  Mcu.StopTime += Mcu.Now - Start;
+  Mcu_Advance(Mcu.Now + STOP_EXIT_US);
+  Mcu.Wakeups++;
+}
+
+/**
+* @brief  Hooks of the ThreadX low power utility (tx_user.h of the applications),
+*         as in app_threadx.c
+*/
+void App_ThreadX_LowPower_Timer_Setup(unsigned long count)
+{
+  LowPowerIdle_TimerSetup((ULONG)count);
+}
+
+void App_ThreadX_LowPower_Enter(void)
+{
+  LowPowerIdle_Enter();
+}
+
+void App_ThreadX_LowPower_Exit(void)
+{
+  LowPowerIdle_Exit();
+}
+
+unsigned long App_ThreadX_LowPower_Timer_Adjust(void)
+{
+  return LowPowerIdle_TimerAdjust();
+}
+
+/**
+* @brief  Expiration of one ThreadX timer: the ThreadX time must be the
+*         expected one and the real time late of less than MAX_LAG_US
+* @param  Index: Timer
+* @retval None
+*/
+static VOID Timer_Expired(ULONG Index)
+{
+  BenchTimer_T *Timer = &Timers[Index];
+  int64_t Late = (int64_t)Mcu.Now - ((int64_t)Timer->Expected * TICK_US);
+
+  if (tx_time_get() != Timer->Expected) {
+    Stats.TickErrors++;
+  }
+
+  if (Late < Stats.LateMin) {
+    Stats.LateMin = Late;
+  }
+  if (Late > Stats.LateMax) {
+    Stats.LateMax = Late;
+  }
+  Stats.LateSum += Late;
+  Stats.Expirations++;
+
+  if (Timer->Periodic) {
+    Stats.PeriodicExpirations++;
+    Timer->Expected += Timer->Ticks;
+  }
+
+  Mcu_Work();
+}
+
+/**
+* @brief  Create one timer, not active
+* @param  Index: Timer
+* @param  Ticks: Period or ticks of the one-shot
+* @param  Periodic: Periodic timer
+* @retval None
+*/
+static void Timer_Create(ULONG Index, ULONG Ticks, UINT Periodic)
+{
+  Timers[Index].Ticks = Ticks;
+  Timers[Index].Periodic = Periodic;
+  if (tx_timer_create(&Timers[Index].Timer, "Bench", Timer_Expired, Index, Ticks,
+                      Periodic ? Ticks : 0, TX_NO_ACTIVATE) != TX_SUCCESS) {
+    fprintf(stderr, "Error creating the timer\n");
+    exit(1);
+  }
+}
+
+static void Timer_Activate(ULONG Index)
+{
+  Timers[Index].Expected = tx_time_get() + Timers[Index].Ticks;
+  if (tx_timer_activate(&Timers[Index].Timer) != TX_SUCCESS) {
+    fprintf(stderr, "Error activating the timer\n");
+    exit(1);
+  }
+}
+
+/**
+* @brief  Sensor interrupt: one-shot timer with random ticks, if not active
+* @param  None
+* @retval None
+*/
+static void Irq_Sensor(void)
+{
+  UINT Active;
+
+  tx_timer_info_get(&Timers[TIMER_ONE_SHOT].Timer, TX_NULL, &Active, TX_NULL, TX_NULL, TX_NULL);
+  if (!Active) {
+    Timers[TIMER_ONE_SHOT].Ticks = 1 + (ULONG)(rand() % ONE_SHOT_MAX_TICKS);
+    tx_timer_change(&Timers[TIMER_ONE_SHOT].Timer, Timers[TIMER_ONE_SHOT].Ticks, 0);
+    Timer_Activate(TIMER_ONE_SHOT);
+  }
+
+  Mcu.Irq[IRQ_SENSOR] += (SENSOR_IRQ_US / 2) + (uint64_t)(rand() % SENSOR_IRQ_US);
+}
+
+/**
+* @brief  User button: start / stop of the log (read timer of 1 tick and
+*         Sleep mode only while logging, as app_filex.c)
+* @param  None
+* @retval None
+*/
+static void Irq_Button(void)
+{
+  Logging = !Logging;
+
+  if (Logging) {
+    LowPowerIdle_AllowStop(TX_FALSE);
+    Timer_Activate(TIMER_READ);
+  } else {
+    tx_timer_deactivate(&Timers[TIMER_READ].Timer);
+    LowPowerIdle_AllowStop(TX_TRUE);
+  }
+
+  Mcu.Irq[IRQ_BUTTON] += (BUTTON_IRQ_US / 2) + (uint64_t)(rand() % BUTTON_IRQ_US);
+}
+
+/**
+* @brief  ThreadX application define: the timers of the run
+* @param  first_unused_memory Not used
+* @retval None
+*/
+void tx_application_define(void *first_unused_memory)
+{
+  ULONG Index;
+
+  (void)first_unused_memory;
+
+  if (Run->Period != 0) {
+    Timer_Create(0, Run->Period, TX_TRUE);
+  } else {
+    for (Index = 0; Index < sizeof(MixedPeriods) / sizeof(MixedPeriods[0]); Index++) {
+      Timer_Create(Index, MixedPeriods[Index], TX_TRUE);
+    }
+    Timer_Create(TIMER_ONE_SHOT, 1, TX_FALSE);
+    Timer_Create(TIMER_READ, 1, TX_TRUE);
+  }
+}
+
+/**
+* @brief  One run in this process: the idle loop of the scheduler and the
+*         interrupts, up to the end of the simulated time
+* @param  None
+* @retval 0 if the timers and the ThreadX time are right
+*/
+static int Run_Idle(void)
+{
+  ULONG Index;
+  ULONG Stops;
+  int64_t Drift;
+  unsigned long Expected;
+  int Failed = 0;
+
+  srand(Seed);
+  memset(&Mcu, 0, sizeof(Mcu));
+  memset(&Stats, 0, sizeof(Stats));
+  Stats.LateMin = INT64_MAX;
+  Stats.LateMax = INT64_MIN;
+  Mcu.TickRunning = TX_TRUE;
+  Mcu.Irq[IRQ_SENSOR] = NEVER;
+  Mcu.Irq[IRQ_BUTTON] = NEVER;
+
+  /* ThreadX without the scheduler: the timers are created by
+     tx_application_define, then everything runs as one interrupt of the
+     idle loop (the timers expire in the tick interrupt) */
+  _tx_initialize_kernel_setup();
+  _tx_thread_system_state = TX_INITIALIZE_IN_PROGRESS;
+  tx_application_define(_tx_initialize_unused_memory);
+  _tx_thread_system_state = 1;
+
+  LowPowerIdle_Init(&Driver);
+  LowPowerIdle_AllowStop(Run->Stop);
+
+  if (Run->Period != 0) {
+    Timer_Activate(0);
+  } else {
+    for (Index = 0; Index < sizeof(MixedPeriods) / sizeof(MixedPeriods[0]); Index++) {
+      Timer_Activate(Index);
+    }
+    Mcu.Irq[IRQ_SENSOR] = SENSOR_IRQ_US;
+    if (Run->Stop) {
+      Mcu.Irq[IRQ_BUTTON] = BUTTON_IRQ_US;
+    }
+  }
+
+  while (Mcu.Now < Duration) {
+    /* Interrupts: the tick first, then the external ones */
+    while (Mcu.TickPending || Mcu_IrqPending()) {
+      if (Mcu.TickPending) {
+        Mcu.TickPending = TX_FALSE;
+        _tx_timer_interrupt();
+      } else if (Mcu.IrqPending[IRQ_SENSOR]) {
+        Mcu.IrqPending[IRQ_SENSOR] = TX_FALSE;
+        Mcu_Work();
+        Irq_Sensor();
+      } else {
+        Mcu.IrqPending[IRQ_BUTTON] = TX_FALSE;
+        Mcu_Work();
+        Irq_Button();
+      }
+    }
+
+    /* Idle loop of the scheduler (Cortex-M33 port with TX_LOW_POWER) */
+    Stops = LowPowerIdleStats.Stops;
+    tx_low_power_enter();
+    tx_low_power_exit();
+
+    /* Wake up latency of the external interrupt */
+    for (Index = 0; Index < IRQS; Index++) {
+      if (Mcu.IrqPending[Index]) {
+        uint64_t Latency = Mcu.Now - Mcu.Irq[Index];
+        UINT Mode = (LowPowerIdleStats.Stops != Stops) ? 1 : 0;
+
+        if (Latency > Mcu.WakeLatency[Mode]) {
+          Mcu.WakeLatency[Mode] = Latency;
+        }
+      }
+    }
+  }
+
+  /* Real time not yet counted by ThreadX (the tick pending is counted): it
+     doesn't grow with the run */
+  Drift = (int64_t)Mcu.Now - (((int64_t)tx_time_get() + Mcu.TickPending) * TICK_US);
+
+  /* The periodic timers of the period run expire at each multiple of the period */
+  if (Run->Period != 0) {
+    Expected = (unsigned long)(Mcu.Now / ((uint64_t)Run->Period * TICK_US));
+    if ((Stats.PeriodicExpirations + 1 < Expected) || (Stats.PeriodicExpirations > Expected)) {
+      Failed = 1;
+    }
+  }
+
+  if ((Stats.TickErrors != 0) || (Stats.Expirations == 0) ||
+      (Stats.LateMin < 0) || (Stats.LateMax > MAX_LAG_US) ||
+      (Drift < 0) || (Drift > MAX_LAG_US) ||
+      (Mcu.WakeLatency[0] != 0) || (Mcu.WakeLatency[1] > STOP_EXIT_US + COUNT_US)) {
+    Failed = 1;
+  }
+
+  printf("%-11s %-8s %9.1f %6.1f %9lu %7.1f %8lld %8lld %6lu %8lld %6llu %6llu  %s\n",
+         Run->Name, Run->Stop ? "tickless" : "periodic",
+         (double)Mcu.Wakeups * 1000000.0 / (double)Mcu.Now,
+         (double)Mcu.StopTime * 100.0 / (double)Mcu.Now,
+         Stats.Expirations, (double)Stats.LateSum / (double)(Stats.Expirations ? Stats.Expirations : 1),
+         (long long)Stats.LateMax, (long long)Drift, Stats.TickErrors,
+         (long long)LowPowerIdleStats.EarlyWakeups,
+         (unsigned long long)Mcu.WakeLatency[0], (unsigned long long)Mcu.WakeLatency[1],
+         Failed ? "FAIL" : "ok");
+
+  return Failed;
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-d seconds] [-s seed]\n", Name);
+  fprintf(stderr, "  -d  simulated time of each run (default 600 S)\n");
+  fprintf(stderr, "  -s  seed of the handler times and of the interrupts (default 1)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  int Arg;
+  unsigned int Index;
+  int Status;
+  int Failed = 0;
+  pid_t Pid;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-d") == 0) && (Arg + 1 < argc)) {
+      Duration = (uint64_t)atoi(argv[++Arg]) * 1000000;
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 1 < argc)) {
+      Seed = (unsigned int)atoi(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (Duration == 0) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  printf("%llu S simulated for each run, tick %d uS, LPTIM1 count %d uS, Stop 2 exit %d uS\n",
+         (unsigned long long)(Duration / 1000000), (int)TICK_US, COUNT_US, STOP_EXIT_US);
+  printf("Timers      Idle     Wakeups/s Stop %% Expired Late uS Late max    Drift Errors    Early  Sleep   Stop\n");
+
+  /* One process for each run: ThreadX is initialized once */
+  for (Index = 0; Index < RUNS; Index++) {
+    fflush(stdout);
+    Pid = fork();
+    if (Pid < 0) {
+      return 1;
+    }
+    if (Pid == 0) {
+      Run = &Runs[Index];
+      Status = Run_Idle();
+      fflush(stdout);
+      _exit(Status);
+    }
+    if ((waitpid(Pid, &Status, 0) != Pid) || !WIFEXITED(Status) || (WEXITSTATUS(Status) != 0)) {
+      Failed = 1;
+    }
+  }
+
+  return Failed;
+}
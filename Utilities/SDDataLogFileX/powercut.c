@@ -0,0 +1,676 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\powercut.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the SDDataLogFileX log checkpoints: one log
+  *          saved with FileX on one RAM disk is interrupted by power cuts at
+  *          random sector writes, then it's recovered and verified
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fx_api.h"
+#include "fx_fault_tolerant.h"
+#include "log_checkpoint.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* RAM disk: 32 MB, 4 KB clusters */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (64 * 1024)
+#define DISK_SECTORS_PER_CLUSTER 8
+
+/* Log model: the same data rates and write sizes of the firmware */
+#define STEP_MS               10                /* Reading Timer period */
+#define AUDIO_FREQUENCY       48000
+#define AUDIO_BLOCK_SAMPLES   (48 * 256)        /* One write each 256 mS */
+#define WAV_HEADER_SIZE       512
+#define BATCH_SIZE            (16 * 1024)       /* Sensors write batching stage */
+#define BATCH_DEADLINE        2000              /* mS */
+#define SENSORS_PREALLOCATION (2 * 1024 * 1024)
+#define AUDIO_PREALLOCATION   (8 * 1024 * 1024)
+
+#define SENSORS_FILE_NAME     "Sens000.csv"
+#define AUDIO_FILE_NAME       "Mic000.wav"
+#define CHECKPOINT_FILE_NAME  "Checkpoint.dat"
+
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define CHECK_SCRATCH_SIZE    (256 * 1024)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Sensors write batching stage (same logic of WriteBatch_T) */
+typedef struct
+{
+  FX_FILE *File;
+  UCHAR Buffer[BATCH_SIZE];
+  ULONG Index;
+  ULONG Limit;
+  ULONG64 Offset;
+  uint32_t FirstTime;
+} Batch_T;
+
+/* Results of one period */
+typedef struct
+{
+  uint32_t Trials;
+  uint32_t Failures;         /* Not mountable, not consistent or corrupted data */
+  double LossSum;            /* Seconds of log lost */
+  double LossMax;
+  uint64_t Writes;           /* Sector writes of one log without power cut */
+  uint32_t Checkpoints;
+} Result_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk;
+static uint64_t DiskWrites;  /* Sectors written from the log start */
+static uint64_t CutAt;       /* Sector write where the power is lost (0 for none) */
+static int PowerLost;
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static UCHAR FaultTolerantMemory[FX_FAULT_TOLERANT_MINIMAL_BUFFER_SIZE];
+static UCHAR CheckpointRecords[2 * LOG_CHECKPOINT_RECORD_SIZE];
+static UCHAR CheckScratch[CHECK_SCRATCH_SIZE];
+static UCHAR FileBuffer[16 * 1024 * 1024];
+
+static FX_MEDIA Media;
+static FX_FILE SensorsFile;
+static FX_FILE AudioFile;
+static FX_FILE CheckpointFile;
+static Batch_T Sensors;
+
+static int ExFat = 0;
+static int Preallocation = 0;
+static uint32_t Duration = 30;
+static uint32_t Seed = 1;
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  RAM disk driver: the sector writes after the power cut are lost
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID RamDisk_Driver(FX_MEDIA *media_ptr)
+{
+  ULONG64 Sector = media_ptr->fx_media_driver_logical_sector;
+  ULONG Count = media_ptr->fx_media_driver_sectors;
+  ULONG Index;
+
+  media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+  switch (media_ptr->fx_media_driver_request) {
+  case FX_DRIVER_READ:
+    memcpy(media_ptr->fx_media_driver_buffer, Disk + Sector * DISK_SECTOR_SIZE, Count * DISK_SECTOR_SIZE);
+    break;
+  case FX_DRIVER_WRITE:
+    for (Index = 0; Index < Count; Index++) {
+      DiskWrites++;
+      if ((CutAt != 0) && (DiskWrites >= CutAt)) {
+        PowerLost = 1;
+      }
+      if (!PowerLost) {
+        memcpy(Disk + (Sector + Index) * DISK_SECTOR_SIZE,
+               media_ptr->fx_media_driver_buffer + Index * DISK_SECTOR_SIZE, DISK_SECTOR_SIZE);
+      }
+    }
+    break;
+  case FX_DRIVER_BOOT_READ:
+    memcpy(media_ptr->fx_media_driver_buffer, Disk, DISK_SECTOR_SIZE);
+    break;
+  case FX_DRIVER_BOOT_WRITE:
+    if (!PowerLost) {
+      memcpy(Disk, media_ptr->fx_media_driver_buffer, DISK_SECTOR_SIZE);
+    }
+    break;
+  default:
+    /* Init, flush, abort, release sectors and uninit: nothing to do */
+    break;
+  }
+}
+
+/**
+* @brief  Format the RAM disk
+* @param  None
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT RamDisk_Format(void)
+{
+  memset(Disk, 0, (size_t)DISK_SECTORS * DISK_SECTOR_SIZE);
+  CutAt = 0;
+  PowerLost = 0;
+
+  if (ExFat) {
+    return fx_media_exFAT_format(&Media, RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                                 "POWERCUT", 1, 0, DISK_SECTORS, DISK_SECTOR_SIZE,
+                                 DISK_SECTORS_PER_CLUSTER, 12345, 0);
+  }
+
+  return fx_media_format(&Media, RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                         "POWERCUT", 2, 512, 0, DISK_SECTORS, DISK_SECTOR_SIZE,
+                         DISK_SECTORS_PER_CLUSTER, 1, 1);
+}
+
+/**
+* @brief  Write out the sensors data waiting on the batching stage
+* @param  None
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Batch_Flush(void)
+{
+  ULONG Size = Sensors.Index;
+
+  if (Size == 0) {
+    return FX_SUCCESS;
+  }
+
+  Sensors.Index = 0;
+  Sensors.Offset += Size;
+  Sensors.Limit = BATCH_SIZE - (ULONG)(Sensors.Offset % BATCH_SIZE);
+
+  return fx_file_write(Sensors.File, Sensors.Buffer, Size);
+}
+
+/**
+* @brief  Add one sensors line to the batching stage
+* @param  Data: Line
+* @param  Size: Bytes
+* @param  Time: Log time in mS
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Batch_Write(const char *Data, ULONG Size, uint32_t Time)
+{
+  UINT status = FX_SUCCESS;
+  ULONG Len;
+
+  while ((Size != 0) && (status == FX_SUCCESS)) {
+    if (Sensors.Index == 0) {
+      Sensors.FirstTime = Time;
+    }
+    Len = Sensors.Limit - Sensors.Index;
+    if (Len > Size) {
+      Len = Size;
+    }
+    memcpy(Sensors.Buffer + Sensors.Index, Data, Len);
+    Sensors.Index += Len;
+    Data += Len;
+    Size -= Len;
+    if (Sensors.Index == Sensors.Limit) {
+      status = Batch_Flush();
+    }
+  }
+
+  return status;
+}
+
+/**
+* @brief  Fill the 512 bytes header of the .wav file (sizes of one empty file)
+* @param  Header: Header to fill
+* @retval None
+*/
+static void Wav_Header(UCHAR *Header)
+{
+  uint32_t Value;
+
+  memset(Header, 0, WAV_HEADER_SIZE);
+  memcpy(Header, "RIFF", 4);
+  Value = WAV_HEADER_SIZE - 8;
+  memcpy(Header + 4, &Value, 4);
+  memcpy(Header + 8, "WAVEfmt ", 8);
+  Header[16] = 16;                       /* fmt chunk size */
+  Header[20] = 1;                        /* PCM */
+  Header[22] = 1;                        /* Mono */
+  Value = AUDIO_FREQUENCY;
+  memcpy(Header + 24, &Value, 4);
+  Value = AUDIO_FREQUENCY * 2;
+  memcpy(Header + 28, &Value, 4);
+  Header[32] = 2;                        /* Block align */
+  Header[34] = 16;                       /* Bits for sample */
+  memcpy(Header + 36, "JUNK", 4);
+  Value = WAV_HEADER_SIZE - 44 - 8;
+  memcpy(Header + 40, &Value, 4);
+  memcpy(Header + WAV_HEADER_SIZE - 8, "data", 4);
+}
+
+/**
+* @brief  Save one checkpoint (same sequence of CheckpointLog_Save)
+* @param  Ckpt: Checkpoint
+* @param  AudioSize: Bytes written on the .wav file
+* @param  Time: Log time in mS
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Checkpoint_Save(LogCheckpoint_T *Ckpt, ULONG64 AudioSize, uint32_t Time)
+{
+  UINT status;
+
+  status = Batch_Flush();
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(&Media);
+  }
+  if (status == FX_SUCCESS) {
+    Ckpt->Files[0].Size = Sensors.Offset;
+    Ckpt->Files[1].Size = AudioSize;
+    Ckpt->Time = Time;
+    status = LogCheckpoint_Write(&CheckpointFile, Ckpt, CheckpointRecords);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Save one log of Duration seconds on the formatted RAM disk, up to
+*         the power cut
+* @param  Period: Seconds between two checkpoints (0 without checkpoints and
+*         without the fault tolerant module)
+* @param  Checkpoints: Checkpoints saved
+* @retval Log time in mS reached before the power cut
+*/
+static uint32_t Logger_Run(uint32_t Period, uint32_t *Checkpoints)
+{
+  static UCHAR Header[WAV_HEADER_SIZE];
+  static int16_t Block[AUDIO_BLOCK_SAMPLES];
+  LogCheckpoint_T Ckpt;
+  ULONG64 AudioSize = 0;
+  uint64_t AudioSamples = 0;
+  uint32_t Line = 0;
+  uint32_t LastCheckpoint = 0;
+  uint32_t Time = 0;
+  UINT status;
+  uint32_t Index;
+
+  *Checkpoints = 0;
+  DiskWrites = 0;
+
+  status = fx_media_open(&Media, "POWERCUT", RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  if ((status == FX_SUCCESS) && (Period != 0)) {
+    status = fx_fault_tolerant_enable(&Media, FaultTolerantMemory, sizeof(FaultTolerantMemory));
+  }
+
+  /* Files opened like the firmware's COMMAND_START_LOG */
+  if (status == FX_SUCCESS) {
+    status = fx_file_create(&Media, SENSORS_FILE_NAME);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &SensorsFile, SENSORS_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+  if ((status == FX_SUCCESS) && Preallocation) {
+    status = fx_file_extended_allocate(&SensorsFile, SENSORS_PREALLOCATION);
+  }
+  if (status == FX_SUCCESS) {
+    Sensors.File = &SensorsFile;
+    Sensors.Index = 0;
+    Sensors.Offset = 0;
+    Sensors.Limit = BATCH_SIZE;
+    status = fx_file_create(&Media, AUDIO_FILE_NAME);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &AudioFile, AUDIO_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+  if ((status == FX_SUCCESS) && Preallocation) {
+    status = fx_file_extended_allocate(&AudioFile, AUDIO_PREALLOCATION);
+  }
+  if (status == FX_SUCCESS) {
+    Wav_Header(Header);
+    status = fx_file_write(&AudioFile, Header, WAV_HEADER_SIZE);
+    AudioSize = WAV_HEADER_SIZE;
+  }
+  if ((status == FX_SUCCESS) && (Period != 0)) {
+    LogCheckpoint_Init(&Ckpt);
+    strcpy(Ckpt.Files[0].Name, SENSORS_FILE_NAME);
+    strcpy(Ckpt.Files[1].Name, AUDIO_FILE_NAME);
+    Ckpt.Open = 1;
+    status = fx_file_create(&Media, CHECKPOINT_FILE_NAME);
+    if (status == FX_SUCCESS) {
+      status = fx_file_open(&Media, &CheckpointFile, CHECKPOINT_FILE_NAME, FX_OPEN_FOR_WRITE);
+    }
+    if (status == FX_SUCCESS) {
+      status = Checkpoint_Save(&Ckpt, AudioSize, 0);
+    }
+    if (status == FX_SUCCESS) {
+      status = Checkpoint_Save(&Ckpt, AudioSize, 0);
+    }
+  }
+
+  /* One step for each Reading Timer period */
+  while ((status == FX_SUCCESS) && (!PowerLost) && (Time < (Duration * 1000U))) {
+    char Text[64];
+    int Size;
+
+    Time += STEP_MS;
+
+    Size = sprintf(Text, "%u, %u, %d, 1000\r\n", (unsigned)Time, (unsigned)Line, -(int)Line);
+    Line++;
+    status = Batch_Write(Text, (ULONG)Size, Time);
+
+    if ((status == FX_SUCCESS) && (((uint64_t)Time * AUDIO_FREQUENCY / 1000) >= (AudioSamples + AUDIO_BLOCK_SAMPLES))) {
+      for (Index = 0; Index < AUDIO_BLOCK_SAMPLES; Index++) {
+        Block[Index] = (int16_t)(AudioSamples + Index);
+      }
+      AudioSamples += AUDIO_BLOCK_SAMPLES;
+      AudioSize += sizeof(Block);
+      status = fx_file_write(&AudioFile, Block, sizeof(Block));
+    }
+
+    if ((status == FX_SUCCESS) && (Sensors.Index != 0) && ((Time - Sensors.FirstTime) >= BATCH_DEADLINE)) {
+      status = Batch_Flush();
+    }
+
+    if ((status == FX_SUCCESS) && (Period != 0) && ((Time - LastCheckpoint) >= (Period * 1000U))) {
+      status = Checkpoint_Save(&Ckpt, AudioSize, Time);
+      LastCheckpoint = Time;
+      (*Checkpoints)++;
+    }
+  }
+
+  /* Nothing else is written (the power is lost): the RAM disk is opened
+     again with one new FX_MEDIA */
+  fx_media_abort(&Media);
+
+  return Time;
+}
+
+/**
+* @brief  Open the RAM disk after the power cut, repair the log and verify it
+* @param  Period: Seconds between two checkpoints (0 without checkpoints)
+* @param  Audio: Seconds of audio recovered
+* @param  Sensors: Seconds of sensors recovered
+* @retval 1 if the file system is consistent and the data are good, 0 otherwise
+*/
+static int Logger_Verify(uint32_t Period, double *Audio, double *SensorsTime)
+{
+  static FX_MEDIA Mounted;
+  static FX_FILE File;
+  LogCheckpoint_T Ckpt;
+  ULONG Errors = 0;
+  ULONG Actual = 0;
+  UINT status;
+  int Good = 1;
+
+  *Audio = 0;
+  *SensorsTime = 0;
+  PowerLost = 0;
+  CutAt = 0;
+
+  memset(&Mounted, 0, sizeof(Mounted));
+  status = fx_media_open(&Mounted, "POWERCUT", RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  if (status != FX_SUCCESS) {
+    return 0;
+  }
+
+  if (Period != 0) {
+    status = fx_fault_tolerant_enable(&Mounted, FaultTolerantMemory, sizeof(FaultTolerantMemory));
+    if (status == FX_SUCCESS) {
+      status = LogCheckpoint_Recover(&Mounted, &File, CHECKPOINT_FILE_NAME, &Ckpt, CheckpointRecords);
+    }
+    if (status != FX_SUCCESS) {
+      fx_media_close(&Mounted);
+      return 0;
+    }
+  }
+
+  /* Lost clusters, cross-linked files, wrong sizes... */
+  status = fx_media_check(&Mounted, CheckScratch, sizeof(CheckScratch), 0, &Errors);
+  if (ExFat) {
+    /* fx_media_check follows the FAT chains: the clusters of the exFAT files
+       without FAT chain (contiguous) are always reported as lost */
+    Errors &= ~(ULONG)FX_LOST_CLUSTER_ERROR;
+  }
+  if ((status != FX_SUCCESS) || (Errors != 0)) {
+    Good = 0;
+  }
+
+  /* Audio: after the header, sample n is n */
+  if (fx_file_open(&Mounted, &File, AUDIO_FILE_NAME, FX_OPEN_FOR_READ) == FX_SUCCESS) {
+    if ((fx_file_read(&File, FileBuffer, sizeof(FileBuffer), &Actual) == FX_SUCCESS) && (Actual >= WAV_HEADER_SIZE)) {
+      uint32_t DataSize;
+      uint32_t Samples = (Actual - WAV_HEADER_SIZE) / 2;
+      uint32_t Index;
+
+      memcpy(&DataSize, FileBuffer + WAV_HEADER_SIZE - 4, 4);
+      if ((memcmp(FileBuffer, "RIFF", 4) != 0) ||
+          ((Period != 0) && (DataSize != (Actual - WAV_HEADER_SIZE)))) {
+        Good = 0;
+      }
+      for (Index = 0; Index < Samples; Index++) {
+        int16_t Sample;
+        memcpy(&Sample, FileBuffer + WAV_HEADER_SIZE + Index * 2, 2);
+        if (Sample != (int16_t)Index) {
+          Good = 0;
+          break;
+        }
+      }
+      *Audio = (double)Index / AUDIO_FREQUENCY;
+    }
+    fx_file_close(&File);
+  }
+
+  /* Sensors: one line for each 10 mS with consecutive numbers */
+  if (fx_file_open(&Mounted, &File, SENSORS_FILE_NAME, FX_OPEN_FOR_READ) == FX_SUCCESS) {
+    if (fx_file_read(&File, FileBuffer, sizeof(FileBuffer) - 1, &Actual) == FX_SUCCESS) {
+      char *Text = (char *)FileBuffer;
+      char *End;
+      uint32_t Line = 0;
+
+      Text[Actual] = '\0';
+      while ((End = strstr(Text, "\r\n")) != NULL) {
+        unsigned Time, Number;
+        if ((sscanf(Text, "%u, %u,", &Time, &Number) != 2) || (Number != Line) || (Time != (Line + 1) * STEP_MS)) {
+          Good = 0;
+          break;
+        }
+        Line++;
+        Text = End + 2;
+      }
+      /* One partial line is accepted only without checkpoints */
+      if ((End == NULL) && (*Text != '\0') && (Period != 0)) {
+        Good = 0;
+      }
+      *SensorsTime = (double)Line * STEP_MS / 1000;
+    }
+    fx_file_close(&File);
+  }
+
+  fx_media_close(&Mounted);
+
+  return Good;
+}
+
+/**
+* @brief  Simple pseudo random generator (reproducible on all the hosts)
+* @param  None
+* @retval 31 bit random number
+*/
+static uint32_t Random(void)
+{
+  Seed = Seed * 1103515245U + 12345U;
+  return (Seed >> 1) & 0x7FFFFFFFU;
+}
+
+/**
+* @brief  Measure one checkpoint period: one log without power cut and Trials
+*         logs interrupted at one random sector write
+* @param  Period: Seconds between two checkpoints (0 for none)
+* @param  Trials: Number of power cuts
+* @param  Result: Results
+* @retval 0 if successful, -1 otherwise
+*/
+static int Period_Run(uint32_t Period, uint32_t Trials, Result_T *Result)
+{
+  uint32_t Trial;
+  uint32_t Checkpoints;
+  double Audio, SensorsTime, Recovered, Loss;
+  uint32_t Time;
+
+  memset(Result, 0, sizeof(Result_T));
+
+  if (RamDisk_Format() != FX_SUCCESS) {
+    return -1;
+  }
+  Logger_Run(Period, &Checkpoints);
+  Result->Writes = DiskWrites;
+  Result->Checkpoints = Checkpoints;
+
+  for (Trial = 0; Trial < Trials; Trial++) {
+    if (RamDisk_Format() != FX_SUCCESS) {
+      return -1;
+    }
+
+    CutAt = 1 + ((((uint64_t)Random() << 31) | Random()) % Result->Writes);
+    Time = Logger_Run(Period, &Checkpoints);
+
+    Result->Trials++;
+    if (!Logger_Verify(Period, &Audio, &SensorsTime)) {
+      Result->Failures++;
+      continue;
+    }
+
+    /* The log (both the streams) is complete up to the oldest data recovered */
+    Recovered = (Audio < SensorsTime) ? Audio : SensorsTime;
+    Loss = (double)Time / 1000 - Recovered;
+    if (Loss < 0) {
+      Loss = 0;
+    }
+    Result->LossSum += Loss;
+    if (Loss > Result->LossMax) {
+      Result->LossMax = Loss;
+    }
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Print the command usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-x] [-p] [-n trials] [-t seconds] [-s seed] [period...]\n", Name);
+  fprintf(stderr, "  -x  exFAT instead of FAT16\n");
+  fprintf(stderr, "  -p  clusters reserved in advance (STBOX1_SD_PREALLOCATION)\n");
+  fprintf(stderr, "  -n  power cuts for each period (default 200)\n");
+  fprintf(stderr, "  -t  log duration in seconds (default 30)\n");
+  fprintf(stderr, "  period: seconds between two checkpoints, 0 for the log without\n");
+  fprintf(stderr, "          checkpoints and fault tolerant module (default 0 1 2 5 10)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t Periods[16] = {0, 1, 2, 5, 10};
+  uint32_t PeriodsNumber = 5;
+  uint32_t Trials = 200;
+  uint64_t BaseWrites = 0;
+  Result_T Result;
+  uint32_t Index;
+  int Arg;
+
+  for (Arg = 1; (Arg < argc) && (argv[Arg][0] == '-'); Arg++) {
+    if (strcmp(argv[Arg], "-x") == 0) {
+      ExFat = 1;
+    } else if (strcmp(argv[Arg], "-p") == 0) {
+      Preallocation = 1;
+    } else if ((strcmp(argv[Arg], "-n") == 0) && (Arg + 1 < argc)) {
+      Trials = (uint32_t)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-t") == 0) && (Arg + 1 < argc)) {
+      Duration = (uint32_t)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 1 < argc)) {
+      Seed = (uint32_t)atoi(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (Arg < argc) {
+    for (PeriodsNumber = 0; (Arg < argc) && (PeriodsNumber < 16); Arg++) {
+      Periods[PeriodsNumber++] = (uint32_t)atoi(argv[Arg]);
+    }
+  }
+
+  if ((Trials == 0) || (Duration == 0) || ((WAV_HEADER_SIZE + Duration * AUDIO_FREQUENCY * 2ULL) > sizeof(FileBuffer))) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  Disk = malloc((size_t)DISK_SECTORS * DISK_SECTOR_SIZE);
+  if (Disk == NULL) {
+    fprintf(stderr, "Error allocating the RAM disk\n");
+    return 1;
+  }
+
+  fx_system_initialize();
+
+  printf("%s, %s, %u s log (96 KB/s audio + 100 Hz sensors), %u power cuts for each period\n",
+         ExFat ? "exFAT" : "FAT16", Preallocation ? "clusters reserved" : "no reservation",
+         (unsigned)Duration, (unsigned)Trials);
+  printf("Period  Failures  Loss avg  Loss max  Writes/ckpt  Overhead\n");
+
+  for (Index = 0; Index < PeriodsNumber; Index++) {
+    uint32_t Period = Periods[Index];
+
+    if (Period_Run(Period, Trials, &Result) != 0) {
+      fprintf(stderr, "Error formatting the RAM disk\n");
+      return 1;
+    }
+
+    if (Period == 0) {
+      BaseWrites = Result.Writes;
+      printf("  none");
+    } else {
+      printf("%4u s", (unsigned)Period);
+    }
+    printf("  %4u/%-4u %6.2f s  %6.2f s",
+           (unsigned)Result.Failures, (unsigned)Result.Trials,
+           (Result.Trials > Result.Failures) ? (Result.LossSum / (Result.Trials - Result.Failures)) : 0.0,
+           Result.LossMax);
+    if ((Period != 0) && (Result.Checkpoints != 0) && (BaseWrites != 0)) {
+      printf("  %11.1f  %7.2f %%",
+             ((double)Result.Writes - (double)BaseWrites) / Result.Checkpoints,
+             100.0 * ((double)Result.Writes - (double)BaseWrites) / (double)BaseWrites);
+    }
+    printf("\n");
+  }
+
+  free(Disk);
+
+  return 0;
+}
@@ -0,0 +1,470 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\preallocbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the preallocation of the log files
+  *          (STBOX1_SD_PREALLOCATION): the sensors and audio files of the
+  *          firmware are written interleaved with and without their clusters
+  *          reserved at the open, on one RAM disk of the FileX RAM driver
+  *          (_fx_ram_driver) with one SD card latency model, and the
+  *          fx_file_write latency percentiles are reported
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fx_api.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* RAM disk: 256 MB formatted with 32 KB clusters (the cluster size of the
+   cards), big enough for the preallocation of both files */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (512 * 1024)
+#define CLUSTER_SECTORS       64
+
+/* Same names, writes, media cache and preallocation sizes of the firmware:
+   one 16 KB sensors batch for each SENSORS_BATCH_BLOCKS audio blocks of
+   256 mS at 48 kHz */
+#define SENSORS_FILE_NAME     "Sens000.csv"
+#define AUDIO_FILE_NAME       "Mic000.wav"
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define AUDIO_BLOCK_SIZE      (24 * 1024)
+#define SENSORS_BATCH_BLOCKS  4
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define SENSORS_PREALLOCATION_SIZE (16ULL * 1024 * 1024)
+#define AUDIO_PREALLOCATION_SIZE   (64ULL * 1024 * 1024)
+
+/* Same latency histogram of the write batching stage (app_filex.c) */
+#define WRITE_BATCH_LATENCY_BINS   10
+#define WRITE_BATCH_LATENCY_LIMITS {500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000}
+
+#define MAX_WRITES            (256 * 1024)
+#define MAX_STREAMS           8
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Latency model of the SD card: each request costs one command overhead plus
+   the bus transfer, after each write the card is busy programming, more for
+   each write that doesn't continue one of the last Streams sequential writes
+   the card keeps open (the erase and the garbage collection of the card) */
+typedef struct
+{
+  double CommandTime;        /* uS for each request */
+  double BusRate;            /* MB/s on the bus */
+  double ProgramTime;        /* uS of card busy after each write */
+  double JumpTime;           /* uS more for each write not sequential */
+  int Streams;               /* Sequential writes kept open by the card */
+} Latency_T;
+
+/* Results of one log */
+typedef struct
+{
+  double OpenTime;           /* uS of the create, open and preallocation of the files */
+  double CloseTime;          /* uS of the release of the clusters not used and of the close */
+  double WriteTime;          /* uS of the writes */
+  ULONG Writes;
+  ULONG Requests;            /* Write requests to the card during the writes */
+  ULONG Jumps;               /* Write requests not sequential during the writes */
+  ULONG FatWrites;           /* FAT sectors written during the writes */
+  ULONG Latency[WRITE_BATCH_LATENCY_BINS];
+  ULONG Max;
+} Result_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk;
+static Latency_T Latency = {100.0, 25.0, 800.0, 1500.0, 2};
+static double Now;           /* uS of the simulation */
+static ULONG Requests;
+static ULONG Jumps;
+static ULONG NextSector[MAX_STREAMS]; /* Sector after the last writes (most recent first) */
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE SensorsFile;
+static FX_FILE AudioFile;
+
+static UCHAR SensorsBatch[WRITE_BATCH_SIZE];
+static UCHAR AudioBlock[AUDIO_BLOCK_SIZE];
+
+/* Latency of each write (uS) for the exact percentiles */
+static ULONG Samples[MAX_WRITES];
+
+extern VOID _fx_ram_driver(FX_MEDIA *media_ptr);
+
+static const ULONG Limits[WRITE_BATCH_LATENCY_BINS - 1] = WRITE_BATCH_LATENCY_LIMITS;
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  FileX RAM driver adding the time of the card model to the simulation
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID Bench_Driver(FX_MEDIA *media_ptr)
+{
+  ULONG Sector = (ULONG)media_ptr->fx_media_driver_logical_sector;
+  ULONG Count = media_ptr->fx_media_driver_sectors;
+  int Stream;
+
+  switch (media_ptr->fx_media_driver_request) {
+  case FX_DRIVER_READ:
+    Now += Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate;
+    break;
+  case FX_DRIVER_WRITE:
+    Now += Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate + Latency.ProgramTime;
+    for (Stream = 0; Stream < (Latency.Streams - 1); Stream++) {
+      if (NextSector[Stream] == Sector) {
+        break;
+      }
+    }
+    if (NextSector[Stream] != Sector) {
+      /* Not sequential: the least recent stream is closed */
+      Now += Latency.JumpTime;
+      Jumps++;
+    }
+    memmove(&NextSector[1], &NextSector[0], Stream * sizeof(NextSector[0]));
+    NextSector[0] = Sector + Count;
+    Requests++;
+    break;
+  case FX_DRIVER_RELEASE_SECTORS:
+    /* Not handled by the RAM driver: nothing to do */
+    media_ptr->fx_media_driver_status = FX_SUCCESS;
+    return;
+  default:
+    break;
+  }
+
+  /* The RAM disk is given by fx_media_open (fx_media_driver_info) */
+  _fx_ram_driver(media_ptr);
+}
+
+/**
+* @brief  Create and open one log file, then reserve its clusters as
+*         LogFile_Preallocate does (the biggest contiguous area if there is
+*         not one big enough)
+* @param  File: FileX file
+* @param  Name: File name
+* @param  Size: Bytes to reserve (0 for no preallocation)
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT LogFile_Open(FX_FILE *File, CHAR *Name, ULONG64 Size)
+{
+  ULONG64 Allocated;
+  UINT status;
+
+  status = fx_file_create(&Media, Name);
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, File, Name, FX_OPEN_FOR_WRITE);
+  }
+  if ((status == FX_SUCCESS) && (Size != 0)) {
+    status = fx_file_extended_allocate(File, Size);
+    if (status == FX_NO_MORE_SPACE) {
+      status = fx_file_extended_best_effort_allocate(File, Size, &Allocated);
+    }
+  }
+
+  return status;
+}
+
+/**
+* @brief  Release the clusters reserved and not used (LogFile_Release) and close one log file
+* @param  File: FileX file
+* @param  Preallocation: 1 if the clusters were reserved
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT LogFile_Close(FX_FILE *File, int Preallocation)
+{
+  UINT status = FX_SUCCESS;
+
+  if (Preallocation) {
+    status = fx_file_extended_truncate_release(File, File->fx_file_current_file_offset);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(File);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Write one buffer and update the latency histogram as WriteBatch_FileWrite
+* @param  File: FileX file
+* @param  Data: Pointer to the data
+* @param  Size: Number of bytes
+* @param  Result: Results of the log
+* @retval FX_SUCCESS or the fx_file_write error
+*/
+static UINT Log_Write(FX_FILE *File, UCHAR *Data, ULONG Size, Result_T *Result)
+{
+  double Start = Now;
+  ULONG WriteTime;
+  UINT status;
+  int Bin;
+
+  status = fx_file_write(File, Data, Size);
+
+  WriteTime = (ULONG)(Now - Start);
+  Result->WriteTime += Now - Start;
+  if (Result->Writes < MAX_WRITES) {
+    Samples[Result->Writes] = WriteTime;
+  }
+  Result->Writes++;
+  if (WriteTime > Result->Max) {
+    Result->Max = WriteTime;
+  }
+  for (Bin = 0; Bin < (WRITE_BATCH_LATENCY_BINS - 1); Bin++) {
+    if (WriteTime < Limits[Bin]) {
+      break;
+    }
+  }
+  Result->Latency[Bin]++;
+
+  return status;
+}
+
+/**
+* @brief  Percentile from the histogram as WriteBatch_Percentile
+* @param  Result: Results of the log
+* @param  Permille: Percentile (per thousand of the writes)
+* @retval Upper limit in uS of the bin with the percentile
+*/
+static ULONG Histogram_Percentile(Result_T *Result, ULONG Permille)
+{
+  uint64_t Target = ((uint64_t)Result->Writes * Permille + 999U) / 1000U;
+  uint64_t Count = 0;
+  int Bin;
+
+  for (Bin = 0; Bin < (WRITE_BATCH_LATENCY_BINS - 1); Bin++) {
+    Count += Result->Latency[Bin];
+    if (Count >= Target) {
+      return (Limits[Bin] < Result->Max) ? Limits[Bin] : Result->Max;
+    }
+  }
+
+  return Result->Max;
+}
+
+/**
+* @brief  Compare two latencies for qsort
+* @param  a: First latency
+* @param  b: Second latency
+* @retval <0, 0, >0
+*/
+static int Compare(const void *a, const void *b)
+{
+  ULONG x = *(const ULONG *)a;
+  ULONG y = *(const ULONG *)b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+* @brief  Exact percentile from the samples (sorted)
+* @param  Writes: Number of samples
+* @param  Permille: Percentile (per thousand of the writes)
+* @retval Latency in uS
+*/
+static ULONG Samples_Percentile(ULONG Writes, ULONG Permille)
+{
+  uint64_t Index = ((uint64_t)Writes * Permille + 999U) / 1000U;
+
+  if (Writes > MAX_WRITES) {
+    Writes = MAX_WRITES;
+  }
+  if (Index > Writes) {
+    Index = Writes;
+  }
+
+  return (Index == 0) ? 0 : Samples[Index - 1];
+}
+
+/**
+* @brief  Format the card and save one log of LogSize bytes
+* @param  LogSize: Bytes of audio and sensors
+* @param  Preallocation: 1 for reserving the clusters at the open
+* @param  Result: Results of the log
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Bench_Run(ULONG64 LogSize, int Preallocation, Result_T *Result)
+{
+  ULONG64 Written = 0;
+  ULONG Block = 0;
+  ULONG FatWrites;
+  ULONG StartRequests, StartJumps;
+  double Start;
+  UINT status;
+
+  memset(Result, 0, sizeof(Result_T));
+  Now = 0;
+  Requests = 0;
+  Jumps = 0;
+  memset(NextSector, 0, sizeof(NextSector));
+
+  status = fx_media_format(&Media, Bench_Driver, Disk, MediaMemory, sizeof(MediaMemory),
+                           "PREALLOC", 2, 512, 0, DISK_SECTORS, DISK_SECTOR_SIZE, CLUSTER_SECTORS, 1, 1);
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "PREALLOC", Bench_Driver, Disk, MediaMemory, sizeof(MediaMemory));
+  }
+
+  Start = Now;
+  if (status == FX_SUCCESS) {
+    status = LogFile_Open(&SensorsFile, SENSORS_FILE_NAME, Preallocation ? SENSORS_PREALLOCATION_SIZE : 0);
+  }
+  if (status == FX_SUCCESS) {
+    status = LogFile_Open(&AudioFile, AUDIO_FILE_NAME, Preallocation ? AUDIO_PREALLOCATION_SIZE : 0);
+  }
+  Result->OpenTime = Now - Start;
+
+  StartRequests = Requests;
+  StartJumps = Jumps;
+  FatWrites = Media.fx_media_fat_sector_writes;
+  while ((Written < LogSize) && (status == FX_SUCCESS)) {
+    status = Log_Write(&AudioFile, AudioBlock, AUDIO_BLOCK_SIZE, Result);
+    Written += AUDIO_BLOCK_SIZE;
+    Block++;
+    if ((status == FX_SUCCESS) && ((Block % SENSORS_BATCH_BLOCKS) == 0)) {
+      status = Log_Write(&SensorsFile, SensorsBatch, WRITE_BATCH_SIZE, Result);
+      Written += WRITE_BATCH_SIZE;
+    }
+  }
+  Result->Requests = Requests - StartRequests;
+  Result->Jumps = Jumps - StartJumps;
+  Result->FatWrites = Media.fx_media_fat_sector_writes - FatWrites;
+
+  Start = Now;
+  if (status == FX_SUCCESS) {
+    status = LogFile_Close(&SensorsFile, Preallocation);
+  }
+  if (status == FX_SUCCESS) {
+    status = LogFile_Close(&AudioFile, Preallocation);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+  Result->CloseTime = Now - Start;
+
+  return status;
+}
+
+int main(int argc, char **argv)
+{
+  ULONG64 LogSize = 48ULL * 1024 * 1024;
+  int Verbose = 0;
+  int Preallocation;
+  int Bin;
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if (strcmp(argv[Arg], "-v") == 0) {
+      Verbose = 1;
+    } else if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      LogSize = (ULONG64)(atof(argv[++Arg]) * 1024 * 1024);
+    } else if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc)) {
+      Latency.CommandTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Latency.BusRate = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      Latency.ProgramTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-j") == 0) && (Arg + 1 < argc)) {
+      Latency.JumpTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 1 < argc)) {
+      Latency.Streams = atoi(argv[++Arg]);
+    } else {
+      fprintf(stderr, "Usage: %s [-v] [-m MB] [-c uS] [-b MB/s] [-p uS] [-j uS] [-s streams]\n", argv[0]);
+      return 1;
+    }
+  }
+  if ((LogSize == 0) || (LogSize > SENSORS_PREALLOCATION_SIZE + AUDIO_PREALLOCATION_SIZE) || (Latency.BusRate <= 0) ||
+      (Latency.Streams < 1) || (Latency.Streams > MAX_STREAMS)) {
+    fprintf(stderr, "Log up to %llu MB, 1 to %d streams\n",
+            (SENSORS_PREALLOCATION_SIZE + AUDIO_PREALLOCATION_SIZE) / (1024 * 1024), MAX_STREAMS);
+    return 1;
+  }
+
+  Disk = calloc(DISK_SECTORS, DISK_SECTOR_SIZE);
+  if (Disk == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  fx_system_initialize();
+
+  printf("FAT16 256 MB RAM disk, 32 KB clusters, %.1f MB for each log (%u KB audio blocks, %u KB sensors batch every %u blocks)\n",
+         LogSize / (1024.0 * 1024.0), AUDIO_BLOCK_SIZE / 1024, WRITE_BATCH_SIZE / 1024, SENSORS_BATCH_BLOCKS);
+  printf("SD request %.0f uS + %.1f MB/s, busy %.0f uS after each write (+%.0f uS for each jump, %d streams)\n",
+         Latency.CommandTime, Latency.BusRate, Latency.ProgramTime, Latency.JumpTime, Latency.Streams);
+  printf("                  Open   Close | Writes Requests  Jumps FatWr |   Avg   P50   P90   P99 P99.9   Max\n");
+
+  for (Preallocation = 0; Preallocation <= 1; Preallocation++) {
+    static Result_T Result;
+    UINT status = Bench_Run(LogSize, Preallocation, &Result);
+    ULONG Writes = (Result.Writes < MAX_WRITES) ? Result.Writes : MAX_WRITES;
+
+    if (status != FX_SUCCESS) {
+      fprintf(stderr, "FileX error 0x%x\n", status);
+      free(Disk);
+      return 1;
+    }
+
+    qsort(Samples, Writes, sizeof(Samples[0]), Compare);
+
+    printf("%-12s %8.0f %7.0f | %6lu %8lu %6lu %5lu | %5.0f %5lu %5lu %5lu %5lu %5lu\n",
+           Preallocation ? "Prealloc" : "No prealloc", Result.OpenTime, Result.CloseTime,
+           (unsigned long)Result.Writes, (unsigned long)Result.Requests, (unsigned long)Result.Jumps,
+           (unsigned long)Result.FatWrites, Result.WriteTime / Result.Writes,
+           (unsigned long)Samples_Percentile(Result.Writes, 500), (unsigned long)Samples_Percentile(Result.Writes, 900),
+           (unsigned long)Samples_Percentile(Result.Writes, 990), (unsigned long)Samples_Percentile(Result.Writes, 999),
+           (unsigned long)Result.Max);
+    printf("%-12s %8s %7s | %6s %8s %6s %5s | %5s %5lu %5lu %5lu %5lu %5lu\n",
+           "  histogram", "", "", "", "", "", "", "",
+           (unsigned long)Histogram_Percentile(&Result, 500), (unsigned long)Histogram_Percentile(&Result, 900),
+           (unsigned long)Histogram_Percentile(&Result, 990), (unsigned long)Histogram_Percentile(&Result, 999),
+           (unsigned long)Result.Max);
+
+    if (Verbose) {
+      for (Bin = 0; Bin < WRITE_BATCH_LATENCY_BINS - 1; Bin++) {
+        printf("    < %6lu uS: %6lu\n", (unsigned long)Limits[Bin], (unsigned long)Result.Latency[Bin]);
+      }
+      printf("    >=%6lu uS: %6lu\n", (unsigned long)Limits[Bin - 1], (unsigned long)Result.Latency[Bin]);
+    }
+  }
+
+  free(Disk);
+
+  return 0;
+}
@@ -0,0 +1,359 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\profbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Check of the thread profiler of the firmware (STBOX1_THREAD_PROFILER)
+  *          on the ThreadX Linux port: threads with known CPU loads, sampled by
+  *          one simulated 1 KHz interrupt, are compared with the loads and the
+  *          stack high-water marks of its JSON reports
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "thread_profiler.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Same sampling rate (HAL tick) and report thread priority of the firmware */
+#define SAMPLE_RATE           1000
+#define PROFILER_THREAD_PRIO  15
+#define THREAD_STACK_SIZE     (4 * 1024)
+
+/* Bytes written on the ThreadX stack of the last worker (the threads of the
+   Linux port run on the stacks of the host threads) */
+#define STACK_DEPTH           1024
+
+/* Calls of ThreadProfiler_Sample for measuring its cost */
+#define COST_SAMPLES          10000000
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* One thread running Busy uS of CPU at each tick, then sleeping up to the next tick */
+typedef struct
+{
+  const char *Name;
+  UINT Priority;
+  ULONG Busy;                /* uS at each tick */
+  ULONG StackDepth;          /* Bytes written on the ThreadX stack */
+  double Load;               /* Sum of the loads reported */
+  unsigned long StackUsed;   /* Last high-water mark reported */
+} Worker_T;
+
+/* Private variables ---------------------------------------------------------*/
+
+/* ThreadX Linux port: simulated interrupts */
+extern VOID _tx_thread_context_save(VOID);
+extern VOID _tx_thread_context_restore(VOID);
+
+static Worker_T Workers[] = {
+  {"high", 10, 3000, 0, 0.0, 0},
+  {"middle", 12, 2000, 0, 0.0, 0},
+  {"low", 14, 1000, STACK_DEPTH, 0.0, 0},
+};
+#define WORKERS               (sizeof(Workers) / sizeof(Workers[0]))
+
+static TX_THREAD WorkerThread[WORKERS];
+static ULONG WorkerStack[WORKERS][THREAD_STACK_SIZE / sizeof(ULONG)];
+
+static ULONG ProfilerStack[THREAD_STACK_SIZE / sizeof(ULONG)];
+
+/* Counters of one message ring, reported as they are */
+static ULONG QueueMaxUsed = 7;
+static ULONG QueueOverflows = 1;
+#define QUEUE_STATUS          "{\"name\":\"Sensors\",\"size\":128,\"max_used\":7,\"overflows\":1}"
+
+/* Simulated timer interrupt of the HAL tick */
+static pthread_t SampleThread;
+static sem_t SampleStart;
+
+static int Reports = 6;
+static double Tolerance = 2.0;
+static int Received;
+static double Idle;
+static unsigned long Samples;
+static double Cost[3];
+
+/* Private function prototypes -----------------------------------------------*/
+static uint64_t CpuTimeUs(void);
+static double MeasureCost(TX_THREAD **Threads, ULONG Count);
+static void *Sample_Thread(void *Arg);
+static VOID Worker_Thread(ULONG Input);
+static VOID Report(const CHAR *Json);
+static int Check(const CHAR *Json);
+static void Usage(const char *Name);
+
+/**
+* @brief  CPU time of the host thread
+* @param  None
+* @retval uS
+*/
+static uint64_t CpuTimeUs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+}
+
+/**
+* @brief  Cost of ThreadProfiler_Sample with the threads given running one after
+*         the other (the counters are reset by the first report, not used)
+* @param  Threads: Threads running (TX_NULL for idle)
+* @param  Count: Threads
+* @retval nS for each sample
+*/
+static double MeasureCost(TX_THREAD **Threads, ULONG Count)
+{
+  struct timespec Start, End;
+  ULONG Index;
+
+  clock_gettime(CLOCK_MONOTONIC, &Start);
+  for (Index = 0; Index < COST_SAMPLES; Index++) {
+    _tx_thread_current_ptr = Threads[Index % Count];
+    ThreadProfiler_Sample();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &End);
+  _tx_thread_current_ptr = TX_NULL;
+
+  return (((double)(End.tv_sec - Start.tv_sec) * 1e9) + (double)(End.tv_nsec - Start.tv_nsec)) / COST_SAMPLES;
+}
+
+/**
+* @brief  Simulated HAL tick interrupt: one host thread that runs
+*         ThreadProfiler_Sample as one ThreadX interrupt at SAMPLE_RATE (the
+*         same way of the timer interrupt of the Linux port)
+* @param  Arg: Not used
+* @retval None
+*/
+static void *Sample_Thread(void *Arg)
+{
+  struct timespec ts;
+
+  (void)Arg;
+
+  while (sem_wait(&SampleStart) != 0) {
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  for (;;) {
+    ts.tv_nsec += 1000000000L / SAMPLE_RATE;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_nsec -= 1000000000L;
+      ts.tv_sec++;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+
+    _tx_thread_context_save();
+    ThreadProfiler_Sample();
+    _tx_thread_context_restore();
+  }
+
+  return NULL;
+}
+
+/**
+* @brief  Worker thread: Busy uS of CPU time at each tick
+* @param  Input: Index of the worker
+* @retval None
+*/
+static VOID Worker_Thread(ULONG Input)
+{
+  Worker_T *Worker = &Workers[Input];
+  uint64_t Start;
+
+  if (Worker->StackDepth != 0) {
+    memset((UCHAR *)WorkerThread[Input].tx_thread_stack_end + 1 - Worker->StackDepth, 0, Worker->StackDepth);
+  }
+
+  if (Input == 0) {
+    sem_post(&SampleStart);
+  }
+
+  for (;;) {
+    tx_thread_sleep(1);
+
+    Start = CpuTimeUs();
+    while ((CpuTimeUs() - Start) < Worker->Busy) {
+    }
+  }
+}
+
+/**
+* @brief  Report callback of the profiler: the first report (with the samples of
+*         the cost measure) is not used
+* @param  Json: JSON status
+* @retval None
+*/
+static VOID Report(const CHAR *Json)
+{
+  unsigned int Index;
+  int Failed;
+
+  Received++;
+  if ((Received > 1) && (Check(Json) != 0)) {
+    fprintf(stderr, "Wrong report: %s\n", Json);
+    exit(1);
+  }
+
+  if (Received < Reports) {
+    return;
+  }
+
+  Failed = 0;
+  printf("%d reports of 1 S, %lu samples (last), sample cost: idle %.1f nS, same thread %.1f nS, 4 threads %.1f nS\n",
+         Reports - 1, Samples, Cost[0], Cost[1], Cost[2]);
+  printf("Thread   Expected %%  Load %%  Error  Stack used\n");
+  for (Index = 0; Index < WORKERS; Index++) {
+    Worker_T *Worker = &Workers[Index];
+    double Expected = (100.0 * (double)Worker->Busy * TX_TIMER_TICKS_PER_SECOND) / 1000000.0;
+    double Load = Worker->Load / (Reports - 1);
+
+    printf("%-8s  %9.1f  %6.1f  %5.1f  %10lu\n", Worker->Name, Expected, Load, Load - Expected, Worker->StackUsed);
+    if ((Load - Expected > Tolerance) || (Expected - Load > Tolerance)) {
+      Failed = 1;
+    }
+    if ((Worker->StackDepth != 0) && (Worker->StackUsed != Worker->StackDepth)) {
+      Failed = 1;
+    }
+  }
+  printf("%-8s  %9s  %6.1f\n", "idle", "", Idle / (Reports - 1));
+  printf("Last report: %s\n", Json);
+
+  exit(Failed);
+}
+
+/**
+* @brief  Read the loads and the stacks of the workers from one report
+* @param  Json: JSON status
+* @retval 0 or 1 if one worker or the queue is not found
+*/
+static int Check(const CHAR *Json)
+{
+  char Name[64];
+  const char *Thread;
+  double Load;
+  unsigned long StackUsed;
+  unsigned int Index;
+
+  if ((sscanf(Json, "{\"performance\":{\"samples\":%lu,\"idle\":%lf", &Samples, &Load) != 2)) {
+    return 1;
+  }
+  Idle += Load;
+
+  if (strstr(Json, QUEUE_STATUS) == NULL) {
+    return 1;
+  }
+
+  for (Index = 0; Index < WORKERS; Index++) {
+    snprintf(Name, sizeof(Name), "{\"name\":\"%s\"", Workers[Index].Name);
+    Thread = strstr(Json, Name);
+    if ((Thread == NULL) ||
+        (sscanf(Thread + strlen(Name), ",\"priority\":%*u,\"load\":%lf,\"stack_used\":%lu", &Load, &StackUsed) != 2)) {
+      return 1;
+    }
+    Workers[Index].Load += Load;
+    Workers[Index].StackUsed = StackUsed;
+  }
+
+  return 0;
+}
+
+/**
+* @brief  ThreadX application define: the workers and the profiler
+* @param  first_unused_memory: Not used
+* @retval None
+*/
+VOID tx_application_define(VOID *first_unused_memory)
+{
+  TX_THREAD *Threads[4] = {TX_NULL};
+  unsigned int Index;
+
+  (void)first_unused_memory;
+
+  for (Index = 0; Index < WORKERS; Index++) {
+    tx_thread_create(&WorkerThread[Index], (CHAR *)Workers[Index].Name, Worker_Thread, Index,
+                     WorkerStack[Index], sizeof(WorkerStack[Index]),
+                     Workers[Index].Priority, Workers[Index].Priority, TX_NO_TIME_SLICE, TX_AUTO_START);
+  }
+
+  if ((ThreadProfiler_AddQueue("Sensors", 128, &QueueMaxUsed, &QueueOverflows) != TX_SUCCESS) ||
+      (ThreadProfiler_Init(Report, TX_TIMER_TICKS_PER_SECOND, PROFILER_THREAD_PRIO,
+                           ProfilerStack, sizeof(ProfilerStack)) != TX_SUCCESS)) {
+    fprintf(stderr, "Error creating the profiler\n");
+    exit(1);
+  }
+
+  /* Cost of one sample: idle, one thread running and 4 threads running one after the other */
+  Cost[0] = MeasureCost(Threads, 1);
+  Threads[0] = &WorkerThread[0];
+  Cost[1] = MeasureCost(Threads, 1);
+  Threads[1] = &WorkerThread[1];
+  Threads[2] = &WorkerThread[2];
+  Threads[3] = _tx_thread_created_ptr;
+  Cost[2] = MeasureCost(Threads, 4);
+
+  /* The simulated interrupt is started by the first worker, with the scheduler running */
+  sem_init(&SampleStart, 0, 0);
+  pthread_create(&SampleThread, NULL, Sample_Thread, NULL);
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-r reports] [-t tolerance]\n", Name);
+  fprintf(stderr, "  -r  reports of 1 S checked, after the first one (default 5)\n");
+  fprintf(stderr, "  -t  max error of the loads (default 2.0 %%)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-r") == 0) && (Arg + 1 < argc)) {
+      Reports = atoi(argv[++Arg]) + 1;
+    } else if ((strcmp(argv[Arg], "-t") == 0) && (Arg + 1 < argc)) {
+      Tolerance = atof(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (Reports < 2) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  tx_kernel_enter();
+
+  return 0;
+}
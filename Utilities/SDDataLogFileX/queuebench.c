@@ -0,0 +1,707 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\queuebench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the SD driver write queue (STBOX1_SD_WRITE_QUEUE):
+  *          one log written by FileX on one simulated SD card with one latency
+  *          model, with the synchronous driver and with the queued driver
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fx_api.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated SD card: 4 GB (SDHC), FAT32 with 32 KB clusters or exFAT with
+   128 KB clusters. The memory is allocated only for the parts written */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (8 * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_CHUNKS           (DISK_SECTORS / DISK_CHUNK_SECTORS)
+
+/* Same write batching stage, media cache and queue slots of the firmware */
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define QUEUE_SLOT_SIZE       (16 * 1024)
+#define QUEUE_MAX_SLOTS       16
+#define LOG_FILE_NAME         "Log000.stb"
+
+#define MAX_RATES             8
+#define STRESS_STEPS          1000000
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Latency model of the SD card: each request costs one command overhead plus
+   the bus transfer (the DMA transfer on the board), then after each write the
+   card is busy programming, for longer when the write doesn't follow the
+   previous one (the card leaves its open allocation unit) and periodically
+   for much longer (the internal garbage collection) */
+typedef struct
+{
+  double CommandTime;        /* uS for each request */
+  double BusRate;            /* MB/s on the bus */
+  double ProgramTime;        /* uS of card busy after each write */
+  double JumpTime;           /* uS of card busy more for each write not sequential */
+  double SpikeTime;          /* uS of card busy more every SpikeWrites writes (garbage collection) */
+  ULONG SpikeWrites;
+  double CopyRate;           /* MB/s of the CPU copy on one queue slot */
+} Latency_T;
+
+/* One slot of the queue */
+typedef struct
+{
+  ULONG Sector;
+  ULONG Sectors;
+  double QueueTime;          /* Time when it was queued */
+} Slot_T;
+
+/* State of the simulation: the time of the FileX Writing thread, the card
+   and the queue (Slots = 0 for the synchronous driver) */
+typedef struct
+{
+  double Now;                /* uS of the writing thread */
+  double CardReady;          /* End of the card busy */
+  double DmaEnd;             /* End of the DMA transfer of the oldest slot */
+  double WaitTime;           /* uS of the writing thread waiting the card */
+  double StallSum;           /* uS of the writing thread waiting in fx_file_write */
+  double StallMax;
+  ULONG NextSector;
+  ULONG CardWrites;
+  int Slots;
+  Slot_T Slot[QUEUE_MAX_SLOTS];
+  int Head;
+  int Count;
+  int Tail;
+  int Busy;                  /* DMA transfer of the oldest slot started */
+  uint64_t Writes;
+  uint64_t Transfers;
+  uint64_t FullWaits;
+  uint64_t Drains;
+} Sim_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk[DISK_CHUNKS];
+static Latency_T Latency = {100.0, 25.0, 800.0, 1500.0, 20000.0, 256, 200.0};
+static Sim_T Sim;
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+
+static UCHAR Batch[WRITE_BATCH_SIZE];
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated card
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Buffer: Data
+* @param  Write: 1 for writing the card
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Buffer, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Data;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Buffer, 0, DISK_SECTOR_SIZE);
+    } else {
+      Data = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Data, Buffer, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Buffer, Data, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Buffer += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Free the simulated card
+* @param  None
+* @retval None
+*/
+static void Disk_Free(void)
+{
+  ULONG Chunk;
+
+  for (Chunk = 0; Chunk < DISK_CHUNKS; Chunk++) {
+    free(Disk[Chunk]);
+    Disk[Chunk] = NULL;
+  }
+}
+
+/**
+* @brief  Start one transfer on the card (the card must be ready)
+* @param  Start: Time of the command
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Write: 1 for one write request
+* @retval End of the DMA transfer
+*/
+static double Card_Transfer(double Start, ULONG Sector, ULONG Count, int Write)
+{
+  double End = Start + Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate;
+
+  Sim.CardReady = End;
+  if (Write) {
+    Sim.CardReady += Latency.ProgramTime;
+    if (Sector != Sim.NextSector) {
+      Sim.CardReady += Latency.JumpTime;
+    }
+    Sim.NextSector = Sector + Count;
+    if ((Latency.SpikeWrites != 0) && ((++Sim.CardWrites % Latency.SpikeWrites) == 0)) {
+      Sim.CardReady += Latency.SpikeTime;
+    }
+  }
+
+  return End;
+}
+
+/**
+* @brief  Request of the synchronous driver: the writing thread waits for the
+*         card ready (check_sd_status) and for the end of the DMA transfer
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Write: 1 for one write request
+* @retval None
+*/
+static void Sync_Request(ULONG Sector, ULONG Count, int Write)
+{
+  double Start = (Sim.CardReady > Sim.Now) ? Sim.CardReady : Sim.Now;
+  double End = Card_Transfer(Start, Sector, Count, Write);
+
+  Sim.WaitTime += End - Sim.Now;
+  Sim.Now = End;
+}
+
+/**
+* @brief  Same steps of queue_pump (fx_stm32_sd_driver_glue.c) at the time Sim.Now:
+*         the oldest slot is released if its DMA transfer is completed and the
+*         next one is started if the card is ready
+* @param  Wait: 1 for waiting the DMA transfer and the card (the writing thread
+*         waits and the queue thread runs), 0 for only checking them
+* @retval None
+*/
+static void Queue_Pump(int Wait)
+{
+  Slot_T *Slot;
+
+  if (Sim.Busy) {
+    if (Sim.DmaEnd > Sim.Now) {
+      if (!Wait) {
+        return;
+      }
+      Sim.WaitTime += Sim.DmaEnd - Sim.Now;
+      Sim.Now = Sim.DmaEnd;
+    }
+
+    Sim.Busy = 0;
+    Sim.Head = (Sim.Head + 1) % Sim.Slots;
+    Sim.Count--;
+
+    /* The writing thread (higher priority) runs again as soon as one slot is free */
+    if (Wait) {
+      return;
+    }
+  }
+
+  if (Sim.Count == 0) {
+    return;
+  }
+
+  if (Sim.CardReady > Sim.Now) {
+    if (!Wait) {
+      return;
+    }
+    Sim.WaitTime += Sim.CardReady - Sim.Now;
+    Sim.Now = Sim.CardReady;
+  }
+
+  Slot = &Sim.Slot[Sim.Head];
+  Sim.DmaEnd = Card_Transfer(Sim.Now, Slot->Sector, Slot->Sectors, 1);
+  Sim.Busy = 1;
+  Sim.Transfers++;
+}
+
+/**
+* @brief  Write request of the queued driver (fx_stm32_sd_queue_write)
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @retval None
+*/
+static void Queue_Write(ULONG Sector, ULONG Count)
+{
+  while (Count > 0) {
+    ULONG Sectors = (Count < QUEUE_SLOT_SIZE / DISK_SECTOR_SIZE) ? Count : QUEUE_SLOT_SIZE / DISK_SECTOR_SIZE;
+    Slot_T *Slot;
+
+    /* No free slot: the queue thread writes the oldest ones */
+    if (Sim.Count == Sim.Slots) {
+      Sim.FullWaits++;
+      while (Sim.Count == Sim.Slots) {
+        Queue_Pump(1);
+      }
+    }
+
+    /* The copy on the slot */
+    Sim.Now += (Sectors * DISK_SECTOR_SIZE) / Latency.CopyRate;
+
+    Slot = &Sim.Slot[Sim.Tail];
+    Sim.Tail = (Sim.Tail + 1) % Sim.Slots;
+    Slot->Sector = Sector;
+    Slot->Sectors = Sectors;
+    Slot->QueueTime = Sim.Now;
+    Sim.Count++;
+
+    /* Start it now if the card is ready, otherwise the queue thread does it */
+    Queue_Pump(0);
+
+    Sector += Sectors;
+    Count -= Sectors;
+  }
+}
+
+/**
+* @brief  The other requests of the queued driver wait for the queued writes
+*         (fx_stm32_sd_queue_drain)
+* @param  None
+* @retval None
+*/
+static void Queue_Drain(void)
+{
+  if (Sim.Count != 0) {
+    Sim.Drains++;
+    while (Sim.Count != 0) {
+      Queue_Pump(1);
+    }
+  }
+}
+
+/**
+* @brief  Stress of the slot bookkeeping of the queued driver: the writing
+*         thread (fx_stm32_sd_queue_write) and the queue thread (queue_pump and
+*         queue_release) are split in their steps between two critical
+*         sections, and at each step one of them runs at random, so every
+*         preemption order is tried (the queue thread has lower priority than
+*         the writing thread, or higher with STBOX1_SD_CARD_EVENTS). Each write
+*         must reach the card once, in order, and no queued slot can be filled
+*         again before its release
+* @param  Slots: Slots of the queue
+* @param  Steps: Steps to run
+* @retval Number of errors
+*/
+static unsigned long Queue_Stress(int Slots, unsigned long Steps)
+{
+  ULONG Sector[QUEUE_MAX_SLOTS];
+  int Pending[QUEUE_MAX_SLOTS];
+  int Head = 0;
+  int Count = 0;
+  int Tail = 0;
+  int Busy = 0;
+  int Free = Slots;          /* queue_free_semaphore */
+  int Writer = 0;            /* Next step of the writing thread */
+  int Reader = 0;            /* Next step of the queue thread */
+  int Slot = 0;
+  ULONG Written = 0;
+  ULONG Expected = 0;
+  unsigned long Errors = 0;
+  unsigned long Step;
+
+  memset(Pending, 0, sizeof(Pending));
+  srand(1);
+
+  for (Step = 0; Step < Steps; Step++) {
+    if (rand() & 1) {
+      switch (Writer) {
+        case 0:
+          /* tx_semaphore_get of one free slot */
+          if (Free > 0) {
+            Free--;
+            Writer = 1;
+          }
+          break;
+        case 1:
+          /* The free slot is taken from the tail and filled */
+          Slot = Tail;
+          Tail = (Tail + 1) % Slots;
+          if (Pending[Slot]) {
+            Errors++;
+          }
+          Pending[Slot] = 1;
+          Sector[Slot] = Written++;
+          Writer = 2;
+          break;
+        default:
+          /* TX_DISABLE: the slot is queued */
+          Count++;
+          Writer = 0;
+          break;
+      }
+    } else {
+      switch (Reader) {
+        case 0:
+          /* The DMA transfer of the oldest slot starts */
+          if (!Busy && (Count != 0)) {
+            if (!Pending[Head] || (Sector[Head] != Expected)) {
+              Errors++;
+            }
+            Expected++;
+            Busy = 1;
+            Reader = 1;
+          }
+          break;
+        case 1:
+          /* TX_DISABLE: queue_release at the end of the transfer */
+          Pending[Head] = 0;
+          Busy = 0;
+          Head = (Head + 1) % Slots;
+          Count--;
+          Reader = 2;
+          break;
+        default:
+          /* tx_semaphore_put of the free slot */
+          Free++;
+          Reader = 0;
+          break;
+      }
+    }
+  }
+
+  return Errors;
+}
+
+/**
+* @brief  Simulated SD card driver: the data are copied at once, the time
+*         follows the synchronous or the queued driver
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID SimDisk_Driver(FX_MEDIA *media_ptr)
+{
+  ULONG Sector = (ULONG)media_ptr->fx_media_driver_logical_sector;
+  ULONG Count = media_ptr->fx_media_driver_sectors;
+  UINT Request = media_ptr->fx_media_driver_request;
+
+  media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+  if (Request == FX_DRIVER_BOOT_READ) {
+    Request = FX_DRIVER_READ;
+    Sector = 0;
+    Count = 1;
+  } else if (Request == FX_DRIVER_BOOT_WRITE) {
+    Request = FX_DRIVER_WRITE;
+    Sector = 0;
+    Count = 1;
+  }
+
+  if ((Sim.Slots != 0) && (Request == FX_DRIVER_WRITE) && (media_ptr->fx_media_driver_system_write == FX_FALSE)) {
+    Disk_Copy(Sector, Count, media_ptr->fx_media_driver_buffer, 1);
+    Queue_Write(Sector, Count);
+    return;
+  }
+
+  if (Sim.Slots != 0) {
+    Queue_Drain();
+  }
+
+  switch (Request) {
+  case FX_DRIVER_READ:
+    Disk_Copy(Sector, Count, media_ptr->fx_media_driver_buffer, 0);
+    Sync_Request(Sector, Count, 0);
+    break;
+  case FX_DRIVER_WRITE:
+    Disk_Copy(Sector, Count, media_ptr->fx_media_driver_buffer, 1);
+    Sync_Request(Sector, Count, 1);
+    break;
+  default:
+    /* Init, flush, abort, release sectors and uninit: nothing to do */
+    break;
+  }
+}
+
+/**
+* @brief  Format the simulated card and open it (the previous log closed it)
+* @param  ExFat: 1 for exFAT, 0 for FAT32
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT SimDisk_Open(int ExFat)
+{
+  UINT status;
+
+  Disk_Free();
+
+  if (ExFat) {
+    status = fx_media_exFAT_format(&Media, SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                                   "QUEBENCH", 1, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 256, 12345, 0);
+  } else {
+    status = fx_media_format(&Media, SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                             "QUEBENCH", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 64, 1, 1);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "QUEBENCH", SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  }
+
+  return status;
+}
+
+/**
+* @brief  The writing thread waits for the next data: the queue thread writes
+*         the queued slots meanwhile
+* @param  Until: Time of the next data
+* @retval None
+*/
+static void Queue_Idle(double Until)
+{
+  while ((Sim.Slots != 0) && (Sim.Count != 0)) {
+    double Next = Sim.Busy ? Sim.DmaEnd : Sim.CardReady;
+
+    if (Next < Sim.Now) {
+      Next = Sim.Now;
+    }
+    if (Next > Until) {
+      break;
+    }
+
+    Sim.Now = Next;
+    Queue_Pump(0);
+  }
+
+  if (Until > Sim.Now) {
+    Sim.Now = Until;
+  }
+}
+
+/**
+* @brief  One log as the firmware saves it: one new file written with
+*         WRITE_BATCH_SIZE bytes for each fx_file_write. The data arrive at
+*         Rate MB/s and the writing thread works CpuTime uS on each batch
+*         (data formatting or compression) before writing it
+* @param  ExFat: 1 for exFAT, 0 for FAT32
+* @param  Slots: Slots of the queue (0 for the synchronous driver)
+* @param  Size: Bytes to write
+* @param  Rate: MB/s of the data (0 for data always ready)
+* @param  CpuTime: uS of the writing thread for each batch
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT QueueLog(int ExFat, int Slots, ULONG64 Size, double Rate, double CpuTime)
+{
+  ULONG64 Written;
+  double Wait;
+  UINT status;
+
+  status = SimDisk_Open(ExFat);
+
+  memset(&Sim, 0, sizeof(Sim));
+  Sim.Slots = Slots;
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_create(&Media, LOG_FILE_NAME);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+  Sim.Now = 0;
+  Sim.WaitTime = 0;
+
+  for (Written = 0; (Written < Size) && (status == FX_SUCCESS); Written += WRITE_BATCH_SIZE) {
+    if (Rate > 0) {
+      Queue_Idle((Written + WRITE_BATCH_SIZE) / Rate);
+    }
+    Sim.Now += CpuTime;
+
+    Wait = Sim.WaitTime;
+    status = fx_file_write(&File, Batch, WRITE_BATCH_SIZE);
+    Wait = Sim.WaitTime - Wait;
+
+    Sim.Writes++;
+    Sim.StallSum += Wait;
+    if (Wait > Sim.StallMax) {
+      Sim.StallMax = Wait;
+    }
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+
+  /* The media is closed when the log is stopped */
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-x] [-m MB] [-a uS] [-c uS] [-b MB/s] [-p uS] [-j uS] [-s uS writes] [-r MB/s] [rate...]\n", Name);
+  fprintf(stderr, "  -x  exFAT (default FAT32)\n");
+  fprintf(stderr, "  -m  size of each log (default 32 MB)\n");
+  fprintf(stderr, "  -a  time of the writing thread on each 16 KB batch (default 300 uS)\n");
+  fprintf(stderr, "  -c  command overhead of each SD request (default 100 uS)\n");
+  fprintf(stderr, "  -b  SD bus rate (default 25 MB/s)\n");
+  fprintf(stderr, "  -p  card busy after each write (default 800 uS)\n");
+  fprintf(stderr, "  -j  card busy more for each write not sequential (default 1500 uS)\n");
+  fprintf(stderr, "  -s  card busy more every some writes (default 20000 uS every 256 writes, 0 0 for none)\n");
+  fprintf(stderr, "  -r  CPU copy rate on the queue slots (default 200 MB/s)\n");
+  fprintf(stderr, "  rate: MB/s of the log data, 0 for data always ready (default 1 4 6 0)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  static const int Slots[4] = {0, 2, 4, 8};
+  double Rates[MAX_RATES] = {1.0, 4.0, 6.0, 0.0};
+  int RateCount = 4;
+  double CpuTime = 300.0;
+  ULONG64 Size = 32ULL * 1024 * 1024;
+  int ExFat = 0;
+  int Index;
+  int Test;
+  int Arg;
+
+  for (Arg = 1; (Arg < argc) && (argv[Arg][0] == '-'); Arg++) {
+    if (strcmp(argv[Arg], "-x") == 0) {
+      ExFat = 1;
+    } else if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      Size = (ULONG64)atoi(argv[++Arg]) * 1024 * 1024;
+    } else if ((strcmp(argv[Arg], "-a") == 0) && (Arg + 1 < argc)) {
+      CpuTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc)) {
+      Latency.CommandTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Latency.BusRate = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      Latency.ProgramTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-j") == 0) && (Arg + 1 < argc)) {
+      Latency.JumpTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 2 < argc)) {
+      Latency.SpikeTime = atof(argv[++Arg]);
+      Latency.SpikeWrites = (ULONG)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-r") == 0) && (Arg + 1 < argc)) {
+      Latency.CopyRate = atof(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (Arg < argc) {
+    for (RateCount = 0; (Arg < argc) && (RateCount < MAX_RATES); Arg++) {
+      Rates[RateCount++] = atof(argv[Arg]);
+    }
+  }
+
+  if ((Size == 0) || (Size > 1024ULL * 1024 * 1024) || (Latency.BusRate <= 0) || (Latency.CopyRate <= 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  for (Test = 1; Test < 4; Test++) {
+    unsigned long Errors = Queue_Stress(Slots[Test], STRESS_STEPS);
+
+    if (Errors != 0) {
+      fprintf(stderr, "Error: %lu slot errors with %d slots\n", Errors, Slots[Test]);
+      return 1;
+    }
+  }
+
+  memset(Batch, 0x5A, sizeof(Batch));
+
+  fx_system_initialize();
+
+  printf("%s, %u MB for each log, %.0f uS of CPU for each 16 KB write\n",
+         ExFat ? "exFAT" : "FAT32", (unsigned)(Size / (1024 * 1024)), CpuTime);
+  printf("SD request %.0f uS + %.1f MB/s, busy %.0f uS (+%.0f uS for each jump, +%.0f uS every %lu writes)\n",
+         Latency.CommandTime, Latency.BusRate, Latency.ProgramTime, Latency.JumpTime, Latency.SpikeTime,
+         (unsigned long)Latency.SpikeWrites);
+  printf("Copy on the queue slots %.0f MB/s\n", Latency.CopyRate);
+  printf("Slots of the queue: %d random steps of the two threads with 2, 4 and 8 slots, no errors\n", STRESS_STEPS);
+  printf("  Rate  Driver        MB/s  Wait %%  Stall avg  Stall max    Full  Drains\n");
+
+  for (Index = 0; Index < RateCount; Index++) {
+    for (Test = 0; Test < 4; Test++) {
+      char Name[32];
+
+      if (QueueLog(ExFat, Slots[Test], Size, Rates[Index], CpuTime) != FX_SUCCESS) {
+        fprintf(stderr, "Error with %d slots\n", Slots[Test]);
+        return 1;
+      }
+
+      if (Slots[Test] == 0) {
+        snprintf(Name, sizeof(Name), "synchronous");
+      } else {
+        snprintf(Name, sizeof(Name), "queue %d", Slots[Test]);
+      }
+
+      if (Rates[Index] > 0) {
+        printf("%6.1f", Rates[Index]);
+      } else {
+        printf("   max");
+      }
+      printf("  %-12s %6.2f  %6.1f  %9.0f  %9.0f  %6llu  %6llu\n", Name, Size / Sim.Now,
+             (100.0 * Sim.WaitTime) / Sim.Now, Sim.StallSum / Sim.Writes, Sim.StallMax,
+             (unsigned long long)Sim.FullWaits, (unsigned long long)Sim.Drains);
+    }
+  }
+
+  Disk_Free();
+
+  return 0;
+}
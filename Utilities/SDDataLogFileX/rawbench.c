@@ -0,0 +1,435 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\rawbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the sustained SD write throughput of the
+  *          SDDataLogFileX log: FileX file writes (FAT32/exFAT, with and
+  *          without preallocation) against the raw log area (log_raw.c),
+  *          on one simulated SD card with a simple latency model
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fx_api.h"
+#include "log_raw.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated SD card: 4 GB (SDHC), FAT32 with 32 KB clusters or exFAT with
+   128 KB clusters. The memory is allocated only for the parts written */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (8 * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_CHUNKS           (DISK_SECTORS / DISK_CHUNK_SECTORS)
+
+/* Same write batching stage and media cache of the firmware */
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define LOG_FILE_NAME         "Log000.stb"
+#define RAW_LOG_FILE_NAME     "RawLog.bin"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Latency model of the SD card: each request costs one fixed overhead (command,
+   busy and stop) plus the bus transfer, and one write that doesn't follow the
+   previous one costs one more penalty (the card leaves its open allocation unit) */
+typedef struct
+{
+  double CommandTime;        /* uS for each request */
+  double BusRate;            /* MB/s on the bus */
+  double JumpTime;           /* uS for each write not sequential */
+} Latency_T;
+
+/* Cost of one log */
+typedef struct
+{
+  double Time;               /* Simulated uS */
+  uint64_t Requests;         /* Write requests */
+  uint64_t Jumps;            /* Write requests not sequential */
+  uint64_t Sectors;          /* Sectors written */
+} Cost_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk[DISK_CHUNKS];
+static Latency_T Latency = {250.0, 25.0, 1500.0};
+static Cost_T Cost;
+static ULONG NextSector;
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+static LogRaw_T RawLog;
+
+static UCHAR Batch[WRITE_BATCH_SIZE];
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated card
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Buffer: Data
+* @param  Write: 1 for writing the card
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Buffer, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Data;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Buffer, 0, DISK_SECTOR_SIZE);
+    } else {
+      Data = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Data, Buffer, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Buffer, Data, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Buffer += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Free the simulated card
+* @param  None
+* @retval None
+*/
+static void Disk_Free(void)
+{
+  ULONG Chunk;
+
+  for (Chunk = 0; Chunk < DISK_CHUNKS; Chunk++) {
+    free(Disk[Chunk]);
+    Disk[Chunk] = NULL;
+  }
+}
+
+/**
+* @brief  Add the simulated time of one request
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Write: 1 for one write request
+* @retval None
+*/
+static void Disk_Time(ULONG Sector, ULONG Count, int Write)
+{
+  Cost.Time += Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate;
+
+  if (Write) {
+    Cost.Requests++;
+    Cost.Sectors += Count;
+    if (Sector != NextSector) {
+      Cost.Jumps++;
+      Cost.Time += Latency.JumpTime;
+    }
+    NextSector = Sector + Count;
+  }
+}
+
+/**
+* @brief  Simulated SD card driver
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID SimDisk_Driver(FX_MEDIA *media_ptr)
+{
+  ULONG Sector = (ULONG)media_ptr->fx_media_driver_logical_sector;
+  ULONG Count = media_ptr->fx_media_driver_sectors;
+
+  media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+  switch (media_ptr->fx_media_driver_request) {
+  case FX_DRIVER_READ:
+    Disk_Copy(Sector, Count, media_ptr->fx_media_driver_buffer, 0);
+    Disk_Time(Sector, Count, 0);
+    break;
+  case FX_DRIVER_WRITE:
+    Disk_Copy(Sector, Count, media_ptr->fx_media_driver_buffer, 1);
+    Disk_Time(Sector, Count, 1);
+    break;
+  case FX_DRIVER_BOOT_READ:
+    Disk_Copy(0, 1, media_ptr->fx_media_driver_buffer, 0);
+    Disk_Time(0, 1, 0);
+    break;
+  case FX_DRIVER_BOOT_WRITE:
+    Disk_Copy(0, 1, media_ptr->fx_media_driver_buffer, 1);
+    Disk_Time(0, 1, 1);
+    break;
+  default:
+    /* Init, flush, abort, release sectors and uninit: nothing to do */
+    break;
+  }
+}
+
+/**
+* @brief  Format the simulated card and open it (the previous log closed it)
+* @param  ExFat: 1 for exFAT, 0 for FAT32
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT SimDisk_Open(int ExFat)
+{
+  UINT status;
+
+  Disk_Free();
+
+  if (ExFat) {
+    status = fx_media_exFAT_format(&Media, SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                                   "RAWBENCH", 1, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 256, 12345, 0);
+  } else {
+    status = fx_media_format(&Media, SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                             "RAWBENCH", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 64, 1, 1);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "RAWBENCH", SimDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  }
+
+  return status;
+}
+
+/**
+* @brief  Start counting the cost of one log
+* @param  None
+* @retval None
+*/
+static void Cost_Start(void)
+{
+  memset(&Cost, 0, sizeof(Cost));
+  NextSector = 0;
+}
+
+/**
+* @brief  One log as the firmware saves it: one new file written with
+*         WRITE_BATCH_SIZE bytes for each fx_file_write
+* @param  Size: Bytes to write
+* @param  Preallocation: 1 for reserving all the clusters when the file is opened
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT FileLog(ULONG64 Size, int Preallocation)
+{
+  ULONG64 Written;
+  UINT status;
+
+  Cost_Start();
+
+  status = fx_file_create(&Media, LOG_FILE_NAME);
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+
+  if ((status == FX_SUCCESS) && Preallocation) {
+    status = fx_file_extended_allocate(&File, Size);
+  }
+
+  for (Written = 0; (Written < Size) && (status == FX_SUCCESS); Written += WRITE_BATCH_SIZE) {
+    status = fx_file_write(&File, Batch, WRITE_BATCH_SIZE);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+
+  /* The media is closed when the log is stopped */
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  One log on the raw log area: the area is created first (once for
+*         all the sessions, not counted) and the write batching stage gives
+*         WRITE_BATCH_SIZE bytes to LogRaw_Write as on the firmware
+* @param  Size: Bytes to write
+* @param  BlockSize: Bytes for each block
+* @param  Buffer: One block
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT RawLogSession(ULONG64 Size, ULONG BlockSize, UCHAR *Buffer)
+{
+  ULONG AreaSize = (ULONG)(Size + Size / 8);
+  ULONG64 Written;
+  UINT status;
+
+  status = LogRaw_Open(&RawLog, &Media, &File, RAW_LOG_FILE_NAME, AreaSize, Buffer, BlockSize, 0x12345678U);
+  if (status == FX_SUCCESS) {
+    status = LogRaw_Close(&RawLog);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(&Media);
+  }
+
+  Cost_Start();
+
+  if (status == FX_SUCCESS) {
+    status = LogRaw_Open(&RawLog, &Media, &File, RAW_LOG_FILE_NAME, AreaSize, Buffer, BlockSize, 0x12345678U);
+  }
+
+  for (Written = 0; (Written < Size) && (status == FX_SUCCESS); Written += WRITE_BATCH_SIZE) {
+    status = LogRaw_Write(&RawLog, Batch, WRITE_BATCH_SIZE);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = LogRaw_Close(&RawLog);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Print one result
+* @param  Name: Name of the test
+* @param  Size: Bytes written by the log
+* @retval None
+*/
+static void PrintCost(const char *Name, ULONG64 Size)
+{
+  printf("%-28s %8.2f %9llu %7llu %9.1f %8.2f\n", Name, Size / Cost.Time,
+         (unsigned long long)Cost.Requests, (unsigned long long)Cost.Jumps,
+         (Cost.Sectors * (double)DISK_SECTOR_SIZE) / (Cost.Requests * 1024.0),
+         (Cost.Sectors * (double)DISK_SECTOR_SIZE) / Size);
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-m MB] [-c uS] [-b MB/s] [-j uS]\n", Name);
+  fprintf(stderr, "  -m  size of each log (default 64 MB)\n");
+  fprintf(stderr, "  -c  overhead of each SD request (default 250 uS)\n");
+  fprintf(stderr, "  -b  SD bus rate (default 25 MB/s)\n");
+  fprintf(stderr, "  -j  penalty of each write not sequential (default 1500 uS)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  static const ULONG BlockSizes[3] = {16 * 1024, 32 * 1024, 64 * 1024};
+  ULONG64 Size = 64ULL * 1024 * 1024;
+  UCHAR *Buffer;
+  char Name[64];
+  int ExFat;
+  int Index;
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      Size = (ULONG64)atoi(argv[++Arg]) * 1024 * 1024;
+    } else if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc)) {
+      Latency.CommandTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Latency.BusRate = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-j") == 0) && (Arg + 1 < argc)) {
+      Latency.JumpTime = atof(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if ((Size == 0) || (Size > 1024ULL * 1024 * 1024) || (Latency.BusRate <= 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  Buffer = malloc(BlockSizes[2]);
+  if (Buffer == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+  memset(Batch, 0x5A, sizeof(Batch));
+
+  fx_system_initialize();
+
+  printf("%u MB for each log, SD request %.0f uS + %.1f MB/s, %.0f uS for each jump\n",
+         (unsigned)(Size / (1024 * 1024)), Latency.CommandTime, Latency.BusRate, Latency.JumpTime);
+  printf("Log                              MB/s  Requests   Jumps  KB/Write  Written\n");
+
+  for (ExFat = 0; ExFat < 2; ExFat++) {
+    const char *Fs = ExFat ? "exFAT" : "FAT32";
+
+    snprintf(Name, sizeof(Name), "%s file", Fs);
+    if ((SimDisk_Open(ExFat) != FX_SUCCESS) || (FileLog(Size, 0) != FX_SUCCESS)) {
+      fprintf(stderr, "Error with %s\n", Name);
+      return 1;
+    }
+    PrintCost(Name, Size);
+
+    snprintf(Name, sizeof(Name), "%s file preallocated", Fs);
+    if ((SimDisk_Open(ExFat) != FX_SUCCESS) || (FileLog(Size, 1) != FX_SUCCESS)) {
+      fprintf(stderr, "Error with %s\n", Name);
+      return 1;
+    }
+    PrintCost(Name, Size);
+
+    for (Index = 0; Index < 3; Index++) {
+      snprintf(Name, sizeof(Name), "%s raw %u KB blocks", Fs, (unsigned)(BlockSizes[Index] / 1024));
+      if ((SimDisk_Open(ExFat) != FX_SUCCESS) || (RawLogSession(Size, BlockSizes[Index], Buffer) != FX_SUCCESS)) {
+        fprintf(stderr, "Error with %s\n", Name);
+        return 1;
+      }
+      PrintCost(Name, Size);
+    }
+  }
+
+  Disk_Free();
+  free(Buffer);
+
+  return 0;
+}
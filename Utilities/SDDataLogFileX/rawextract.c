@@ -0,0 +1,421 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\rawextract.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Extract the sessions saved by SDDataLogFileX on the raw log area
+  *          (RawLog.bin) as LogXXX.stb files, from one image of the whole SD
+  *          card or from the RawLog.bin file itself
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#define _FILE_OFFSET_BITS 64
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "sdlog_utils.h"
+#include "log_container.h"
+#include "log_raw.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SESSION_FILE_NAME "%sLog%03u.stb"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Superblock of the raw log area */
+typedef struct
+{
+  uint64_t Offset;           /* Position of the area on the input */
+  uint32_t BlockSectors;
+  uint32_t Blocks;
+  uint32_t Session;          /* Last session */
+  uint32_t FirstBlock;       /* First block of the last session */
+  uint32_t NextBlock;        /* First block after the last session (0 if not closed) */
+  uint32_t HeaderSize;
+  uint32_t Id;
+} Super_T;
+
+/* Header of one block */
+typedef struct
+{
+  uint32_t Session;
+  uint32_t Sequence;
+  uint32_t Payload;
+  uint8_t Valid;             /* Written by the area (header CRC valid) */
+  uint8_t Used;              /* Extracted with its session */
+} Block_T;
+
+/* Session that is extracted */
+typedef struct
+{
+  FILE *Out;
+  char Name[300];
+  uint32_t Session;
+  uint32_t FirstBlock;
+  uint32_t Blocks;
+  uint64_t Bytes;
+  uint32_t Errors;           /* Blocks with the payload corrupted */
+} Session_T;
+
+/* Private variables ---------------------------------------------------------*/
+static int Verbose = 0;
+static Super_T Super;
+static Block_T *Blocks;
+
+/**
+* @brief  Read and check one superblock
+* @param  Sector: LOG_RAW_SECTOR_SIZE bytes
+* @param  Super: Superblock to fill
+* @retval 1 if it's valid
+*/
+static int Super_Parse(const uint8_t *Sector, Super_T *Super)
+{
+  if ((memcmp(Sector, LOG_RAW_MAGIC, 8) != 0) ||
+      (SDLOG_GetU16(Sector + 8) != LOG_RAW_VERSION) ||
+      (SDLOG_GetU16(Sector + 10) != LOG_RAW_SUPER_SIZE) ||
+      (SDLOG_GetU32(Sector + LOG_RAW_SUPER_CRC_POS) != SDLOG_Crc32(Sector, LOG_RAW_SUPER_CRC_POS))) {
+    return 0;
+  }
+
+  Super->BlockSectors = SDLOG_GetU32(Sector + 12);
+  Super->Blocks       = SDLOG_GetU32(Sector + 16);
+  Super->Session      = SDLOG_GetU32(Sector + 20);
+  Super->FirstBlock   = SDLOG_GetU32(Sector + 24);
+  Super->NextBlock    = SDLOG_GetU32(Sector + 28);
+  Super->HeaderSize   = SDLOG_GetU32(Sector + 32);
+  Super->Id           = SDLOG_GetU32(Sector + 36);
+
+  return (Super->BlockSectors != 0) && (Super->HeaderSize == LOG_RAW_BLOCK_HEADER_SIZE);
+}
+
+/**
+* @brief  Search the superblock on the input, sector by sector
+* @param  In: Input (SD card image or RawLog.bin)
+* @param  Skip: Superblocks to skip (old areas still present on the card)
+* @param  Super: Superblock found
+* @retval 1 if it's found
+*/
+static int Super_Find(FILE *In, uint32_t Skip, Super_T *Super)
+{
+  static uint8_t Buffer[1024 * LOG_RAW_SECTOR_SIZE];
+  uint64_t Offset = 0;
+  size_t Read;
+  size_t Index;
+
+  if (fseeko(In, 0, SEEK_SET) != 0) {
+    return 0;
+  }
+
+  while ((Read = fread(Buffer, LOG_RAW_SECTOR_SIZE, sizeof(Buffer) / LOG_RAW_SECTOR_SIZE, In)) != 0) {
+    for (Index = 0; Index < Read; Index++) {
+      if (Super_Parse(Buffer + Index * LOG_RAW_SECTOR_SIZE, Super)) {
+        Super->Offset = Offset + Index * LOG_RAW_SECTOR_SIZE;
+        if (Skip == 0) {
+          return 1;
+        }
+        fprintf(stderr, "Superblock at offset %llu skipped\n", (unsigned long long)Super->Offset);
+        Skip--;
+      }
+    }
+    Offset += (uint64_t)Read * LOG_RAW_SECTOR_SIZE;
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Complete the header of one extracted session: the firmware doesn't
+*         update the first block when the session is closed, so the position
+*         of the index and the number of chunks are found walking the chunks
+* @param  Session: Session closed
+* @retval None
+*/
+static void Session_Complete(Session_T *Session)
+{
+  uint8_t Header[LOG_CONTAINER_HEADER_SIZE];
+  uint8_t Chunk[LOG_CONTAINER_CHUNK_HEADER_SIZE];
+  uint64_t Offset = LOG_CONTAINER_HEADER_SIZE;
+  uint32_t Chunks = 0;
+  int IndexFound = 0;
+
+  if ((fseeko(Session->Out, 0, SEEK_SET) != 0) ||
+      (fread(Header, 1, sizeof(Header), Session->Out) != sizeof(Header)) ||
+      (memcmp(Header, LOG_CONTAINER_MAGIC, 8) != 0)) {
+    fprintf(stderr, "%s: log container header not found\n", Session->Name);
+    return;
+  }
+
+  while ((fseeko(Session->Out, (off_t)Offset, SEEK_SET) == 0) &&
+         (fread(Chunk, 1, sizeof(Chunk), Session->Out) == sizeof(Chunk)) &&
+         (SDLOG_GetU16(Chunk) == LOG_CONTAINER_CHUNK_SYNC)) {
+    if (Chunk[2] == LOG_CONTAINER_STREAM_INDEX) {
+      IndexFound = 1;
+      break;
+    }
+    Offset += LOG_CONTAINER_CHUNK_HEADER_SIZE + SDLOG_GetU32(Chunk + 4);
+    if (Offset > Session->Bytes) {
+      break;
+    }
+    Chunks++;
+  }
+
+  /* Without the index (session not closed) stbsplit reads up to the last valid chunk */
+  if (IndexFound) {
+    SDLOG_PutU32(Header + LOG_CONTAINER_CHUNKS_POS, Chunks);
+    SDLOG_PutU32(Header + LOG_CONTAINER_INDEX_OFFSET_POS, (uint32_t)Offset);
+    SDLOG_PutU32(Header + LOG_CONTAINER_INDEX_OFFSET_POS + 4, (uint32_t)(Offset >> 32));
+
+    if ((fseeko(Session->Out, 0, SEEK_SET) != 0) ||
+        (fwrite(Header, 1, sizeof(Header), Session->Out) != sizeof(Header))) {
+      fprintf(stderr, "%s: error updating the header\n", Session->Name);
+    }
+  }
+
+  printf("%s: session %u, %u blocks from %u, %llu bytes, %u chunks%s%s\n", Session->Name,
+         Session->Session, Session->Blocks, Session->FirstBlock,
+         (unsigned long long)Session->Bytes, Chunks, IndexFound ? "" : ", not closed (no index)",
+         (Session->Errors != 0) ? ", with corrupted blocks" : "");
+}
+
+/**
+* @brief  Read the header of all the blocks
+* @param  In: Input
+* @retval 0 or 1 if the input is truncated
+*/
+static int Blocks_Read(FILE *In)
+{
+  uint32_t BlockSize = Super.BlockSectors * LOG_RAW_SECTOR_SIZE;
+  uint8_t Header[LOG_RAW_SECTOR_SIZE];
+  uint32_t Index;
+
+  for (Index = 1; Index < Super.Blocks; Index++) {
+    Block_T *Block = &Blocks[Index];
+
+    if ((fseeko(In, (off_t)(Super.Offset + (uint64_t)Index * BlockSize), SEEK_SET) != 0) ||
+        (fread(Header, 1, sizeof(Header), In) != sizeof(Header))) {
+      fprintf(stderr, "Block %u: input truncated\n", Index);
+      return 1;
+    }
+
+    Block->Session  = SDLOG_GetU32(Header + 12);
+    Block->Sequence = SDLOG_GetU32(Header + 16);
+    Block->Payload  = SDLOG_GetU32(Header + 20);
+    Block->Valid = (memcmp(Header, LOG_RAW_BLOCK_MAGIC, 8) == 0) &&
+                   (SDLOG_GetU32(Header + 8) == Super.Id) &&
+                   (SDLOG_GetU32(Header + LOG_RAW_BLOCK_CRC_POS) == SDLOG_Crc32(Header, LOG_RAW_BLOCK_CRC_POS)) &&
+                   (Block->Payload <= BlockSize - LOG_RAW_BLOCK_HEADER_SIZE);
+
+    if (Verbose && Block->Valid) {
+      fprintf(stderr, "Block %u: session %u sequence %u payload %u\n", Index,
+              Block->Session, Block->Sequence, Block->Payload);
+    }
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Extract one session following its blocks on the ring from its first one
+* @param  In: Input
+* @param  Prefix: Prefix of the output file
+* @param  FirstBlock: Block with sequence number 0
+* @param  Buffer: One block
+* @retval 0 or 1 for one error
+*/
+static int Session_Extract(FILE *In, const char *Prefix, uint32_t FirstBlock, uint8_t *Buffer)
+{
+  uint32_t BlockSize = Super.BlockSectors * LOG_RAW_SECTOR_SIZE;
+  uint32_t Index = FirstBlock;
+  Session_T Session;
+  int Result = 0;
+
+  memset(&Session, 0, sizeof(Session));
+  Session.Session = Blocks[FirstBlock].Session;
+  Session.FirstBlock = FirstBlock;
+  snprintf(Session.Name, sizeof(Session.Name), SESSION_FILE_NAME, Prefix, Session.Session);
+
+  Session.Out = fopen(Session.Name, "w+b");
+  if (Session.Out == NULL) {
+    fprintf(stderr, "Error creating %s\n", Session.Name);
+    return 1;
+  }
+
+  while (Blocks[Index].Valid && !Blocks[Index].Used &&
+         (Blocks[Index].Session == Session.Session) && (Blocks[Index].Sequence == Session.Blocks)) {
+    uint32_t Payload = Blocks[Index].Payload;
+
+    if ((fseeko(In, (off_t)(Super.Offset + (uint64_t)Index * BlockSize), SEEK_SET) != 0) ||
+        (fread(Buffer, 1, BlockSize, In) != BlockSize)) {
+      fprintf(stderr, "Block %u: input truncated\n", Index);
+      Result = 1;
+      break;
+    }
+
+    if (SDLOG_GetU32(Buffer + 24) != SDLOG_Crc32(Buffer + LOG_RAW_BLOCK_HEADER_SIZE, Payload)) {
+      fprintf(stderr, "%s: block %u (sequence %u) corrupted\n", Session.Name, Index, Session.Blocks);
+      Session.Errors++;
+      Result = 1;
+    }
+
+    if (fwrite(Buffer + LOG_RAW_BLOCK_HEADER_SIZE, 1, Payload, Session.Out) != Payload) {
+      fprintf(stderr, "Error writing %s\n", Session.Name);
+      Result = 1;
+      break;
+    }
+
+    Blocks[Index].Used = 1;
+    Session.Blocks++;
+    Session.Bytes += Payload;
+
+    /* Next block on the ring */
+    Index = (Index + 1 < Super.Blocks) ? (Index + 1) : 1;
+  }
+
+  Session_Complete(&Session);
+  fclose(Session.Out);
+
+  return Result;
+}
+
+/**
+* @brief  Order the first blocks of the sessions by session number
+* @param  a: First block
+* @param  b: First block
+* @retval Comparison result
+*/
+static int CompareSessions(const void *a, const void *b)
+{
+  uint32_t SessionA = Blocks[*(const uint32_t *)a].Session;
+  uint32_t SessionB = Blocks[*(const uint32_t *)b].Session;
+
+  return (SessionA > SessionB) - (SessionA < SessionB);
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-v] [-s superblocks] [-p prefix] input\n", Name);
+  fprintf(stderr, "  -v  print each block\n");
+  fprintf(stderr, "  -s  superblocks to skip (old raw log areas still present on the card)\n");
+  fprintf(stderr, "  -p  prefix of the output files (default none: Log000.stb, ...)\n");
+  fprintf(stderr, "  input: image of the SD card (e.g. dd if=/dev/sdX of=sd.img) or RawLog.bin\n");
+}
+
+int main(int argc, char *argv[])
+{
+  const char *Prefix = "";
+  uint32_t Skip = 0;
+  uint32_t *Starts;
+  uint8_t *Buffer;
+  uint32_t Index;
+  uint32_t Sessions = 0;
+  uint32_t Lost = 0;
+  uint32_t LastLost = 0;
+  int Result = 0;
+  FILE *In;
+  int Arg;
+
+  for (Arg = 1; (Arg < argc) && (argv[Arg][0] == '-'); Arg++) {
+    if (strcmp(argv[Arg], "-v") == 0) {
+      Verbose = 1;
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 1 < argc)) {
+      Skip = (uint32_t)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      Prefix = argv[++Arg];
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (Arg + 1 != argc) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  In = fopen(argv[Arg], "rb");
+  if (In == NULL) {
+    fprintf(stderr, "Error opening %s\n", argv[Arg]);
+    return 1;
+  }
+
+  if (!Super_Find(In, Skip, &Super)) {
+    fprintf(stderr, "Raw log superblock not found on %s\n", argv[Arg]);
+    return 1;
+  }
+
+  printf("Raw log area at offset %llu: %u blocks of %u bytes, id 0x%08X\n",
+         (unsigned long long)Super.Offset, Super.Blocks, Super.BlockSectors * LOG_RAW_SECTOR_SIZE, Super.Id);
+  if (Super.NextBlock != 0) {
+    printf("Last session %u closed (from block %u, next free block %u)\n",
+           Super.Session, Super.FirstBlock, Super.NextBlock);
+  } else {
+    printf("Last session %u not closed (from block %u)\n", Super.Session, Super.FirstBlock);
+  }
+
+  Blocks = calloc(Super.Blocks, sizeof(Block_T));
+  Starts = calloc(Super.Blocks, sizeof(uint32_t));
+  Buffer = malloc(Super.BlockSectors * LOG_RAW_SECTOR_SIZE);
+  if ((Blocks == NULL) || (Starts == NULL) || (Buffer == NULL)) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  Result = Blocks_Read(In);
+
+  /* Sessions whose first block is still present */
+  for (Index = 1; Index < Super.Blocks; Index++) {
+    if (Blocks[Index].Valid && (Blocks[Index].Sequence == 0)) {
+      Starts[Sessions++] = Index;
+    }
+  }
+  qsort(Starts, Sessions, sizeof(uint32_t), CompareSessions);
+
+  for (Index = 0; Index < Sessions; Index++) {
+    Result |= Session_Extract(In, Prefix, Starts[Index], Buffer);
+  }
+
+  /* Blocks left by the sessions partially overwritten by the next ones */
+  for (Index = 1; Index < Super.Blocks; Index++) {
+    if (Blocks[Index].Valid && !Blocks[Index].Used) {
+      if ((Lost == 0) || (Blocks[Index].Session != LastLost)) {
+        fprintf(stderr, "Session %u: first blocks overwritten, block %u not extracted\n",
+                Blocks[Index].Session, Index);
+        LastLost = Blocks[Index].Session;
+      }
+      Lost++;
+    }
+  }
+
+  printf("%u sessions extracted", Sessions);
+  if (Lost != 0) {
+    printf(", %u blocks of sessions partially overwritten", Lost);
+  }
+  printf("\n");
+
+  free(Buffer);
+  free(Starts);
+  free(Blocks);
+  fclose(In);
+
+  return Result;
+}
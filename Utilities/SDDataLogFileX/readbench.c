@@ -0,0 +1,561 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\readbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Benchmark of the read-ahead of the FileX SD driver of the firmware
+  *          (STBOX1_SD_READ_AHEAD): one log read back by FileX with sequential
+  *          and random reads on one simulated SD card, with the driver built
+  *          without read-ahead and with some read-ahead buffers
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fx_api.h"
+#include "fx_stm32_sd_driver.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated SD card: 4 GB (SDHC) formatted FAT32 with 32 KB clusters. The
+   memory is allocated only for the parts written */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (8 * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_CHUNKS           (DISK_SECTORS / DISK_CHUNK_SECTORS)
+
+/* Same write batching stage and media cache of the firmware */
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define LOG_FILE_NAME         "Sens000.csv"
+
+/* Max bytes of one fx_file_read */
+#define MAX_READ_SIZE         (64 * 1024)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Latency model of the SD card: each request costs one command overhead plus
+   the bus transfer (the DMA transfer on the board), then after each write the
+   card is busy programming. The driver copies the sectors read ahead at the CPU
+   copy rate */
+typedef struct
+{
+  double CommandTime;        /* uS for each request */
+  double BusRate;            /* MB/s on the bus */
+  double ProgramTime;        /* uS of card busy after each write */
+  double CopyRate;           /* MB/s of the CPU copy from the read-ahead buffer */
+} Latency_T;
+
+/* The same driver (fx_stm32_sd_driver.c) built with one read-ahead buffer of
+   Sectors sectors after Trigger sequential requests (see the Makefile) */
+typedef struct
+{
+  const char *Name;
+  VOID (*Driver)(FX_MEDIA *media_ptr);
+  FX_STM32_SD_DRIVER_STATS *Stats;
+} Driver_T;
+
+/* One way of reading the log */
+typedef struct
+{
+  const char *Name;
+  ULONG Size;                /* Bytes for each fx_file_read */
+  int Random;                /* 1 for one seek at one random position before each read */
+} Access_T;
+
+/* Private variables ---------------------------------------------------------*/
+extern VOID fx_stm32_sd_driver_ra0(FX_MEDIA *media_ptr);
+extern VOID fx_stm32_sd_driver_ra32(FX_MEDIA *media_ptr);
+extern VOID fx_stm32_sd_driver_ra128(FX_MEDIA *media_ptr);
+extern VOID fx_stm32_sd_driver_ra32all(FX_MEDIA *media_ptr);
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_ra0;
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_ra32;
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_ra128;
+extern FX_STM32_SD_DRIVER_STATS fx_stm32_sd_driver_stats_ra32all;
+
+static const Driver_T Drivers[] = {
+  {"none", fx_stm32_sd_driver_ra0, &fx_stm32_sd_driver_stats_ra0},
+  {"16 KB", fx_stm32_sd_driver_ra32, &fx_stm32_sd_driver_stats_ra32},
+  {"64 KB", fx_stm32_sd_driver_ra128, &fx_stm32_sd_driver_stats_ra128},
+  {"16 KB always", fx_stm32_sd_driver_ra32all, &fx_stm32_sd_driver_stats_ra32all},
+};
+#define DRIVERS               (sizeof(Drivers) / sizeof(Drivers[0]))
+
+static const Access_T Accesses[] = {
+  {"seq 512", 512, 0},
+  {"seq 4K", 4096, 0},
+  {"seq 16K", 16384, 0},
+  {"rnd 4K", 4096, 1},
+};
+#define ACCESSES              (sizeof(Accesses) / sizeof(Accesses[0]))
+
+static UCHAR *Disk[DISK_CHUNKS];
+static Latency_T Latency = {100.0, 25.0, 800.0, 200.0};
+static double Now;           /* uS of the simulation */
+static double CardReady;     /* End of the card busy */
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+
+static UCHAR Buffer[MAX_READ_SIZE] __attribute__ ((aligned (32)));
+static UCHAR Expected[MAX_READ_SIZE];
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated card
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Data: Data
+* @param  Write: 1 for writing the card
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Data, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Sectors;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Data, 0, DISK_SECTOR_SIZE);
+    } else {
+      Sectors = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Sectors, Data, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Data, Sectors, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Data += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Free the simulated card
+* @param  None
+* @retval None
+*/
+static void Disk_Free(void)
+{
+  ULONG Chunk;
+
+  for (Chunk = 0; Chunk < DISK_CHUNKS; Chunk++) {
+    free(Disk[Chunk]);
+    Disk[Chunk] = NULL;
+  }
+}
+
+/**
+* @brief  One transfer on the simulated card: the DMA transfer is completed
+*         at once, the time follows the latency model
+* @param  Count: Number of sectors
+* @param  Write: 1 for one write request
+* @retval None
+*/
+static void Card_Transfer(ULONG Count, int Write)
+{
+  if (CardReady > Now) {
+    Now = CardReady;
+  }
+  Now += Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate;
+
+  CardReady = Now;
+  if (Write) {
+    CardReady += Latency.ProgramTime;
+  }
+}
+
+/**
+* @brief  Time base of the driver statistics (DWT on the board)
+* @param  None
+* @retval uS of the simulation
+*/
+ULONG fx_stm32_sd_host_cycles(VOID)
+{
+  return (ULONG)Now;
+}
+
+/**
+* @brief  SD functions used by the driver (fx_stm32_sd_driver_glue.c on the board)
+*/
+INT fx_stm32_sd_init(UINT Instance)
+{
+  (void)Instance;
+  return 0;
+}
+
+INT fx_stm32_sd_deinit(UINT Instance)
+{
+  (void)Instance;
+  return 0;
+}
+
+INT fx_stm32_sd_get_status(UINT Instance)
+{
+  (void)Instance;
+
+  /* The driver polls the card until the end of its busy */
+  if (CardReady > Now) {
+    Now = CardReady;
+  }
+
+  return 0;
+}
+
+INT fx_stm32_sd_read_blocks(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks)
+{
+  (void)Instance;
+
+  if ((StartSector + NbrOfBlocks > DISK_SECTORS) || (((uintptr_t)Buffer & 0x3) != 0)) {
+    return 1;
+  }
+
+  Disk_Copy(StartSector, NbrOfBlocks, (UCHAR *)Buffer, 0);
+  Card_Transfer(NbrOfBlocks, 0);
+
+  return 0;
+}
+
+INT fx_stm32_sd_write_blocks(UINT Instance, UINT *Buffer, UINT StartSector, UINT NbrOfBlocks)
+{
+  (void)Instance;
+
+  if ((StartSector + NbrOfBlocks > DISK_SECTORS) || (((uintptr_t)Buffer & 0x3) != 0)) {
+    return 1;
+  }
+
+  Disk_Copy(StartSector, NbrOfBlocks, (UCHAR *)Buffer, 1);
+  Card_Transfer(NbrOfBlocks, 1);
+
+  return 0;
+}
+
+/**
+* @brief  Simulated time of the driver, with the copies from the read-ahead buffer
+* @param  Driver: Driver used
+* @retval uS
+*/
+static double Driver_Time(const Driver_T *Driver)
+{
+  return Now + (Driver->Stats->ReadAheadHits * (double)DISK_SECTOR_SIZE) / Latency.CopyRate;
+}
+
+/**
+* @brief  Pattern of the log data
+* @param  Data: Destination
+* @param  Offset: Offset of the data in the log
+* @param  Size: Bytes
+* @retval None
+*/
+static void Pattern(UCHAR *Data, ULONG64 Offset, ULONG Size)
+{
+  ULONG Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Data[Index] = (UCHAR)(((Offset + Index) * 7U) ^ ((Offset + Index) >> 9));
+  }
+}
+
+/**
+* @brief  Format the simulated card, open it with one driver and write the log
+* @param  Driver: Driver to use
+* @param  Size: Bytes of the log
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Log_Create(const Driver_T *Driver, ULONG64 Size)
+{
+  ULONG64 Offset;
+  UINT status;
+
+  Disk_Free();
+
+  status = fx_media_format(&Media, Driver->Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                           "RDBENCH", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 64, 1, 1);
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "RDBENCH", Driver->Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_create(&Media, LOG_FILE_NAME);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+
+  for (Offset = 0; (Offset < Size) && (status == FX_SUCCESS); Offset += WRITE_BATCH_SIZE) {
+    Pattern(Buffer, Offset, WRITE_BATCH_SIZE);
+    status = fx_file_write(&File, Buffer, WRITE_BATCH_SIZE);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Read the log with one access, after one media open (nothing on the
+*         media cache and on the read-ahead buffer)
+* @param  Driver: Driver to use
+* @param  Access: Access
+* @param  Size: Bytes of the log
+* @param  Bytes: Bytes read
+* @param  Time: uS of the reads
+* @param  Stats: Driver statistics of the reads
+* @retval FX_SUCCESS, FX_IO_ERROR for wrong data or the FileX error
+*/
+static UINT Log_Read(const Driver_T *Driver, const Access_T *Access, ULONG64 Size, ULONG64 *Bytes, double *Time,
+                     FX_STM32_SD_DRIVER_STATS *Stats)
+{
+  ULONG64 Reads = Size / Access->Size;
+  ULONG64 Offset = 0;
+  ULONG64 Index;
+  ULONG Actual;
+  double Start;
+  UINT status;
+
+  /* The random reads are 1/8 of the log */
+  if (Access->Random) {
+    Reads /= 8;
+  }
+
+  status = fx_media_open(&Media, "RDBENCH", Driver->Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_READ);
+  }
+
+  srand(1);
+  memset(Driver->Stats, 0, sizeof(*Driver->Stats));
+  Start = Driver_Time(Driver);
+
+  for (Index = 0; (Index < Reads) && (status == FX_SUCCESS); Index++) {
+    if (Access->Random) {
+      Offset = ((ULONG64)rand() % (Size / Access->Size)) * Access->Size;
+      status = fx_file_extended_seek(&File, Offset);
+    }
+
+    if (status == FX_SUCCESS) {
+      status = fx_file_read(&File, Buffer, Access->Size, &Actual);
+    }
+
+    if (status == FX_SUCCESS) {
+      Pattern(Expected, Offset, Access->Size);
+      if ((Actual != Access->Size) || (memcmp(Buffer, Expected, Access->Size) != 0)) {
+        fprintf(stderr, "Wrong data at %llu\n", (unsigned long long)Offset);
+        status = FX_IO_ERROR;
+      }
+    }
+
+    Offset += Access->Size;
+  }
+
+  *Time = Driver_Time(Driver) - Start;
+  *Bytes = Reads * Access->Size;
+  *Stats = *Driver->Stats;
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  The writes discard the read-ahead buffer: the start of the log is read
+*         (so it's on the read-ahead buffer), then some sectors are written on it
+*         and read back after the media cache is invalidated
+* @param  Driver: Driver to use
+* @retval FX_SUCCESS, FX_IO_ERROR for wrong data or the FileX error
+*/
+static UINT Log_Coherence(const Driver_T *Driver)
+{
+  static FX_FILE Writer;
+  ULONG64 Offset;
+  ULONG Actual;
+  UINT status;
+
+  status = fx_media_open(&Media, "RDBENCH", Driver->Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_READ);
+  }
+
+  for (Offset = 0; (Offset < 4096) && (status == FX_SUCCESS); Offset += 512) {
+    status = fx_file_read(&File, Buffer, 512, &Actual);
+  }
+
+  /* New data on the sectors read ahead */
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &Writer, LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_extended_seek(&Writer, 8192);
+  }
+  if (status == FX_SUCCESS) {
+    memset(Buffer, 0xA5, 1024);
+    status = fx_file_write(&Writer, Buffer, 1024);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&Writer);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_cache_invalidate(&Media);
+  }
+
+  for (; (Offset < 16384) && (status == FX_SUCCESS); Offset += 512) {
+    status = fx_file_read(&File, Buffer, 512, &Actual);
+    if (status == FX_SUCCESS) {
+      if ((Offset >= 8192) && (Offset < 8192 + 1024)) {
+        memset(Expected, 0xA5, 512);
+      } else {
+        Pattern(Expected, Offset, 512);
+      }
+      if ((Actual != 512) || (memcmp(Buffer, Expected, 512) != 0)) {
+        status = FX_IO_ERROR;
+      }
+    }
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-m MB] [-c uS] [-b MB/s] [-r MB/s]\n", Name);
+  fprintf(stderr, "  -m  size of the log (default 16 MB)\n");
+  fprintf(stderr, "  -c  command overhead of each SD request (default 100 uS)\n");
+  fprintf(stderr, "  -b  SD bus rate (default 25 MB/s)\n");
+  fprintf(stderr, "  -r  CPU copy rate from the read-ahead buffer (default 200 MB/s)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  ULONG64 Size = 16ULL * 1024 * 1024;
+  ULONG Index;
+  ULONG Access;
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      Size = (ULONG64)atoi(argv[++Arg]) * 1024 * 1024;
+    } else if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc)) {
+      Latency.CommandTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Latency.BusRate = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-r") == 0) && (Arg + 1 < argc)) {
+      Latency.CopyRate = atof(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if ((Size == 0) || (Size > 1024ULL * 1024 * 1024) || (Latency.BusRate <= 0) || (Latency.CopyRate <= 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  fx_system_initialize();
+
+  printf("FAT32, %u MB log, SD request %.0f uS + %.1f MB/s, copy %.0f MB/s\n",
+         (unsigned)(Size / (1024 * 1024)), Latency.CommandTime, Latency.BusRate, Latency.CopyRate);
+  printf("MB/s (SD requests) for each fx_file_read size, random reads on 1/8 of the log\n");
+  printf("Read-ahead  ");
+  for (Access = 0; Access < ACCESSES; Access++) {
+    printf("  %16s", Accesses[Access].Name);
+  }
+  printf("  Writes\n");
+
+  for (Index = 0; Index < DRIVERS; Index++) {
+    const Driver_T *Driver = &Drivers[Index];
+
+    Now = 0;
+    CardReady = 0;
+    if (Log_Create(Driver, Size) != FX_SUCCESS) {
+      fprintf(stderr, "Error writing the log (%s)\n", Driver->Name);
+      return 1;
+    }
+
+    printf("%-12s", Driver->Name);
+
+    for (Access = 0; Access < ACCESSES; Access++) {
+      FX_STM32_SD_DRIVER_STATS Stats;
+      ULONG64 Bytes;
+      double Time;
+
+      if (Log_Read(Driver, &Accesses[Access], Size, &Bytes, &Time, &Stats) != FX_SUCCESS) {
+        fprintf(stderr, "Error reading the log (%s, %s)\n", Driver->Name, Accesses[Access].Name);
+        return 1;
+      }
+
+      printf("  %6.2f (%7lu)", Bytes / Time, (unsigned long)Stats.Requests);
+    }
+
+    printf("  %s\n", (Log_Coherence(Driver) == FX_SUCCESS) ? "OK" : "ERROR");
+  }
+
+  Disk_Free();
+
+  return 0;
+}
@@ -0,0 +1,444 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\ringbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Check of the message rings of the firmware (FileX/App/msg_ring.h)
+  *          on the ThreadX Linux port: one producer thread (the sensors
+  *          thread) and one simulated interrupt (the audio callback) against
+  *          one slow consumer (the Writing thread). The sequence numbers of
+  *          the messages received must be continuous and each message must be
+  *          received or counted in the Overflows of its ring
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "tx_api.h"
+#include "msg_ring.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Same ring sizes, events and thread priorities of the firmware */
+#define SENSORS_RING_SIZE     128
+#define AUDIO_RING_SIZE       4
+#define MESSAGE_EVENT_SENSORS 0x1U
+#define MESSAGE_EVENT_AUDIO   0x2U
+#define READ_THREAD_PRIO      10
+#define WRITE_THREAD_PRIO     11
+#define THREAD_STACK_SIZE     (4 * 1024)
+
+/* Words of payload of each message, checked by the consumer */
+#define PAYLOAD_WORDS         15
+
+/* One command (never discarded) every COMMAND_TICKS ticks of the producer thread */
+#define COMMAND_TICKS         50
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  MESSAGE_SAMPLE = 0,
+  MESSAGE_COMMAND,
+  MESSAGE_AUDIO
+} MessageKind_T;
+
+typedef struct
+{
+  ULONG Kind;
+  ULONG Seq;                 /* Sequence number of its kind */
+  ULONG Payload[PAYLOAD_WORDS];
+} Message_T;
+
+/* Counters of one kind of messages */
+typedef struct
+{
+  const char *Name;
+  MsgRing_T *Ring;
+  ULONG Sent;                /* Messages produced (received or lost) */
+  ULONG Retries;             /* Reserve requests refused and retried (commands) */
+  ULONG Received;
+  ULONG NextSeq;             /* Sequence number expected by the consumer */
+  ULONG Gaps;                /* Messages missing between the received ones */
+  ULONG Errors;              /* Messages out of order or with wrong payload */
+} Stream_T;
+
+/* Private variables ---------------------------------------------------------*/
+
+/* ThreadX Linux port: simulated interrupts */
+extern VOID _tx_thread_context_save(VOID);
+extern VOID _tx_thread_context_restore(VOID);
+
+static Message_T SensorsRingBuffer[SENSORS_RING_SIZE];
+static Message_T AudioRingBuffer[AUDIO_RING_SIZE];
+static MsgRing_T SensorsRing;
+static MsgRing_T AudioRing;
+static TX_EVENT_FLAGS_GROUP MessageEvents;
+
+static Stream_T Streams[] = {
+  {"Samples", &SensorsRing, 0, 0, 0, 0, 0, 0},
+  {"Commands", &SensorsRing, 0, 0, 0, 0, 0, 0},
+  {"Audio", &AudioRing, 0, 0, 0, 0, 0, 0},
+};
+#define STREAMS               (sizeof(Streams) / sizeof(Streams[0]))
+
+static TX_THREAD ProducerThread;
+static TX_THREAD ConsumerThread;
+static ULONG ProducerStack[THREAD_STACK_SIZE / sizeof(ULONG)];
+static ULONG ConsumerStack[THREAD_STACK_SIZE / sizeof(ULONG)];
+
+/* Simulated audio interrupt */
+static pthread_t IsrThread;
+static sem_t IsrStart;
+static Message_T *AudioMsg;
+static int AudioTailOverflow;
+
+static volatile int Stop;
+static volatile int ProducerDone;
+static volatile int IsrDone;
+
+/* Options */
+static ULONG Duration = 10;          /* S */
+static ULONG IsrPeriod = 4000;       /* uS */
+static ULONG Burst = 4;              /* Samples for each tick of the producer thread */
+static ULONG StallMessages = 16;     /* Messages between two stalls of the consumer */
+static ULONG StallTicks = 2;         /* Ticks of each stall */
+
+/* Private function prototypes -----------------------------------------------*/
+static void Message_Fill(Message_T *Msg, ULONG Kind, ULONG Seq);
+static int Message_Check(Message_T *Msg);
+static void *Isr_Thread(void *Arg);
+static VOID Producer_Thread(ULONG Input);
+static VOID Consumer_Thread(ULONG Input);
+static int Report(void);
+static void Usage(const char *Name);
+
+/**
+* @brief  Fill one message with its sequence number and the payload derived from it
+* @param  Msg: Message reserved on the ring
+* @param  Kind: MESSAGE_SAMPLE, MESSAGE_COMMAND or MESSAGE_AUDIO
+* @param  Seq: Sequence number
+* @retval None
+*/
+static void Message_Fill(Message_T *Msg, ULONG Kind, ULONG Seq)
+{
+  ULONG Index;
+
+  Msg->Kind = Kind;
+  Msg->Seq = Seq;
+  for (Index = 0; Index < PAYLOAD_WORDS; Index++) {
+    Msg->Payload[Index] = (Seq * 2654435761U) ^ (Kind << 24) ^ Index;
+  }
+}
+
+/**
+* @brief  Check the payload of one message (one message read while it's written
+*         by the producer has the payload of two sequence numbers)
+* @param  Msg: Message peeked from the ring
+* @retval 1 if the payload is correct
+*/
+static int Message_Check(Message_T *Msg)
+{
+  ULONG Index;
+
+  for (Index = 0; Index < PAYLOAD_WORDS; Index++) {
+    if (Msg->Payload[Index] != ((Msg->Seq * 2654435761U) ^ (Msg->Kind << 24) ^ Index)) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/**
+* @brief  Simulated audio interrupt: one host thread that runs the logic of
+*         AudioProcess_SD_Recording as one ThreadX interrupt every IsrPeriod uS
+*         (one audio block for each interrupt). The message of the next block
+*         is reserved in advance: if the ring is full the next block is lost
+* @param  Arg: Not used
+* @retval None
+*/
+static void *Isr_Thread(void *Arg)
+{
+  Stream_T *Audio = &Streams[MESSAGE_AUDIO];
+  struct timespec ts;
+
+  (void)Arg;
+
+  while (sem_wait(&IsrStart) != 0) {
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  while (!Stop) {
+    ts.tv_nsec += (long)IsrPeriod * 1000L;
+    while (ts.tv_nsec >= 1000000000L) {
+      ts.tv_nsec -= 1000000000L;
+      ts.tv_sec++;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+
+    _tx_thread_context_save();
+    if (AudioMsg != NULL) {
+      /* The block is complete: send it to the consumer */
+      Message_Fill(AudioMsg, MESSAGE_AUDIO, Audio->Sent);
+      MsgRing_Commit(&AudioRing);
+      tx_event_flags_set(&MessageEvents, MESSAGE_EVENT_AUDIO, TX_OR);
+    }
+    /* Else the data of this block were discarded, counted by the Reserve that failed */
+    Audio->Sent++;
+    AudioMsg = (Message_T *) MsgRing_Reserve(&AudioRing);
+    _tx_thread_context_restore();
+  }
+
+  /* The block after the last one is never produced */
+  AudioTailOverflow = (AudioMsg == NULL);
+  IsrDone = 1;
+
+  return NULL;
+}
+
+/**
+* @brief  Producer thread: Burst samples at each tick (one FIFO drain), discarded
+*         when the ring is full as the sensors thread does, and one command
+*         every COMMAND_TICKS ticks that waits for one free message
+* @param  Input: Not used
+* @retval None
+*/
+static VOID Producer_Thread(ULONG Input)
+{
+  Stream_T *Samples = &Streams[MESSAGE_SAMPLE];
+  Stream_T *Commands = &Streams[MESSAGE_COMMAND];
+  Message_T *Msg;
+  ULONG Ticks = 0;
+  ULONG Index;
+
+  (void)Input;
+
+  sem_post(&IsrStart);
+
+  while (!Stop) {
+    tx_thread_sleep(1);
+    Ticks++;
+
+    if ((Ticks % COMMAND_TICKS) == 0) {
+      /* The commands are never discarded */
+      while ((Msg = (Message_T *) MsgRing_Reserve(&SensorsRing)) == NULL) {
+        Commands->Retries++;
+        tx_thread_sleep(1);
+      }
+      Message_Fill(Msg, MESSAGE_COMMAND, Commands->Sent++);
+      MsgRing_Commit(&SensorsRing);
+      tx_event_flags_set(&MessageEvents, MESSAGE_EVENT_SENSORS, TX_OR);
+    }
+
+    for (Index = 0; Index < Burst; Index++) {
+      /* If the ring is full the sample is discarded (and counted) */
+      Msg = (Message_T *) MsgRing_Reserve(&SensorsRing);
+      Samples->Sent++;
+      if (Msg == NULL) {
+        continue;
+      }
+      Message_Fill(Msg, MESSAGE_SAMPLE, Samples->Sent - 1);
+      MsgRing_Commit(&SensorsRing);
+      tx_event_flags_set(&MessageEvents, MESSAGE_EVENT_SENSORS, TX_OR);
+    }
+  }
+
+  ProducerDone = 1;
+}
+
+/**
+* @brief  Consumer thread: the audio blocks first, then the sensors, as
+*         MessageReceive does, with one stall of StallTicks ticks every
+*         StallMessages messages (the SD writes). It stops the producers after
+*         Duration seconds and reports when both the rings are empty
+* @param  Input: Not used
+* @retval None
+*/
+static VOID Consumer_Thread(ULONG Input)
+{
+  MsgRing_T *Ring;
+  Message_T *Msg;
+  Stream_T *Stream;
+  ULONG Messages = 0;
+  ULONG Events;
+
+  (void)Input;
+
+  for (;;) {
+    if (tx_time_get() >= (Duration * TX_TIMER_TICKS_PER_SECOND)) {
+      Stop = 1;
+    }
+
+    Ring = &AudioRing;
+    Msg = (Message_T *) MsgRing_Peek(&AudioRing);
+    if (Msg == NULL) {
+      Ring = &SensorsRing;
+      Msg = (Message_T *) MsgRing_Peek(&SensorsRing);
+    }
+
+    if (Msg == NULL) {
+      if (ProducerDone && IsrDone && (MsgRing_Used(&AudioRing) == 0) && (MsgRing_Used(&SensorsRing) == 0)) {
+        exit(Report());
+      }
+      /* Wait for one new message (with timeout for seeing the end of the test) */
+      tx_event_flags_get(&MessageEvents, MESSAGE_EVENT_SENSORS | MESSAGE_EVENT_AUDIO, TX_OR_CLEAR,
+                         &Events, 10);
+      continue;
+    }
+
+    if ((Msg->Kind >= STREAMS) || (Streams[Msg->Kind].Ring != Ring)) {
+      Streams[(Ring == &AudioRing) ? MESSAGE_AUDIO : MESSAGE_SAMPLE].Errors++;
+    } else {
+      Stream = &Streams[Msg->Kind];
+      if ((Msg->Seq < Stream->NextSeq) || !Message_Check(Msg)) {
+        Stream->Errors++;
+      } else {
+        Stream->Gaps += Msg->Seq - Stream->NextSeq;
+        Stream->NextSeq = Msg->Seq + 1;
+      }
+      Stream->Received++;
+    }
+
+    /* Give back the message to its producer */
+    MsgRing_Release(Ring);
+
+    if ((++Messages % StallMessages) == 0) {
+      tx_thread_sleep(StallTicks);
+    }
+  }
+}
+
+/**
+* @brief  Print the counters and check them
+* @param  None
+* @retval 0 or 1 if one check failed
+*/
+static int Report(void)
+{
+  ULONG Lost[STREAMS];
+  ULONG Overflows[STREAMS];
+  int Failed = 0;
+  ULONG Index;
+
+  /* The Overflows of the sensors ring are shared: samples lost plus commands retried */
+  Overflows[MESSAGE_SAMPLE] = SensorsRing.Overflows - Streams[MESSAGE_COMMAND].Retries;
+  Overflows[MESSAGE_COMMAND] = 0;
+  Overflows[MESSAGE_AUDIO] = AudioRing.Overflows - (ULONG)AudioTailOverflow;
+
+  printf("%lu S, producer thread %lu samples/tick (%u Hz ticks), interrupt every %lu uS\n",
+         (unsigned long)Duration, (unsigned long)Burst, (unsigned)TX_TIMER_TICKS_PER_SECOND, (unsigned long)IsrPeriod);
+  printf("Consumer stalls %lu ticks every %lu messages\n", (unsigned long)StallTicks, (unsigned long)StallMessages);
+  printf("Stream        Sent  Received  Overflows  Retries   Gaps  Errors  MaxUsed/Size\n");
+  for (Index = 0; Index < STREAMS; Index++) {
+    Stream_T *Stream = &Streams[Index];
+
+    /* Each message is received or counted, without gaps other than the lost ones */
+    Lost[Index] = Stream->Sent - Stream->Received;
+    if ((Stream->Errors != 0) || (Lost[Index] != Overflows[Index]) ||
+        ((Stream->Gaps + (Stream->Sent - Stream->NextSeq)) != Lost[Index])) {
+      Failed = 1;
+    }
+
+    printf("%-10s %7lu  %8lu  %9lu  %7lu  %5lu  %6lu  %7lu/%-4lu %s\n", Stream->Name,
+           (unsigned long)Stream->Sent, (unsigned long)Stream->Received, (unsigned long)Overflows[Index],
+           (unsigned long)Stream->Retries, (unsigned long)Stream->Gaps, (unsigned long)Stream->Errors,
+           (unsigned long)Stream->Ring->MaxUsed, (unsigned long)Stream->Ring->ItemsNumber,
+           (Lost[Index] == Overflows[Index]) ? "" : "LOST NOT COUNTED");
+  }
+  printf("%s\n", Failed ? "FAILED" : "OK: sequences continuous, each message received or counted");
+
+  return Failed;
+}
+
+/**
+* @brief  ThreadX application define: the rings, the producer and the consumer
+* @param  first_unused_memory: Not used
+* @retval None
+*/
+VOID tx_application_define(VOID *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  MsgRing_Init(&SensorsRing, SensorsRingBuffer, sizeof(Message_T), SENSORS_RING_SIZE);
+  MsgRing_Init(&AudioRing, AudioRingBuffer, sizeof(Message_T), AUDIO_RING_SIZE);
+  AudioMsg = (Message_T *) MsgRing_Reserve(&AudioRing);
+
+  if ((tx_event_flags_create(&MessageEvents, "Message Events") != TX_SUCCESS) ||
+      (tx_thread_create(&ProducerThread, "Producer", Producer_Thread, 0, ProducerStack, sizeof(ProducerStack),
+                        READ_THREAD_PRIO, READ_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START) != TX_SUCCESS) ||
+      (tx_thread_create(&ConsumerThread, "Consumer", Consumer_Thread, 0, ConsumerStack, sizeof(ConsumerStack),
+                        WRITE_THREAD_PRIO, WRITE_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START) != TX_SUCCESS)) {
+    fprintf(stderr, "Error creating the threads\n");
+    exit(1);
+  }
+
+  /* The simulated interrupt is started by the producer, with the scheduler running */
+  sem_init(&IsrStart, 0, 0);
+  pthread_create(&IsrThread, NULL, Isr_Thread, NULL);
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-t S] [-i uS] [-n samples] [-k messages] [-s ticks]\n", Name);
+  fprintf(stderr, "  -t  test duration (default 10 S)\n");
+  fprintf(stderr, "  -i  period of the simulated audio interrupt (default 4000 uS)\n");
+  fprintf(stderr, "  -n  samples of the producer thread at each tick (default 4)\n");
+  fprintf(stderr, "  -k  messages between two stalls of the consumer (default 16)\n");
+  fprintf(stderr, "  -s  ticks of each stall of the consumer (default 2)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  int Arg;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-t") == 0) && (Arg + 1 < argc)) {
+      Duration = strtoul(argv[++Arg], NULL, 0);
+    } else if ((strcmp(argv[Arg], "-i") == 0) && (Arg + 1 < argc)) {
+      IsrPeriod = strtoul(argv[++Arg], NULL, 0);
+    } else if ((strcmp(argv[Arg], "-n") == 0) && (Arg + 1 < argc)) {
+      Burst = strtoul(argv[++Arg], NULL, 0);
+    } else if ((strcmp(argv[Arg], "-k") == 0) && (Arg + 1 < argc)) {
+      StallMessages = strtoul(argv[++Arg], NULL, 0);
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 1 < argc)) {
+      StallTicks = strtoul(argv[++Arg], NULL, 0);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if ((Duration == 0) || (IsrPeriod == 0) || (StallMessages == 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  tx_kernel_enter();
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\sdlog_utils.h
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Little-endian helpers shared by the SDDataLogFileX host tools
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SDLOG_UTILS_H
+#define __SDLOG_UTILS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+/* Exported functions --------------------------------------------------------*/
+
+/* The files are written by a little-endian Cortex-M33: read them byte by byte
+   for being independent from the host endianness */
+static inline uint16_t SDLOG_GetU16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t SDLOG_GetU32(const uint8_t *p)
+{
+  return ((uint32_t)p[0]) | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline float SDLOG_GetFloat(const uint8_t *p)
+{
+  uint32_t u = SDLOG_GetU32(p);
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+static inline void SDLOG_PutU16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void SDLOG_PutU32(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+/* CRC-32 (IEEE 802.3) of the log_raw.c superblock and blocks */
+static inline uint32_t SDLOG_Crc32(const uint8_t *p, size_t Size)
+{
+  static const uint32_t Nibble[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+  };
+  uint32_t Crc = 0xFFFFFFFFU;
+
+  while (Size-- > 0) {
+    Crc ^= *p++;
+    Crc = (Crc >> 4) ^ Nibble[Crc & 0xFU];
+    Crc = (Crc >> 4) ^ Nibble[Crc & 0xFU];
+  }
+
+  return ~Crc;
+}
+
+#endif /* __SDLOG_UTILS_H */
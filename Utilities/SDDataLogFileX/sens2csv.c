@@ -0,0 +1,195 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\sens2csv.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host tool for converting the SDDataLogFileX binary sensors
+  *          log (SensXXX.dat) to the SensXXX.csv text format
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sdlog_utils.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Binary sensors log layout (see SensorsLogHeader_T, SensorsLogChannel_T and
+   SensorsLogRecord_T in SDDataLogFileX\FileX\App\app_filex.c) */
+#define SENSORS_LOG_MAGIC           "STBOXLOG"
+#define SENSORS_LOG_VERSION         1
+#define SENSORS_LOG_HEADER_SIZE     24
+#define SENSORS_LOG_CHANNEL_SIZE    40
+#define SENSORS_LOG_MAX_CHANNELS    64
+
+#define SENSORS_LOG_TYPE_INT32      0
+#define SENSORS_LOG_TYPE_FLOAT      1
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  char Sensor[13];
+  char Name[9];
+  char Unit[9];
+  uint32_t Type;
+  float Sensitivity;
+  float Odr;
+} Channel_T;
+
+/* Private variables ---------------------------------------------------------*/
+static Channel_T Channels[SENSORS_LOG_MAX_CHANNELS];
+
+/**
+* @brief  Main program
+* @param  argc: number of arguments
+* @param  argv: arguments (input .dat file and optional output .csv file)
+* @retval 0 on success, 1 otherwise
+*/
+int main(int argc, char **argv)
+{
+  uint8_t Header[SENSORS_LOG_HEADER_SIZE];
+  uint8_t Descriptor[SENSORS_LOG_CHANNEL_SIZE];
+  uint8_t *Record;
+  uint16_t Version, HeaderSize, RecordSize, ChannelsNumber;
+  uint32_t TickFrequency;
+  float Odr;
+  uint32_t NumRecords = 0;
+  FILE *In, *Out;
+  int Verbose = 0;
+  int ArgIndex = 1;
+  int i;
+
+  if ((argc > 1) && (strcmp(argv[1], "-v") == 0)) {
+    Verbose = 1;
+    ArgIndex++;
+  }
+
+  if ((argc - ArgIndex) < 1) {
+    fprintf(stderr, "Usage: %s [-v] SensXXX.dat [SensXXX.csv]\n", argv[0]);
+    return 1;
+  }
+
+  In = fopen(argv[ArgIndex], "rb");
+  if (In == NULL) {
+    fprintf(stderr, "Error opening %s\n", argv[ArgIndex]);
+    return 1;
+  }
+
+  if ((argc - ArgIndex) > 1) {
+    Out = fopen(argv[ArgIndex + 1], "wb");
+    if (Out == NULL) {
+      fprintf(stderr, "Error opening %s\n", argv[ArgIndex + 1]);
+      fclose(In);
+      return 1;
+    }
+  } else {
+    Out = stdout;
+  }
+
+  /* Read and check the file header */
+  if ((fread(Header, 1, sizeof(Header), In) != sizeof(Header)) ||
+      (memcmp(Header, SENSORS_LOG_MAGIC, 8) != 0)) {
+    fprintf(stderr, "%s is not a SDDataLogFileX sensors log\n", argv[ArgIndex]);
+    return 1;
+  }
+
+  Version        = SDLOG_GetU16(Header + 8);
+  HeaderSize     = SDLOG_GetU16(Header + 10);
+  RecordSize     = SDLOG_GetU16(Header + 12);
+  ChannelsNumber = SDLOG_GetU16(Header + 14);
+  TickFrequency  = SDLOG_GetU32(Header + 16);
+  Odr            = SDLOG_GetFloat(Header + 20);
+
+  if (Version != SENSORS_LOG_VERSION) {
+    fprintf(stderr, "Unsupported sensors log version %u\n", Version);
+    return 1;
+  }
+
+  if ((ChannelsNumber > SENSORS_LOG_MAX_CHANNELS) ||
+      (HeaderSize != (SENSORS_LOG_HEADER_SIZE + ChannelsNumber * SENSORS_LOG_CHANNEL_SIZE)) ||
+      (RecordSize != (4 + ChannelsNumber * 4))) {
+    fprintf(stderr, "Corrupted sensors log header\n");
+    return 1;
+  }
+
+  /* Read the channels descriptors */
+  for (i = 0; i < ChannelsNumber; i++) {
+    if (fread(Descriptor, 1, sizeof(Descriptor), In) != sizeof(Descriptor)) {
+      fprintf(stderr, "Truncated sensors log header\n");
+      return 1;
+    }
+    memcpy(Channels[i].Sensor, Descriptor, 12);
+    memcpy(Channels[i].Name, Descriptor + 12, 8);
+    memcpy(Channels[i].Unit, Descriptor + 20, 8);
+    Channels[i].Type        = SDLOG_GetU32(Descriptor + 28);
+    Channels[i].Sensitivity = SDLOG_GetFloat(Descriptor + 32);
+    Channels[i].Odr         = SDLOG_GetFloat(Descriptor + 36);
+  }
+
+  if (Verbose) {
+    fprintf(stderr, "Records: %u bytes @ %.2f Hz, time stamp @ %u Hz\n", RecordSize, Odr, TickFrequency);
+    for (i = 0; i < ChannelsNumber; i++) {
+      fprintf(stderr, "  %-12s %-8s [%s] Sensitivity=%f ODR=%.2f Hz\n",
+              Channels[i].Sensor, Channels[i].Name, Channels[i].Unit,
+              Channels[i].Sensitivity, Channels[i].Odr);
+    }
+  }
+
+  /* Same header of the SensXXX.csv files (the IMU FIFO mode uses the sensor's time stamps) */
+  if (TickFrequency == 100) {
+    fprintf(Out, "Time [mS], ");
+  } else {
+    fprintf(Out, "Time [%guS], ", 1e6 / TickFrequency);
+  }
+  for (i = 0; i < ChannelsNumber; i++) {
+    fprintf(Out, "%s%s [%s]", (i == 0) ? "" : ",", Channels[i].Name, Channels[i].Unit);
+  }
+  fprintf(Out, "\r\n");
+
+  Record = malloc(RecordSize);
+  if (Record == NULL) {
+    return 1;
+  }
+
+  /* Convert all the records */
+  while (fread(Record, 1, RecordSize, In) == RecordSize) {
+    fprintf(Out, "%u", SDLOG_GetU32(Record));
+    for (i = 0; i < ChannelsNumber; i++) {
+      uint8_t *Value = Record + 4 + i * 4;
+      if (Channels[i].Type == SENSORS_LOG_TYPE_FLOAT) {
+        fprintf(Out, ", %5.2f", SDLOG_GetFloat(Value));
+      } else {
+        fprintf(Out, ", %d", (int32_t)SDLOG_GetU32(Value));
+      }
+    }
+    fprintf(Out, "\r\n");
+    NumRecords++;
+  }
+
+  if (Verbose) {
+    fprintf(stderr, "%u records converted\n", NumRecords);
+  }
+
+  free(Record);
+  fclose(In);
+  if (Out != stdout) {
+    fclose(Out);
+  }
+
+  return 0;
+}
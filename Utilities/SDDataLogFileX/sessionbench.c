@@ -0,0 +1,381 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\sessionbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host benchmark of the SDDataLogFileX log start: time and sector
+  *          reads for finding the next free session name, searching all the
+  *          names on the root directory or with the session index
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "fx_api.h"
+#include "log_session.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* RAM disk: 64 MB, FAT32 with 512 bytes clusters or exFAT with 4 KB clusters */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (128 * 1024)
+
+/* Same names and media cache of the firmware */
+#define SENSORS_FILE_NAME     "Sens%03d.csv"
+#define AUDIO_FILE_NAME       "Mic%03d.wav"
+#define SESSION_INDEX_FILE_NAME "Session.idx"
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Cost of one log start */
+typedef struct
+{
+  uint64_t Reads;            /* Sectors read */
+  uint64_t Writes;           /* Sectors written */
+  uint32_t Creates;          /* fx_file_create calls for the sensors file */
+  double Time;               /* uS on the host */
+} Cost_T;
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR *Disk;
+static uint64_t DiskReads;
+static uint64_t DiskWrites;
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE SessionFile;
+
+static int ExFat = 0;
+static uint32_t DirSize = 100;
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to mask in one thread
+* @param  None
+* @retval Previous posture
+*/
+UINT _tx_thread_interrupt_disable(void)
+{
+  return 0;
+}
+
+/**
+* @brief  ThreadX interrupt control used by FileX: nothing to restore in one thread
+* @param  previous_posture: posture returned by _tx_thread_interrupt_disable
+* @retval None
+*/
+VOID _tx_thread_interrupt_restore(UINT previous_posture)
+{
+  (void)previous_posture;
+}
+
+/**
+* @brief  RAM disk driver counting the sectors read and written
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID RamDisk_Driver(FX_MEDIA *media_ptr)
+{
+  ULONG64 Sector = media_ptr->fx_media_driver_logical_sector;
+  ULONG Count = media_ptr->fx_media_driver_sectors;
+
+  media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+  switch (media_ptr->fx_media_driver_request) {
+  case FX_DRIVER_READ:
+    memcpy(media_ptr->fx_media_driver_buffer, Disk + Sector * DISK_SECTOR_SIZE, Count * DISK_SECTOR_SIZE);
+    DiskReads += Count;
+    break;
+  case FX_DRIVER_WRITE:
+    memcpy(Disk + Sector * DISK_SECTOR_SIZE, media_ptr->fx_media_driver_buffer, Count * DISK_SECTOR_SIZE);
+    DiskWrites += Count;
+    break;
+  case FX_DRIVER_BOOT_READ:
+    memcpy(media_ptr->fx_media_driver_buffer, Disk, DISK_SECTOR_SIZE);
+    DiskReads++;
+    break;
+  case FX_DRIVER_BOOT_WRITE:
+    memcpy(Disk, media_ptr->fx_media_driver_buffer, DISK_SECTOR_SIZE);
+    DiskWrites++;
+    break;
+  default:
+    /* Init, flush, abort, release sectors and uninit: nothing to do */
+    break;
+  }
+}
+
+/**
+* @brief  Format the RAM disk
+* @param  None
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT RamDisk_Format(void)
+{
+  memset(Disk, 0, (size_t)DISK_SECTORS * DISK_SECTOR_SIZE);
+
+  if (ExFat) {
+    return fx_media_exFAT_format(&Media, RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                                 "SESSIONS", 1, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 8, 12345, 0);
+  }
+
+  return fx_media_format(&Media, RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                         "SESSIONS", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 1, 1, 1);
+}
+
+/**
+* @brief  Host time in uS
+* @param  None
+* @retval Time
+*/
+static double Now(void)
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+
+  return Time.tv_sec * 1e6 + Time.tv_nsec / 1e3;
+}
+
+/**
+* @brief  Name of one log file of one session
+* @param  Name: File name to be filled
+* @param  Format: SENSORS_FILE_NAME or AUDIO_FILE_NAME
+* @param  Session: Session number
+* @param  Indexed: 1 for the session directories, 0 for the root directory
+* @retval None
+*/
+static void FileName(CHAR *Name, const CHAR *Format, uint32_t Session, int Indexed)
+{
+  if (Indexed) {
+    LogSession_FileName(Name, Format, Session, DirSize);
+  } else {
+    sprintf(Name, Format, (int)Session);
+  }
+}
+
+/**
+* @brief  Format the RAM disk and save Sessions empty logs (one sensors file
+*         and one audio file for each session)
+* @param  Sessions: Number of sessions
+* @param  Indexed: 1 for the session directories and index, 0 for the root directory
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Disk_Fill(uint32_t Sessions, int Indexed)
+{
+  LogSession_T Index = {0, 0, 0};
+  CHAR Name[32];
+  uint32_t Session;
+  UINT status;
+
+  status = RamDisk_Format();
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "SESSIONS", RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  }
+
+  for (Session = 0; (Session < Sessions) && (status == FX_SUCCESS); Session++) {
+    FileName(Name, SENSORS_FILE_NAME, Session, Indexed);
+    status = Indexed ? LogSession_FileCreate(&Media, Name) : fx_file_create(&Media, Name);
+    if (status == FX_SUCCESS) {
+      FileName(Name, AUDIO_FILE_NAME, Session, Indexed);
+      status = fx_file_create(&Media, Name);
+    }
+  }
+
+  if ((status == FX_SUCCESS) && Indexed) {
+    Index.Next = Sessions;
+    Index.DirSize = DirSize;
+    status = LogSession_Write(&Media, &SessionFile, SESSION_INDEX_FILE_NAME, &Index);
+  }
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  One log start as the firmware does after fx_media_open: the next
+*         free session is searched and its two files are created
+* @param  Indexed: 1 with the session index, 0 trying all the names from 0
+* @param  Session: Session found
+* @param  Cost: Cost of the log start
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Log_Start(int Indexed, uint32_t *Session, Cost_T *Cost)
+{
+  LogSession_T Index = {0, 0, 0};
+  CHAR Name[32];
+  UINT status;
+  double StartTime;
+
+  /* The media is opened at each log start */
+  status = fx_media_open(&Media, "SESSIONS", RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  if (status != FX_SUCCESS) {
+    return status;
+  }
+
+  memset(Cost, 0, sizeof(Cost_T));
+  DiskReads = 0;
+  DiskWrites = 0;
+  StartTime = Now();
+
+  *Session = 0;
+  if (Indexed) {
+    Index.DirSize = DirSize;
+    status = LogSession_Read(&Media, &SessionFile, SESSION_INDEX_FILE_NAME, &Index);
+    if (status != FX_SUCCESS) {
+      return status;
+    }
+    *Session = Index.Next;
+  }
+
+  do {
+    FileName(Name, SENSORS_FILE_NAME, *Session, Indexed);
+    status = Indexed ? LogSession_FileCreate(&Media, Name) : fx_file_create(&Media, Name);
+    Cost->Creates++;
+    (*Session)++;
+  } while (status == FX_ALREADY_CREATED);
+  (*Session)--;
+
+  if ((status == FX_SUCCESS) && Indexed) {
+    Index.Next = *Session + 1;
+    status = LogSession_Write(&Media, &SessionFile, SESSION_INDEX_FILE_NAME, &Index);
+  }
+
+  if (status == FX_SUCCESS) {
+    FileName(Name, AUDIO_FILE_NAME, *Session, Indexed);
+    status = fx_file_create(&Media, Name);
+  }
+
+  Cost->Time = Now() - StartTime;
+  Cost->Reads = DiskReads;
+  Cost->Writes = DiskWrites;
+
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Remove the session index (lost or not valid)
+* @param  None
+* @retval FX_SUCCESS or the FileX error
+*/
+static UINT Index_Delete(void)
+{
+  UINT status;
+
+  status = fx_media_open(&Media, "SESSIONS", RamDisk_Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  if (status == FX_SUCCESS) {
+    status = fx_file_delete(&Media, SESSION_INDEX_FILE_NAME);
+    fx_media_close(&Media);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-x] [-d sessions] [sessions...]\n", Name);
+  fprintf(stderr, "  -x  exFAT instead of FAT32\n");
+  fprintf(stderr, "  -d  sessions for each directory (STBOX1_LOG_SESSION_DIR_SIZE, default 100)\n");
+  fprintf(stderr, "  sessions: logs already saved on the SD card (default 0 10 100 500 1000 2000)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t SessionsList[16] = {0, 10, 100, 500, 1000, 2000};
+  uint32_t SessionsNumber = 6;
+  Cost_T Root;
+  Cost_T Indexed;
+  Cost_T Rebuilt;
+  uint32_t Session[3];
+  uint32_t Index;
+  int Arg;
+
+  for (Arg = 1; (Arg < argc) && (argv[Arg][0] == '-'); Arg++) {
+    if (strcmp(argv[Arg], "-x") == 0) {
+      ExFat = 1;
+    } else if ((strcmp(argv[Arg], "-d") == 0) && (Arg + 1 < argc)) {
+      DirSize = (uint32_t)atoi(argv[++Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (Arg < argc) {
+    for (SessionsNumber = 0; (Arg < argc) && (SessionsNumber < 16); Arg++) {
+      SessionsList[SessionsNumber++] = (uint32_t)atoi(argv[Arg]);
+    }
+  }
+
+  if (DirSize == 0) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  Disk = malloc((size_t)DISK_SECTORS * DISK_SECTOR_SIZE);
+  if (Disk == NULL) {
+    fprintf(stderr, "Error allocating the RAM disk\n");
+    return 1;
+  }
+
+  fx_system_initialize();
+
+  printf("%s, %u sessions for each directory, %u sectors media cache\n",
+         ExFat ? "exFAT" : "FAT32", (unsigned)DirSize, (unsigned)(MEDIA_CACHE_SIZE / DISK_SECTOR_SIZE));
+  printf("          Root directory            Session index      Index rebuilt\n");
+  printf("Sessions  Creates  Reads       uS   Reads Writes   uS   Reads       uS\n");
+
+  for (Index = 0; Index < SessionsNumber; Index++) {
+    uint32_t Sessions = SessionsList[Index];
+
+    if ((Disk_Fill(Sessions, 0) != FX_SUCCESS) || (Log_Start(0, &Session[0], &Root) != FX_SUCCESS) ||
+        (Disk_Fill(Sessions, 1) != FX_SUCCESS) || (Log_Start(1, &Session[1], &Indexed) != FX_SUCCESS) ||
+        (Disk_Fill(Sessions, 1) != FX_SUCCESS) || (Index_Delete() != FX_SUCCESS) ||
+        (Log_Start(1, &Session[2], &Rebuilt) != FX_SUCCESS)) {
+      fprintf(stderr, "Error with %u sessions (the RAM disk is too small?)\n", (unsigned)Sessions);
+      return 1;
+    }
+
+    if ((Session[0] != Sessions) || (Session[1] != Sessions) || (Session[2] != Sessions)) {
+      fprintf(stderr, "Error: session %u/%u/%u found instead of %u\n", (unsigned)Session[0],
+              (unsigned)Session[1], (unsigned)Session[2], (unsigned)Sessions);
+      return 1;
+    }
+
+    printf("%8u  %7u %6llu %8.0f  %6llu %6llu %4.0f  %6llu %8.0f\n", (unsigned)Sessions,
+           (unsigned)Root.Creates, (unsigned long long)Root.Reads, Root.Time,
+           (unsigned long long)Indexed.Reads, (unsigned long long)Indexed.Writes, Indexed.Time,
+           (unsigned long long)Rebuilt.Reads, Rebuilt.Time);
+  }
+
+  free(Disk);
+
+  return 0;
+}
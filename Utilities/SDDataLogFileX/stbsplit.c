@@ -0,0 +1,624 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\stbsplit.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host tool for splitting one SDDataLogFileX log container
+  *          (LogXXX.stb) in one file for each stream
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sdlog_utils.h"
+#include "log_container.h"
+#include "audio_lac.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Max delay in mS between one record and the write of its chunk
+   (chunk deadline and messages waiting on the firmware's rings) */
+#define SEEK_MARGIN       3000
+
+/* Min hole in mS between two audio chunks filled with silence (audio blocks
+   discarded by the firmware) */
+#define AUDIO_GAP         10
+
+/* Max interleaved channels of one 16 bit audio stream */
+#define AUDIO_MAX_CHANNELS 8
+
+#define WAV_HEADER_SIZE   44
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  /* Descriptor */
+  uint8_t Id;
+  uint8_t Type;
+  uint16_t RecordSize;
+  char Name[12];
+  uint32_t TickFrequency;
+  float Rate;
+  /* Output file */
+  FILE *Out;
+  uint64_t Samples;          /* Audio samples of each channel written (silence included) */
+  double AudioStart;         /* Time of the first audio sample */
+  double RecordTime;         /* Time of the last sensors record */
+  uint32_t RecordTick;       /* Time stamp of the last sensors record */
+  /* Statistics */
+  uint32_t Chunks;
+  uint64_t Records;
+  double FirstTime;
+  double LastTime;
+} Stream_T;
+
+/* Private variables ---------------------------------------------------------*/
+static Stream_T Streams[LOG_CONTAINER_MAX_STREAMS];
+static uint32_t StreamsNumber;
+static const char *Prefix;
+static int Seek = 0;
+static double SeekTime = 0;
+static uint8_t *Payload;
+static uint32_t PayloadSize;
+
+/**
+* @brief  Write the header of one 16 bit .wav file
+* @param  Out: Output file
+* @param  SampleRate: Sampling frequency
+* @param  Channels: Number of interleaved channels
+* @param  NumSamples: Number of samples of each channel
+* @retval None
+*/
+static void WriteWavHeader(FILE *Out, uint32_t SampleRate, uint16_t Channels, uint32_t NumSamples)
+{
+  uint8_t Header[WAV_HEADER_SIZE];
+
+  memcpy(Header, "RIFF", 4);
+  SDLOG_PutU32(Header + 4, 36 + NumSamples * Channels * 2);
+  memcpy(Header + 8, "WAVEfmt ", 8);
+  SDLOG_PutU32(Header + 16, 16);
+  /* PCM */
+  SDLOG_PutU16(Header + 20, 1);
+  SDLOG_PutU16(Header + 22, Channels);
+  SDLOG_PutU32(Header + 24, SampleRate);
+  SDLOG_PutU32(Header + 28, SampleRate * Channels * 2);
+  SDLOG_PutU16(Header + 32, Channels * 2);
+  SDLOG_PutU16(Header + 34, 16);
+  memcpy(Header + 36, "data", 4);
+  SDLOG_PutU32(Header + 40, NumSamples * Channels * 2);
+
+  fwrite(Header, 1, sizeof(Header), Out);
+}
+
+/**
+* @brief  Open the output file of one stream
+* @param  Stream: Stream
+* @retval 0 on success, -1 otherwise
+*/
+static int OpenOutput(Stream_T *Stream)
+{
+  char FileName[1024];
+  const char *Extension;
+  uint8_t LacHeader[AUDIO_LAC_HEADER_SIZE];
+
+  switch (Stream->Type) {
+    case LOG_CONTAINER_TYPE_IMU:
+    case LOG_CONTAINER_TYPE_MAG:
+    case LOG_CONTAINER_TYPE_ENV:
+      Extension = "csv";
+      break;
+    case LOG_CONTAINER_TYPE_AUDIO_PCM:
+      Extension = "wav";
+      break;
+    case LOG_CONTAINER_TYPE_AUDIO_LAC:
+      Extension = "lac";
+      break;
+    default:
+      Extension = "txt";
+      break;
+  }
+
+  snprintf(FileName, sizeof(FileName), "%s_%s.%s", Prefix, Stream->Name, Extension);
+  Stream->Out = fopen(FileName, "wb");
+  if (Stream->Out == NULL) {
+    fprintf(stderr, "Error opening %s\n", FileName);
+    return -1;
+  }
+
+  switch (Stream->Type) {
+    case LOG_CONTAINER_TYPE_IMU:
+      fprintf(Stream->Out, "Time [mS],AccX [mg],AccY [mg],AccZ [mg],GyroX [mdps],GyroY [mdps],GyroZ [mdps]\n");
+      break;
+    case LOG_CONTAINER_TYPE_MAG:
+      fprintf(Stream->Out, "Time [mS],MagX [mgauss],MagY [mgauss],MagZ [mgauss]\n");
+      break;
+    case LOG_CONTAINER_TYPE_ENV:
+      fprintf(Stream->Out, "Time [mS],P [mB],T ['C]\n");
+      break;
+    case LOG_CONTAINER_TYPE_AUDIO_PCM:
+      /* The data size is updated at the end */
+      WriteWavHeader(Stream->Out, Stream->TickFrequency, Stream->RecordSize / 2, 0);
+      break;
+    case LOG_CONTAINER_TYPE_AUDIO_LAC:
+      /* The total samples are updated at the end */
+      AudioLac_HeaderInit(LacHeader, Stream->TickFrequency);
+      fwrite(LacHeader, 1, sizeof(LacHeader), Stream->Out);
+      break;
+    default:
+      break;
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Update the header and close the output file of one stream
+* @param  Stream: Stream
+* @retval None
+*/
+static void CloseOutput(Stream_T *Stream)
+{
+  uint8_t LacHeader[AUDIO_LAC_HEADER_SIZE];
+
+  if (Stream->Out == NULL) {
+    return;
+  }
+
+  if (Stream->Type == LOG_CONTAINER_TYPE_AUDIO_PCM) {
+    fseek(Stream->Out, 0, SEEK_SET);
+    WriteWavHeader(Stream->Out, Stream->TickFrequency, Stream->RecordSize / 2, (uint32_t)Stream->Samples);
+  } else if (Stream->Type == LOG_CONTAINER_TYPE_AUDIO_LAC) {
+    AudioLac_HeaderInit(LacHeader, Stream->TickFrequency);
+    AudioLac_HeaderUpdate(LacHeader, (uint32_t)Stream->Samples);
+    fseek(Stream->Out, 0, SEEK_SET);
+    fwrite(LacHeader, 1, sizeof(LacHeader), Stream->Out);
+  }
+
+  fclose(Stream->Out);
+  Stream->Out = NULL;
+}
+
+/**
+* @brief  Update the statistics of one stream
+* @param  Stream: Stream
+* @param  Time: Record time in mS
+* @retval None
+*/
+static void AddRecord(Stream_T *Stream, double Time)
+{
+  if (Stream->Records == 0) {
+    Stream->FirstTime = Time;
+  }
+  Stream->LastTime = Time;
+  Stream->Records++;
+}
+
+/**
+* @brief  Convert the sensors records of one chunk to text
+*         (the record time stamps are referred to the chunk time stamp)
+* @param  Stream: Stream
+* @param  Time: Chunk time stamp in mS
+* @param  Count: Number of records
+* @retval None
+*/
+static void SaveSensors(Stream_T *Stream, uint32_t Time, uint32_t Count)
+{
+  uint32_t FirstTick = SDLOG_GetU32(Payload);
+  double FirstTime = Time;
+  uint32_t Index;
+
+  /* The chunk time stamp has 1 mS resolution: keep following the sensor's
+     time stamps while they don't drift from the common time base */
+  if ((Stream->Records != 0) && (Stream->TickFrequency != 1000)) {
+    double Predicted = Stream->RecordTime + (int32_t)(FirstTick - Stream->RecordTick) * 1000.0 / Stream->TickFrequency;
+
+    if ((Predicted > (Time - 1.0)) && (Predicted < (Time + 1.0))) {
+      FirstTime = Predicted;
+    }
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    const uint8_t *Record = Payload + Index * Stream->RecordSize;
+    double RecordTime = FirstTime + (int32_t)(SDLOG_GetU32(Record) - FirstTick) * 1000.0 / Stream->TickFrequency;
+
+    Stream->RecordTime = RecordTime;
+    Stream->RecordTick = SDLOG_GetU32(Record);
+
+    if (Seek && (RecordTime < SeekTime)) {
+      continue;
+    }
+
+    fprintf(Stream->Out, "%.3f", RecordTime);
+    switch (Stream->Type) {
+      case LOG_CONTAINER_TYPE_IMU:
+        fprintf(Stream->Out, ",%d,%d,%d,%d,%d,%d\n",
+                (int32_t)SDLOG_GetU32(Record + 4), (int32_t)SDLOG_GetU32(Record + 8), (int32_t)SDLOG_GetU32(Record + 12),
+                (int32_t)SDLOG_GetU32(Record + 16), (int32_t)SDLOG_GetU32(Record + 20), (int32_t)SDLOG_GetU32(Record + 24));
+        break;
+      case LOG_CONTAINER_TYPE_MAG:
+        fprintf(Stream->Out, ",%d,%d,%d\n",
+                (int32_t)SDLOG_GetU32(Record + 4), (int32_t)SDLOG_GetU32(Record + 8), (int32_t)SDLOG_GetU32(Record + 12));
+        break;
+      default:
+        fprintf(Stream->Out, ",%.2f,%.2f\n", SDLOG_GetFloat(Record + 4), SDLOG_GetFloat(Record + 8));
+        break;
+    }
+    AddRecord(Stream, RecordTime);
+  }
+}
+
+/**
+* @brief  Save the audio of one chunk
+*         (the holes are filled with silence for keeping the .wav aligned)
+* @param  Stream: Stream
+* @param  Time: Time stamp in mS of the first sample
+* @param  Count: Number of samples (of each channel for the .wav)
+* @param  Size: Payload size
+* @retval None
+*/
+static void SaveAudio(Stream_T *Stream, uint32_t Time, uint32_t Count, uint32_t Size)
+{
+  uint32_t Skip = 0;
+
+  if (Seek && (Time < SeekTime)) {
+    Skip = (uint32_t)((SeekTime - Time) * Stream->TickFrequency / 1000);
+    if (Skip >= Count) {
+      return;
+    }
+    /* The compressed frames are saved only whole */
+    if (Stream->Type == LOG_CONTAINER_TYPE_AUDIO_LAC) {
+      return;
+    }
+  }
+
+  if (Stream->Samples == 0) {
+    Stream->AudioStart = Time + Skip * 1000.0 / Stream->TickFrequency;
+  } else if (Stream->Type == LOG_CONTAINER_TYPE_AUDIO_PCM) {
+    double Expected = Stream->AudioStart + Stream->Samples * 1000.0 / Stream->TickFrequency;
+
+    if (Time > (Expected + AUDIO_GAP)) {
+      uint64_t Silence = (uint64_t)((Time - Expected) * Stream->TickFrequency / 1000);
+      static const uint8_t Zero[AUDIO_MAX_CHANNELS * 2] = {0};
+
+      fprintf(stderr, "%s: %.3f mS of silence at %.3f mS\n", Stream->Name, Time - Expected, Expected);
+      Stream->Samples += Silence;
+      while (Silence-- > 0) {
+        fwrite(Zero, 1, Stream->RecordSize, Stream->Out);
+      }
+    }
+  }
+
+  if (Stream->Type == LOG_CONTAINER_TYPE_AUDIO_PCM) {
+    /* The samples are already little-endian and interleaved */
+    fwrite(Payload + Skip * Stream->RecordSize, Stream->RecordSize, Count - Skip, Stream->Out);
+  } else {
+    /* One compressed frame */
+    fwrite(Payload, 1, Size, Stream->Out);
+  }
+
+  Stream->Samples += Count - Skip;
+  AddRecord(Stream, Time);
+  Stream->Records += Count - Skip - 1;
+}
+
+/**
+* @brief  Save one annotation
+* @param  Stream: Stream
+* @param  Size: Payload size
+* @retval None
+*/
+static void SaveAnnotation(Stream_T *Stream, uint32_t Size)
+{
+  uint32_t Time;
+  uint16_t Length;
+
+  if (Size < 6) {
+    return;
+  }
+
+  Time = SDLOG_GetU32(Payload);
+  Length = SDLOG_GetU16(Payload + 4);
+  if (Length > (Size - 6)) {
+    Length = (uint16_t)(Size - 6);
+  }
+
+  if (Seek && (Time < SeekTime)) {
+    return;
+  }
+
+  fprintf(Stream->Out, "%u %.*s\n", Time, (int)Length, (const char *)(Payload + 6));
+  AddRecord(Stream, Time);
+}
+
+/**
+* @brief  Look for the stream of one chunk
+* @param  Id: Stream id
+* @retval Stream or NULL if it's not described on the header
+*/
+static Stream_T *FindStream(uint8_t Id)
+{
+  uint32_t Index;
+
+  for (Index = 0; Index < StreamsNumber; Index++) {
+    if (Streams[Index].Id == Id) {
+      return &Streams[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+* @brief  Look on the index for the file offset where to start reading
+* @param  In: Input file
+* @param  IndexOffset: File offset of the index chunk
+* @param  Offset: Start offset (unchanged if the index is not usable)
+* @retval Number of index entries
+*/
+static uint32_t IndexSeek(FILE *In, uint64_t IndexOffset, uint64_t *Offset)
+{
+  uint8_t Header[LOG_CONTAINER_CHUNK_HEADER_SIZE];
+  uint8_t Entry[LOG_CONTAINER_INDEX_ENTRY_SIZE];
+  uint32_t Entries, Index;
+
+  if ((fseek(In, (long)IndexOffset, SEEK_SET) != 0) ||
+      (fread(Header, 1, sizeof(Header), In) != sizeof(Header)) ||
+      (SDLOG_GetU16(Header) != LOG_CONTAINER_CHUNK_SYNC) ||
+      (Header[2] != LOG_CONTAINER_STREAM_INDEX)) {
+    fprintf(stderr, "Index not found\n");
+    return 0;
+  }
+
+  Entries = SDLOG_GetU32(Header + 12);
+
+  /* The chunks are written in time order of their deadline, not of their
+     first record: start from the last one well before the seek time */
+  for (Index = 0; Index < Entries; Index++) {
+    if (fread(Entry, 1, sizeof(Entry), In) != sizeof(Entry)) {
+      break;
+    }
+    if (Seek && ((SDLOG_GetU32(Entry + 8) + (double)SEEK_MARGIN) <= SeekTime)) {
+      *Offset = (uint64_t)SDLOG_GetU32(Entry) | ((uint64_t)SDLOG_GetU32(Entry + 4) << 32);
+    }
+  }
+
+  return Entries;
+}
+
+/**
+* @brief  Main program
+* @param  argc: number of arguments
+* @param  argv: arguments (input .stb file and optional output files prefix)
+* @retval 0 on success, 1 otherwise
+*/
+int main(int argc, char **argv)
+{
+  uint8_t Header[LOG_CONTAINER_HEADER_SIZE];
+  uint8_t ChunkHeader[LOG_CONTAINER_CHUNK_HEADER_SIZE];
+  uint16_t Version, HeaderSize, ChunkHeaderSize;
+  uint32_t TickFrequency, Chunks, IndexEntries = 0, Read = 0, Index;
+  uint64_t IndexOffset, Offset;
+  char *DefaultPrefix = NULL;
+  FILE *In;
+  int Verbose = 0;
+  int ArgIndex = 1;
+  int Result = 0;
+
+  while ((ArgIndex < argc) && (argv[ArgIndex][0] == '-')) {
+    if (strcmp(argv[ArgIndex], "-v") == 0) {
+      Verbose = 1;
+    } else if ((strcmp(argv[ArgIndex], "-s") == 0) && ((ArgIndex + 1) < argc)) {
+      Seek = 1;
+      SeekTime = atof(argv[++ArgIndex]);
+    } else {
+      break;
+    }
+    ArgIndex++;
+  }
+
+  if ((argc - ArgIndex) < 1) {
+    fprintf(stderr, "Usage: %s [-v] [-s mS] LogXXX.stb [prefix]\n", argv[0]);
+    return 1;
+  }
+
+  In = fopen(argv[ArgIndex], "rb");
+  if (In == NULL) {
+    fprintf(stderr, "Error opening %s\n", argv[ArgIndex]);
+    return 1;
+  }
+
+  /* Read and check the file header */
+  if ((fread(Header, 1, sizeof(Header), In) != sizeof(Header)) ||
+      (memcmp(Header, LOG_CONTAINER_MAGIC, 8) != 0)) {
+    fprintf(stderr, "%s is not a SDDataLogFileX log container\n", argv[ArgIndex]);
+    return 1;
+  }
+
+  Version         = SDLOG_GetU16(Header + 8);
+  HeaderSize      = SDLOG_GetU16(Header + 10);
+  StreamsNumber   = SDLOG_GetU16(Header + 12);
+  ChunkHeaderSize = SDLOG_GetU16(Header + 14);
+  TickFrequency   = SDLOG_GetU32(Header + 16);
+  Chunks          = SDLOG_GetU32(Header + LOG_CONTAINER_CHUNKS_POS);
+  IndexOffset     = (uint64_t)SDLOG_GetU32(Header + LOG_CONTAINER_INDEX_OFFSET_POS) |
+                    ((uint64_t)SDLOG_GetU32(Header + LOG_CONTAINER_INDEX_OFFSET_POS + 4) << 32);
+
+  if (Version != LOG_CONTAINER_VERSION) {
+    fprintf(stderr, "Unsupported log container version %u\n", Version);
+    return 1;
+  }
+
+  if ((HeaderSize != LOG_CONTAINER_HEADER_SIZE) || (ChunkHeaderSize != LOG_CONTAINER_CHUNK_HEADER_SIZE) ||
+      (StreamsNumber > LOG_CONTAINER_MAX_STREAMS) || (TickFrequency != 1000)) {
+    fprintf(stderr, "Corrupted log container header\n");
+    return 1;
+  }
+
+  for (Index = 0; Index < StreamsNumber; Index++) {
+    const uint8_t *Descriptor = Header + LOG_CONTAINER_STREAMS_POS + Index * LOG_CONTAINER_STREAM_SIZE;
+    Stream_T *Stream = &Streams[Index];
+
+    Stream->Id = Descriptor[0];
+    Stream->Type = Descriptor[1];
+    Stream->RecordSize = SDLOG_GetU16(Descriptor + 2);
+    memcpy(Stream->Name, Descriptor + 4, 11);
+    Stream->Name[11] = '\0';
+    Stream->TickFrequency = SDLOG_GetU32(Descriptor + 16);
+    Stream->Rate = SDLOG_GetFloat(Descriptor + 20);
+
+    if ((Stream->TickFrequency == 0) ||
+        ((Stream->Type == LOG_CONTAINER_TYPE_AUDIO_PCM) &&
+         ((Stream->RecordSize == 0) || ((Stream->RecordSize % 2) != 0) || (Stream->RecordSize > (AUDIO_MAX_CHANNELS * 2))))) {
+      fprintf(stderr, "Corrupted log container header\n");
+      return 1;
+    }
+  }
+
+  /* Output files prefix: the input file name without extension */
+  if ((argc - ArgIndex) > 1) {
+    Prefix = argv[ArgIndex + 1];
+  } else {
+    char *Dot;
+
+    DefaultPrefix = strdup(argv[ArgIndex]);
+    Dot = strrchr(DefaultPrefix, '.');
+    if (Dot != NULL) {
+      *Dot = '\0';
+    }
+    Prefix = DefaultPrefix;
+  }
+
+  Offset = HeaderSize;
+  if (IndexOffset != 0) {
+    IndexEntries = IndexSeek(In, IndexOffset, &Offset);
+  } else {
+    fprintf(stderr, "%s was not closed: reading up to the last valid chunk\n", argv[ArgIndex]);
+  }
+
+  if (fseek(In, (long)Offset, SEEK_SET) != 0) {
+    fprintf(stderr, "Error moving to the offset %llu\n", (unsigned long long)Offset);
+    return 1;
+  }
+
+  /* Read all the chunks up to the index */
+  while (fread(ChunkHeader, 1, sizeof(ChunkHeader), In) == sizeof(ChunkHeader)) {
+    uint8_t StreamId = ChunkHeader[2];
+    uint32_t Size  = SDLOG_GetU32(ChunkHeader + 4);
+    uint32_t Time  = SDLOG_GetU32(ChunkHeader + 8);
+    uint32_t Count = SDLOG_GetU32(ChunkHeader + 12);
+    Stream_T *Stream;
+
+    if (SDLOG_GetU16(ChunkHeader) != LOG_CONTAINER_CHUNK_SYNC) {
+      if (IndexOffset != 0) {
+        fprintf(stderr, "Chunk %u: sync not found\n", Read);
+        Result = 1;
+      }
+      break;
+    }
+
+    if (StreamId == LOG_CONTAINER_STREAM_INDEX) {
+      break;
+    }
+
+    if (Size > PayloadSize) {
+      Payload = realloc(Payload, Size);
+      PayloadSize = Size;
+      if (Payload == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+      }
+    }
+
+    if (fread(Payload, 1, Size, In) != Size) {
+      fprintf(stderr, "Chunk %u: truncated\n", Read);
+      Result = (IndexOffset != 0);
+      break;
+    }
+    Read++;
+
+    Stream = FindStream(StreamId);
+    if (Stream == NULL) {
+      fprintf(stderr, "Chunk %u: unknown stream %u\n", Read - 1, StreamId);
+      continue;
+    }
+
+    if ((Stream->RecordSize != 0) && (Size != (Count * Stream->RecordSize))) {
+      fprintf(stderr, "Chunk %u: corrupted %s chunk\n", Read - 1, Stream->Name);
+      Result = 1;
+      continue;
+    }
+
+    if ((Stream->Out == NULL) && (OpenOutput(Stream) != 0)) {
+      return 1;
+    }
+    Stream->Chunks++;
+
+    switch (Stream->Type) {
+      case LOG_CONTAINER_TYPE_IMU:
+      case LOG_CONTAINER_TYPE_MAG:
+      case LOG_CONTAINER_TYPE_ENV:
+        if (Count != 0) {
+          SaveSensors(Stream, Time, Count);
+        }
+        break;
+      case LOG_CONTAINER_TYPE_AUDIO_PCM:
+      case LOG_CONTAINER_TYPE_AUDIO_LAC:
+        if (Count != 0) {
+          SaveAudio(Stream, Time, Count, Size);
+        }
+        break;
+      case LOG_CONTAINER_TYPE_ANNOTATION:
+        SaveAnnotation(Stream, Size);
+        break;
+      default:
+        break;
+    }
+  }
+
+  for (Index = 0; Index < StreamsNumber; Index++) {
+    CloseOutput(&Streams[Index]);
+  }
+
+  if (!Seek && (IndexOffset != 0) && (Read != Chunks)) {
+    fprintf(stderr, "Warning: %u chunks read, %u expected\n", Read, Chunks);
+  }
+
+  if (Verbose) {
+    fprintf(stderr, "%u chunks read (%u index entries), started at offset %llu\n",
+            Read, IndexEntries, (unsigned long long)Offset);
+    for (Index = 0; Index < StreamsNumber; Index++) {
+      Stream_T *Stream = &Streams[Index];
+
+      fprintf(stderr, "%-6s type %u, %.1f Hz, %u chunks, %llu records",
+              Stream->Name, Stream->Type, Stream->Rate, Stream->Chunks, (unsigned long long)Stream->Records);
+      if (Stream->Records != 0) {
+        fprintf(stderr, " from %.3f to %.3f mS", Stream->FirstTime, Stream->LastTime);
+      }
+      if (Stream->Samples != 0) {
+        fprintf(stderr, " (first sample at %.3f mS)", Stream->AudioStart);
+      }
+      fprintf(stderr, "\n");
+    }
+  }
+
+  fclose(In);
+  free(Payload);
+  free(DefaultPrefix);
+
+  return Result;
+}
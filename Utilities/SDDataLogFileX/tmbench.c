@@ -0,0 +1,293 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\tmbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   thread_metric scores of one ThreadX configuration on the ThreadX
+  *          Linux port: each test runs in one child process for some periods
+  *          of TM_TEST_DURATION seconds and its period totals are written as
+  *          one CSV row
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "tm_api.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Name of the ThreadX configuration, given by the Makefile */
+#ifndef TM_CONFIG
+#define TM_CONFIG             "default"
+#endif
+
+#define MAX_PERIODS           16
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* One thread_metric test */
+typedef struct
+{
+  const char *Name;
+  void (*Main)(void);        /* tm_main of the test */
+  void (*Handler)(void);     /* Handler of TM_CAUSE_INTERRUPT */
+} Test_T;
+
+/* Private variables ---------------------------------------------------------*/
+
+/* tm_main of each test, renamed by the Makefile */
+extern void tm_basic_processing_test_main(void);
+extern void tm_cooperative_scheduling_test_main(void);
+extern void tm_preemptive_scheduling_test_main(void);
+extern void tm_interrupt_processing_test_main(void);
+extern void tm_interrupt_preemption_processing_test_main(void);
+extern void tm_message_processing_test_main(void);
+extern void tm_synchronization_processing_test_main(void);
+extern void tm_memory_allocation_test_main(void);
+
+extern void tm_interrupt_handler(void);
+extern void tm_interrupt_preemption_handler(void);
+
+static const Test_T Tests[] = {
+  {"basic_processing", tm_basic_processing_test_main, NULL},
+  {"cooperative_scheduling", tm_cooperative_scheduling_test_main, NULL},
+  {"preemptive_scheduling", tm_preemptive_scheduling_test_main, NULL},
+  {"interrupt_processing", tm_interrupt_processing_test_main, tm_interrupt_handler},
+  {"interrupt_preemption_processing", tm_interrupt_preemption_processing_test_main, tm_interrupt_preemption_handler},
+  {"message_processing", tm_message_processing_test_main, NULL},
+  {"synchronization_processing", tm_synchronization_processing_test_main, NULL},
+  {"memory_allocation", tm_memory_allocation_test_main, NULL},
+};
+#define TESTS                 (sizeof(Tests) / sizeof(Tests[0]))
+
+static const Test_T *Test;
+static int Periods = 3;
+
+/* Private function prototypes -----------------------------------------------*/
+static int Run(const Test_T *RunTest, unsigned long *Totals, int *Errors);
+static int CompareTotals(const void *A, const void *B);
+static void Usage(const char *Name);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  ThreadX application define: starts the test of this process
+  * @param  first_unused_memory Not used
+  * @retval None
+  */
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  Test->Main();
+}
+
+/**
+  * @brief  TM_CAUSE_INTERRUPT of the tests: the handler runs in the thread as
+  *         one interrupt of the Linux port, between _tx_thread_context_save
+  *         and _tx_thread_context_restore, so the threads made ready by it
+  *         preempt the thread only at the end of the handler. The interrupt
+  *         entry and exit of the target are not measured
+  * @param  None
+  * @retval None
+  */
+void tm_interrupt_raise(void)
+{
+  TX_INTERRUPT_SAVE_AREA
+
+  /* Enter the interrupt */
+  TX_DISABLE
+  _tx_thread_system_state++;
+  TX_RESTORE
+
+  Test->Handler();
+
+  /* Exit the interrupt, with the preemption of the thread if needed */
+  TX_DISABLE
+  _tx_thread_system_state--;
+  TX_RESTORE
+  _tx_thread_system_preempt_check();
+}
+
+/**
+  * @brief  Run one test in one child process up to the periods requested
+  * @param  RunTest Test
+  * @param  Totals Destination of the total of each period
+  * @param  Errors Destination of the number of errors reported by the test
+  * @retval Number of periods completed, -1 if the process is not started
+  */
+static int Run(const Test_T *RunTest, unsigned long *Totals, int *Errors)
+{
+  int Pipe[2];
+  pid_t Pid;
+  FILE *Output;
+  char Line[256];
+  int Count = 0;
+
+  *Errors = 0;
+
+  fflush(stdout);
+  if (pipe(Pipe) != 0) {
+    return -1;
+  }
+
+  Pid = fork();
+  if (Pid < 0) {
+    close(Pipe[0]);
+    close(Pipe[1]);
+    return -1;
+  }
+
+  if (Pid == 0) {
+    /* The test reports on stdout one line at a time */
+    close(Pipe[0]);
+    dup2(Pipe[1], STDOUT_FILENO);
+    close(Pipe[1]);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    Test = RunTest;
+    tx_kernel_enter();
+    _exit(1);
+  }
+
+  close(Pipe[1]);
+  Output = fdopen(Pipe[0], "r");
+  if (Output == NULL) {
+    close(Pipe[0]);
+    kill(Pid, SIGKILL);
+    waitpid(Pid, NULL, 0);
+    return -1;
+  }
+
+  /* The reporting thread of the test never ends */
+  while ((Count < Periods) && (fgets(Line, sizeof(Line), Output) != NULL)) {
+    if (sscanf(Line, "Time Period Total: %lu", &Totals[Count]) == 1) {
+      Count++;
+    } else if (strncmp(Line, "ERROR", 5) == 0) {
+      (*Errors)++;
+    }
+  }
+
+  kill(Pid, SIGKILL);
+  waitpid(Pid, NULL, 0);
+  fclose(Output);
+
+  return Count;
+}
+
+static int CompareTotals(const void *A, const void *B)
+{
+  unsigned long TotalA = *(const unsigned long *)A;
+  unsigned long TotalB = *(const unsigned long *)B;
+
+  return (TotalA > TotalB) - (TotalA < TotalB);
+}
+
+static void Usage(const char *Name)
+{
+  unsigned int Index;
+
+  fprintf(stderr, "Usage: %s [-p periods] [-H] [test ...]\n", Name);
+  fprintf(stderr, "  -p  periods of %d s for each test (default 3)\n", TM_TEST_DURATION);
+  fprintf(stderr, "  -H  write the CSV header\n");
+  fprintf(stderr, "Tests:");
+  for (Index = 0; Index < TESTS; Index++) {
+    fprintf(stderr, " %s", Tests[Index].Name);
+  }
+  fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+  int Arg;
+  int Header = 0;
+  int FirstTest = argc;
+  int Count;
+  int Errors;
+  int Failed = 0;
+  unsigned int Index;
+  unsigned long Totals[MAX_PERIODS];
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      Periods = atoi(argv[++Arg]);
+    } else if (strcmp(argv[Arg], "-H") == 0) {
+      Header = 1;
+    } else if (argv[Arg][0] != '-') {
+      FirstTest = Arg;
+      break;
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if ((Periods < 1) || (Periods > MAX_PERIODS)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  /* Check the names of the tests requested */
+  for (Arg = FirstTest; Arg < argc; Arg++) {
+    for (Index = 0; Index < TESTS; Index++) {
+      if (strcmp(argv[Arg], Tests[Index].Name) == 0) {
+        break;
+      }
+    }
+    if (Index == TESTS) {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  /* score: median of the period totals */
+  if (Header) {
+    printf("config,test,duration_s,periods,score,min,max,errors\n");
+  }
+
+  for (Index = 0; Index < TESTS; Index++) {
+    if (FirstTest < argc) {
+      for (Arg = FirstTest; Arg < argc; Arg++) {
+        if (strcmp(argv[Arg], Tests[Index].Name) == 0) {
+          break;
+        }
+      }
+      if (Arg == argc) {
+        continue;
+      }
+    }
+
+    Count = Run(&Tests[Index], Totals, &Errors);
+    if (Count < Periods) {
+      fprintf(stderr, "%s: %s stopped after %d periods\n", TM_CONFIG, Tests[Index].Name, (Count < 0) ? 0 : Count);
+      Failed = 1;
+      continue;
+    }
+
+    qsort(Totals, (size_t)Count, sizeof(Totals[0]), CompareTotals);
+    printf("%s,%s,%d,%d,%lu,%lu,%lu,%d\n", TM_CONFIG, Tests[Index].Name, TM_TEST_DURATION, Count,
+           Totals[Count / 2], Totals[0], Totals[Count - 1], Errors);
+  }
+
+  return Failed;
+}
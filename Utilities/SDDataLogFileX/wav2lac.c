@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\wav2lac.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Host tool for compressing one recorded .wav file with the same
+  *          encoder of the SDDataLogFileX firmware (ratio and speed benchmark)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "sdlog_utils.h"
+#include "audio_lac.h"
+
+/* Private variables ---------------------------------------------------------*/
+static AudioLac_Encoder_T Encoder;
+static uint8_t Frame[AUDIO_LAC_FRAME_MAX_SIZE];
+
+/**
+* @brief  Read one mono 16 bit .wav file
+* @param  In: Input file
+* @param  SampleRate: Sampling frequency
+* @param  NumSamples: Number of samples
+* @retval Samples (to be freed) or NULL on error
+*/
+static int16_t *ReadWav(FILE *In, uint32_t *SampleRate, uint32_t *NumSamples)
+{
+  uint8_t Chunk[8];
+  uint8_t Format[16];
+  int16_t *Samples;
+  uint8_t *Data;
+  uint32_t Size, Index;
+  int FormatFound = 0;
+
+  if ((fread(Chunk, 1, 4, In) != 4) || (memcmp(Chunk, "RIFF", 4) != 0) ||
+      (fread(Chunk, 1, 8, In) != 8) || (memcmp(Chunk + 4, "WAVE", 4) != 0)) {
+    return NULL;
+  }
+
+  /* Look for the "fmt " and "data" chunks (the MicXXX.wav files have one "JUNK" chunk) */
+  while (fread(Chunk, 1, 8, In) == 8) {
+    Size = SDLOG_GetU32(Chunk + 4);
+
+    if (memcmp(Chunk, "fmt ", 4) == 0) {
+      if ((Size < sizeof(Format)) || (fread(Format, 1, sizeof(Format), In) != sizeof(Format))) {
+        return NULL;
+      }
+      fseek(In, (long)(Size - sizeof(Format) + (Size & 1)), SEEK_CUR);
+      if ((SDLOG_GetU16(Format) != 1) || (SDLOG_GetU16(Format + 2) != 1) || (SDLOG_GetU16(Format + 14) != 16)) {
+        fprintf(stderr, "Only mono 16 bit PCM files are supported\n");
+        return NULL;
+      }
+      *SampleRate = SDLOG_GetU32(Format + 4);
+      FormatFound = 1;
+    } else if (memcmp(Chunk, "data", 4) == 0) {
+      if (!FormatFound) {
+        return NULL;
+      }
+      Data = malloc(Size);
+      Samples = malloc(Size);
+      if ((Data == NULL) || (Samples == NULL)) {
+        return NULL;
+      }
+      /* Accept a truncated data chunk (recording interrupted) */
+      Size = (uint32_t)fread(Data, 1, Size, In);
+      *NumSamples = Size / 2;
+      for (Index = 0; Index < *NumSamples; Index++) {
+        Samples[Index] = (int16_t)SDLOG_GetU16(Data + Index * 2);
+      }
+      free(Data);
+      return Samples;
+    } else {
+      fseek(In, (long)(Size + (Size & 1)), SEEK_CUR);
+    }
+  }
+
+  return NULL;
+}
+
+/**
+* @brief  Main program
+* @param  argc: number of arguments
+* @param  argv: arguments (input .wav file and optional output .lac file)
+* @retval 0 on success, 1 otherwise
+*/
+int main(int argc, char **argv)
+{
+  uint8_t Header[AUDIO_LAC_HEADER_SIZE];
+  struct timespec Start, End;
+  uint32_t SampleRate = 0, NumSamples = 0, Index, Size;
+  uint64_t Bytes = AUDIO_LAC_HEADER_SIZE;
+  double Seconds;
+  int16_t *Samples;
+  FILE *In, *Out = NULL;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s MicXXX.wav [MicXXX.lac]\n", argv[0]);
+    return 1;
+  }
+
+  In = fopen(argv[1], "rb");
+  if (In == NULL) {
+    fprintf(stderr, "Error opening %s\n", argv[1]);
+    return 1;
+  }
+
+  Samples = ReadWav(In, &SampleRate, &NumSamples);
+  fclose(In);
+  if ((Samples == NULL) || (NumSamples == 0)) {
+    fprintf(stderr, "%s is not a valid .wav file\n", argv[1]);
+    return 1;
+  }
+
+  if (argc > 2) {
+    Out = fopen(argv[2], "wb");
+    if (Out == NULL) {
+      fprintf(stderr, "Error opening %s\n", argv[2]);
+      return 1;
+    }
+    AudioLac_HeaderInit(Header, SampleRate);
+    AudioLac_HeaderUpdate(Header, NumSamples);
+    fwrite(Header, 1, sizeof(Header), Out);
+  }
+
+  AudioLac_Init(&Encoder);
+
+  /* Same frames of the firmware */
+  clock_gettime(CLOCK_MONOTONIC, &Start);
+  for (Index = 0; Index < NumSamples; Index += AUDIO_LAC_FRAME_SAMPLES) {
+    uint32_t FrameSamples = NumSamples - Index;
+    if (FrameSamples > AUDIO_LAC_FRAME_SAMPLES) {
+      FrameSamples = AUDIO_LAC_FRAME_SAMPLES;
+    }
+    Size = AudioLac_EncodeFrame(&Encoder, Samples + Index, FrameSamples, Frame);
+    if (Out != NULL) {
+      fwrite(Frame, 1, Size, Out);
+    }
+    Bytes += Size;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &End);
+
+  Seconds = (End.tv_sec - Start.tv_sec) + (End.tv_nsec - Start.tv_nsec) * 1e-9;
+
+  printf("%s: %u samples @ %u Hz (%.2f s)\n", argv[1], NumSamples, SampleRate, (double)NumSamples / SampleRate);
+  printf("  Frames:    %u (%u verbatim)\n", Encoder.Frames, Encoder.VerbatimFrames);
+  printf("  Size:      %u -> %llu bytes\n", NumSamples * 2, (unsigned long long)Bytes);
+  printf("  Ratio:     %.2f (%.2f bits for sample)\n", (double)NumSamples * 2 / Bytes, (double)Bytes * 8 / NumSamples);
+  printf("  Host time: %.1f ns for sample\n", Seconds * 1e9 / NumSamples);
+
+  if (Out != NULL) {
+    fclose(Out);
+  }
+  free(Samples);
+
+  return 0;
+}
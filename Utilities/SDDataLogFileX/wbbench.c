@@ -0,0 +1,574 @@
+/**
+  ******************************************************************************
+  * @file    Utilities\SDDataLogFileX\wbbench.c
+  * @author  System Research & Applications Team - Catania Lab.
+  * @version V2.0.0
+  * @date    17-Oct-2026
+  * @brief   Benchmark of the FileX write-behind layer of the firmware
+  *          (STBOX1_FX_WRITE_BEHIND, FileX/App/log_write_behind.c) on the
+  *          ThreadX Linux port: one log written by FileX at one constant data
+  *          rate on one simulated slow device (long write stalls from time to
+  *          time), with the driver called directly and with some queue sizes
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/wait.h>
+
+#include "tx_api.h"
+#include "fx_api.h"
+#include "log_write_behind.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Simulated device: 4 GB formatted FAT32 with 32 KB clusters. The memory is
+   allocated only for the parts written */
+#define DISK_SECTOR_SIZE      512
+#define DISK_SECTORS          (8 * 1024 * 1024)
+#define DISK_CHUNK_SECTORS    2048
+#define DISK_CHUNKS           (DISK_SECTORS / DISK_CHUNK_SECTORS)
+
+/* Same write batching stage, media cache and thread priorities of the firmware */
+#define WRITE_BATCH_SIZE      (16 * 1024)
+#define MEDIA_CACHE_SIZE      (32 * DISK_SECTOR_SIZE)
+#define LOG_FILE_NAME         "Log000.stb"
+#define WRITER_THREAD_PRIO    12
+#define BEHIND_THREAD_PRIO    13
+#define THREAD_STACK_SIZE     (16 * 1024)
+
+/* Max queue tested (KB) */
+#define MAX_QUEUE_SIZE        1024
+
+/* Histogram of the fx_file_write times: upper limits (mS) */
+#define STALL_BINS            6
+static const double StallLimits[STALL_BINS - 1] = {1, 10, 20, 50, 100};
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Latency model of the device: each write takes the command, the bus transfer
+   and the programming; one write every SpikeEvery takes SpikeTime more (garbage
+   collection of the flash translation layer) */
+typedef struct
+{
+  double CommandTime;        /* uS for each request */
+  double BusRate;            /* MB/s on the bus */
+  double ProgramTime;        /* uS of device busy after each write */
+  double SpikeTime;          /* mS of one long write */
+  ULONG SpikeEvery;          /* Writes between the long ones */
+} Latency_T;
+
+/* Private variables ---------------------------------------------------------*/
+
+/* ThreadX Linux port: simulated interrupts */
+extern VOID _tx_thread_context_save(VOID);
+extern VOID _tx_thread_context_restore(VOID);
+
+static UCHAR *Disk[DISK_CHUNKS];
+static Latency_T Latency = {100.0, 25.0, 800.0, 100.0, 64};
+static ULONG64 LogSize = 8ULL * 1024 * 1024;
+static ULONG Rate = 2048;                 /* KB/s of data of the log, 0 as fast as possible */
+static ULONG ExtentSize = 32;             /* KB */
+static ULONG Deadline = 100;              /* mS */
+static ULONG QueueSize;                   /* KB of the queue, 0 for the direct driver */
+static ULONG DeviceWrites;
+
+/* Device completion: one host thread waits for the end of each write and
+   signals it as one ThreadX interrupt (the same way of the timer interrupt of
+   the Linux port) */
+static pthread_t IrqThread;
+static sem_t IrqStart;
+static volatile uint64_t DeviceBusyEnd;   /* uS */
+static TX_SEMAPHORE DeviceDone;
+
+static TX_THREAD WriterThread;
+static ULONG WriterStack[THREAD_STACK_SIZE / sizeof(ULONG)];
+static ULONG BehindStack[THREAD_STACK_SIZE / sizeof(ULONG)];
+static UCHAR BehindBuffer[MAX_QUEUE_SIZE * 1024] __attribute__ ((aligned (32)));
+
+static UCHAR MediaMemory[MEDIA_CACHE_SIZE];
+static FX_MEDIA Media;
+static FX_FILE File;
+
+static UCHAR Batch[WRITE_BATCH_SIZE] __attribute__ ((aligned (32)));
+
+/**
+* @brief  Time of the host
+* @param  None
+* @retval uS
+*/
+static uint64_t Now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)(ts.tv_nsec / 1000);
+}
+
+/**
+* @brief  Time base of the write-behind statistics (host/log_write_behind_time.h)
+* @param  None
+* @retval uS
+*/
+unsigned int log_write_behind_host_us(void)
+{
+  return (unsigned int)Now_us();
+}
+
+/**
+* @brief  Copy some sectors from/to the simulated device
+* @param  Sector: First sector
+* @param  Count: Number of sectors
+* @param  Data: Data
+* @param  Write: 1 for writing the device
+* @retval None
+*/
+static void Disk_Copy(ULONG Sector, ULONG Count, UCHAR *Data, int Write)
+{
+  while (Count-- > 0) {
+    ULONG Chunk = Sector / DISK_CHUNK_SECTORS;
+    UCHAR *Sectors;
+
+    if ((Disk[Chunk] == NULL) && Write) {
+      Disk[Chunk] = calloc(DISK_CHUNK_SECTORS, DISK_SECTOR_SIZE);
+      if (Disk[Chunk] == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+      }
+    }
+
+    if (Disk[Chunk] == NULL) {
+      memset(Data, 0, DISK_SECTOR_SIZE);
+    } else {
+      Sectors = Disk[Chunk] + (Sector % DISK_CHUNK_SECTORS) * DISK_SECTOR_SIZE;
+      if (Write) {
+        memcpy(Sectors, Data, DISK_SECTOR_SIZE);
+      } else {
+        memcpy(Data, Sectors, DISK_SECTOR_SIZE);
+      }
+    }
+
+    Sector++;
+    Data += DISK_SECTOR_SIZE;
+  }
+}
+
+/**
+* @brief  Simulated device interrupt at the end of each write
+* @param  Arg: Not used
+* @retval None
+*/
+static void *Irq_Thread(void *Arg)
+{
+  struct timespec ts;
+  uint64_t End;
+
+  (void)Arg;
+
+  for (;;) {
+    while (sem_wait(&IrqStart) != 0) {
+    }
+
+    End = DeviceBusyEnd;
+    ts.tv_sec = (time_t)(End / 1000000U);
+    ts.tv_nsec = (long)((End % 1000000U) * 1000U);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+
+    _tx_thread_context_save();
+    tx_semaphore_put(&DeviceDone);
+    _tx_thread_context_restore();
+  }
+
+  return NULL;
+}
+
+/**
+* @brief  Simulated slow device driver: the reads are done at once, each write
+*         sleeps the calling thread until the device is ready again
+* @param  media_ptr: FileX media
+* @retval None
+*/
+static VOID Device_Driver(FX_MEDIA *media_ptr)
+{
+  ULONG Sector = (ULONG)media_ptr->fx_media_driver_logical_sector + media_ptr->fx_media_hidden_sectors;
+  ULONG Count = media_ptr->fx_media_driver_sectors;
+  UINT Request = media_ptr->fx_media_driver_request;
+  double Busy;
+
+  media_ptr->fx_media_driver_status = FX_SUCCESS;
+
+  if (Request == FX_DRIVER_BOOT_READ) {
+    Request = FX_DRIVER_READ;
+    Sector = 0;
+    Count = 1;
+  } else if (Request == FX_DRIVER_BOOT_WRITE) {
+    Request = FX_DRIVER_WRITE;
+    Sector = 0;
+    Count = 1;
+  }
+
+  if (((Request == FX_DRIVER_READ) || (Request == FX_DRIVER_WRITE)) && (Sector + Count > DISK_SECTORS)) {
+    media_ptr->fx_media_driver_status = FX_IO_ERROR;
+    return;
+  }
+
+  switch (Request) {
+  case FX_DRIVER_READ:
+    Disk_Copy(Sector, Count, media_ptr->fx_media_driver_buffer, 0);
+    break;
+  case FX_DRIVER_WRITE:
+    Disk_Copy(Sector, Count, media_ptr->fx_media_driver_buffer, 1);
+
+    Busy = Latency.CommandTime + (Count * DISK_SECTOR_SIZE) / Latency.BusRate + Latency.ProgramTime;
+    DeviceWrites++;
+    if ((Latency.SpikeEvery != 0) && ((DeviceWrites % Latency.SpikeEvery) == 0)) {
+      Busy += Latency.SpikeTime * 1000.0;
+    }
+
+    DeviceBusyEnd = Now_us() + (uint64_t)Busy;
+    sem_post(&IrqStart);
+    if (tx_semaphore_get(&DeviceDone, 10 * TX_TIMER_TICKS_PER_SECOND) != TX_SUCCESS) {
+      media_ptr->fx_media_driver_status = FX_IO_ERROR;
+    }
+    break;
+  default:
+    /* Init, flush, abort, release sectors and uninit: nothing to do */
+    break;
+  }
+}
+
+/**
+* @brief  Fill one batch with its position on the log
+* @param  Offset: Bytes written before
+* @retval None
+*/
+static void Batch_Fill(ULONG64 Offset)
+{
+  ULONG Index;
+
+  for (Index = 0; Index < WRITE_BATCH_SIZE; Index += 4) {
+    uint32_t Word = (uint32_t)((Offset + Index) / 4);
+
+    memcpy(&Batch[Index], &Word, 4);
+  }
+}
+
+/**
+* @brief  Read back the log from the device with the direct driver
+* @param  None
+* @retval 1 if all the data are on the file
+*/
+static int Log_Verify(void)
+{
+  static UCHAR Data[WRITE_BATCH_SIZE];
+  ULONG64 Offset;
+  ULONG Read;
+  int Ok;
+
+  if (fx_media_open(&Media, "WBBENCH", Device_Driver, NULL, MediaMemory, sizeof(MediaMemory)) != FX_SUCCESS) {
+    return 0;
+  }
+
+  Ok = (fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_READ) == FX_SUCCESS) &&
+       (File.fx_file_current_file_size == LogSize);
+
+  for (Offset = 0; Ok && (Offset < LogSize); Offset += WRITE_BATCH_SIZE) {
+    Batch_Fill(Offset);
+    Ok = (fx_file_read(&File, Data, WRITE_BATCH_SIZE, &Read) == FX_SUCCESS) && (Read == WRITE_BATCH_SIZE) &&
+         (memcmp(Data, Batch, WRITE_BATCH_SIZE) == 0);
+  }
+
+  fx_media_close(&Media);
+
+  return Ok;
+}
+
+/**
+* @brief  Print the write-behind statistics
+* @param  None
+* @retval None
+*/
+static void Behind_Print(void)
+{
+  static const ULONG Limits[LOG_WRITE_BEHIND_LATENCY_BINS - 1] = LOG_WRITE_BEHIND_LATENCY_LIMITS;
+  LogWriteBehindStats_T *Stats = &LogWriteBehindStats;
+  int Bin;
+
+  printf("  queue: high water %lu KB (%lu extents), %lu writes (%lu coalesced) on %lu extents, %lu at deadline\n",
+         (unsigned long)(Stats->MaxBytes / 1024), (unsigned long)Stats->MaxExtents, (unsigned long)Stats->Writes,
+         (unsigned long)Stats->Coalesced, (unsigned long)Stats->Extents, (unsigned long)Stats->DeadlineFlushes);
+  printf("  full waits %lu (max %.1f mS), drains %lu, errors %lu\n", (unsigned long)Stats->FullWaits,
+         Stats->WaitMax / 1000.0, (unsigned long)Stats->Drains, (unsigned long)Stats->Errors);
+  printf("  extent latency max %.1f mS:", Stats->LatencyMax / 1000.0);
+  for (Bin = 0; Bin < LOG_WRITE_BEHIND_LATENCY_BINS; Bin++) {
+    if (Bin < LOG_WRITE_BEHIND_LATENCY_BINS - 1) {
+      printf(" <%lu %lu", (unsigned long)Limits[Bin], (unsigned long)Stats->Latency[Bin]);
+    } else {
+      printf(" >=%lu %lu", (unsigned long)Limits[Bin - 1], (unsigned long)Stats->Latency[Bin]);
+    }
+  }
+  printf("\n");
+}
+
+/**
+* @brief  Writing thread: one log at the data rate, with one fx_file_write for
+*         each WRITE_BATCH_SIZE bytes ready (the firmware wakes up at each tick)
+* @param  Input: Not used
+* @retval None
+*/
+static VOID Writer_Thread(ULONG Input)
+{
+  VOID (*Driver)(FX_MEDIA *media_ptr) = (QueueSize != 0) ? LogWriteBehind_Driver : Device_Driver;
+  ULONG Stalls[STALL_BINS] = {0};
+  uint64_t WriteMax = 0;
+  uint64_t FlushTime;
+  uint64_t Start;
+  uint64_t Time;
+  uint64_t Now;
+  ULONG64 Backlog;
+  ULONG64 BacklogMax = 0;
+  ULONG64 Written;
+  ULONG64 Ready;
+  char Name[32];
+  UINT status;
+  int Bin;
+
+  (void)Input;
+
+  if ((QueueSize != 0) &&
+      (LogWriteBehind_Init(Device_Driver, BehindBuffer, QueueSize * 1024, ExtentSize * 1024,
+                           (Deadline * TX_TIMER_TICKS_PER_SECOND + 999) / 1000, BEHIND_THREAD_PRIO,
+                           BehindStack, sizeof(BehindStack)) != FX_SUCCESS)) {
+    fprintf(stderr, "Write-behind init error\n");
+    exit(1);
+  }
+
+  status = fx_media_format(&Media, Driver, NULL, MediaMemory, sizeof(MediaMemory),
+                           "WBBENCH", 2, 0, 0, DISK_SECTORS, DISK_SECTOR_SIZE, 64, 1, 1);
+  if (status == FX_SUCCESS) {
+    status = fx_media_open(&Media, "WBBENCH", Driver, NULL, MediaMemory, sizeof(MediaMemory));
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_create(&Media, LOG_FILE_NAME);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_file_open(&Media, &File, LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+  }
+
+  Start = Now_us();
+  Written = 0;
+
+  while ((Written < LogSize) && (status == FX_SUCCESS)) {
+    Now = Now_us();
+    Ready = (Rate != 0) ? ((ULONG64)(Now - Start) * Rate * 1024) / 1000000U : LogSize;
+    if (Ready > LogSize) {
+      Ready = LogSize;
+    }
+
+    /* Data waiting on the RAM of the application */
+    Backlog = (Ready > Written) ? (Ready - Written) : 0;
+    if (Backlog > BacklogMax) {
+      BacklogMax = Backlog;
+    }
+
+    if (Ready < Written + WRITE_BATCH_SIZE) {
+      tx_thread_sleep(1);
+      continue;
+    }
+
+    Batch_Fill(Written);
+    Now = Now_us();
+    status = fx_file_write(&File, Batch, WRITE_BATCH_SIZE);
+    Time = Now_us() - Now;
+    Written += WRITE_BATCH_SIZE;
+
+    if (Time > WriteMax) {
+      WriteMax = Time;
+    }
+    for (Bin = 0; Bin < STALL_BINS - 1; Bin++) {
+      if (Time < StallLimits[Bin] * 1000.0) {
+        break;
+      }
+    }
+    Stalls[Bin]++;
+  }
+
+  /* fx_media_flush returns when all the data are on the device */
+  Now = Now_us();
+  if (status == FX_SUCCESS) {
+    status = fx_media_flush(&Media);
+  }
+  FlushTime = Now_us() - Now;
+
+  if (status == FX_SUCCESS) {
+    status = fx_file_close(&File);
+  }
+  if (status == FX_SUCCESS) {
+    status = fx_media_close(&Media);
+  }
+
+  Time = Now_us() - Start;
+
+  if (status != FX_SUCCESS) {
+    fprintf(stderr, "FileX error 0x%x\n", status);
+    exit(1);
+  }
+
+  if (QueueSize != 0) {
+    snprintf(Name, sizeof(Name), "behind %lu KB", (unsigned long)QueueSize);
+  } else {
+    snprintf(Name, sizeof(Name), "direct");
+  }
+
+  printf("%-14s %5.2f  %7.1f  %5lu %5lu %5lu %5lu %5lu %5lu  %6lu  %6.1f  %s\n", Name, LogSize / (double)Time,
+         WriteMax / 1000.0, (unsigned long)Stalls[0], (unsigned long)Stalls[1], (unsigned long)Stalls[2],
+         (unsigned long)Stalls[3], (unsigned long)Stalls[4], (unsigned long)Stalls[5],
+         (unsigned long)(BacklogMax / 1024), FlushTime / 1000.0, Log_Verify() ? "OK" : "ERROR");
+
+  if (QueueSize != 0) {
+    Behind_Print();
+  }
+
+  fflush(stdout);
+  exit(0);
+}
+
+/**
+* @brief  ThreadX application define: the writing thread
+* @param  first_unused_memory: Not used
+* @retval None
+*/
+VOID tx_application_define(VOID *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_semaphore_create(&DeviceDone, "device done", 0);
+
+  /* The simulated interrupt is started after the initialization of the Linux port */
+  sem_init(&IrqStart, 0, 0);
+  pthread_create(&IrqThread, NULL, Irq_Thread, NULL);
+
+  tx_thread_create(&WriterThread, "writer", Writer_Thread, 0, WriterStack, sizeof(WriterStack),
+                   WRITER_THREAD_PRIO, WRITER_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/**
+* @brief  Print the usage
+* @param  Name: Program name
+* @retval None
+*/
+static void Usage(const char *Name)
+{
+  fprintf(stderr, "Usage: %s [-m MB] [-r KB/s] [-e KB] [-d mS] [-s mS] [-n writes] [-c uS] [-b MB/s] [-p uS] [KB...]\n",
+          Name);
+  fprintf(stderr, "  -m  size of each log (default 8 MB)\n");
+  fprintf(stderr, "  -r  data rate of the log, 0 as fast as possible (default 2048 KB/s)\n");
+  fprintf(stderr, "  -e  size of each extent of the queue (default 32 KB)\n");
+  fprintf(stderr, "  -d  deadline of the queued writes (default 100 mS)\n");
+  fprintf(stderr, "  -s  long write of the device (default 100 mS)\n");
+  fprintf(stderr, "  -n  writes between the long ones, 0 for none (default 64)\n");
+  fprintf(stderr, "  -c  command overhead of each write (default 100 uS)\n");
+  fprintf(stderr, "  -b  bus rate (default 25 MB/s)\n");
+  fprintf(stderr, "  -p  device busy after each write (default 800 uS)\n");
+  fprintf(stderr, "  KB  queue sizes tested after the direct driver (default 64 128 256, max %u)\n",
+          MAX_QUEUE_SIZE);
+}
+
+int main(int argc, char *argv[])
+{
+  ULONG Sizes[16] = {0, 64, 128, 256};
+  ULONG Count = 4;
+  ULONG Index;
+  int Arg;
+  int Status;
+  pid_t Pid;
+
+  for (Arg = 1; Arg < argc; Arg++) {
+    if ((strcmp(argv[Arg], "-m") == 0) && (Arg + 1 < argc)) {
+      LogSize = (ULONG64)atoi(argv[++Arg]) * 1024 * 1024;
+    } else if ((strcmp(argv[Arg], "-r") == 0) && (Arg + 1 < argc)) {
+      Rate = (ULONG)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-e") == 0) && (Arg + 1 < argc)) {
+      ExtentSize = (ULONG)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-d") == 0) && (Arg + 1 < argc)) {
+      Deadline = (ULONG)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-s") == 0) && (Arg + 1 < argc)) {
+      Latency.SpikeTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-n") == 0) && (Arg + 1 < argc)) {
+      Latency.SpikeEvery = (ULONG)atoi(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-c") == 0) && (Arg + 1 < argc)) {
+      Latency.CommandTime = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-b") == 0) && (Arg + 1 < argc)) {
+      Latency.BusRate = atof(argv[++Arg]);
+    } else if ((strcmp(argv[Arg], "-p") == 0) && (Arg + 1 < argc)) {
+      Latency.ProgramTime = atof(argv[++Arg]);
+    } else if ((argv[Arg][0] != '-') && (Count < sizeof(Sizes) / sizeof(Sizes[0])) && (atoi(argv[Arg]) > 0) &&
+               (atoi(argv[Arg]) <= MAX_QUEUE_SIZE)) {
+      if (Count == 4) {
+        /* The sizes given replace the default ones */
+        Count = 1;
+      }
+      Sizes[Count++] = (ULONG)atoi(argv[Arg]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if ((LogSize == 0) || (LogSize > 256ULL * 1024 * 1024) || (Latency.BusRate <= 0) || (ExtentSize == 0)) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  printf("FAT32, %u MB log at %u KB/s, %u bytes for each fx_file_write\n", (unsigned)(LogSize / (1024 * 1024)),
+         (unsigned)Rate, (unsigned)WRITE_BATCH_SIZE);
+  printf("Device write %.0f uS + %.1f MB/s + busy %.0f uS, %.0f mS more every %lu writes, tick %u uS\n",
+         Latency.CommandTime, Latency.BusRate, Latency.ProgramTime, Latency.SpikeTime,
+         (unsigned long)Latency.SpikeEvery, (unsigned)(1000000U / TX_TIMER_TICKS_PER_SECOND));
+  printf("Write-behind extents of %lu KB, deadline %lu mS\n", (unsigned long)ExtentSize, (unsigned long)Deadline);
+  printf("                      fx_file_write (mS)  <1   <10   <20   <50  <100 >=100  Backlog  Flush\n");
+  printf("Mode            MB/s      max                                              KB      mS   Data\n");
+  fflush(stdout);
+
+  /* One process for each mode: ThreadX and the write-behind layer are started once */
+  for (Index = 0; Index < Count; Index++) {
+    QueueSize = Sizes[Index];
+    if ((QueueSize != 0) && (QueueSize < 2 * ExtentSize)) {
+      fprintf(stderr, "Queue of %lu KB smaller than 2 extents\n", (unsigned long)QueueSize);
+      continue;
+    }
+
+    Pid = fork();
+    if (Pid == 0) {
+      fx_system_initialize();
+      tx_kernel_enter();
+      return 0;
+    }
+
+    if ((Pid < 0) || (waitpid(Pid, &Status, 0) != Pid) || !WIFEXITED(Status) || (WEXITSTATUS(Status) != 0)) {
+      fprintf(stderr, "Error with the queue of %lu KB\n", (unsigned long)QueueSize);
+      return 1;
+    }
+  }
+
+  return 0;
+}